@@ -23,6 +23,12 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdarg>
+#include <cstdlib>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -51,6 +57,419 @@ static int s_nIndentationLevel = 0;
 ///	</summary>
 static bool s_fBlockFlag = false;
 
+///////////////////////////////////////////////////////////////////////////////
+/// Profile
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Measurements of all calls of an announcement block with the same
+///		name and the same enclosing block.
+///	</summary>
+struct AnnounceProfileBlock {
+
+	AnnounceProfileBlock(
+		const std::string & strNameIn,
+		int ixParentIn
+	) :
+		strName(strNameIn),
+		ixParent(ixParentIn),
+		nCalls(0),
+		dWallTime(0.0),
+		dCPUTime(0.0),
+		lPeakRSSGrowth(0)
+	{ }
+
+	std::string strName;
+	int ixParent;
+	std::vector<int> vecChildren;
+
+	int nCalls;
+	double dWallTime;
+	double dCPUTime;
+
+	///	<summary>
+	///		Largest growth of the peak resident set size during a call, in
+	///		kilobytes.
+	///	</summary>
+	long lPeakRSSGrowth;
+
+	///	<summary>
+	///		Change of each counter during all calls.
+	///	</summary>
+	std::vector<long long> vecCounters;
+};
+
+///	<summary>
+///		Measurements at the start of an open announcement block.
+///	</summary>
+struct AnnounceProfileFrame {
+	int ixBlock;
+	double dWallTime;
+	double dCPUTime;
+	long lPeakRSS;
+	std::vector<long long> vecCounters;
+};
+
+///	<summary>
+///		Profile of all announcement blocks of this process.  The first
+///		block encloses the whole run.
+///	</summary>
+struct AnnounceProfile {
+
+	AnnounceProfile() :
+		fEnabled(false),
+		fPrint(false)
+	{
+		const char * szProfile = getenv("TEMPEST_PROFILE");
+		if ((szProfile != NULL) &&
+			(strcmp(szProfile, "") != 0) &&
+			(strcmp(szProfile, "0") != 0)
+		) {
+			fPrint = true;
+		}
+
+		const char * szJSONFile = getenv("TEMPEST_PROFILE_JSON");
+		if (szJSONFile != NULL) {
+			strJSONFile = szJSONFile;
+		}
+
+		fEnabled = (fPrint || (strJSONFile != ""));
+
+		if (fEnabled) {
+			vecBlocks.push_back(AnnounceProfileBlock("Total", -1));
+			vecStack.resize(1);
+			Measure(0, vecStack[0]);
+		}
+	}
+
+	///	<summary>
+	///		Record the current time, resident set size and counters.
+	///	</summary>
+	void Measure(
+		int ixBlock,
+		AnnounceProfileFrame & frame
+	) const {
+		frame.ixBlock = ixBlock;
+
+		frame.dWallTime = std::chrono::duration<double>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+
+		frame.dCPUTime =
+			static_cast<double>(usage.ru_utime.tv_sec)
+			+ 1.0e-6 * static_cast<double>(usage.ru_utime.tv_usec)
+			+ static_cast<double>(usage.ru_stime.tv_sec)
+			+ 1.0e-6 * static_cast<double>(usage.ru_stime.tv_usec);
+
+#ifdef __APPLE__
+		frame.lPeakRSS = static_cast<long>(usage.ru_maxrss / 1024);
+#else
+		frame.lPeakRSS = static_cast<long>(usage.ru_maxrss);
+#endif
+
+		frame.vecCounters.resize(dequeCounters.size());
+		for (int c = 0; c < dequeCounters.size(); c++) {
+			frame.vecCounters[c] =
+				dequeCounters[c].load(std::memory_order_relaxed);
+		}
+	}
+
+	///	<summary>
+	///		Open a block named szName within the innermost open block.
+	///	</summary>
+	void StartBlock(
+		const char * szName
+	) {
+		std::string strName = (szName != NULL)?(szName):("");
+
+		int ixParent = vecStack.back().ixBlock;
+
+		int ixBlock = -1;
+		for (int i = 0; i < vecBlocks[ixParent].vecChildren.size(); i++) {
+			int ixChild = vecBlocks[ixParent].vecChildren[i];
+			if (vecBlocks[ixChild].strName == strName) {
+				ixBlock = ixChild;
+				break;
+			}
+		}
+
+		if (ixBlock == -1) {
+			ixBlock = static_cast<int>(vecBlocks.size());
+			vecBlocks.push_back(AnnounceProfileBlock(strName, ixParent));
+			vecBlocks[ixParent].vecChildren.push_back(ixBlock);
+		}
+
+		vecStack.push_back(AnnounceProfileFrame());
+		Measure(ixBlock, vecStack.back());
+	}
+
+	///	<summary>
+	///		Close the innermost open block.
+	///	</summary>
+	void EndBlock() {
+		AnnounceProfileFrame frameEnd;
+		Measure(vecStack.back().ixBlock, frameEnd);
+
+		const AnnounceProfileFrame & frameBegin = vecStack.back();
+		AnnounceProfileBlock & block = vecBlocks[frameBegin.ixBlock];
+
+		block.nCalls++;
+		block.dWallTime += frameEnd.dWallTime - frameBegin.dWallTime;
+		block.dCPUTime += frameEnd.dCPUTime - frameBegin.dCPUTime;
+
+		long lPeakRSSGrowth = frameEnd.lPeakRSS - frameBegin.lPeakRSS;
+		if (lPeakRSSGrowth > block.lPeakRSSGrowth) {
+			block.lPeakRSSGrowth = lPeakRSSGrowth;
+		}
+
+		// Counters may be registered while the block is open
+		block.vecCounters.resize(frameEnd.vecCounters.size(), 0);
+		for (int c = 0; c < frameEnd.vecCounters.size(); c++) {
+			long long llBegin = 0;
+			if (c < frameBegin.vecCounters.size()) {
+				llBegin = frameBegin.vecCounters[c];
+			}
+			block.vecCounters[c] += frameEnd.vecCounters[c] - llBegin;
+		}
+
+		vecStack.pop_back();
+	}
+
+	///	<summary>
+	///		Print a block and its children.
+	///	</summary>
+	void PrintBlock(
+		int ixBlock,
+		int nDepth
+	) const {
+		const AnnounceProfileBlock & block = vecBlocks[ixBlock];
+
+		std::string strName;
+		for (int i = 0; i < nDepth; i++) {
+			strName += "..";
+		}
+		strName += block.strName;
+
+		printf("%-44.44s %6i %10.3f %10.3f %10li\n",
+			strName.c_str(),
+			block.nCalls,
+			block.dWallTime,
+			block.dCPUTime,
+			block.lPeakRSSGrowth);
+
+		for (int c = 0; c < block.vecCounters.size(); c++) {
+			if (block.vecCounters[c] == 0) {
+				continue;
+			}
+			std::string strCounter;
+			for (int i = 0; i <= nDepth; i++) {
+				strCounter += "  ";
+			}
+			strCounter += vecCounterNames[c];
+
+			printf("%-44.44s %lli\n",
+				strCounter.c_str(), block.vecCounters[c]);
+		}
+
+		for (int i = 0; i < block.vecChildren.size(); i++) {
+			PrintBlock(block.vecChildren[i], nDepth + 1);
+		}
+	}
+
+	///	<summary>
+	///		Write a string to a JSON file.
+	///	</summary>
+	static void WriteJSONString(
+		FILE * fp,
+		const std::string & str
+	) {
+		fputc('"', fp);
+		for (int i = 0; i < str.length(); i++) {
+			unsigned char c = static_cast<unsigned char>(str[i]);
+			if ((c == '"') || (c == '\\')) {
+				fputc('\\', fp);
+				fputc(c, fp);
+			} else if (c < 0x20) {
+				fprintf(fp, "\\u%04x", c);
+			} else {
+				fputc(c, fp);
+			}
+		}
+		fputc('"', fp);
+	}
+
+	///	<summary>
+	///		Write a block and its children to a JSON file.
+	///	</summary>
+	void WriteJSONBlock(
+		FILE * fp,
+		int ixBlock,
+		int nDepth
+	) const {
+		const AnnounceProfileBlock & block = vecBlocks[ixBlock];
+
+		std::string strIndent(2 * nDepth, ' ');
+
+		fprintf(fp, "%s{\"name\": ", strIndent.c_str());
+		WriteJSONString(fp, block.strName);
+		fprintf(fp, ", \"calls\": %i, \"wall_s\": %.6e, \"cpu_s\": %.6e, "
+			"\"peak_rss_growth_kb\": %li, \"counters\": {",
+			block.nCalls,
+			block.dWallTime,
+			block.dCPUTime,
+			block.lPeakRSSGrowth);
+
+		bool fFirst = true;
+		for (int c = 0; c < block.vecCounters.size(); c++) {
+			if (block.vecCounters[c] == 0) {
+				continue;
+			}
+			if (!fFirst) {
+				fprintf(fp, ", ");
+			}
+			WriteJSONString(fp, vecCounterNames[c]);
+			fprintf(fp, ": %lli", block.vecCounters[c]);
+			fFirst = false;
+		}
+
+		fprintf(fp, "}, \"children\": [");
+		for (int i = 0; i < block.vecChildren.size(); i++) {
+			fprintf(fp, "%s\n", (i == 0)?(""):(","));
+			WriteJSONBlock(fp, block.vecChildren[i], nDepth + 1);
+		}
+		if (block.vecChildren.size() != 0) {
+			fprintf(fp, "\n%s", strIndent.c_str());
+		}
+		fprintf(fp, "]}");
+	}
+
+	///	<summary>
+	///		Close all open blocks and report the profile.
+	///	</summary>
+	void Report() {
+		while (vecStack.size() != 0) {
+			EndBlock();
+		}
+
+		// Only the process which made announcements reports
+		if (vecBlocks.size() == 1) {
+			return;
+		}
+
+		fflush(NULL);
+
+		if (fPrint) {
+			printf("-- Profile "
+				"-------------------------------------------------\n");
+			printf("%-44s %6s %10s %10s %10s\n",
+				"Block", "Calls", "Wall (s)", "CPU (s)", "+RSS (KB)");
+			PrintBlock(0, 0);
+			printf("-------------------------------------------------"
+				"-----------\n");
+			fflush(NULL);
+		}
+
+		if (strJSONFile != "") {
+			FILE * fp = fopen(strJSONFile.c_str(), "w");
+			if (fp == NULL) {
+				fprintf(stderr, "WARNING: Unable to open profile file \"%s\"\n",
+					strJSONFile.c_str());
+				return;
+			}
+
+			WriteJSONBlock(fp, 0, 0);
+			fprintf(fp, "\n");
+
+			if (fclose(fp) != 0) {
+				fprintf(stderr, "WARNING: Unable to write profile file \"%s\"\n",
+					strJSONFile.c_str());
+			}
+		}
+	}
+
+	///	<summary>
+	///		Flags indicating whether profiling is enabled and whether the
+	///		profile is printed.
+	///	</summary>
+	bool fEnabled;
+	bool fPrint;
+
+	///	<summary>
+	///		File to which the profile is written as JSON.
+	///	</summary>
+	std::string strJSONFile;
+
+	///	<summary>
+	///		Names and values of all counters.  Values are held in a deque
+	///		so that their addresses do not change as counters are added.
+	///	</summary>
+	std::vector<std::string> vecCounterNames;
+	std::deque< std::atomic<long long> > dequeCounters;
+
+	///	<summary>
+	///		All blocks and the stack of open blocks.
+	///	</summary>
+	std::vector<AnnounceProfileBlock> vecBlocks;
+	std::vector<AnnounceProfileFrame> vecStack;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Report the profile at exit.
+///	</summary>
+static void ReportAnnounceProfile();
+
+///	<summary>
+///		Get the profile of this process.  The profile is reported at exit,
+///		and since the handler is registered after the profile is
+///		constructed the profile is destroyed after it is reported.
+///	</summary>
+static AnnounceProfile & GetAnnounceProfile() {
+	static AnnounceProfile s_profile;
+	static bool s_fRegistered =
+		(!s_profile.fEnabled) || (atexit(ReportAnnounceProfile) == 0);
+
+	(void)s_fRegistered;
+	return s_profile;
+}
+
+static void ReportAnnounceProfile() {
+	GetAnnounceProfile().Report();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool AnnounceProfileEnabled() {
+	return GetAnnounceProfile().fEnabled;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+AnnounceCounter::AnnounceCounter(
+	const char * szName
+) :
+	m_pValue(NULL)
+{
+	AnnounceProfile & profile = GetAnnounceProfile();
+	if (!profile.fEnabled) {
+		return;
+	}
+
+	for (int c = 0; c < profile.vecCounterNames.size(); c++) {
+		if (profile.vecCounterNames[c] == szName) {
+			m_pValue = &(profile.dequeCounters[c]);
+			return;
+		}
+	}
+
+	profile.vecCounterNames.push_back(szName);
+	profile.dequeCounters.emplace_back(0);
+	m_pValue = &(profile.dequeCounters.back());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void AnnounceStartBlock(const char * szText) {
@@ -89,6 +508,12 @@ void AnnounceStartBlock(const char * szText) {
 	}
 	s_nIndentationLevel++;
 
+	// Blocks announced after the profile is reported are not recorded
+	AnnounceProfile & profile = GetAnnounceProfile();
+	if (profile.fEnabled && (profile.vecStack.size() != 0)) {
+		profile.StartBlock(szText);
+	}
+
 	fflush(NULL);
 }
 
@@ -127,6 +552,11 @@ void AnnounceEndBlock(const char * szText) {
 
 	s_nIndentationLevel--;
 
+	AnnounceProfile & profile = GetAnnounceProfile();
+	if (profile.fEnabled && (profile.vecStack.size() > 1)) {
+		profile.EndBlock();
+	}
+
 	fflush(NULL);
 }
 
@@ -22,6 +22,7 @@
 #define _ANNOUNCE_H_
 
 #include <cstdio>
+#include <atomic>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -47,5 +48,49 @@ void AnnounceBanner(const char * szText = NULL);
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Determine if profiling is enabled.  If the environment variable
+///		TEMPEST_PROFILE is set to 1, the wall time, CPU time, growth of the
+///		peak resident set size and counter totals of each announcement
+///		block are measured and printed as a tree at exit.  If
+///		TEMPEST_PROFILE_JSON is set to the name of a file, the tree is
+///		written to that file as JSON.
+///	</summary>
+bool AnnounceProfileEnabled();
+
+///	<summary>
+///		A named counter, reported in the profile for each announcement
+///		block during which it changes.  Counters are declared with static
+///		storage in the file which updates them, and counters with the same
+///		name are reported together.  Add may be called concurrently from
+///		several threads, and does nothing if profiling is disabled.
+///	</summary>
+class AnnounceCounter {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	AnnounceCounter(const char * szName);
+
+public:
+	///	<summary>
+	///		Add n to the counter.
+	///	</summary>
+	inline void Add(long long n) {
+		if (m_pValue != NULL) {
+			m_pValue->fetch_add(n, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	///	<summary>
+	///		Value of the counter, or NULL if profiling is disabled.
+	///	</summary>
+	std::atomic<long long> * m_pValue;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 #endif
 
@@ -19,6 +19,10 @@
 #include "Exception.h"
 #include "OfflineMap.h"
 
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void ParseVariableList(
@@ -54,8 +58,59 @@ void ParseVariableList(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Read a list of input and output data file pairs.  Each line of the
+///		file contains an input data file followed by an output data file;
+///		empty lines and lines beginning with '#' are ignored.
+///	</summary>
+void ReadDataFileList(
+	const std::string & strDataList,
+	std::vector< std::string > & vecInputData,
+	std::vector< std::string > & vecOutputData
+) {
+	FILE * fp = fopen(strDataList.c_str(), "r");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open data list \"%s\"", strDataList.c_str());
+	}
+
+	char szLine[4096];
+	char szInput[4096];
+	char szOutput[4096];
+	char szExtra[4096];
+
+	int iLine = 0;
+
+	while (fgets(szLine, sizeof(szLine), fp) != NULL) {
+		iLine++;
+
+		int nFiles = sscanf(szLine, "%4095s %4095s %4095s",
+			szInput, szOutput, szExtra);
+
+		if ((nFiles <= 0) || (szInput[0] == '#')) {
+			continue;
+		}
+
+		if (nFiles != 2) {
+			fclose(fp);
+			_EXCEPTION2("Line %i of data list \"%s\" must contain an "
+				"input and an output data file", iLine, strDataList.c_str());
+		}
+
+		vecInputData.push_back(szInput);
+		vecOutputData.push_back(szOutput);
+	}
+
+	fclose(fp);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 int main(int argc, char** argv) {
 
+#ifdef USE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+
 try {
 
 	// Input map file
@@ -67,6 +122,9 @@ try {
 	// Input data file
 	std::string strInputData;
 
+	// List of input and output data files
+	std::string strDataList;
+
 	// List of variables
 	std::string strVariables;
 
@@ -82,38 +140,86 @@ try {
 	// Name of the ncol variable
 	std::string strNColName;
 
+	// Memory budget for data buffers (in MB)
+	int nBatchMemoryMB;
+
+	// Overlap file input and output with remapping
+	bool fPipeline;
+
+	// Apply the map on an offload device
+	bool fGPU;
+
+	// Apply the map in single precision
+	bool fSinglePrecision;
+
+	// Tolerance on changes in the map due to single precision
+	double dSingleTolerance;
+
+	// Write NetCDF-4 output with chunked variables
+	bool fNetCDF4;
+
+	// Deflate level of NetCDF-4 output
+	int nDeflateLevel;
+
+	// Apply the shuffle filter to NetCDF-4 output
+	bool fShuffle;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strOutputData, "out_data", "");
 		CommandLineString(strInputMap, "map", "");
 		CommandLineString(strInputData, "in_data", "");
+		CommandLineString(strDataList, "data_list", "");
 		CommandLineString(strVariables, "var", "");
 		CommandLineString(strInputMap2, "map2", "");
 		CommandLineString(strInputData2, "in_data2", "");
 		CommandLineString(strVariables2, "var2", "");
 		CommandLineString(strNColName, "ncol_name", "ncol");
+		CommandLineInt(nBatchMemoryMB, "batch_mem", 256);
+		CommandLineBool(fPipeline, "pipeline");
+		CommandLineBool(fGPU, "gpu");
+		CommandLineBool(fSinglePrecision, "single");
+		CommandLineDouble(dSingleTolerance, "single_tol", 1.0e-6);
+		CommandLineBool(fNetCDF4, "netcdf4");
+		CommandLineInt(nDeflateLevel, "deflate", 0);
+		CommandLineBool(fShuffle, "shuffle");
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
 
 	AnnounceBanner();
 
+	// Format of NetCDF output files
+	NetCDFOutputOptions optNetCDF(fNetCDF4, nDeflateLevel, fShuffle);
+
 	// Check parameters
 	if (strInputMap == "") {
 		_EXCEPTIONT("No map specified");
 	}
-	if (strInputData == "") {
-		_EXCEPTIONT("No input data specified");
+	// Input and output data files, which are remapped concurrently
+	std::vector< std::string > vecInputData;
+	std::vector< std::string > vecOutputData;
+
+	ParseVariableList(strInputData, vecInputData);
+	ParseVariableList(strOutputData, vecOutputData);
+
+	if (vecInputData.size() != vecOutputData.size()) {
+		_EXCEPTIONT("in_data and out_data must list the same number of files");
 	}
-	if (strOutputData == "") {
-		_EXCEPTIONT("No output data specified");
+
+	if (strDataList != "") {
+		ReadDataFileList(strDataList, vecInputData, vecOutputData);
+	}
+
+	if (vecInputData.size() == 0) {
+		_EXCEPTIONT("No input data specified");
 	}
 
 	// Parse variable list
 	std::vector< std::string > vecVariableStrings;
 	ParseVariableList(strVariables, vecVariableStrings);
 
-	if ((strInputData != "") && (vecVariableStrings.size() == 0)) {
+	if (vecVariableStrings.size() == 0) {
 		_EXCEPTIONT("No variables specified");
 	}
 
@@ -127,10 +233,23 @@ try {
 		if (strInputMap2 == "") {
 			_EXCEPTIONT("No map specified for --in_data2");
 		}
+		if (vecOutputData.size() != 1) {
+			_EXCEPTIONT("--in_data2 requires a single output data file");
+		}
 	}
 	if ((strInputMap2 != "") && (strInputData2 == "")) {
 		_EXCEPTIONT("No input data specified for --map2");
 	}
+	if (nBatchMemoryMB < 1) {
+		_EXCEPTIONT("--batch_mem must be at least 1");
+	}
+#ifndef USE_PTHREADS
+	if (fPipeline) {
+		_EXCEPTIONT("--pipeline requires compilation with PTHREADS=True");
+	}
+#endif
+
+	size_t sMemoryBudget = static_cast<size_t>(nBatchMemoryMB) * 1024 * 1024;
 
 	// Apply OfflineMap to data
 	DataVector<double> vecDummyAreas;
@@ -145,15 +264,27 @@ try {
 	OfflineMap mapRemap;
 	mapRemap.Read(strInputMap);
 
+	if (fSinglePrecision) {
+		mapRemap.ConvertToSinglePrecision(
+			mapRemap.GetSourceAreas(),
+			mapRemap.GetTargetAreas(),
+			dSingleTolerance);
+	}
+
 	mapRemap.Apply(
 		vecDummyAreas,
 		vecDummyAreas,
-		strInputData,
-		strOutputData,
+		vecInputData,
+		vecOutputData,
 		vecVariableStrings,
 		strNColName,
 		false,
-		false);
+		false,
+		sMemoryBudget,
+		fPipeline,
+		optNetCDF,
+		true,
+		fGPU);
 	AnnounceEndBlock(NULL);
 
 	if (strInputMap2 != "") {
@@ -163,11 +294,16 @@ try {
 		OfflineMap mapRemap2;
 		mapRemap2.Read(strInputMap2);
 
+		if (fSinglePrecision) {
+			mapRemap2.ConvertToSinglePrecision(
+				mapRemap2.GetSourceAreas(),
+				mapRemap2.GetTargetAreas(),
+				dSingleTolerance);
+		}
+
 		// Verify consistency of maps
-		SparseMatrix<double> & smatRemap  = mapRemap .GetSparseMatrix();
-		SparseMatrix<double> & smatRemap2 = mapRemap2.GetSparseMatrix();
-		if ((smatRemap.GetRows() != smatRemap2.GetRows()) ||
-			(smatRemap.GetColumns() != smatRemap2.GetColumns())
+		if ((mapRemap.GetRows() != mapRemap2.GetRows()) ||
+			(mapRemap.GetColumns() != mapRemap2.GetColumns())
 		) {
 			_EXCEPTIONT("Mismatch in dimensions of input maps "
 				"--map and --map2");
@@ -177,11 +313,16 @@ try {
 			vecDummyAreas,
 			vecDummyAreas,
 			strInputData2,
-			strOutputData,
+			vecOutputData[0],
 			vecVariableStrings2,
 			strNColName,
 			false,
-			true);
+			true,
+			sMemoryBudget,
+			fPipeline,
+			optNetCDF,
+			true,
+			fGPU);
 
 		AnnounceEndBlock(NULL);
 	}
@@ -191,6 +332,10 @@ try {
 } catch(Exception & e) {
 	Announce(e.ToString().c_str());
 }
+
+#ifdef USE_MPI
+	MPI_Finalize();
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,1432 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    Benchmark.cpp
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "Announce.h"
+#include "CommandLine.h"
+#include "Exception.h"
+#include "DataVector.h"
+#include "GridElements.h"
+#include "MeshUtilitiesFuzzy.h"
+#include "MeshUtilitiesExact.h"
+#include "FixedPoint.h"
+#include "OverlapMesh.h"
+#include "OfflineMap.h"
+#include "SparseMatrix.h"
+#include "LinearRemapFV.h"
+#include "LinearRemapSE0.h"
+#include "FiniteElementTools.h"
+#include "FaceQuadratureTable.h"
+#include "GLLElementData.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Input files of the benchmarks.
+///	</summary>
+struct BenchmarkOptions {
+
+	///	<summary>
+	///		Cubed-sphere mesh (CSne30).
+	///	</summary>
+	std::string strCSMesh;
+
+	///	<summary>
+	///		Regular latitude-longitude mesh (RLL1deg).
+	///	</summary>
+	std::string strRLLMesh;
+
+	///	<summary>
+	///		Icosahedral mesh.
+	///	</summary>
+	std::string strICOMesh;
+
+	///	<summary>
+	///		Overlap mesh of the cubed-sphere and latitude-longitude meshes.
+	///	</summary>
+	std::string strOverlapMesh;
+
+	///	<summary>
+	///		Offline map file.
+	///	</summary>
+	std::string strMap;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Deterministic pseudo-random numbers, so that every run of a
+///		benchmark does the same work.
+///	</summary>
+class BenchmarkRandom {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	BenchmarkRandom(
+		unsigned long long ullSeed
+	) :
+		m_ullState(ullSeed)
+	{ }
+
+public:
+	///	<summary>
+	///		Uniformly distributed number in [0, 1).
+	///	</summary>
+	double Uniform() {
+		m_ullState =
+			m_ullState * 6364136223846793005ULL + 1442695040888963407ULL;
+		return static_cast<double>(m_ullState >> 11)
+			* (1.0 / 9007199254740992.0);
+	}
+
+	///	<summary>
+	///		Uniformly distributed Node on the unit sphere.
+	///	</summary>
+	Node UnitNode() {
+		double dZ = 2.0 * Uniform() - 1.0;
+		double dLon = 2.0 * M_PI * Uniform();
+		double dR = sqrt(1.0 - dZ * dZ);
+
+		return Node(dR * cos(dLon), dR * sin(dLon), dZ);
+	}
+
+private:
+	///	<summary>
+	///		State of the generator.
+	///	</summary>
+	unsigned long long m_ullState;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A benchmark, which is prepared once by Setup and then timed over
+///		several repetitions of Run.
+///	</summary>
+class Benchmark {
+
+public:
+	///	<summary>
+	///		Virtual destructor.
+	///	</summary>
+	virtual ~Benchmark() { }
+
+public:
+	///	<summary>
+	///		Name of the command line option of a missing input file, or an
+	///		empty string if all inputs are available.
+	///	</summary>
+	virtual std::string GetMissingInput() const {
+		return "";
+	}
+
+	///	<summary>
+	///		Prepare the benchmark.  Not timed.
+	///	</summary>
+	virtual void Setup() { }
+
+	///	<summary>
+	///		Run one timed repetition of the benchmark.
+	///	</summary>
+	virtual void Run() = 0;
+
+	///	<summary>
+	///		Units of work done by each repetition, for the throughput.
+	///	</summary>
+	virtual double GetWork() const = 0;
+
+	///	<summary>
+	///		Name of the units of work.
+	///	</summary>
+	virtual const char * GetUnit() const = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Load a Mesh as the command line tools do.
+///	</summary>
+static void LoadBenchmarkMesh(
+	const std::string & strFile,
+	Mesh & mesh
+) {
+	mesh.Read(strFile);
+	mesh.RemoveZeroEdges();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Locate random Nodes on the cubed-sphere mesh with its face tree.
+///	</summary>
+class FindFaceFromNodeBenchmark : public Benchmark {
+
+public:
+	FindFaceFromNodeBenchmark(
+		const BenchmarkOptions & opts
+	) :
+		m_opts(opts),
+		m_nFound(0)
+	{ }
+
+	virtual std::string GetMissingInput() const {
+		return (m_opts.strCSMesh == "")?("cs_mesh"):("");
+	}
+
+	virtual void Setup() {
+		LoadBenchmarkMesh(m_opts.strCSMesh, m_mesh);
+		m_mesh.ConstructFaceTree();
+
+		BenchmarkRandom random(1);
+		m_vecNodes.resize(100000);
+		for (int i = 0; i < m_vecNodes.size(); i++) {
+			m_vecNodes[i] = random.UnitNode();
+		}
+	}
+
+	virtual void Run() {
+		MeshUtilitiesFuzzy utils;
+		FindFaceStruct aFindFaceStruct;
+
+		for (int i = 0; i < m_vecNodes.size(); i++) {
+			utils.FindFaceFromNode(m_mesh, m_vecNodes[i], aFindFaceStruct);
+			m_nFound += aFindFaceStruct.vecFaceIndices.size();
+		}
+	}
+
+	virtual double GetWork() const {
+		return static_cast<double>(m_vecNodes.size());
+	}
+
+	virtual const char * GetUnit() const {
+		return "nodes";
+	}
+
+private:
+	const BenchmarkOptions & m_opts;
+	Mesh m_mesh;
+	std::vector<Node> m_vecNodes;
+	size_t m_nFound;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Intersect pairs of short crossing great circle arcs with the
+///		fuzzy or exact mesh utilities.
+///	</summary>
+template <class MeshUtilitiesType, class NodeType>
+class EdgeIntersectionsBenchmark : public Benchmark {
+
+public:
+	EdgeIntersectionsBenchmark(
+		const BenchmarkOptions & opts,
+		int nPairs
+	) :
+		m_nPairs(nPairs),
+		m_nIntersections(0)
+	{ }
+
+	virtual void Setup() {
+		BenchmarkRandom random(2);
+
+		m_vecNodes.resize(4 * m_nPairs);
+		for (int i = 0; i < m_nPairs; i++) {
+			Node nodeCenter = random.UnitNode();
+
+			for (int k = 0; k < 2; k++) {
+				Node nodeDir = random.UnitNode();
+
+				Node nodeBegin(
+					nodeCenter.x + 0.05 * nodeDir.x,
+					nodeCenter.y + 0.05 * nodeDir.y,
+					nodeCenter.z + 0.05 * nodeDir.z);
+				Node nodeEnd(
+					nodeCenter.x - 0.05 * nodeDir.x,
+					nodeCenter.y - 0.05 * nodeDir.y,
+					nodeCenter.z - 0.05 * nodeDir.z);
+
+				m_vecNodes[4*i+2*k  ] = UnitNode(nodeBegin);
+				m_vecNodes[4*i+2*k+1] = UnitNode(nodeEnd);
+			}
+		}
+	}
+
+	virtual void Run() {
+		MeshUtilitiesType utils;
+		std::vector<NodeType> vecIntersections;
+
+		for (int i = 0; i < m_nPairs; i++) {
+			vecIntersections.clear();
+			utils.CalculateEdgeIntersections(
+				m_vecNodes[4*i  ], m_vecNodes[4*i+1], Edge::Type_GreatCircleArc,
+				m_vecNodes[4*i+2], m_vecNodes[4*i+3], Edge::Type_GreatCircleArc,
+				vecIntersections);
+
+			m_nIntersections += vecIntersections.size();
+		}
+	}
+
+	virtual double GetWork() const {
+		return static_cast<double>(m_nPairs);
+	}
+
+	virtual const char * GetUnit() const {
+		return "pairs";
+	}
+
+private:
+	///	<summary>
+	///		Project a Node onto the unit sphere.
+	///	</summary>
+	static Node UnitNode(
+		const Node & node
+	) {
+		Real dMag = node.Magnitude();
+		return Node(node.x / dMag, node.y / dMag, node.z / dMag);
+	}
+
+private:
+	int m_nPairs;
+	std::vector<Node> m_vecNodes;
+	size_t m_nIntersections;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sum of products of FixedPoint numbers, as in the exact predicates.
+///	</summary>
+template <class FixedPointType>
+class FixedPointMultiplyAddBenchmark : public Benchmark {
+
+public:
+	FixedPointMultiplyAddBenchmark(
+		const BenchmarkOptions & opts
+	) :
+		m_dResult(0.0)
+	{ }
+
+	virtual void Setup() {
+		BenchmarkRandom random(3);
+
+		m_vecA.resize(100000);
+		m_vecB.resize(m_vecA.size());
+		for (int i = 0; i < m_vecA.size(); i++) {
+			m_vecA[i].Set(2.0 * random.Uniform() - 1.0);
+			m_vecB[i].Set(2.0 * random.Uniform() - 1.0);
+		}
+	}
+
+	virtual void Run() {
+		FixedPointType fpSum(0.0);
+		for (int i = 0; i < m_vecA.size(); i++) {
+			fpSum += m_vecA[i] * m_vecB[i];
+		}
+		m_dResult += fpSum.ToReal();
+	}
+
+	virtual double GetWork() const {
+		return static_cast<double>(m_vecA.size());
+	}
+
+	virtual const char * GetUnit() const {
+		return "ops";
+	}
+
+private:
+	std::vector<FixedPointType> m_vecA;
+	std::vector<FixedPointType> m_vecB;
+	double m_dResult;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Conversion of doubles to FixedPoint numbers and back.
+///	</summary>
+class FixedPointConvertBenchmark : public Benchmark {
+
+public:
+	FixedPointConvertBenchmark(
+		const BenchmarkOptions & opts
+	) :
+		m_dResult(0.0)
+	{ }
+
+	virtual void Setup() {
+		BenchmarkRandom random(4);
+
+		m_vecValues.resize(100000);
+		for (int i = 0; i < m_vecValues.size(); i++) {
+			m_vecValues[i] = 2.0 * random.Uniform() - 1.0;
+		}
+	}
+
+	virtual void Run() {
+		FixedPoint fp;
+		for (int i = 0; i < m_vecValues.size(); i++) {
+			fp.Set(m_vecValues[i]);
+			m_dResult += fp.ToReal();
+		}
+	}
+
+	virtual double GetWork() const {
+		return static_cast<double>(m_vecValues.size());
+	}
+
+	virtual const char * GetUnit() const {
+		return "ops";
+	}
+
+private:
+	std::vector<double> m_vecValues;
+	double m_dResult;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap mesh of two meshes in memory, after the same
+///		preparation of the meshes as GenerateOverlapMesh.
+///	</summary>
+class GenerateOverlapMeshBenchmark : public Benchmark {
+
+public:
+	GenerateOverlapMeshBenchmark(
+		const BenchmarkOptions & opts,
+		const std::string & strMeshA,
+		const std::string & strOptionA,
+		const std::string & strMeshB,
+		const std::string & strOptionB
+	) :
+		m_strMeshA(strMeshA),
+		m_strOptionA(strOptionA),
+		m_strMeshB(strMeshB),
+		m_strOptionB(strOptionB),
+		m_nOverlapFaces(0)
+	{ }
+
+	virtual std::string GetMissingInput() const {
+		if (m_strMeshA == "") {
+			return m_strOptionA;
+		}
+		if (m_strMeshB == "") {
+			return m_strOptionB;
+		}
+		return "";
+	}
+
+	virtual void Setup() {
+		LoadBenchmarkMesh(m_strMeshA, m_meshA);
+		LoadBenchmarkMesh(m_strMeshB, m_meshB);
+
+		m_meshA.ConstructEdgeMap();
+		m_meshB.ConstructEdgeMap();
+
+		m_meshA.ConstructReverseNodeArray();
+		m_meshB.ConstructReverseNodeArray();
+
+		EqualizeCoincidentNodes(m_meshA, m_meshB);
+
+		m_meshB.ConstructFaceTree();
+	}
+
+	virtual void Run() {
+		Mesh meshOverlap;
+		GenerateOverlapMesh(
+			m_meshA, m_meshB, meshOverlap, OverlapMeshMethod_Fuzzy);
+
+		m_nOverlapFaces = meshOverlap.faces.size();
+	}
+
+	virtual double GetWork() const {
+		return static_cast<double>(m_meshA.faces.size());
+	}
+
+	virtual const char * GetUnit() const {
+		return "faces";
+	}
+
+private:
+	std::string m_strMeshA;
+	std::string m_strOptionA;
+	std::string m_strMeshB;
+	std::string m_strOptionB;
+	Mesh m_meshA;
+	Mesh m_meshB;
+	size_t m_nOverlapFaces;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Base class of benchmarks which generate an offline map from the
+///		cubed-sphere mesh to the latitude-longitude mesh, after the same
+///		preparation of the meshes as gecore2.
+///	</summary>
+class LinearRemapBenchmark : public Benchmark {
+
+public:
+	LinearRemapBenchmark(
+		const BenchmarkOptions & opts
+	) :
+		m_opts(opts)
+	{ }
+
+	virtual std::string GetMissingInput() const {
+		if (m_opts.strCSMesh == "") {
+			return "cs_mesh";
+		}
+		if (m_opts.strRLLMesh == "") {
+			return "rll_mesh";
+		}
+		if (m_opts.strOverlapMesh == "") {
+			return "ov_mesh";
+		}
+		return "";
+	}
+
+	virtual void Setup() {
+		LoadBenchmarkMesh(m_opts.strCSMesh, m_meshInput);
+		m_meshInput.CalculateFaceAreas();
+
+		LoadBenchmarkMesh(m_opts.strRLLMesh, m_meshOutput);
+		m_meshOutput.CalculateFaceAreas();
+
+		LoadBenchmarkMesh(m_opts.strOverlapMesh, m_meshOverlap);
+
+		int ixFirstFaceMax =
+			m_meshOverlap.firstfaceindex.GetSourceFaceCount();
+
+		if (ixFirstFaceMax == m_meshOutput.faces.size()) {
+			m_meshOverlap.ExchangeFirstAndSecondMesh();
+
+		} else if (ixFirstFaceMax != m_meshInput.faces.size()) {
+			_EXCEPTIONT("Overlap mesh does not correspond to the cubed-sphere "
+				"and latitude-longitude meshes");
+		}
+
+		m_meshOverlap.ConstructOverlapIndex(
+			static_cast<int>(m_meshInput.faces.size()),
+			static_cast<int>(m_meshOutput.faces.size()));
+
+		m_meshOverlap.CalculateFaceAreas();
+
+		m_quadOverlap.Initialize(m_meshOverlap, RemapQuadratureOrder);
+	}
+
+	virtual double GetWork() const {
+		return static_cast<double>(m_meshOverlap.faces.size());
+	}
+
+	virtual const char * GetUnit() const {
+		return "faces";
+	}
+
+protected:
+	const BenchmarkOptions & m_opts;
+	Mesh m_meshInput;
+	Mesh m_meshOutput;
+	Mesh m_meshOverlap;
+	FaceQuadratureTable m_quadOverlap;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Finite volume to finite volume map of order nOrder.
+///	</summary>
+class LinearRemapFVtoFVBenchmark : public LinearRemapBenchmark {
+
+public:
+	LinearRemapFVtoFVBenchmark(
+		const BenchmarkOptions & opts,
+		int nOrder
+	) :
+		LinearRemapBenchmark(opts),
+		m_nOrder(nOrder)
+	{ }
+
+	virtual void Setup() {
+		LinearRemapBenchmark::Setup();
+		m_meshInput.ConstructReverseNodeArray();
+	}
+
+	virtual void Run() {
+		OfflineMap mapRemap;
+		LinearRemapFVtoFV(
+			m_meshInput,
+			m_meshOutput,
+			m_meshOverlap,
+			m_nOrder,
+			mapRemap,
+			NULL,
+			&m_quadOverlap);
+	}
+
+private:
+	int m_nOrder;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Spectral element (np = 4) to finite volume map.
+///	</summary>
+class LinearRemapSE4Benchmark : public LinearRemapBenchmark {
+
+public:
+	LinearRemapSE4Benchmark(
+		const BenchmarkOptions & opts
+	) :
+		LinearRemapBenchmark(opts)
+	{ }
+
+	virtual void Setup() {
+		LinearRemapBenchmark::Setup();
+		GenerateMetaData(
+			m_meshInput, 4, true, m_dataGLLNodes, m_dataGLLJacobian);
+	}
+
+	virtual void Run() {
+		OfflineMap mapRemap;
+		LinearRemapSE4(
+			m_meshInput,
+			m_meshOutput,
+			m_meshOverlap,
+			m_dataGLLNodes,
+			m_dataGLLJacobian,
+			false,
+			mapRemap,
+			&m_quadOverlap);
+	}
+
+private:
+	GLLElementData<int> m_dataGLLNodes;
+	GLLElementData<double> m_dataGLLJacobian;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Apply a random SparseMatrix, with the row lengths of a high order
+///		map, to one vector or to several interleaved vectors.
+///	</summary>
+class SparseMatrixApplyBenchmark : public Benchmark {
+
+public:
+	SparseMatrixApplyBenchmark(
+		const BenchmarkOptions & opts,
+		int nVectors
+	) :
+		m_nVectors(nVectors)
+	{ }
+
+	virtual void Setup() {
+		static const int Size = 500000;
+		static const int EntriesPerRow = 16;
+
+		BenchmarkRandom random(5);
+
+		for (int i = 0; i < Size; i++) {
+			int iColBegin = static_cast<int>(random.Uniform() * Size);
+			for (int k = 0; k < EntriesPerRow; k++) {
+				m_smat.Add(
+					i,
+					(iColBegin + k * k) % Size,
+					random.Uniform() / EntriesPerRow);
+			}
+		}
+		m_smat.Finalize();
+
+		m_vecIn.resize(static_cast<size_t>(m_smat.GetColumns()) * m_nVectors);
+		m_vecOut.resize(static_cast<size_t>(m_smat.GetRows()) * m_nVectors);
+		for (size_t i = 0; i < m_vecIn.size(); i++) {
+			m_vecIn[i] = random.Uniform();
+		}
+
+		m_dataIn.Initialize(m_smat.GetColumns());
+		m_dataOut.Initialize(m_smat.GetRows());
+		for (int i = 0; i < m_dataIn.GetRows(); i++) {
+			m_dataIn[i] = m_vecIn[i];
+		}
+	}
+
+	virtual void Run() {
+		if (m_nVectors == 1) {
+			m_smat.Apply(m_dataIn, m_dataOut);
+		} else {
+			m_smat.ApplyMultiple(&(m_vecIn[0]), &(m_vecOut[0]), m_nVectors);
+		}
+	}
+
+	virtual double GetWork() const {
+		return static_cast<double>(m_smat.GetNonZeros()) * m_nVectors;
+	}
+
+	virtual const char * GetUnit() const {
+		return "nonzeros";
+	}
+
+private:
+	int m_nVectors;
+	SparseMatrix<double> m_smat;
+	DataVector<double> m_dataIn;
+	DataVector<double> m_dataOut;
+	std::vector<double> m_vecIn;
+	std::vector<double> m_vecOut;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Read an offline map file.
+///	</summary>
+class OfflineMapReadBenchmark : public Benchmark {
+
+public:
+	OfflineMapReadBenchmark(
+		const BenchmarkOptions & opts
+	) :
+		m_opts(opts),
+		m_nNonZeros(0)
+	{ }
+
+	virtual std::string GetMissingInput() const {
+		return (m_opts.strMap == "")?("map"):("");
+	}
+
+	virtual void Run() {
+		OfflineMap mapRemap;
+		mapRemap.Read(m_opts.strMap);
+
+		m_nNonZeros = mapRemap.GetSparseMatrix().GetNonZeros();
+	}
+
+	virtual double GetWork() const {
+		return static_cast<double>(m_nNonZeros);
+	}
+
+	virtual const char * GetUnit() const {
+		return "nonzeros";
+	}
+
+private:
+	const BenchmarkOptions & m_opts;
+	int m_nNonZeros;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Apply an offline map to horizontal slices in memory.
+///	</summary>
+class OfflineMapApplyBenchmark : public Benchmark {
+
+public:
+	OfflineMapApplyBenchmark(
+		const BenchmarkOptions & opts
+	) :
+		m_opts(opts)
+	{ }
+
+	virtual std::string GetMissingInput() const {
+		return (m_opts.strMap == "")?("map"):("");
+	}
+
+	virtual void Setup() {
+		m_mapRemap.Read(m_opts.strMap);
+
+		BenchmarkRandom random(6);
+
+		m_vecIn.resize(
+			static_cast<size_t>(m_mapRemap.GetSourceSize()) * Levels);
+		m_vecOut.resize(
+			static_cast<size_t>(m_mapRemap.GetTargetSize()) * Levels);
+		for (size_t i = 0; i < m_vecIn.size(); i++) {
+			m_vecIn[i] = random.Uniform();
+		}
+	}
+
+	virtual void Run() {
+		m_mapRemap.Apply(&(m_vecIn[0]), &(m_vecOut[0]), Levels);
+	}
+
+	virtual double GetWork() const {
+		return static_cast<double>(m_mapRemap.GetSparseMatrix().GetNonZeros())
+			* Levels;
+	}
+
+	virtual const char * GetUnit() const {
+		return "nonzeros";
+	}
+
+private:
+	static const int Levels = 32;
+	const BenchmarkOptions & m_opts;
+	OfflineMap m_mapRemap;
+	std::vector<double> m_vecIn;
+	std::vector<double> m_vecOut;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Names of all benchmarks, in the order in which they are run.
+///	</summary>
+static const char * BenchmarkNames[] = {
+	"FindFaceFromNode",
+	"CalculateEdgeIntersections_Fuzzy",
+	"CalculateEdgeIntersections_Exact",
+	"FixedPoint_Decimal_MultiplyAdd",
+#ifdef __SIZEOF_INT128__
+	"FixedPoint_Binary_MultiplyAdd",
+#endif
+	"FixedPoint_Convert",
+	"GenerateOverlapMesh_CS_RLL",
+	"GenerateOverlapMesh_ICO_CS",
+	"LinearRemapFVtoFV_1",
+	"LinearRemapFVtoFV_2",
+	"LinearRemapFVtoFV_3",
+	"LinearRemapFVtoFV_4",
+	"LinearRemapSE4",
+	"SparseMatrix_Apply",
+	"SparseMatrix_ApplyMultiple",
+	"OfflineMap_Read",
+	"OfflineMap_Apply"
+};
+
+///	<summary>
+///		Create the benchmark with the given name.
+///	</summary>
+static Benchmark * CreateBenchmark(
+	const std::string & strName,
+	const BenchmarkOptions & opts
+) {
+	if (strName == "FindFaceFromNode") {
+		return new FindFaceFromNodeBenchmark(opts);
+	}
+	if (strName == "CalculateEdgeIntersections_Fuzzy") {
+		return new EdgeIntersectionsBenchmark<MeshUtilitiesFuzzy, Node>(
+			opts, 100000);
+	}
+	if (strName == "CalculateEdgeIntersections_Exact") {
+		return new EdgeIntersectionsBenchmark<MeshUtilitiesExact, NodeExact>(
+			opts, 10000);
+	}
+	if (strName == "FixedPoint_Decimal_MultiplyAdd") {
+		return new FixedPointMultiplyAddBenchmark<
+			FixedPointT<FixedPointBackend_Decimal> >(opts);
+	}
+#ifdef __SIZEOF_INT128__
+	if (strName == "FixedPoint_Binary_MultiplyAdd") {
+		return new FixedPointMultiplyAddBenchmark<
+			FixedPointT<FixedPointBackend_Binary> >(opts);
+	}
+#endif
+	if (strName == "FixedPoint_Convert") {
+		return new FixedPointConvertBenchmark(opts);
+	}
+	if (strName == "GenerateOverlapMesh_CS_RLL") {
+		return new GenerateOverlapMeshBenchmark(
+			opts, opts.strCSMesh, "cs_mesh", opts.strRLLMesh, "rll_mesh");
+	}
+	if (strName == "GenerateOverlapMesh_ICO_CS") {
+		return new GenerateOverlapMeshBenchmark(
+			opts, opts.strICOMesh, "ico_mesh", opts.strCSMesh, "cs_mesh");
+	}
+	if (strName == "LinearRemapFVtoFV_1") {
+		return new LinearRemapFVtoFVBenchmark(opts, 1);
+	}
+	if (strName == "LinearRemapFVtoFV_2") {
+		return new LinearRemapFVtoFVBenchmark(opts, 2);
+	}
+	if (strName == "LinearRemapFVtoFV_3") {
+		return new LinearRemapFVtoFVBenchmark(opts, 3);
+	}
+	if (strName == "LinearRemapFVtoFV_4") {
+		return new LinearRemapFVtoFVBenchmark(opts, 4);
+	}
+	if (strName == "LinearRemapSE4") {
+		return new LinearRemapSE4Benchmark(opts);
+	}
+	if (strName == "SparseMatrix_Apply") {
+		return new SparseMatrixApplyBenchmark(opts, 1);
+	}
+	if (strName == "SparseMatrix_ApplyMultiple") {
+		return new SparseMatrixApplyBenchmark(opts, 16);
+	}
+	if (strName == "OfflineMap_Read") {
+		return new OfflineMapReadBenchmark(opts);
+	}
+	if (strName == "OfflineMap_Apply") {
+		return new OfflineMapApplyBenchmark(opts);
+	}
+
+	_EXCEPTION1("Unknown benchmark \"%s\"", strName.c_str());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Result of a benchmark.
+///	</summary>
+struct BenchmarkResult {
+
+	BenchmarkResult() :
+		nRepeats(0),
+		dMedianTime(0.0),
+		dMinTime(0.0),
+		dWork(0.0),
+		lPeakRSS(0),
+		dBaselineTime(0.0)
+	{ }
+
+	///	<summary>
+	///		Name of the benchmark.
+	///	</summary>
+	std::string strName;
+
+	///	<summary>
+	///		Status of the benchmark (ok, skipped or failed).
+	///	</summary>
+	std::string strStatus;
+
+	///	<summary>
+	///		Number of timed repetitions.
+	///	</summary>
+	int nRepeats;
+
+	///	<summary>
+	///		Median and minimum wall time of one repetition, in seconds.
+	///	</summary>
+	double dMedianTime;
+	double dMinTime;
+
+	///	<summary>
+	///		Units of work done by one repetition.
+	///	</summary>
+	double dWork;
+	std::string strUnit;
+
+	///	<summary>
+	///		Peak resident set size of the process running the benchmark,
+	///		in kilobytes.
+	///	</summary>
+	long lPeakRSS;
+
+	///	<summary>
+	///		Median wall time of the baseline, or zero if there is none.
+	///	</summary>
+	double dBaselineTime;
+
+	///	<summary>
+	///		Throughput in units of work per second.
+	///	</summary>
+	double GetThroughput() const {
+		return (dMedianTime > 0.0)?(dWork / dMedianTime):(0.0);
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Set up and time a benchmark in this process, writing the result to
+///		file descriptor fd.  Returns the exit status of the process.
+///	</summary>
+static int RunBenchmarkChild(
+	const std::string & strName,
+	const BenchmarkOptions & opts,
+	int nRepeats,
+	int fd
+) {
+	int iStatus = 0;
+
+#ifdef USE_MPI
+	MPI_Init(NULL, NULL);
+#endif
+
+	try {
+		std::unique_ptr<Benchmark> pBenchmark(CreateBenchmark(strName, opts));
+
+		pBenchmark->Setup();
+
+		std::vector<double> vecTimes(nRepeats);
+		for (int r = 0; r < nRepeats; r++) {
+			std::chrono::steady_clock::time_point tpBegin =
+				std::chrono::steady_clock::now();
+
+			pBenchmark->Run();
+
+			vecTimes[r] = std::chrono::duration<double>(
+				std::chrono::steady_clock::now() - tpBegin).count();
+		}
+
+		std::sort(vecTimes.begin(), vecTimes.end());
+
+		double dMedianTime = vecTimes[nRepeats / 2];
+		if (nRepeats % 2 == 0) {
+			dMedianTime = 0.5 * (dMedianTime + vecTimes[nRepeats / 2 - 1]);
+		}
+
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+
+		char szResult[256];
+		int nLength = snprintf(szResult, sizeof(szResult),
+			"%.9e %.9e %.9e %ld %s\n",
+			dMedianTime,
+			vecTimes[0],
+			pBenchmark->GetWork(),
+			static_cast<long>(usage.ru_maxrss),
+			pBenchmark->GetUnit());
+
+		if (write(fd, szResult, nLength) != nLength) {
+			iStatus = 1;
+		}
+
+	} catch(Exception & e) {
+		fprintf(stderr, "%s\n", e.ToString().c_str());
+		iStatus = 1;
+
+	} catch(std::exception & e) {
+		fprintf(stderr, "%s\n", e.what());
+		iStatus = 1;
+	}
+
+#ifdef USE_MPI
+	MPI_Finalize();
+#endif
+
+	return iStatus;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Run a benchmark in a child process, so that the peak memory of
+///		each benchmark is measured separately and a failure does not
+///		affect the other benchmarks.
+///	</summary>
+static void RunBenchmark(
+	const BenchmarkOptions & opts,
+	int nRepeats,
+	bool fVerbose,
+	BenchmarkResult & result
+) {
+	std::unique_ptr<Benchmark> pBenchmark(
+		CreateBenchmark(result.strName, opts));
+
+	std::string strMissingInput = pBenchmark->GetMissingInput();
+	if (strMissingInput != "") {
+		Announce("%s skipped (no --%s)",
+			result.strName.c_str(), strMissingInput.c_str());
+		result.strStatus = "skipped";
+		return;
+	}
+
+	int fd[2];
+	if (pipe(fd) != 0) {
+		_EXCEPTIONT("Unable to create pipe");
+	}
+
+	fflush(stdout);
+	fflush(stderr);
+
+	pid_t pid = fork();
+	if (pid < 0) {
+		_EXCEPTIONT("Unable to fork benchmark process");
+	}
+
+	if (pid == 0) {
+		close(fd[0]);
+		if (!fVerbose) {
+			if (freopen("/dev/null", "w", stdout) == NULL) {
+				_exit(1);
+			}
+		}
+		int iStatus = RunBenchmarkChild(result.strName, opts, nRepeats, fd[1]);
+		fflush(stdout);
+		fflush(stderr);
+		_exit(iStatus);
+	}
+
+	close(fd[1]);
+
+	std::string strOutput;
+	char szBuffer[256];
+	for (;;) {
+		ssize_t sRead = read(fd[0], szBuffer, sizeof(szBuffer));
+		if (sRead <= 0) {
+			break;
+		}
+		strOutput.append(szBuffer, sRead);
+	}
+	close(fd[0]);
+
+	int iStatus;
+	if (waitpid(pid, &iStatus, 0) != pid) {
+		_EXCEPTIONT("Unable to wait for benchmark process");
+	}
+
+	char szUnit[64];
+	if (!WIFEXITED(iStatus) || (WEXITSTATUS(iStatus) != 0) ||
+		(sscanf(strOutput.c_str(), "%lf %lf %lf %ld %63s",
+			&(result.dMedianTime),
+			&(result.dMinTime),
+			&(result.dWork),
+			&(result.lPeakRSS),
+			szUnit) != 5)
+	) {
+		Announce("%s FAILED", result.strName.c_str());
+		result.strStatus = "failed";
+		return;
+	}
+
+	result.strStatus = "ok";
+	result.nRepeats = nRepeats;
+	result.strUnit = szUnit;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Parse a comma separated list.
+///	</summary>
+static void ParseBenchmarkList(
+	const std::string & strList,
+	std::vector<std::string> & vecItems
+) {
+	size_t iBegin = 0;
+	while (iBegin <= strList.length()) {
+		size_t iEnd = strList.find(',', iBegin);
+		if (iEnd == std::string::npos) {
+			iEnd = strList.length();
+		}
+		if (iEnd != iBegin) {
+			vecItems.push_back(strList.substr(iBegin, iEnd - iBegin));
+		}
+		iBegin = iEnd + 1;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Header of the CSV results.
+///	</summary>
+static const char * BenchmarkCSVHeader =
+	"name,status,repeats,median_s,min_s,work,unit,throughput,peak_rss_kb";
+
+///	<summary>
+///		Write results as CSV.
+///	</summary>
+static void WriteBenchmarkCSV(
+	const std::string & strFile,
+	const std::vector<BenchmarkResult> & vecResults
+) {
+	FILE * fp = fopen(strFile.c_str(), "w");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open output file \"%s\"", strFile.c_str());
+	}
+
+	fprintf(fp, "%s\n", BenchmarkCSVHeader);
+	for (int i = 0; i < vecResults.size(); i++) {
+		const BenchmarkResult & result = vecResults[i];
+		fprintf(fp, "%s,%s,%i,%.6e,%.6e,%.6e,%s,%.6e,%ld\n",
+			result.strName.c_str(),
+			result.strStatus.c_str(),
+			result.nRepeats,
+			result.dMedianTime,
+			result.dMinTime,
+			result.dWork,
+			result.strUnit.c_str(),
+			result.GetThroughput(),
+			result.lPeakRSS);
+	}
+
+	if (fclose(fp) != 0) {
+		_EXCEPTION1("Unable to write output file \"%s\"", strFile.c_str());
+	}
+}
+
+///	<summary>
+///		Write results as JSON.
+///	</summary>
+static void WriteBenchmarkJSON(
+	const std::string & strFile,
+	const std::vector<BenchmarkResult> & vecResults
+) {
+	FILE * fp = fopen(strFile.c_str(), "w");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open output file \"%s\"", strFile.c_str());
+	}
+
+	fprintf(fp, "{\n  \"benchmarks\": [\n");
+	for (int i = 0; i < vecResults.size(); i++) {
+		const BenchmarkResult & result = vecResults[i];
+		fprintf(fp, "    {\"name\": \"%s\", \"status\": \"%s\", "
+			"\"repeats\": %i, \"median_s\": %.6e, \"min_s\": %.6e, "
+			"\"work\": %.6e, \"unit\": \"%s\", \"throughput\": %.6e, "
+			"\"peak_rss_kb\": %ld",
+			result.strName.c_str(),
+			result.strStatus.c_str(),
+			result.nRepeats,
+			result.dMedianTime,
+			result.dMinTime,
+			result.dWork,
+			result.strUnit.c_str(),
+			result.GetThroughput(),
+			result.lPeakRSS);
+
+		if (result.dBaselineTime > 0.0) {
+			fprintf(fp, ", \"baseline_median_s\": %.6e", result.dBaselineTime);
+		}
+		fprintf(fp, "}%s\n", (i == vecResults.size() - 1)?(""):(","));
+	}
+	fprintf(fp, "  ]\n}\n");
+
+	if (fclose(fp) != 0) {
+		_EXCEPTION1("Unable to write output file \"%s\"", strFile.c_str());
+	}
+}
+
+///	<summary>
+///		Read the median times of the successful benchmarks of a baseline
+///		written with --csv.
+///	</summary>
+static void ReadBenchmarkBaseline(
+	const std::string & strFile,
+	std::map<std::string, double> & mapBaseline
+) {
+	FILE * fp = fopen(strFile.c_str(), "r");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open baseline file \"%s\"", strFile.c_str());
+	}
+
+	char szLine[1024];
+	if ((fgets(szLine, sizeof(szLine), fp) == NULL) ||
+		(std::string(szLine).find(BenchmarkCSVHeader) != 0)
+	) {
+		fclose(fp);
+		_EXCEPTION1("Invalid baseline file \"%s\"", strFile.c_str());
+	}
+
+	while (fgets(szLine, sizeof(szLine), fp) != NULL) {
+		std::vector<std::string> vecFields;
+		ParseBenchmarkList(szLine, vecFields);
+
+		if ((vecFields.size() >= 4) && (vecFields[1] == "ok")) {
+			mapBaseline[vecFields[0]] = atof(vecFields[3].c_str());
+		}
+	}
+
+	fclose(fp);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+try {
+
+	// Input files
+	BenchmarkOptions opts;
+
+	// Benchmarks to run
+	std::string strBenchmarks;
+
+	// Number of timed repetitions of each benchmark
+	int nRepeats;
+
+	// Output CSV file
+	std::string strOutputCSV;
+
+	// Output JSON file
+	std::string strOutputJSON;
+
+	// Baseline CSV file
+	std::string strBaseline;
+
+	// Relative slowdown from the baseline reported as a regression
+	double dTolerance;
+
+	// List the benchmarks
+	bool fList;
+
+	// Show the output of the benchmarked functions
+	bool fVerbose;
+
+	// Parse the command line
+	BeginCommandLine()
+		CommandLineString(opts.strCSMesh, "cs_mesh", "");
+		CommandLineString(opts.strRLLMesh, "rll_mesh", "");
+		CommandLineString(opts.strICOMesh, "ico_mesh", "");
+		CommandLineString(opts.strOverlapMesh, "ov_mesh", "");
+		CommandLineString(opts.strMap, "map", "");
+		CommandLineString(strBenchmarks, "bench", "");
+		CommandLineInt(nRepeats, "repeat", 5);
+		CommandLineString(strOutputCSV, "csv", "");
+		CommandLineString(strOutputJSON, "json", "");
+		CommandLineString(strBaseline, "baseline", "");
+		CommandLineDouble(dTolerance, "tolerance", 0.1);
+		CommandLineBool(fList, "list");
+		CommandLineBool(fVerbose, "verbose");
+
+		ParseCommandLine(argc, argv);
+	EndCommandLine(argv)
+
+	AnnounceBanner();
+
+	const int nBenchmarkNames =
+		sizeof(BenchmarkNames) / sizeof(BenchmarkNames[0]);
+
+	if (fList) {
+		for (int i = 0; i < nBenchmarkNames; i++) {
+			Announce("%s", BenchmarkNames[i]);
+		}
+		return (0);
+	}
+
+	// Check parameters
+	if (nRepeats < 1) {
+		_EXCEPTIONT("--repeat must be at least 1");
+	}
+	if (dTolerance < 0.0) {
+		_EXCEPTIONT("--tolerance must be nonnegative");
+	}
+
+	// Benchmarks selected by name or by prefix of their name
+	std::vector<std::string> vecSelected;
+	ParseBenchmarkList(strBenchmarks, vecSelected);
+
+	std::vector<BenchmarkResult> vecResults;
+	for (int i = 0; i < nBenchmarkNames; i++) {
+		std::string strName = BenchmarkNames[i];
+
+		bool fSelected = (vecSelected.size() == 0);
+		for (int s = 0; s < vecSelected.size(); s++) {
+			if (strName.compare(0, vecSelected[s].length(), vecSelected[s]) == 0) {
+				fSelected = true;
+			}
+		}
+
+		if (fSelected) {
+			vecResults.push_back(BenchmarkResult());
+			vecResults.back().strName = strName;
+		}
+	}
+
+	if (vecResults.size() == 0) {
+		_EXCEPTION1("No benchmarks match \"%s\"", strBenchmarks.c_str());
+	}
+
+	std::map<std::string, double> mapBaseline;
+	if (strBaseline != "") {
+		ReadBenchmarkBaseline(strBaseline, mapBaseline);
+	}
+
+	// Run benchmarks
+	AnnounceStartBlock("Running benchmarks");
+
+	int nFailed = 0;
+	int nRegressions = 0;
+
+	for (int i = 0; i < vecResults.size(); i++) {
+		BenchmarkResult & result = vecResults[i];
+
+		RunBenchmark(opts, nRepeats, fVerbose, result);
+
+		if (result.strStatus == "failed") {
+			nFailed++;
+		}
+		if (result.strStatus != "ok") {
+			continue;
+		}
+
+		Announce("%-34s %11.4e s  %11.4e %s/s  %8li KB",
+			result.strName.c_str(),
+			result.dMedianTime,
+			result.GetThroughput(),
+			result.strUnit.c_str(),
+			result.lPeakRSS);
+
+		std::map<std::string, double>::const_iterator iter =
+			mapBaseline.find(result.strName);
+
+		if ((iter != mapBaseline.end()) && (iter->second > 0.0)) {
+			result.dBaselineTime = iter->second;
+
+			double dChange = result.dMedianTime / result.dBaselineTime - 1.0;
+			if (dChange > dTolerance) {
+				Announce("  REGRESSION: %+.1f%% relative to baseline",
+					100.0 * dChange);
+				nRegressions++;
+			} else {
+				Announce("  %+.1f%% relative to baseline", 100.0 * dChange);
+			}
+		}
+	}
+
+	AnnounceEndBlock(NULL);
+
+	// Write results
+	if (strOutputCSV != "") {
+		WriteBenchmarkCSV(strOutputCSV, vecResults);
+	}
+	if (strOutputJSON != "") {
+		WriteBenchmarkJSON(strOutputJSON, vecResults);
+	}
+
+	if (nFailed != 0) {
+		Announce("%i benchmark(s) failed", nFailed);
+	}
+	if (nRegressions != 0) {
+		Announce("%i regression(s) beyond tolerance %1.2f",
+			nRegressions, dTolerance);
+	}
+
+	AnnounceBanner();
+
+	return ((nFailed != 0) || (nRegressions != 0))?(1):(0);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
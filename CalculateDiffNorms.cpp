@@ -20,12 +20,215 @@
 #include "GaussLobattoQuadrature.h"
 #include "Exception.h"
 #include "Announce.h"
-#include "DataMatrix3D.h"
+#include "GLLElementData.h"
 
 #include "netcdfcpp.h"
 
 #include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Parse a list of comma or space separated strings.
+///	</summary>
+void ParseVariableList(
+	const std::string & strVariables,
+	std::vector< std::string > & vecVariableStrings
+) {
+	int iVarBegin = 0;
+	int iVarCurrent = 0;
+
+	// Parse variable name
+	for (;;) {
+		if ((iVarCurrent >= strVariables.length()) ||
+			(strVariables[iVarCurrent] == ',') ||
+			(strVariables[iVarCurrent] == ' ')
+		) {
+			if (iVarCurrent != iVarBegin) {
+				vecVariableStrings.push_back(
+					strVariables.substr(iVarBegin, iVarCurrent - iVarBegin));
+			}
+
+			if (iVarCurrent >= strVariables.length()) {
+				break;
+			}
+
+			iVarBegin = iVarCurrent + 1;
+		}
+
+		iVarCurrent++;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Norms of the difference between two fields.
+///	</summary>
+struct DiffNorms {
+	double dNormL1;
+	double dNormL2;
+	double dNormLi;
+	double dNormLmin;
+	double dNormLmax;
+
+	double dSumL1;
+	double dSumL2;
+	double dSumLi;
+
+	double dMinA;
+	double dMaxA;
+	double dMinB;
+	double dMaxB;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Calculate the norms of the difference between dDataA and dDataB,
+///		weighted by dArea.  Weighted sums are compensated and computed in
+///		blocks of fixed length, so the norms do not depend on the number
+///		of threads.  dWork must hold 4 * nTotalDataSize values.
+///	</summary>
+void CalculateDiffNorms(
+	int nTotalDataSize,
+	const double * dDataA,
+	const double * dDataB,
+	const double * dArea,
+	double * dWork,
+	DiffNorms & norms
+) {
+	const int BlockSize = 4096;
+
+	if (nTotalDataSize <= 0) {
+		_EXCEPTIONT("No data to compare");
+	}
+
+	int nBlocks = (nTotalDataSize + BlockSize - 1) / BlockSize;
+
+	// Weighted terms of each sum
+	double * dTermL1 = dWork;
+	double * dTermL2 = dWork + nTotalDataSize;
+	double * dTermSumL1 = dWork + 2 * nTotalDataSize;
+	double * dTermSumL2 = dWork + 3 * nTotalDataSize;
+
+	// Extrema of each block
+	std::vector<double> vecBlockMinA(nBlocks);
+	std::vector<double> vecBlockMaxA(nBlocks);
+	std::vector<double> vecBlockMinB(nBlocks);
+	std::vector<double> vecBlockMaxB(nBlocks);
+	std::vector<double> vecBlockLi(nBlocks);
+	std::vector<double> vecBlockSumLi(nBlocks);
+
+#pragma omp parallel for schedule(static)
+	for (int b = 0; b < nBlocks; b++) {
+		int ixBegin = b * BlockSize;
+		int ixEnd = ixBegin + BlockSize;
+		if (ixEnd > nTotalDataSize) {
+			ixEnd = nTotalDataSize;
+		}
+
+		double dMinA = dDataA[ixBegin];
+		double dMaxA = dDataA[ixBegin];
+		double dMinB = dDataB[ixBegin];
+		double dMaxB = dDataB[ixBegin];
+		double dLi = 0.0;
+		double dSumLi = 0.0;
+
+		for (int i = ixBegin; i < ixEnd; i++) {
+			if (dDataA[i] > dMaxA) {
+				dMaxA = dDataA[i];
+			}
+			if (dDataA[i] < dMinA) {
+				dMinA = dDataA[i];
+			}
+
+			if (dDataB[i] > dMaxB) {
+				dMaxB = dDataB[i];
+			}
+			if (dDataB[i] < dMinB) {
+				dMinB = dDataB[i];
+			}
+
+			double dDiff = fabs(dDataA[i] - dDataB[i]);
+
+			dTermL1[i] = dDiff * dArea[i];
+			dTermL2[i] = dDiff * dDiff * dArea[i];
+
+			if (dDiff > dLi) {
+				dLi = dDiff;
+			}
+
+			dTermSumL1[i] = dDataB[i] * dArea[i];
+			dTermSumL2[i] = dDataB[i] * dDataB[i] * dArea[i];
+
+			if (dDataB[i] > dSumLi) {
+				dSumLi = dDataB[i];
+			}
+		}
+
+		vecBlockMinA[b] = dMinA;
+		vecBlockMaxA[b] = dMaxA;
+		vecBlockMinB[b] = dMinB;
+		vecBlockMaxB[b] = dMaxB;
+		vecBlockLi[b] = dLi;
+		vecBlockSumLi[b] = dSumLi;
+	}
+
+	// Combine extrema
+	norms.dMinA = vecBlockMinA[0];
+	norms.dMaxA = vecBlockMaxA[0];
+	norms.dMinB = vecBlockMinB[0];
+	norms.dMaxB = vecBlockMaxB[0];
+	norms.dNormLi = 0.0;
+	norms.dSumLi = 0.0;
+
+	for (int b = 0; b < nBlocks; b++) {
+		if (vecBlockMinA[b] < norms.dMinA) {
+			norms.dMinA = vecBlockMinA[b];
+		}
+		if (vecBlockMaxA[b] > norms.dMaxA) {
+			norms.dMaxA = vecBlockMaxA[b];
+		}
+		if (vecBlockMinB[b] < norms.dMinB) {
+			norms.dMinB = vecBlockMinB[b];
+		}
+		if (vecBlockMaxB[b] > norms.dMaxB) {
+			norms.dMaxB = vecBlockMaxB[b];
+		}
+		if (vecBlockLi[b] > norms.dNormLi) {
+			norms.dNormLi = vecBlockLi[b];
+		}
+		if (vecBlockSumLi[b] > norms.dSumLi) {
+			norms.dSumLi = vecBlockSumLi[b];
+		}
+	}
+
+	// Min / Max Norm
+	if (norms.dMaxB == norms.dMinB) {
+		norms.dNormLmin = norms.dMinB - norms.dMinA;
+		norms.dNormLmax = norms.dMaxA - norms.dMaxB;
+	} else {
+		norms.dNormLmin =
+			(norms.dMinB - norms.dMinA) / (norms.dMaxB - norms.dMinB);
+		norms.dNormLmax =
+			(norms.dMaxA - norms.dMaxB) / (norms.dMaxB - norms.dMinB);
+	}
+
+	// Norms and Sums
+	norms.dSumL1 = CompensatedSum(dTermSumL1, nTotalDataSize);
+	norms.dSumL2 = CompensatedSum(dTermSumL2, nTotalDataSize);
+
+	norms.dNormL1 =
+		CompensatedSum(dTermL1, nTotalDataSize) / norms.dSumL1;
+	norms.dNormL2 =
+		sqrt(CompensatedSum(dTermL2, nTotalDataSize) / norms.dSumL2);
+	norms.dNormLi =
+		norms.dNormLi / norms.dSumLi;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -37,8 +240,8 @@ try {
 	// Second data file
 	std::string strFileB;
 
-	// Variable to compare
-	std::string strVariableName;
+	// Variables to compare
+	std::string strVariableNames;
 
 	// Mesh file to use
 	std::string strMeshFile;
@@ -55,23 +258,27 @@ try {
 	// Output filename
 	std::string strOutputFile;
 
+	// Read the mesh through a binary cache next to the mesh file
+	bool fMeshCache;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strFileA, "a", "");
 		CommandLineString(strFileB, "b", "");
-		CommandLineString(strVariableName, "var", "Psi");
+		CommandLineString(strVariableNames, "var", "Psi");
 		CommandLineBool(fGLL, "gll");
 		CommandLineInt(nP, "np", 4);
 		CommandLineBool(fBubble, "bubble");
 		CommandLineString(strMeshFile, "mesh", "");
 		CommandLineString(strOutputFile, "outfile", "");
+		CommandLineBool(fMeshCache, "mesh_cache");
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
 
 	// Input mesh
 	AnnounceStartBlock("Loading Mesh");
-	Mesh mesh(strMeshFile);
+	Mesh mesh(strMeshFile, fMeshCache);
 
 	// Check for rectilinear Mesh
 	NcFile ncMesh(strMeshFile.c_str(), NcFile::ReadOnly);
@@ -140,173 +347,197 @@ try {
 	// Finite elements
 	} else {
 		// Calculate pointwise areas
-		DataMatrix3D<int> dataGLLnodes;
-		DataMatrix3D<double> dataGLLJacobian;
+		GLLElementData<int> dataGLLnodes;
+		GLLElementData<double> dataGLLJacobian;
 
 		GenerateMetaData(mesh, nP, fBubble, dataGLLnodes, dataGLLJacobian);
 
 		GenerateUniqueJacobian(
 			dataGLLnodes, dataGLLJacobian, dataUniqueJacobian);
 
-		for (int s = 0; s < nP; s++) {
-		for (int t = 0; t < nP; t++) {
-		for (int i = 0; i < dataGLLnodes.GetSubColumns(); i++) {
-			if (dataGLLnodes[s][t][i] > vecOutputDimSizes[0]) {
-				vecOutputDimSizes[0] = dataGLLnodes[s][t][i];
+		for (int i = 0; i < dataGLLnodes.GetElements(); i++) {
+			const int * pNodes = dataGLLnodes[i];
+
+			for (int s = 0; s < nP * nP; s++) {
+				if (pNodes[s] > vecOutputDimSizes[0]) {
+					vecOutputDimSizes[0] = pNodes[s];
+				}
 			}
 		}
-		}
-		}
 
 		nTotalDataSize = vecOutputDimSizes[0];
 	}
 
-	// Load data from file A
-	AnnounceStartBlock("Loading data from file A");
-
-	DataVector<double> dDataA;
-	dDataA.Initialize(nTotalDataSize);
+	// Variables to compare
+	std::vector<std::string> vecVariableNames;
+	ParseVariableList(strVariableNames, vecVariableNames);
 
-	NcFile ncFileA(strFileA.c_str(), NcFile::ReadOnly);
+	if (vecVariableNames.size() == 0) {
+		_EXCEPTIONT("No variables specified (--var)");
+	}
 
-	NcVar * varA = ncFileA.get_var(strVariableName.c_str());
+	int nVariables = static_cast<int>(vecVariableNames.size());
 
-	varA->get(&(dDataA[0]), &(vecOutputDimSizes[0]));
+	// Area of each data point
+	const double * dArea;
 
-	ncFileA.close();
+	if (!fGLL) {
+		mesh.CalculateFaceAreas();
 
-	AnnounceEndBlock("Done");
+		if (mesh.vecFaceArea.GetRows() < nTotalDataSize) {
+			_EXCEPTIONT("Mesh is too small for the data");
+		}
+		dArea = &(mesh.vecFaceArea[0]);
 
-	// Load data from file B
-	AnnounceStartBlock("Loading data from file B");
+	} else {
+		dArea = &(dataUniqueJacobian[0]);
+	}
 
-	DataVector<double> dDataB;
-	dDataB.Initialize(nTotalDataSize);
+	// Open data files
+	NcFile ncFileA(strFileA.c_str(), NcFile::ReadOnly);
+	if (!ncFileA.is_valid()) {
+		_EXCEPTION1("Unable to open data file \"%s\"", strFileA.c_str());
+	}
 
 	NcFile ncFileB(strFileB.c_str(), NcFile::ReadOnly);
+	if (!ncFileB.is_valid()) {
+		_EXCEPTION1("Unable to open data file \"%s\"", strFileB.c_str());
+	}
 
-	NcVar * varB = ncFileB.get_var(strVariableName.c_str());
+	// Data of one level of each variable
+	DataVector<double> dDataA;
+	dDataA.Initialize(nTotalDataSize);
 
-	varB->get(&(dDataB[0]), &(vecOutputDimSizes[0]));
+	DataVector<double> dDataB;
+	dDataB.Initialize(nTotalDataSize);
 
-	ncFileB.close();
+	DataVector<double> dWork;
+	dWork.Initialize(4 * nTotalDataSize);
 
-	AnnounceEndBlock("Done");
+	// Output file
+	FILE * fpOutput = NULL;
+	if (strOutputFile != "") {
+		fpOutput = fopen(strOutputFile.c_str(), "a");
+		if (fpOutput == NULL) {
+			_EXCEPTION1("Unable to open output file \"%s\"",
+				strOutputFile.c_str());
+		}
+	}
 
-	// Calculate the difference and store in dDataA
-	double dMaxA = dDataA[0];
-	double dMinA = dDataA[0];
+	int nSpatialDims = static_cast<int>(vecOutputDimSizes.size());
 
-	double dMaxB = dDataB[0];
-	double dMinB = dDataB[0];
+	for (int v = 0; v < nVariables; v++) {
+		const char * szVariable = vecVariableNames[v].c_str();
 
-	for (int i = 0; i < nTotalDataSize; i++) {
-		if (dDataA[i] > dMaxA) {
-			dMaxA = dDataA[i];
-		}
-		if (dDataA[i] < dMinA) {
-			dMinA = dDataA[i];
+		NcVar * varA = ncFileA.get_var(szVariable);
+		if (varA == NULL) {
+			_EXCEPTION2("Variable \"%s\" not found in \"%s\"",
+				szVariable, strFileA.c_str());
 		}
 
-		if (dMinA == 0.0) {
-			_EXCEPTION();
-		}
-
-		if (dDataB[i] > dMaxB) {
-			dMaxB = dDataB[i];
-		}
-		if (dDataB[i] < dMinB) {
-			dMinB = dDataB[i];
+		NcVar * varB = ncFileB.get_var(szVariable);
+		if (varB == NULL) {
+			_EXCEPTION2("Variable \"%s\" not found in \"%s\"",
+				szVariable, strFileB.c_str());
 		}
 
-		dDataA[i] = fabs(dDataA[i] - dDataB[i]);
+		// Variables have the spatial dimensions last, preceded by any
+		// number of level dimensions, such as time and lev
+		int nDims = varA->num_dims();
 
-	}
-
-	// Min / Max Norm
-	double dNormLmin;
-	double dNormLmax;
-
-	if (dMaxB == dMinB) {
-		dNormLmin = dMinB - dMinA;
-		dNormLmax = dMaxA - dMaxB;
-	} else {
-		dNormLmin = (dMinB - dMinA) / (dMaxB - dMinB);
-		dNormLmax = (dMaxA - dMaxB) / (dMaxB - dMinB);
-	}
+		if ((nDims < nSpatialDims) || (varB->num_dims() != nDims)) {
+			_EXCEPTION1("Variable \"%s\" has inconsistent dimensions",
+				szVariable);
+		}
 
-	// Norms and Sums
-	double dNormL1 = 0.0;
-	double dNormL2 = 0.0;
-	double dNormLi = 0.0;
+		int nLevelDims = nDims - nSpatialDims;
 
-	double dSumL1 = 0.0;
-	double dSumL2 = 0.0;
-	double dSumLi = 0.0;
+		std::vector<long> vecDimSizes(nDims);
+		for (int d = 0; d < nDims; d++) {
+			vecDimSizes[d] = varA->get_dim(d)->size();
 
-	// Use face areas
-	if (!fGLL) {
-		mesh.CalculateFaceAreas();
-
-		for (int i = 0; i < nTotalDataSize; i++) {
-			dNormL1 += dDataA[i] * mesh.vecFaceArea[i];
-			dNormL2 += dDataA[i] * dDataA[i] * mesh.vecFaceArea[i];
-
-			if (dDataA[i] > dNormLi) {
-				dNormLi = dDataA[i];
+			if (varB->get_dim(d)->size() != vecDimSizes[d]) {
+				_EXCEPTION1("Variable \"%s\" has different dimensions "
+					"in files A and B", szVariable);
 			}
-
-			dSumL1 += dDataB[i] * mesh.vecFaceArea[i];
-			dSumL2 += dDataB[i] * dDataB[i] * mesh.vecFaceArea[i];
-
-			if (dDataB[i] > dSumLi) {
-				dSumLi = dDataB[i];
+			if ((d >= nLevelDims) &&
+				(vecDimSizes[d] != vecOutputDimSizes[d - nLevelDims])
+			) {
+				_EXCEPTION1("Variable \"%s\" does not match the mesh",
+					szVariable);
 			}
 		}
 
-		dNormL1 = dNormL1 / dSumL1;
-		dNormL2 = sqrt(dNormL2 / dSumL2);
-		dNormLi = dNormLi / dSumLi;
+		int nLevels = 1;
+		for (int d = 0; d < nLevelDims; d++) {
+			nLevels *= vecDimSizes[d];
+		}
 
-	} else {
+		// Read one level at a time
+		std::vector<long> vecCurrent(nDims, 0);
 
-		// Calculate differences
-		for (int i = 0; i < nTotalDataSize; i++) {
-			dNormL1 += dDataA[i] * dataUniqueJacobian[i];
-			dNormL2 += dDataA[i] * dDataA[i] * dataUniqueJacobian[i];
+		std::vector<long> vecCounts(nDims, 1);
+		for (int d = nLevelDims; d < nDims; d++) {
+			vecCounts[d] = vecDimSizes[d];
+		}
 
-			if (dDataA[i] > dNormLi) {
-				dNormLi = dDataA[i];
-			}
+		for (int l = 0; l < nLevels; l++) {
 
-			dSumL1 += dDataB[i] * dataUniqueJacobian[i];
-			dSumL2 += dDataB[i] * dDataB[i] * dataUniqueJacobian[i];
+			// Indices of this level in each level dimension
+			int ixLevel = l;
+			for (int d = nLevelDims - 1; d >= 0; d--) {
+				vecCurrent[d] = ixLevel % vecDimSizes[d];
+				ixLevel /= vecDimSizes[d];
+			}
 
-			if (dDataB[i] > dSumLi) {
-				dSumLi = dDataB[i];
+			varA->set_cur(&(vecCurrent[0]));
+			varA->get(&(dDataA[0]), &(vecCounts[0]));
+
+			varB->set_cur(&(vecCurrent[0]));
+			varB->get(&(dDataB[0]), &(vecCounts[0]));
+
+			DiffNorms norms;
+			CalculateDiffNorms(
+				nTotalDataSize,
+				&(dDataA[0]),
+				&(dDataB[0]),
+				dArea,
+				&(dWork[0]),
+				norms);
+
+			// Announce results
+			if ((nVariables == 1) && (nLevels == 1)) {
+				AnnounceStartBlock("Results:");
+			} else {
+				char szBlock[256];
+				snprintf(szBlock, sizeof(szBlock),
+					"Results: %s [level %i]", szVariable, l);
+				AnnounceStartBlock(szBlock);
+			}
+			Announce("L1:   %1.15e | %1.15e", norms.dNormL1, norms.dSumL1);
+			Announce("L2:   %1.15e | %1.15e", norms.dNormL2, norms.dSumL2);
+			Announce("Li:   %1.15e | %1.15e", norms.dNormLi, norms.dSumLi);
+			Announce("Lmin: %1.15e | %1.5e %1.5e",
+				norms.dNormLmin, norms.dMinA, norms.dMinB);
+			Announce("Lmax: %1.15e | %1.5e %1.5e",
+				norms.dNormLmax, norms.dMaxA, norms.dMaxB);
+			AnnounceEndBlock(NULL);
+
+			// Print results to file, with the variable and level when
+			// more than one field is compared
+			if (fpOutput != NULL) {
+				if ((nVariables != 1) || (nLevels != 1)) {
+					fprintf(fpOutput, "%s %i ", szVariable, l);
+				}
+				fprintf(fpOutput, "%1.15e %1.15e %1.15e %1.15e %1.15e\n",
+					norms.dNormL1, norms.dNormL2, norms.dNormLi,
+					norms.dNormLmin, norms.dNormLmax);
 			}
 		}
-
-		dNormL1 = dNormL1 / dSumL1;
-		dNormL2 = sqrt(dNormL2 / dSumL2);
-		dNormLi = dNormLi / dSumLi;
 	}
 
-	// Announce results
-	AnnounceStartBlock("Results:");
-	Announce("L1:   %1.15e | %1.15e", dNormL1, dSumL1);
-	Announce("L2:   %1.15e | %1.15e", dNormL2, dSumL2);
-	Announce("Li:   %1.15e | %1.15e", dNormLi, dSumLi);
-	Announce("Lmin: %1.15e | %1.5e %1.5e", dNormLmin, dMinA, dMinB);
-	Announce("Lmax: %1.15e | %1.5e %1.5e", dNormLmax, dMaxA, dMaxB);
-	AnnounceEndBlock(NULL);
-
-	// Print results to file
-	if (strOutputFile != "") {
-		FILE * fp = fopen(strOutputFile.c_str(), "a");
-		fprintf(fp, "%1.15e %1.15e %1.15e %1.15e %1.15e\n",
-			dNormL1, dNormL2, dNormLi, dNormLmin, dNormLmax);
-		fclose(fp);
+	if (fpOutput != NULL) {
+		fclose(fpOutput);
 	}
 
 } catch(Exception & e) {
@@ -0,0 +1,351 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    CompactMesh.cpp
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "CompactMesh.h"
+#include "MeshStream.h"
+#include "Announce.h"
+#include "Exception.h"
+#include "DataMatrix.h"
+
+#include "netcdfcpp.h"
+
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactMesh::Clear() {
+	m_dX.clear();
+	m_dY.clear();
+	m_dZ.clear();
+	m_vecFaceOffsets.clear();
+	m_vecFaceNodes.clear();
+	m_vecEdgeTypeMask.clear();
+	vecFirstFaceIx.clear();
+	vecSecondFaceIx.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactMesh::Initialize(
+	const Mesh & mesh
+) {
+	Clear();
+
+	int nNodes = static_cast<int>(mesh.nodes.size());
+	int nFaces = static_cast<int>(mesh.faces.size());
+
+	// Node coordinates
+	m_dX.resize(nNodes);
+	m_dY.resize(nNodes);
+	m_dZ.resize(nNodes);
+
+	for (int i = 0; i < nNodes; i++) {
+		m_dX[i] = mesh.nodes[i].x;
+		m_dY[i] = mesh.nodes[i].y;
+		m_dZ[i] = mesh.nodes[i].z;
+	}
+
+	// Face connectivity
+	m_vecFaceOffsets.resize(nFaces + 1);
+	m_vecFaceOffsets[0] = 0;
+
+	for (int i = 0; i < nFaces; i++) {
+		m_vecFaceOffsets[i+1] =
+			m_vecFaceOffsets[i] + static_cast<int>(mesh.faces[i].edges.size());
+	}
+
+	m_vecFaceNodes.resize(m_vecFaceOffsets[nFaces]);
+	m_vecEdgeTypeMask.resize(nFaces, 0);
+
+	for (int i = 0; i < nFaces; i++) {
+		const Face & face = mesh.faces[i];
+
+		int nEdges = static_cast<int>(face.edges.size());
+		if (nEdges > MaximumFaceEdges) {
+			_EXCEPTION2("Face %i has more than %i Edges",
+				i, MaximumFaceEdges);
+		}
+
+		for (int k = 0; k < nEdges; k++) {
+			if (face.edges[k][1] != face.edges[(k+1)%nEdges][0]) {
+				_EXCEPTION1("Edges of Face %i do not form a closed path", i);
+			}
+
+			m_vecFaceNodes[m_vecFaceOffsets[i] + k] = face[k];
+
+			if (face.edges[k].type == Edge::Type_ConstantLatitude) {
+				m_vecEdgeTypeMask[i] |= (static_cast<uint64_t>(1) << k);
+			}
+		}
+	}
+
+	vecFirstFaceIx = mesh.vecFirstFaceIx;
+	vecSecondFaceIx = mesh.vecSecondFaceIx;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactMesh::Read(const std::string & strFile) {
+
+	Clear();
+
+	// Try to open the NetCDF file
+	FILE * fp = fopen(strFile.c_str(), "r");
+	if (fp == NULL) {
+		_EXCEPTION1("Mesh file not found \"%s\"", strFile.c_str());
+	}
+	fclose(fp);
+
+	// Input from a NetCDF Exodus file
+	NcFile ncFile(strFile.c_str(), NcFile::ReadOnly);
+	if (!ncFile.is_valid()) {
+		_EXCEPTION1("Unable to open mesh file \"%s\"", strFile.c_str());
+	}
+
+	// Determine number of nodes per element
+	NcDim * dimNodesPerElement = ncFile.get_dim("num_nod_per_el1");
+	int nNodesPerElement = dimNodesPerElement->size();
+
+	if (nNodesPerElement > MaximumFaceEdges) {
+		_EXCEPTION1("Faces with more than %i Edges are not supported",
+			MaximumFaceEdges);
+	}
+
+	// Number of nodes
+	NcDim * dimNodes = ncFile.get_dim("num_nodes");
+	int nNodeCount = dimNodes->size();
+
+	// Number of elements
+	NcDim * dimElements = ncFile.get_dim("num_elem");
+	int nElementCount = dimElements->size();
+
+	// Output size
+	Announce("Mesh size: Nodes [%i] Elements [%i]", nNodeCount, nElementCount);
+
+	// Load in node coordinates directly into each coordinate array
+	NcVar * varNodes = ncFile.get_var("coord");
+
+	m_dX.resize(nNodeCount);
+	m_dY.resize(nNodeCount);
+	m_dZ.resize(nNodeCount);
+
+	if (nNodeCount != 0) {
+		varNodes->set_cur(0, 0);
+		varNodes->get(&(m_dX[0]), 1, nNodeCount);
+
+		varNodes->set_cur(1, 0);
+		varNodes->get(&(m_dY[0]), 1, nNodeCount);
+
+		varNodes->set_cur(2, 0);
+		varNodes->get(&(m_dZ[0]), 1, nNodeCount);
+	}
+
+	// Check for variables
+	bool fHasEdgeType = false;
+	bool fHasFirstMeshSourceFace = false;
+	bool fHasSecondMeshSourceFace = false;
+
+	for (int v = 0; v < ncFile.num_vars(); v++) {
+		if (strcmp(ncFile.get_var(v)->name(), "edge_type") == 0) {
+			fHasEdgeType = true;
+		}
+		if (strcmp(ncFile.get_var(v)->name(), "face_source_1") == 0) {
+			fHasFirstMeshSourceFace = true;
+		}
+		if (strcmp(ncFile.get_var(v)->name(), "face_source_2") == 0) {
+			fHasSecondMeshSourceFace = true;
+		}
+	}
+
+	// Load in face array and edge types in chunks
+	m_vecFaceOffsets.resize(nElementCount + 1);
+	m_vecFaceNodes.resize(nElementCount * nNodesPerElement);
+	m_vecEdgeTypeMask.resize(nElementCount, 0);
+
+	for (int i = 0; i <= nElementCount; i++) {
+		m_vecFaceOffsets[i] = i * nNodesPerElement;
+	}
+
+	NcVar * varFaces = ncFile.get_var("connect1");
+
+	NcVar * varEdgeTypes = NULL;
+	if (fHasEdgeType) {
+		varEdgeTypes = ncFile.get_var("edge_type");
+	}
+
+	const int ChunkSize = MeshStreamWriter::ChunkSize;
+
+	DataMatrix<int> iEdgeTypes;
+	if (fHasEdgeType) {
+		iEdgeTypes.Initialize(ChunkSize, nNodesPerElement);
+	}
+
+	for (int i = 0; i < nElementCount; i += ChunkSize) {
+		int nChunk =
+			(i + ChunkSize > nElementCount)?(nElementCount - i):(ChunkSize);
+
+		int * pFaceNodes = &(m_vecFaceNodes[i * nNodesPerElement]);
+
+		varFaces->set_cur(i, 0);
+		varFaces->get(pFaceNodes, nChunk, nNodesPerElement);
+
+		for (int j = 0; j < nChunk * nNodesPerElement; j++) {
+			pFaceNodes[j]--;
+		}
+
+		if (!fHasEdgeType) {
+			continue;
+		}
+
+		varEdgeTypes->set_cur(i, 0);
+		varEdgeTypes->get(&(iEdgeTypes[0][0]), nChunk, nNodesPerElement);
+
+		for (int j = 0; j < nChunk; j++) {
+		for (int k = 0; k < nNodesPerElement; k++) {
+			if (iEdgeTypes[j][k] == Edge::Type_ConstantLatitude) {
+				m_vecEdgeTypeMask[i+j] |= (static_cast<uint64_t>(1) << k);
+			}
+		}
+		}
+	}
+
+	// Load in first mesh source face ix
+	if (fHasFirstMeshSourceFace) {
+		NcVar * varFaceSource1 = ncFile.get_var("face_source_1");
+		vecFirstFaceIx.resize(nElementCount);
+		varFaceSource1->set_cur((long)0);
+		varFaceSource1->get(&(vecFirstFaceIx[0]), nElementCount);
+	}
+
+	// Load in second mesh source face ix
+	if (fHasSecondMeshSourceFace) {
+		NcVar * varFaceSource2 = ncFile.get_var("face_source_2");
+		vecSecondFaceIx.resize(nElementCount);
+		varFaceSource2->set_cur((long)0);
+		varFaceSource2->get(&(vecSecondFaceIx[0]), nElementCount);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactMesh::RemoveZeroEdges() {
+
+	// Faces are compacted in place; Edge k is a zero edge if Node k and
+	// Node k+1 are equal, in which case Node k is removed
+	int nFaces = GetFaceCount();
+
+	int ixNext = 0;
+
+	for (int i = 0; i < nFaces; i++) {
+		int ixBegin = m_vecFaceOffsets[i];
+		int nNodes = m_vecFaceOffsets[i+1] - ixBegin;
+
+		uint64_t uiMask = m_vecEdgeTypeMask[i];
+		uint64_t uiNewMask = 0;
+
+		m_vecFaceOffsets[i] = ixNext;
+
+		// The first Node may be overwritten before it is needed as the
+		// end of the last Edge
+		int ixFirstNode = (nNodes == 0)?(InvalidNode):(m_vecFaceNodes[ixBegin]);
+
+		int nNewNodes = 0;
+		for (int k = 0; k < nNodes; k++) {
+			int ixNode = m_vecFaceNodes[ixBegin + k];
+			int ixNodeNext = (k == nNodes-1)?
+				(ixFirstNode):(m_vecFaceNodes[ixBegin + k + 1]);
+
+			if (ixNode == ixNodeNext) {
+				continue;
+			}
+
+			if ((uiMask >> k) & 1) {
+				uiNewMask |= (static_cast<uint64_t>(1) << nNewNodes);
+			}
+
+			m_vecFaceNodes[ixNext + nNewNodes] = ixNode;
+			nNewNodes++;
+		}
+
+		m_vecEdgeTypeMask[i] = uiNewMask;
+
+		ixNext += nNewNodes;
+	}
+
+	if (nFaces != 0) {
+		m_vecFaceOffsets[nFaces] = ixNext;
+	}
+
+	m_vecFaceNodes.resize(ixNext);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactMesh::ToMesh(
+	Mesh & mesh
+) const {
+	mesh.Clear();
+
+	int nNodes = GetNodeCount();
+	int nFaces = GetFaceCount();
+
+	mesh.nodes.resize(nNodes);
+	for (int i = 0; i < nNodes; i++) {
+		mesh.nodes[i] = GetNode(i);
+	}
+
+	mesh.faces.resize(nFaces);
+	for (int i = 0; i < nFaces; i++) {
+		GetFace(i, mesh.faces[i]);
+	}
+
+	mesh.vecFirstFaceIx = vecFirstFaceIx;
+	mesh.vecSecondFaceIx = vecSecondFaceIx;
+
+	if ((vecFirstFaceIx.size() != 0) && (vecSecondFaceIx.size() != 0)) {
+		mesh.ConstructOverlapIndex();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactMesh::GetFace(
+	int ixFace,
+	Face & face
+) const {
+	int nNodes = GetFaceNodeCount(ixFace);
+
+	face.edges.resize(nNodes);
+
+	for (int k = 0; k < nNodes; k++) {
+		face.SetNode(k, GetFaceNode(ixFace, k));
+		face.edges[k].type = GetEdgeType(ixFace, k);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t CompactMesh::GetMemoryUsage() const {
+	return (
+		  (m_dX.capacity() + m_dY.capacity() + m_dZ.capacity()) * sizeof(Real)
+		+ (m_vecFaceOffsets.capacity() + m_vecFaceNodes.capacity()
+			+ vecFirstFaceIx.capacity() + vecSecondFaceIx.capacity())
+			* sizeof(int)
+		+ m_vecEdgeTypeMask.capacity() * sizeof(uint64_t));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    CompactMesh.h
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _COMPACTMESH_H_
+#define _COMPACTMESH_H_
+
+#include "GridElements.h"
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A compact representation of a Mesh.  Node coordinates are stored as
+///		separate x, y and z arrays, the Nodes of all Faces are stored in
+///		compressed sparse row format and the Edge types of each Face are
+///		stored as a bitmask, where bit k is set if Edge k (from Node k to
+///		Node k+1) is a line of constant latitude.  Each Face index is stored
+///		once, rather than twice as in a FaceVector, and no Face requires a
+///		separate heap allocation.
+///	</summary>
+class CompactMesh {
+
+public:
+	///	<summary>
+	///		Maximum number of Edges of a Face.
+	///	</summary>
+	static const int MaximumFaceEdges = 64;
+
+public:
+	///	<summary>
+	///		Default constructor.
+	///	</summary>
+	CompactMesh() {
+	}
+
+	///	<summary>
+	///		Constructor with input mesh parameter.
+	///	</summary>
+	CompactMesh(const std::string & strFile) {
+		Read(strFile);
+	}
+
+public:
+	///	<summary>
+	///		Clear the contents of the mesh.
+	///	</summary>
+	void Clear();
+
+	///	<summary>
+	///		Build the compact representation of mesh.
+	///	</summary>
+	void Initialize(
+		const Mesh & mesh
+	);
+
+	///	<summary>
+	///		Read the mesh from a NetCDF file, without constructing the
+	///		Faces of a Mesh.  Zero Edges are retained, as in Mesh::Read.
+	///	</summary>
+	void Read(const std::string & strFile);
+
+	///	<summary>
+	///		Remove zero edges from all Faces.
+	///	</summary>
+	void RemoveZeroEdges();
+
+	///	<summary>
+	///		Expand the compact representation into mesh.
+	///	</summary>
+	void ToMesh(
+		Mesh & mesh
+	) const;
+
+public:
+	///	<summary>
+	///		Number of Nodes.
+	///	</summary>
+	int GetNodeCount() const {
+		return static_cast<int>(m_dX.size());
+	}
+
+	///	<summary>
+	///		Coordinates of Node ixNode.
+	///	</summary>
+	Real GetX(int ixNode) const {
+		return m_dX[ixNode];
+	}
+
+	Real GetY(int ixNode) const {
+		return m_dY[ixNode];
+	}
+
+	Real GetZ(int ixNode) const {
+		return m_dZ[ixNode];
+	}
+
+	///	<summary>
+	///		Node ixNode.
+	///	</summary>
+	Node GetNode(int ixNode) const {
+		return Node(m_dX[ixNode], m_dY[ixNode], m_dZ[ixNode]);
+	}
+
+	///	<summary>
+	///		Number of Faces.
+	///	</summary>
+	int GetFaceCount() const {
+		return (m_vecFaceOffsets.size() == 0)?(0):
+			(static_cast<int>(m_vecFaceOffsets.size()) - 1);
+	}
+
+	///	<summary>
+	///		Number of Nodes (and Edges) of Face ixFace.
+	///	</summary>
+	int GetFaceNodeCount(int ixFace) const {
+		return (m_vecFaceOffsets[ixFace+1] - m_vecFaceOffsets[ixFace]);
+	}
+
+	///	<summary>
+	///		Index of Node k of Face ixFace.
+	///	</summary>
+	int GetFaceNode(int ixFace, int k) const {
+		return m_vecFaceNodes[m_vecFaceOffsets[ixFace] + k];
+	}
+
+	///	<summary>
+	///		Type of Edge k of Face ixFace.
+	///	</summary>
+	Edge::Type GetEdgeType(int ixFace, int k) const {
+		if ((m_vecEdgeTypeMask[ixFace] >> k) & 1) {
+			return Edge::Type_ConstantLatitude;
+		}
+		return Edge::Type_GreatCircleArc;
+	}
+
+	///	<summary>
+	///		Expand Face ixFace into face, reusing the Edges of face.
+	///	</summary>
+	void GetFace(
+		int ixFace,
+		Face & face
+	) const;
+
+	///	<summary>
+	///		Approximate number of bytes used by the mesh.
+	///	</summary>
+	size_t GetMemoryUsage() const;
+
+public:
+	///	<summary>
+	///		Vector of first mesh Face indices.
+	///	</summary>
+	std::vector<int> vecFirstFaceIx;
+
+	///	<summary>
+	///		Vector of second mesh Face indices.
+	///	</summary>
+	std::vector<int> vecSecondFaceIx;
+
+protected:
+	///	<summary>
+	///		Coordinates of all Nodes.
+	///	</summary>
+	std::vector<Real> m_dX;
+	std::vector<Real> m_dY;
+	std::vector<Real> m_dZ;
+
+	///	<summary>
+	///		Index of the first Node of each Face in m_vecFaceNodes,
+	///		followed by the total number of entries.
+	///	</summary>
+	std::vector<int> m_vecFaceOffsets;
+
+	///	<summary>
+	///		Node indices of all Faces.
+	///	</summary>
+	std::vector<int> m_vecFaceNodes;
+
+	///	<summary>
+	///		Edge type bitmask of each Face.
+	///	</summary>
+	std::vector<uint64_t> m_vecEdgeTypeMask;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    ComposeOfflineMaps.cpp
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "Announce.h"
+#include "CommandLine.h"
+#include "Exception.h"
+#include "OfflineMap.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+try {
+
+	// First input map file (A to B)
+	std::string strInputMap1;
+
+	// Second input map file (B to C)
+	std::string strInputMap2;
+
+	// Output map file
+	std::string strOutputMap;
+
+	// Output binary map file
+	std::string strOutputMapBinary;
+
+	// Tolerance for dropping entries of the composed map
+	double dDropTolerance;
+
+	// Do not verify the composed map
+	bool fNoCheck;
+
+	// Verify monotonicity of the composed map
+	bool fMonotone;
+
+	// Write NetCDF-4 output with chunked variables
+	bool fNetCDF4;
+
+	// Deflate level of NetCDF-4 output
+	int nDeflateLevel;
+
+	// Apply the shuffle filter to NetCDF-4 output
+	bool fShuffle;
+
+	// Parse the command line
+	BeginCommandLine()
+		CommandLineString(strInputMap1, "map1", "");
+		CommandLineString(strInputMap2, "map2", "");
+		CommandLineString(strOutputMap, "out_map", "");
+		CommandLineString(strOutputMapBinary, "out_map_bin", "");
+		CommandLineDouble(dDropTolerance, "drop_tol", 0.0);
+		CommandLineBool(fNoCheck, "nocheck");
+		CommandLineBool(fMonotone, "mono");
+		CommandLineBool(fNetCDF4, "netcdf4");
+		CommandLineInt(nDeflateLevel, "deflate", 0);
+		CommandLineBool(fShuffle, "shuffle");
+
+		ParseCommandLine(argc, argv);
+	EndCommandLine(argv)
+
+	AnnounceBanner();
+
+	// Format of NetCDF output files
+	NetCDFOutputOptions optNetCDF(fNetCDF4, nDeflateLevel, fShuffle);
+
+	// Check parameters
+	if (strInputMap1 == "") {
+		_EXCEPTIONT("No first map (--map1) specified");
+	}
+	if (strInputMap2 == "") {
+		_EXCEPTIONT("No second map (--map2) specified");
+	}
+	if ((strOutputMap == "") && (strOutputMapBinary == "")) {
+		_EXCEPTIONT("No output map (--out_map or --out_map_bin) specified");
+	}
+	if (dDropTolerance < 0.0) {
+		_EXCEPTIONT("--drop_tol must be non-negative");
+	}
+
+	// Load the maps
+	AnnounceStartBlock("Loading offline maps");
+	OfflineMap mapFirst;
+	mapFirst.Read(strInputMap1);
+
+	OfflineMap mapSecond;
+	mapSecond.Read(strInputMap2);
+	AnnounceEndBlock(NULL);
+
+	// Compose the maps
+	AnnounceStartBlock("Composing offline maps");
+	OfflineMap mapComposed;
+	mapComposed.Compose(mapFirst, mapSecond, dDropTolerance);
+
+	Announce("Non-zeros: %i (%i + %i in input maps)",
+		mapComposed.GetSparseMatrix().GetNonZeros(),
+		mapFirst.GetSparseMatrix().GetNonZeros(),
+		mapSecond.GetSparseMatrix().GetNonZeros());
+	AnnounceEndBlock(NULL);
+
+	const DataVector<double> & vecSourceAreas = mapComposed.GetSourceAreas();
+	const DataVector<double> & vecTargetAreas = mapComposed.GetTargetAreas();
+
+	// Verify consistency, conservation and monotonicity
+	if (!fNoCheck) {
+		AnnounceStartBlock("Verifying map");
+		mapComposed.Verify(vecSourceAreas, vecTargetAreas, fMonotone);
+		AnnounceEndBlock(NULL);
+	}
+
+	// Output the composed map
+	if (strOutputMap != "") {
+		AnnounceStartBlock("Writing offline map");
+		mapComposed.Write(
+			strOutputMap, vecSourceAreas, vecTargetAreas, optNetCDF);
+		AnnounceEndBlock(NULL);
+	}
+
+	if (strOutputMapBinary != "") {
+		AnnounceStartBlock("Writing binary offline map");
+		mapComposed.WriteBinary(
+			strOutputMapBinary, vecSourceAreas, vecTargetAreas);
+		AnnounceEndBlock(NULL);
+	}
+
+	AnnounceBanner();
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,288 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    ContentCache.cpp
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "ContentCache.h"
+#include "GridElements.h"
+#include "Announce.h"
+#include "Exception.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <sys/stat.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Size of the buffer used to read and copy files.
+///	</summary>
+static const size_t ContentCacheBufferSize = 1 << 20;
+
+///////////////////////////////////////////////////////////////////////////////
+/// ContentHash
+///////////////////////////////////////////////////////////////////////////////
+
+void ContentHash::Add(double d) {
+	uint64_t uiWord;
+	memcpy(&uiWord, &d, sizeof(uint64_t));
+	AddWord(uiWord);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ContentHash::Add(const std::string & str) {
+	Add(static_cast<int>(str.length()));
+	for (size_t i = 0; i < str.length(); i++) {
+		AddWord(static_cast<uint64_t>(static_cast<unsigned char>(str[i])));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ContentHash::Add(const Mesh & mesh) {
+
+	// Node coordinates
+	Add(static_cast<int>(mesh.nodes.size()));
+	for (int i = 0; i < mesh.nodes.size(); i++) {
+		Add(static_cast<double>(mesh.nodes[i].x));
+		Add(static_cast<double>(mesh.nodes[i].y));
+		Add(static_cast<double>(mesh.nodes[i].z));
+	}
+
+	// Face connectivity and Edge types
+	Add(static_cast<int>(mesh.faces.size()));
+	for (int i = 0; i < mesh.faces.size(); i++) {
+		const Face & face = mesh.faces[i];
+
+		Add(static_cast<int>(face.edges.size()));
+		for (int k = 0; k < face.edges.size(); k++) {
+			Add(face[k]);
+			Add(static_cast<int>(face.edges[k].type));
+		}
+	}
+
+	// Source Faces of an overlap mesh
+	Add(static_cast<int>(mesh.vecFirstFaceIx.size()));
+	for (int i = 0; i < mesh.vecFirstFaceIx.size(); i++) {
+		Add(mesh.vecFirstFaceIx[i]);
+	}
+
+	Add(static_cast<int>(mesh.vecSecondFaceIx.size()));
+	for (int i = 0; i < mesh.vecSecondFaceIx.size(); i++) {
+		Add(mesh.vecSecondFaceIx[i]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ContentHash::AddFile(const std::string & strFile) {
+	FILE * fp = fopen(strFile.c_str(), "rb");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open file \"%s\"", strFile.c_str());
+	}
+
+	std::vector<unsigned char> vecBuffer(ContentCacheBufferSize);
+
+	int64_t nBytes = 0;
+	for (;;) {
+		size_t sRead = fread(&(vecBuffer[0]), 1, vecBuffer.size(), fp);
+		for (size_t i = 0; i < sRead; i++) {
+			AddWord(static_cast<uint64_t>(vecBuffer[i]));
+		}
+		nBytes += static_cast<int64_t>(sRead);
+
+		if (sRead != vecBuffer.size()) {
+			break;
+		}
+	}
+
+	bool fError = (ferror(fp) != 0);
+	fclose(fp);
+
+	if (fError) {
+		_EXCEPTION1("Unable to read file \"%s\"", strFile.c_str());
+	}
+
+	AddWord(static_cast<uint64_t>(nBytes));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string ContentHash::GetHex() const {
+	char szHex[32];
+	sprintf(szHex, "%016llx", static_cast<unsigned long long>(m_uiHash));
+	return std::string(szHex);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// ContentCache
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Copy the contents of strSource to strTarget.  Returns false if
+///		either file cannot be opened or the copy is incomplete.
+///	</summary>
+static bool CopyFileContents(
+	const std::string & strSource,
+	const std::string & strTarget
+) {
+	FILE * fpSource = fopen(strSource.c_str(), "rb");
+	if (fpSource == NULL) {
+		return false;
+	}
+
+	FILE * fpTarget = fopen(strTarget.c_str(), "wb");
+	if (fpTarget == NULL) {
+		fclose(fpSource);
+		return false;
+	}
+
+	std::vector<char> vecBuffer(ContentCacheBufferSize);
+
+	bool fValid = true;
+	for (;;) {
+		size_t sRead = fread(&(vecBuffer[0]), 1, vecBuffer.size(), fpSource);
+		if (fwrite(&(vecBuffer[0]), 1, sRead, fpTarget) != sRead) {
+			fValid = false;
+			break;
+		}
+		if (sRead != vecBuffer.size()) {
+			break;
+		}
+	}
+
+	if (ferror(fpSource) != 0) {
+		fValid = false;
+	}
+
+	fclose(fpSource);
+
+	if (fclose(fpTarget) != 0) {
+		fValid = false;
+	}
+
+	return fValid;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ContentCache::ContentCache(
+	const std::string & strDirectory
+) :
+	m_strDirectory(strDirectory)
+{
+	if (m_strDirectory == "") {
+		return;
+	}
+
+	if ((mkdir(m_strDirectory.c_str(), 0775) != 0) && (errno != EEXIST)) {
+		Announce("WARNING: Unable to create cache directory \"%s\"",
+			m_strDirectory.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string ContentCache::GetEntryPath(
+	const std::string & strKind,
+	const ContentHash & hash,
+	const std::string & strExtension
+) const {
+	ContentHash hashEntry(hash);
+	hashEntry.Add(FormatVersion);
+
+	return (m_strDirectory + "/" + strKind + "_" + hashEntry.GetHex() + strExtension);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ContentCache::HasEntry(
+	const std::string & strEntry
+) const {
+	if (!IsEnabled()) {
+		return false;
+	}
+
+	struct stat statEntry;
+	return (stat(strEntry.c_str(), &statEntry) == 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string ContentCache::GetTemporaryPath(
+	const std::string & strEntry
+) const {
+
+	// Jobs on different hosts may share the cache directory
+	char szHost[64];
+	if (gethostname(szHost, sizeof(szHost)) != 0) {
+		strcpy(szHost, "host");
+	}
+	szHost[sizeof(szHost)-1] = '\0';
+
+	char szSuffix[96];
+	sprintf(szSuffix, ".%s.%i", szHost, static_cast<int>(getpid()));
+
+	return (strEntry + szSuffix);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ContentCache::Commit(
+	const std::string & strTemporary,
+	const std::string & strEntry,
+	bool fValid
+) const {
+	if (!fValid || (rename(strTemporary.c_str(), strEntry.c_str()) != 0)) {
+		remove(strTemporary.c_str());
+		Announce("WARNING: Unable to write cache entry \"%s\"",
+			strEntry.c_str());
+		return;
+	}
+
+	Announce("Cache entry written to \"%s\"", strEntry.c_str());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ContentCache::Store(
+	const std::string & strFile,
+	const std::string & strEntry
+) const {
+	if (!IsEnabled()) {
+		return;
+	}
+
+	std::string strTemporary = GetTemporaryPath(strEntry);
+
+	Commit(strTemporary, strEntry, CopyFileContents(strFile, strTemporary));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ContentCache::Retrieve(
+	const std::string & strEntry,
+	const std::string & strFile
+) const {
+	if (!CopyFileContents(strEntry, strFile)) {
+		_EXCEPTION2("Unable to copy cache entry \"%s\" to \"%s\"",
+			strEntry.c_str(), strFile.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
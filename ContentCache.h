@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    ContentCache.h
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _CONTENTCACHE_H_
+#define _CONTENTCACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Mesh;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A 64-bit FNV-1a hash of the contents of meshes, files and options.
+///		Arrays are hashed as 64-bit words, so the hash of a Mesh depends
+///		only on its Node coordinates, Face connectivity, Edge types and
+///		source Face indices, and not on the name or format of its file.
+///	</summary>
+class ContentHash {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	ContentHash() :
+		m_uiHash(14695981039346656037ULL)
+	{ }
+
+public:
+	///	<summary>
+	///		Add a 64-bit word to the hash.
+	///	</summary>
+	void AddWord(uint64_t uiWord) {
+		m_uiHash = (m_uiHash ^ uiWord) * 1099511628211ULL;
+	}
+
+	///	<summary>
+	///		Add an integer to the hash.
+	///	</summary>
+	void Add(int n) {
+		AddWord(static_cast<uint64_t>(static_cast<int64_t>(n)));
+	}
+
+	///	<summary>
+	///		Add the bit pattern of a double to the hash.
+	///	</summary>
+	void Add(double d);
+
+	///	<summary>
+	///		Add the length and characters of a string to the hash.
+	///	</summary>
+	void Add(const std::string & str);
+
+	///	<summary>
+	///		Add the geometry and connectivity of a Mesh to the hash.
+	///	</summary>
+	void Add(const Mesh & mesh);
+
+	///	<summary>
+	///		Add the contents of a file to the hash.
+	///	</summary>
+	void AddFile(const std::string & strFile);
+
+public:
+	///	<summary>
+	///		Get the hash.
+	///	</summary>
+	uint64_t Get() const {
+		return m_uiHash;
+	}
+
+	///	<summary>
+	///		Get the hash as a string of 16 hexadecimal digits.
+	///	</summary>
+	std::string GetHex() const;
+
+private:
+	///	<summary>
+	///		Current value of the hash.
+	///	</summary>
+	uint64_t m_uiHash;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A directory of files addressed by the ContentHash of their inputs,
+///		which may be shared by concurrent jobs.  Entries are written to a
+///		temporary file which is then renamed, so a reader never sees a
+///		partial entry.  Failure to write an entry is not an error.
+///	</summary>
+class ContentCache {
+
+public:
+	///	<summary>
+	///		Constructor.  The cache is disabled if strDirectory is empty.
+	///		The directory is created if it does not exist.
+	///	</summary>
+	ContentCache(
+		const std::string & strDirectory
+	);
+
+public:
+	///	<summary>
+	///		Version of the format of cache entries, which is added to the
+	///		hash of every entry.  Increment it whenever a change makes
+	///		existing entries invalid.
+	///	</summary>
+	static const int FormatVersion = 2;
+
+public:
+	///	<summary>
+	///		Determine if the cache is enabled.
+	///	</summary>
+	bool IsEnabled() const {
+		return (m_strDirectory != "");
+	}
+
+	///	<summary>
+	///		Path of the entry of the given kind and hash, for the current
+	///		FormatVersion.
+	///	</summary>
+	std::string GetEntryPath(
+		const std::string & strKind,
+		const ContentHash & hash,
+		const std::string & strExtension
+	) const;
+
+	///	<summary>
+	///		Determine if an entry exists.
+	///	</summary>
+	bool HasEntry(
+		const std::string & strEntry
+	) const;
+
+	///	<summary>
+	///		Path of a temporary file, unique to this process, to which the
+	///		given entry can be written before it is committed.
+	///	</summary>
+	std::string GetTemporaryPath(
+		const std::string & strEntry
+	) const;
+
+	///	<summary>
+	///		Rename a temporary file written by this process to the entry.
+	///		If fValid is false, or the rename fails, the temporary file is
+	///		removed and a warning is announced.
+	///	</summary>
+	void Commit(
+		const std::string & strTemporary,
+		const std::string & strEntry,
+		bool fValid = true
+	) const;
+
+	///	<summary>
+	///		Store a copy of strFile as an entry.
+	///	</summary>
+	void Store(
+		const std::string & strFile,
+		const std::string & strEntry
+	) const;
+
+	///	<summary>
+	///		Copy an entry to strFile.
+	///	</summary>
+	void Retrieve(
+		const std::string & strEntry,
+		const std::string & strFile
+	) const;
+
+private:
+	///	<summary>
+	///		Directory of the cache.
+	///	</summary>
+	std::string m_strDirectory;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
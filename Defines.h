@@ -21,6 +21,8 @@
 
 #define USE_EXACT_ARITHMETIC
 
+#define USE_BINARY_FIXEDPOINT
+
 ///////////////////////////////////////////////////////////////////////////////
 
 typedef double Real;
@@ -164,5 +164,69 @@ class Exception {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Exception raised while processing Faces in parallel.  The exception
+///		of the lowest-indexed Face is kept, so that the same exception is
+///		rethrown as in a serial loop.
+///	</summary>
+class FaceLoopException {
+
+	public:
+		///	<summary>
+		///		Constructor.
+		///	</summary>
+		FaceLoopException() :
+			m_ixFace(-1),
+			m_pex(NULL)
+		{ }
+
+		///	<summary>
+		///		Destructor.
+		///	</summary>
+		~FaceLoopException() {
+			delete m_pex;
+		}
+
+	public:
+		///	<summary>
+		///		Record the exception raised while processing Face ixFace.
+		///	</summary>
+		void Record(int ixFace, const Exception & e) {
+#pragma omp critical(FaceLoopException)
+			{
+				if ((m_pex == NULL) || (ixFace < m_ixFace)) {
+					delete m_pex;
+					m_pex = new Exception(e);
+					m_ixFace = ixFace;
+				}
+			}
+		}
+
+		///	<summary>
+		///		Rethrow the recorded exception, if any.
+		///	</summary>
+		void Rethrow() {
+			if (m_pex != NULL) {
+				Exception ex(*m_pex);
+				delete m_pex;
+				m_pex = NULL;
+				throw ex;
+			}
+		}
+
+	private:
+		///	<summary>
+		///		Index of the Face which raised the recorded exception.
+		///	</summary>
+		int m_ixFace;
+
+		///	<summary>
+		///		Recorded exception.
+		///	</summary>
+		Exception * m_pex;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 #endif
 
@@ -0,0 +1,318 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    FaceQuadratureTable.cpp
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "FaceQuadratureTable.h"
+#include "TriangularQuadrature.h"
+#include "GridElements.h"
+#include "DataMatrix.h"
+#include "Exception.h"
+
+#include "netcdfcpp.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute a hash of the connectivity of all Faces of mesh, so that a
+///		table is not applied to a Mesh with reordered Faces.
+///	</summary>
+static int HashMeshConnectivity(
+	const Mesh & mesh
+) {
+	unsigned int uiHash = 2166136261u;
+
+	for (int i = 0; i < mesh.faces.size(); i++) {
+		const Face & face = mesh.faces[i];
+
+		uiHash = (uiHash ^ static_cast<unsigned int>(face.edges.size()))
+			* 16777619u;
+
+		for (int j = 0; j < face.edges.size(); j++) {
+			uiHash = (uiHash ^ static_cast<unsigned int>(face[j]))
+				* 16777619u;
+		}
+	}
+
+	return static_cast<int>(uiHash);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceQuadratureTable::Initialize(
+	const Mesh & mesh,
+	int nOrder
+) {
+	TriangularQuadratureRule triquadrule(nOrder);
+
+	const DataMatrix<double> & dG = triquadrule.GetG();
+
+	m_nOrder = nOrder;
+	m_nPoints = triquadrule.GetPoints();
+	m_nNodes = static_cast<int>(mesh.nodes.size());
+	m_nMeshHash = HashMeshConnectivity(mesh);
+	m_dW = triquadrule.GetW();
+
+	// Index the sub-triangles of all Faces
+	int nFaces = static_cast<int>(mesh.faces.size());
+
+	m_vecTriBegin.Initialize(nFaces + 1);
+	for (int i = 0; i < nFaces; i++) {
+		int nTriangles = static_cast<int>(mesh.faces[i].edges.size()) - 2;
+		if (nTriangles < 1) {
+			_EXCEPTION1("Face %i has fewer than three edges", i);
+		}
+		m_vecTriBegin[i+1] = m_vecTriBegin[i] + nTriangles;
+	}
+
+	int nTotalTriangles = m_vecTriBegin[nFaces];
+
+	m_dTriArea.Initialize(nTotalTriangles);
+	m_dX.Initialize(nTotalTriangles * m_nPoints);
+	m_dY.Initialize(nTotalTriangles * m_nPoints);
+	m_dZ.Initialize(nTotalTriangles * m_nPoints);
+
+	// Compute areas and quadrature points of all sub-triangles
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nFaces; i++) {
+		const Face & face = mesh.faces[i];
+
+		Face faceTri(3);
+
+		for (int ixTri = m_vecTriBegin[i]; ixTri < m_vecTriBegin[i+1]; ixTri++) {
+			int j = ixTri - m_vecTriBegin[i];
+
+			// Cornerpoints of triangle
+			const Node & node0 = mesh.nodes[face[0]];
+			const Node & node1 = mesh.nodes[face[j+1]];
+			const Node & node2 = mesh.nodes[face[j+2]];
+
+			// Calculate the area of the sub-triangle
+			faceTri.SetNode(0, face[0]);
+			faceTri.SetNode(1, face[j+1]);
+			faceTri.SetNode(2, face[j+2]);
+
+			m_dTriArea[ixTri] = CalculateFaceArea(faceTri, mesh.nodes);
+
+			// Project the quadrature points onto the unit sphere
+			double * dX = &(m_dX[ixTri * m_nPoints]);
+			double * dY = &(m_dY[ixTri * m_nPoints]);
+			double * dZ = &(m_dZ[ixTri * m_nPoints]);
+
+			for (int k = 0; k < m_nPoints; k++) {
+				const double * dGL = dG[k];
+
+				double dXc =
+					dGL[0] * node0.x + dGL[1] * node1.x + dGL[2] * node2.x;
+				double dYc =
+					dGL[0] * node0.y + dGL[1] * node1.y + dGL[2] * node2.y;
+				double dZc =
+					dGL[0] * node0.z + dGL[1] * node1.z + dGL[2] * node2.z;
+
+				double dMag = sqrt(dXc * dXc + dYc * dYc + dZc * dZc);
+
+				dX[k] = dXc / dMag;
+				dY[k] = dYc / dMag;
+				dZ[k] = dZc / dMag;
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool FaceQuadratureTable::Read(
+	const std::string & strInput
+) {
+	NcError error(NcError::silent_nonfatal);
+
+	NcFile ncInput(strInput.c_str(), NcFile::ReadOnly);
+	if (!ncInput.is_valid()) {
+		return false;
+	}
+
+	NcAtt * attOrder = ncInput.get_att("order");
+	NcAtt * attNodes = ncInput.get_att("mesh_nodes");
+	NcAtt * attHash = ncInput.get_att("mesh_hash");
+
+	NcDim * dimFaces = ncInput.get_dim("n_face");
+	NcDim * dimTri = ncInput.get_dim("n_tri");
+	NcDim * dimPoints = ncInput.get_dim("n_point");
+
+	NcVar * varTriCount = ncInput.get_var("tri_count");
+	NcVar * varTriArea = ncInput.get_var("tri_area");
+	NcVar * varX = ncInput.get_var("x");
+	NcVar * varY = ncInput.get_var("y");
+	NcVar * varZ = ncInput.get_var("z");
+
+	if ((attOrder == NULL) || (attNodes == NULL) || (attHash == NULL) ||
+		(dimFaces == NULL) || (dimTri == NULL) || (dimPoints == NULL) ||
+		(varTriCount == NULL) || (varTriArea == NULL) ||
+		(varX == NULL) || (varY == NULL) || (varZ == NULL)
+	) {
+		return false;
+	}
+
+	TriangularQuadratureRule triquadrule(attOrder->as_int(0));
+
+	int nFaces = static_cast<int>(dimFaces->size());
+	int nTotalTriangles = static_cast<int>(dimTri->size());
+
+	if (static_cast<int>(dimPoints->size()) != triquadrule.GetPoints()) {
+		_EXCEPTION1("Quadrature file \"%s\" has inconsistent order",
+			strInput.c_str());
+	}
+
+	m_nOrder = attOrder->as_int(0);
+	m_nPoints = triquadrule.GetPoints();
+	m_nNodes = attNodes->as_int(0);
+	m_nMeshHash = attHash->as_int(0);
+	m_dW = triquadrule.GetW();
+
+	DataVector<int> vecTriCount;
+	vecTriCount.Initialize(nFaces);
+
+	if (nFaces != 0) {
+		varTriCount->set_cur((long)0);
+		varTriCount->get(&(vecTriCount[0]), nFaces);
+	}
+
+	m_vecTriBegin.Initialize(nFaces + 1);
+	for (int i = 0; i < nFaces; i++) {
+		m_vecTriBegin[i+1] = m_vecTriBegin[i] + vecTriCount[i];
+	}
+	if (m_vecTriBegin[nFaces] != nTotalTriangles) {
+		_EXCEPTION1("Quadrature file \"%s\" has inconsistent triangles",
+			strInput.c_str());
+	}
+
+	m_dTriArea.Initialize(nTotalTriangles);
+	m_dX.Initialize(nTotalTriangles * m_nPoints);
+	m_dY.Initialize(nTotalTriangles * m_nPoints);
+	m_dZ.Initialize(nTotalTriangles * m_nPoints);
+
+	if (nTotalTriangles != 0) {
+		varTriArea->set_cur((long)0);
+		varTriArea->get(&(m_dTriArea[0]), nTotalTriangles);
+
+		varX->set_cur((long)0, (long)0);
+		varX->get(&(m_dX[0]), nTotalTriangles, m_nPoints);
+
+		varY->set_cur((long)0, (long)0);
+		varY->get(&(m_dY[0]), nTotalTriangles, m_nPoints);
+
+		varZ->set_cur((long)0, (long)0);
+		varZ->get(&(m_dZ[0]), nTotalTriangles, m_nPoints);
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceQuadratureTable::Write(
+	const std::string & strOutput
+) const {
+	NcFile ncOutput(strOutput.c_str(), NcFile::Replace);
+	if (!ncOutput.is_valid()) {
+		_EXCEPTION1("Unable to open quadrature file \"%s\"",
+			strOutput.c_str());
+	}
+
+	int nFaces = GetFaceCount();
+	int nTotalTriangles = m_vecTriBegin[nFaces];
+
+	// Attributes
+	ncOutput.add_att("Title", "TempestRemap Face Quadrature Table");
+	ncOutput.add_att("order", m_nOrder);
+	ncOutput.add_att("mesh_nodes", m_nNodes);
+	ncOutput.add_att("mesh_hash", m_nMeshHash);
+
+	NcDim * dimFaces = ncOutput.add_dim("n_face", nFaces);
+	NcDim * dimTri = ncOutput.add_dim("n_tri", nTotalTriangles);
+	NcDim * dimPoints = ncOutput.add_dim("n_point", m_nPoints);
+
+	NcVar * varTriCount = ncOutput.add_var("tri_count", ncInt, dimFaces);
+	NcVar * varTriArea = ncOutput.add_var("tri_area", ncDouble, dimTri);
+	NcVar * varX = ncOutput.add_var("x", ncDouble, dimTri, dimPoints);
+	NcVar * varY = ncOutput.add_var("y", ncDouble, dimTri, dimPoints);
+	NcVar * varZ = ncOutput.add_var("z", ncDouble, dimTri, dimPoints);
+
+	DataVector<int> vecTriCount;
+	vecTriCount.Initialize(nFaces);
+
+	for (int i = 0; i < nFaces; i++) {
+		vecTriCount[i] = GetTriangleCount(i);
+	}
+
+	if (nFaces != 0) {
+		varTriCount->set_cur((long)0);
+		varTriCount->put(&(vecTriCount[0]), nFaces);
+	}
+
+	if (nTotalTriangles != 0) {
+		varTriArea->set_cur((long)0);
+		varTriArea->put(&(m_dTriArea[0]), nTotalTriangles);
+
+		varX->set_cur((long)0, (long)0);
+		varX->put(&(m_dX[0]), nTotalTriangles, m_nPoints);
+
+		varY->set_cur((long)0, (long)0);
+		varY->put(&(m_dY[0]), nTotalTriangles, m_nPoints);
+
+		varZ->set_cur((long)0, (long)0);
+		varZ->put(&(m_dZ[0]), nTotalTriangles, m_nPoints);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool FaceQuadratureTable::IsCompatible(
+	const Mesh & mesh,
+	int nOrder
+) const {
+	if ((nOrder != m_nOrder) ||
+		(GetFaceCount() != mesh.faces.size()) ||
+		(m_nNodes != mesh.nodes.size())
+	) {
+		return false;
+	}
+
+	for (int i = 0; i < mesh.faces.size(); i++) {
+		if (GetTriangleCount(i) != mesh.faces[i].edges.size() - 2) {
+			return false;
+		}
+	}
+
+	if (HashMeshConnectivity(mesh) != m_nMeshHash) {
+		return false;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceQuadratureTable::Validate(
+	const Mesh & mesh,
+	int nOrder
+) const {
+	if (!IsCompatible(mesh, nOrder)) {
+		_EXCEPTION2("Quadrature table dimension mismatch with Mesh (%i, %i)",
+			GetFaceCount(), mesh.faces.size());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
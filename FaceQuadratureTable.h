@@ -0,0 +1,212 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    FaceQuadratureTable.h
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _FACEQUADRATURETABLE_H_
+#define _FACEQUADRATURETABLE_H_
+
+#include "DataVector.h"
+
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+
+class Mesh;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Order of the triangular quadrature rule used by the remap operators.
+///	</summary>
+static const int RemapQuadratureOrder = 4;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A table of the triangular quadrature points of all Faces of a Mesh.
+///		Each Face is split into the sub-triangles (0, j+1, j+2), and the
+///		area of each sub-triangle and the coordinates of its quadrature
+///		points projected onto the unit sphere are stored in separate arrays.
+///		The table depends only on the Mesh and the order of the quadrature
+///		rule, so it can be computed once and shared by all remap operators.
+///	</summary>
+class FaceQuadratureTable {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	FaceQuadratureTable() :
+		m_nOrder(0),
+		m_nPoints(0),
+		m_nNodes(0),
+		m_nMeshHash(0)
+	{ }
+
+public:
+	///	<summary>
+	///		Compute the table for all Faces of mesh using the triangular
+	///		quadrature rule of order nOrder.
+	///	</summary>
+	void Initialize(
+		const Mesh & mesh,
+		int nOrder
+	);
+
+	///	<summary>
+	///		Load the table from a NetCDF file.  Returns false if the file
+	///		does not exist or does not contain a quadrature table.
+	///	</summary>
+	bool Read(
+		const std::string & strInput
+	);
+
+	///	<summary>
+	///		Write the table to a NetCDF file.
+	///	</summary>
+	void Write(
+		const std::string & strOutput
+	) const;
+
+	///	<summary>
+	///		Check if the table was computed for mesh with order nOrder.
+	///	</summary>
+	bool IsCompatible(
+		const Mesh & mesh,
+		int nOrder
+	) const;
+
+	///	<summary>
+	///		Verify the table was computed for mesh with order nOrder.
+	///	</summary>
+	void Validate(
+		const Mesh & mesh,
+		int nOrder
+	) const;
+
+public:
+	///	<summary>
+	///		Order of the quadrature rule.
+	///	</summary>
+	int GetOrder() const {
+		return m_nOrder;
+	}
+
+	///	<summary>
+	///		Number of quadrature points per sub-triangle.
+	///	</summary>
+	int GetPoints() const {
+		return m_nPoints;
+	}
+
+	///	<summary>
+	///		Quadrature weights of the points of each sub-triangle.
+	///	</summary>
+	const DataVector<double> & GetW() const {
+		return m_dW;
+	}
+
+	///	<summary>
+	///		Number of Faces.
+	///	</summary>
+	int GetFaceCount() const {
+		return static_cast<int>(m_vecTriBegin.GetRows()) - 1;
+	}
+
+	///	<summary>
+	///		Index of the first sub-triangle of Face ixFace.
+	///	</summary>
+	int GetTriangleBegin(int ixFace) const {
+		return m_vecTriBegin[ixFace];
+	}
+
+	///	<summary>
+	///		Number of sub-triangles of Face ixFace.
+	///	</summary>
+	int GetTriangleCount(int ixFace) const {
+		return m_vecTriBegin[ixFace+1] - m_vecTriBegin[ixFace];
+	}
+
+	///	<summary>
+	///		Area of sub-triangle ixTri.
+	///	</summary>
+	double GetTriangleArea(int ixTri) const {
+		return m_dTriArea[ixTri];
+	}
+
+	///	<summary>
+	///		Coordinates of the quadrature points of sub-triangle ixTri.
+	///	</summary>
+	const double * GetX(int ixTri) const {
+		return &(m_dX[ixTri * m_nPoints]);
+	}
+
+	const double * GetY(int ixTri) const {
+		return &(m_dY[ixTri * m_nPoints]);
+	}
+
+	const double * GetZ(int ixTri) const {
+		return &(m_dZ[ixTri * m_nPoints]);
+	}
+
+protected:
+	///	<summary>
+	///		Order of the quadrature rule.
+	///	</summary>
+	int m_nOrder;
+
+	///	<summary>
+	///		Number of quadrature points per sub-triangle.
+	///	</summary>
+	int m_nPoints;
+
+	///	<summary>
+	///		Number of Nodes of the Mesh.
+	///	</summary>
+	int m_nNodes;
+
+	///	<summary>
+	///		Hash of the connectivity of all Faces of the Mesh.
+	///	</summary>
+	int m_nMeshHash;
+
+	///	<summary>
+	///		Quadrature weights.
+	///	</summary>
+	DataVector<double> m_dW;
+
+	///	<summary>
+	///		Index of the first sub-triangle of each Face, followed by the
+	///		total number of sub-triangles.
+	///	</summary>
+	DataVector<int> m_vecTriBegin;
+
+	///	<summary>
+	///		Area of each sub-triangle.
+	///	</summary>
+	DataVector<double> m_dTriArea;
+
+	///	<summary>
+	///		Coordinates of each quadrature point.
+	///	</summary>
+	DataVector<double> m_dX;
+	DataVector<double> m_dY;
+	DataVector<double> m_dZ;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -18,6 +18,7 @@
 #include "PolynomialInterp.h"
 #include "GridElements.h"
 #include "GaussLobattoQuadrature.h"
+#include "Exception.h"
 
 #include <map>
 
@@ -205,34 +206,179 @@ void ApplyInverseMap(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Determine if every Edge of the mesh is shared by exactly two Faces,
+///		so that GLL nodes can be identified from the mesh topology alone.
+///	</summary>
+static bool IsClosedConformingMesh(
+	const Mesh & mesh,
+	const EdgeMap & edgemap
+) {
+	for (int k = 0; k < mesh.faces.size(); k++) {
+		const Face & face = mesh.faces[k];
+
+		int nEdges = static_cast<int>(face.edges.size());
+		for (int l = 0; l < nEdges; l++) {
+			if (face[l] == face[(l+1)%nEdges]) {
+				return false;
+			}
+		}
+	}
+
+	for (EdgeMapConstIterator iter = edgemap.begin();
+		iter != edgemap.end(); iter++
+	) {
+		if (!iter->second.IsComplete()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number the GLL nodes of all Faces from the mesh topology.  GLL nodes
+///		at the corners of a Face are identified with the corresponding mesh
+///		Node, GLL nodes along an Edge with the Edge and their position from
+///		the smaller Node of the Edge, and all other GLL nodes are unique to
+///		their Face.  Nodes are numbered in order of first appearance, so
+///		that the numbering matches that of a search by coordinates.
+///	</summary>
+static void GenerateTopologicalGLLNodes(
+	const Mesh & mesh,
+	const EdgeMap & edgemap,
+	int nP,
+	GLLElementData<int> & dataGLLnodes
+) {
+	int nElements = static_cast<int>(mesh.faces.size());
+	int nNodes = static_cast<int>(mesh.nodes.size());
+	int nEdgeInterior = nP - 2;
+
+	// Entities are the mesh Nodes followed by the interior GLL nodes
+	// of each Edge; GLL nodes interior to a Face have no entity
+	const int FaceInteriorEntity = (-1);
+
+	int nEntities = nNodes + static_cast<int>(edgemap.size()) * nEdgeInterior;
+
+	// Corner of the Face at each corner GLL node (i,j)
+	const int ixCorner[2][2] = {{0, 3}, {1, 2}};
+
+	// Determine the entity of each GLL node
+#pragma omp parallel for schedule(static)
+	for (int k = 0; k < nElements; k++) {
+		const Face & face = mesh.faces[k];
+
+		// Index of the Edge along each side of the Face, with the side
+		// traversed from its first to its second Node
+		int ixSideNode[4][2] = {
+			{face[0], face[1]},
+			{face[1], face[2]},
+			{face[3], face[2]},
+			{face[0], face[3]}};
+
+		int ixSideEdge[4];
+		for (int l = 0; l < 4; l++) {
+			EdgeMapConstIterator iter =
+				edgemap.find(Edge(ixSideNode[l][0], ixSideNode[l][1]));
+
+			ixSideEdge[l] = static_cast<int>(iter - edgemap.begin());
+		}
+
+		for (int j = 0; j < nP; j++) {
+		for (int i = 0; i < nP; i++) {
+			bool fEdgeI = ((i == 0) || (i == nP-1));
+			bool fEdgeJ = ((j == 0) || (j == nP-1));
+
+			int ixEntity;
+
+			// Corner nodes
+			if (fEdgeI && fEdgeJ) {
+				ixEntity = face[ixCorner[(i == 0)?(0):(1)][(j == 0)?(0):(1)]];
+
+			// Edge nodes
+			} else if (fEdgeI || fEdgeJ) {
+				int l;
+				int t;
+				if (j == 0) {
+					l = 0;
+					t = i;
+				} else if (i == nP-1) {
+					l = 1;
+					t = j;
+				} else if (j == nP-1) {
+					l = 2;
+					t = i;
+				} else {
+					l = 3;
+					t = j;
+				}
+
+				if (ixSideNode[l][0] > ixSideNode[l][1]) {
+					t = nP - 1 - t;
+				}
+
+				ixEntity = nNodes + ixSideEdge[l] * nEdgeInterior + (t - 1);
+
+			// Interior nodes
+			} else {
+				ixEntity = FaceInteriorEntity;
+			}
+
+			dataGLLnodes[k][j * nP + i] = ixEntity;
+		}
+		}
+	}
+
+	// Number GLL nodes in order of first appearance
+	std::vector<int> vecEntityNode(nEntities, 0);
+
+	int nGLLNodes = 0;
+
+	for (int k = 0; k < nElements; k++) {
+		for (int j = 0; j < nP; j++) {
+		for (int i = 0; i < nP; i++) {
+			int ixEntity = dataGLLnodes[k][j * nP + i];
+
+			if (ixEntity == FaceInteriorEntity) {
+				nGLLNodes++;
+				dataGLLnodes[k][j * nP + i] = nGLLNodes;
+
+			} else {
+				if (vecEntityNode[ixEntity] == 0) {
+					nGLLNodes++;
+					vecEntityNode[ixEntity] = nGLLNodes;
+				}
+				dataGLLnodes[k][j * nP + i] = vecEntityNode[ixEntity];
+			}
+		}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 double GenerateMetaData(
 	const Mesh & mesh,
 	int nP,
 	bool fBubble,
-	DataMatrix3D<int> & dataGLLnodes,
-	DataMatrix3D<double> & dataGLLJacobian
+	GLLElementData<int> & dataGLLnodes,
+	GLLElementData<double> & dataGLLJacobian
 ) {
 
 	// Number of Faces
 	int nElements = static_cast<int>(mesh.faces.size());
 
 	// Initialize data structures
-	dataGLLnodes.Initialize(nP, nP, nElements);
-	dataGLLJacobian.Initialize(nP, nP, nElements);
-
-	std::map<Node, int> mapNodes;
+	dataGLLnodes.Initialize(nP, nElements);
+	dataGLLJacobian.Initialize(nP, nElements);
 
 	// GLL Quadrature nodes
 	DataVector<double> dG;
 	DataVector<double> dW;
 	GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dG, dW);
 
-	// Accumulated Jacobian
-	double dAccumulatedJacobian = 0.0;
-
-	// Growing array of Jacobian values
-	std::vector<double> vecGLLJacobian;
-
 	// Verify face areas are available
 	if (fBubble) {
 		if (mesh.vecFaceArea.GetRows() != nElements) {
@@ -240,8 +386,37 @@ double GenerateMetaData(
 		}
 	}
 
+	// GLL nodes of a closed conforming mesh are numbered from its
+	// topology, and otherwise by searching for their coordinates
+	EdgeMap edgemapLocal;
+	const EdgeMap * pedgemap = &(mesh.edgemap);
+
+	if (mesh.edgemap.size() == 0) {
+		edgemapLocal.Construct(
+			mesh.faces, static_cast<int>(mesh.nodes.size()));
+		pedgemap = &edgemapLocal;
+	}
+
+	bool fTopological =
+		(nP >= 2) && IsClosedConformingMesh(mesh, *pedgemap);
+
+	// Coordinates of all GLL nodes, if numbered by coordinates
+	std::vector<Node> vecGLLNodeCoords;
+	if (!fTopological) {
+		vecGLLNodeCoords.resize(
+			static_cast<size_t>(nElements) * nP * nP);
+	}
+
+	// Numerical area of each Face
+	std::vector<double> vecFaceNumericalArea(nElements);
+
+	// Exception raised while processing Faces
+	FaceLoopException exFaces;
+
 	// Write metadata
+#pragma omp parallel for schedule(static)
 	for (int k = 0; k < nElements; k++) {
+	try {
 		const Face & face = mesh.faces[k];
 		const NodeVector & nodevec = mesh.nodes;
 
@@ -253,79 +428,7 @@ double GenerateMetaData(
 
 		for (int j = 0; j < nP; j++) {
 		for (int i = 0; i < nP; i++) {
-/*
-			double dXc =
-				  nodevec[face[0]].x * (1.0 - dG[i]) * (1.0 - dG[j])
-				+ nodevec[face[1]].x *        dG[i]  * (1.0 - dG[j])
-				+ nodevec[face[2]].x *        dG[i]  *        dG[j]
-				+ nodevec[face[3]].x * (1.0 - dG[i]) *        dG[j];
-
-			double dYc =
-				  nodevec[face[0]].y * (1.0 - dG[i]) * (1.0 - dG[j])
-				+ nodevec[face[1]].y *        dG[i]  * (1.0 - dG[j])
-				+ nodevec[face[2]].y *        dG[i]  *        dG[j]
-				+ nodevec[face[3]].y * (1.0 - dG[i]) *        dG[j];
-
-			double dZc =
-				  nodevec[face[0]].z * (1.0 - dG[i]) * (1.0 - dG[j])
-				+ nodevec[face[1]].z *        dG[i]  * (1.0 - dG[j])
-				+ nodevec[face[2]].z *        dG[i]  *        dG[j]
-				+ nodevec[face[3]].z * (1.0 - dG[i]) *        dG[j];
-
-			double dR = sqrt(dXc * dXc + dYc * dYc + dZc * dZc);
-
-			// Check if this Node exists in the NodeMap
-			Node nodeGLL;
-			nodeGLL.x = dXc / dR;
-			nodeGLL.y = dYc / dR;
-			nodeGLL.z = dZc / dR;
-
-			// Calculate Jacobian
-
-			// Pointwise basis vectors in Cartesian geometry
-			Node dDx1F(
-				(1.0 - dG[j]) * (nodevec[face[1]].x - nodevec[face[0]].x)
-				+      dG[j]  * (nodevec[face[2]].x - nodevec[face[3]].x),
-				(1.0 - dG[j]) * (nodevec[face[1]].y - nodevec[face[0]].y)
-				+      dG[j]  * (nodevec[face[2]].y - nodevec[face[3]].y),
-				(1.0 - dG[j]) * (nodevec[face[1]].z - nodevec[face[0]].z)
-				+      dG[j]  * (nodevec[face[2]].z - nodevec[face[3]].z));
-
-			Node dDx2F(
-				(1.0 - dG[i]) * (nodevec[face[3]].x - nodevec[face[0]].x)
-				+      dG[i]  * (nodevec[face[2]].x - nodevec[face[1]].x),
-				(1.0 - dG[i]) * (nodevec[face[3]].y - nodevec[face[0]].y)
-				+      dG[i]  * (nodevec[face[2]].y - nodevec[face[1]].y),
-				(1.0 - dG[i]) * (nodevec[face[3]].z - nodevec[face[0]].z)
-				+      dG[i]  * (nodevec[face[2]].z - nodevec[face[1]].z));
-
-			// Pointwise basis vectors in spherical geometry
-			double dDenomTerm = 1.0 / (dR * dR * dR);
-
-			Node dDx1G(
-				- dXc * (dYc * dDx1F.y + dZc * dDx1F.z)
-					+ (dYc * dYc + dZc * dZc) * dDx1F.x,
-				- dYc * (dXc * dDx1F.x + dZc * dDx1F.z)
-					+ (dXc * dXc + dZc * dZc) * dDx1F.y,
-				- dZc * (dXc * dDx1F.x + dYc * dDx1F.y)
-					+ (dXc * dXc + dYc * dYc) * dDx1F.z);
-
-			Node dDx2G(
-				- dXc * (dYc * dDx2F.y + dZc * dDx2F.z)
-					+ (dYc * dYc + dZc * dZc) * dDx2F.x,
-				- dYc * (dXc * dDx2F.x + dZc * dDx2F.z)
-					+ (dXc * dXc + dZc * dZc) * dDx2F.y,
-				- dZc * (dXc * dDx2F.x + dYc * dDx2F.y)
-					+ (dXc * dXc + dYc * dYc) * dDx2F.z);
-
-			dDx1G.x *= dDenomTerm;
-			dDx1G.y *= dDenomTerm;
-			dDx1G.z *= dDenomTerm;
-
-			dDx2G.x *= dDenomTerm;
-			dDx2G.y *= dDenomTerm;
-			dDx2G.z *= dDenomTerm;
-*/
+
 			// Get local map vectors
 			Node nodeGLL;
 			Node dDx1G;
@@ -340,17 +443,9 @@ double GenerateMetaData(
 				dDx1G,
 				dDx2G);
 
-			// Determine if this is a unique Node
-			std::map<Node, int>::const_iterator iter = mapNodes.find(nodeGLL);
-			if (iter == mapNodes.end()) {
-
-				// Insert new unique node into map
-				int ixNode = static_cast<int>(mapNodes.size());
-				mapNodes.insert(std::pair<Node, int>(nodeGLL, ixNode));
-				dataGLLnodes[j][i][k] = ixNode + 1;
-
-			} else {
-				dataGLLnodes[j][i][k] = iter->second + 1;
+			if (!fTopological) {
+				vecGLLNodeCoords[(static_cast<size_t>(k) * nP + j) * nP + i] =
+					nodeGLL;
 			}
 
 			// Cross product gives local Jacobian
@@ -370,7 +465,7 @@ double GenerateMetaData(
 
 			dFaceNumericalArea += dJacobian;
 
-			dataGLLJacobian[j][i][k] = dJacobian;
+			dataGLLJacobian[k][j * nP + i] = dJacobian;
 		}
 		}
 
@@ -379,7 +474,7 @@ double GenerateMetaData(
 			double dMassDifference = mesh.vecFaceArea[k] - dFaceNumericalArea;
 			for (int j = 0; j < nP; j++) {
 			for (int i = 0; i < nP; i++) {
-				dataGLLJacobian[j][i][k] +=
+				dataGLLJacobian[k][j * nP + i] +=
 					dMassDifference * dW[i] * dW[j];
  			}
 			}
@@ -387,8 +482,49 @@ double GenerateMetaData(
 			dFaceNumericalArea += dMassDifference;
 		}
 
-		// Accumulate area from element
-		dAccumulatedJacobian += dFaceNumericalArea;
+		vecFaceNumericalArea[k] = dFaceNumericalArea;
+
+	} catch(Exception & e) {
+		exFaces.Record(k, e);
+	}
+	}
+
+	exFaces.Rethrow();
+
+	// Number the GLL nodes
+	if (fTopological) {
+		GenerateTopologicalGLLNodes(mesh, *pedgemap, nP, dataGLLnodes);
+
+	} else {
+		NodeSpatialHash hashNodes;
+		hashNodes.Clear(nElements * (nP - 1) * (nP - 1) + 2);
+
+		for (int k = 0; k < nElements; k++) {
+			for (int j = 0; j < nP; j++) {
+			for (int i = 0; i < nP; i++) {
+				const Node & nodeGLL =
+					vecGLLNodeCoords[(static_cast<size_t>(k) * nP + j) * nP + i];
+
+				// Determine if this is a unique Node
+				int ixNode = hashNodes.Find(nodeGLL);
+				if (ixNode == InvalidNode) {
+
+					// Insert new unique node into hash
+					ixNode = hashNodes.GetSize();
+					hashNodes.Insert(nodeGLL, ixNode);
+				}
+
+				dataGLLnodes[k][j * nP + i] = ixNode + 1;
+			}
+			}
+		}
+	}
+
+	// Accumulate area from each element, in order
+	double dAccumulatedJacobian = 0.0;
+
+	for (int k = 0; k < nElements; k++) {
+		dAccumulatedJacobian += vecFaceNumericalArea[k];
 	}
 
 	return dAccumulatedJacobian;
@@ -397,40 +533,42 @@ double GenerateMetaData(
 ///////////////////////////////////////////////////////////////////////////////
 
 void GenerateUniqueJacobian(
-	const DataMatrix3D<int> & dataGLLnodes,
-	const DataMatrix3D<double> & dataGLLJacobian,
+	const GLLElementData<int> & dataGLLnodes,
+	const GLLElementData<double> & dataGLLJacobian,
 	DataVector<double> & dataUniqueJacobian
 ) {
 	// Verify correct array sizes
-	if ((dataGLLnodes.GetRows() != dataGLLJacobian.GetRows()) ||
-		(dataGLLnodes.GetColumns() != dataGLLJacobian.GetColumns()) ||
-		(dataGLLnodes.GetSubColumns() != dataGLLJacobian.GetSubColumns())
+	if ((dataGLLnodes.GetNp() != dataGLLJacobian.GetNp()) ||
+		(dataGLLnodes.GetElements() != dataGLLJacobian.GetElements())
 	) {
 		_EXCEPTIONT("Dimension mismatch in dataGLLnodes / dataGLLJacobian");
 	}
 
+	int nPointsPerElement = dataGLLnodes.GetNp() * dataGLLnodes.GetNp();
+	int nElements = dataGLLnodes.GetElements();
+
 	// Find the maximum index of GLLnodes
 	int iMaximumIndex = 0;
 
-	for (int i = 0; i < dataGLLnodes.GetRows(); i++) {
-	for (int j = 0; j < dataGLLnodes.GetColumns(); j++) {
-	for (int k = 0; k < dataGLLnodes.GetSubColumns(); k++) {
-		if (dataGLLnodes[i][j][k] > iMaximumIndex) {
-			iMaximumIndex = dataGLLnodes[i][j][k];
+	for (int k = 0; k < nElements; k++) {
+		const int * pNodes = dataGLLnodes[k];
+
+		for (int s = 0; s < nPointsPerElement; s++) {
+			if (pNodes[s] > iMaximumIndex) {
+				iMaximumIndex = pNodes[s];
+			}
 		}
 	}
-	}
-	}
 
 	// Resize unique Jacobian array
 	dataUniqueJacobian.Initialize(iMaximumIndex);
 
-	for (int i = 0; i < dataGLLnodes.GetRows(); i++) {
-	for (int j = 0; j < dataGLLnodes.GetColumns(); j++) {
-	for (int k = 0; k < dataGLLnodes.GetSubColumns(); k++) {
-		dataUniqueJacobian[dataGLLnodes[i][j][k]-1] +=
-			dataGLLJacobian[i][j][k];
-	}
+	// Contributions to each unique node are summed in order of GLL node
+	// and then element, as with the [p][q][element] layout
+	for (int s = 0; s < nPointsPerElement; s++) {
+	for (int k = 0; k < nElements; k++) {
+		dataUniqueJacobian[dataGLLnodes[k][s]-1] +=
+			dataGLLJacobian[k][s];
 	}
 	}
 }
@@ -438,29 +576,170 @@ void GenerateUniqueJacobian(
 ///////////////////////////////////////////////////////////////////////////////
 
 void GenerateDiscontinuousJacobian(
-	const DataMatrix3D<double> & dataGLLJacobian,
+	const GLLElementData<double> & dataGLLJacobian,
 	DataVector<double> & dataDiscontinuousJacobian
 ) {
 
 	// Resize unique Jacobian array
-	dataDiscontinuousJacobian.Initialize(
-		  dataGLLJacobian.GetRows()
-		* dataGLLJacobian.GetColumns()
-		* dataGLLJacobian.GetSubColumns());
-
-	int nP = dataGLLJacobian.GetRows();
-
-	for (int i = 0; i < dataGLLJacobian.GetRows(); i++) {
-	for (int j = 0; j < dataGLLJacobian.GetColumns(); j++) {
-	for (int k = 0; k < dataGLLJacobian.GetSubColumns(); k++) {
-		dataDiscontinuousJacobian[k * nP * nP + i * nP + j] =
-			dataGLLJacobian[i][j][k];
+	dataDiscontinuousJacobian.Initialize(dataGLLJacobian.GetTotalElements());
+
+	int nPointsPerElement = dataGLLJacobian.GetNp() * dataGLLJacobian.GetNp();
+
+	for (int k = 0; k < dataGLLJacobian.GetElements(); k++) {
+		const double * pJacobian = dataGLLJacobian[k];
+
+		for (int s = 0; s < nPointsPerElement; s++) {
+			dataDiscontinuousJacobian[k * nPointsPerElement + s] =
+				pJacobian[s];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the coefficients of the monotone one-dimensional basis with nP
+///		points on [-1,1], sampled at dX.
+///	</summary>
+static void SampleMonotoneGLLBasis(
+	int nP,
+	double dX,
+	double * dCoeff
+) {
+	for (int i = 0; i < nP; i++) {
+		dCoeff[i] = 0.0;
+	}
+
+	// Second order monotone interpolation
+	if (nP == 2) {
+		dCoeff[0] = 0.5 * (1.0 - dX);
+		dCoeff[1] = 0.5 * (1.0 + dX);
+
+	// Third order monotone interpolation
+	} else if (nP == 3) {
+
+		if (dX < 0.0) {
+			dCoeff[0] = dX * dX;
+			dCoeff[1] = 1.0 - dX * dX;
+		} else {
+			dCoeff[1] = 1.0 - dX * dX;
+			dCoeff[2] = dX * dX;
+		}
+/*
+		if (dX < 0.0) {
+			dCoeff[0] = - dX;
+			dCoeff[1] = 1.0 + dX;
+		} else {
+			dCoeff[1] = 1.0 - dX;
+			dCoeff[2] = dX;
+		}
+*/
+	// Fourth order monotone interpolation
+	} else if (nP == 4) {
+
+		const double dGLL1 = 1.0/sqrt(5.0);
+
+		const double dA0 = (1.0 + sqrt(5.0)) / 16.0;
+		const double dB0 = (5.0 + sqrt(5.0)) / 16.0;
+		const double dC0 = (-5.0 - 5.0 * sqrt(5.0)) / 16.0;
+		const double dD0 = (-25.0 - 5.0 * sqrt(5.0)) / 16.0;
+
+		const double dA1 = 0.5;
+		const double dB1 = -(3.0 / 4.0) * sqrt(5.0);
+		const double dC1 = 0.0;
+		const double dD1 = (5.0 / 4.0) * sqrt(5.0);
+
+		if ((dX >= -dGLL1) && (dX <= dGLL1)) {
+			dCoeff[1] =
+				dA1 + dX * (dB1 + dX * (dC1 + dX * dD1));
+			dCoeff[2] =
+				1.0 - dCoeff[1];
+		} else if (dX < -dGLL1) {
+			dCoeff[0] =
+				dA0 + dX * (dB0 + dX * (dC0 + dX * dD0));
+			dCoeff[1] =
+				1.0 - dCoeff[0];
+		} else {
+			dCoeff[3] =
+				dA0 - dX * (dB0 - dX * (dC0 - dX * dD0));
+			dCoeff[2] =
+				1.0 - dCoeff[3];
+		}
+
+	} else {
+		_EXCEPTIONT("Not implemented");
 	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		GLL quadrature nodes with nP points on [0,1], computed once per
+///		polynomial order.
+///	</summary>
+template <int nP>
+struct GLLReferenceNodes {
+	GLLReferenceNodes() {
+		DataVector<double> dGLL;
+		DataVector<double> dWGLL;
+		GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dGLL, dWGLL);
+
+		for (int i = 0; i < nP; i++) {
+			dG[i] = dGLL[i];
+		}
 	}
+
+	double dG[nP];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <int nP>
+void SampleGLLFiniteElement(
+	bool fMonotone,
+	double dAlpha,
+	double dBeta,
+	double * dCoeff
+) {
+	// Interpolation coefficients
+	double dCoeffAlpha[nP];
+	double dCoeffBeta[nP];
+
+	// Non-monotone interpolation
+	if (!fMonotone) {
+
+		// GLL Quadrature nodes on [0,1]
+		static const GLLReferenceNodes<nP> s_nodes;
+
+		// Get interpolation coefficients in each direction
+		PolynomialInterp::LagrangianPolynomialCoeffs<nP>(
+			s_nodes.dG, dCoeffAlpha, dAlpha);
+
+		PolynomialInterp::LagrangianPolynomialCoeffs<nP>(
+			s_nodes.dG, dCoeffBeta, dBeta);
+
+	// Monotone interpolation on [-1,1]
+	} else {
+		SampleMonotoneGLLBasis(nP, 2.0 * dAlpha - 1.0, dCoeffAlpha);
+		SampleMonotoneGLLBasis(nP, 2.0 * dBeta  - 1.0, dCoeffBeta);
 	}
 
+	// Combine coefficients
+	for (int j = 0; j < nP; j++) {
+	for (int i = 0; i < nP; i++) {
+		dCoeff[j * nP + i] = dCoeffAlpha[i] * dCoeffBeta[j];
+	}
+	}
 }
 
+template void SampleGLLFiniteElement<2>(bool, double, double, double *);
+template void SampleGLLFiniteElement<3>(bool, double, double, double *);
+template void SampleGLLFiniteElement<4>(bool, double, double, double *);
+template void SampleGLLFiniteElement<5>(bool, double, double, double *);
+template void SampleGLLFiniteElement<6>(bool, double, double, double *);
+template void SampleGLLFiniteElement<7>(bool, double, double, double *);
+template void SampleGLLFiniteElement<8>(bool, double, double, double *);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SampleGLLFiniteElement(
@@ -470,6 +749,24 @@ void SampleGLLFiniteElement(
 	double dBeta,
 	DataMatrix<double> & dCoeff
 ) {
+	// Specializations on the number of GLL points
+	if ((nP >= 2) && (nP <= 8)) {
+		dCoeff.Initialize(nP, nP, false);
+
+		double * pCoeff = &(dCoeff[0][0]);
+
+		switch (nP) {
+			case 2: SampleGLLFiniteElement<2>(fMonotone, dAlpha, dBeta, pCoeff); break;
+			case 3: SampleGLLFiniteElement<3>(fMonotone, dAlpha, dBeta, pCoeff); break;
+			case 4: SampleGLLFiniteElement<4>(fMonotone, dAlpha, dBeta, pCoeff); break;
+			case 5: SampleGLLFiniteElement<5>(fMonotone, dAlpha, dBeta, pCoeff); break;
+			case 6: SampleGLLFiniteElement<6>(fMonotone, dAlpha, dBeta, pCoeff); break;
+			case 7: SampleGLLFiniteElement<7>(fMonotone, dAlpha, dBeta, pCoeff); break;
+			case 8: SampleGLLFiniteElement<8>(fMonotone, dAlpha, dBeta, pCoeff); break;
+		}
+		return;
+	}
+
 	// Interpolation coefficients
 	DataVector<double> dCoeffAlpha;
 	dCoeffAlpha.Initialize(nP);
@@ -492,106 +789,10 @@ void SampleGLLFiniteElement(
 		PolynomialInterp::LagrangianPolynomialCoeffs(
 			nP, dG, dCoeffBeta, dBeta);
 
-	// Monotone interpolation
+	// Monotone interpolation on [-1,1]
 	} else {
-
-		// Map dAlpha and dBeta to [-1,1]
-		dAlpha = 2.0 * dAlpha - 1.0;
-		dBeta  = 2.0 * dBeta  - 1.0;
-
-		// Second order monotone interpolation
-		if (nP == 2) {
-			dCoeffAlpha[0] = 0.5 * (1.0 - dAlpha);
-			dCoeffAlpha[1] = 0.5 * (1.0 + dAlpha);
-
-			dCoeffBeta[0] = 0.5 * (1.0 - dBeta);
-			dCoeffBeta[1] = 0.5 * (1.0 + dBeta);
-
-		// Third order monotone interpolation
-		} else if (nP == 3) {
-
-			if (dAlpha < 0.0) {
-				dCoeffAlpha[0] = dAlpha * dAlpha;
-				dCoeffAlpha[1] = 1.0 - dAlpha * dAlpha;
-			} else {
-				dCoeffAlpha[1] = 1.0 - dAlpha * dAlpha;
-				dCoeffAlpha[2] = dAlpha * dAlpha;
-			}
-			if (dBeta < 0.0) {
-				dCoeffBeta[0] = dBeta * dBeta;
-				dCoeffBeta[1] = 1.0 - dBeta * dBeta;
-			} else {
-				dCoeffBeta[1] = 1.0 - dBeta * dBeta;
-				dCoeffBeta[2] = dBeta * dBeta;
-			}
-/*
-			if (dAlpha < 0.0) {
-				dCoeffAlpha[0] = - dAlpha;
-				dCoeffAlpha[1] = 1.0 + dAlpha;
-			} else {
-				dCoeffAlpha[1] = 1.0 - dAlpha;
-				dCoeffAlpha[2] = dAlpha;
-			}
-			if (dBeta < 0.0) {
-				dCoeffBeta[0] = - dBeta;
-				dCoeffBeta[1] = 1.0 + dBeta;
-			} else {
-				dCoeffBeta[1] = 1.0 - dBeta;
-				dCoeffBeta[2] = dBeta;
-			}
-*/
-		// Fourth order monotone interpolation
-		} else if (nP == 4) {
-
-			const double dGLL1 = 1.0/sqrt(5.0);
-
-			const double dA0 = (1.0 + sqrt(5.0)) / 16.0;
-			const double dB0 = (5.0 + sqrt(5.0)) / 16.0;
-			const double dC0 = (-5.0 - 5.0 * sqrt(5.0)) / 16.0;
-			const double dD0 = (-25.0 - 5.0 * sqrt(5.0)) / 16.0;
-
-			const double dA1 = 0.5;
-			const double dB1 = -(3.0 / 4.0) * sqrt(5.0);
-			const double dC1 = 0.0;
-			const double dD1 = (5.0 / 4.0) * sqrt(5.0);
-
-			if ((dAlpha >= -dGLL1) && (dAlpha <= dGLL1)) {
-				dCoeffAlpha[1] =
-					dA1 + dAlpha * (dB1 + dAlpha * (dC1 + dAlpha * dD1));
-				dCoeffAlpha[2] =
-					1.0 - dCoeffAlpha[1];
-			} else if (dAlpha < -dGLL1) {
-				dCoeffAlpha[0] =
-					dA0 + dAlpha * (dB0 + dAlpha * (dC0 + dAlpha * dD0));
-				dCoeffAlpha[1] =
-					1.0 - dCoeffAlpha[0];
-			} else {
-				dCoeffAlpha[3] =
-					dA0 - dAlpha * (dB0 - dAlpha * (dC0 - dAlpha * dD0));
-				dCoeffAlpha[2] =
-					1.0 - dCoeffAlpha[3];
-			}
-
-			if ((dBeta >= -dGLL1) && (dBeta <= dGLL1)) {
-				dCoeffBeta[1] =
-					dA1 + dBeta * (dB1 + dBeta * (dC1 + dBeta * dD1));
-				dCoeffBeta[2] =
-					1.0 - dCoeffBeta[1];
-			} else if (dBeta < -dGLL1) {
-				dCoeffBeta[0] =
-					dA0 + dBeta * (dB0 + dBeta * (dC0 + dBeta * dD0));
-				dCoeffBeta[1] =
-					1.0 - dCoeffBeta[0];
-			} else {
-				dCoeffBeta[3] =
-					dA0 - dBeta * (dB0 - dBeta * (dC0 - dBeta * dD0));
-				dCoeffBeta[2] =
-					1.0 - dCoeffBeta[3];
-			}
-
-		} else {
-			_EXCEPTIONT("Not implemented");
-		}
+		SampleMonotoneGLLBasis(nP, 2.0 * dAlpha - 1.0, dCoeffAlpha);
+		SampleMonotoneGLLBasis(nP, 2.0 * dBeta  - 1.0, dCoeffBeta);
 	}
 
 	// Combine coefficients
@@ -602,76 +803,6 @@ void SampleGLLFiniteElement(
 		dCoeff[j][i] = dCoeffAlpha[i] * dCoeffBeta[j];
 	}
 	}
-/*
-	// DEBUG: Override
-	if (fMonotone && (nP == 4)) {
-
-		const double dGLL1 = 1.0/sqrt(5.0);
-
-		if ((dAlpha < -dGLL1) && (dBeta < -dGLL1)) {
-			dCoeff[0][0] = 0.090903957942705;
-			dCoeff[1][0] = 0.251678634003417;
-			dCoeff[0][1] = 0.251678634003417;
-			dCoeff[1][1] = 0.405738774050462;
-			return;
-		}
-		if ((dAlpha < -dGLL1) && (dBeta < dGLL1)) {
-			dCoeff[1][0] = 0.125362728546156;
-			dCoeff[2][0] = 0.125362728546156;
-			dCoeff[1][1] = 0.374637271453844;
-			dCoeff[2][1] = 0.374637271453844;
-			return;
-		}
-		if (dAlpha < -dGLL1) {
-			dCoeff[2][0] = 0.251678634003417;
-			dCoeff[3][0] = 0.090903957942705;
-			dCoeff[3][1] = 0.251678634003417;
-			dCoeff[2][1] = 0.405738774050462;
-			return;
-		}
-		if ((dAlpha < dGLL1) && (dBeta < -dGLL1)) {
-			dCoeff[0][1] = 0.125362728546156;
-			dCoeff[0][2] = 0.125362728546156;
-			dCoeff[1][1] = 0.374637271453844;
-			dCoeff[1][2] = 0.374637271453844;
-			return;
-		}
-		if ((dAlpha < dGLL1) && (dBeta < dGLL1)) {
-			dCoeff[1][1] = 0.25;
-			dCoeff[1][2] = 0.25;
-			dCoeff[2][1] = 0.25;
-			dCoeff[2][2] = 0.25;
-			return;
-		}
-		if (dAlpha < dGLL1) {
-			dCoeff[3][1] = 0.125362728546156;
-			dCoeff[3][2] = 0.125362728546156;
-			dCoeff[2][1] = 0.374637271453844;
-			dCoeff[2][2] = 0.374637271453844;
-			return;
-		}
-		if (dBeta < -dGLL1) {
-			dCoeff[0][2] = 0.251678634003417;
-			dCoeff[0][3] = 0.090903957942705;
-			dCoeff[1][3] = 0.251678634003417;
-			dCoeff[1][2] = 0.405738774050462;
-			return;
-		}
-		if (dBeta < dGLL1) {
-			dCoeff[1][3] = 0.125362728546156;
-			dCoeff[2][3] = 0.125362728546156;
-			dCoeff[1][2] = 0.374637271453844;
-			dCoeff[2][2] = 0.374637271453844;
-			return;
-		}
-
-		dCoeff[3][2] = 0.251678634003417;
-		dCoeff[3][3] = 0.090903957942705;
-		dCoeff[2][3] = 0.251678634003417;
-		dCoeff[2][2] = 0.405738774050462;
-		return;
-	}
-*/
 }
 
 ///////////////////////////////////////////////////////////////////////////////
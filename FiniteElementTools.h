@@ -17,7 +17,7 @@
 #include "Defines.h"
 #include "DataVector.h"
 #include "DataMatrix.h"
-#include "DataMatrix3D.h"
+#include "GLLElementData.h"
 #include "GridElements.h"
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -61,8 +61,8 @@ double GenerateMetaData(
 	const Mesh & mesh,
 	int nP,
 	bool fBubble,
-	DataMatrix3D<int> & dataGLLnodes,
-	DataMatrix3D<double> & dataGLLJacobian
+	GLLElementData<int> & dataGLLnodes,
+	GLLElementData<double> & dataGLLJacobian
 );
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -71,8 +71,8 @@ double GenerateMetaData(
 ///		Generate unique Jacobian values from non-unique Jacobians.
 ///	</summary>
 void GenerateUniqueJacobian(
-	const DataMatrix3D<int> & dataGLLnodes,
-	const DataMatrix3D<double> & dataGLLJacobian,
+	const GLLElementData<int> & dataGLLnodes,
+	const GLLElementData<double> & dataGLLJacobian,
 	DataVector<double> & dataUniqueJacobian
 );
 
@@ -82,7 +82,7 @@ void GenerateUniqueJacobian(
 ///		Generate Jacobian vector from Jacobians on GLL nodes.
 ///	</summary>
 void GenerateDiscontinuousJacobian(
-	const DataMatrix3D<double> & dataGLLJacobian,
+	const GLLElementData<double> & dataGLLJacobian,
 	DataVector<double> & dataUniqueJacobian
 );
 
@@ -102,3 +102,19 @@ void SampleGLLFiniteElement(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Get the coefficients for sampling a 2D finite element with a fixed
+///		number of GLL points at the specified point.  The nP x nP
+///		coefficients are stored in dCoeff in the same order as the
+///		DataMatrix version.  Instantiated for nP = 2 through 8.
+///	</summary>
+template <int nP>
+void SampleGLLFiniteElement(
+	bool fMonotone,
+	double dAlpha,
+	double dBeta,
+	double * dCoeff
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
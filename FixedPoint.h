@@ -30,9 +30,27 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
-///		A fixed point number, used for exact arithmetic.
+///		Backends for FixedPoint arithmetic.
 ///	</summary>
-class FixedPoint {
+enum FixedPointBackend {
+	FixedPointBackend_Decimal,
+	FixedPointBackend_Binary
+};
+
+///	<summary>
+///		A fixed point number, used for exact arithmetic.  All backends
+///		represent the same set of values and produce the same results.
+///	</summary>
+template <FixedPointBackend Backend>
+class FixedPointT;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A fixed point number stored as base 10^16 digits.
+///	</summary>
+template <>
+class FixedPointT<FixedPointBackend_Decimal> {
 
 public:
 	///	<summary>
@@ -54,7 +72,7 @@ public:
 	///	<summary>
 	///		Default constructor.
 	///	</summary>
-	FixedPoint() :
+	FixedPointT() :
 		m_iSign(0),
 		m_iDecimal(0)
 	{
@@ -64,7 +82,7 @@ public:
 	///	<summary>
 	///		Constructor from a double.
 	///	</summary>
-	FixedPoint(double d) {
+	FixedPointT(double d) {
 		Set(d);
 	}
 
@@ -74,12 +92,12 @@ public:
 	///	</summary>
 	inline void Normalize() {
 		uint64_t nCarryover;
-		for (int i = 0; i < Digits; i++) {
+		for (int i = 0; i < Digits-1; i++) {
 			nCarryover = m_vecDigits[i] / MaximumDigit;
 			m_vecDigits[i] = m_vecDigits[i] % MaximumDigit;
 			m_vecDigits[i+1] += nCarryover;
 		}
-		if (nCarryover != 0) {
+		if (m_vecDigits[Digits-1] >= MaximumDigit) {
 			_EXCEPTIONT("FixedPoint overflow");
 		}
 
@@ -140,7 +158,7 @@ private:
 	///		Member sum/difference operator
 	///	</summary>
 	inline void SumDifference(
-		const FixedPoint & fp,
+		const FixedPointT & fp,
 		bool fDifference
 	) {
 		// Check for zero
@@ -257,9 +275,9 @@ private:
 	///		Product operator.
 	///	</summary>
 	inline void Product(
-		const FixedPoint & fp
+		const FixedPointT & fp
 	) {
-		FixedPoint fpTemp(*this);
+		FixedPointT fpTemp(*this);
 
 		Zero();
 
@@ -301,7 +319,7 @@ public:
 	///	<summary>
 	///		Assignment operator.
 	///	</summary>
-	inline const FixedPoint & operator=(const FixedPoint & fp) {
+	inline const FixedPointT & operator=(const FixedPointT & fp) {
 		m_iSign = fp.m_iSign;
 		m_iDecimal = fp.m_iDecimal;
 		memcpy(m_vecDigits, fp.m_vecDigits, Digits * sizeof(uint64_t));
@@ -312,7 +330,7 @@ public:
 	///	<summary>
 	///		Inline sum operator.
 	///	</summary>
-	inline FixedPoint & operator+=(const FixedPoint & fp) {
+	inline FixedPointT & operator+=(const FixedPointT & fp) {
 		SumDifference(fp, false);
 		return (*this);
 	}
@@ -320,8 +338,8 @@ public:
 	///	<summary>
 	///		Sum operator.
 	///	</summary>
-	inline FixedPoint operator+(const FixedPoint & fp) const {
-		FixedPoint fpOut(*this);
+	inline FixedPointT operator+(const FixedPointT & fp) const {
+		FixedPointT fpOut(*this);
 		fpOut.SumDifference(fp, false);
 		return fpOut;
 	}
@@ -329,7 +347,7 @@ public:
 	///	<summary>
 	///		Inline difference operator.
 	///	</summary>
-	inline FixedPoint & operator-=(const FixedPoint & fp) {
+	inline FixedPointT & operator-=(const FixedPointT & fp) {
 		SumDifference(fp, true);
 		return (*this);
 	}
@@ -337,8 +355,8 @@ public:
 	///	<summary>
 	///		Difference operator.
 	///	</summary>
-	inline FixedPoint operator-(const FixedPoint & fp) const {
-		FixedPoint fpOut(*this);
+	inline FixedPointT operator-(const FixedPointT & fp) const {
+		FixedPointT fpOut(*this);
 		fpOut.SumDifference(fp, true);
 		return fpOut;
 	}
@@ -346,7 +364,7 @@ public:
 	///	<summary>
 	///		Inline product operator.
 	///	</summary>
-	inline FixedPoint & operator*=(const FixedPoint & fp) {
+	inline FixedPointT & operator*=(const FixedPointT & fp) {
 		Product(fp);
 		return (*this);
 	}
@@ -354,8 +372,8 @@ public:
 	///	<summary>
 	///		Product operator.
 	///	</summary>
-	inline FixedPoint operator*(const FixedPoint & fp) const {
-		FixedPoint fpOut(*this);
+	inline FixedPointT operator*(const FixedPointT & fp) const {
+		FixedPointT fpOut(*this);
 		fpOut.Product(fp);
 		return fpOut;
 	}
@@ -363,7 +381,7 @@ public:
 	///	<summary>
 	///		Negation operator.
 	///	</summary>
-	inline const FixedPoint & Negate() {
+	inline const FixedPointT & Negate() {
 		m_iSign = - m_iSign;
 		return (*this);
 	}
@@ -475,5 +493,500 @@ protected:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#ifdef __SIZEOF_INT128__
+
+///	<summary>
+///		A fixed point number stored as an integer multiple of a power of
+///		10^-16, where the integer is held in binary 64-bit limbs.  Products
+///		use unsigned 128-bit multiply-accumulate, and carries are only
+///		propagated when a limb overflows, so no division is needed except
+///		when converting to decimal.
+///	</summary>
+template <>
+class FixedPointT<FixedPointBackend_Binary> {
+
+public:
+	///	<summary>
+	///		Number of base 10^16 digits of precision.
+	///	</summary>
+	static const int Digits = 8;
+
+	///	<summary>
+	///		Number of 64-bit limbs, sufficient to hold 10^(16 Digits).
+	///	</summary>
+	static const int Limbs = 8;
+
+	///	<summary>
+	///		Maximum value in each decimal Digit.
+	///	</summary>
+	static const uint64_t MaximumDigit = 10000000000000000ULL;
+
+public:
+	///	<summary>
+	///		Default constructor.
+	///	</summary>
+	FixedPointT() {
+		Zero();
+	}
+
+	///	<summary>
+	///		Constructor from a double.
+	///	</summary>
+	FixedPointT(double d) {
+		Set(d);
+	}
+
+public:
+	///	<summary>
+	///		Set equal to zero.
+	///	</summary>
+	inline void Zero() {
+		m_iSign = 0;
+		m_iDecimal = 1;
+		memset(m_vecLimbs, 0, sizeof(uint64_t) * Limbs);
+	}
+
+	///	<summary>
+	///		Set the FixedPoint number.
+	///	</summary>
+	inline void Set(double d) {
+		Zero();
+
+		uint64_t nValue;
+		if (d > 0.0) {
+			nValue = static_cast<int64_t>( d * 1.0e16);
+			m_iSign = +1;
+
+		} else if (d == 0.0) {
+			return;
+
+		} else {
+			nValue = static_cast<int64_t>(-d * 1.0e16);
+			m_iSign = -1;
+		}
+
+		if (nValue == MaximumDigit) {
+			nValue = MaximumDigit-1;
+		} else if (nValue > MaximumDigit) {
+			_EXCEPTIONT("FixedPoint cannot be set by value larger than 1");
+		}
+
+		m_vecLimbs[0] = nValue;
+
+		if (nValue == 0) {
+			m_iSign = 0;
+		}
+	}
+
+private:
+	///	<summary>
+	///		Returns true if the magnitude of this number is zero.
+	///	</summary>
+	inline bool IsMagnitudeZero() const {
+		for (int i = 0; i < Limbs; i++) {
+			if (m_vecLimbs[i] != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	///	<summary>
+	///		Number of limbs up to and including the last non-zero limb.
+	///	</summary>
+	inline int ActiveLimbs() const {
+		int n = Limbs;
+		for (; n > 0; n--) {
+			if (m_vecLimbs[n-1] != 0) {
+				break;
+			}
+		}
+		return n;
+	}
+
+	///	<summary>
+	///		Shift the decimal point right by nShift digits, leaving the value
+	///		unchanged.
+	///	</summary>
+	inline void ShiftDecimal(int nShift) {
+		for (int s = 0; s < nShift; s++) {
+			unsigned __int128 nCarry = 0;
+			for (int i = 0; i < Limbs; i++) {
+				unsigned __int128 nTerm =
+					static_cast<unsigned __int128>(m_vecLimbs[i])
+						* MaximumDigit + nCarry;
+
+				m_vecLimbs[i] = static_cast<uint64_t>(nTerm);
+				nCarry = nTerm >> 64;
+			}
+			if (nCarry != 0) {
+				_EXCEPTIONT("Integer overflow detected");
+			}
+		}
+		m_iDecimal += nShift;
+	}
+
+	///	<summary>
+	///		Compare magnitudes, returning -1, 0 or +1.
+	///	</summary>
+	static inline int CompareMagnitude(
+		const uint64_t * a,
+		const uint64_t * b
+	) {
+		for (int i = Limbs-1; i >= 0; i--) {
+			if (a[i] > b[i]) {
+				return (+1);
+			} else if (a[i] < b[i]) {
+				return (-1);
+			}
+		}
+		return 0;
+	}
+
+	///	<summary>
+	///		Member sum/difference operator
+	///	</summary>
+	inline void SumDifference(
+		const FixedPointT & fp,
+		bool fDifference
+	) {
+		// Check for zero
+		if (fp.m_iSign == 0) {
+			return;
+		}
+
+		// Align decimal points
+		FixedPointT fpAligned;
+		const uint64_t * pLimbs = fp.m_vecLimbs;
+
+		if (m_iDecimal < fp.m_iDecimal) {
+			ShiftDecimal(fp.m_iDecimal - m_iDecimal);
+
+		} else if (m_iDecimal > fp.m_iDecimal) {
+			fpAligned = fp;
+			fpAligned.ShiftDecimal(m_iDecimal - fp.m_iDecimal);
+			pLimbs = fpAligned.m_vecLimbs;
+		}
+
+		// Sign of the second term
+		int iFPSign = fp.m_iSign;
+		if (fDifference) {
+			iFPSign = - iFPSign;
+		}
+
+		// Signs are the same, add values
+		if (((m_iSign >= 0) && (iFPSign >= 0)) ||
+			((m_iSign <= 0) && (iFPSign <= 0))
+		) {
+			uint64_t nCarry = 0;
+			for (int i = 0; i < Limbs; i++) {
+				unsigned __int128 nTerm =
+					static_cast<unsigned __int128>(m_vecLimbs[i])
+						+ pLimbs[i] + nCarry;
+
+				m_vecLimbs[i] = static_cast<uint64_t>(nTerm);
+				nCarry = static_cast<uint64_t>(nTerm >> 64);
+			}
+			if (nCarry != 0) {
+				_EXCEPTIONT("Integer overflow detected");
+			}
+
+			if (m_iSign == 0) {
+				m_iSign = iFPSign;
+			}
+
+		// Signs are different, difference values
+		} else {
+			int iCompare = CompareMagnitude(m_vecLimbs, pLimbs);
+
+			const uint64_t * pLarge = m_vecLimbs;
+			const uint64_t * pSmall = pLimbs;
+
+			if (iCompare < 0) {
+				m_iSign = - m_iSign;
+				pLarge = pLimbs;
+				pSmall = m_vecLimbs;
+			}
+
+			uint64_t nBorrow = 0;
+			for (int i = 0; i < Limbs; i++) {
+				uint64_t nLarge = pLarge[i];
+				uint64_t nSmall = pSmall[i];
+				uint64_t nDiff = nLarge - nSmall - nBorrow;
+
+				nBorrow =
+					((nLarge < nSmall) || ((nLarge - nSmall) < nBorrow))?(1):(0);
+
+				m_vecLimbs[i] = nDiff;
+			}
+		}
+
+		// Check for zero
+		if (IsMagnitudeZero()) {
+			m_iSign = 0;
+			m_iDecimal = 1;
+		}
+	}
+
+	///	<summary>
+	///		Product operator.
+	///	</summary>
+	inline void Product(
+		const FixedPointT & fp
+	) {
+		int nDecimal = m_iDecimal + fp.m_iDecimal;
+		if (nDecimal > Digits) {
+			Print(); printf("\n");
+			fp.Print(); printf("\n");
+			_EXCEPTIONT("FixedPoint overflow");
+		}
+
+		int nA = ActiveLimbs();
+		int nB = fp.ActiveLimbs();
+
+		uint64_t vecResult[2 * Limbs];
+		memset(vecResult, 0, sizeof(uint64_t) * 2 * Limbs);
+
+		for (int i = 0; i < nA; i++) {
+			uint64_t nCarry = 0;
+			for (int j = 0; j < nB; j++) {
+				unsigned __int128 nTerm =
+					static_cast<unsigned __int128>(m_vecLimbs[i])
+						* fp.m_vecLimbs[j]
+					+ vecResult[i+j]
+					+ nCarry;
+
+				vecResult[i+j] = static_cast<uint64_t>(nTerm);
+				nCarry = static_cast<uint64_t>(nTerm >> 64);
+			}
+			vecResult[i+nB] = nCarry;
+		}
+
+		for (int i = Limbs; i < 2 * Limbs; i++) {
+			if (vecResult[i] != 0) {
+				_EXCEPTIONT("FixedPoint overflow");
+			}
+		}
+
+		memcpy(m_vecLimbs, vecResult, sizeof(uint64_t) * Limbs);
+
+		m_iDecimal = nDecimal;
+		m_iSign = m_iSign * fp.m_iSign;
+
+		// Check for zero
+		if (m_iSign == 0) {
+			m_iDecimal = 1;
+		}
+	}
+
+	///	<summary>
+	///		Extract the lowest nDigits base 10^16 digits of the magnitude.
+	///	</summary>
+	inline void GetDecimalDigits(
+		int nDigits,
+		uint64_t * pDigits
+	) const {
+		uint64_t vecLimbs[Limbs];
+		memcpy(vecLimbs, m_vecLimbs, sizeof(uint64_t) * Limbs);
+
+		for (int d = 0; d < nDigits; d++) {
+			unsigned __int128 nRemainder = 0;
+			for (int i = Limbs-1; i >= 0; i--) {
+				unsigned __int128 nCurrent =
+					(nRemainder << 64) | vecLimbs[i];
+
+				vecLimbs[i] = static_cast<uint64_t>(nCurrent / MaximumDigit);
+				nRemainder = nCurrent % MaximumDigit;
+			}
+			pDigits[d] = static_cast<uint64_t>(nRemainder);
+		}
+	}
+
+public:
+	///	<summary>
+	///		Inline sum operator.
+	///	</summary>
+	inline FixedPointT & operator+=(const FixedPointT & fp) {
+		SumDifference(fp, false);
+		return (*this);
+	}
+
+	///	<summary>
+	///		Sum operator.
+	///	</summary>
+	inline FixedPointT operator+(const FixedPointT & fp) const {
+		FixedPointT fpOut(*this);
+		fpOut.SumDifference(fp, false);
+		return fpOut;
+	}
+
+	///	<summary>
+	///		Inline difference operator.
+	///	</summary>
+	inline FixedPointT & operator-=(const FixedPointT & fp) {
+		SumDifference(fp, true);
+		return (*this);
+	}
+
+	///	<summary>
+	///		Difference operator.
+	///	</summary>
+	inline FixedPointT operator-(const FixedPointT & fp) const {
+		FixedPointT fpOut(*this);
+		fpOut.SumDifference(fp, true);
+		return fpOut;
+	}
+
+	///	<summary>
+	///		Inline product operator.
+	///	</summary>
+	inline FixedPointT & operator*=(const FixedPointT & fp) {
+		Product(fp);
+		return (*this);
+	}
+
+	///	<summary>
+	///		Product operator.
+	///	</summary>
+	inline FixedPointT operator*(const FixedPointT & fp) const {
+		FixedPointT fpOut(*this);
+		fpOut.Product(fp);
+		return fpOut;
+	}
+
+	///	<summary>
+	///		Negation operator.
+	///	</summary>
+	inline const FixedPointT & Negate() {
+		m_iSign = - m_iSign;
+		return (*this);
+	}
+
+	///	<summary>
+	///		Returns true if this number is positive.
+	///	</summary>
+	bool IsPositive() const {
+		return (m_iSign > 0);
+	}
+
+	///	<summary>
+	///		Returns true if this number is negative.
+	///	</summary>
+	bool IsNegative() const {
+		return (m_iSign < 0);
+	}
+
+	///	<summary>
+	///		Returns true if this number is nonpositive.
+	///	</summary>
+	bool IsNonPositive() const {
+		return (m_iSign <= 0);
+	}
+
+	///	<summary>
+	///		Returns true if this number is nonnegative.
+	///	</summary>
+	bool IsNonNegative() const {
+		return (m_iSign >= 0);
+	}
+
+	///	<summary>
+	///		Returns true if this number is zero.
+	///	</summary>
+	bool IsZero() const {
+		return (m_iSign == 0);
+	}
+
+public:
+	///	<summary>
+	///		Convert this number to a double, summing the fractional decimal
+	///		digits in the same order as the decimal backend.
+	///	</summary>
+	Real ToReal() const {
+		if (m_iSign == 0) {
+			return 0.0;
+		}
+		if (m_iDecimal == 0) {
+			_EXCEPTIONT("Invalid value of m_iDecimal");
+		}
+
+		uint64_t vecDigits[Digits];
+		GetDecimalDigits(m_iDecimal, vecDigits);
+
+		const Real dInv = 1.0 / static_cast<double>(MaximumDigit);
+
+		Real dCurrentInv = dInv;
+		Real dOut = 0.0;
+		for (int i = 1; i <= m_iDecimal; i++) {
+			dOut += static_cast<Real>(vecDigits[m_iDecimal-i]) * dCurrentInv;
+			dCurrentInv *= dInv;
+		}
+
+		if (m_iSign == -1) {
+			dOut *= -1.0;
+		}
+
+		return dOut;
+	}
+
+	///	<summary>
+	///		Print this number
+	///	</summary>
+	void Print() const {
+		uint64_t vecDigits[Digits];
+		GetDecimalDigits(Digits, vecDigits);
+
+		if (m_iSign < 0) {
+			printf("-");
+		}
+		int i = Digits-1;
+		for (; i > 0; i--) {
+			if (vecDigits[i] != 0) {
+				break;
+			}
+			if (i+1 == m_iDecimal) {
+				break;
+			}
+		}
+		for (; i >= 0; i--) {
+			if (i+1 == m_iDecimal) {
+				printf(".");
+			}
+			printf("%016llu", static_cast<unsigned long long>(vecDigits[i]));
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Sign of this expression (-1, 0 or +1).
+	///	</summary>
+	int m_iSign;
+
+	///	<summary>
+	///		Decimal point location, in units of base 10^16 digits.
+	///	</summary>
+	int m_iDecimal;
+
+	///	<summary>
+	///		Magnitude of the number, multiplied by 10^(16 m_iDecimal),
+	///		stored in little-endian 64-bit limbs.
+	///	</summary>
+	uint64_t m_vecLimbs[Limbs];
+};
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		The FixedPoint type used for exact arithmetic.
+///	</summary>
+#if defined(USE_BINARY_FIXEDPOINT) && defined(__SIZEOF_INT128__)
+typedef FixedPointT<FixedPointBackend_Binary> FixedPoint;
+#else
+typedef FixedPointT<FixedPointBackend_Decimal> FixedPoint;
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
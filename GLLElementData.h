@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    GLLElementData.h
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _GLLELEMENTDATA_H_
+#define _GLLELEMENTDATA_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DataVector.h"
+#include "Exception.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Data on the nP x nP GLL nodes of each element of a spectral element
+///		mesh.  The values of each element are stored contiguously, so that
+///		data[k][p * nP + q] is the value at GLL node (p,q) of element k.
+///		Metadata files store these arrays as [p][q][element], which can be
+///		converted with the PointMajor functions.
+///	</summary>
+template <typename DataType>
+class GLLElementData {
+
+	public:
+		///	<summary>
+		///		Constructor.
+		///	</summary>
+		GLLElementData() :
+			m_nP(0),
+			m_nElements(0)
+		{ }
+
+	public:
+		///	<summary>
+		///		Allocate data for nElements elements of order nP.
+		///	</summary>
+		void Initialize(
+			int nP,
+			int nElements,
+			bool fAutoZero = true
+		) {
+			if ((nP < 0) || (nElements < 0)) {
+				_EXCEPTION2("Invalid GLLElementData dimensions (%i, %i)",
+					nP, nElements);
+			}
+
+			m_nP = nP;
+			m_nElements = nElements;
+
+			m_data.Initialize(nP * nP * nElements, fAutoZero);
+		}
+
+		///	<summary>
+		///		Determine if this GLLElementData is initialized.
+		///	</summary>
+		bool IsInitialized() const {
+			return m_data.IsInitialized();
+		}
+
+	public:
+		///	<summary>
+		///		Load the data from an array with layout [p][q][element].
+		///	</summary>
+		void FromPointMajor(
+			const DataType * pData
+		) {
+			int nPointsPerElement = m_nP * m_nP;
+
+			for (int s = 0; s < nPointsPerElement; s++) {
+				const DataType * pPoint = pData + s * m_nElements;
+
+				for (int k = 0; k < m_nElements; k++) {
+					m_data[k * nPointsPerElement + s] = pPoint[k];
+				}
+			}
+		}
+
+		///	<summary>
+		///		Store the data into an array with layout [p][q][element].
+		///	</summary>
+		void ToPointMajor(
+			DataType * pData
+		) const {
+			int nPointsPerElement = m_nP * m_nP;
+
+			for (int s = 0; s < nPointsPerElement; s++) {
+				DataType * pPoint = pData + s * m_nElements;
+
+				for (int k = 0; k < m_nElements; k++) {
+					pPoint[k] = m_data[k * nPointsPerElement + s];
+				}
+			}
+		}
+
+	public:
+		///	<summary>
+		///		Order of the elements.
+		///	</summary>
+		inline int GetNp() const {
+			return m_nP;
+		}
+
+		///	<summary>
+		///		Number of elements.
+		///	</summary>
+		inline int GetElements() const {
+			return m_nElements;
+		}
+
+		///	<summary>
+		///		Total number of values.
+		///	</summary>
+		inline int GetTotalElements() const {
+			return m_nP * m_nP * m_nElements;
+		}
+
+	public:
+		///	<summary>
+		///		Values of element ixElement, indexed by p * nP + q.
+		///	</summary>
+		inline DataType * operator[](int ixElement) {
+			return &(m_data[ixElement * m_nP * m_nP]);
+		}
+
+		inline const DataType * operator[](int ixElement) const {
+			return &(m_data[ixElement * m_nP * m_nP]);
+		}
+
+	private:
+		///	<summary>
+		///		Order of the elements.
+		///	</summary>
+		int m_nP;
+
+		///	<summary>
+		///		Number of elements.
+		///	</summary>
+		int m_nElements;
+
+		///	<summary>
+		///		Values of all elements.
+		///	</summary>
+		DataVector<DataType> m_data;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
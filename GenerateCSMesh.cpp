@@ -23,15 +23,18 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
-int InsertCSSubNode(
-	int ix0,
-	int ix1,
-	Real alpha,
-	NodeVector & nodes
+///	<summary>
+///		Calculate the node at fraction alpha of the line between node0 and
+///		node1, projected onto the sphere.
+///	</summary>
+Node CalculateCSSubNode(
+	const Node & node0,
+	const Node & node1,
+	Real alpha
 ) {
-	Real dX = nodes[ix0].x + (nodes[ix1].x - nodes[ix0].x) * alpha;
-	Real dY = nodes[ix0].y + (nodes[ix1].y - nodes[ix0].y) * alpha;
-	Real dZ = nodes[ix0].z + (nodes[ix1].z - nodes[ix0].z) * alpha;
+	Real dX = node0.x + (node1.x - node0.x) * alpha;
+	Real dY = node0.y + (node1.y - node0.y) * alpha;
+	Real dZ = node0.z + (node1.z - node0.z) * alpha;
 
 	// Project to sphere
 	Real dRadius = sqrt(dX*dX + dY*dY + dZ*dZ);
@@ -40,48 +43,64 @@ int InsertCSSubNode(
 	dY /= dRadius;
 	dZ /= dRadius;
 
-	// Index
-	int ix = nodes.size();
+	return Node(dX, dY, dZ);
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
-	// Insert node
-	nodes.push_back(Node(dX, dY, dZ));
+///	<summary>
+///		Fraction of the line between two nodes at which the i-th of
+///		nRefineLevel equiangular subdivisions lies.
+///	</summary>
+Real GetCSSubNodeAlpha(
+	int nRefineLevel,
+	int i
+) {
+	Real alpha =
+		static_cast<Real>(i) / static_cast<Real>(nRefineLevel);
 
-	return ix;
+	return 0.5 * (tan(0.25 * M_PI * (2.0 * alpha - 1.0)) + 1.0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Generate the nRefineLevel-1 nodes along the line from ix0 to ix1,
+///		storing them in nodes beginning at ixNodeBegin.
+///	</summary>
 void GenerateCSMultiEdgeVertices(
 	int nRefineLevel,
 	int ix0,
 	int ix1,
+	int ixNodeBegin,
 	NodeVector & nodes,
 	MultiEdge & edge
 ) {
-	edge.clear();
-	edge.push_back(ix0);
-
-	int i;
-	for (i = 1; i < nRefineLevel; i++) {
+	edge.resize(nRefineLevel + 1);
+	edge[0] = ix0;
+	edge[nRefineLevel] = ix1;
 
-		// Nodes along line in Cartesian geometry
-		Real alpha =
-			static_cast<Real>(i) / static_cast<Real>(nRefineLevel);
+#pragma omp parallel for schedule(static)
+	for (int i = 1; i < nRefineLevel; i++) {
+		Real alpha = GetCSSubNodeAlpha(nRefineLevel, i);
 
-		alpha = 0.5 * (tan(0.25 * M_PI * (2.0 * alpha - 1.0)) + 1.0);
+		int ixNode = ixNodeBegin + i - 1;
 
-		// Insert node along edge
-		int ixNode = InsertCSSubNode(ix0, ix1, alpha, nodes);
+		nodes[ixNode] = CalculateCSSubNode(nodes[ix0], nodes[ix1], alpha);
 
-		// Add node to edge
-		edge.push_back(ixNode);
+		edge[i] = ixNode;
 	}
-
-	edge.push_back(ix1);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Generate the nodes and faces of one panel bounded by the given
+///		edges.  The (nResolution-1)^2 interior nodes of the panel are
+///		stored in nodes beginning at ixNodeBegin, row by row from edge0,
+///		and the nResolution^2 faces are stored in faces beginning at
+///		ixFaceBegin.  Both arrays must be preallocated.
+///	</summary>
 void GenerateFacesFromQuad(
 	int nResolution,
 	int iPanel,
@@ -89,38 +108,68 @@ void GenerateFacesFromQuad(
 	const MultiEdge & edge1,
 	const MultiEdge & edge2,
 	const MultiEdge & edge3,
+	int ixNodeBegin,
+	int ixFaceBegin,
 	NodeVector & nodes,
-	FaceVector & vecFaces
+	FaceVector & faces
 ) {
-	MultiEdge edgeTop;
-	MultiEdge edgeBot = edge0;
+	const int nInterior = nResolution - 1;
 
-	for (int j = 0; j < nResolution; j++) {
-
-		// Generate top level edge
-		if (j != nResolution-1) {
-			int ix0 = edge1[j+1];
-			int ix1 = edge2[j+1];
+	// Interior nodes; row j lies on the line from edge1[j] to edge2[j]
+#pragma omp parallel for schedule(static)
+	for (int j = 1; j < nResolution; j++) {
+		const Node & node0 = nodes[edge1[j]];
+		const Node & node1 = nodes[edge2[j]];
 
-			GenerateCSMultiEdgeVertices(nResolution, ix0, ix1, nodes, edgeTop);
+		for (int i = 1; i < nResolution; i++) {
+			Real alpha = GetCSSubNodeAlpha(nResolution, i);
 
-		} else {
-			edgeTop = edge3;
+			nodes[ixNodeBegin + (j-1) * nInterior + (i-1)] =
+				CalculateCSSubNode(node0, node1, alpha);
 		}
+	}
 
-		// Generate face
+	// Index of the node in row j and column i of the panel
+	struct PanelIndex {
+		int nResolution;
+		int nInterior;
+		int ixNodeBegin;
+		const MultiEdge * pEdge[4];
+
+		int operator()(int j, int i) const {
+			if (j == 0) {
+				return (*pEdge[0])[i];
+			} else if (j == nResolution) {
+				return (*pEdge[3])[i];
+			} else if (i == 0) {
+				return (*pEdge[1])[j];
+			} else if (i == nResolution) {
+				return (*pEdge[2])[j];
+			}
+			return ixNodeBegin + (j-1) * nInterior + (i-1);
+		}
+	} ixPanel;
+
+	ixPanel.nResolution = nResolution;
+	ixPanel.nInterior = nInterior;
+	ixPanel.ixNodeBegin = ixNodeBegin;
+	ixPanel.pEdge[0] = &edge0;
+	ixPanel.pEdge[1] = &edge1;
+	ixPanel.pEdge[2] = &edge2;
+	ixPanel.pEdge[3] = &edge3;
+
+	// Generate faces
+#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nResolution; j++) {
 		for (int i = 0; i < nResolution; i++) {
-			Face face(4);
-			face.SetNode(0, edgeBot[i+1]);
-			face.SetNode(1, edgeTop[i+1]);
-			face.SetNode(2, edgeTop[i]);
-			face.SetNode(3, edgeBot[i]);
+			Face & face = faces[ixFaceBegin + j * nResolution + i];
 
-			vecFaces.push_back(face);
+			face.edges.resize(4);
+			face.SetNode(0, ixPanel(j, i+1));
+			face.SetNode(1, ixPanel(j+1, i+1));
+			face.SetNode(2, ixPanel(j+1, i));
+			face.SetNode(3, ixPanel(j, i));
 		}
-
-		// Increment row
-		edgeBot = edgeTop;
 	}
 }
 
@@ -155,99 +204,81 @@ try {
 	NodeVector & nodes = mesh.nodes;
 	FaceVector & faces = mesh.faces;
 
+	// Number of nodes and faces; nodes are stored as the 8 corners, then
+	// the interior nodes of the 12 edges and then the interior nodes of
+	// the 6 panels, so that all shared nodes are indexed analytically
+	const int nInterior = nResolution - 1;
+
+	const int ixEdgeNodeBegin = 8;
+	const int ixPanelNodeBegin = ixEdgeNodeBegin + 12 * nInterior;
+
+	nodes.resize(ixPanelNodeBegin + 6 * nInterior * nInterior);
+	faces.resize(6 * nResolution * nResolution);
+
 	// Generate corner points
 	Real dInvDeltaX = 1.0 / sqrt(3.0);
 
-	nodes.push_back(Node(+dInvDeltaX, -dInvDeltaX, -dInvDeltaX));
-	nodes.push_back(Node(+dInvDeltaX, +dInvDeltaX, -dInvDeltaX));
-	nodes.push_back(Node(-dInvDeltaX, +dInvDeltaX, -dInvDeltaX));
-	nodes.push_back(Node(-dInvDeltaX, -dInvDeltaX, -dInvDeltaX));
-	nodes.push_back(Node(+dInvDeltaX, -dInvDeltaX, +dInvDeltaX));
-	nodes.push_back(Node(+dInvDeltaX, +dInvDeltaX, +dInvDeltaX));
-	nodes.push_back(Node(-dInvDeltaX, +dInvDeltaX, +dInvDeltaX));
-	nodes.push_back(Node(-dInvDeltaX, -dInvDeltaX, +dInvDeltaX));
+	nodes[0] = Node(+dInvDeltaX, -dInvDeltaX, -dInvDeltaX);
+	nodes[1] = Node(+dInvDeltaX, +dInvDeltaX, -dInvDeltaX);
+	nodes[2] = Node(-dInvDeltaX, +dInvDeltaX, -dInvDeltaX);
+	nodes[3] = Node(-dInvDeltaX, -dInvDeltaX, -dInvDeltaX);
+	nodes[4] = Node(+dInvDeltaX, -dInvDeltaX, +dInvDeltaX);
+	nodes[5] = Node(+dInvDeltaX, +dInvDeltaX, +dInvDeltaX);
+	nodes[6] = Node(-dInvDeltaX, +dInvDeltaX, +dInvDeltaX);
+	nodes[7] = Node(-dInvDeltaX, -dInvDeltaX, +dInvDeltaX);
 
 	// Generate edges
+	static const int EdgeCorners[12][2] = {
+		{0, 1}, {1, 2}, {2, 3}, {3, 0},
+		{0, 4}, {1, 5}, {2, 6}, {3, 7},
+		{4, 5}, {5, 6}, {6, 7}, {7, 4}};
+
 	MultiEdgeVector vecMultiEdges;
 	vecMultiEdges.resize(12);
 
-	GenerateCSMultiEdgeVertices(nResolution, 0, 1, nodes, vecMultiEdges[0]);
-	GenerateCSMultiEdgeVertices(nResolution, 1, 2, nodes, vecMultiEdges[1]);
-	GenerateCSMultiEdgeVertices(nResolution, 2, 3, nodes, vecMultiEdges[2]);
-	GenerateCSMultiEdgeVertices(nResolution, 3, 0, nodes, vecMultiEdges[3]);
-
-	GenerateCSMultiEdgeVertices(nResolution, 0, 4, nodes, vecMultiEdges[4]);
-	GenerateCSMultiEdgeVertices(nResolution, 1, 5, nodes, vecMultiEdges[5]);
-	GenerateCSMultiEdgeVertices(nResolution, 2, 6, nodes, vecMultiEdges[6]);
-	GenerateCSMultiEdgeVertices(nResolution, 3, 7, nodes, vecMultiEdges[7]);
-
-	GenerateCSMultiEdgeVertices(nResolution, 4, 5, nodes, vecMultiEdges[8]);
-	GenerateCSMultiEdgeVertices(nResolution, 5, 6, nodes, vecMultiEdges[9]);
-	GenerateCSMultiEdgeVertices(nResolution, 6, 7, nodes, vecMultiEdges[10]);
-	GenerateCSMultiEdgeVertices(nResolution, 7, 4, nodes, vecMultiEdges[11]);
-
-	// Generate equatorial faces
-	GenerateFacesFromQuad(
-		nResolution,
-		0,
-		vecMultiEdges[0],
-		vecMultiEdges[4],
-		vecMultiEdges[5],
-		vecMultiEdges[8],
-		nodes,
-		faces);
-
-	GenerateFacesFromQuad(
-		nResolution,
-		1,
-		vecMultiEdges[1],
-		vecMultiEdges[5],
-		vecMultiEdges[6],
-		vecMultiEdges[9],
-		nodes,
-		faces);
-
-	GenerateFacesFromQuad(
-		nResolution,
-		2,
-		vecMultiEdges[2],
-		vecMultiEdges[6],
-		vecMultiEdges[7],
-		vecMultiEdges[10],
-		nodes,
-		faces);
-
-	GenerateFacesFromQuad(
-		nResolution,
-		3,
-		vecMultiEdges[3],
-		vecMultiEdges[7],
-		vecMultiEdges[4],
-		vecMultiEdges[11],
-		nodes,
-		faces);
-
-	// Generate south polar face
-	GenerateFacesFromQuad(
-		nResolution,
-		5,
-		vecMultiEdges[2].Flip(),
-		vecMultiEdges[3],
-		vecMultiEdges[1].Flip(),
-		vecMultiEdges[0],
-		nodes,
-		faces);
-
-	// Generate north polar face
-	GenerateFacesFromQuad(
-		nResolution,
-		4,
-		vecMultiEdges[8],
-		vecMultiEdges[11].Flip(),
-		vecMultiEdges[9],
-		vecMultiEdges[10].Flip(),
-		nodes,
-		faces);
+	for (int e = 0; e < 12; e++) {
+		GenerateCSMultiEdgeVertices(
+			nResolution,
+			EdgeCorners[e][0],
+			EdgeCorners[e][1],
+			ixEdgeNodeBegin + e * nInterior,
+			nodes,
+			vecMultiEdges[e]);
+	}
+
+	// Panels in order of storage, given by their panel index and their
+	// bottom, left, right and top edges; ~e denotes edge e reversed
+	static const int PanelEdges[6][5] = {
+		{0, 0, 4, 5, 8},
+		{1, 1, 5, 6, 9},
+		{2, 2, 6, 7, 10},
+		{3, 3, 7, 4, 11},
+		{5, ~2, 3, ~1, 0},
+		{4, 8, ~11, 9, ~10}};
+
+	for (int k = 0; k < 6; k++) {
+		MultiEdge edge[4];
+		for (int l = 0; l < 4; l++) {
+			int e = PanelEdges[k][l+1];
+			if (e < 0) {
+				edge[l] = vecMultiEdges[~e].Flip();
+			} else {
+				edge[l] = vecMultiEdges[e];
+			}
+		}
+
+		GenerateFacesFromQuad(
+			nResolution,
+			PanelEdges[k][0],
+			edge[0],
+			edge[1],
+			edge[2],
+			edge[3],
+			ixPanelNodeBegin + k * nInterior * nInterior,
+			k * nResolution * nResolution,
+			nodes,
+			faces);
+	}
 
 	// Announce
 	std::cout << "..Writing mesh to file [" << strOutputFile.c_str() << "] ";
@@ -18,7 +18,7 @@
 #include "CommandLine.h"
 #include "Exception.h"
 #include "GridElements.h"
-#include "DataMatrix3D.h"
+#include "GLLElementData.h"
 #include "GaussLobattoQuadrature.h"
 #include "FiniteElementTools.h"
 
@@ -70,8 +70,8 @@ try {
 	AnnounceEndBlock(NULL);
 
 	// Calculate metadata
-	DataMatrix3D<int> dataGLLnodes;
-	DataMatrix3D<double> dataGLLJacobian;
+	GLLElementData<int> dataGLLnodes;
+	GLLElementData<double> dataGLLJacobian;
 
 	AnnounceStartBlock("Calculating Metadata");
 	double dAccumulatedJacobian =
@@ -101,9 +101,18 @@ try {
 	NcVar * varJacobian =
 		ncOut.add_var("J", ncDouble, dimNp, dimNp, dimElements);
 
-	varGLLnodes->put(&(dataGLLnodes[0][0][0]), nP, nP, nElements);
+	// Metadata is stored as [p][q][element]
+	DataVector<int> vecGLLnodes;
+	vecGLLnodes.Initialize(nP * nP * nElements);
+	dataGLLnodes.ToPointMajor(vecGLLnodes);
 
-	varJacobian->put(&(dataGLLJacobian[0][0][0]), nP, nP, nElements);
+	DataVector<double> vecGLLJacobian;
+	vecGLLJacobian.Initialize(nP * nP * nElements);
+	dataGLLJacobian.ToPointMajor(vecGLLJacobian);
+
+	varGLLnodes->put(&(vecGLLnodes[0]), nP, nP, nElements);
+
+	varJacobian->put(&(vecGLLJacobian[0]), nP, nP, nElements);
 
 	// Done
 	AnnounceBanner();
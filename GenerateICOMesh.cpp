@@ -44,15 +44,18 @@ typedef std::vector<LonLatNode> LonLatNodeVector;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-int InsertSubNode(
-	int ix0,
-	int ix1,
-	double alpha,
-	NodeVector & vecNodes
+///	<summary>
+///		Calculate the node at fraction alpha of the great circle arc
+///		between node0 and node1.
+///	</summary>
+Node CalculateSubNode(
+	const Node & node0,
+	const Node & node1,
+	double alpha
 ) {
-	double dDeltaX = (vecNodes[ix1].x - vecNodes[ix0].x);
-	double dDeltaY = (vecNodes[ix1].y - vecNodes[ix0].y);
-	double dDeltaZ = (vecNodes[ix1].z - vecNodes[ix0].z);
+	double dDeltaX = (node1.x - node0.x);
+	double dDeltaY = (node1.y - node0.y);
+	double dDeltaZ = (node1.z - node0.z);
 	double dCartLength =
 		sqrt(dDeltaX*dDeltaX + dDeltaY*dDeltaY + dDeltaZ*dDeltaZ);
 
@@ -63,37 +66,9 @@ int InsertSubNode(
 
 	alpha = sin(dAlphaTheta) / sin(dBeta) / dCartLength;
 
-	double dX = vecNodes[ix0].x + (vecNodes[ix1].x - vecNodes[ix0].x) * alpha;
-	double dY = vecNodes[ix0].y + (vecNodes[ix1].y - vecNodes[ix0].y) * alpha;
-	double dZ = vecNodes[ix0].z + (vecNodes[ix1].z - vecNodes[ix0].z) * alpha;
-
-	// Project to sphere
-	double dRadius = sqrt(dX*dX + dY*dY + dZ*dZ);
-
-	dX /= dRadius;
-	dY /= dRadius;
-	dZ /= dRadius;
-
-	// Index
-	int ix = vecNodes.size();
-
-	// Insert node
-	vecNodes.push_back(Node(dX, dY, dZ));
-
-	return ix;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-
-int InsertTriFaceCentroidNode(
-	int ix0,
-	int ix1,
-	int ix2,
-	NodeVector & vecNodes
-) {
-	double dX = (vecNodes[ix0].x + vecNodes[ix1].x + vecNodes[ix2].x) / 3.0;
-	double dY = (vecNodes[ix0].y + vecNodes[ix1].y + vecNodes[ix2].y) / 3.0;
-	double dZ = (vecNodes[ix0].z + vecNodes[ix1].z + vecNodes[ix2].z) / 3.0;
+	double dX = node0.x + (node1.x - node0.x) * alpha;
+	double dY = node0.y + (node1.y - node0.y) * alpha;
+	double dZ = node0.z + (node1.z - node0.z) * alpha;
 
 	// Project to sphere
 	double dRadius = sqrt(dX*dX + dY*dY + dZ*dZ);
@@ -102,108 +77,125 @@ int InsertTriFaceCentroidNode(
 	dY /= dRadius;
 	dZ /= dRadius;
 
-	// Index
-	int ix = vecNodes.size();
-
-	// Insert node
-	vecNodes.push_back(Node(dX, dY, dZ));
-
-	return ix;
+	return Node(dX, dY, dZ);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Generate the nRefineLevel-1 nodes along the arc from ix0 to ix1,
+///		storing them in vecNodes beginning at ixNodeBegin.
+///	</summary>
 void GenerateEdgeVertices(
 	int nRefineLevel,
 	int ix0,
 	int ix1,
+	int ixNodeBegin,
 	NodeVector & vecNodes,
 	MultiEdge & edge
 ) {
-	edge.clear();
-	edge.push_back(ix0);
+	edge.resize(nRefineLevel + 1);
+	edge[0] = ix0;
+	edge[nRefineLevel] = ix1;
 
+#pragma omp parallel for schedule(static)
 	for (int i = 1; i < nRefineLevel; i++) {
 
 		// Nodes along line in Cartesian geometry
 		double alpha =
 			static_cast<double>(i) / static_cast<double>(nRefineLevel);
 
-		// Insert node along edge
-		int ixNode = InsertSubNode(ix0, ix1, alpha, vecNodes);
+		int ixNode = ixNodeBegin + i - 1;
 
-		// Add node to edge
-		edge.push_back(ixNode);
-	}
+		vecNodes[ixNode] =
+			CalculateSubNode(vecNodes[ix0], vecNodes[ix1], alpha);
 
-	edge.push_back(ix1);
+		edge[i] = ixNode;
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Generate the nodes and faces of one base triangle bounded by the
+///		given edges.  Row r of the triangle has r+1 nodes; the interior
+///		nodes of rows 2 to nRefineLevel-1 are stored in vecNodes beginning
+///		at ixNodeBegin, and the nRefineLevel^2 faces are stored in vecFaces
+///		beginning at ixFaceBegin.  Both arrays must be preallocated.
+///	</summary>
 void GenerateFacesFromTriangle(
 	int nRefineLevel,
 	const MultiEdge & edge0,
 	const MultiEdge & edge1,
 	const MultiEdge & edge2,
+	int ixNodeBegin,
+	int ixFaceBegin,
 	NodeVector & vecNodes,
 	FaceVector & vecFaces
 ) {
-	int i;
-	int j;
-	int k;
+	// Interior nodes; row r lies on the arc from edge0[r] to edge1[r]
+#pragma omp parallel for schedule(dynamic)
+	for (int r = 2; r < nRefineLevel; r++) {
+		const Node & node0 = vecNodes[edge0[r]];
+		const Node & node1 = vecNodes[edge1[r]];
 
-	int ixEndNode;
+		for (int p = 1; p < r; p++) {
+			double alpha = static_cast<double>(p) / static_cast<double>(r);
 
-	int ixInt;
+			vecNodes[ixNodeBegin + (r-1) * (r-2) / 2 + (p-1)] =
+				CalculateSubNode(node0, node1, alpha);
+		}
+	}
 
-	// MultiEdges
-	MultiEdge edgeBot;
-	MultiEdge edgeMid;
-	MultiEdge edgeTop;
+	// Index of node p of row r of the triangle
+	struct TriangleIndex {
+		int nRefineLevel;
+		int ixNodeBegin;
+		const MultiEdge * pEdge[3];
+
+		int operator()(int r, int p) const {
+			if (r == nRefineLevel) {
+				return (*pEdge[2])[p];
+			} else if (p == 0) {
+				return (*pEdge[0])[r];
+			} else if (p == r) {
+				return (*pEdge[1])[r];
+			}
+			return ixNodeBegin + (r-1) * (r-2) / 2 + (p-1);
+		}
+	} ixTri;
 
-	// Initial bottom edge
-	edgeBot.push_back(edge0[0]);
+	ixTri.nRefineLevel = nRefineLevel;
+	ixTri.ixNodeBegin = ixNodeBegin;
+	ixTri.pEdge[0] = &edge0;
+	ixTri.pEdge[1] = &edge1;
+	ixTri.pEdge[2] = &edge2;
 
-	// Loop over all refined faces
-	for (j = 0; j < nRefineLevel; j++) {
+	// Generate faces; row j contains 2j+1 faces beginning at face j^2
+#pragma omp parallel for schedule(dynamic)
+	for (int j = 0; j < nRefineLevel; j++) {
+		for (int i = 0; i < 2*j+1; i++) {
+			Face & face = vecFaces[ixFaceBegin + j * j + i];
 
-		// Generate top level vertices
-		if (j == nRefineLevel-1) {
-			edgeTop = edge2;
-		} else {
-			GenerateEdgeVertices(
-				j+1, edge0[j+1], edge1[j+1], vecNodes, edgeTop);
-		}
+			face.edges.resize(3);
 
-		// Generate faces
-		for (i = 0; i < 2*j+1; i++) {
 			// Downward pointing faces
 			if (i % 2 == 0) {
 				int ix = i/2;
 
-				Face face(3);
-				face.SetNode(0, edgeBot[ix]);
-				face.SetNode(1, edgeTop[ix]);
-				face.SetNode(2, edgeTop[ix+1]);
-
-				vecFaces.push_back(face);
+				face.SetNode(0, ixTri(j, ix));
+				face.SetNode(1, ixTri(j+1, ix));
+				face.SetNode(2, ixTri(j+1, ix+1));
 
 			// Upward pointing faces
 			} else {
 				int ix = (i-1)/2;
 
-				Face face(3);
-				face.SetNode(0, edgeTop[ix+1]);
-				face.SetNode(1, edgeBot[ix+1]);
-				face.SetNode(2, edgeBot[ix]);
-
-				vecFaces.push_back(face);
+				face.SetNode(0, ixTri(j+1, ix+1));
+				face.SetNode(1, ixTri(j, ix+1));
+				face.SetNode(2, ixTri(j, ix));
 			}
 		}
-
-		// New bottom edge
-		edgeBot = edgeTop;
 	}
 }
 
@@ -253,44 +245,47 @@ void GenerateIcosahedralQuadGrid(
 	vecLonLatNodes.push_back(LonLatNode(2.0*M_PI*0.9, +NodeLat));
 	vecLonLatNodes.push_back(LonLatNode(0.0,          +0.5*M_PI));
 
+	// Number of nodes and faces; nodes are stored as the 12 icosahedral
+	// nodes, then the interior nodes of the 30 edges and then the
+	// interior nodes of the 20 base triangles, so that all shared nodes
+	// are indexed analytically
+	const int nEdgeInterior = nRefineLevel - 1;
+	const int nTriangleInterior = (nRefineLevel - 1) * (nRefineLevel - 2) / 2;
+
+	const int ixEdgeNodeBegin = 12;
+	const int ixTriangleNodeBegin = ixEdgeNodeBegin + 30 * nEdgeInterior;
+
 	// Convert icosahedral nodes to Cartesian geometry
 	ConvertFromLonLatToCartesian(vecLonLatNodes, vecNodes);
 
+	vecNodes.resize(ixTriangleNodeBegin + 20 * nTriangleInterior);
+	vecFaces.resize(20 * nRefineLevel * nRefineLevel);
+
 	// Vector of edges
+	static const int EdgeNodes[30][2] = {
+		{0, 1}, {0, 2}, {0, 3}, {0, 4}, {0, 5},
+		{1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 1},
+		{1, 6}, {6, 2}, {2, 7}, {7, 3}, {3, 8},
+		{8, 4}, {4, 9}, {9, 5}, {5, 10}, {10, 1},
+		{6, 7}, {7, 8}, {8, 9}, {9, 10}, {10, 6},
+		{6, 11}, {7, 11}, {8, 11}, {9, 11}, {10, 11}};
+
 	MultiEdgeVector vecEdges;
 	vecEdges.resize(30);
 
 	// Generate vertices along edges
-	for (int i = 0; i < 5; i++) {
+	for (int e = 0; e < 30; e++) {
 		GenerateEdgeVertices(
-			nRefineLevel, 0, i+1, vecNodes, vecEdges[i]);
-	}
-
-	for (int i = 0; i < 5; i++) {
-		GenerateEdgeVertices(
-			nRefineLevel, i+1, ((i+1)%5)+1, vecNodes, vecEdges[i+5]);
-	}
-
-	GenerateEdgeVertices(nRefineLevel, 1, 6, vecNodes, vecEdges[10]);
-	GenerateEdgeVertices(nRefineLevel, 6, 2, vecNodes, vecEdges[11]);
-	GenerateEdgeVertices(nRefineLevel, 2, 7, vecNodes, vecEdges[12]);
-	GenerateEdgeVertices(nRefineLevel, 7, 3, vecNodes, vecEdges[13]);
-	GenerateEdgeVertices(nRefineLevel, 3, 8, vecNodes, vecEdges[14]);
-	GenerateEdgeVertices(nRefineLevel, 8, 4, vecNodes, vecEdges[15]);
-	GenerateEdgeVertices(nRefineLevel, 4, 9, vecNodes, vecEdges[16]);
-	GenerateEdgeVertices(nRefineLevel, 9, 5, vecNodes, vecEdges[17]);
-	GenerateEdgeVertices(nRefineLevel, 5, 10, vecNodes, vecEdges[18]);
-	GenerateEdgeVertices(nRefineLevel, 10, 1, vecNodes, vecEdges[19]);
-
-	for (int i = 0; i < 5; i++) {
-		GenerateEdgeVertices(
-			nRefineLevel, i+6, ((i+1)%5)+6, vecNodes, vecEdges[i+20]);
+			nRefineLevel,
+			EdgeNodes[e][0],
+			EdgeNodes[e][1],
+			ixEdgeNodeBegin + e * nEdgeInterior,
+			vecNodes,
+			vecEdges[e]);
 	}
 
-	for (int i = 0; i < 5; i++) {
-		GenerateEdgeVertices(
-			nRefineLevel, i+6, 11, vecNodes, vecEdges[i+25]);
-	}
+	// Base triangles in order of storage
+	int ixTriangle = 0;
 
 	// Generate south polar faces
 	for (int i = 0; i < 5; i++) {
@@ -299,9 +294,12 @@ void GenerateIcosahedralQuadGrid(
 			vecEdges[i],
 			vecEdges[(i+1)%5],
 			vecEdges[i+5],
+			ixTriangleNodeBegin + ixTriangle * nTriangleInterior,
+			ixTriangle * nRefineLevel * nRefineLevel,
 			vecNodes,
 			vecFaces
 		);
+		ixTriangle++;
 	}
 
 	// Generate south equatorial faces
@@ -311,9 +309,12 @@ void GenerateIcosahedralQuadGrid(
 			vecEdges[2*i+10],
 			vecEdges[i+5],
 			vecEdges[2*i+11],
+			ixTriangleNodeBegin + ixTriangle * nTriangleInterior,
+			ixTriangle * nRefineLevel * nRefineLevel,
 			vecNodes,
 			vecFaces
 		);
+		ixTriangle++;
 	}
 
 	// Generate north equatorial faces
@@ -323,9 +324,12 @@ void GenerateIcosahedralQuadGrid(
 			vecEdges[i+20],
 			vecEdges[2*i+11],
 			vecEdges[2*((i+1)%5)+10].Flip(),
+			ixTriangleNodeBegin + ixTriangle * nTriangleInterior,
+			ixTriangle * nRefineLevel * nRefineLevel,
 			vecNodes,
 			vecFaces
 		);
+		ixTriangle++;
 	}
 
 	// Generate north polar faces
@@ -335,9 +339,12 @@ void GenerateIcosahedralQuadGrid(
 			vecEdges[i+25],
 			vecEdges[i+20],
 			vecEdges[((i+1)%5)+25].Flip(),
+			ixTriangleNodeBegin + ixTriangle * nTriangleInterior,
+			ixTriangle * nRefineLevel * nRefineLevel,
 			vecNodes,
 			vecFaces
 		);
+		ixTriangle++;
 	}
 }
 
@@ -355,11 +362,18 @@ void Dual(
 	NodeVector nodesOld = mesh.nodes;
 	FaceVector facesOld = mesh.faces;
 
+	int nFacesOld = static_cast<int>(facesOld.size());
+	int nNodesOld = static_cast<int>(nodesOld.size());
+
 	mesh.nodes.clear();
 	mesh.faces.clear();
 
+	mesh.nodes.resize(nFacesOld);
+	mesh.faces.resize(nNodesOld);
+
 	// Generate new Node array
-	for (int i = 0; i < facesOld.size(); i++) {
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nFacesOld; i++) {
 		Node node;
 		for (int j = 0; j < facesOld[i].edges.size(); j++) {
 			node.x += nodesOld[facesOld[i][j]].x;
@@ -377,21 +391,19 @@ void Dual(
 		node.y /= dMag;
 		node.z /= dMag;
 
-		mesh.nodes.push_back(node);
+		mesh.nodes[i] = node;
 	}
 
 	// Generate new Face array
-	for (int i = 0; i < nodesOld.size(); i++) {
-		const int nEdges = mesh.revnodearray[i].size();
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nNodesOld; i++) {
+		const int nEdges = mesh.revnodearray.GetFaceCount(i);
 
 		Face face(EdgeCountHexagon);
 		Face faceTemp(EdgeCountHexagon);
 
-		int ixNode = 0;
-		std::set<int>::const_iterator iter = mesh.revnodearray[i].begin();
-		for (; iter != mesh.revnodearray[i].end(); iter++) {
-			faceTemp.SetNode(ixNode, *iter);
-			ixNode++;
+		for (int ixNode = 0; ixNode < nEdges; ixNode++) {
+			faceTemp.SetNode(ixNode, mesh.revnodearray.GetFace(i, ixNode));
 		}
 
 		// Reorient Faces
@@ -451,7 +463,7 @@ void Dual(
 			face.SetNode(j, face[nEdges-1]);
 		}
 
-		mesh.faces.push_back(face);
+		mesh.faces[i] = face;
 	}
 }
 
@@ -20,13 +20,80 @@
 #include "Exception.h"
 #include "GridElements.h"
 #include "OverlapMesh.h"
+#include "ContentCache.h"
+
+#include "netcdfcpp.h"
 
 #include <cmath>
 
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Name of the global attribute of the overlap mesh which records the
+///		ContentHash of mesh B, so that the overlap mesh is only reused with
+///		prev_ov for the same mesh B.
+///	</summary>
+static const char * MeshBHashAttribute = "mesh_b_hash";
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Record the ContentHash of mesh B in the overlap mesh file.
+///	</summary>
+static void WriteMeshBHash(
+	const std::string & strOverlapMesh,
+	const ContentHash & hashMeshB
+) {
+	NcFile ncOverlap(strOverlapMesh.c_str(), NcFile::Write);
+	if (!ncOverlap.is_valid()) {
+		_EXCEPTION1("Unable to open overlap mesh \"%s\"",
+			strOverlapMesh.c_str());
+	}
+
+	ncOverlap.add_att(MeshBHashAttribute, hashMeshB.GetHex().c_str());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Read the ContentHash of mesh B recorded in an overlap mesh file, or
+///		an empty string if none is recorded.
+///	</summary>
+static std::string ReadMeshBHash(
+	const std::string & strOverlapMesh
+) {
+	NcError error(NcError::silent_nonfatal);
+
+	NcFile ncOverlap(strOverlapMesh.c_str(), NcFile::ReadOnly);
+	if (!ncOverlap.is_valid()) {
+		_EXCEPTION1("Unable to open overlap mesh \"%s\"",
+			strOverlapMesh.c_str());
+	}
+
+	NcAtt * attHash = ncOverlap.get_att(MeshBHashAttribute);
+	if (attHash == NULL) {
+		return std::string("");
+	}
+
+	char * szHash = attHash->as_string(0);
+	std::string strHash(szHash);
+	delete[] szHash;
+
+	return strHash;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char** argv) {
 
+#ifdef USE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+
 try {
 
 	// Input mesh A
@@ -41,22 +108,70 @@ try {
 	// Overlap grid generation method
 	std::string strMethod;
 
+	// Traversal order of the Faces of mesh A
+	std::string strTraversal;
+
 	// No validation of the meshes
 	bool fNoValidate;
 
+	// Number of Faces of mesh A per block written to the output (0 to
+	// construct the complete overlap mesh in memory)
+	int nBlockFaces;
+
+	// Previous version of mesh A
+	std::string strPreviousMeshA;
+
+	// Previous overlap mesh of the previous mesh A and mesh B
+	std::string strPreviousOverlapMesh;
+
+	// Write NetCDF-4 output with chunked variables
+	bool fNetCDF4;
+
+	// Deflate level of NetCDF-4 output
+	int nDeflateLevel;
+
+	// Apply the shuffle filter to NetCDF-4 output
+	bool fShuffle;
+
+	// Read meshes through a binary cache next to each mesh file
+	bool fMeshCache;
+
+	// Directory of cached overlap meshes
+	std::string strCacheDir;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strMeshA, "a", "");
 		CommandLineString(strMeshB, "b", "");
 		CommandLineString(strOverlapMesh, "out", "overlap.g");
 		CommandLineStringD(strMethod, "method", "fuzzy", "(fuzzy|exact|mixed)");
+		CommandLineStringD(strTraversal, "traversal", "index", "(index|sfc)");
 		CommandLineBool(fNoValidate, "novalidate");
+		CommandLineIntD(nBlockFaces, "block", 0, "(faces of mesh A per output block)");
+		CommandLineString(strPreviousMeshA, "prev_a", "");
+		CommandLineString(strPreviousOverlapMesh, "prev_ov", "");
+		CommandLineBool(fNetCDF4, "netcdf4");
+		CommandLineInt(nDeflateLevel, "deflate", 0);
+		CommandLineBool(fShuffle, "shuffle");
+		CommandLineBool(fMeshCache, "mesh_cache");
+		CommandLineString(strCacheDir, "cache_dir", "");
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
 
 	AnnounceBanner();
 
+	// Format of NetCDF output files
+	NetCDFOutputOptions optNetCDF(fNetCDF4, nDeflateLevel, fShuffle);
+
+	// Check command line parameters
+	if ((strPreviousMeshA == "") != (strPreviousOverlapMesh == "")) {
+		_EXCEPTIONT("prev_a and prev_ov must be specified together");
+	}
+	if ((strPreviousMeshA != "") && (nBlockFaces > 0)) {
+		_EXCEPTIONT("block cannot be used with prev_a and prev_ov");
+	}
+
 	// Method string
 	OverlapMeshMethod method;
 	STLStringHelper::ToLower(strMethod);
@@ -70,9 +185,20 @@ try {
 		_EXCEPTIONT("Invalid \"method\" value");
 	}
 
+	// Traversal string
+	OverlapMeshTraversal traversal;
+	STLStringHelper::ToLower(strTraversal);
+	if (strTraversal == "index") {
+		traversal = OverlapMeshTraversal_Index;
+	} else if (strTraversal == "sfc") {
+		traversal = OverlapMeshTraversal_SpaceFillingCurve;
+	} else {
+		_EXCEPTIONT("Invalid \"traversal\" value");
+	}
+
 	// Load input mesh
 	AnnounceStartBlock("Loading mesh A");
-	Mesh meshA(strMeshA);
+	Mesh meshA(strMeshA, fMeshCache);
 	meshA.RemoveZeroEdges();
 	AnnounceEndBlock(NULL);
 
@@ -85,7 +211,7 @@ try {
 
 	// Load output mesh
 	AnnounceStartBlock("Loading mesh B");
-	Mesh meshB(strMeshB);
+	Mesh meshB(strMeshB, fMeshCache);
 	meshB.RemoveZeroEdges();
 	AnnounceEndBlock(NULL);
 
@@ -96,46 +222,186 @@ try {
 		AnnounceEndBlock(NULL);
 	}
 
-	// Construct the edge map on both meshes
-	AnnounceStartBlock("Constructing edge map on mesh A");
-	meshA.ConstructEdgeMap();
-	AnnounceEndBlock(NULL);
+	// Hash of mesh B before its Nodes are equalized with mesh A, which is
+	// recorded in the overlap mesh
+	ContentHash hashMeshB;
+	hashMeshB.Add(meshB);
 
-	AnnounceStartBlock("Constructing edge map on mesh B");
-	meshB.ConstructEdgeMap();
-	AnnounceEndBlock(NULL);
+	// The previous overlap mesh may only be reused if it was generated
+	// with the same mesh B
+	bool fReusePrevious = (strPreviousMeshA != "");
+	if (fReusePrevious) {
+		std::string strPreviousHash = ReadMeshBHash(strPreviousOverlapMesh);
 
-	// Construct the reverse node array on both meshes
-	AnnounceStartBlock("Constructing reverse node array on input mesh");
-	meshA.ConstructReverseNodeArray();
-	AnnounceEndBlock(NULL);
+		if (strPreviousHash == "") {
+			Announce("WARNING: Previous overlap mesh does not record "
+				"mesh B;\n  generating the complete overlap mesh");
+			fReusePrevious = false;
 
-	AnnounceStartBlock("Constructing reverse node array on output mesh");
-	meshB.ConstructReverseNodeArray();
-	AnnounceEndBlock(NULL);
+		} else if (strPreviousHash != hashMeshB.GetHex()) {
+			_EXCEPTIONT("Previous overlap mesh was generated with "
+				"a different mesh B");
+		}
+	}
 
-	// Equalize nearly coincident nodes on these Meshes
-	AnnounceStartBlock("Equalize coicident Nodes");
-	EqualizeCoincidentNodes(meshA, meshB);
-	AnnounceEndBlock(NULL);
+	// Rank of this processor; the overlap mesh is generated on all ranks
+	// and written by the root rank
+	int nRank = 0;
 
-	// Construct the overlap mesh
-	Mesh meshOverlap;
+#ifdef USE_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+#endif
 
-	AnnounceStartBlock("Construct overlap mesh");
-	GenerateOverlapMesh(meshA, meshB, meshOverlap, method);
-	AnnounceEndBlock(NULL);
+	// Cache entry of the overlap mesh, keyed by the contents of both
+	// meshes and the options that affect the overlap mesh
+	ContentCache cache(strCacheDir);
 
-	// Write the overlap mesh
-	AnnounceStartBlock("Writing overlap mesh");
-	meshOverlap.Write(strOverlapMesh.c_str());
-	AnnounceEndBlock(NULL);
+	std::string strCacheEntry;
+	if (cache.IsEnabled()) {
+		ContentHash hash;
+		hash.Add(std::string("overlap"));
+		hash.Add(meshA);
+		hash.Add(meshB);
+		hash.Add(static_cast<int>(method));
+		hash.Add(static_cast<int>(traversal));
+
+		strCacheEntry = cache.GetEntryPath("overlap", hash, ".g");
+	}
+
+	// Reuse the cached overlap mesh
+	if (cache.HasEntry(strCacheEntry)) {
+		if (nRank == 0) {
+			AnnounceStartBlock("Writing overlap mesh from cache");
+			Announce("Cache entry \"%s\"", strCacheEntry.c_str());
+
+			// A block-streamed overlap mesh is not loaded into memory
+			if (nBlockFaces > 0) {
+				cache.Retrieve(strCacheEntry, strOverlapMesh);
+			} else {
+				Mesh meshOverlap(strCacheEntry);
+				meshOverlap.Write(strOverlapMesh.c_str(), optNetCDF);
+			}
+			WriteMeshBHash(strOverlapMesh, hashMeshB);
+			AnnounceEndBlock(NULL);
+		}
+
+	} else {
+		// Construct the edge map on both meshes
+		AnnounceStartBlock("Constructing edge map on mesh A");
+		meshA.ConstructEdgeMap();
+		AnnounceEndBlock(NULL);
+
+		AnnounceStartBlock("Constructing edge map on mesh B");
+		meshB.ConstructEdgeMap();
+		AnnounceEndBlock(NULL);
+
+		// Construct the reverse node array on both meshes
+		AnnounceStartBlock("Constructing reverse node array on input mesh");
+		meshA.ConstructReverseNodeArray();
+		AnnounceEndBlock(NULL);
+
+		AnnounceStartBlock("Constructing reverse node array on output mesh");
+		meshB.ConstructReverseNodeArray();
+		AnnounceEndBlock(NULL);
+
+		// Equalize nearly coincident nodes on these Meshes
+		AnnounceStartBlock("Equalize coicident Nodes");
+		EqualizeCoincidentNodes(meshA, meshB);
+		AnnounceEndBlock(NULL);
+
+		// Construct the face tree on mesh B for locating seed faces
+		AnnounceStartBlock("Constructing face tree on output mesh");
+		meshB.ConstructFaceTree();
+		AnnounceEndBlock(NULL);
+
+		// Construct the overlap mesh and stream it to the output in blocks
+		if (nBlockFaces > 0) {
+			MeshStreamWriter writer(strOverlapMesh, optNetCDF);
+
+			AnnounceStartBlock("Construct overlap mesh in blocks");
+			GenerateOverlapMesh(
+				meshA, meshB, writer, nBlockFaces, method, traversal);
+			AnnounceEndBlock(NULL);
+
+			if (nRank == 0) {
+				AnnounceStartBlock("Writing overlap mesh");
+				writer.Close();
+				WriteMeshBHash(strOverlapMesh, hashMeshB);
+				AnnounceEndBlock(NULL);
+			}
+
+		// Construct the overlap mesh in memory
+		} else {
+			Mesh meshOverlap;
+
+			// Reuse the overlap of Faces unchanged from the previous mesh A
+			if (fReusePrevious) {
+				AnnounceStartBlock("Loading previous mesh A");
+				Mesh meshPreviousA(strPreviousMeshA, fMeshCache);
+				meshPreviousA.RemoveZeroEdges();
+				AnnounceEndBlock(NULL);
+
+				AnnounceStartBlock("Loading previous overlap mesh");
+				Mesh meshPreviousOverlap(strPreviousOverlapMesh, fMeshCache);
+				meshPreviousOverlap.RemoveZeroEdges();
+				AnnounceEndBlock(NULL);
+
+				// Verify the previous overlap mesh only refers to Faces
+				// of mesh B
+				int ixSecondFaceMax = (-1);
+				for (int i = 0; i < meshPreviousOverlap.vecSecondFaceIx.size(); i++) {
+					if (meshPreviousOverlap.vecSecondFaceIx[i] > ixSecondFaceMax) {
+						ixSecondFaceMax = meshPreviousOverlap.vecSecondFaceIx[i];
+					}
+				}
+				if (ixSecondFaceMax >= static_cast<int>(meshB.faces.size())) {
+					_EXCEPTION2("Previous overlap mesh refers to Face %i "
+						"of mesh B, which has %i Faces",
+						ixSecondFaceMax,
+						static_cast<int>(meshB.faces.size()));
+				}
+
+				AnnounceStartBlock("Regenerate overlap mesh");
+				RegenerateOverlapMesh(
+					meshPreviousA,
+					meshPreviousOverlap,
+					meshA,
+					meshB,
+					meshOverlap,
+					method,
+					traversal);
+				AnnounceEndBlock(NULL);
+
+			} else {
+				AnnounceStartBlock("Construct overlap mesh");
+				GenerateOverlapMesh(meshA, meshB, meshOverlap, method, traversal);
+				AnnounceEndBlock(NULL);
+			}
+
+			// Write the overlap mesh
+			if (nRank == 0) {
+				AnnounceStartBlock("Writing overlap mesh");
+				meshOverlap.Write(strOverlapMesh.c_str(), optNetCDF);
+				WriteMeshBHash(strOverlapMesh, hashMeshB);
+				AnnounceEndBlock(NULL);
+			}
+		}
+
+		// Store the overlap mesh in the cache
+		if (cache.IsEnabled() && (nRank == 0)) {
+			cache.Store(strOverlapMesh, strCacheEntry);
+		}
+	}
 
 	AnnounceBanner();
 
 } catch(Exception & e) {
 	Announce(e.ToString().c_str());
 }
+
+#ifdef USE_MPI
+	MPI_Finalize();
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -17,15 +17,16 @@
 #include "CommandLine.h"
 #include "GridElements.h"
 #include "FiniteElementTools.h"
-#include "TriangularQuadrature.h"
+#include "FaceQuadratureTable.h"
 #include "GaussLobattoQuadrature.h"
 #include "Exception.h"
 #include "Announce.h"
-#include "DataMatrix3D.h"
+#include "GLLElementData.h"
 
 #include "netcdfcpp.h"
 
 #include <cmath>
+#include <cstdlib>
 #include <iostream>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -49,6 +50,20 @@ public:
 		double dLon,
 		double dLat
 	) = 0;
+
+	///	<summary>
+	///		Evaluate the test function at nPoints points.
+	///	</summary>
+	virtual void Evaluate(
+		int nPoints,
+		const double * dLon,
+		const double * dLat,
+		double * dValue
+	) {
+		for (int i = 0; i < nPoints; i++) {
+			dValue[i] = (*this)(dLon[i], dLat[i]);
+		}
+	}
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -59,6 +74,16 @@ public:
 class TestFunctionY2b2 : public TestFunction {
 
 public:
+	///	<summary>
+	///		Value of the test function.
+	///	</summary>
+	static double Value(
+		double dLon,
+		double dLat
+	) {
+		return (2.0 + cos(dLat) * cos(dLat) * cos(2.0 * dLon));
+	}
+
 	///	<summary>
 	///		Evaluate the test function.
 	///	<summary>
@@ -66,7 +91,21 @@ public:
 		double dLon,
 		double dLat
 	) {
-		return (2.0 + cos(dLat) * cos(dLat) * cos(2.0 * dLon));
+		return Value(dLon, dLat);
+	}
+
+	///	<summary>
+	///		Evaluate the test function at nPoints points.
+	///	</summary>
+	virtual void Evaluate(
+		int nPoints,
+		const double * dLon,
+		const double * dLat,
+		double * dValue
+	) {
+		for (int i = 0; i < nPoints; i++) {
+			dValue[i] = Value(dLon[i], dLat[i]);
+		}
 	}
 };
 
@@ -78,6 +117,16 @@ public:
 class TestFunctionY16b32 : public TestFunction {
 
 public:
+	///	<summary>
+	///		Value of the test function.
+	///	</summary>
+	static double Value(
+		double dLon,
+		double dLat
+	) {
+		return (2.0 + pow(sin(2.0 * dLat), 16.0) * cos(16.0 * dLon));
+	}
+
 	///	<summary>
 	///		Evaluate the test function.
 	///	</summary>
@@ -85,7 +134,21 @@ public:
 		double dLon,
 		double dLat
 	) {
-		return (2.0 + pow(sin(2.0 * dLat), 16.0) * cos(16.0 * dLon));
+		return Value(dLon, dLat);
+	}
+
+	///	<summary>
+	///		Evaluate the test function at nPoints points.
+	///	</summary>
+	virtual void Evaluate(
+		int nPoints,
+		const double * dLon,
+		const double * dLat,
+		double * dValue
+	) {
+		for (int i = 0; i < nPoints; i++) {
+			dValue[i] = Value(dLon[i], dLat[i]);
+		}
 	}
 };
 
@@ -99,16 +162,16 @@ class TestFunctionVortex : public TestFunction {
 public:
 	///	<summary>
 	///		Find the rotated longitude and latitude of a point on a sphere
-	///		with pole at (dLonC, dLatC).
+	///		with pole at (dLonC, dLatC), where dSinC and dCosC are the sine
+	///		and cosine of dLatC.
 	///	</summary>
-	void RotatedSphereCoord(
+	static void RotatedSphereCoord(
 		double dLonC,
-		double dLatC,
+		double dSinC,
+		double dCosC,
 		double & dLonT,
 		double & dLatT
 	) {
-		double dSinC = sin(dLatC);
-		double dCosC = cos(dLatC);
 		double dCosT = cos(dLatT);
 		double dSinT = sin(dLatT);
 		
@@ -125,19 +188,21 @@ public:
 	}
 
 	///	<summary>
-	///		Evaluate the test function.
+	///		Value of the test function, where dSinC and dCosC are the sine
+	///		and cosine of the latitude of the vortex center.
 	///	</summary>
-	virtual double operator()(
+	static double Value(
 		double dLon,
-		double dLat
+		double dLat,
+		double dSinC,
+		double dCosC
 	) {
 		const double dLon0 = 0.0;
-		const double dLat0 = 0.6;
 		const double dR0 = 3.0;
 		const double dD = 5.0;
 		const double dT = 6.0;
 
-		RotatedSphereCoord(dLon0, dLat0, dLon, dLat);
+		RotatedSphereCoord(dLon0, dSinC, dCosC, dLon, dLat);
 
 		double dRho = dR0 * cos(dLat);
 		double dVt = 3.0 * sqrt(3.0) / 2.0
@@ -152,8 +217,112 @@ public:
 
 		return (1.0 - tanh(dRho / dD * sin(dLon - dOmega * dT)));
 	}
+
+	///	<summary>
+	///		Evaluate the test function.
+	///	</summary>
+	virtual double operator()(
+		double dLon,
+		double dLat
+	) {
+		return Value(dLon, dLat, sin(LatC), cos(LatC));
+	}
+
+	///	<summary>
+	///		Evaluate the test function at nPoints points.
+	///	</summary>
+	virtual void Evaluate(
+		int nPoints,
+		const double * dLon,
+		const double * dLat,
+		double * dValue
+	) {
+		const double dSinC = sin(LatC);
+		const double dCosC = cos(LatC);
+
+		for (int i = 0; i < nPoints; i++) {
+			dValue[i] = Value(dLon[i], dLat[i], dSinC, dCosC);
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Latitude of the vortex center.
+	///	</summary>
+	static const double LatC;
 };
 
+const double TestFunctionVortex::LatC = 0.6;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Parse a list of comma or space separated strings.
+///	</summary>
+void ParseVariableList(
+	const std::string & strVariables,
+	std::vector< std::string > & vecVariableStrings
+) {
+	int iVarBegin = 0;
+	int iVarCurrent = 0;
+
+	// Parse variable name
+	for (;;) {
+		if ((iVarCurrent >= strVariables.length()) ||
+			(strVariables[iVarCurrent] == ',') ||
+			(strVariables[iVarCurrent] == ' ')
+		) {
+			if (iVarCurrent != iVarBegin) {
+				vecVariableStrings.push_back(
+					strVariables.substr(iVarBegin, iVarCurrent - iVarBegin));
+			}
+
+			if (iVarCurrent >= strVariables.length()) {
+				break;
+			}
+
+			iVarBegin = iVarCurrent + 1;
+		}
+
+		iVarCurrent++;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Evaluate a test function at all sample points, in parallel over
+///		blocks of points.
+///	</summary>
+void EvaluateTestFunction(
+	TestFunction & test,
+	const DataVector<double> & dLon,
+	const DataVector<double> & dLat,
+	DataVector<double> & dSample
+) {
+	const int BlockSize = 1024;
+
+	int nPoints = static_cast<int>(dLon.GetRows());
+	int nBlocks = (nPoints + BlockSize - 1) / BlockSize;
+
+	dSample.Initialize(nPoints);
+
+#pragma omp parallel for schedule(static)
+	for (int b = 0; b < nBlocks; b++) {
+		int ixBegin = b * BlockSize;
+		int nBlockPoints = nPoints - ixBegin;
+		if (nBlockPoints > BlockSize) {
+			nBlockPoints = BlockSize;
+		}
+
+		test.Evaluate(
+			nBlockPoints,
+			&(dLon[ixBegin]),
+			&(dLat[ixBegin]),
+			&(dSample[ixBegin]));
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char** argv) {
@@ -162,7 +331,7 @@ try {
 	std::string strMeshFile;
 
 	// Test data to use
-	int iTestData;
+	std::string strTestData;
 
 	// Output on GLL grid
 	bool fGLL;
@@ -173,21 +342,21 @@ try {
 	// Include a level dimension in output
 	bool fHOMMEFormat;
 
-	// Output variable name
-	std::string strVariableName;
+	// Output variable names
+	std::string strVariableNames;
 
 	// Output filename
-	std::string strTestData;
+	std::string strOutputFile;
 
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strMeshFile, "mesh", "");
-		CommandLineInt(iTestData, "test", 1);
+		CommandLineString(strTestData, "test", "1");
 		CommandLineBool(fGLL, "gll");
 		CommandLineInt(nP, "np", 4);
 		CommandLineBool(fHOMMEFormat, "homme");
-		CommandLineString(strVariableName, "var", "Psi");
-		CommandLineString(strTestData, "out", "testdata.nc");
+		CommandLineString(strVariableNames, "var", "Psi");
+		CommandLineString(strOutputFile, "out", "testdata.nc");
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
@@ -200,23 +369,38 @@ try {
 
 	Announce("Using triangular quadrature of order %i", TriQuadratureOrder);
 
-	TriangularQuadratureRule triquadrule(TriQuadratureOrder);
+	// Test data and output variable names
+	std::vector<std::string> vecTestStrings;
+	ParseVariableList(strTestData, vecTestStrings);
 
-	const int TriQuadraturePoints = triquadrule.GetPoints();
+	std::vector<std::string> vecVariableNames;
+	ParseVariableList(strVariableNames, vecVariableNames);
 
-	const DataMatrix<double> & TriQuadratureG = triquadrule.GetG();
-	const DataVector<double> & TriQuadratureW = triquadrule.GetW();
+	if (vecTestStrings.size() == 0) {
+		_EXCEPTIONT("No test data specified (--test)");
+	}
+	if (vecVariableNames.size() != vecTestStrings.size()) {
+		_EXCEPTION2("Number of variables (%i) must equal the number of "
+			"test data (%i)",
+			static_cast<int>(vecVariableNames.size()),
+			static_cast<int>(vecTestStrings.size()));
+	}
 
-	// Test data
-	TestFunction * pTest;
-	if (iTestData == 1) {
-		pTest = new TestFunctionY2b2;
-	} else if (iTestData == 2) {
-		pTest = new TestFunctionY16b32;
-	} else if (iTestData == 3) {
-		pTest = new TestFunctionVortex;
-	} else {
-		_EXCEPTIONT("Test index out of range; expected [1,2,3]");
+	int nTests = static_cast<int>(vecTestStrings.size());
+
+	std::vector<TestFunction *> vecTests(nTests, NULL);
+	for (int t = 0; t < nTests; t++) {
+		int iTestData = atoi(vecTestStrings[t].c_str());
+
+		if (iTestData == 1) {
+			vecTests[t] = new TestFunctionY2b2;
+		} else if (iTestData == 2) {
+			vecTests[t] = new TestFunctionY16b32;
+		} else if (iTestData == 3) {
+			vecTests[t] = new TestFunctionVortex;
+		} else {
+			_EXCEPTIONT("Test index out of range; expected [1,2,3]");
+		}
 	}
 
 	// Input mesh
@@ -284,8 +468,15 @@ try {
 	DataVector<double> dLon;
 	DataVector<double> dArea;
 
-	// Output data
-	DataVector<double> dVar;
+	// Output data for each test
+	std::vector< DataVector<double> > vecVar(nTests);
+
+	// Sample points
+	DataVector<double> dSampleLon;
+	DataVector<double> dSampleLat;
+
+	// Sample values
+	DataVector<double> dSample;
 
 	// Sample as element averages
 	if (!fGLL) {
@@ -293,62 +484,73 @@ try {
 		// Calculate element areas
 		mesh.CalculateFaceAreas();
 
-		// Resize the array
-		dVar.Initialize(mesh.faces.size());
-
-		// Loop through all Faces
-		for (int i = 0; i < mesh.faces.size(); i++) {
-
-			const Face & face = mesh.faces[i];
-
-			// Loop through all sub-triangles
-			for (int j = 0; j < face.edges.size()-2; j++) {
-
-				const Node & node0 = mesh.nodes[face[0]];
-				const Node & node1 = mesh.nodes[face[j+1]];
-				const Node & node2 = mesh.nodes[face[j+2]];
-
-				// Triangle area
-				Face faceTri(3);
-				faceTri.SetNode(0, face[0]);
-				faceTri.SetNode(1, face[j+1]);
-				faceTri.SetNode(2, face[j+2]);
-
-				double dTriangleArea = CalculateFaceArea(faceTri, mesh.nodes);
-
-				// Calculate the element average
-				double dTotalSample = 0.0;
-
-				// Loop through all quadrature points
-				for (int k = 0; k < TriQuadraturePoints; k++) {
-					Node node(
-						  TriQuadratureG[k][0] * node0.x
-						+ TriQuadratureG[k][1] * node1.x
-						+ TriQuadratureG[k][2] * node2.x,
-						  TriQuadratureG[k][0] * node0.y
-						+ TriQuadratureG[k][1] * node1.y
-						+ TriQuadratureG[k][2] * node2.y,
-						  TriQuadratureG[k][0] * node0.z
-						+ TriQuadratureG[k][1] * node1.z
-						+ TriQuadratureG[k][2] * node2.z);
-
-					double dMagnitude = node.Magnitude();
-					node.x /= dMagnitude;
-					node.y /= dMagnitude;
-					node.z /= dMagnitude;
-
-					double dLon = atan2(node.y, node.x);
-					if (dLon < 0.0) {
-						dLon += 2.0 * M_PI;
-					}
-					double dLat = asin(node.z);
+		// Quadrature points of all sub-triangles
+		FaceQuadratureTable quadMesh;
+		quadMesh.Initialize(mesh, TriQuadratureOrder);
+
+		const int TriQuadraturePoints = quadMesh.GetPoints();
+
+		const DataVector<double> & TriQuadratureW = quadMesh.GetW();
 
-					double dSample = (*pTest)(dLon, dLat);
+		int nFaces = static_cast<int>(mesh.faces.size());
+		int nTotalTriangles = quadMesh.GetTriangleBegin(nFaces);
 
-					dTotalSample += dSample * TriQuadratureW[k] * dTriangleArea;
+		// Longitude and latitude of all quadrature points
+		dSampleLon.Initialize(nTotalTriangles * TriQuadraturePoints);
+		dSampleLat.Initialize(nTotalTriangles * TriQuadraturePoints);
+
+#pragma omp parallel for schedule(static)
+		for (int ixTri = 0; ixTri < nTotalTriangles; ixTri++) {
+			const double * dX = quadMesh.GetX(ixTri);
+			const double * dY = quadMesh.GetY(ixTri);
+			const double * dZ = quadMesh.GetZ(ixTri);
+
+			for (int k = 0; k < TriQuadraturePoints; k++) {
+				double dLon = atan2(dY[k], dX[k]);
+				if (dLon < 0.0) {
+					dLon += 2.0 * M_PI;
 				}
 
-				dVar[i] += dTotalSample / mesh.vecFaceArea[i];
+				dSampleLon[ixTri * TriQuadraturePoints + k] = dLon;
+				dSampleLat[ixTri * TriQuadraturePoints + k] = asin(dZ[k]);
+			}
+		}
+
+		for (int t = 0; t < nTests; t++) {
+			EvaluateTestFunction(
+				*(vecTests[t]), dSampleLon, dSampleLat, dSample);
+
+			DataVector<double> & dVar = vecVar[t];
+
+			// Resize the array
+			dVar.Initialize(nFaces);
+
+			// Loop through all Faces
+#pragma omp parallel for schedule(static)
+			for (int i = 0; i < nFaces; i++) {
+
+				// Loop through all sub-triangles
+				int ixTriBegin = quadMesh.GetTriangleBegin(i);
+				int ixTriEnd = ixTriBegin + quadMesh.GetTriangleCount(i);
+
+				for (int ixTri = ixTriBegin; ixTri < ixTriEnd; ixTri++) {
+
+					double dTriangleArea = quadMesh.GetTriangleArea(ixTri);
+
+					const double * dTriSample =
+						&(dSample[ixTri * TriQuadraturePoints]);
+
+					// Calculate the element average
+					double dTotalSample = 0.0;
+
+					// Loop through all quadrature points
+					for (int k = 0; k < TriQuadraturePoints; k++) {
+						dTotalSample +=
+							dTriSample[k] * TriQuadratureW[k] * dTriangleArea;
+					}
+
+					dVar[i] += dTotalSample / mesh.vecFaceArea[i];
+				}
 			}
 		}
 
@@ -356,8 +558,8 @@ try {
 	} else {
 
 		// Generate grid metadata
-		DataMatrix3D<int> dataGLLNodes;
-		DataMatrix3D<double> dataGLLJacobian;
+		GLLElementData<int> dataGLLNodes;
+		GLLElementData<double> dataGLLJacobian;
 
 		GenerateMetaData(mesh, nP, false, dataGLLNodes, dataGLLJacobian);
 
@@ -376,15 +578,15 @@ try {
 
 		// Number of unique nodes
 		int iMaxNode = 0;
-		for (int i = 0; i < nP; i++) {
-		for (int j = 0; j < nP; j++) {
 		for (int k = 0; k < nElements; k++) {
-			if (dataGLLNodes[i][j][k] > iMaxNode) {
-				iMaxNode = dataGLLNodes[i][j][k];
+			const int * pNodes = dataGLLNodes[k];
+
+			for (int s = 0; s < nP * nP; s++) {
+				if (pNodes[s] > iMaxNode) {
+					iMaxNode = pNodes[s];
+				}
 			}
 		}
-		}
-		}
 
 		// Resize output array
 		if (fHOMMEFormat) {
@@ -404,10 +606,12 @@ try {
 
 		GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dG, dW);
 
-		// Allocate data
-		dVar.Initialize(iMaxNode+1);
+		// Longitude and latitude of each GLL node of each element,
+		// with sample (i,j) of element k at index (k * nP + i) * nP + j
+		dSampleLon.Initialize(nElements * nP * nP);
+		dSampleLat.Initialize(nElements * nP * nP);
 
-		// Sample data
+#pragma omp parallel for schedule(static)
 		for (int k = 0; k < nElements; k++) {
 
 			const Face & face = mesh.faces[k];
@@ -434,18 +638,46 @@ try {
 				if (dNodeLon < 0.0) {
 					dNodeLon += 2.0 * M_PI;
 				}
-				double dNodeLat = asin(node.z);
 
-				double dSample = (*pTest)(dNodeLon, dNodeLat);
-
-				dVar[dataGLLNodes[j][i][k]-1] = dSample;
+				dSampleLon[(k * nP + i) * nP + j] = dNodeLon;
+				dSampleLat[(k * nP + i) * nP + j] = asin(node.z);
+			}
+			}
+		}
 
-				if (fHOMMEFormat) {
-					dLat[dataGLLNodes[j][i][k]-1] = dNodeLat * 180.0 / M_PI;
-					dLon[dataGLLNodes[j][i][k]-1] = dNodeLon * 180.0 / M_PI;
-					dArea[dataGLLNodes[j][i][k]-1] += dataGLLJacobian[j][i][k];
+		// Coordinates and areas of the unique nodes
+		if (fHOMMEFormat) {
+			for (int k = 0; k < nElements; k++) {
+				for (int i = 0; i < nP; i++) {
+				for (int j = 0; j < nP; j++) {
+					int ixNode = dataGLLNodes[k][j * nP + i] - 1;
+					int ixSample = (k * nP + i) * nP + j;
+
+					dLat[ixNode] = dSampleLat[ixSample] * 180.0 / M_PI;
+					dLon[ixNode] = dSampleLon[ixSample] * 180.0 / M_PI;
+					dArea[ixNode] += dataGLLJacobian[k][j * nP + i];
+				}
 				}
 			}
+		}
+
+		// Sample data, where the last sample of each unique node is kept
+		for (int t = 0; t < nTests; t++) {
+			EvaluateTestFunction(
+				*(vecTests[t]), dSampleLon, dSampleLat, dSample);
+
+			DataVector<double> & dVar = vecVar[t];
+
+			// Allocate data
+			dVar.Initialize(iMaxNode+1);
+
+			for (int k = 0; k < nElements; k++) {
+				for (int i = 0; i < nP; i++) {
+				for (int j = 0; j < nP; j++) {
+					dVar[dataGLLNodes[k][j * nP + i]-1] =
+						dSample[(k * nP + i) * nP + j];
+				}
+				}
 			}
 		}
 	}
@@ -455,7 +687,7 @@ try {
 	// Output file
 	AnnounceStartBlock("Writing results");
 
-	NcFile ncOut(strTestData.c_str(), NcFile::Replace);
+	NcFile ncOut(strOutputFile.c_str(), NcFile::Replace);
 
 	// Add dimensions
 	std::vector<NcDim *> vecDimOut;
@@ -477,21 +709,28 @@ try {
 		varArea->put(&(dArea[0]), vecOutputDimSizes[1]);
 	}
 
-	// Add variable
-	NcVar * varOut =
-		ncOut.add_var(
-			strVariableName.c_str(),
-			ncDouble,
-			static_cast<int>(vecOutputDimSizes.size()),
-			(const NcDim**)&(vecDimOut[0]));
+	// Add variables
+	std::vector<NcVar *> vecVarOut(nTests);
+	for (int t = 0; t < nTests; t++) {
+		vecVarOut[t] =
+			ncOut.add_var(
+				vecVariableNames[t].c_str(),
+				ncDouble,
+				static_cast<int>(vecOutputDimSizes.size()),
+				(const NcDim**)&(vecDimOut[0]));
+	}
 
 	// Output data
-	varOut->put(&(dVar[0]), &(vecOutputDimSizes[0]));
+	for (int t = 0; t < nTests; t++) {
+		vecVarOut[t]->put(&(vecVar[t][0]), &(vecOutputDimSizes[0]));
+	}
 
 	AnnounceEndBlock("Done");
 
-	// Delete the test
-	delete pTest;
+	// Delete the tests
+	for (int t = 0; t < nTests; t++) {
+		delete vecTests[t];
+	}
 
 } catch(Exception & e) {
 	std::cout << e.ToString() << std::endl;
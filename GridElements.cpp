@@ -17,42 +17,1119 @@
 #include "Defines.h"
 #include "GridElements.h"
 
+#include "MeshStream.h"
 #include "DataMatrix.h"
 #include "Announce.h"
 
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
 #include <netcdfcpp.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Bytes of Node coordinates and Face connectivity read and written
+///		by Mesh::Read and Mesh::Write.
+///	</summary>
+static AnnounceCounter s_counterBytesRead("bytes read");
+static AnnounceCounter s_counterBytesWritten("bytes written");
+
+///////////////////////////////////////////////////////////////////////////////
+/// NodeSpatialHash
+///////////////////////////////////////////////////////////////////////////////
+
+const Real NodeSpatialHash::DefaultTolerance = 1.0e-8;
+
+///////////////////////////////////////////////////////////////////////////////
+
+NodeSpatialHash::NodeSpatialHash(
+	Real dTolerance
+) :
+	m_dTolerance(dTolerance),
+	m_dInvCellWidth(0.5 / dTolerance),
+	m_nEntries(0)
+{
+	if (dTolerance <= 0.0) {
+		_EXCEPTIONT("NodeSpatialHash tolerance must be positive");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void NodeSpatialHash::Clear(
+	int nNodes
+) {
+	m_nEntries = 0;
+	m_vecEntries.clear();
+
+	Reserve(nNodes);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void NodeSpatialHash::Initialize(
+	const NodeVector & nodes
+) {
+	int nNodes = static_cast<int>(nodes.size());
+
+	Clear(nNodes);
+
+	// Grid cells are computed in parallel; insertion is in order
+	std::vector<Entry> vecNewEntries(nNodes);
+
+#pragma omp parallel for
+	for (int i = 0; i < nNodes; i++) {
+		Entry & entry = vecNewEntries[i];
+
+		entry.iCell[0] = GetCell(nodes[i].x);
+		entry.iCell[1] = GetCell(nodes[i].y);
+		entry.iCell[2] = GetCell(nodes[i].z);
+		entry.ix = i;
+		entry.x = nodes[i].x;
+		entry.y = nodes[i].y;
+		entry.z = nodes[i].z;
+	}
+
+	for (int i = 0; i < nNodes; i++) {
+		InsertEntry(vecNewEntries[i]);
+	}
+
+	m_nEntries = nNodes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void NodeSpatialHash::Reserve(
+	int nNodes
+) {
+	// Keep the load factor below one half
+	size_t sCapacity = 16;
+	while (sCapacity < 2 * static_cast<size_t>(nNodes)) {
+		sCapacity *= 2;
+	}
+
+	if (sCapacity <= m_vecEntries.size()) {
+		return;
+	}
+
+	std::vector<Entry> vecOldEntries;
+	vecOldEntries.swap(m_vecEntries);
+
+	Entry entryEmpty;
+	entryEmpty.iCell[0] = 0;
+	entryEmpty.iCell[1] = 0;
+	entryEmpty.iCell[2] = 0;
+	entryEmpty.ix = InvalidNode;
+	entryEmpty.x = 0.0;
+	entryEmpty.y = 0.0;
+	entryEmpty.z = 0.0;
+
+	m_vecEntries.resize(sCapacity, entryEmpty);
+
+	for (size_t s = 0; s < vecOldEntries.size(); s++) {
+		if (vecOldEntries[s].ix != InvalidNode) {
+			InsertEntry(vecOldEntries[s]);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void NodeSpatialHash::InsertEntry(
+	const Entry & entry
+) {
+	size_t sMask = m_vecEntries.size() - 1;
+	size_t s = GetSlot(entry.iCell);
+
+	while (m_vecEntries[s].ix != InvalidNode) {
+		s = (s + 1) & sMask;
+	}
+
+	m_vecEntries[s] = entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void NodeSpatialHash::Insert(
+	const Node & node,
+	int ix
+) {
+	if (2 * static_cast<size_t>(m_nEntries + 1) > m_vecEntries.size()) {
+		Reserve(2 * (m_nEntries + 1));
+	}
+
+	Entry entry;
+	entry.iCell[0] = GetCell(node.x);
+	entry.iCell[1] = GetCell(node.y);
+	entry.iCell[2] = GetCell(node.z);
+	entry.ix = ix;
+	entry.x = node.x;
+	entry.y = node.y;
+	entry.z = node.z;
+
+	InsertEntry(entry);
+
+	m_nEntries++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int NodeSpatialHash::Find(
+	const Node & node
+) const {
+	if (m_nEntries == 0) {
+		return InvalidNode;
+	}
+
+	size_t sMask = m_vecEntries.size() - 1;
+
+	// Range of grid cells that may contain a coincident Node
+	int iCellMin[3];
+	int iCellMax[3];
+
+	iCellMin[0] = GetCell(node.x - m_dTolerance);
+	iCellMin[1] = GetCell(node.y - m_dTolerance);
+	iCellMin[2] = GetCell(node.z - m_dTolerance);
+
+	iCellMax[0] = GetCell(node.x + m_dTolerance);
+	iCellMax[1] = GetCell(node.y + m_dTolerance);
+	iCellMax[2] = GetCell(node.z + m_dTolerance);
+
+	int ixFound = InvalidNode;
+
+	int iCell[3];
+	for (iCell[0] = iCellMin[0]; iCell[0] <= iCellMax[0]; iCell[0]++) {
+	for (iCell[1] = iCellMin[1]; iCell[1] <= iCellMax[1]; iCell[1]++) {
+	for (iCell[2] = iCellMin[2]; iCell[2] <= iCellMax[2]; iCell[2]++) {
+
+		size_t s = GetSlot(iCell);
+
+		for (; m_vecEntries[s].ix != InvalidNode; s = (s + 1) & sMask) {
+			const Entry & entry = m_vecEntries[s];
+
+			if ((entry.iCell[0] != iCell[0]) ||
+				(entry.iCell[1] != iCell[1]) ||
+				(entry.iCell[2] != iCell[2])
+			) {
+				continue;
+			}
+
+			if ((fabs(entry.x - node.x) < m_dTolerance) &&
+				(fabs(entry.y - node.y) < m_dTolerance) &&
+				(fabs(entry.z - node.z) < m_dTolerance)
+			) {
+				if ((ixFound == InvalidNode) || (entry.ix < ixFound)) {
+					ixFound = entry.ix;
+				}
+			}
+		}
+	}
+	}
+	}
+
+	return ixFound;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Face
 ///////////////////////////////////////////////////////////////////////////////
 
-int Face::GetEdgeIndex(
+int Face::GetEdgeIndex(
+	const Edge & edge
+) const {
+	for (int i = 0; i < edges.size(); i++) {
+		if (edges[i] == edge) {
+			return i;
+		}
+	}
+	_EXCEPTIONT("Edge not found on Face");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Face::RemoveZeroEdges() {
+
+	// Loop through all edges of this face
+	for (int i = 0; i < edges.size(); i++) {
+
+		// Remove zero edges
+		if (edges[i][0] == edges[i][1]) {
+			edges.erase(edges.begin()+i);
+			i--;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// FaceCapTree
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceCapTree::Construct(
+	const FaceVector & faces,
+	const NodeVector & nodes
+) {
+	// Radius of a cap which covers the entire sphere
+	static const Real WholeSphereRadius = 2.1;
+
+	Clear();
+
+	if (faces.size() == 0) {
+		return;
+	}
+
+	// Bounding cap of each Face
+	std::vector<Node> vecFaceCenters;
+	vecFaceCenters.resize(faces.size());
+
+	std::vector<Real> vecFaceRadii;
+	vecFaceRadii.resize(faces.size());
+
+	for (int i = 0; i < faces.size(); i++) {
+		const Face & face = faces[i];
+
+		int nEdges = face.edges.size();
+
+		// Center of the cap is the normalized mean of the Face nodes
+		Node nodeCenter;
+		for (int k = 0; k < nEdges; k++) {
+			const Node & node = nodes[face[k]];
+			nodeCenter.x += node.x;
+			nodeCenter.y += node.y;
+			nodeCenter.z += node.z;
+		}
+
+		Real dMag = nodeCenter.Magnitude();
+		if (dMag == 0.0) {
+			vecFaceCenters[i] = nodeCenter;
+			vecFaceRadii[i] = WholeSphereRadius;
+			continue;
+		}
+
+		nodeCenter = ScalarProduct(1.0 / dMag, nodeCenter);
+
+		// Each Edge lies within a ball centered on its midpoint whose
+		// radius is the distance from the midpoint to either endpoint
+		Real dRadius = 0.0;
+
+		for (int k = 0; k < nEdges; k++) {
+			const Edge & edge = face.edges[k];
+
+			const Node & node0 = nodes[edge[0]];
+			const Node & node1 = nodes[edge[1]];
+
+			Node nodeMid;
+			if (edge.type == Edge::Type_ConstantLatitude) {
+				Real dLon0 = atan2(node0.y, node0.x);
+				Real dLon1 = atan2(node1.y, node1.x);
+
+				Real dDeltaLon = dLon1 - dLon0;
+				if (dDeltaLon > M_PI) {
+					dDeltaLon -= 2.0 * M_PI;
+				} else if (dDeltaLon < -M_PI) {
+					dDeltaLon += 2.0 * M_PI;
+				}
+
+				Real dLonMid = dLon0 + 0.5 * dDeltaLon;
+				Real dRho = sqrt(node0.x * node0.x + node0.y * node0.y);
+
+				nodeMid.x = dRho * cos(dLonMid);
+				nodeMid.y = dRho * sin(dLonMid);
+				nodeMid.z = node0.z;
+
+			} else {
+				nodeMid.x = node0.x + node1.x;
+				nodeMid.y = node0.y + node1.y;
+				nodeMid.z = node0.z + node1.z;
+
+				Real dMidMag = nodeMid.Magnitude();
+				if (dMidMag == 0.0) {
+					dRadius = WholeSphereRadius;
+					break;
+				}
+				nodeMid = ScalarProduct(1.0 / dMidMag, nodeMid);
+			}
+
+			Real dEdgeRadius =
+				(nodeMid - nodeCenter).Magnitude()
+				+ std::max(
+					(node0 - nodeMid).Magnitude(),
+					(node1 - nodeMid).Magnitude());
+
+			if (dEdgeRadius > dRadius) {
+				dRadius = dEdgeRadius;
+			}
+		}
+
+		// The Face is only guaranteed to lie within its cap if the
+		// cap does not exceed a hemisphere
+		if (dRadius >= sqrt(2.0)) {
+			dRadius = WholeSphereRadius;
+		}
+
+		vecFaceCenters[i] = nodeCenter;
+		vecFaceRadii[i] = dRadius;
+	}
+
+	// Build the tree
+	m_vecFaceIx.resize(faces.size());
+	for (int i = 0; i < faces.size(); i++) {
+		m_vecFaceIx[i] = i;
+	}
+
+	m_vecCaps.reserve(2 * faces.size());
+
+	ConstructSubtree(vecFaceCenters, vecFaceRadii, 0, faces.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int FaceCapTree::ConstructSubtree(
+	const std::vector<Node> & vecFaceCenters,
+	const std::vector<Real> & vecFaceRadii,
+	int ixBegin,
+	int ixEnd
+) {
+	// Maximum number of Faces stored in a leaf cap
+	static const int MaxLeafFaces = 4;
+
+	int ixCap = m_vecCaps.size();
+	m_vecCaps.resize(ixCap + 1);
+
+	// Center of this cap is the mean of all Face centers
+	Node nodeCenter;
+	for (int i = ixBegin; i < ixEnd; i++) {
+		const Node & nodeFace = vecFaceCenters[m_vecFaceIx[i]];
+		nodeCenter.x += nodeFace.x;
+		nodeCenter.y += nodeFace.y;
+		nodeCenter.z += nodeFace.z;
+	}
+	nodeCenter = ScalarProduct(
+		1.0 / static_cast<Real>(ixEnd - ixBegin), nodeCenter);
+
+	// Radius of this cap must enclose the caps of all Faces
+	Real dRadius = 0.0;
+	for (int i = ixBegin; i < ixEnd; i++) {
+		int ixFace = m_vecFaceIx[i];
+		Real dFaceRadius =
+			(vecFaceCenters[ixFace] - nodeCenter).Magnitude()
+			+ vecFaceRadii[ixFace];
+
+		if (dFaceRadius > dRadius) {
+			dRadius = dFaceRadius;
+		}
+	}
+
+	m_vecCaps[ixCap].center = nodeCenter;
+	m_vecCaps[ixCap].dRadius = dRadius;
+	m_vecCaps[ixCap].ixBegin = ixBegin;
+	m_vecCaps[ixCap].ixEnd = ixEnd;
+	m_vecCaps[ixCap].ixChild[0] = (-1);
+	m_vecCaps[ixCap].ixChild[1] = (-1);
+
+	if (ixEnd - ixBegin <= MaxLeafFaces) {
+		return ixCap;
+	}
+
+	// Split along the coordinate axis of greatest extent
+	Node nodeMin = vecFaceCenters[m_vecFaceIx[ixBegin]];
+	Node nodeMax = nodeMin;
+	for (int i = ixBegin + 1; i < ixEnd; i++) {
+		const Node & nodeFace = vecFaceCenters[m_vecFaceIx[i]];
+		nodeMin.x = std::min(nodeMin.x, nodeFace.x);
+		nodeMin.y = std::min(nodeMin.y, nodeFace.y);
+		nodeMin.z = std::min(nodeMin.z, nodeFace.z);
+		nodeMax.x = std::max(nodeMax.x, nodeFace.x);
+		nodeMax.y = std::max(nodeMax.y, nodeFace.y);
+		nodeMax.z = std::max(nodeMax.z, nodeFace.z);
+	}
+
+	Node nodeExtent = nodeMax - nodeMin;
+
+	int iAxis = 0;
+	if ((nodeExtent.y >= nodeExtent.x) && (nodeExtent.y >= nodeExtent.z)) {
+		iAxis = 1;
+	} else if (nodeExtent.z >= nodeExtent.x) {
+		iAxis = 2;
+	}
+
+	// Sort Faces by position along the axis, breaking ties by index
+	std::vector< std::pair<Real, int> > vecKeys;
+	vecKeys.resize(ixEnd - ixBegin);
+	for (int i = ixBegin; i < ixEnd; i++) {
+		const Node & nodeFace = vecFaceCenters[m_vecFaceIx[i]];
+		Real dKey;
+		if (iAxis == 0) {
+			dKey = nodeFace.x;
+		} else if (iAxis == 1) {
+			dKey = nodeFace.y;
+		} else {
+			dKey = nodeFace.z;
+		}
+		vecKeys[i - ixBegin] = std::pair<Real, int>(dKey, m_vecFaceIx[i]);
+	}
+	std::sort(vecKeys.begin(), vecKeys.end());
+
+	for (int i = ixBegin; i < ixEnd; i++) {
+		m_vecFaceIx[i] = vecKeys[i - ixBegin].second;
+	}
+
+	// Build children
+	int ixMid = ixBegin + (ixEnd - ixBegin) / 2;
+
+	int ixChild0 =
+		ConstructSubtree(vecFaceCenters, vecFaceRadii, ixBegin, ixMid);
+	int ixChild1 =
+		ConstructSubtree(vecFaceCenters, vecFaceRadii, ixMid, ixEnd);
+
+	m_vecCaps[ixCap].ixChild[0] = ixChild0;
+	m_vecCaps[ixCap].ixChild[1] = ixChild1;
+
+	return ixCap;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceCapTree::FindCandidateFaces(
+	const Node & node,
+	std::vector<int> & vecFaceIndices
+) const {
+	// Slack on cap radii so that Nodes on Face boundaries are not missed
+	static const Real Tolerance = 1.0e-6;
+
+	vecFaceIndices.clear();
+
+	if (m_vecCaps.size() == 0) {
+		return;
+	}
+
+	// Depth-first traversal of the tree
+	std::vector<int> vecStack;
+	vecStack.push_back(0);
+
+	while (vecStack.size() != 0) {
+		const Cap & cap = m_vecCaps[vecStack.back()];
+		vecStack.pop_back();
+
+		if ((node - cap.center).Magnitude() > cap.dRadius + Tolerance) {
+			continue;
+		}
+
+		if (cap.ixChild[0] == (-1)) {
+			for (int i = cap.ixBegin; i < cap.ixEnd; i++) {
+				vecFaceIndices.push_back(m_vecFaceIx[i]);
+			}
+
+		} else {
+			vecStack.push_back(cap.ixChild[1]);
+			vecStack.push_back(cap.ixChild[0]);
+		}
+	}
+
+	std::sort(vecFaceIndices.begin(), vecFaceIndices.end());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// ReverseNodeArray
+///////////////////////////////////////////////////////////////////////////////
+
+void ReverseNodeArray::Construct(
+	const FaceVector & faces,
+	int nNodes
+) {
+	int nFaces = static_cast<int>(faces.size());
+
+	// Last Face counted at each Node, so that Nodes repeated within a
+	// Face are only counted once
+	std::vector<int> vecLastFace(nNodes, -1);
+
+	// Count the Faces at each Node
+	m_vecNodeBegin.assign(nNodes + 1, 0);
+
+	for (int i = 0; i < nFaces; i++) {
+		for (int k = 0; k < faces[i].edges.size(); k++) {
+			int ixNode = faces[i].edges[k][0];
+			if (vecLastFace[ixNode] != i) {
+				vecLastFace[ixNode] = i;
+				m_vecNodeBegin[ixNode+1]++;
+			}
+		}
+	}
+
+	for (int n = 0; n < nNodes; n++) {
+		m_vecNodeBegin[n+1] += m_vecNodeBegin[n];
+	}
+
+	// Store Face indices; Faces are visited in ascending order so the
+	// Faces of each Node are sorted
+	m_vecFaceIx.resize(m_vecNodeBegin[nNodes]);
+
+	std::vector<int> vecNext(m_vecNodeBegin.begin(), m_vecNodeBegin.end() - 1);
+	vecLastFace.assign(nNodes, -1);
+
+	for (int i = 0; i < nFaces; i++) {
+		for (int k = 0; k < faces[i].edges.size(); k++) {
+			int ixNode = faces[i].edges[k][0];
+			if (vecLastFace[ixNode] != i) {
+				vecLastFace[ixNode] = i;
+				m_vecFaceIx[vecNext[ixNode]++] = i;
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// OverlapFaceIndex
+///////////////////////////////////////////////////////////////////////////////
+
+void OverlapFaceIndex::Construct(
+	const std::vector<int> & vecSourceFaceIx,
+	int nSourceFaces
+) {
+	int nOverlapFaces = static_cast<int>(vecSourceFaceIx.size());
+
+	// Infer the number of source Faces
+	if (nSourceFaces < 0) {
+		nSourceFaces = 0;
+		for (int i = 0; i < nOverlapFaces; i++) {
+			if (vecSourceFaceIx[i] + 1 > nSourceFaces) {
+				nSourceFaces = vecSourceFaceIx[i] + 1;
+			}
+		}
+	}
+
+	// Count the overlap Faces of each source Face
+	m_vecSourceBegin.assign(nSourceFaces + 1, 0);
+	m_fContiguous = true;
+
+	for (int i = 0; i < nOverlapFaces; i++) {
+		int ixSource = vecSourceFaceIx[i];
+		if ((ixSource < 0) || (ixSource >= nSourceFaces)) {
+			_EXCEPTION3("Overlap Face %i has invalid source Face index %i "
+				"(expected [0, %i))", i, ixSource, nSourceFaces);
+		}
+		if ((i != 0) && (ixSource < vecSourceFaceIx[i-1])) {
+			m_fContiguous = false;
+		}
+		m_vecSourceBegin[ixSource+1]++;
+	}
+
+	for (int n = 0; n < nSourceFaces; n++) {
+		m_vecSourceBegin[n+1] += m_vecSourceBegin[n];
+	}
+
+	// Store overlap Face indices; overlap Faces are visited in ascending
+	// order so the overlap Faces of each source Face are sorted
+	m_vecFaceIx.resize(nOverlapFaces);
+
+	std::vector<int> vecNext(
+		m_vecSourceBegin.begin(), m_vecSourceBegin.end() - 1);
+
+	for (int i = 0; i < nOverlapFaces; i++) {
+		m_vecFaceIx[vecNext[vecSourceFaceIx[i]]++] = i;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// EdgeMap
+///////////////////////////////////////////////////////////////////////////////
+
+void EdgeMap::Construct(
+	const FaceVector & faces,
+	int nNodes
+) {
+	int nFaces = static_cast<int>(faces.size());
+
+	clear();
+
+	// Count the Edges at the smaller Node of each Edge
+	std::vector<int> vecNodeBegin(nNodes + 1, 0);
+
+	for (int i = 0; i < nFaces; i++) {
+		const Face & face = faces[i];
+
+		int nEdges = static_cast<int>(face.edges.size());
+
+		for (int k = 0; k < nEdges; k++) {
+			int ixNode0 = face[k];
+			int ixNode1 = face[(k+1)%nEdges];
+
+			if (ixNode0 == ixNode1) {
+				continue;
+			}
+
+			if ((ixNode0 < 0) || (ixNode0 >= nNodes) ||
+				(ixNode1 < 0) || (ixNode1 >= nNodes)
+			) {
+				_EXCEPTION2("Face %i references a Node outside of [0, %i)",
+					i, nNodes);
+			}
+
+			vecNodeBegin[std::min(ixNode0, ixNode1)+1]++;
+		}
+	}
+
+	for (int n = 0; n < nNodes; n++) {
+		vecNodeBegin[n+1] += vecNodeBegin[n];
+	}
+
+	// Bucket the Face Edges by their smaller Node; Faces are visited in
+	// ascending order so each bucket is sorted by Face and local Edge index
+	struct FaceEdge {
+		int ixNodeBig;
+		int ixFace;
+		int ixEdge;
+	};
+
+	std::vector<FaceEdge> vecFaceEdges(vecNodeBegin[nNodes]);
+	std::vector<int> vecNext(vecNodeBegin.begin(), vecNodeBegin.end() - 1);
+
+	for (int i = 0; i < nFaces; i++) {
+		const Face & face = faces[i];
+
+		int nEdges = static_cast<int>(face.edges.size());
+
+		for (int k = 0; k < nEdges; k++) {
+			int ixNode0 = face[k];
+			int ixNode1 = face[(k+1)%nEdges];
+
+			if (ixNode0 == ixNode1) {
+				continue;
+			}
+
+			FaceEdge & faceedge =
+				vecFaceEdges[vecNext[std::min(ixNode0, ixNode1)]++];
+			faceedge.ixNodeBig = std::max(ixNode0, ixNode1);
+			faceedge.ixFace = i;
+			faceedge.ixEdge = k;
+		}
+	}
+
+	// Sort each bucket by the larger Node; buckets are small, so a stable
+	// insertion sort is used to preserve the order of Faces
+	for (int n = 0; n < nNodes; n++) {
+		for (int j = vecNodeBegin[n] + 1; j < vecNodeBegin[n+1]; j++) {
+			FaceEdge faceedge = vecFaceEdges[j];
+
+			int l = j;
+			for (; l > vecNodeBegin[n]; l--) {
+				if (vecFaceEdges[l-1].ixNodeBig <= faceedge.ixNodeBig) {
+					break;
+				}
+				vecFaceEdges[l] = vecFaceEdges[l-1];
+			}
+			vecFaceEdges[l] = faceedge;
+		}
+	}
+
+	// Merge Face Edges with the same Nodes into a single Edge
+	m_vecKeys.reserve(vecFaceEdges.size() / 2 + 1);
+	m_vecEdges.reserve(vecFaceEdges.size() / 2 + 1);
+
+	for (int n = 0; n < nNodes; n++) {
+		for (int j = vecNodeBegin[n]; j < vecNodeBegin[n+1]; j++) {
+			const FaceEdge & faceedge = vecFaceEdges[j];
+
+			if ((j == vecNodeBegin[n]) ||
+				(vecFaceEdges[j-1].ixNodeBig != faceedge.ixNodeBig)
+			) {
+				const Face & face = faces[faceedge.ixFace];
+
+				int nEdges = static_cast<int>(face.edges.size());
+
+				Edge edge(
+					face[faceedge.ixEdge],
+					face[(faceedge.ixEdge+1)%nEdges]);
+
+				m_vecKeys.push_back(PackKey(edge));
+				m_vecEdges.push_back(EdgePair(edge, FacePair()));
+			}
+
+			m_vecEdges.back().second.AddFace(faceedge.ixFace);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t EdgeMap::FindIndex(
 	const Edge & edge
 ) const {
-	for (int i = 0; i < edges.size(); i++) {
-		if (edges[i] == edge) {
-			return i;
-		}
+	uint64_t uiKey = PackKey(edge);
+
+	std::vector<uint64_t>::const_iterator iter =
+		std::lower_bound(m_vecKeys.begin(), m_vecKeys.end(), uiKey);
+
+	if ((iter == m_vecKeys.end()) || (*iter != uiKey)) {
+		return m_vecEdges.size();
 	}
-	_EXCEPTIONT("Edge not found on Face");
+
+	return static_cast<size_t>(iter - m_vecKeys.begin());
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// Mesh cache
 ///////////////////////////////////////////////////////////////////////////////
 
-void Face::RemoveZeroEdges() {
+///	<summary>
+///		Suffix appended to the name of a mesh file to obtain its cache file.
+///	</summary>
+static const char MeshCacheSuffix[] = ".cache";
+
+///	<summary>
+///		Magic bytes at the start of a mesh cache file.
+///	</summary>
+static const char MeshCacheMagic[8] = {'T','R','M','E','S','H','C','C'};
+
+///	<summary>
+///		Version of the mesh cache format.
+///	</summary>
+static const int32_t MeshCacheVersion = 1;
+
+///	<summary>
+///		Byte order marker, used to reject caches written on another host.
+///	</summary>
+static const int32_t MeshCacheByteOrder = 0x01020304;
+
+///	<summary>
+///		Number of leading bytes of the mesh file included in its hash.
+///	</summary>
+static const size_t MeshCacheHashBytes = 65536;
+
+///	<summary>
+///		Flags of the arrays present in a mesh cache file.
+///	</summary>
+enum MeshCacheFlag {
+	MeshCacheFlag_EdgeType = 1,
+	MeshCacheFlag_FirstFaceIx = 2,
+	MeshCacheFlag_SecondFaceIx = 4
+};
+
+///	<summary>
+///		Identity of a mesh file.  A cache is only used if the size,
+///		modification time and hash of the leading bytes of the mesh file,
+///		which include its NetCDF header, all match.
+///	</summary>
+struct MeshCacheKey {
+	int64_t nSize;
+	int64_t nMTimeSec;
+	int64_t nMTimeNSec;
+	uint64_t uiHash;
+};
+
+///	<summary>
+///		Header of a mesh cache file.  The header is followed by the x, y
+///		and z coordinates of all Nodes as double, the 1-indexed Node indices
+///		of all Faces (nNodesPerElement per Face) as int32, and then, if
+///		present, the Edge types and first and second mesh Face indices
+///		as int32.
+///	</summary>
+struct MeshCacheHeader {
+	char szMagic[8];
+	int32_t nVersion;
+	int32_t nByteOrder;
+
+	MeshCacheKey key;
+
+	int64_t nNodes;
+	int64_t nFaces;
+	int32_t nNodesPerElement;
+	int32_t nFlags;
+};
 
-	// Loop through all edges of this face
-	for (int i = 0; i < edges.size(); i++) {
+///////////////////////////////////////////////////////////////////////////////
 
-		// Remove zero edges
-		if (edges[i][0] == edges[i][1]) {
-			edges.erase(edges.begin()+i);
-			i--;
+///	<summary>
+///		Compute the MeshCacheKey of the given mesh file.
+///	</summary>
+static void GetMeshCacheKey(
+	const std::string & strFile,
+	MeshCacheKey & key
+) {
+	memset(&key, 0, sizeof(MeshCacheKey));
+
+	struct stat statFile;
+	if (stat(strFile.c_str(), &statFile) != 0) {
+		_EXCEPTION1("Unable to stat mesh file \"%s\"", strFile.c_str());
+	}
+
+	key.nSize = static_cast<int64_t>(statFile.st_size);
+#ifdef __APPLE__
+	key.nMTimeSec = static_cast<int64_t>(statFile.st_mtimespec.tv_sec);
+	key.nMTimeNSec = static_cast<int64_t>(statFile.st_mtimespec.tv_nsec);
+#else
+	key.nMTimeSec = static_cast<int64_t>(statFile.st_mtim.tv_sec);
+	key.nMTimeNSec = static_cast<int64_t>(statFile.st_mtim.tv_nsec);
+#endif
+
+	// FNV-1a hash of the leading bytes of the file
+	FILE * fp = fopen(strFile.c_str(), "rb");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open mesh file \"%s\"", strFile.c_str());
+	}
+
+	std::vector<unsigned char> vecBytes(MeshCacheHashBytes);
+	size_t sRead = fread(&(vecBytes[0]), 1, MeshCacheHashBytes, fp);
+	fclose(fp);
+
+	uint64_t uiHash = 14695981039346656037ULL;
+	for (size_t i = 0; i < sRead; i++) {
+		uiHash = (uiHash ^ static_cast<uint64_t>(vecBytes[i]))
+			* 1099511628211ULL;
+	}
+	key.uiHash = uiHash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Build the Faces of mesh from arrays of Node indices, with base
+///		nIndexBase, and optionally Edge types, of nNodesPerElement entries
+///		per Face.  Faces are constructed in parallel.
+///	</summary>
+static void SetFacesFromArrays(
+	Mesh & mesh,
+	int nFaces,
+	int nNodesPerElement,
+	const int * pFaceNodes,
+	const int * pEdgeTypes,
+	int nIndexBase
+) {
+	mesh.faces.resize(nFaces);
+
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nFaces; i++) {
+		Face & face = mesh.faces[i];
+
+		face.edges.resize(nNodesPerElement);
+
+		const int * pNodes = pFaceNodes + i * nNodesPerElement;
+
+		for (int j = 0; j < nNodesPerElement; j++) {
+			face.SetNode(j, pNodes[j] - nIndexBase);
+		}
+
+		if (pEdgeTypes == NULL) {
+			for (int j = 0; j < nNodesPerElement; j++) {
+				face.edges[j].type = Edge::Type_Default;
+			}
+
+		} else {
+			const int * pTypes = pEdgeTypes + i * nNodesPerElement;
+
+			for (int j = 0; j < nNodesPerElement; j++) {
+				face.edges[j].type = static_cast<Edge::Type>(pTypes[j]);
+			}
 		}
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Read a mesh from the cache of strFile, if the cache exists and
+///		matches key.  Returns false if there is no valid cache.
+///	</summary>
+static bool ReadMeshCache(
+	const std::string & strFile,
+	const MeshCacheKey & key,
+	Mesh & mesh
+) {
+	std::string strCache = strFile + MeshCacheSuffix;
+
+	FILE * fp = fopen(strCache.c_str(), "rb");
+	if (fp == NULL) {
+		return false;
+	}
+
+	MeshCacheHeader header;
+	if ((fread(&header, sizeof(MeshCacheHeader), 1, fp) != 1) ||
+		(memcmp(header.szMagic, MeshCacheMagic, sizeof(MeshCacheMagic)) != 0) ||
+		(header.nVersion != MeshCacheVersion) ||
+		(header.nByteOrder != MeshCacheByteOrder) ||
+		(header.key.nSize != key.nSize) ||
+		(header.key.nMTimeSec != key.nMTimeSec) ||
+		(header.key.nMTimeNSec != key.nMTimeNSec) ||
+		(header.key.uiHash != key.uiHash)
+	) {
+		fclose(fp);
+		return false;
+	}
+
+	int nNodes = static_cast<int>(header.nNodes);
+	int nFaces = static_cast<int>(header.nFaces);
+	int nNodesPerElement = header.nNodesPerElement;
+
+	size_t sFaceEntries =
+		static_cast<size_t>(nFaces) * static_cast<size_t>(nNodesPerElement);
+
+	// Load the arrays
+	std::vector<double> dCoord(3 * static_cast<size_t>(nNodes));
+	std::vector<int32_t> vecFaceNodes(sFaceEntries);
+	std::vector<int32_t> vecEdgeTypes;
+	std::vector<int> vecFirstFaceIx;
+	std::vector<int> vecSecondFaceIx;
+
+	if (header.nFlags & MeshCacheFlag_EdgeType) {
+		vecEdgeTypes.resize(sFaceEntries);
+	}
+	if (header.nFlags & MeshCacheFlag_FirstFaceIx) {
+		vecFirstFaceIx.resize(nFaces);
+	}
+	if (header.nFlags & MeshCacheFlag_SecondFaceIx) {
+		vecSecondFaceIx.resize(nFaces);
+	}
+
+	bool fValid =
+		(fread(dCoord.data(), sizeof(double), dCoord.size(), fp)
+			== dCoord.size()) &&
+		(fread(vecFaceNodes.data(), sizeof(int32_t), vecFaceNodes.size(), fp)
+			== vecFaceNodes.size()) &&
+		(fread(vecEdgeTypes.data(), sizeof(int32_t), vecEdgeTypes.size(), fp)
+			== vecEdgeTypes.size()) &&
+		(fread(vecFirstFaceIx.data(), sizeof(int), vecFirstFaceIx.size(), fp)
+			== vecFirstFaceIx.size()) &&
+		(fread(vecSecondFaceIx.data(), sizeof(int), vecSecondFaceIx.size(), fp)
+			== vecSecondFaceIx.size());
+
+	fclose(fp);
+
+	if (!fValid) {
+		return false;
+	}
+
+	Announce("Mesh size: Nodes [%i] Elements [%i]", nNodes, nFaces);
+	Announce("Mesh read from cache \"%s\"", strCache.c_str());
+
+	// Build the mesh
+	mesh.nodes.resize(nNodes);
+
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nNodes; i++) {
+		mesh.nodes[i].x = static_cast<Real>(dCoord[i]);
+		mesh.nodes[i].y = static_cast<Real>(dCoord[nNodes + i]);
+		mesh.nodes[i].z = static_cast<Real>(dCoord[2 * nNodes + i]);
+	}
+
+	SetFacesFromArrays(
+		mesh,
+		nFaces,
+		nNodesPerElement,
+		vecFaceNodes.data(),
+		(vecEdgeTypes.size() == 0)?(NULL):(vecEdgeTypes.data()),
+		1);
+
+	mesh.vecFirstFaceIx.swap(vecFirstFaceIx);
+	mesh.vecSecondFaceIx.swap(vecSecondFaceIx);
+
+	// Index the Faces of an overlap mesh by first and second mesh Face
+	if ((header.nFlags & MeshCacheFlag_FirstFaceIx) &&
+		(header.nFlags & MeshCacheFlag_SecondFaceIx)
+	) {
+		mesh.ConstructOverlapIndex();
+	} else {
+		mesh.firstfaceindex.Clear();
+		mesh.secondfaceindex.Clear();
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Write the cache of strFile.  The cache is written to a temporary
+///		file which is then renamed, so concurrent readers never see a
+///		partial cache.  Failure to write the cache is not an error.
+///	</summary>
+static void WriteMeshCache(
+	const std::string & strFile,
+	const MeshCacheKey & key,
+	const Mesh & mesh,
+	int nNodesPerElement,
+	const int * pFaceNodes,
+	const int * pEdgeTypes
+) {
+	std::string strCache = strFile + MeshCacheSuffix;
+
+	char szPid[32];
+	sprintf(szPid, ".%i", static_cast<int>(getpid()));
+	std::string strTemp = strCache + szPid;
+
+	int nNodes = static_cast<int>(mesh.nodes.size());
+	int nFaces = static_cast<int>(mesh.faces.size());
+
+	size_t sFaceEntries =
+		static_cast<size_t>(nFaces) * static_cast<size_t>(nNodesPerElement);
+
+	MeshCacheHeader header;
+	memset(&header, 0, sizeof(MeshCacheHeader));
+	memcpy(header.szMagic, MeshCacheMagic, sizeof(MeshCacheMagic));
+	header.nVersion = MeshCacheVersion;
+	header.nByteOrder = MeshCacheByteOrder;
+	header.key = key;
+	header.nNodes = nNodes;
+	header.nFaces = nFaces;
+	header.nNodesPerElement = nNodesPerElement;
+	header.nFlags = 0;
+	if (pEdgeTypes != NULL) {
+		header.nFlags |= MeshCacheFlag_EdgeType;
+	}
+	if (mesh.vecFirstFaceIx.size() != 0) {
+		header.nFlags |= MeshCacheFlag_FirstFaceIx;
+	}
+	if (mesh.vecSecondFaceIx.size() != 0) {
+		header.nFlags |= MeshCacheFlag_SecondFaceIx;
+	}
+
+	std::vector<double> dCoord(3 * static_cast<size_t>(nNodes));
+	for (int i = 0; i < nNodes; i++) {
+		dCoord[i] = static_cast<double>(mesh.nodes[i].x);
+		dCoord[nNodes + i] = static_cast<double>(mesh.nodes[i].y);
+		dCoord[2 * nNodes + i] = static_cast<double>(mesh.nodes[i].z);
+	}
+
+	FILE * fp = fopen(strTemp.c_str(), "wb");
+	if (fp == NULL) {
+		Announce("WARNING: Unable to write mesh cache \"%s\"",
+			strCache.c_str());
+		return;
+	}
+
+	bool fValid =
+		(fwrite(&header, sizeof(MeshCacheHeader), 1, fp) == 1) &&
+		(fwrite(dCoord.data(), sizeof(double), dCoord.size(), fp)
+			== dCoord.size()) &&
+		(fwrite(pFaceNodes, sizeof(int32_t), sFaceEntries, fp)
+			== sFaceEntries);
+
+	if (fValid && (pEdgeTypes != NULL)) {
+		fValid = (fwrite(pEdgeTypes, sizeof(int32_t), sFaceEntries, fp)
+			== sFaceEntries);
+	}
+	if (fValid && (mesh.vecFirstFaceIx.size() != 0)) {
+		fValid = (fwrite(mesh.vecFirstFaceIx.data(), sizeof(int),
+			mesh.vecFirstFaceIx.size(), fp) == mesh.vecFirstFaceIx.size());
+	}
+	if (fValid && (mesh.vecSecondFaceIx.size() != 0)) {
+		fValid = (fwrite(mesh.vecSecondFaceIx.data(), sizeof(int),
+			mesh.vecSecondFaceIx.size(), fp) == mesh.vecSecondFaceIx.size());
+	}
+
+	if (fclose(fp) != 0) {
+		fValid = false;
+	}
+
+	if (!fValid || (rename(strTemp.c_str(), strCache.c_str()) != 0)) {
+		remove(strTemp.c_str());
+		Announce("WARNING: Unable to write mesh cache \"%s\"",
+			strCache.c_str());
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Mesh
 ///////////////////////////////////////////////////////////////////////////////
@@ -61,92 +1138,80 @@ void Mesh::Clear() {
 	nodes.clear();
 	faces.clear();
 	edgemap.clear();
-	revnodearray.clear();
+	revnodearray.Clear();
+	firstfaceindex.Clear();
+	secondfaceindex.Clear();
+	facetree.Clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Mesh::ConstructEdgeMap() {
+	edgemap.Construct(faces, static_cast<int>(nodes.size()));
 
-	// Construct the edge map
-	edgemap.clear();
-	for (int i = 0; i < faces.size(); i++) {
-		const Face & face = faces[i];
-
-		int nEdges = face.edges.size();
+	Announce("Mesh size: Edges [%i]", edgemap.size());
+}
 
-		for (int k = 0; k < nEdges; k++) {
-			if (faces[i][k] == face[(k+1)%nEdges]) {
-				continue;
-			}
+///////////////////////////////////////////////////////////////////////////////
 
-			Edge edge(face[k], face[(k+1)%nEdges]);
-			FacePair facepair;
+void Mesh::ConstructReverseNodeArray() {
+	revnodearray.Construct(faces, static_cast<int>(nodes.size()));
+}
 
-			EdgeMapIterator iter =
-				edgemap.insert(EdgeMapPair(edge, facepair)).first;
+///////////////////////////////////////////////////////////////////////////////
 
-			iter->second.AddFace(i);
-		}
+void Mesh::ConstructOverlapIndex(
+	int nFirstFaces,
+	int nSecondFaces
+) {
+	if (vecFirstFaceIx.size() != faces.size()) {
+		_EXCEPTION2("Overlap mesh has %i Faces but %i first mesh Face indices",
+			faces.size(), vecFirstFaceIx.size());
+	}
+	if (vecSecondFaceIx.size() != faces.size()) {
+		_EXCEPTION2("Overlap mesh has %i Faces but %i second mesh Face indices",
+			faces.size(), vecSecondFaceIx.size());
 	}
 
-	Announce("Mesh size: Edges [%i]", edgemap.size());
+	firstfaceindex.Construct(vecFirstFaceIx, nFirstFaces);
+	secondfaceindex.Construct(vecSecondFaceIx, nSecondFaces);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::ConstructReverseNodeArray() {
-
-	// Initialize the object
-	revnodearray.resize(nodes.size());
-	for (int i = 0; i < revnodearray.size(); i++) {
-		revnodearray[i].clear();
-	}
-
-	// Build set for each node
-	for (int i = 0; i < faces.size(); i++) {
-		for (int k = 0; k < faces[i].edges.size(); k++) {
-			int ixNode = faces[i].edges[k][0];
-			revnodearray[ixNode].insert(i);
-		}
-	}
+void Mesh::ConstructFaceTree() {
+	facetree.Construct(faces, nodes);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 Real Mesh::CalculateFaceAreas() {
 
+	int nFaces = static_cast<int>(faces.size());
+
+	// Longitude and conformal latitude of each Node, computed once rather
+	// than twice for each Face containing the Node
+	std::vector<double> dLon;
+	std::vector<double> dLamLat;
+
+	CalculateNodeAreaCoordinates(nodes, dLon, dLamLat);
+
+	const double * pLon = (dLon.size() == 0)?(NULL):(&(dLon[0]));
+	const double * pLamLat = (dLamLat.size() == 0)?(NULL):(&(dLamLat[0]));
+
 	// Calculate the area of each Face
-	vecFaceArea.Initialize(faces.size());
-	for (int i = 0; i < faces.size(); i++) {
-		vecFaceArea[i] = CalculateFaceArea(faces[i], nodes);
+	vecFaceArea.Initialize(nFaces);
+
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nFaces; i++) {
+		vecFaceArea[i] = CalculateFaceArea(faces[i], pLon, pLamLat);
 	}
 
 	// Calculate accumulated area carefully
-	static const int Jump = 10;
-	std::vector<double> vecFaceAreaBak;
-	vecFaceAreaBak.resize(vecFaceArea.GetRows());
-	memcpy(&(vecFaceAreaBak[0]), &(vecFaceArea[0]),
-		vecFaceArea.GetRows() * sizeof(double));
-
-	for (;;) {
-		if (vecFaceAreaBak.size() == 1) {
-			break;
-		}
-		for (int i = 0; i <= (vecFaceAreaBak.size()-1) / Jump; i++) {
-			int ixRef = Jump * i;
-			vecFaceAreaBak[i] = vecFaceAreaBak[ixRef];
-			for (int j = 1; j < Jump; j++) {
-				if (ixRef + j >= vecFaceAreaBak.size()) {
-					break;
-				}
-				vecFaceAreaBak[i] += vecFaceAreaBak[ixRef + j];
-			}
-		}
-		vecFaceAreaBak.resize((vecFaceAreaBak.size()-1) / Jump + 1);
+	if (nFaces == 0) {
+		return 0.0;
 	}
-
-	return vecFaceAreaBak[0];
+	return CompensatedSum(&(vecFaceArea[0]), nFaces);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -158,25 +1223,53 @@ Real Mesh::CalculateFaceAreasFromOverlap(
 		_EXCEPTIONT("MeshOverlap Face Areas have not been calculated");
 	}
 
+	int nFaces = static_cast<int>(faces.size());
+	int nOverlapFaces = static_cast<int>(meshOverlap.faces.size());
+
 	// Set all Face areas to zero
-	vecFaceArea.Initialize(faces.size());
+	vecFaceArea.Initialize(nFaces);
 	vecFaceArea.Zero();
 
-	// Loop over all Faces in meshOverlap
-	double dTotalArea = 0.0;
-
-	for (int i = 0; i < meshOverlap.faces.size(); i++) {
+	for (int i = 0; i < nOverlapFaces; i++) {
 		int ixFirstFace = meshOverlap.vecFirstFaceIx[i];
 
-		if (ixFirstFace >= vecFaceArea.GetRows()) {
+		if ((ixFirstFace < 0) || (ixFirstFace >= nFaces)) {
 			_EXCEPTIONT("Overlap Mesh FirstFaceIx contains invalid "
 				"Face index");
 		}
+	}
+
+	// Accumulate the areas of the overlap Faces of each Face; the overlap
+	// Faces of each Face are visited in ascending order, as in a serial
+	// pass over the overlap mesh
+	const OverlapFaceIndex & indexOverlap = meshOverlap.firstfaceindex;
+
+	if (!indexOverlap.IsEmpty() &&
+		(indexOverlap.GetSourceFaceCount() <= nFaces)
+	) {
+		int nSourceFaces = indexOverlap.GetSourceFaceCount();
+
+#pragma omp parallel for schedule(static)
+		for (int ixFirst = 0; ixFirst < nSourceFaces; ixFirst++) {
+			int nOverlap = indexOverlap.GetFaceCount(ixFirst);
+			for (int j = 0; j < nOverlap; j++) {
+				vecFaceArea[ixFirst] +=
+					meshOverlap.vecFaceArea[indexOverlap.GetFace(ixFirst, j)];
+			}
+		}
 
-		vecFaceArea[ixFirstFace] += meshOverlap.vecFaceArea[i];
-		dTotalArea += meshOverlap.vecFaceArea[i];
+	} else {
+		for (int i = 0; i < nOverlapFaces; i++) {
+			vecFaceArea[meshOverlap.vecFirstFaceIx[i]] +=
+				meshOverlap.vecFaceArea[i];
+		}
+	}
+
+	// Total area of the overlap mesh
+	if (nOverlapFaces == 0) {
+		return 0.0;
 	}
-	return dTotalArea;
+	return CompensatedSum(&(meshOverlap.vecFaceArea[0]), nOverlapFaces);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -194,45 +1287,81 @@ void Mesh::ExchangeFirstAndSecondMesh() {
 	FaceVector facesOld = faces;
 
 	std::vector<int> vecFirstFaceIxOld = vecFirstFaceIx;
+	std::vector<int> vecSecondFaceIxOld = vecSecondFaceIx;
 
-	// Reordering map
-	std::multimap<int,int> multimapReorder;
-	for (int i = 0; i < vecSecondFaceIx.size(); i++) {
-		multimapReorder.insert(std::pair<int,int>(vecSecondFaceIx[i], i));
-	}
-
-	// Apply reordering
-	faces.clear();
-	vecFirstFaceIx.clear();
-	vecSecondFaceIx.clear();
+	int nFirstFaces = firstfaceindex.GetSourceFaceCount();
+	int nSecondFaces = secondfaceindex.GetSourceFaceCount();
 
-	std::multimap<int,int>::const_iterator iterReorder
-		= multimapReorder.begin();
+	// Sort the overlap Faces by second mesh Face, preserving the order
+	// of overlap Faces within each second mesh Face
+	OverlapFaceIndex indexReorder;
+	indexReorder.Construct(
+		vecSecondFaceIxOld, (nSecondFaces == 0)?(-1):(nSecondFaces));
 
-	for (; iterReorder != multimapReorder.end(); iterReorder++) {
-		faces.push_back(facesOld[iterReorder->second]);
-		vecFirstFaceIx.push_back(iterReorder->first);
-		vecSecondFaceIx.push_back(vecFirstFaceIxOld[iterReorder->second]);
+	// Apply reordering
+	int ixOverlap = 0;
+	for (int ixSecond = 0; ixSecond < indexReorder.GetSourceFaceCount(); ixSecond++) {
+		for (int i = 0; i < indexReorder.GetFaceCount(ixSecond); i++) {
+			int ixOld = indexReorder.GetFace(ixSecond, i);
+
+			faces[ixOverlap] = facesOld[ixOld];
+			vecFirstFaceIx[ixOverlap] = ixSecond;
+			vecSecondFaceIx[ixOverlap] = vecFirstFaceIxOld[ixOld];
+			ixOverlap++;
+		}
 	}
+
+	// Rebuild the overlap index
+	ConstructOverlapIndex(
+		(nSecondFaces == 0)?(-1):(nSecondFaces),
+		(nFirstFaces == 0)?(-1):(nFirstFaces));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::Write(const std::string & strFile) const {
+void Mesh::Write(
+	const std::string & strFile,
+	const NetCDFOutputOptions & options
+) const {
 	const int ParamFour = 4;
 	const int ParamLenString = 33;
 
+	// Number of nodes
+	int nNodeCount = nodes.size();
+
+	// Number of elements
+	int nElementCount = faces.size();
+
 	// Determine the maximum number of nodes per element
 	int nNodesPerElement = 0;
-	for (int i = 0; i < faces.size(); i++) {
+	for (int i = 0; i < nElementCount; i++) {
 		if (faces[i].edges.size() > nNodesPerElement) {
 			nNodesPerElement = faces[i].edges.size();
 		}
 	}
 	Announce("Max nodes per element: %i", nNodesPerElement);
 
+	if (vecFirstFaceIx.size() != 0) {
+		if (vecFirstFaceIx.size() != nElementCount) {
+			_EXCEPTIONT("Incorrect size of vecFirstFaceIx");
+		}
+	}
+	if (vecSecondFaceIx.size() != 0) {
+		if (vecSecondFaceIx.size() != nElementCount) {
+			_EXCEPTIONT("Incorrect size of vecSecondFaceIx");
+		}
+	}
+
 	// Output to a NetCDF Exodus file
-	NcFile ncOut(strFile.c_str(), NcFile::Replace);
+	NcFile ncOut(
+		strFile.c_str(),
+		NcFile::Replace,
+		NULL,
+		0,
+		(options.fNetCDF4)?(NcFile::Netcdf4):(NcFile::Classic));
+
+	// All dimensions, attributes and variables are defined before any
+	// data is written, so that the file is only put into data mode once
 
 	// Random Exodus dimensions
 	NcDim * dimLenString = ncOut.add_dim("len_string", ParamLenString);
@@ -241,12 +1370,8 @@ void Mesh::Write(const std::string & strFile) const {
 	NcDim * dimTime = ncOut.add_dim("time_step");
 	NcDim * dimDimension = ncOut.add_dim("num_dim", 3);
 
-	// Number of nodes
-	int nNodeCount = nodes.size();
 	NcDim * dimNodes = ncOut.add_dim("num_nodes", nNodeCount);
 
-	// Number of elements
-	int nElementCount = faces.size();
 	NcDim * dimElements = ncOut.add_dim("num_elem", nElementCount);
 
 	// Other dimensions
@@ -257,6 +1382,19 @@ void Mesh::Write(const std::string & strFile) const {
 		ncOut.add_dim("num_nod_per_el1", nNodesPerElement);
 	NcDim * dimAttBlock1 = ncOut.add_dim("num_att_in_blk1", 1);
 
+	// Chunk shapes of Face and Node variables
+	long nChunkFaces[2];
+	nChunkFaces[0] = GetNcChunkLength(nElementCount);
+	nChunkFaces[1] = GetNcChunkLength(nNodesPerElement);
+
+	long nChunkAttrib1[2];
+	nChunkAttrib1[0] = nChunkFaces[0];
+	nChunkAttrib1[1] = 1;
+
+	long nChunkNodes[2];
+	nChunkNodes[0] = 1;
+	nChunkNodes[1] = GetNcChunkLength(nNodeCount);
+
 	// Global attributes
 	ncOut.add_att("api_version", 4.98f);
 	ncOut.add_att("version", 4.98f);
@@ -271,88 +1409,156 @@ void Mesh::Write(const std::string & strFile) const {
 	ncOut.add_var("time_whole", ncDouble, dimTime);
 
 	// QA records
-	char szQARecord[ParamFour][ParamLenString] = {
-		"Tempest", "13.0", "01/01/2013", "00:00:00"};
-
 	NcVar * varQARecords =
 		ncOut.add_var("qa_records", ncChar, dimNumQARec, dimFour, dimLenString);
-	varQARecords->set_cur(0, 0, 0);
-	varQARecords->put(&(szQARecord[0][0]), 1, 4, ParamLenString);
 
 	// Coordinate names
-	char szCoordNames[3][ParamLenString] = {"x", "y", "z"};
-	
 	NcVar * varCoordNames =
 		ncOut.add_var("coor_names", ncChar, dimDimension, dimLenString);
-	varCoordNames->set_cur(0, 0, 0);
-	varCoordNames->put(&(szCoordNames[0][0]), 3, ParamLenString);
 
 	// Element block names
 	NcVar * varElementBlockNames =
 		ncOut.add_var("eb_names", ncChar, dimNumElementBlocks, dimLenString);
 
 	// Element map
+	NcVar * varElementMap =
+		ncOut.add_var("elem_map", ncInt, dimElements);
+	DefineNcVarStorage(&ncOut, varElementMap, nChunkFaces, options);
+
+	// Element block status
+	NcVar * varElementBlockStatus =
+		ncOut.add_var("eb_status", ncInt, dimNumElementBlocks);
+
+	NcVar * varElementProperty =
+		ncOut.add_var("eb_prop1", ncInt, dimNumElementBlocks);
+	varElementProperty->add_att("name", "ID");
+
+	// Attributes
+	NcVar * varAttrib1 =
+		ncOut.add_var("attrib1", ncDouble, dimElementBlock1, dimAttBlock1);
+	DefineNcVarStorage(&ncOut, varAttrib1, nChunkAttrib1, options);
+
+	// Face nodes (1-indexed)
+	NcVar * varFaces =
+		ncOut.add_var("connect1", ncInt, dimElementBlock1, dimNodesPerElement);
+
+	varFaces->add_att("elem_type", "SHELL4");
+	DefineNcVarStorage(&ncOut, varFaces, nChunkFaces, options);
+
+	// Node list
+	NcVar * varNodes =
+		ncOut.add_var("coord", ncDouble, dimDimension, dimNodes);
+	DefineNcVarStorage(&ncOut, varNodes, nChunkNodes, options);
+
+	// Edge types
+	NcVar * varEdgeTypes =
+		ncOut.add_var("edge_type", ncInt,
+			dimElementBlock1, dimNodesPerElement);
+	DefineNcVarStorage(&ncOut, varEdgeTypes, nChunkFaces, options);
+
+	// Source elements from mesh 1
+	NcVar * varFirstMeshSourceFace = NULL;
+	if (vecFirstFaceIx.size() != 0) {
+		varFirstMeshSourceFace =
+			ncOut.add_var("face_source_1", ncInt, dimElementBlock1);
+		DefineNcVarStorage(
+			&ncOut, varFirstMeshSourceFace, nChunkFaces, options);
+	}
+
+	// Source elements from mesh 2
+	NcVar * varSecondMeshSourceFace = NULL;
+	if (vecSecondFaceIx.size() != 0) {
+		varSecondMeshSourceFace =
+			ncOut.add_var("face_source_2", ncInt, dimElementBlock1);
+		DefineNcVarStorage(
+			&ncOut, varSecondMeshSourceFace, nChunkFaces, options);
+	}
+
+	// Write QA records
+	char szQARecord[ParamFour][ParamLenString] = {
+		"Tempest", "13.0", "01/01/2013", "00:00:00"};
+
+	varQARecords->set_cur(0, 0, 0);
+	varQARecords->put(&(szQARecord[0][0]), 1, 4, ParamLenString);
+
+	// Write coordinate names
+	char szCoordNames[3][ParamLenString] = {"x", "y", "z"};
+
+	varCoordNames->set_cur(0, 0, 0);
+	varCoordNames->put(&(szCoordNames[0][0]), 3, ParamLenString);
+
+	// Write element map
 	int * nElementMap = new int[nElementCount];
 	for (int i = 0; i < nElementCount; i++) {
 		nElementMap[i] = i+1;
-	}
-
-	NcVar * varElementMap =
-		ncOut.add_var("elem_map", ncInt, dimElements);
+	}
 	varElementMap->put(nElementMap, nElementCount);
 
 	delete[] nElementMap;
 
-	// Element block status
+	// Write element block status
 	int nOne = 1;
 
-	NcVar * varElementBlockStatus =
-		ncOut.add_var("eb_status", ncInt, dimNumElementBlocks);
 	varElementBlockStatus->put(&nOne, 1);
-
-	NcVar * varElementProperty =
-		ncOut.add_var("eb_prop1", ncInt, dimNumElementBlocks);
 	varElementProperty->put(&nOne, 1);
-	varElementProperty->add_att("name", "ID");
 
-	// Attributes
+	// Write attributes
 	double * dAttrib1 = new double[nElementCount];
 	for (int i = 0; i < nElementCount; i++) {
 		dAttrib1[i] = 1.0;
 	}
-
-	NcVar * varAttrib1 =
-		ncOut.add_var("attrib1", ncDouble, dimElementBlock1, dimAttBlock1);
 	varAttrib1->put(dAttrib1, nElementCount, 1);
 	delete[] dAttrib1;
 
-	// Face nodes (1-indexed)
-	NcVar * varFaces =
-		ncOut.add_var("connect1", ncInt, dimElementBlock1, dimNodesPerElement);
+	// Write Face nodes and Edge types in blocks of Faces
+	const int ChunkSize = MeshStreamWriter::ChunkSize;
 
-	varFaces->add_att("elem_type", "SHELL4");
+	DataMatrix<int> nConnect;
+	DataMatrix<int> nEdgeType;
 
-	int * nConnect = new int[nNodesPerElement];
-	for (int i = 0; i < nElementCount; i++) {
-		int nEdges = faces[i].edges.size();
-		int k = 0;
-		for (; k < nEdges; k++) {
-			nConnect[k] = faces[i][k] + 1;
+	if ((nElementCount != 0) && (nNodesPerElement != 0)) {
+		nConnect.Initialize(ChunkSize, nNodesPerElement);
+		nEdgeType.Initialize(ChunkSize, nNodesPerElement);
+	}
+
+	for (int i = 0; i < nElementCount; i += ChunkSize) {
+		int nChunk =
+			(i + ChunkSize > nElementCount)?(nElementCount - i):(ChunkSize);
+
+		if (nNodesPerElement == 0) {
+			break;
 		}
-		for (; k < nNodesPerElement; k++) {
-			nConnect[k] = nConnect[nEdges-1];
+
+#pragma omp parallel for schedule(static)
+		for (int j = 0; j < nChunk; j++) {
+			const Face & face = faces[i+j];
+
+			int nEdges = face.edges.size();
+			int k = 0;
+			for (; k < nEdges; k++) {
+				nConnect[j][k] = face[k] + 1;
+				nEdgeType[j][k] = static_cast<int>(face.edges[k].type);
+			}
+
+			// Padded Edges carry the type of the last Edge, which is the
+			// type of the closing Edge once the Face is read back
+			for (; k < nNodesPerElement; k++) {
+				nConnect[j][k] = nConnect[j][nEdges-1];
+				nEdgeType[j][k] = nEdgeType[j][nEdges-1];
+			}
 		}
 
 		varFaces->set_cur(i, 0);
-		varFaces->put(nConnect, 1, nNodesPerElement);
-	}
+		varFaces->put(&(nConnect[0][0]), nChunk, nNodesPerElement);
 
-	delete[] nConnect;
+		varEdgeTypes->set_cur(i, 0);
+		varEdgeTypes->put(&(nEdgeType[0][0]), nChunk, nNodesPerElement);
 
-	// Node list
-	NcVar * varNodes =
-		ncOut.add_var("coord", ncDouble, dimDimension, dimNodes);
+		s_counterBytesWritten.Add(
+			sizeof(int) * static_cast<long long>(nChunk) * nNodesPerElement);
+	}
 
+	// Write Node list
 	double * dCoord = new double[nNodeCount];
 	for (int i = 0; i < nNodeCount; i++) {
 		dCoord[i] = static_cast<double>(nodes[i].x);
@@ -371,43 +1577,16 @@ void Mesh::Write(const std::string & strFile) const {
 	varNodes->put(dCoord, 1, nNodeCount);
 	delete[] dCoord;
 
-	// Edge types
-	NcVar * varEdgeTypes =
-		ncOut.add_var("edge_type", ncInt,
-			dimElementBlock1, dimNodesPerElement);
-
-	int * nEdgeType = new int[nNodesPerElement];
-	for (int i = 0; i < nElementCount; i++) {
-		for (int k = 0; k < nNodesPerElement; k++) {
-			nEdgeType[k] = static_cast<int>(faces[i].edges[k].type);
-		}
-		varEdgeTypes->set_cur(i, 0);
-		varEdgeTypes->put(nEdgeType, 1, nNodesPerElement);
-	}
-	delete[] nEdgeType;
-
-	// Source elements from mesh 1
-	if (vecFirstFaceIx.size() != 0) {
-		if (vecFirstFaceIx.size() != nElementCount) {
-			_EXCEPTIONT("Incorrect size of vecFirstFaceIx");
-		}
-
-		NcVar * varFirstMeshSourceFace =
-			ncOut.add_var("face_source_1", ncInt, dimElementBlock1);
+	s_counterBytesWritten.Add(3 * sizeof(double) * nNodeCount);
 
+	// Write source elements from mesh 1
+	if (varFirstMeshSourceFace != NULL) {
 		varFirstMeshSourceFace->set_cur((long)0);
 		varFirstMeshSourceFace->put(&(vecFirstFaceIx[0]), nElementCount);
 	}
 
-	// Source elements from mesh 2
-	if (vecSecondFaceIx.size() != 0) {
-		if (vecSecondFaceIx.size() != nElementCount) {
-			_EXCEPTIONT("Incorrect size of vecSecondFaceIx");
-		}
-
-		NcVar * varSecondMeshSourceFace =
-			ncOut.add_var("face_source_2", ncInt, dimElementBlock1);
-
+	// Write source elements from mesh 2
+	if (varSecondMeshSourceFace != NULL) {
 		varSecondMeshSourceFace->set_cur((long)0);
 		varSecondMeshSourceFace->put(&(vecSecondFaceIx[0]), nElementCount);
 	}
@@ -415,13 +1594,27 @@ void Mesh::Write(const std::string & strFile) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::Read(const std::string & strFile) {
+void Mesh::Read(
+	const std::string & strFile,
+	bool fUseCache
+) {
 
 	// Try to open the NetCDF file
 	FILE * fp = fopen(strFile.c_str(), "r");
 	if (fp == NULL) {
 		_EXCEPTION1("Mesh file not found \"%s\"", strFile.c_str());
 	}
+	fclose(fp);
+
+	// Identify the source file for the binary cache
+	MeshCacheKey key;
+	if (fUseCache) {
+		GetMeshCacheKey(strFile, key);
+
+		if (ReadMeshCache(strFile, key, *this)) {
+			return;
+		}
+	}
 
 	// Input from a NetCDF Exodus file
 	NcFile ncFile(strFile.c_str(), NcFile::ReadOnly);
@@ -441,6 +1634,23 @@ void Mesh::Read(const std::string & strFile) {
 	// Output size
 	Announce("Mesh size: Nodes [%i] Elements [%i]", nNodeCount, nElementCount);
 
+	// Check for variables
+	bool fHasEdgeType = false;
+	bool fHasFirstMeshSourceFace = false;
+	bool fHasSecondMeshSourceFace = false;
+
+	for (int v = 0; v < ncFile.num_vars(); v++) {
+		if (strcmp(ncFile.get_var(v)->name(), "edge_type") == 0) {
+			fHasEdgeType = true;
+		}
+		if (strcmp(ncFile.get_var(v)->name(), "face_source_1") == 0) {
+			fHasFirstMeshSourceFace = true;
+		}
+		if (strcmp(ncFile.get_var(v)->name(), "face_source_2") == 0) {
+			fHasSecondMeshSourceFace = true;
+		}
+	}
+
 	// Load in node array
 	nodes.resize(nNodeCount);
 
@@ -449,10 +1659,14 @@ void Mesh::Read(const std::string & strFile) {
 	DataMatrix<double> dNodeCoords;
 	dNodeCoords.Initialize(3, nNodeCount);
 
-	// Load in node array
-	varNodes->set_cur(0, 0);
-	varNodes->get(&(dNodeCoords[0][0]), 3, nNodeCount);
+	if (nNodeCount != 0) {
+		varNodes->set_cur(0, 0);
+		varNodes->get(&(dNodeCoords[0][0]), 3, nNodeCount);
+	}
 
+	s_counterBytesRead.Add(3 * sizeof(double) * nNodeCount);
+
+#pragma omp parallel for schedule(static)
 	for (int i = 0; i < nNodeCount; i++) {
 		nodes[i].x = static_cast<Real>(dNodeCoords[0][i]);
 		nodes[i].y = static_cast<Real>(dNodeCoords[1][i]);
@@ -461,73 +1675,81 @@ void Mesh::Read(const std::string & strFile) {
 
 	dNodeCoords.Deinitialize();
 
-	// Load in face array
-	faces.resize(nElementCount, Face(nNodesPerElement));
-
-	NcVar * varFaces = ncFile.get_var("connect1");
-
+	// Load in face array and edge type array
 	DataMatrix<int> iFaceIndices;
 	iFaceIndices.Initialize(nElementCount, nNodesPerElement);
 
-	varFaces->set_cur(0, 0);
-	varFaces->get(&(iFaceIndices[0][0]), nElementCount, nNodesPerElement);
-
-	for (int i = 0; i < nElementCount; i++) {
-	for (int j = 0; j < nNodesPerElement; j++) {
-		faces[i].SetNode(j, iFaceIndices[i][j]-1);
-	}
-	}
-
-	iFaceIndices.Deinitialize();
+	DataMatrix<int> iEdgeTypes;
 
-	// Check for variables
-	bool fHasEdgeType = false;
-	bool fHasFirstMeshSourceFace = false;
-	bool fHasSecondMeshSourceFace = false;
+	if (nElementCount != 0) {
+		NcVar * varFaces = ncFile.get_var("connect1");
 
-	for (int v = 0; v < ncFile.num_vars(); v++) {
-		if (strcmp(ncFile.get_var(v)->name(), "edge_type") == 0) {
-			fHasEdgeType = true;
-		}
-		if (strcmp(ncFile.get_var(v)->name(), "face_source_1") == 0) {
-			fHasFirstMeshSourceFace = true;
-		}
-		if (strcmp(ncFile.get_var(v)->name(), "face_source_2") == 0) {
-			fHasSecondMeshSourceFace = true;
-		}
-	}
+		varFaces->set_cur(0, 0);
+		varFaces->get(&(iFaceIndices[0][0]), nElementCount, nNodesPerElement);
 
-	// Load in edge type array
-	if (fHasEdgeType) {
-		NcVar * varEdgeTypes = ncFile.get_var("edge_type");
+		s_counterBytesRead.Add(
+			sizeof(int) * static_cast<long long>(nElementCount) * nNodesPerElement);
 
-		DataMatrix<int> iEdgeTypes;
-		iEdgeTypes.Initialize(nElementCount, nNodesPerElement);
+		if (fHasEdgeType) {
+			NcVar * varEdgeTypes = ncFile.get_var("edge_type");
 
-		varEdgeTypes->set_cur(0, 0);
-		varEdgeTypes->get(&(iEdgeTypes[0][0]), nElementCount, nNodesPerElement);
+			iEdgeTypes.Initialize(nElementCount, nNodesPerElement);
 
-		for (int i = 0; i < nElementCount; i++) {
-		for (int j = 0; j < nNodesPerElement; j++) {
-			faces[i].edges[j].type = static_cast<Edge::Type>(iEdgeTypes[i][j]);
-		}
+			varEdgeTypes->set_cur(0, 0);
+			varEdgeTypes->get(
+				&(iEdgeTypes[0][0]), nElementCount, nNodesPerElement);
 		}
 	}
 
 	// Load in first mesh source face ix
+	vecFirstFaceIx.clear();
 	if (fHasFirstMeshSourceFace) {
 		NcVar * varFaceSource1 = ncFile.get_var("face_source_1");
 		vecFirstFaceIx.resize(nElementCount);
-		varFaceSource1->set_cur((long)0);
-		varFaceSource1->get(&(vecFirstFaceIx[0]), nElementCount);
+		if (nElementCount != 0) {
+			varFaceSource1->set_cur((long)0);
+			varFaceSource1->get(&(vecFirstFaceIx[0]), nElementCount);
+		}
 	}
 
 	// Load in second mesh source face ix
+	vecSecondFaceIx.clear();
 	if (fHasSecondMeshSourceFace) {
 		NcVar * varFaceSource2 = ncFile.get_var("face_source_2");
 		vecSecondFaceIx.resize(nElementCount);
-		varFaceSource2->set_cur((long)0);
-		varFaceSource2->get(&(vecSecondFaceIx[0]), nElementCount);
+		if (nElementCount != 0) {
+			varFaceSource2->set_cur((long)0);
+			varFaceSource2->get(&(vecSecondFaceIx[0]), nElementCount);
+		}
+	}
+
+	// Build the Faces
+	SetFacesFromArrays(
+		*this,
+		nElementCount,
+		nNodesPerElement,
+		(nElementCount == 0)?(NULL):(&(iFaceIndices[0][0])),
+		(fHasEdgeType && (nElementCount != 0))?(&(iEdgeTypes[0][0])):(NULL),
+		1);
+
+	// Store the arrays in the binary cache
+	if (fUseCache) {
+		WriteMeshCache(
+			strFile,
+			key,
+			*this,
+			nNodesPerElement,
+			(nElementCount == 0)?(NULL):(&(iFaceIndices[0][0])),
+			(fHasEdgeType && (nElementCount != 0))?
+				(&(iEdgeTypes[0][0])):(NULL));
+	}
+
+	// Index the Faces of an overlap mesh by first and second mesh Face
+	if (fHasFirstMeshSourceFace && fHasSecondMeshSourceFace) {
+		ConstructOverlapIndex();
+	} else {
+		firstfaceindex.Clear();
+		secondfaceindex.Clear();
 	}
 }
 
@@ -543,118 +1765,112 @@ void Mesh::RemoveZeroEdges() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::Validate() const {
-
-	// Valid that Nodes have magnitude 1
-	for (int i = 0; i < nodes.size(); i++) {
-		double dMag = nodes[i].Magnitude();
-
-		if (fabs(dMag - 1.0) > ReferenceTolerance) {
-			_EXCEPTION2("Mesh validation failed: "
-				"Node of non-unit magnitude detected (%i, %1.10e)",
-				i, dMag);
-
-		}
-	}
-
-	// Validate that edges are oriented counter-clockwise
-	for (int i = 0; i < faces.size(); i++) {
-		const Face & face = faces[i];
-
-		const int nEdges = face.edges.size();
+///	<summary>
+///		Validate that the Edges of Face i are cyclic and oriented
+///		counter-clockwise.
+///	</summary>
+static void ValidateFace(
+	const Face & face,
+	const NodeVector & nodes,
+	int i
+) {
+	const int nEdges = face.edges.size();
 
-		for (int j = 0; j < nEdges; j++) {
+	for (int j = 0; j < nEdges; j++) {
 
-			// Check for zero edges
-			for(;;) {
-				if (face.edges[j][0] == face.edges[j][1]) {
-					j++;
-				} else {
-					break;
-				}
-				if (j == nEdges) {
-					break;
-				}
+		// Check for zero edges
+		for(;;) {
+			if (face.edges[j][0] == face.edges[j][1]) {
+				j++;
+			} else {
+				break;
 			}
-
 			if (j == nEdges) {
 				break;
 			}
+		}
 
-			// Find the next non-zero edge
-			int jNext = (j + 1) % nEdges;
+		if (j == nEdges) {
+			break;
+		}
 
-			for(;;) {
-				if (face.edges[jNext][0] == face.edges[jNext][1]) {
-					jNext++;
-				} else {
-					break;
-				}
-				if (jNext == nEdges) {
-					jNext = 0;
-				}
-				if (jNext == ((j + 1) % nEdges)) {
-					_EXCEPTIONT("Mesh validation failed: "
-						"No edge information on Face");
-				}
+		// Find the next non-zero edge
+		int jNext = (j + 1) % nEdges;
+
+		for(;;) {
+			if (face.edges[jNext][0] == face.edges[jNext][1]) {
+				jNext++;
+			} else {
+				break;
+			}
+			if (jNext == nEdges) {
+				jNext = 0;
 			}
+			if (jNext == ((j + 1) % nEdges)) {
+				_EXCEPTIONT("Mesh validation failed: "
+					"No edge information on Face");
+			}
+		}
 
-			// Get edges
-			const Edge & edge0 = face.edges[j];
-			const Edge & edge1 = face.edges[(j + 1) % nEdges];
+		// Get edges
+		const Edge & edge0 = face.edges[j];
+		const Edge & edge1 = face.edges[(j + 1) % nEdges];
 
-			if (edge0[1] != edge1[0]) {
-				_EXCEPTIONT("Mesh validation failed: Edge cyclicity error");
-			}
+		if (edge0[1] != edge1[0]) {
+			_EXCEPTIONT("Mesh validation failed: Edge cyclicity error");
+		}
 
-			const Node & node0 = nodes[edge0[0]];
-			const Node & node1 = nodes[edge0[1]];
-			const Node & node2 = nodes[edge1[1]];
+		const Node & node0 = nodes[edge0[0]];
+		const Node & node1 = nodes[edge0[1]];
+		const Node & node2 = nodes[edge1[1]];
 
-			// Vectors along edges
-			Node nodeD1 = node0 - node1;
-			Node nodeD2 = node2 - node1;
+		// Vectors along edges
+		Node nodeD1 = node0 - node1;
+		Node nodeD2 = node2 - node1;
 
-			// Compute cross-product
-			Node nodeCross(CrossProduct(nodeD1, nodeD2));
+		// Compute cross-product
+		Node nodeCross(CrossProduct(nodeD1, nodeD2));
 
-			// Dot cross product with radial vector
-			Real dDot = DotProduct(node1, nodeCross);
+		// Dot cross product with radial vector
+		Real dDot = DotProduct(node1, nodeCross);
 /*
 #ifdef USE_EXACT_ARITHMETIC
-			FixedPoint dDotX = DotProductX(node1, nodeCross);
-
-			printf("%1.15e : ", nodeCross.x); nodeCross.fx.Print(); printf("\n");
-
-			if (fabs(nodeCross.x - nodeCross.fx.ToReal()) > ReferenceTolerance) {
-				printf("X0: %1.15e : ", node0.x); node0.fx.Print(); printf("\n");
-				printf("Y0: %1.15e : ", node0.y); node0.fy.Print(); printf("\n");
-				printf("Z0: %1.15e : ", node0.z); node0.fz.Print(); printf("\n");
-				printf("X1: %1.15e : ", node1.x); node1.fx.Print(); printf("\n");
-				printf("Y1: %1.15e : ", node1.y); node1.fy.Print(); printf("\n");
-				printf("Z1: %1.15e : ", node1.z); node1.fz.Print(); printf("\n");
-				printf("X2: %1.15e : ", node2.x); node2.fx.Print(); printf("\n");
-				printf("Y2: %1.15e : ", node2.y); node2.fy.Print(); printf("\n");
-				printf("Z2: %1.15e : ", node2.z); node2.fz.Print(); printf("\n");
-
-				printf("X1: %1.15e : ", nodeD1.x); nodeD1.fx.Print(); printf("\n");
-				printf("Y1: %1.15e : ", nodeD1.y); nodeD1.fy.Print(); printf("\n");
-				printf("Z1: %1.15e : ", nodeD1.z); nodeD1.fz.Print(); printf("\n");
-				printf("X2: %1.15e : ", nodeD2.x); nodeD2.fx.Print(); printf("\n");
-				printf("Y2: %1.15e : ", nodeD2.y); nodeD2.fy.Print(); printf("\n");
-				printf("Z2: %1.15e : ", nodeD2.z); nodeD2.fz.Print(); printf("\n");
-				_EXCEPTIONT("FixedPoint mismatch (X)");
-			}
-			if (fabs(nodeCross.y - nodeCross.fy.ToReal()) > ReferenceTolerance) {
-				_EXCEPTIONT("FixedPoint mismatch (Y)");
-			}
-			if (fabs(nodeCross.z - nodeCross.fz.ToReal()) > ReferenceTolerance) {
-				_EXCEPTIONT("FixedPoint mismatch (Z)");
-			}
+		FixedPoint dDotX = DotProductX(node1, nodeCross);
+
+		printf("%1.15e : ", nodeCross.x); nodeCross.fx.Print(); printf("\n");
+
+		if (fabs(nodeCross.x - nodeCross.fx.ToReal()) > ReferenceTolerance) {
+			printf("X0: %1.15e : ", node0.x); node0.fx.Print(); printf("\n");
+			printf("Y0: %1.15e : ", node0.y); node0.fy.Print(); printf("\n");
+			printf("Z0: %1.15e : ", node0.z); node0.fz.Print(); printf("\n");
+			printf("X1: %1.15e : ", node1.x); node1.fx.Print(); printf("\n");
+			printf("Y1: %1.15e : ", node1.y); node1.fy.Print(); printf("\n");
+			printf("Z1: %1.15e : ", node1.z); node1.fz.Print(); printf("\n");
+			printf("X2: %1.15e : ", node2.x); node2.fx.Print(); printf("\n");
+			printf("Y2: %1.15e : ", node2.y); node2.fy.Print(); printf("\n");
+			printf("Z2: %1.15e : ", node2.z); node2.fz.Print(); printf("\n");
+
+			printf("X1: %1.15e : ", nodeD1.x); nodeD1.fx.Print(); printf("\n");
+			printf("Y1: %1.15e : ", nodeD1.y); nodeD1.fy.Print(); printf("\n");
+			printf("Z1: %1.15e : ", nodeD1.z); nodeD1.fz.Print(); printf("\n");
+			printf("X2: %1.15e : ", nodeD2.x); nodeD2.fx.Print(); printf("\n");
+			printf("Y2: %1.15e : ", nodeD2.y); nodeD2.fy.Print(); printf("\n");
+			printf("Z2: %1.15e : ", nodeD2.z); nodeD2.fz.Print(); printf("\n");
+			_EXCEPTIONT("FixedPoint mismatch (X)");
+		}
+		if (fabs(nodeCross.y - nodeCross.fy.ToReal()) > ReferenceTolerance) {
+			_EXCEPTIONT("FixedPoint mismatch (Y)");
+		}
+		if (fabs(nodeCross.z - nodeCross.fz.ToReal()) > ReferenceTolerance) {
+			_EXCEPTIONT("FixedPoint mismatch (Z)");
+		}
 
 #endif
 */
-			if (dDot > 0.0) {
+		if (dDot > 0.0) {
+			// Diagnostics of Faces validated in parallel are not interleaved
+#pragma omp critical(Announce)
+			{
 				printf("\nError detected (orientation):\n");
 				printf("  Face %i, Edge %i, Orientation %1.5e\n",
 					i, j, dDot);
@@ -687,12 +1903,56 @@ void Mesh::Validate() const {
 				printf("  X-Product:\n");
 				printf("    %1.5e %1.5e %1.5e\n",
 					nodeCross.x, nodeCross.y, nodeCross.z);
+			}
+
+			_EXCEPTIONT(
+				"Mesh validation failed: Clockwise element detected");
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::Validate() const {
+
+	int nNodes = static_cast<int>(nodes.size());
+	int nFaces = static_cast<int>(faces.size());
+
+	// Exception raised while validating Nodes or Faces; the exception of
+	// the first invalid Node or Face is raised, as in a serial pass
+	FaceLoopException exValidate;
+
+	// Valid that Nodes have magnitude 1
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nNodes; i++) {
+		double dMag = nodes[i].Magnitude();
+
+		if (fabs(dMag - 1.0) > ReferenceTolerance) {
+			try {
+				_EXCEPTION2("Mesh validation failed: "
+					"Node of non-unit magnitude detected (%i, %1.10e)",
+					i, dMag);
 
-				_EXCEPTIONT(
-					"Mesh validation failed: Clockwise element detected");
+			} catch(Exception & e) {
+				exValidate.Record(i, e);
 			}
 		}
 	}
+
+	exValidate.Rethrow();
+
+	// Validate that edges are oriented counter-clockwise
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nFaces; i++) {
+		try {
+			ValidateFace(faces[i], nodes, i);
+
+		} catch(Exception & e) {
+			exValidate.Record(i, e);
+		}
+	}
+
+	exValidate.Rethrow();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -833,21 +2093,20 @@ void EqualizeCoincidentNodes(
 ) {
 	int nCoincidentNodes = 0;
 
-	// Sort nodes
-	std::map<Node, int> setSortedFirstNodes;
-	for (int i = 0; i < meshFirst.nodes.size(); i++) {
-		setSortedFirstNodes.insert(
-			std::pair<Node, int>(meshFirst.nodes[i], i));
-	}
+	// Hash nodes
+	NodeSpatialHash hashFirstNodes;
+	hashFirstNodes.Initialize(meshFirst.nodes);
 
 	// For each node in meshSecond determine if a corresponding node
 	// exists in meshFirst.
-	for (int i = 0; i < meshSecond.nodes.size(); i++) {
-		std::map<Node, int>::const_iterator iter =
-			setSortedFirstNodes.find(meshSecond.nodes[i]);
+	int nSecondNodes = static_cast<int>(meshSecond.nodes.size());
 
-		if (iter != setSortedFirstNodes.end()) {
-			meshSecond.nodes[i] = iter->first;
+#pragma omp parallel for
+	for (int i = 0; i < nSecondNodes; i++) {
+		int ixFirstNode = hashFirstNodes.Find(meshSecond.nodes[i]);
+
+		if (ixFirstNode != InvalidNode) {
+			meshSecond.nodes[i] = meshFirst.nodes[ixFirstNode];
 		}
 	}
 }
@@ -859,18 +2118,18 @@ void EqualizeCoincidentNodes(
 ) {
 	int nCoincidentNodes = 0;
 
-	// Sort nodes
-	std::map<Node, int> mapSortedNodes;
+	// Hash nodes
+	NodeSpatialHash hashNodes;
+	hashNodes.Clear(static_cast<int>(mesh.nodes.size()));
+
 	for (int i = 0; i < mesh.nodes.size(); i++) {
-		std::map<Node, int>::const_iterator iter =
-			mapSortedNodes.find(mesh.nodes[i]);
+		int ixNode = hashNodes.Find(mesh.nodes[i]);
 
-		if (iter != mapSortedNodes.end()) {
+		if (ixNode != InvalidNode) {
 			nCoincidentNodes++;
-			mesh.nodes[i] = iter->first;
+			mesh.nodes[i] = mesh.nodes[ixNode];
 		} else {
-			mapSortedNodes.insert(
-				std::pair<Node, int>(mesh.nodes[i], i));
+			hashNodes.Insert(mesh.nodes[i], i);
 		}
 	}
 
@@ -886,24 +2145,23 @@ int BuildCoincidentNodeVector(
 ) {
 	int nCoincidentNodes = 0;
 
-	// Sort nodes
-	std::map<Node, int> setSortedFirstNodes;
-	for (int i = 0; i < meshFirst.nodes.size(); i++) {
-		setSortedFirstNodes.insert(
-			std::pair<Node, int>(meshFirst.nodes[i], i));
-	}
+	// Hash nodes
+	NodeSpatialHash hashFirstNodes;
+	hashFirstNodes.Initialize(meshFirst.nodes);
 
 	// Resize array
 	vecSecondToFirstCoincident.resize(meshSecond.nodes.size(), InvalidNode);
 
 	// For each node in meshSecond determine if a corresponding node
 	// exists in meshFirst.
-	for (int i = 0; i < meshSecond.nodes.size(); i++) {
-		std::map<Node, int>::const_iterator iter =
-			setSortedFirstNodes.find(meshSecond.nodes[i]);
+	int nSecondNodes = static_cast<int>(meshSecond.nodes.size());
+
+#pragma omp parallel for reduction(+:nCoincidentNodes)
+	for (int i = 0; i < nSecondNodes; i++) {
+		int ixFirstNode = hashFirstNodes.Find(meshSecond.nodes[i]);
 
-		if (iter != setSortedFirstNodes.end()) {
-			vecSecondToFirstCoincident[i] = iter->second;
+		if (ixFirstNode != InvalidNode) {
+			vecSecondToFirstCoincident[i] = ixFirstNode;
 			nCoincidentNodes++;
 		}
 	}
@@ -913,101 +2171,168 @@ int BuildCoincidentNodeVector(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Contribution of the Edge from Node 1 to Node 2 to the area of a
+///		Face, using Karney's method.
+///	</summary>
+///	<remarks>
+///		http://osgeo-org.1560.x6.nabble.com/Area-of-a-spherical-polygon-td3841625.html
+///	</remarks>
+static inline double CalculateEdgeAreaExcess(
+	double dLon1,
+	double dLamLat1,
+	double dLon2,
+	double dLamLat2
+) {
+	if ((dLon1 < -0.5 * M_PI) && (dLon2 > 0.5 * M_PI)) {
+		dLon1 += 2.0 * M_PI;
+	}
+	if ((dLon2 < -0.5 * M_PI) && (dLon1 > 0.5 * M_PI)) {
+		dLon2 += 2.0 * M_PI;
+	}
+
+	double dS = tan(0.5 * (dLon2 - dLon1))
+		* tanh(0.5 * (dLamLat1 + dLamLat2));
+
+	return 2.0 * atan(dS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 Real CalculateFaceArea(
 	const Face & face,
 	const NodeVector & nodes
 ) {
-	const Real Tolerance = ReferenceTolerance;
-
-	double dAccumulatedExcess = 0.0;
-
 	int nEdges = static_cast<int>(face.edges.size());
 
 	double dFaceArea = 0.0;
 
 	for (int j = 0; j < nEdges; j++) {
-
-		// Get Nodes bounding this Node
-		int jPrev = (j + nEdges - 1) % nEdges;
 		int jNext = (j + 1) % nEdges;
 
-		const Node & node0 = nodes[face[jPrev]];
 		const Node & node1 = nodes[face[j]];
 		const Node & node2 = nodes[face[jNext]];
 
-		// Calculate area using Karney's method
-		// http://osgeo-org.1560.x6.nabble.com/Area-of-a-spherical-polygon-td3841625.html
 		double dLon1 = atan2(node1.y, node1.x);
 		double dLat1 = asin(node1.z);
 
 		double dLon2 = atan2(node2.y, node2.x);
 		double dLat2 = asin(node2.z);
 
-		if ((dLon1 < -0.5 * M_PI) && (dLon2 > 0.5 * M_PI)) {
-			dLon1 += 2.0 * M_PI;
-		}
-		if ((dLon2 < -0.5 * M_PI) && (dLon1 > 0.5 * M_PI)) {
-			dLon2 += 2.0 * M_PI;
-		}
-
 		double dLamLat1 = 2.0 * atanh(tan(dLat1 / 2.0));
 		double dLamLat2 = 2.0 * atanh(tan(dLat2 / 2.0));
 
-		double dS = tan(0.5 * (dLon2 - dLon1))
-			* tanh(0.5 * (dLamLat1 + dLamLat2));
+		dFaceArea -=
+			CalculateEdgeAreaExcess(dLon1, dLamLat1, dLon2, dLamLat2);
+	}
 
-		dFaceArea -= 2.0 * atan(dS);
-/*
-		// Calculate angle between Nodes
-		Real dDotN0N1 = DotProduct(node0, node1);
-		Real dDotN0N2 = DotProduct(node0, node2);
-		Real dDotN2N1 = DotProduct(node2, node1);
+	if (dFaceArea < 0.0) {
+		dFaceArea += 2.0 * M_PI;
+	}
 
-		Real dDotN0N0 = DotProduct(node0, node0);
-		Real dDotN1N1 = DotProduct(node1, node1);
-		Real dDotN2N2 = DotProduct(node2, node2);
+	return dFaceArea;
+}
 
-		Real dDenom0 = dDotN0N0 * dDotN1N1 - dDotN0N1 * dDotN0N1;
-		Real dDenom2 = dDotN2N2 * dDotN1N1 - dDotN2N1 * dDotN2N1;
+///////////////////////////////////////////////////////////////////////////////
 
-		if ((dDenom0 < Tolerance) || (dDenom2 < Tolerance)) {
-			continue;
-		}
+void CalculateNodeAreaCoordinates(
+	const NodeVector & nodes,
+	std::vector<double> & dLon,
+	std::vector<double> & dLamLat
+) {
+	int nNodes = static_cast<int>(nodes.size());
 
-		// Angle between nodes
-		double dDenom = sqrt(dDenom0 * dDenom2);
+	dLon.resize(nNodes);
+	dLamLat.resize(nNodes);
 
-		double dRatio =
-			(dDotN1N1 * dDotN0N2 - dDotN0N1 * dDotN2N1) / dDenom;
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nNodes; i++) {
+		double dLat = asin(nodes[i].z);
 
-		if (dRatio > 1.0) {
-			dRatio = 1.0;
-		} else if (dRatio < -1.0) {
-			dRatio = -1.0;
-		}
+		dLon[i] = atan2(nodes[i].y, nodes[i].x);
+		dLamLat[i] = 2.0 * atanh(tan(dLat / 2.0));
+	}
+}
 
-		dAccumulatedExcess += acos(dRatio);
-*/
-		//printf("[%1.15e %1.15e %1.15e],\n", node1.x, node1.y, node1.z);
-		//printf("%1.15e %1.15e\n",  dDotN1N1, dDotN2N2);
+///////////////////////////////////////////////////////////////////////////////
 
-	}
+Real CalculateFaceArea(
+	const Face & face,
+	const double * dLon,
+	const double * dLamLat
+) {
+	int nEdges = static_cast<int>(face.edges.size());
+
+	double dFaceArea = 0.0;
+
+	for (int j = 0; j < nEdges; j++) {
+		int ixNode1 = face[j];
+		int ixNode2 = face[(j + 1) % nEdges];
 
-	//double dPlanarSum = static_cast<double>(nEdges-2) * M_PI;
+		dFaceArea -= CalculateEdgeAreaExcess(
+			dLon[ixNode1], dLamLat[ixNode1],
+			dLon[ixNode2], dLamLat[ixNode2]);
+	}
 
 	if (dFaceArea < 0.0) {
 		dFaceArea += 2.0 * M_PI;
-		//printf("%1.15e %1.15e\n", dFaceArea, dAccumulatedExcess - dPlanarSum);
-		//_EXCEPTIONT("Negative area element detected");
 	}
-/*
-	if (dPlanarSum > dAccumulatedExcess) {
-		printf("%1.15e %1.15e\n", dPlanarSum, dAccumulatedExcess);
-		_EXCEPTIONT("Negative area element detected");
-	}
-*/
+
 	return dFaceArea;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+double CompensatedSum(
+	const double * dValues,
+	int nValues
+) {
+	static const int BlockSize = 4096;
+
+	int nBlocks = (nValues + BlockSize - 1) / BlockSize;
+
+	std::vector<double> dBlockSum(nBlocks);
+	std::vector<double> dBlockCorrection(nBlocks);
+
+	// Neumaier summation of each block
+#pragma omp parallel for schedule(static)
+	for (int b = 0; b < nBlocks; b++) {
+		int iEnd = std::min(nValues, (b + 1) * BlockSize);
+
+		double dSum = 0.0;
+		double dCorrection = 0.0;
+
+		for (int i = b * BlockSize; i < iEnd; i++) {
+			double dNewSum = dSum + dValues[i];
+			if (fabs(dSum) >= fabs(dValues[i])) {
+				dCorrection += (dSum - dNewSum) + dValues[i];
+			} else {
+				dCorrection += (dValues[i] - dNewSum) + dSum;
+			}
+			dSum = dNewSum;
+		}
+
+		dBlockSum[b] = dSum;
+		dBlockCorrection[b] = dCorrection;
+	}
+
+	// Neumaier summation of the block sums, in order
+	double dSum = 0.0;
+	double dCorrection = 0.0;
+
+	for (int b = 0; b < nBlocks; b++) {
+		double dNewSum = dSum + dBlockSum[b];
+		if (fabs(dSum) >= fabs(dBlockSum[b])) {
+			dCorrection += (dSum - dNewSum) + dBlockSum[b];
+		} else {
+			dCorrection += (dBlockSum[b] - dNewSum) + dSum;
+		}
+		dSum = dNewSum;
+		dCorrection += dBlockCorrection[b];
+	}
+
+	return (dSum + dCorrection);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -21,6 +21,7 @@
 
 #include "Defines.h"
 
+#include <cstdint>
 #include <vector>
 #include <set>
 #include <map>
@@ -29,6 +30,7 @@
 
 #include "Exception.h"
 #include "DataVector.h"
+#include "NetCDFUtilities.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -154,6 +156,142 @@ typedef std::map<Node, int> NodeMap;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		A spatial hash of Nodes on a uniform grid, used to find the Node
+///		which is coincident with a given Node.  Two Nodes are coincident if
+///		each of their coordinates differ by less than the tolerance, which
+///		matches the equivalence used by Node::operator<.
+///	</summary>
+class NodeSpatialHash {
+
+public:
+	///	<summary>
+	///		Default tolerance used for determining coincident Nodes.
+	///	</summary>
+	static const Real DefaultTolerance;
+
+protected:
+	///	<summary>
+	///		An entry in the hash table.
+	///	</summary>
+	struct Entry {
+		int iCell[3];
+		int ix;
+		Real x;
+		Real y;
+		Real z;
+	};
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	NodeSpatialHash(
+		Real dTolerance = DefaultTolerance
+	);
+
+	///	<summary>
+	///		Remove all Nodes and reserve space for nNodes Nodes.
+	///	</summary>
+	void Clear(
+		int nNodes = 0
+	);
+
+	///	<summary>
+	///		Remove all Nodes and insert all Nodes of nodes, indexed by their
+	///		position in the vector.
+	///	</summary>
+	void Initialize(
+		const NodeVector & nodes
+	);
+
+	///	<summary>
+	///		Insert a Node with index ix.
+	///	</summary>
+	void Insert(
+		const Node & node,
+		int ix
+	);
+
+	///	<summary>
+	///		Find the smallest index of all Nodes coincident with node, or
+	///		InvalidNode if no such Node has been inserted.
+	///	</summary>
+	int Find(
+		const Node & node
+	) const;
+
+	///	<summary>
+	///		Number of Nodes in the hash.
+	///	</summary>
+	int GetSize() const {
+		return m_nEntries;
+	}
+
+protected:
+	///	<summary>
+	///		Index of the grid cell containing the given coordinate.
+	///	</summary>
+	inline int GetCell(Real d) const {
+		return static_cast<int>(floor(d * m_dInvCellWidth));
+	}
+
+	///	<summary>
+	///		Hash table slot for the given grid cell.
+	///	</summary>
+	inline size_t GetSlot(const int iCell[3]) const {
+		uint64_t nHash =
+			  static_cast<uint64_t>(static_cast<uint32_t>(iCell[0]))
+				* 0x9E3779B97F4A7C15ULL
+			^ static_cast<uint64_t>(static_cast<uint32_t>(iCell[1]))
+				* 0xC2B2AE3D27D4EB4FULL
+			^ static_cast<uint64_t>(static_cast<uint32_t>(iCell[2]))
+				* 0x165667B19E3779F9ULL;
+
+		nHash ^= (nHash >> 29);
+
+		return static_cast<size_t>(nHash) & (m_vecEntries.size() - 1);
+	}
+
+	///	<summary>
+	///		Insert an Entry without checking the load factor.
+	///	</summary>
+	void InsertEntry(
+		const Entry & entry
+	);
+
+	///	<summary>
+	///		Resize the hash table to hold at least nNodes Nodes.
+	///	</summary>
+	void Reserve(
+		int nNodes
+	);
+
+protected:
+	///	<summary>
+	///		Tolerance used for determining coincident Nodes.
+	///	</summary>
+	Real m_dTolerance;
+
+	///	<summary>
+	///		Inverse of the width of each grid cell.
+	///	</summary>
+	Real m_dInvCellWidth;
+
+	///	<summary>
+	///		Number of Nodes in the hash.
+	///	</summary>
+	int m_nEntries;
+
+	///	<summary>
+	///		Open-addressed hash table with linear probing; empty entries
+	///		have index InvalidNode.
+	///	</summary>
+	std::vector<Entry> m_vecEntries;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		A node index.
 ///	</summary>
@@ -416,16 +554,6 @@ public:
 
 typedef std::vector<Edge> EdgeVector;
 
-typedef std::map<Edge, FacePair> EdgeMap;
-
-typedef EdgeMap::value_type EdgeMapPair;
-
-typedef EdgeMap::iterator EdgeMapIterator;
-
-typedef EdgeMap::const_iterator EdgeMapConstIterator;
-
-typedef std::vector<EdgeMap::iterator> EdgeMapIteratorVector;
-
 typedef std::set<Edge> EdgeSet;
 
 typedef std::pair<Edge, FacePair> EdgePair;
@@ -506,10 +634,357 @@ typedef std::vector<Face> FaceVector;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		A bounding volume hierarchy over the Faces of a Mesh.  Each Face is
+///		enclosed in a spherical cap, represented as a ball centered on the
+///		unit sphere, and caps are merged pairwise into a binary tree so that
+///		all Faces which may contain a given Node can be found in O(log N).
+///	</summary>
+class FaceCapTree {
+
+public:
+	///	<summary>
+	///		A single cap in the tree.  Leaf caps reference the range
+	///		[ixBegin, ixEnd) of the sorted Face index array.
+	///	</summary>
+	struct Cap {
+		Node center;
+		Real dRadius;
+		int ixBegin;
+		int ixEnd;
+		int ixChild[2];
+	};
+
+public:
+	///	<summary>
+	///		Remove all caps from the tree.
+	///	</summary>
+	void Clear() {
+		m_vecCaps.clear();
+		m_vecFaceIx.clear();
+	}
+
+	///	<summary>
+	///		Determine if the tree has been constructed.
+	///	</summary>
+	bool IsEmpty() const {
+		return (m_vecCaps.size() == 0);
+	}
+
+	///	<summary>
+	///		Construct the tree from the given Faces.
+	///	</summary>
+	void Construct(
+		const FaceVector & faces,
+		const NodeVector & nodes
+	);
+
+	///	<summary>
+	///		Find all Faces whose bounding cap contains the given Node.  The
+	///		returned Face indices are sorted in ascending order.
+	///	</summary>
+	void FindCandidateFaces(
+		const Node & node,
+		std::vector<int> & vecFaceIndices
+	) const;
+
+protected:
+	///	<summary>
+	///		Recursively build the subtree over the range [ixBegin, ixEnd)
+	///		of the Face index array, returning the index of its root cap.
+	///	</summary>
+	int ConstructSubtree(
+		const std::vector<Node> & vecFaceCenters,
+		const std::vector<Real> & vecFaceRadii,
+		int ixBegin,
+		int ixEnd
+	);
+
+protected:
+	///	<summary>
+	///		Caps in this tree; the root cap is stored at index 0.
+	///	</summary>
+	std::vector<Cap> m_vecCaps;
+
+	///	<summary>
+	///		Face indices, ordered so that each cap spans a contiguous range.
+	///	</summary>
+	std::vector<int> m_vecFaceIx;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		A reverse node array stores all faces associated with a given node.
+///		The Face indices of all Nodes are stored contiguously in compressed
+///		sparse row format, in ascending order for each Node.
 ///	</summary>
-typedef std::vector< std::set<int> > ReverseNodeArray;
+class ReverseNodeArray {
+
+public:
+	///	<summary>
+	///		Remove all entries from the array.
+	///	</summary>
+	void Clear() {
+		m_vecNodeBegin.clear();
+		m_vecFaceIx.clear();
+	}
+
+	///	<summary>
+	///		Determine if the array has been constructed.
+	///	</summary>
+	bool IsEmpty() const {
+		return (m_vecNodeBegin.size() == 0);
+	}
+
+	///	<summary>
+	///		Construct the array from the given Faces over nNodes Nodes.
+	///	</summary>
+	void Construct(
+		const FaceVector & faces,
+		int nNodes
+	);
+
+	///	<summary>
+	///		Number of Nodes in the array.
+	///	</summary>
+	int GetNodeCount() const {
+		return (m_vecNodeBegin.size() == 0)?(0):
+			(static_cast<int>(m_vecNodeBegin.size()) - 1);
+	}
+
+	///	<summary>
+	///		Number of Faces containing the given Node.
+	///	</summary>
+	int GetFaceCount(int ixNode) const {
+		return (m_vecNodeBegin[ixNode+1] - m_vecNodeBegin[ixNode]);
+	}
+
+	///	<summary>
+	///		Index of the i-th Face containing the given Node.
+	///	</summary>
+	int GetFace(int ixNode, int i) const {
+		return m_vecFaceIx[m_vecNodeBegin[ixNode] + i];
+	}
+
+protected:
+	///	<summary>
+	///		Index of the first Face of each Node, followed by the total
+	///		number of entries.
+	///	</summary>
+	std::vector<int> m_vecNodeBegin;
+
+	///	<summary>
+	///		Face indices of all Nodes.
+	///	</summary>
+	std::vector<int> m_vecFaceIx;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		An index from the Faces of a source mesh to the Faces of an overlap
+///		mesh, stored in compressed sparse row format.  The overlap Faces of
+///		each source Face are stored in ascending order.
+///	</summary>
+class OverlapFaceIndex {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OverlapFaceIndex() :
+		m_fContiguous(true)
+	{ }
+
+	///	<summary>
+	///		Remove all entries from the index.
+	///	</summary>
+	void Clear() {
+		m_vecSourceBegin.clear();
+		m_vecFaceIx.clear();
+		m_fContiguous = true;
+	}
+
+	///	<summary>
+	///		Determine if the index has been constructed.
+	///	</summary>
+	bool IsEmpty() const {
+		return (m_vecSourceBegin.size() == 0);
+	}
+
+	///	<summary>
+	///		Construct the index from the source Face index of each overlap
+	///		Face over nSourceFaces source Faces.  If nSourceFaces is negative
+	///		the number of source Faces is one more than the largest index.
+	///	</summary>
+	void Construct(
+		const std::vector<int> & vecSourceFaceIx,
+		int nSourceFaces = (-1)
+	);
+
+	///	<summary>
+	///		Number of source Faces in the index.
+	///	</summary>
+	int GetSourceFaceCount() const {
+		return (m_vecSourceBegin.size() == 0)?(0):
+			(static_cast<int>(m_vecSourceBegin.size()) - 1);
+	}
+
+	///	<summary>
+	///		Number of overlap Faces of the given source Face.
+	///	</summary>
+	int GetFaceCount(int ixSource) const {
+		return (m_vecSourceBegin[ixSource+1] - m_vecSourceBegin[ixSource]);
+	}
+
+	///	<summary>
+	///		Index of the i-th overlap Face of the given source Face.
+	///	</summary>
+	int GetFace(int ixSource, int i) const {
+		return m_vecFaceIx[m_vecSourceBegin[ixSource] + i];
+	}
+
+	///	<summary>
+	///		Determine if the overlap Faces of each source Face are stored
+	///		consecutively, in order of source Face.  In this case the i-th
+	///		overlap Face of ixSource is GetFace(ixSource, 0) + i.
+	///	</summary>
+	bool IsContiguous() const {
+		return m_fContiguous;
+	}
+
+protected:
+	///	<summary>
+	///		Index of the first entry of each source Face, followed by the
+	///		total number of entries.
+	///	</summary>
+	std::vector<int> m_vecSourceBegin;
+
+	///	<summary>
+	///		Overlap Face indices of all source Faces.
+	///	</summary>
+	std::vector<int> m_vecFaceIx;
+
+	///	<summary>
+	///		Flag indicating the source Face indices are sorted.
+	///	</summary>
+	bool m_fContiguous;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A table of all Edges of a mesh and the pair of Faces on either side
+///		of each Edge.  Edges are stored in a vector sorted by their ordered
+///		Node indices, which is the same order as a std::map<Edge, FacePair>,
+///		and are located by binary search on a packed 64-bit key.
+///	</summary>
+class EdgeMap {
+
+public:
+	typedef EdgePair value_type;
+
+	typedef EdgeMapVector::iterator iterator;
+
+	typedef EdgeMapVector::const_iterator const_iterator;
+
+public:
+	///	<summary>
+	///		Remove all Edges from the table.
+	///	</summary>
+	void clear() {
+		m_vecKeys.clear();
+		m_vecEdges.clear();
+	}
+
+	///	<summary>
+	///		Number of Edges in the table.
+	///	</summary>
+	size_t size() const {
+		return m_vecEdges.size();
+	}
+
+	///	<summary>
+	///		Iterators over all Edges, in ascending order of ordered Nodes.
+	///	</summary>
+	iterator begin() {
+		return m_vecEdges.begin();
+	}
+
+	const_iterator begin() const {
+		return m_vecEdges.begin();
+	}
+
+	iterator end() {
+		return m_vecEdges.end();
+	}
+
+	const_iterator end() const {
+		return m_vecEdges.end();
+	}
+
+	///	<summary>
+	///		Find the given Edge, irrespective of orientation.  Returns end()
+	///		if the Edge is not in the table.
+	///	</summary>
+	iterator find(const Edge & edge) {
+		return m_vecEdges.begin() + FindIndex(edge);
+	}
+
+	const_iterator find(const Edge & edge) const {
+		return m_vecEdges.begin() + FindIndex(edge);
+	}
+
+	///	<summary>
+	///		Construct the table from the given Faces over nNodes Nodes.
+	///		Zero Edges are ignored.  The Faces of each FacePair are in
+	///		ascending order and each Edge has the orientation it has in
+	///		the first of these Faces.
+	///	</summary>
+	void Construct(
+		const FaceVector & faces,
+		int nNodes
+	);
+
+protected:
+	///	<summary>
+	///		Pack the ordered Nodes of an Edge into a single key.
+	///	</summary>
+	static uint64_t PackKey(const Edge & edge) {
+		int ixNodeSmall;
+		int ixNodeBig;
+		edge.GetOrderedNodes(ixNodeSmall, ixNodeBig);
+
+		return ((static_cast<uint64_t>(static_cast<uint32_t>(ixNodeSmall)) << 32)
+			| static_cast<uint64_t>(static_cast<uint32_t>(ixNodeBig)));
+	}
+
+	///	<summary>
+	///		Index of the given Edge in m_vecEdges, or size() if the Edge is
+	///		not in the table.
+	///	</summary>
+	size_t FindIndex(const Edge & edge) const;
+
+protected:
+	///	<summary>
+	///		Packed key of each Edge.
+	///	</summary>
+	std::vector<uint64_t> m_vecKeys;
+
+	///	<summary>
+	///		Each Edge and its pair of Faces.
+	///	</summary>
+	EdgeMapVector m_vecEdges;
+};
+
+typedef EdgeMap::value_type EdgeMapPair;
+
+typedef EdgeMap::iterator EdgeMapIterator;
+
+typedef EdgeMap::const_iterator EdgeMapConstIterator;
+
+typedef std::vector<EdgeMap::iterator> EdgeMapIteratorVector;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -554,6 +1029,21 @@ public:
 	///	</summary>
 	ReverseNodeArray revnodearray;
 
+	///	<summary>
+	///		Index from first mesh Faces to the Faces of this overlap mesh.
+	///	</summary>
+	OverlapFaceIndex firstfaceindex;
+
+	///	<summary>
+	///		Index from second mesh Faces to the Faces of this overlap mesh.
+	///	</summary>
+	OverlapFaceIndex secondfaceindex;
+
+	///	<summary>
+	///		FaceCapTree for this mesh.
+	///	</summary>
+	FaceCapTree facetree;
+
 public:
 	///	<summary>
 	///		Default constructor.
@@ -564,8 +1054,11 @@ public:
 	///	<summary>
 	///		Constructor with input mesh parameter.
 	///	</summary>
-	Mesh(const std::string & strFile) {
-		Read(strFile);
+	Mesh(
+		const std::string & strFile,
+		bool fUseCache = false
+	) {
+		Read(strFile, fUseCache);
 	}
 
 public:
@@ -584,6 +1077,21 @@ public:
 	///	</summary>
 	void ConstructReverseNodeArray();
 
+	///	<summary>
+	///		Construct the first and second OverlapFaceIndex from the first
+	///		and second mesh Face indices, verifying all indices are in range.
+	///		If a Face count is negative it is inferred from the indices.
+	///	</summary>
+	void ConstructOverlapIndex(
+		int nFirstFaces = (-1),
+		int nSecondFaces = (-1)
+	);
+
+	///	<summary>
+	///		Construct the FaceCapTree from the NodeVector and FaceVector.
+	///	</summary>
+	void ConstructFaceTree();
+
 	///	<summary>
 	///		Calculate Face areas.
 	///	</summary>
@@ -602,14 +1110,24 @@ public:
 	void ExchangeFirstAndSecondMesh();
 
 	///	<summary>
-	///		Write the mesh to a NetCDF file.
+	///		Write the mesh to a NetCDF file.  In NetCDF-4 output the Faces
+	///		and Nodes are chunked in blocks along their largest dimension.
 	///	</summary>
-	void Write(const std::string & strFile) const;
+	void Write(
+		const std::string & strFile,
+		const NetCDFOutputOptions & options = NetCDFOutputOptions()
+	) const;
 
 	///	<summary>
-	///		Read the mesh to a NetCDF file.
+	///		Read the mesh from a NetCDF file.  If fUseCache is true the mesh
+	///		is read from the binary cache file strFile.cache when it matches
+	///		the size, modification time and header of strFile, and otherwise
+	///		the cache is written after the NetCDF file is read.
 	///	</summary>
-	void Read(const std::string & strFile);
+	void Read(
+		const std::string & strFile,
+		bool fUseCache = false
+	);
 
 	///	<summary>
 	///		Remove zero edges from all Faces.
@@ -775,6 +1293,37 @@ Real CalculateFaceArea(
 	const NodeVector & nodes
 );
 
+///	<summary>
+///		Calculate the longitude and conformal latitude of all Nodes, as
+///		required by CalculateFaceArea, into separate arrays.
+///	</summary>
+void CalculateNodeAreaCoordinates(
+	const NodeVector & nodes,
+	std::vector<double> & dLon,
+	std::vector<double> & dLamLat
+);
+
+///	<summary>
+///		Calculate the area of a single Face from the longitude and conformal
+///		latitude of its Nodes.  The result is identical to that of
+///		CalculateFaceArea with the Nodes themselves.
+///	</summary>
+Real CalculateFaceArea(
+	const Face & face,
+	const double * dLon,
+	const double * dLamLat
+);
+
+///	<summary>
+///		Calculate the compensated sum of an array.  The array is summed in
+///		blocks of fixed length, which are combined in order, so the result
+///		does not depend on the number of threads.
+///	</summary>
+double CompensatedSum(
+	const double * dValues,
+	int nValues
+);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #endif
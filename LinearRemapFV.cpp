@@ -15,17 +15,31 @@
 ///	</remarks>
 
 #include "LinearRemapFV.h"
+#include "LinearRemapSE0.h"
+#include "FaceQuadratureTable.h"
 #include "GridElements.h"
 #include "OfflineMap.h"
 #include "FiniteElementTools.h"
 #include "GaussLobattoQuadrature.h"
-#include "TriangularQuadrature.h"
+#include "DataMatrix3D.h"
 
 #include "Announce.h"
 #include "MathHelper.h"
 
+#include "netcdfcpp.h"
+
+#include <algorithm>
+#include <climits>
 #include <map>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 extern "C" {
@@ -82,31 +96,6 @@ extern "C" {
 		int * lwork,
 		int * info);
 
-	/// Matrix vector multiply
-	int dgemv_(
-		char * trans,
-		int * m,
-		int * n,
-		double * alpha,
-		double * a,
-		int * lda,
-		double * x,
-		int * incx,
-		double * beta,
-		double * y,
-		int * incy);
-
-	/// Symmetric positive definite matrix solver from CLAPACK
-	int dposv_(
-		char * uplo,
-		int * n,
-		int * nrhs,
-		double * a,
-		int * lda,
-		double * b,
-		int * ldb,
-		int * info);
-
 	/// Symmetric matrix solver from CLAPACK
 	int dsysv_(
 		char * uplo,
@@ -142,14 +131,128 @@ extern "C" {
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
-///		Face index and distance metric pair.
+///		Solve the 3x3 system dFit for the coordinates of nPoints quadrature
+///		points, stored consecutively in vecX and overwritten by the
+///		solutions.  All quadrature points of a Face share the same system,
+///		so it is factored once and all right-hand sides are solved together.
+///	</summary>
+void SolveFitSystems(
+	const DataMatrix<double> & dFit,
+	int nPoints,
+	std::vector<double> & vecX
+) {
+	if (nPoints == 0) {
+		return;
+	}
+
+	int n = 3;
+	int nrhs = nPoints;
+	int lda = 3;
+	int ipiv[3];
+	int ldb = 3;
+	int info;
+
+	DataMatrix<double> dFitTemp;
+	dFitTemp = dFit;
+	dgesv_(
+		&n, &nrhs, &(dFitTemp[0][0]), &lda, ipiv, &(vecX[0]), &ldb, &info);
+
+	if (info != 0) {
+		_EXCEPTIONT("Solve failure in dgesv");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append the area of each sub-triangle of Face ixFace to vecTriArea
+///		and the coordinates of each quadrature point of the sub-triangles,
+///		projected onto the unit sphere, to vecX.
 ///	</summary>
-typedef std::pair<int, int> FaceDistancePair;
+void AppendQuadraturePoints(
+	const FaceQuadratureTable & quad,
+	int ixFace,
+	std::vector<double> & vecTriArea,
+	std::vector<double> & vecX
+) {
+	int nPoints = quad.GetPoints();
+
+	int ixTriBegin = quad.GetTriangleBegin(ixFace);
+	int ixTriEnd = ixTriBegin + quad.GetTriangleCount(ixFace);
+
+	for (int ixTri = ixTriBegin; ixTri < ixTriEnd; ixTri++) {
+		vecTriArea.push_back(quad.GetTriangleArea(ixTri));
+
+		const double * dX = quad.GetX(ixTri);
+		const double * dY = quad.GetY(ixTri);
+		const double * dZ = quad.GetZ(ixTri);
+
+		for (int k = 0; k < nPoints; k++) {
+			vecX.push_back(dX[k]);
+			vecX.push_back(dY[k]);
+			vecX.push_back(dZ[k]);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
-///		Vector storing adjacent Faces.
+///		Reusable buffers for GetAdjacentFaceVector.  Nodes and Faces are
+///		marked as visited by stamping them with the index of the current
+///		search, so the buffers never need to be cleared between searches.
 ///	</summary>
-typedef std::vector<FaceDistancePair> AdjacentFaceVector;
+class AdjacentFaceBuffer {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	AdjacentFaceBuffer() :
+		m_nStamp(0)
+	{ }
+
+	///	<summary>
+	///		Begin a new search over mesh.
+	///	</summary>
+	void Begin(const Mesh & mesh) {
+		if ((m_vecNodeStamp.size() != mesh.nodes.size()) ||
+			(m_vecFaceStamp.size() != mesh.faces.size()) ||
+			(m_nStamp == INT_MAX)
+		) {
+			m_vecNodeStamp.assign(mesh.nodes.size(), 0);
+			m_vecFaceStamp.assign(mesh.faces.size(), 0);
+			m_nStamp = 0;
+		}
+		m_nStamp++;
+	}
+
+public:
+	///	<summary>
+	///		Index of the current search.
+	///	</summary>
+	int m_nStamp;
+
+	///	<summary>
+	///		Index of the last search which visited each Node.
+	///	</summary>
+	std::vector<int> m_vecNodeStamp;
+
+	///	<summary>
+	///		Index of the last search which visited each Face.
+	///	</summary>
+	std::vector<int> m_vecFaceStamp;
+
+	///	<summary>
+	///		Nodes on the perimeter of the current set of Faces.
+	///	</summary>
+	std::vector<int> m_vecPerimeterNodes;
+
+	///	<summary>
+	///		Nodes on the perimeter of the next set of Faces.
+	///	</summary>
+	std::vector<int> m_vecNextPerimeterNodes;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -157,76 +260,95 @@ void GetAdjacentFaceVector(
 	const Mesh & mesh,
 	int iFaceInitial,
 	int nRequiredFaceSetSize,
-	AdjacentFaceVector & vecFaces
+	AdjacentFaceVector & vecFaces,
+	AdjacentFaceBuffer & buffer
 ) {
 	// Ensure the ReverseNodeArray has been constructed
-	if (mesh.revnodearray.size() == 0) {
+	if (mesh.revnodearray.IsEmpty()) {
 		_EXCEPTIONT("ReverseNodeArray is required");
 	}
 
+	buffer.Begin(mesh);
+
+	const int nStamp = buffer.m_nStamp;
+
+	std::vector<int> & vecNodeStamp = buffer.m_vecNodeStamp;
+	std::vector<int> & vecFaceStamp = buffer.m_vecFaceStamp;
+
+	std::vector<int> & vecPerimeterNodes = buffer.m_vecPerimeterNodes;
+	std::vector<int> & vecNextPerimeterNodes = buffer.m_vecNextPerimeterNodes;
+
 	// Insert the initial Face
+	vecFaces.clear();
 	vecFaces.push_back(FaceDistancePair(iFaceInitial,1));
+	vecFaceStamp[iFaceInitial] = nStamp;
 
 	// Initial Face
 	const Face & faceInitial = mesh.faces[iFaceInitial];
 
-	// Set of nodes at the "perimeter" of faceInitial
-	std::set<int> setPerimeterNodes;
+	// Nodes at the "perimeter" of faceInitial
+	vecPerimeterNodes.clear();
 
 	for (int j = 0; j < faceInitial.edges.size(); j++) {
-		setPerimeterNodes.insert(faceInitial[j]);
+		if (vecNodeStamp[faceInitial[j]] != nStamp) {
+			vecNodeStamp[faceInitial[j]] = nStamp;
+			vecPerimeterNodes.push_back(faceInitial[j]);
+		}
 	}
 
-	// Set of Faces already added to vecFaces
-	std::set<int> setFaces;
-	setFaces.insert(iFaceInitial);
+	std::sort(vecPerimeterNodes.begin(), vecPerimeterNodes.end());
 
-	// Generate the set of faces
+	// Generate the set of faces in rings of increasing distance.  Perimeter
+	// Nodes are visited in ascending order and the Faces of each Node in
+	// ascending order.
 	int iDistance = 1;
 	for (;;) {
 		if (vecFaces.size() >= nRequiredFaceSetSize) {
 			break;
 		}
+		if (vecPerimeterNodes.size() == 0) {
+			_EXCEPTION2("Mesh has too few Faces for reconstruction "
+				"(%i of %i)", vecFaces.size(), nRequiredFaceSetSize);
+		}
 
 		// Increment distance metric
 		iDistance++;
 
-		// Store old perimeter nodes
-		std::set<int> setPerimeterNodesOld = setPerimeterNodes;
-
-		setPerimeterNodes.clear();
+		vecNextPerimeterNodes.clear();
 
 		// Loop through all perimeter nodes and add corresponding Faces
-		std::set<int>::const_iterator iterNode = setPerimeterNodesOld.begin();
+		for (int i = 0; i < vecPerimeterNodes.size(); i++) {
+			int ixNode = vecPerimeterNodes[i];
 
-		for (; iterNode != setPerimeterNodesOld.end(); iterNode++) {
-			const std::set<int> & setAdjFaces =
-				mesh.revnodearray[*iterNode];
+			int nAdjFaces = mesh.revnodearray.GetFaceCount(ixNode);
 
-			std::set<int>::const_iterator iterFace = setAdjFaces.begin();
-			for (; iterFace != setAdjFaces.end(); iterFace++) {
+			for (int k = 0; k < nAdjFaces; k++) {
+				int ixFace = mesh.revnodearray.GetFace(ixNode, k);
 
 				// Verify this Face has not already been added
-				if (setFaces.find(*iterFace) != setFaces.end()) {
+				if (vecFaceStamp[ixFace] == nStamp) {
 					continue;
 				}
 
-				// Add this Face to vecFaces and setFaces
-				vecFaces.push_back(FaceDistancePair(*iterFace, iDistance));
-				setFaces.insert(*iterFace);
+				// Add this Face to vecFaces
+				vecFaces.push_back(FaceDistancePair(ixFace, iDistance));
+				vecFaceStamp[ixFace] = nStamp;
 
 				// Add new nodes to perimeter node set
-				const Face & faceAdj = mesh.faces[*iterFace];
+				const Face & faceAdj = mesh.faces[ixFace];
 
 				for (int j = 0; j < faceAdj.edges.size(); j++) {
-					if (setPerimeterNodesOld.find(faceAdj[j]) ==
-						setPerimeterNodesOld.end()
-					) {
-						setPerimeterNodes.insert(faceAdj[j]);
+					if (vecNodeStamp[faceAdj[j]] != nStamp) {
+						vecNodeStamp[faceAdj[j]] = nStamp;
+						vecNextPerimeterNodes.push_back(faceAdj[j]);
 					}
 				}
 			}
 		}
+
+		std::sort(vecNextPerimeterNodes.begin(), vecNextPerimeterNodes.end());
+
+		vecPerimeterNodes.swap(vecNextPerimeterNodes);
 	}
 }
 
@@ -234,13 +356,11 @@ void GetAdjacentFaceVector(
 
 void BuildFitArray(
 	const Mesh & mesh,
+	const FaceQuadratureTable & quad,
 	int ixFirst,
 	const AdjacentFaceVector & vecAdjFaces,
 	int nOrder,
-	DataVector<double> & dConstraint,
-	DataMatrix<double> & dFitArray,
-	DataVector<double> & dFitWeights,
-	DataMatrix<double> & dFitArrayPlus
+	DataMatrix<double> & dFitArray
 ) {
 
 	// Reference to active Face
@@ -252,16 +372,11 @@ void BuildFitArray(
 	// Number of adjacent Faces
 	int nAdjFaces = vecAdjFaces.size();
 
-	// Initialize arrays,
+	// Initialize arrays
 	dFitArray.Initialize(nCoefficients, nAdjFaces);
-	dFitWeights.Initialize(nAdjFaces);
-	dFitArrayPlus.Initialize(nAdjFaces, nCoefficients);
-
-	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(4);
 
-	const DataMatrix<double> & dG = triquadrule.GetG();
-	const DataVector<double> & dW = triquadrule.GetW();
+	// Triangular quadrature weights
+	const DataVector<double> & dW = quad.GetW();
 
 	// Coordinate axes
 	const Node & nodeRef = mesh.nodes[faceFirst[0]];
@@ -279,7 +394,32 @@ void BuildFitArray(
 	dFit[1][0] = nodeA2.x; dFit[1][1] = nodeA2.y; dFit[1][2] = nodeA2.z;
 	dFit[2][0] = nodeC.x;  dFit[2][1] = nodeC.y;  dFit[2][2] = nodeC.z;
 
+	// Number of quadrature points
+	int nPoints = quad.GetPoints();
+
+	// Area of each sub-triangle and coordinates of each quadrature point of
+	// all adjacent Faces, relative to the reference Node
+	std::vector<double> vecTriArea;
+	std::vector<double> vecX;
+
+	for (int iAdjFace = 0; iAdjFace < vecAdjFaces.size(); iAdjFace++) {
+		AppendQuadraturePoints(
+			quad, vecAdjFaces[iAdjFace].first, vecTriArea, vecX);
+	}
+
+	for (int i = 0; i < vecX.size(); i += 3) {
+		vecX[i  ] -= nodeRef.x;
+		vecX[i+1] -= nodeRef.y;
+		vecX[i+2] -= nodeRef.z;
+	}
+
+	// Find the coefficients of all points
+	SolveFitSystems(dFit, static_cast<int>(vecX.size()) / 3, vecX);
+
 	// Loop through all adjacent Faces
+	int ixTri = 0;
+	int ixPoint = 0;
+
 	for (int iAdjFace = 0; iAdjFace < vecAdjFaces.size(); iAdjFace++) {
 
 		const FaceDistancePair & fdp = vecAdjFaces[iAdjFace];
@@ -292,58 +432,12 @@ void BuildFitArray(
 		// Loop through all sub-triangles
 		for (int j = 0; j < faceAdj.edges.size()-2; j++) {
 
-			const Node & node0 = mesh.nodes[faceAdj[0]];
-			const Node & node1 = mesh.nodes[faceAdj[j+1]];
-			const Node & node2 = mesh.nodes[faceAdj[j+2]];
-
-			// Calculate sub-triangular area
-			Face faceTri(3);
-			faceTri.SetNode(0, faceAdj[0]);
-			faceTri.SetNode(1, faceAdj[j+1]);
-			faceTri.SetNode(2, faceAdj[j+2]);
-
-			double dTriArea = CalculateFaceArea(faceTri, mesh.nodes);
+			double dTriArea = vecTriArea[ixTri++];
 
 			// Loop through all triangular quadrature nodes
-			for (int k = 0; k < triquadrule.GetPoints(); k++) {
-
-				double * dGL = dG[k];
-
-				// Get the nodal location of this point
-				double dX[3];
-
-				dX[0] = dGL[0] * node0.x + dGL[1] * node1.x + dGL[2] * node2.x;
-				dX[1] = dGL[0] * node0.y + dGL[1] * node1.y + dGL[2] * node2.y;
-				dX[2] = dGL[0] * node0.z + dGL[1] * node1.z + dGL[2] * node2.z;
-
-				double dMag =
-					sqrt(dX[0] * dX[0] + dX[1] * dX[1] + dX[2] * dX[2]);
-
-				dX[0] /= dMag;
-				dX[1] /= dMag;
-				dX[2] /= dMag;
-
-				dX[0] -= nodeRef.x;
-				dX[1] -= nodeRef.y;
-				dX[2] -= nodeRef.z;
+			for (int k = 0; k < nPoints; k++) {
 
-				// Find the coefficients for this point
-				int n = 3;
-				int nrhs = 1;
-				int lda = 3;
-				int ipiv[9];
-				int ldb = 3;
-				int info;
-
-#pragma message "Pre-triangularize this matrix for efficiency"
-				DataMatrix<double> dFitTemp;
-				dFitTemp = dFit;
-				dgesv_(
-					&n, &nrhs, &(dFitTemp[0][0]), &lda, ipiv, dX, &ldb, &info);
-
-				if (info != 0) {
-					_EXCEPTIONT("Solve failure in dgesv");
-				}
+				const double * dX = &(vecX[3 * (ixPoint++)]);
 
 				// Loop through all coefficients
 				int ixp = 0;
@@ -373,6 +467,26 @@ void BuildFitArray(
 		}
 */
 	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void InvertFitArray(
+	int nOrder,
+	const DataVector<double> & dConstraint,
+	const DataMatrix<double> & dFitArray,
+	DataVector<double> & dFitWeights,
+	DataMatrix<double> & dFitArrayPlus
+) {
+	// Number of coefficients
+	int nCoefficients = nOrder * (nOrder + 1) / 2;
+
+	// Number of adjacent Faces
+	int nAdjFaces = dFitArray.GetColumns();
+
+	// Initialize arrays
+	dFitWeights.Initialize(nAdjFaces);
+	dFitArrayPlus.Initialize(nAdjFaces, nCoefficients);
 
 	// First order
 	if (nOrder == 1) {
@@ -658,501 +772,742 @@ void BuildFitArray(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void LinearRemapFVtoFV(
-	const Mesh & meshInput,
-	const Mesh & meshOutput,
-	const Mesh & meshOverlap,
-	int nOrder,
-	OfflineMap & mapRemap
+void FVReconstructionOperator::Initialize(
+	const Mesh & mesh,
+	int nOrder
 ) {
-	// Verify ReverseNodeArray has been calculated
-	if (meshInput.revnodearray.size() == 0) {
-		_EXCEPTIONT("ReverseNodeArray has not been calculated for meshInput");
+	if (nOrder < 1) {
+		_EXCEPTION1("Invalid reconstruction order (%i)", nOrder);
+	}
+	if (mesh.vecFaceArea.GetRows() != mesh.faces.size()) {
+		_EXCEPTIONT("Face areas have not been calculated for mesh");
 	}
-
-	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(4);
-
-	const DataMatrix<double> & dG = triquadrule.GetG();
-	const DataVector<double> & dW = triquadrule.GetW();
-
-	// Get SparseMatrix represntation of the OfflineMap
-	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
 
 	// Number of elements needed
 	int nCoefficients = nOrder * (nOrder + 1) / 2;
 
 	int nRequiredFaceSetSize = nCoefficients;
 
-	// Current overlap face
-	int ixOverlap = 0;
+	int nFaces = static_cast<int>(mesh.faces.size());
+
+	m_nOrder = nOrder;
+	m_nNodes = static_cast<int>(mesh.nodes.size());
+
+	m_dArea = 0.0;
+	for (int i = 0; i < nFaces; i++) {
+		m_dArea += mesh.vecFaceArea[i];
+	}
+
+	// Exception raised while processing Faces
+	FaceLoopException exFaces;
+
+	// Number of threads processing Faces
+	int nThreads = 1;
+#ifdef _OPENMP
+	nThreads = omp_get_max_threads();
+#endif
+
+	// Search buffers of each thread
+	std::vector<AdjacentFaceBuffer> vecBuffers(nThreads);
+
+	// Determine the adjacent Faces of each Face
+	std::vector<AdjacentFaceVector> vecAllAdjFaces(nFaces);
 
-	// Loop through all faces on meshInput
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
+#pragma omp parallel for schedule(static) num_threads(nThreads)
+	for (int i = 0; i < nFaces; i++) {
+		try {
+			int iThread = 0;
+#ifdef _OPENMP
+			iThread = omp_get_thread_num();
+#endif
 
-		// Output every 100 elements
-		if (ixFirst % 100 == 0) {
-			Announce("Element %i", ixFirst);
+			GetAdjacentFaceVector(
+				mesh,
+				i,
+				nRequiredFaceSetSize,
+				vecAllAdjFaces[i],
+				vecBuffers[iThread]);
+
+		} catch(Exception & e) {
+			exFaces.Record(i, e);
 		}
+	}
 
-		// This Face
-		const Face & faceFirst = meshInput.faces[ixFirst];
+	exFaces.Rethrow();
+
+	m_vecAdjBegin.Initialize(nFaces + 1);
+	for (int i = 0; i < nFaces; i++) {
+		m_vecAdjBegin[i+1] =
+			m_vecAdjBegin[i] + static_cast<int>(vecAllAdjFaces[i].size());
+	}
 
-		// Coordinate axes
-		const Node & nodeRef = meshInput.nodes[faceFirst[0]];
+	int nAdjTotal = m_vecAdjBegin[nFaces];
 
-		Node nodeA1 = meshInput.nodes[faceFirst[1]] - nodeRef;
-		Node nodeA2 = meshInput.nodes[faceFirst[2]] - nodeRef;
+	m_vecAdjFaceIx.Initialize(nAdjTotal);
+	m_vecAdjDistance.Initialize(nAdjTotal);
+	m_dFitArray.Initialize(nAdjTotal * nCoefficients);
 
-		Node nodeC = CrossProduct(nodeA1, nodeA2);
+	// Quadrature points of all Faces
+	FaceQuadratureTable quadMesh;
+	quadMesh.Initialize(mesh, RemapQuadratureOrder);
 
-		// Fit matrix
-		DataMatrix<double> dFit;
-		dFit.Initialize(3,3);
+	// Build the fit array of each Face
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nFaces; i++) {
+		try {
+			const AdjacentFaceVector & vecAdjFaces = vecAllAdjFaces[i];
 
-		dFit[0][0] = nodeA1.x; dFit[0][1] = nodeA1.y; dFit[0][2] = nodeA1.z;
-		dFit[1][0] = nodeA2.x; dFit[1][1] = nodeA2.y; dFit[1][2] = nodeA2.z;
-		dFit[2][0] = nodeC.x;  dFit[2][1] = nodeC.y;  dFit[2][2] = nodeC.z;
+			DataMatrix<double> dFitArray;
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = 0;
-		int nTotalOverlapTriangles = 0;
+			BuildFitArray(mesh, quadMesh, i, vecAdjFaces, nOrder, dFitArray);
 
-		// Determine how many overlap Faces and triangles are present
-		int ixOverlapTemp = ixOverlap;
-		for (; ixOverlapTemp < meshOverlap.faces.size(); ixOverlapTemp++) {
+			for (int j = 0; j < vecAdjFaces.size(); j++) {
+				int ix = m_vecAdjBegin[i] + j;
 
-			const Face & faceOverlap = meshOverlap.faces[ixOverlapTemp];
+				m_vecAdjFaceIx[ix] = vecAdjFaces[j].first;
+				m_vecAdjDistance[ix] = vecAdjFaces[j].second;
 
-			if (meshOverlap.vecFirstFaceIx[ixOverlapTemp] != ixFirst) {
-				break;
+				for (int k = 0; k < nCoefficients; k++) {
+					m_dFitArray[ix * nCoefficients + k] = dFitArray[k][j];
+				}
 			}
 
-			nOverlapFaces++;
-			nTotalOverlapTriangles += faceOverlap.edges.size() - 2;
+		} catch(Exception & e) {
+			exFaces.Record(i, e);
 		}
+	}
 
-		// Build integration array
-		DataMatrix<double> dIntArray;
-		dIntArray.Initialize(nCoefficients, nOverlapFaces);
-
-		// Loop through all overlap Faces
-		for (int i = 0; i < nOverlapFaces; i++) {
-			const Face & faceOverlap = meshOverlap.faces[ixOverlap + i];
-
-			const NodeVector & nodesOverlap = meshOverlap.nodes;
+	exFaces.Rethrow();
+}
 
-			int nOverlapTriangles = faceOverlap.edges.size() - 2;
+///////////////////////////////////////////////////////////////////////////////
 
-			// Loop over all sub-triangles of this Overlap Face
-			for (int j = 0; j < nOverlapTriangles; j++) {
+void FVReconstructionOperator::Read(
+	const std::string & strInput
+) {
+	NcError error(NcError::silent_nonfatal);
 
-				// Cornerpoints of triangle
-				const Node & node0 = nodesOverlap[faceOverlap[0]];
-				const Node & node1 = nodesOverlap[faceOverlap[j+1]];
-				const Node & node2 = nodesOverlap[faceOverlap[j+2]];
+	NcFile ncInput(strInput.c_str(), NcFile::ReadOnly);
+	if (!ncInput.is_valid()) {
+		_EXCEPTION1("Unable to open reconstruction file \"%s\"",
+			strInput.c_str());
+	}
 
-				// Calculate the area of the modified Face
-				Face faceTri(3);
-				faceTri.SetNode(0, faceOverlap[0]);
-				faceTri.SetNode(1, faceOverlap[j+1]);
-				faceTri.SetNode(2, faceOverlap[j+2]);
+	NcAtt * attOrder = ncInput.get_att("order");
+	NcAtt * attNodes = ncInput.get_att("mesh_nodes");
+	NcAtt * attArea = ncInput.get_att("mesh_area");
+
+	NcDim * dimFaces = ncInput.get_dim("n_face");
+	NcDim * dimAdj = ncInput.get_dim("n_adj");
+	NcDim * dimCoeff = ncInput.get_dim("n_coeff");
+
+	NcVar * varAdjCount = ncInput.get_var("adj_count");
+	NcVar * varAdjFace = ncInput.get_var("adj_face");
+	NcVar * varAdjDistance = ncInput.get_var("adj_distance");
+	NcVar * varFit = ncInput.get_var("fit");
+
+	if ((attOrder == NULL) || (attNodes == NULL) || (attArea == NULL) ||
+		(dimFaces == NULL) || (dimAdj == NULL) || (dimCoeff == NULL) ||
+		(varAdjCount == NULL) || (varAdjFace == NULL) ||
+		(varAdjDistance == NULL) || (varFit == NULL)
+	) {
+		_EXCEPTION1("\"%s\" is not a reconstruction file", strInput.c_str());
+	}
 
-				double dTriArea =
-					CalculateFaceArea(faceTri, nodesOverlap);
+	m_nOrder = attOrder->as_int(0);
+	m_nNodes = attNodes->as_int(0);
+	m_dArea = attArea->as_double(0);
 
-				for (int k = 0; k < triquadrule.GetPoints(); k++) {
-					double * dGL = dG[k];
+	int nFaces = static_cast<int>(dimFaces->size());
+	int nAdjTotal = static_cast<int>(dimAdj->size());
+	int nCoefficients = static_cast<int>(dimCoeff->size());
 
-					// Get the nodal location of this point
-					double dX[3];
+	if (nCoefficients != m_nOrder * (m_nOrder + 1) / 2) {
+		_EXCEPTION1("Reconstruction file \"%s\" has inconsistent order",
+			strInput.c_str());
+	}
 
-					dX[0] = dGL[0] * node0.x + dGL[1] * node1.x + dGL[2] * node2.x;
-					dX[1] = dGL[0] * node0.y + dGL[1] * node1.y + dGL[2] * node2.y;
-					dX[2] = dGL[0] * node0.z + dGL[1] * node1.z + dGL[2] * node2.z;
+	DataVector<int> vecAdjCount;
+	vecAdjCount.Initialize(nFaces);
 
-					double dMag =
-						sqrt(dX[0] * dX[0] + dX[1] * dX[1] + dX[2] * dX[2]);
+	if (nFaces != 0) {
+		varAdjCount->set_cur((long)0);
+		varAdjCount->get(&(vecAdjCount[0]), nFaces);
+	}
 
-					dX[0] /= dMag;
-					dX[1] /= dMag;
-					dX[2] /= dMag;
+	m_vecAdjBegin.Initialize(nFaces + 1);
+	for (int i = 0; i < nFaces; i++) {
+		m_vecAdjBegin[i+1] = m_vecAdjBegin[i] + vecAdjCount[i];
+	}
+	if (m_vecAdjBegin[nFaces] != nAdjTotal) {
+		_EXCEPTION1("Reconstruction file \"%s\" has inconsistent adjacency",
+			strInput.c_str());
+	}
 
-					dX[0] -= nodeRef.x;
-					dX[1] -= nodeRef.y;
-					dX[2] -= nodeRef.z;
+	m_vecAdjFaceIx.Initialize(nAdjTotal);
+	m_vecAdjDistance.Initialize(nAdjTotal);
+	m_dFitArray.Initialize(nAdjTotal * nCoefficients);
 
-					// Find the coefficients for this point
-					int n = 3;
-					int nrhs = 1;
-					int lda = 3;
-					int ipiv[3];
-					int ldb = 3;
-					int info;
+	if (nAdjTotal != 0) {
+		varAdjFace->set_cur((long)0);
+		varAdjFace->get(&(m_vecAdjFaceIx[0]), nAdjTotal);
 
-					DataMatrix<double> dFitTemp;
-					dFitTemp = dFit;
-					dgesv_(
-						&n, &nrhs, &(dFitTemp[0][0]), &lda, ipiv, dX, &ldb, &info);
+		varAdjDistance->set_cur((long)0);
+		varAdjDistance->get(&(m_vecAdjDistance[0]), nAdjTotal);
 
-					// Sample this point
-					int ixp = 0;
-					for (int p = 0; p < nOrder; p++) {
-					for (int q = 0; q < nOrder - p; q++) {
-						dIntArray[ixp][i] +=
-							  IPow(dX[0], p)
-							* IPow(dX[1], q)
-							* dW[k]
-							* dTriArea;
+		varFit->set_cur((long)0, (long)0);
+		varFit->get(&(m_dFitArray[0]), nAdjTotal, nCoefficients);
+	}
 
-						ixp++;
-					}
-					}
-				}
-			}
+	for (int i = 0; i < nAdjTotal; i++) {
+		if ((m_vecAdjFaceIx[i] < 0) || (m_vecAdjFaceIx[i] >= nFaces)) {
+			_EXCEPTION1("Reconstruction file \"%s\" has invalid Face index",
+				strInput.c_str());
 		}
+	}
+}
 
-		// Determine the conservative constraint equation
-		DataVector<double> dConstraint;
-		dConstraint.Initialize(nCoefficients);
+///////////////////////////////////////////////////////////////////////////////
 
-		double dFirstArea = meshInput.vecFaceArea[ixFirst];
+void FVReconstructionOperator::Write(
+	const std::string & strOutput
+) const {
+	NcFile ncOutput(strOutput.c_str(), NcFile::Replace);
+	if (!ncOutput.is_valid()) {
+		_EXCEPTION1("Unable to open reconstruction file \"%s\"",
+			strOutput.c_str());
+	}
 
-		for (int p = 0; p < nCoefficients; p++) {
-		for (int j = 0; j < nOverlapFaces; j++) {
-			dConstraint[p] += dIntArray[p][j] / dFirstArea;
-		}
-		}
+	int nFaces = GetFaceCount();
+	int nAdjTotal = m_vecAdjBegin[nFaces];
+	int nCoefficients = m_nOrder * (m_nOrder + 1) / 2;
 
-		// Set of Faces to use in building the reconstruction and associated
-		// distance metric.
-		AdjacentFaceVector vecAdjFaces;
-
-		GetAdjacentFaceVector(
-			meshInput,
-			ixFirst,
-			nRequiredFaceSetSize,
-			vecAdjFaces);
-
-		// Number of adjacent Faces
-		int nAdjFaces = vecAdjFaces.size();
-
-		// Least squares arrays
-		DataMatrix<double> dFitArray;
-		DataVector<double> dFitWeights;
-		DataMatrix<double> dFitArrayPlus;
-
-		BuildFitArray(
-			meshInput,
-			ixFirst,
-			vecAdjFaces,
-			nOrder,
-			dConstraint,
-			dFitArray,
-			dFitWeights,
-			dFitArrayPlus
-		);
-/*
-		printf("\n");
-		for (int i = 0; i < nAdjFaces; i++) {
-		for (int p = 0; p < nCoefficients; p++) {
-			printf("%1.3e  ", dFitArray[p][i]);
-		}
-			printf("\n");
-		}
-*/
-		// Test conservative constraint equation
-		DataVector<double> dColumnSums;
-		dColumnSums.Initialize(nAdjFaces);
-/*
-		for (int p = 0; p < nCoefficients; p++) {
-			printf("%1.10e\n", dConstraint[p]);
-		}
-*/
-/*
-		for (int p = 0; p < nCoefficients; p++) {
-		for (int i = 0; i < nAdjFaces; i++) {
-			dColumnSums[i] += dConstraint[p] * dFitArrayPlus[i][p];
-			printf("%1.3e  ", dFitArrayPlus[i][p]);
-		}
-		printf(";\n");
-		}
+	// Attributes
+	ncOutput.add_att("Title", "TempestRemap Finite Volume Reconstruction");
+	ncOutput.add_att("order", m_nOrder);
+	ncOutput.add_att("mesh_nodes", m_nNodes);
+	ncOutput.add_att("mesh_area", m_dArea);
 
-		for (int i = 0; i < nAdjFaces; i++) {
-			printf("%1.10e\n", dColumnSums[i]);
-		}
-		_EXCEPTION();
-*/
+	NcDim * dimFaces = ncOutput.add_dim("n_face", nFaces);
+	NcDim * dimAdj = ncOutput.add_dim("n_adj", nAdjTotal);
+	NcDim * dimCoeff = ncOutput.add_dim("n_coeff", nCoefficients);
 
-		// Multiply integration array and fit array
-		DataMatrix<double> dComposedArray;
-		dComposedArray.Initialize(nAdjFaces, nOverlapFaces);
+	NcVar * varAdjCount = ncOutput.add_var("adj_count", ncInt, dimFaces);
+	NcVar * varAdjFace = ncOutput.add_var("adj_face", ncInt, dimAdj);
+	NcVar * varAdjDistance = ncOutput.add_var("adj_distance", ncInt, dimAdj);
+	NcVar * varFit = ncOutput.add_var("fit", ncDouble, dimAdj, dimCoeff);
 
-		for (int i = 0; i < nAdjFaces; i++) {
-		for (int j = 0; j < nOverlapFaces; j++) {
-		for (int k = 0; k < nCoefficients; k++) {
-			dComposedArray[i][j] += dIntArray[k][j] * dFitArrayPlus[i][k];
-		}
-		}
-		}
-/*
-		DataVector<double> dRowSums;
-		dRowSums.Initialize(nOverlapFaces);
+	DataVector<int> vecAdjCount;
+	vecAdjCount.Initialize(nFaces);
 
-		DataVector<double> dColSums;
-		dColSums.Initialize(nAdjFaces);
+	for (int i = 0; i < nFaces; i++) {
+		vecAdjCount[i] = m_vecAdjBegin[i+1] - m_vecAdjBegin[i];
+	}
 
-		for (int i = 0; i < nAdjFaces; i++) {
-		for (int j = 0; j < nOverlapFaces; j++) {
-			dRowSums[j] += dComposedArray[i][j] / meshOverlap.vecFaceArea[ixOverlap + j];
-			dColSums[i] += dComposedArray[i][j];
-		}
-		}
+	if (nFaces != 0) {
+		varAdjCount->set_cur((long)0);
+		varAdjCount->put(&(vecAdjCount[0]), nFaces);
+	}
 
-		printf("\n");
-		for (int j = 0; j < nOverlapFaces; j++) {
-			printf("%1.15e\n", dRowSums[j]);
-		}
-		printf("\n");
-		printf("%1.15e %1.15e\n", dColSums[0], meshInput.vecFaceArea[ixFirst]);
-		_EXCEPTION();
-*/
-		// Put composed array into map
-		for (int i = 0; i < vecAdjFaces.size(); i++) {
-		for (int j = 0; j < nOverlapFaces; j++) {
-			int ixFirstFace = vecAdjFaces[i].first;
-			int ixSecondFace = meshOverlap.vecSecondFaceIx[ixOverlap + j];
-
-			smatMap(ixSecondFace, ixFirstFace) +=
-				dComposedArray[i][j]
-				/ meshOutput.vecFaceArea[ixSecondFace];
-		}
-		}
+	if (nAdjTotal != 0) {
+		varAdjFace->set_cur((long)0);
+		varAdjFace->put(&(m_vecAdjFaceIx[0]), nAdjTotal);
 
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
+		varAdjDistance->set_cur((long)0);
+		varAdjDistance->put(&(m_vecAdjDistance[0]), nAdjTotal);
 
-		//_EXCEPTION();
+		varFit->set_cur((long)0, (long)0);
+		varFit->put(&(m_dFitArray[0]), nAdjTotal, nCoefficients);
 	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void ForceIntArrayConsistencyConservation(
-	const DataVector<double> & vecSourceArea,
-	const DataVector<double> & vecTargetArea,
-	DataMatrix<double> & dCoeff,
-	bool fMonotone
-) {
+void FVReconstructionOperator::Validate(
+	const Mesh & mesh,
+	int nOrder
+) const {
+	if (nOrder != m_nOrder) {
+		_EXCEPTION2("Reconstruction order (%i) does not match "
+			"requested order (%i)", m_nOrder, nOrder);
+	}
+	if ((GetFaceCount() != mesh.faces.size()) ||
+		(m_nNodes != mesh.nodes.size())
+	) {
+		_EXCEPTION2("Reconstruction operator dimension mismatch with "
+			"input Mesh (%i, %i)", GetFaceCount(), mesh.faces.size());
+	}
 
-	// Number of free coefficients
-	int nCoeff = dCoeff.GetRows() * dCoeff.GetColumns();
+	double dArea = 0.0;
+	for (int i = 0; i < mesh.vecFaceArea.GetRows(); i++) {
+		dArea += mesh.vecFaceArea[i];
+	}
+	if (fabs(dArea - m_dArea) > 1.0e-10) {
+		_EXCEPTION2("Reconstruction operator area (%1.15e) does not match "
+			"input Mesh area (%1.15e)", m_dArea, dArea);
+	}
+}
 
-	// Number of conditions
-	int nCondConservation = dCoeff.GetColumns();
-	int nCondConsistency  = dCoeff.GetRows();
+///////////////////////////////////////////////////////////////////////////////
 
-	// One condition is dropped due to linear dependence
-	int nCond = nCondConservation + nCondConsistency - 1;
+void FVReconstructionOperator::GetFace(
+	int ixFace,
+	AdjacentFaceVector & vecAdjFaces,
+	DataMatrix<double> & dFitArray
+) const {
+	int nCoefficients = m_nOrder * (m_nOrder + 1) / 2;
 
-	// Product matrix
-	DataMatrix<double> dCCt;
-	dCCt.Initialize(nCond, nCond);
+	int ixBegin = m_vecAdjBegin[ixFace];
+	int nAdjFaces = m_vecAdjBegin[ixFace+1] - ixBegin;
 
-	DataMatrix<double> dC;
-	dC.Initialize(nCoeff, nCond);
+	vecAdjFaces.resize(nAdjFaces);
+	dFitArray.Initialize(nCoefficients, nAdjFaces);
 
-	DataVector<double> dRHS;
-	dRHS.Initialize(nCoeff + nCond);
+	for (int j = 0; j < nAdjFaces; j++) {
+		int ix = ixBegin + j;
 
-	// RHS
-	int ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dRHS[ix] = dCoeff[i][j];
-		ix++;
-	}
-	}
+		vecAdjFaces[j] =
+			FaceDistancePair(m_vecAdjFaceIx[ix], m_vecAdjDistance[ix]);
 
-	// Consistency
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dC[i * dCoeff.GetColumns() + j][ix] = 1.0;
+		for (int k = 0; k < nCoefficients; k++) {
+			dFitArray[k][j] = m_dFitArray[ix * nCoefficients + k];
 		}
-		dRHS[nCoeff + ix] = 1.0;
-		ix++;
 	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef USE_MPI
+
+///	<summary>
+///		Send the map contributions recorded on this rank to the root rank,
+///		which adds the contributions of all ranks to smatMap in rank order.
+///	</summary>
+void GatherMapContributions(
+	const std::vector<int> & vecRows,
+	const std::vector<int> & vecCols,
+	const std::vector<double> & vecValues,
+	SparseMatrix<double> & smatMap
+) {
+	int nRank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+
+	int nSize;
+	MPI_Comm_size(MPI_COMM_WORLD, &nSize);
 
-	// Conservation
-	for (int j = 0; j < dCoeff.GetColumns()-1; j++) {
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			dC[i * dCoeff.GetColumns() + j][ix] = vecTargetArea[i];
+	if (nRank != 0) {
+		int nCount = static_cast<int>(vecValues.size());
+		MPI_Send(&nCount, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
+
+		if (nCount != 0) {
+			MPI_Send(const_cast<int *>(&(vecRows[0])),
+				nCount, MPI_INT, 0, 1, MPI_COMM_WORLD);
+			MPI_Send(const_cast<int *>(&(vecCols[0])),
+				nCount, MPI_INT, 0, 2, MPI_COMM_WORLD);
+			MPI_Send(const_cast<double *>(&(vecValues[0])),
+				nCount, MPI_DOUBLE, 0, 3, MPI_COMM_WORLD);
 		}
-		dRHS[nCoeff + ix] = vecSourceArea[j];
-		ix++;
+		return;
 	}
 
-	// Calculate CCt
-	double dP = 0.0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dP += vecTargetArea[i] * vecTargetArea[i];
-	}
+	for (int r = 1; r < nSize; r++) {
+		int nCount;
+		MPI_Recv(&nCount, 1, MPI_INT, r, 0, MPI_COMM_WORLD,
+			MPI_STATUS_IGNORE);
+
+		if (nCount == 0) {
+			continue;
+		}
+
+		std::vector<int> vecRankRows(nCount);
+		std::vector<int> vecRankCols(nCount);
+		std::vector<double> vecRankValues(nCount);
 
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dCCt[i][i] = static_cast<double>(dCoeff.GetColumns());
-		for (int j = 0; j < dCoeff.GetColumns()-1; j++) {
-			dCCt[i][dCoeff.GetRows() + j] = vecTargetArea[i];
-			dCCt[dCoeff.GetRows() + j][i] = vecTargetArea[i];
+		MPI_Recv(&(vecRankRows[0]), nCount, MPI_INT, r, 1,
+			MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		MPI_Recv(&(vecRankCols[0]), nCount, MPI_INT, r, 2,
+			MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		MPI_Recv(&(vecRankValues[0]), nCount, MPI_DOUBLE, r, 3,
+			MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+		for (int i = 0; i < nCount; i++) {
+			smatMap.Add(vecRankRows[i], vecRankCols[i], vecRankValues[i]);
 		}
 	}
+}
 
-	for (int i = 0; i < dCoeff.GetColumns()-1; i++) {
-		int ix = dCoeff.GetRows() + i;
-		dCCt[ix][ix] = dP;
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+void LinearRemapFVtoFV(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	int nOrder,
+	OfflineMap & mapRemap,
+	const FVReconstructionOperator * pReconstruction,
+	const FaceQuadratureTable * pOverlapQuadrature
+) {
+	// Verify the reconstruction operator or the ReverseNodeArray
+	if (pReconstruction != NULL) {
+		pReconstruction->Validate(meshInput, nOrder);
+
+	} else if (meshInput.revnodearray.IsEmpty()) {
+		_EXCEPTIONT("ReverseNodeArray has not been calculated for meshInput");
 	}
-/*
-	for (int i = 0; i < nCond; i++) {
-	for (int j = 0; j < nCond; j++) {
-		for (int k = 0; k < nCoeff; k++) {
-			dCCt[i][j] += dC[k][i] * dC[k][j];
-		}
+
+	// Verify the overlap mesh has been indexed for meshInput
+	if (meshOverlap.firstfaceindex.GetSourceFaceCount() != meshInput.faces.size()) {
+		_EXCEPTIONT("Overlap mesh index has not been calculated for meshInput");
 	}
+
+	// Quadrature points of the overlap mesh
+	FaceQuadratureTable quadOverlapLocal;
+
+	const FaceQuadratureTable * pquadOverlap = pOverlapQuadrature;
+
+	if (pquadOverlap != NULL) {
+		pquadOverlap->Validate(meshOverlap, RemapQuadratureOrder);
+
+	} else {
+		quadOverlapLocal.Initialize(meshOverlap, RemapQuadratureOrder);
+		pquadOverlap = &quadOverlapLocal;
+	}
+
+	const FaceQuadratureTable & quadOverlap = *pquadOverlap;
+
+	// Quadrature points of the input mesh, used to build the fit arrays
+	FaceQuadratureTable quadInput;
+
+	if (pReconstruction == NULL) {
+		quadInput.Initialize(meshInput, RemapQuadratureOrder);
 	}
+
+	// Triangular quadrature weights
+	const DataVector<double> & dW = quadOverlap.GetW();
+
+	// Get SparseMatrix represntation of the OfflineMap
+	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
+
+	// Number of elements needed
+	int nCoefficients = nOrder * (nOrder + 1) / 2;
+
+	int nRequiredFaceSetSize = nCoefficients;
+
+	// Range of Faces on meshInput processed by this rank.  Each rank
+	// processes a contiguous range of Faces, so that contributions can be
+	// added to the map on the root rank in the same order as in serial.
+	int ixFirstBegin = 0;
+	int ixFirstEnd = static_cast<int>(meshInput.faces.size());
+
+	int nRank = 0;
+
+	// Number of threads processing Faces
+	int nThreads = 1;
+#ifdef _OPENMP
+	nThreads = omp_get_max_threads();
+#endif
+
+#ifdef USE_MPI
+	int nSize;
+	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+	MPI_Comm_size(MPI_COMM_WORLD, &nSize);
+
+	ixFirstBegin = static_cast<int>(
+		(static_cast<long long>(meshInput.faces.size()) * nRank) / nSize);
+	ixFirstEnd = static_cast<int>(
+		(static_cast<long long>(meshInput.faces.size()) * (nRank+1)) / nSize);
+
+	// Map contributions recorded by each thread on ranks other than the root
+	std::vector< std::vector<int> > vecThreadContribRows(nThreads);
+	std::vector< std::vector<int> > vecThreadContribCols(nThreads);
+	std::vector< std::vector<double> > vecThreadContribValues(nThreads);
+#endif
+
+	// Overlap Faces of each Face
+	const OverlapFaceIndex & indexOverlap = meshOverlap.firstfaceindex;
+
+	// Search buffers of each thread
+	std::vector<AdjacentFaceBuffer> vecBuffers(nThreads);
+
+	// Exception raised while processing Faces
+	FaceLoopException exFaces;
+
+	// Loop through all faces on meshInput.  Each thread processes a
+	// contiguous range of Faces, so that contributions are added to the
+	// map in the same order as in serial.
+#pragma omp parallel for schedule(static) num_threads(nThreads)
+	for (int ixFirst = ixFirstBegin; ixFirst < ixFirstEnd; ixFirst++) {
+		try {
+			// Output every 100 elements
+			if (ixFirst % 100 == 0) {
+#pragma omp critical(Announce)
+				Announce("Element %i", ixFirst);
+			}
+
+			int iThread = 0;
+#ifdef _OPENMP
+			iThread = omp_get_thread_num();
+#endif
+
+			// This Face
+			const Face & faceFirst = meshInput.faces[ixFirst];
+
+			// Coordinate axes
+			const Node & nodeRef = meshInput.nodes[faceFirst[0]];
+
+			Node nodeA1 = meshInput.nodes[faceFirst[1]] - nodeRef;
+			Node nodeA2 = meshInput.nodes[faceFirst[2]] - nodeRef;
+
+			Node nodeC = CrossProduct(nodeA1, nodeA2);
+
+			// Fit matrix
+			DataMatrix<double> dFit;
+			dFit.Initialize(3,3);
+
+			dFit[0][0] = nodeA1.x; dFit[0][1] = nodeA1.y; dFit[0][2] = nodeA1.z;
+			dFit[1][0] = nodeA2.x; dFit[1][1] = nodeA2.y; dFit[1][2] = nodeA2.z;
+			dFit[2][0] = nodeC.x;  dFit[2][1] = nodeC.y;  dFit[2][2] = nodeC.z;
+
+			// Overlapping Faces
+			int nOverlapFaces = indexOverlap.GetFaceCount(ixFirst);
+
+			// Build integration array
+			DataMatrix<double> dIntArray;
+			dIntArray.Initialize(nCoefficients, nOverlapFaces);
+
+			// Area of each sub-triangle and coordinates of each quadrature
+			// point of all overlap Faces, relative to the reference Node
+			std::vector<double> vecTriArea;
+			std::vector<double> vecX;
+
+			for (int i = 0; i < nOverlapFaces; i++) {
+				AppendQuadraturePoints(
+					quadOverlap,
+					indexOverlap.GetFace(ixFirst, i),
+					vecTriArea,
+					vecX);
+			}
+
+			for (int i = 0; i < vecX.size(); i += 3) {
+				vecX[i  ] -= nodeRef.x;
+				vecX[i+1] -= nodeRef.y;
+				vecX[i+2] -= nodeRef.z;
+			}
+
+			// Find the coefficients of all points
+			SolveFitSystems(dFit, static_cast<int>(vecX.size()) / 3, vecX);
+
+			// Loop through all overlap Faces
+			int ixTri = 0;
+			int ixPoint = 0;
+
+			for (int i = 0; i < nOverlapFaces; i++) {
+				const Face & faceOverlap =
+					meshOverlap.faces[indexOverlap.GetFace(ixFirst, i)];
+
+				int nOverlapTriangles = faceOverlap.edges.size() - 2;
+
+				// Loop over all sub-triangles of this Overlap Face
+				for (int j = 0; j < nOverlapTriangles; j++) {
+
+					double dTriArea = vecTriArea[ixTri++];
+
+					for (int k = 0; k < quadOverlap.GetPoints(); k++) {
+						const double * dX = &(vecX[3 * (ixPoint++)]);
+
+						// Sample this point
+						int ixp = 0;
+						for (int p = 0; p < nOrder; p++) {
+						for (int q = 0; q < nOrder - p; q++) {
+							dIntArray[ixp][i] +=
+								  IPow(dX[0], p)
+								* IPow(dX[1], q)
+								* dW[k]
+								* dTriArea;
+
+							ixp++;
+						}
+						}
+					}
+				}
+			}
+
+			// Determine the conservative constraint equation
+			DataVector<double> dConstraint;
+			dConstraint.Initialize(nCoefficients);
+
+			double dFirstArea = meshInput.vecFaceArea[ixFirst];
+
+			for (int p = 0; p < nCoefficients; p++) {
+			for (int j = 0; j < nOverlapFaces; j++) {
+				dConstraint[p] += dIntArray[p][j] / dFirstArea;
+			}
+			}
+
+			// Set of Faces to use in building the reconstruction and associated
+			// distance metric, and the fit array of the reconstruction.
+			AdjacentFaceVector vecAdjFaces;
+			DataMatrix<double> dFitArray;
+
+			if (pReconstruction != NULL) {
+				pReconstruction->GetFace(ixFirst, vecAdjFaces, dFitArray);
+
+			} else {
+				GetAdjacentFaceVector(
+					meshInput,
+					ixFirst,
+					nRequiredFaceSetSize,
+					vecAdjFaces,
+					vecBuffers[iThread]);
+
+				BuildFitArray(
+					meshInput,
+					quadInput,
+					ixFirst,
+					vecAdjFaces,
+					nOrder,
+					dFitArray);
+			}
+
+			// Number of adjacent Faces
+			int nAdjFaces = vecAdjFaces.size();
+
+			// Least squares arrays
+			DataVector<double> dFitWeights;
+			DataMatrix<double> dFitArrayPlus;
+
+			InvertFitArray(
+				nOrder,
+				dConstraint,
+				dFitArray,
+				dFitWeights,
+				dFitArrayPlus
+			);
+/*
+			printf("\n");
+			for (int i = 0; i < nAdjFaces; i++) {
+			for (int p = 0; p < nCoefficients; p++) {
+				printf("%1.3e  ", dFitArray[p][i]);
+			}
+				printf("\n");
+			}
 */
+			// Test conservative constraint equation
+			DataVector<double> dColumnSums;
+			dColumnSums.Initialize(nAdjFaces);
 /*
-	FILE * fp = fopen("cct.dat", "w");
-	for (int i = 0; i < nCond; i++) {
-		for (int j = 0; j < nCond; j++) {
-			fprintf(fp, "%1.15e\t", dCCt[i][j]);
-		}
-		fprintf(fp, "\n");
-	}
-	fclose(fp);
-	_EXCEPTION();
+			for (int p = 0; p < nCoefficients; p++) {
+				printf("%1.10e\n", dConstraint[p]);
+			}
 */
-	// Calculate C*r1 - r2
-	char trans = 'n';
-	int m = nCond;
-	int n = nCoeff;
-	int lda = m;
-	int incx = 1;
-	int incy = 1;
-	double posone = 1.0;
-	double negone = -1.0;
-	dgemv_(
-		&trans,
-		&m,
-		&n,
-		&posone,
-		&(dC[0][0]),
-		&lda,
-		&(dRHS[0]),
-		&incx,
-		&negone,
-		&(dRHS[nCoeff]),
-		&incy);
-
-	// Solve the general system
-	int nrhs = 1;
-	int ldb = nCond;
-
-	int nInfo;
 /*
-	DataVector<int> iPIV;
-	iPIV.Initialize(nCond);
+			for (int p = 0; p < nCoefficients; p++) {
+			for (int i = 0; i < nAdjFaces; i++) {
+				dColumnSums[i] += dConstraint[p] * dFitArrayPlus[i][p];
+				printf("%1.3e  ", dFitArrayPlus[i][p]);
+			}
+			printf(";\n");
+			}
 
-	dgesv_(
-		&m,
-		&nrhs,
-		&(dCCt[0][0]),
-		&lda,
-		&(iPIV[0]),
-		&(dRHS[nCoeff]),
-		&ldb,
-		&nInfo);
+			for (int i = 0; i < nAdjFaces; i++) {
+				printf("%1.10e\n", dColumnSums[i]);
+			}
+			_EXCEPTION();
 */
-	char uplo = 'U';
-	dposv_(
-		&uplo,
-		&m,
-		&nrhs,
-		&(dCCt[0][0]),
-		&lda,
-		&(dRHS[nCoeff]),
-		&ldb,
-		&nInfo);
-
-	if (nInfo != 0) {
-		_EXCEPTION1("Unable to solve SPD Schur system: %i\n", nInfo);
-	}
-
-	// Obtain coefficients
-	trans = 't';
-	dgemv_(
-		&trans,
-		&m,
-		&n,
-		&negone,
-		&(dC[0][0]),
-		&lda,
-		&(dRHS[nCoeff]),
-		&incx,
-		&posone,
-		&(dRHS[0]),
-		&incy);
-
-	// Store coefficients in array
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dCoeff[i][j] = dRHS[ix];
-		ix++;
-	}
-	}
-
-	// Force monotonicity
-	if (fMonotone) {
-
-		// Calculate total element Jacobian
-		double dTotalJacobian = 0.0;
-		for (int i = 0; i < vecSourceArea.GetRows(); i++) {
-			dTotalJacobian += vecSourceArea[i];
-		}
 
-		// Determine low-order remap coefficients
-		DataMatrix<double> dMonoCoeff;
-		dMonoCoeff.Initialize(dCoeff.GetRows(), dCoeff.GetColumns());
+			// Multiply integration array and fit array
+			DataMatrix<double> dComposedArray;
+			dComposedArray.Initialize(nAdjFaces, nOverlapFaces);
 
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dMonoCoeff[i][j] =
-				vecSourceArea[j]
-				/ dTotalJacobian;
-		}
-		}
+			for (int i = 0; i < nAdjFaces; i++) {
+			for (int j = 0; j < nOverlapFaces; j++) {
+			for (int k = 0; k < nCoefficients; k++) {
+				dComposedArray[i][j] += dIntArray[k][j] * dFitArrayPlus[i][k];
+			}
+			}
+			}
+/*
+			DataVector<double> dRowSums;
+			dRowSums.Initialize(nOverlapFaces);
+
+			DataVector<double> dColSums;
+			dColSums.Initialize(nAdjFaces);
 
-		// Compute scaling factor
-		double dA = 0.0;
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			if (dCoeff[i][j] < 0.0) {
-				double dNewA =
-					- dCoeff[i][j] / fabs(dMonoCoeff[i][j] - dCoeff[i][j]);
+			for (int i = 0; i < nAdjFaces; i++) {
+			for (int j = 0; j < nOverlapFaces; j++) {
+				dRowSums[j] += dComposedArray[i][j]
+					/ meshOverlap.vecFaceArea[indexOverlap.GetFace(ixFirst, j)];
+				dColSums[i] += dComposedArray[i][j];
+			}
+			}
 
-				if (dNewA > dA) {
-					dA = dNewA;
+			printf("\n");
+			for (int j = 0; j < nOverlapFaces; j++) {
+				printf("%1.15e\n", dRowSums[j]);
+			}
+			printf("\n");
+			printf("%1.15e %1.15e\n", dColSums[0], meshInput.vecFaceArea[ixFirst]);
+			_EXCEPTION();
+*/
+			// Put composed array into map
+			for (int i = 0; i < vecAdjFaces.size(); i++) {
+			for (int j = 0; j < nOverlapFaces; j++) {
+				int ixFirstFace = vecAdjFaces[i].first;
+				int ixSecondFace =
+					meshOverlap.vecSecondFaceIx[indexOverlap.GetFace(ixFirst, j)];
+
+				double dValue =
+					dComposedArray[i][j]
+					/ meshOutput.vecFaceArea[ixSecondFace];
+
+#ifdef USE_MPI
+				if (nRank != 0) {
+					vecThreadContribRows[iThread].push_back(ixSecondFace);
+					vecThreadContribCols[iThread].push_back(ixFirstFace);
+					vecThreadContribValues[iThread].push_back(dValue);
+					continue;
 				}
+#endif
+
+				smatMap.Add(ixSecondFace, ixFirstFace, dValue);
+			}
 			}
-		}
-		}
 
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dCoeff[i][j] = (1.0 - dA) * dCoeff[i][j] + dA * dMonoCoeff[i][j];
-		}
+		} catch(Exception & e) {
+			exFaces.Record(ixFirst, e);
 		}
 	}
+
+	exFaces.Rethrow();
+
+#ifdef USE_MPI
+	// Assemble the complete map on the root rank
+	if (nSize != 1) {
+		std::vector<int> vecContribRows;
+		std::vector<int> vecContribCols;
+		std::vector<double> vecContribValues;
+
+		for (int t = 0; t < nThreads; t++) {
+			vecContribRows.insert(vecContribRows.end(),
+				vecThreadContribRows[t].begin(),
+				vecThreadContribRows[t].end());
+			vecContribCols.insert(vecContribCols.end(),
+				vecThreadContribCols[t].begin(),
+				vecThreadContribCols[t].end());
+			vecContribValues.insert(vecContribValues.end(),
+				vecThreadContribValues[t].begin(),
+				vecThreadContribValues[t].end());
+		}
+
+		GatherMapContributions(
+			vecContribRows,
+			vecContribCols,
+			vecContribValues,
+			smatMap);
+	}
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1161,45 +1516,66 @@ void LinearRemapFVtoGLL(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
-	const DataMatrix3D<int> & dataGLLNodes,
-	const DataMatrix3D<double> & dataGLLJacobian,
+	const GLLElementData<int> & dataGLLNodes,
+	const GLLElementData<double> & dataGLLJacobian,
 	int nOrder,
 	OfflineMap & mapRemap,
-	bool fMonotone
+	bool fMonotone,
+	const FVReconstructionOperator * pReconstruction,
+	const FaceQuadratureTable * pOverlapQuadrature
 ) {
-	// Verify ReverseNodeArray has been calculated
-	if (meshInput.revnodearray.size() == 0) {
+	// Verify the reconstruction operator or the ReverseNodeArray
+	if (pReconstruction != NULL) {
+		pReconstruction->Validate(meshInput, nOrder);
+
+	} else if (meshInput.revnodearray.IsEmpty()) {
 		_EXCEPTIONT("ReverseNodeArray has not been calculated for meshInput");
 	}
 
-	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(4);
+	// Verify the overlap mesh has been indexed for meshInput and meshOutput
+	if (meshOverlap.firstfaceindex.GetSourceFaceCount() != meshInput.faces.size()) {
+		_EXCEPTIONT("Overlap mesh index has not been calculated for meshInput");
+	}
+	if (meshOverlap.secondfaceindex.GetSourceFaceCount() != meshOutput.faces.size()) {
+		_EXCEPTIONT("Overlap mesh index has not been calculated for meshOutput");
+	}
+
+	// Quadrature points of the overlap mesh
+	FaceQuadratureTable quadOverlapLocal;
 
-	const DataMatrix<double> & dG = triquadrule.GetG();
-	const DataVector<double> & dW = triquadrule.GetW();
+	const FaceQuadratureTable * pquadOverlap = pOverlapQuadrature;
+
+	if (pquadOverlap != NULL) {
+		pquadOverlap->Validate(meshOverlap, RemapQuadratureOrder);
+
+	} else {
+		quadOverlapLocal.Initialize(meshOverlap, RemapQuadratureOrder);
+		pquadOverlap = &quadOverlapLocal;
+	}
+
+	const FaceQuadratureTable & quadOverlap = *pquadOverlap;
+
+	// Quadrature points of the input mesh, used to build the fit arrays
+	FaceQuadratureTable quadInput;
+
+	if (pReconstruction == NULL) {
+		quadInput.Initialize(meshInput, RemapQuadratureOrder);
+	}
+
+	// Triangular quadrature weights
+	const DataVector<double> & dW = quadOverlap.GetW();
 
 	// Get SparseMatrix represntation of the OfflineMap
 	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
 
 	// Order of the finite element method
-	int nP = dataGLLNodes.GetRows();
-
-	// Sample coefficients
-	DataMatrix<double> dSampleCoeff;
-	dSampleCoeff.Initialize(nP, nP);
+	int nP = dataGLLNodes.GetNp();
 
 	// Number of elements needed
 	int nCoefficients = nOrder * (nOrder + 1) / 2;
 
 	int nRequiredFaceSetSize = nCoefficients;
 
-	// Current overlap face
-	int ixOverlap = 0;
-
-	// Face areas
-	DataVector<double> dNumericalSecondArea;
-	dNumericalSecondArea.Initialize(meshOutput.faces.size() * nP * nP);
-
 	// Generate the unique Jacobian for each point
 	DataVector<double> dataUniqueJacobian;
 	GenerateUniqueJacobian(dataGLLNodes, dataGLLJacobian, dataUniqueJacobian);
@@ -1211,340 +1587,307 @@ void LinearRemapFVtoGLL(
 		meshOverlap.faces.size(),
 		nP * nP);
 
-	// Number of overlap Faces per source Face
-	DataVector<int> nAllOverlapFaces;
-	nAllOverlapFaces.Initialize(meshInput.faces.size());
+	// Overlap Faces of each Face on meshInput
+	const OverlapFaceIndex & indexOverlap = meshOverlap.firstfaceindex;
 
-	DataVector<int> nAllTotalOverlapTriangles;
-	nAllTotalOverlapTriangles.Initialize(meshInput.faces.size());
+	// Number of Faces on meshInput
+	int nFirstFaces = static_cast<int>(meshInput.faces.size());
 
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
+	// Exception raised while processing Faces
+	FaceLoopException exFaces;
 
-		int ixOverlapTemp = ixOverlap;
-		for (; ixOverlapTemp < meshOverlap.faces.size(); ixOverlapTemp++) {
-
-			const Face & faceOverlap = meshOverlap.faces[ixOverlapTemp];
-
-			if (meshOverlap.vecFirstFaceIx[ixOverlapTemp] != ixFirst) {
-				break;
+	// Loop through all faces on meshInput.  Each Face accumulates into the
+	// rows of the integration array of its own overlap Faces.
+#pragma omp parallel for schedule(static)
+	for (int ixFirst = 0; ixFirst < nFirstFaces; ixFirst++) {
+		try {
+			// Output every 100 elements
+			if (ixFirst % 100 == 0) {
+#pragma omp critical(Announce)
+				Announce("Element %i", ixFirst);
 			}
 
-			nAllOverlapFaces[ixFirst]++;
-			nAllTotalOverlapTriangles[ixFirst] += faceOverlap.edges.size() - 2;
-		}
-
-		// Increment the current overlap index
-		ixOverlap += nAllOverlapFaces[ixFirst];
-	}
-
-	// Loop through all faces on meshInput
-	ixOverlap = 0;
-
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
+			// This Face
+			const Face & faceFirst = meshInput.faces[ixFirst];
 
-		// Output every 100 elements
-		if (ixFirst % 100 == 0) {
-			Announce("Element %i", ixFirst);
-		}
-
-		// This Face
-		const Face & faceFirst = meshInput.faces[ixFirst];
-
-		// Area of the First Face
-		double dFirstArea = meshInput.vecFaceArea[ixFirst];
-
-		// Coordinate axes
-		const Node & nodeRef = meshInput.nodes[faceFirst[0]];
-
-		Node nodeA1 = meshInput.nodes[faceFirst[1]] - nodeRef;
-		Node nodeA2 = meshInput.nodes[faceFirst[2]] - nodeRef;
-
-		Node nodeC = CrossProduct(nodeA1, nodeA2);
-
-		// Fit matrix
-		DataMatrix<double> dFit;
-		dFit.Initialize(3,3);
-
-		dFit[0][0] = nodeA1.x; dFit[0][1] = nodeA1.y; dFit[0][2] = nodeA1.z;
-		dFit[1][0] = nodeA2.x; dFit[1][1] = nodeA2.y; dFit[1][2] = nodeA2.z;
-		dFit[2][0] = nodeC.x;  dFit[2][1] = nodeC.y;  dFit[2][2] = nodeC.z;
+			// Area of the First Face
+			double dFirstArea = meshInput.vecFaceArea[ixFirst];
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
-		int nTotalOverlapTriangles = nAllTotalOverlapTriangles[ixFirst];
+			// Coordinate axes
+			const Node & nodeRef = meshInput.nodes[faceFirst[0]];
 
-		// Basis integral over all Overlap Faces
-		DataVector<double> dBasisIntArray;
-		dBasisIntArray.Initialize(nP * nP);
+			Node nodeA1 = meshInput.nodes[faceFirst[1]] - nodeRef;
+			Node nodeA2 = meshInput.nodes[faceFirst[2]] - nodeRef;
 
-		// Build integration array
-		DataMatrix<double> dIntArray;
-		dIntArray.Initialize(nCoefficients, nOverlapFaces * nP * nP);
+			Node nodeC = CrossProduct(nodeA1, nodeA2);
 
-		DataMatrix3D<double> dLocalSecondArea;
-		dLocalSecondArea.Initialize(nOverlapFaces, nP, nP);
+			// Fit matrix
+			DataMatrix<double> dFit;
+			dFit.Initialize(3,3);
 
-		// Loop through all Overlap Faces
-		for (int i = 0; i < nOverlapFaces; i++) {
+			dFit[0][0] = nodeA1.x; dFit[0][1] = nodeA1.y; dFit[0][2] = nodeA1.z;
+			dFit[1][0] = nodeA2.x; dFit[1][1] = nodeA2.y; dFit[1][2] = nodeA2.z;
+			dFit[2][0] = nodeC.x;  dFit[2][1] = nodeC.y;  dFit[2][2] = nodeC.z;
 
-			// Quantities from the overlap Mesh
-			const Face & faceOverlap = meshOverlap.faces[ixOverlap + i];
+			// Overlapping Faces
+			int nOverlapFaces = indexOverlap.GetFaceCount(ixFirst);
 
-			const NodeVector & nodesOverlap = meshOverlap.nodes;
+			// Sample coefficients
+			DataMatrix<double> dSampleCoeff;
+			dSampleCoeff.Initialize(nP, nP);
 
-			int nOverlapTriangles = faceOverlap.edges.size() - 2;
+			// Basis integral over all Overlap Faces
+			DataVector<double> dBasisIntArray;
+			dBasisIntArray.Initialize(nP * nP);
 
-			// Quantities from the Second Mesh
-			int ixSecond = meshOverlap.vecSecondFaceIx[ixOverlap + i];
+			// Build integration array
+			DataMatrix<double> dIntArray;
+			dIntArray.Initialize(nCoefficients, nOverlapFaces * nP * nP);
 
-			const NodeVector & nodesSecond = meshOutput.nodes;
+			// Area of each sub-triangle and coordinates of each quadrature
+			// point of all overlap Faces
+			std::vector<double> vecTriArea;
+			std::vector<double> vecNodes;
 
-			const Face & faceSecond = meshOutput.faces[ixSecond];
-
-			// Loop over all sub-triangles of this Overlap Face
-			for (int j = 0; j < nOverlapTriangles; j++) {
+			for (int i = 0; i < nOverlapFaces; i++) {
+				AppendQuadraturePoints(
+					quadOverlap,
+					indexOverlap.GetFace(ixFirst, i),
+					vecTriArea,
+					vecNodes);
+			}
 
-				// Cornerpoints of triangle
-				const Node & node0 = nodesOverlap[faceOverlap[0]];
-				const Node & node1 = nodesOverlap[faceOverlap[j+1]];
-				const Node & node2 = nodesOverlap[faceOverlap[j+2]];
+			// Find the coefficients of all points
+			std::vector<double> vecX(vecNodes);
 
-				// Calculate the area of the modified Face
-				Face faceTri(3);
-				faceTri.SetNode(0, faceOverlap[0]);
-				faceTri.SetNode(1, faceOverlap[j+1]);
-				faceTri.SetNode(2, faceOverlap[j+2]);
+			SolveFitSystems(dFit, static_cast<int>(vecX.size()) / 3, vecX);
 
-				double dTriArea =
-					CalculateFaceArea(faceTri, nodesOverlap);
+			// Loop through all Overlap Faces
+			int ixTri = 0;
+			int ixPoint = 0;
 
-				for (int k = 0; k < triquadrule.GetPoints(); k++) {
-					double * dGL = dG[k];
+			for (int i = 0; i < nOverlapFaces; i++) {
 
-					// Get the nodal location of this point
-					double dX[3];
+				// Quantities from the overlap Mesh
+				int ixOverlap = indexOverlap.GetFace(ixFirst, i);
 
-					dX[0] = dGL[0] * node0.x + dGL[1] * node1.x + dGL[2] * node2.x;
-					dX[1] = dGL[0] * node0.y + dGL[1] * node1.y + dGL[2] * node2.y;
-					dX[2] = dGL[0] * node0.z + dGL[1] * node1.z + dGL[2] * node2.z;
+				const Face & faceOverlap = meshOverlap.faces[ixOverlap];
 
-					double dMag =
-						sqrt(dX[0] * dX[0] + dX[1] * dX[1] + dX[2] * dX[2]);
+				int nOverlapTriangles = faceOverlap.edges.size() - 2;
 
-					dX[0] /= dMag;
-					dX[1] /= dMag;
-					dX[2] /= dMag;
+				// Quantities from the Second Mesh
+				int ixSecond = meshOverlap.vecSecondFaceIx[ixOverlap];
 
-					Node nodeQuadrature(dX[0], dX[1], dX[2]);
+				const NodeVector & nodesSecond = meshOutput.nodes;
 
-					// Find the coefficients for this point
-					int n = 3;
-					int nrhs = 1;
-					int lda = 3;
-					int ipiv[3];
-					int ldb = 3;
-					int info;
+				const Face & faceSecond = meshOutput.faces[ixSecond];
 
-					DataMatrix<double> dFitTemp;
-					dFitTemp = dFit;
-					dgesv_(
-						&n, &nrhs, &(dFitTemp[0][0]), &lda, ipiv, dX, &ldb, &info);
+				// Loop over all sub-triangles of this Overlap Face
+				for (int j = 0; j < nOverlapTriangles; j++) {
 
-					// Find the components of this quadrature point in the basis
-					// of the finite element.
-					double dAlpha;
-					double dBeta;
+					double dTriArea = vecTriArea[ixTri++];
 
-					ApplyInverseMap(
-						faceSecond,
-						nodesSecond,
-						nodeQuadrature,
-						dAlpha,
-						dBeta);
+					for (int k = 0; k < quadOverlap.GetPoints(); k++) {
+						const double * dNode = &(vecNodes[3 * ixPoint]);
+						const double * dX = &(vecX[3 * ixPoint]);
+						ixPoint++;
 
-					// Check inverse map value
-					if ((dAlpha < 0.0) || (dAlpha > 1.0) ||
-						(dBeta  < 0.0) || (dBeta  > 1.0)
-					) {
-						_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
-							dAlpha, dBeta);
-					}
+						Node nodeQuadrature(dNode[0], dNode[1], dNode[2]);
 
-					// Sample this point in the GLL element
-					int ixs = 0;
-					for (int s = 0; s < nP; s++) {
-					for (int t = 0; t < nP; t++) {
+						// Find the components of this quadrature point in the basis
+						// of the finite element.
+						double dAlpha;
+						double dBeta;
 
-						// Sample the finite element at this point
-						SampleGLLFiniteElement(
-							fMonotone, nP,
+						ApplyInverseMap(
+							faceSecond,
+							nodesSecond,
+							nodeQuadrature,
 							dAlpha,
-							dBeta,
-							dSampleCoeff);
-
-						double dPointwiseArea =
-							  dW[k]
-							* dSampleCoeff[s][t]
-							* dTriArea;
-
-						dLocalSecondArea[i][s][t] += dPointwiseArea;
-
-						dNumericalSecondArea[ixSecond * nP * nP + ixs]
-							+= dPointwiseArea;
-
-						int ixp = 0;
-						for (int p = 0; p < nOrder; p++) {
-						for (int q = 0; q < nOrder - p; q++) {
-
-							double dIntUpdate =
-								  IPow(dX[0], p)
-								* IPow(dX[1], q)
-								* dW[k]
-								* dSampleCoeff[s][t]
-								* dTriArea;
-
-							dIntArray[ixp][i * nP * nP + ixs] +=
-								dIntUpdate;
-
-							dGlobalIntArray[ixp][ixOverlap + i][ixs] +=
-								dIntUpdate / dataGLLJacobian[s][t][ixSecond];
+							dBeta);
+
+						// Check inverse map value
+						if ((dAlpha < 0.0) || (dAlpha > 1.0) ||
+							(dBeta  < 0.0) || (dBeta  > 1.0)
+						) {
+							_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
+								dAlpha, dBeta);
+						}
 
-							ixp++;
+						// Sample this point in the GLL element
+						int ixs = 0;
+						for (int s = 0; s < nP; s++) {
+						for (int t = 0; t < nP; t++) {
+
+							// Sample the finite element at this point
+							SampleGLLFiniteElement(
+								fMonotone, nP,
+								dAlpha,
+								dBeta,
+								dSampleCoeff);
+
+							int ixp = 0;
+							for (int p = 0; p < nOrder; p++) {
+							for (int q = 0; q < nOrder - p; q++) {
+
+								double dIntUpdate =
+									  IPow(dX[0], p)
+									* IPow(dX[1], q)
+									* dW[k]
+									* dSampleCoeff[s][t]
+									* dTriArea;
+
+								dIntArray[ixp][i * nP * nP + ixs] +=
+									dIntUpdate;
+
+								dGlobalIntArray[ixp][ixOverlap][ixs] +=
+									dIntUpdate / dataGLLJacobian[ixSecond][s * nP + t];
+
+								ixp++;
+							}
+							}
+							ixs++;
 						}
 						}
-						ixs++;
-					}
 					}
 				}
 			}
-		}
 
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
+		} catch(Exception & e) {
+			exFaces.Record(ixFirst, e);
+		}
 	}
 
-	// Reverse map
-	std::vector< std::vector<int> > vecReverseFaceIx;
-	vecReverseFaceIx.resize(meshOutput.faces.size());
-	for (int i = 0; i < meshOverlap.faces.size(); i++) {
-		int ixSecond = meshOverlap.vecSecondFaceIx[i];
+	exFaces.Rethrow();
 
-		vecReverseFaceIx[ixSecond].push_back(i);
-	}
+	// Overlap Faces of each Face on meshOutput
+	const OverlapFaceIndex & indexReverse = meshOverlap.secondfaceindex;
 
-	// Force consistency and conservation
-	for (int ixSecond = 0; ixSecond < meshOutput.faces.size(); ixSecond++) {
+	// Number of Faces on meshOutput
+	int nSecondFaces = static_cast<int>(meshOutput.faces.size());
 
-		DataMatrix<double> dCoeff;
-		dCoeff.Initialize(
-			nP * nP,
-			vecReverseFaceIx[ixSecond].size());
+	// Force consistency and conservation.  Each Face on meshOutput adjusts
+	// the rows of the integration array of its own overlap Faces.
+#pragma omp parallel for schedule(static)
+	for (int ixSecond = 0; ixSecond < nSecondFaces; ixSecond++) {
+		try {
+			DataMatrix<double> dCoeff;
+			dCoeff.Initialize(
+				nP * nP,
+				indexReverse.GetFaceCount(ixSecond));
 
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
+			for (int i = 0; i < indexReverse.GetFaceCount(ixSecond); i++) {
+				int ixOverlap = indexReverse.GetFace(ixSecond, i);
 
-			for (int s = 0; s < nP * nP; s++) {
-				dCoeff[s][i] = dGlobalIntArray[0][ixOverlap][s];
+				for (int s = 0; s < nP * nP; s++) {
+					dCoeff[s][i] = dGlobalIntArray[0][ixOverlap][s];
+				}
 			}
-		}
 /*
-		for (int s = 0; s < nP * nP; s++) {
-			double dConsistency = 0.0;
-			for (int i = 0; i < dCoeff.GetRows(); i++) {
-				dConsistency += dCoeff[i][s];
+			for (int s = 0; s < nP * nP; s++) {
+				double dConsistency = 0.0;
+				for (int i = 0; i < dCoeff.GetRows(); i++) {
+					dConsistency += dCoeff[i][s];
+				}
+				printf("%1.15e\n", dConsistency);
 			}
-			printf("%1.15e\n", dConsistency);
-		}
 */
 
-		// Target areas
-		DataVector<double> vecTargetArea;
-		vecTargetArea.Initialize(nP * nP);
+			// Target areas
+			DataVector<double> vecTargetArea;
+			vecTargetArea.Initialize(nP * nP);
 
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
+			for (int i = 0; i < dCoeff.GetRows(); i++) {
+				int ixOverlap = indexReverse.GetFace(ixSecond, i);
 
-			for (int s = 0; s < nP * nP; s++) {
-				vecTargetArea[s] =
-					dataGLLJacobian[s/nP][s%nP][ixSecond];
-					// meshOverlap.vecFaceArea[ixOverlap];
+				for (int s = 0; s < nP * nP; s++) {
+					vecTargetArea[s] =
+						dataGLLJacobian[ixSecond][s];
+						// meshOverlap.vecFaceArea[ixOverlap];
+				}
 			}
-		}
 
-		// Source areas
-		DataVector<double> vecSourceArea;
-		vecSourceArea.Initialize(vecReverseFaceIx[ixSecond].size());
+			// Source areas
+			DataVector<double> vecSourceArea;
+			vecSourceArea.Initialize(indexReverse.GetFaceCount(ixSecond));
 
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
-			vecSourceArea[i] = meshOverlap.vecFaceArea[ixOverlap];
-		}
+			for (int i = 0; i < indexReverse.GetFaceCount(ixSecond); i++) {
+				int ixOverlap = indexReverse.GetFace(ixSecond, i);
+				vecSourceArea[i] = meshOverlap.vecFaceArea[ixOverlap];
+			}
 
-		ForceIntArrayConsistencyConservation(
-			vecSourceArea,
-			vecTargetArea,
-			dCoeff,
-			false);
+			ForceConsistencyConservation(
+				vecSourceArea,
+				vecTargetArea,
+				dCoeff,
+				false);
 
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			double dConsistency = 0.0;
-			for (int j = 0; j < dCoeff.GetColumns(); j++) {
-				dConsistency += dCoeff[i][j];
+			for (int i = 0; i < dCoeff.GetRows(); i++) {
+				double dConsistency = 0.0;
+				for (int j = 0; j < dCoeff.GetColumns(); j++) {
+					dConsistency += dCoeff[i][j];
+				}
+				//printf("%1.15e\n", dConsistency);
 			}
-			//printf("%1.15e\n", dConsistency);
-		}
 
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
+			for (int i = 0; i < indexReverse.GetFaceCount(ixSecond); i++) {
+				int ixOverlap = indexReverse.GetFace(ixSecond, i);
 
-			for (int s = 0; s < nP * nP; s++) {
-				//printf("%1.15e %1.15e\n", dGlobalIntArray[0][ixOverlap][s], dCoeff[s][i]);
-				dGlobalIntArray[0][ixOverlap][s] = dCoeff[s][i];
+				for (int s = 0; s < nP * nP; s++) {
+					//printf("%1.15e %1.15e\n", dGlobalIntArray[0][ixOverlap][s], dCoeff[s][i]);
+					dGlobalIntArray[0][ixOverlap][s] = dCoeff[s][i];
+				}
 			}
-		}
 
 /*
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			double dConsistency = 0.0;
-			for (int j = 0; j < dCoeff.GetColumns(); j++) {
-				dConsistency += dCoeff[i][j];
+			for (int i = 0; i < dCoeff.GetRows(); i++) {
+				double dConsistency = 0.0;
+				for (int j = 0; j < dCoeff.GetColumns(); j++) {
+					dConsistency += dCoeff[i][j];
+				}
+				printf("%1.15e\n", dConsistency);
 			}
-			printf("%1.15e\n", dConsistency);
-		}
 
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			int ixFirst = vecReverseFaceIx[ixSecond][i];
+			for (int i = 0; i < dCoeff.GetRows(); i++) {
+				int ixFirst = indexReverse.GetFace(ixSecond, i);
 
-			for (int s = 0; s < dCoeff.GetColumns(); s++) {
-				vecTargetArea[i] += dCoeff[i][s]
-					* dataGLLJacobian[s/nP][s%nP][ixSecond]
-					 meshInput.vecFaceArea[ixFirst];
+				for (int s = 0; s < dCoeff.GetColumns(); s++) {
+					vecTargetArea[i] += dCoeff[i][s]
+						* dataGLLJacobian[ixSecond][s]
+						 meshInput.vecFaceArea[ixFirst];
+				}
+				printf("%1.15e\n", vecTargetArea[i]);
 			}
-			printf("%1.15e\n", vecTargetArea[i]);
-		}
 */
 /*
-		double dConsistency = 0.0;
-		double dConservation = 0.0;
+			double dConsistency = 0.0;
+			double dConservation = 0.0;
 
-		int ixFirst = meshOverlap.vecFirstFaceIx[i];
-		int ixSecond = meshOverlap.vecSecondFaceIx[i];
+			int ixFirst = meshOverlap.vecFirstFaceIx[i];
+			int ixSecond = meshOverlap.vecSecondFaceIx[i];
 
-		for (int s = 0; s < nP * nP; s++) {
-			//dConsistency += dGlobalIntArray[0][i][s];
-			dConservation += dGlobalIntArray[0][i][s]
-				* dataGLLJacobian[s/nP][s%nP][ixSecond]
-				/ meshInput.vecFaceArea[ixFirst];
+			for (int s = 0; s < nP * nP; s++) {
+				//dConsistency += dGlobalIntArray[0][i][s];
+				dConservation += dGlobalIntArray[0][i][s]
+					* dataGLLJacobian[ixSecond][s]
+					/ meshInput.vecFaceArea[ixFirst];
 
-			printf("%1.15e\n", dataGLLJacobian[s/nP][s%nP][ixSecond]);
-		}
+				printf("%1.15e\n", dataGLLJacobian[ixSecond][s]);
+			}
 
-		//printf("Consistency: %1.15e\n", dConsistency);
-		printf("Conservation: %1.15e\n", dConservation);
+			//printf("Consistency: %1.15e\n", dConsistency);
+			printf("Conservation: %1.15e\n", dConservation);
 
-		_EXCEPTION();
+			_EXCEPTION();
 */
+
+		} catch(Exception & e) {
+			exFaces.Record(ixSecond, e);
+		}
 	}
+
+	exFaces.Rethrow();
+
 /*
 	// Check consistency
 	DataMatrix<double> dIntSums;
@@ -1574,7 +1917,7 @@ void LinearRemapFVtoGLL(
 		int ixSecond = meshOverlap.vecSecondFaceIx[i];
 
 		dMassSums[ixFirst] += dGlobalIntArray[0][i][s]
-			* dataGLLJacobian[s/nP][s%nP][ixSecond]
+			* dataGLLJacobian[ixSecond][s]
 			/ meshInput.vecFaceArea[ixFirst];
 	}
 	}
@@ -1596,215 +1939,200 @@ void LinearRemapFVtoGLL(
 	// Impose conservative and consistent conditions on integration array
 	//_EXCEPTION();
 
-	// Construct finite-volume fit matrix and compose with integration operator
-	ixOverlap = 0;
-
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
-
-		// Output every 100 elements
-		if (ixFirst % 100 == 0) {
-			Announce("Element %i", ixFirst);
-		}
+	// Number of threads processing Faces
+	int nThreads = 1;
+#ifdef _OPENMP
+	nThreads = omp_get_max_threads();
+#endif
+
+	// Search buffers of each thread
+	std::vector<AdjacentFaceBuffer> vecBuffers(nThreads);
+
+	// Construct finite-volume fit matrix and compose with integration
+	// operator.  Each thread processes a contiguous range of Faces, so that
+	// contributions are added to the map in the same order as in serial.
+#pragma omp parallel for schedule(static) num_threads(nThreads)
+	for (int ixFirst = 0; ixFirst < nFirstFaces; ixFirst++) {
+		try {
+			int iThread = 0;
+#ifdef _OPENMP
+			iThread = omp_get_thread_num();
+#endif
+
+			// Output every 100 elements
+			if (ixFirst % 100 == 0) {
+#pragma omp critical(Announce)
+				Announce("Element %i", ixFirst);
+			}
 
-		// This Face
-		const Face & faceFirst = meshInput.faces[ixFirst];
+			// This Face
+			const Face & faceFirst = meshInput.faces[ixFirst];
 
-		// Area of the First Face
-		double dFirstArea = meshInput.vecFaceArea[ixFirst];
+			// Area of the First Face
+			double dFirstArea = meshInput.vecFaceArea[ixFirst];
 
-		// Coordinate axes
-		const Node & nodeRef = meshInput.nodes[faceFirst[0]];
+			// Coordinate axes
+			const Node & nodeRef = meshInput.nodes[faceFirst[0]];
 
-		Node nodeA1 = meshInput.nodes[faceFirst[1]] - nodeRef;
-		Node nodeA2 = meshInput.nodes[faceFirst[2]] - nodeRef;
+			Node nodeA1 = meshInput.nodes[faceFirst[1]] - nodeRef;
+			Node nodeA2 = meshInput.nodes[faceFirst[2]] - nodeRef;
 
-		Node nodeC = CrossProduct(nodeA1, nodeA2);
+			Node nodeC = CrossProduct(nodeA1, nodeA2);
 
-		// Fit matrix
-		DataMatrix<double> dFit;
-		dFit.Initialize(3,3);
+			// Fit matrix
+			DataMatrix<double> dFit;
+			dFit.Initialize(3,3);
 
-		dFit[0][0] = nodeA1.x; dFit[0][1] = nodeA1.y; dFit[0][2] = nodeA1.z;
-		dFit[1][0] = nodeA2.x; dFit[1][1] = nodeA2.y; dFit[1][2] = nodeA2.z;
-		dFit[2][0] = nodeC.x;  dFit[2][1] = nodeC.y;  dFit[2][2] = nodeC.z;
+			dFit[0][0] = nodeA1.x; dFit[0][1] = nodeA1.y; dFit[0][2] = nodeA1.z;
+			dFit[1][0] = nodeA2.x; dFit[1][1] = nodeA2.y; dFit[1][2] = nodeA2.z;
+			dFit[2][0] = nodeC.x;  dFit[2][1] = nodeC.y;  dFit[2][2] = nodeC.z;
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
-		int nTotalOverlapTriangles = nAllTotalOverlapTriangles[ixFirst];
+			// Overlapping Faces
+			int nOverlapFaces = indexOverlap.GetFaceCount(ixFirst);
 
-		// Verify equal partition of mass in integration array
-		double dTotal = 0.0;
-		for (int i = 0; i < nOverlapFaces; i++) {
-			int ixSecond = meshOverlap.vecSecondFaceIx[ixOverlap + i];
+			// Verify equal partition of mass in integration array
+			double dTotal = 0.0;
+			for (int i = 0; i < nOverlapFaces; i++) {
+				int ixOverlap = indexOverlap.GetFace(ixFirst, i);
+				int ixSecond = meshOverlap.vecSecondFaceIx[ixOverlap];
 
-			for (int s = 0; s < nP * nP; s++) {
-				dTotal += dGlobalIntArray[0][ixOverlap + i][s]
-					* dataGLLJacobian[s/nP][s%nP][ixSecond]
-					/ dFirstArea;
+				for (int s = 0; s < nP * nP; s++) {
+					dTotal += dGlobalIntArray[0][ixOverlap][s]
+						* dataGLLJacobian[ixSecond][s]
+						/ dFirstArea;
+				}
+			}
+			if (fabs(dTotal - 1.0) > 1.0e-8) {
+				printf("%1.15e\n", dTotal);
+				_EXCEPTION();
 			}
-		}
-		if (fabs(dTotal - 1.0) > 1.0e-8) {
-			printf("%1.15e\n", dTotal);
-			_EXCEPTION();
-		}
 
-		// Determine the conservative constraint equation
-		DataVector<double> dConstraint;
-		dConstraint.Initialize(nCoefficients);
+			// Determine the conservative constraint equation
+			DataVector<double> dConstraint;
+			dConstraint.Initialize(nCoefficients);
 
-		for (int p = 0; p < nCoefficients; p++) {
-		for (int i = 0; i < nOverlapFaces; i++) {
-			int ixSecond = meshOverlap.vecSecondFaceIx[ixOverlap + i];
+			for (int p = 0; p < nCoefficients; p++) {
+			for (int i = 0; i < nOverlapFaces; i++) {
+				int ixOverlap = indexOverlap.GetFace(ixFirst, i);
+				int ixSecond = meshOverlap.vecSecondFaceIx[ixOverlap];
 
-			for (int s = 0; s < nP * nP; s++) {
-				dConstraint[p] += dGlobalIntArray[p][ixOverlap + i][s]
-					* dataGLLJacobian[s/nP][s%nP][ixSecond]
-					/ dFirstArea;
+				for (int s = 0; s < nP * nP; s++) {
+					dConstraint[p] += dGlobalIntArray[p][ixOverlap][s]
+						* dataGLLJacobian[ixSecond][s]
+						/ dFirstArea;
+				}
+			}
 			}
-		}
-		}
 /*
-		for (int p = 0; p < nCoefficients; p++) {
-		for (int j = 0; j < nOverlapFaces * nP * nP; j++) {
-			dConstraint[p] += dIntArray[p][j] / dFirstArea;
-		}
-		}
+			for (int p = 0; p < nCoefficients; p++) {
+			for (int j = 0; j < nOverlapFaces * nP * nP; j++) {
+				dConstraint[p] += dIntArray[p][j] / dFirstArea;
+			}
+			}
 */
-		// Set of Faces to use in building the reconstruction and associated
-		// distance metric.
-		AdjacentFaceVector vecAdjFaces;
-
-		GetAdjacentFaceVector(
-			meshInput,
-			ixFirst,
-			nRequiredFaceSetSize,
-			vecAdjFaces);
-
-		// Number of adjacent Faces
-		int nAdjFaces = vecAdjFaces.size();
-
-		// Least squares arrays
-		DataMatrix<double> dFitArray;
-		DataVector<double> dFitWeights;
-		DataMatrix<double> dFitArrayPlus;
-
-		BuildFitArray(
-			meshInput,
-			ixFirst,
-			vecAdjFaces,
-			nOrder,
-			dConstraint,
-			dFitArray,
-			dFitWeights,
-			dFitArrayPlus
-		);
-
-/*
-		DataVector<double> dRowSum;
-		dRowSum.Initialize(nCoefficients);
+			// Set of Faces to use in building the reconstruction and associated
+			// distance metric, and the fit array of the reconstruction.
+			AdjacentFaceVector vecAdjFaces;
+			DataMatrix<double> dFitArray;
+
+			if (pReconstruction != NULL) {
+				pReconstruction->GetFace(ixFirst, vecAdjFaces, dFitArray);
+
+			} else {
+				GetAdjacentFaceVector(
+					meshInput,
+					ixFirst,
+					nRequiredFaceSetSize,
+					vecAdjFaces,
+					vecBuffers[iThread]);
+
+				BuildFitArray(
+					meshInput,
+					quadInput,
+					ixFirst,
+					vecAdjFaces,
+					nOrder,
+					dFitArray);
+			}
 
-		for (int i = 0; i < nAdjFaces; i++) {
-		for (int k = 0; k < nCoefficients; k++) {
-			dRowSum[k] += dFitArrayPlus[i][k];
-		}
-		}
+			// Number of adjacent Faces
+			int nAdjFaces = vecAdjFaces.size();
 
-		for (int k = 0; k < nCoefficients; k++) {
-			printf("%1.15e\n", dRowSum[k]);
-		}
-		_EXCEPTION();
-*/
+			// Least squares arrays
+			DataVector<double> dFitWeights;
+			DataMatrix<double> dFitArrayPlus;
 
-		// Multiply integration array and fit array
-		DataMatrix<double> dComposedArray;
-		dComposedArray.Initialize(nAdjFaces, nOverlapFaces * nP * nP);
+			InvertFitArray(
+				nOrder,
+				dConstraint,
+				dFitArray,
+				dFitWeights,
+				dFitArrayPlus
+			);
 
-		for (int j = 0; j < nOverlapFaces; j++) {
-			int ixSecond = meshOverlap.vecSecondFaceIx[ixOverlap + j];
+/*
+			DataVector<double> dRowSum;
+			dRowSum.Initialize(nCoefficients);
 
 			for (int i = 0; i < nAdjFaces; i++) {
-			for (int s = 0; s < nP * nP; s++) {
 			for (int k = 0; k < nCoefficients; k++) {
-				dComposedArray[i][j * nP * nP + s] +=
-					dGlobalIntArray[k][ixOverlap + j][s]
-					* dFitArrayPlus[i][k];
-			}
+				dRowSum[k] += dFitArrayPlus[i][k];
 			}
 			}
-		}
-
-		// Put composed array into map
-		for (int i = 0; i < vecAdjFaces.size(); i++) {
-		for (int j = 0; j < nOverlapFaces; j++) {
-			int ixFirstFace = vecAdjFaces[i].first;
-			int ixSecondFace = meshOverlap.vecSecondFaceIx[ixOverlap + j];
 
-			for (int s = 0; s < nP; s++) {
-			for (int t = 0; t < nP; t++) {
+			for (int k = 0; k < nCoefficients; k++) {
+				printf("%1.15e\n", dRowSum[k]);
+			}
+			_EXCEPTION();
+*/
 
-				int jx = j * nP * nP + s * nP + t;
+			// Multiply integration array and fit array
+			DataMatrix<double> dComposedArray;
+			dComposedArray.Initialize(nAdjFaces, nOverlapFaces * nP * nP);
 
-				int ixSecondNode = ixSecondFace * nP * nP + s * nP + t;//dataGLLNodes[s][t][ixSecondFace]-1;
+			for (int j = 0; j < nOverlapFaces; j++) {
+				int ixOverlap = indexOverlap.GetFace(ixFirst, j);
+				int ixSecond = meshOverlap.vecSecondFaceIx[ixOverlap];
 
-				smatMap(ixSecondNode, ixFirstFace) +=
-					dComposedArray[i][jx];
-					// dataUniqueJacobian[ixSecondNode];
-			}
+				for (int i = 0; i < nAdjFaces; i++) {
+				for (int s = 0; s < nP * nP; s++) {
+				for (int k = 0; k < nCoefficients; k++) {
+					dComposedArray[i][j * nP * nP + s] +=
+						dGlobalIntArray[k][ixOverlap][s]
+						* dFitArrayPlus[i][k];
+				}
+				}
+				}
 			}
-		}
-		}
-
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
-	}
-
-/*
-	double dTotal = 0.0;
-	for (int i = 0; i < dNumericalSecondArea.GetRows(); i++) {
-		if (dNumericalSecondArea[i] == 0.0) {
-			printf("%i\n", i);
-		}
-		dTotal += dNumericalSecondArea[i];
-	}
-	printf("%1.15e\n", dTotal);
-	_EXCEPTION();
-*/
-/*
-	// Loop through all entries in the sparse matrix and divide by the
-	// numerical area.
-	DataVector<int> dataRows;
-	DataVector<int> dataCols;
-	DataVector<double> dataEntries;
 
-	smatMap.GetEntries(dataRows, dataCols, dataEntries);
+			// Put composed array into map
+			for (int i = 0; i < vecAdjFaces.size(); i++) {
+			for (int j = 0; j < nOverlapFaces; j++) {
+				int ixFirstFace = vecAdjFaces[i].first;
+				int ixSecondFace =
+					meshOverlap.vecSecondFaceIx[indexOverlap.GetFace(ixFirst, j)];
 
-	for (int i = 0; i < dataEntries.GetRows(); i++) {
-		int ixSecond = dataRows[i];
-		dataEntries[i] /= dNumericalSecondArea[ixSecond];
-	}
+				for (int s = 0; s < nP; s++) {
+				for (int t = 0; t < nP; t++) {
 
-	smatMap.SetEntries(dataRows, dataCols, dataEntries);
-*/
-/*
-	for (int i = 0; i < meshOutput.faces.size(); i++) {
-		double dTotalArea = 0.0;
+					int jx = j * nP * nP + s * nP + t;
 
-		int ixs = 0;
-		for (int s = 0; s < nP; s++) {
-		for (int t = 0; t < nP; t++) {
-			dTotalArea += dNumericalSecondArea[i * nP * nP + ixs];
+					int ixSecondNode = ixSecondFace * nP * nP + s * nP + t;//dataGLLNodes[ixSecondFace][s * nP + t]-1;
 
-			ixs++;
-		}
-		}
+					smatMap.Add(ixSecondNode, ixFirstFace,
+						dComposedArray[i][jx]);
+						// dataUniqueJacobian[ixSecondNode];
+				}
+				}
+			}
+			}
 
-		if (fabs(dTotalArea - meshOutput.vecFaceArea[i]) > 1.0e-12) {
-			printf("%1.15e %1.15e\n", dTotalArea, meshOutput.vecFaceArea[i]);
+		} catch(Exception & e) {
+			exFaces.Record(ixFirst, e);
 		}
-		
 	}
-	_EXCEPTION();
-*/
+
+	exFaces.Rethrow();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -17,42 +17,186 @@
 #ifndef _LINEARREMAPFV_H_
 #define _LINEARREMAPFV_H_
 
-#include "DataMatrix3D.h"
+#include "DataVector.h"
+#include "DataMatrix.h"
+#include "GLLElementData.h"
+
+#include <string>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 class Mesh;
 class OfflineMap;
+class FaceQuadratureTable;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Face index and distance metric pair.
+///	</summary>
+typedef std::pair<int, int> FaceDistancePair;
+
+///	<summary>
+///		Vector storing adjacent Faces.
+///	</summary>
+typedef std::vector<FaceDistancePair> AdjacentFaceVector;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		The finite volume reconstruction operator of a Mesh, consisting of
+///		the adjacent Faces and the fit array of each Face.  The operator
+///		depends only on the Mesh and the order of the reconstruction, so it
+///		can be computed once and reused for maps to any number of target
+///		meshes.
+///	</summary>
+class FVReconstructionOperator {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	FVReconstructionOperator() :
+		m_nOrder(0),
+		m_nNodes(0),
+		m_dArea(0.0)
+	{ }
+
+public:
+	///	<summary>
+	///		Compute the reconstruction operator of order nOrder for all Faces
+	///		of mesh.  The ReverseNodeArray and Face areas of mesh must have
+	///		been calculated.
+	///	</summary>
+	void Initialize(
+		const Mesh & mesh,
+		int nOrder
+	);
+
+	///	<summary>
+	///		Load the reconstruction operator from a NetCDF file.
+	///	</summary>
+	void Read(
+		const std::string & strInput
+	);
+
+	///	<summary>
+	///		Write the reconstruction operator to a NetCDF file.
+	///	</summary>
+	void Write(
+		const std::string & strOutput
+	) const;
+
+	///	<summary>
+	///		Verify the reconstruction operator was computed for mesh with
+	///		order nOrder.
+	///	</summary>
+	void Validate(
+		const Mesh & mesh,
+		int nOrder
+	) const;
+
+	///	<summary>
+	///		Get the adjacent Faces and fit array of Face ixFace.
+	///	</summary>
+	void GetFace(
+		int ixFace,
+		AdjacentFaceVector & vecAdjFaces,
+		DataMatrix<double> & dFitArray
+	) const;
+
+	///	<summary>
+	///		Order of the reconstruction.
+	///	</summary>
+	int GetOrder() const {
+		return m_nOrder;
+	}
+
+	///	<summary>
+	///		Number of Faces.
+	///	</summary>
+	int GetFaceCount() const {
+		return static_cast<int>(m_vecAdjBegin.GetRows()) - 1;
+	}
+
+protected:
+	///	<summary>
+	///		Order of the reconstruction.
+	///	</summary>
+	int m_nOrder;
+
+	///	<summary>
+	///		Number of Nodes of the Mesh.
+	///	</summary>
+	int m_nNodes;
+
+	///	<summary>
+	///		Total area of the Mesh.
+	///	</summary>
+	double m_dArea;
+
+	///	<summary>
+	///		Index of the first adjacent Face of each Face, followed by the
+	///		total number of adjacent Faces.
+	///	</summary>
+	DataVector<int> m_vecAdjBegin;
+
+	///	<summary>
+	///		Indices of the adjacent Faces of all Faces.
+	///	</summary>
+	DataVector<int> m_vecAdjFaceIx;
+
+	///	<summary>
+	///		Distance metric of the adjacent Faces of all Faces.
+	///	</summary>
+	DataVector<int> m_vecAdjDistance;
+
+	///	<summary>
+	///		Fit array coefficients of each adjacent Face.
+	///	</summary>
+	DataVector<double> m_dFitArray;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
 ///		Generate the OfflineMap for remapping from finite volumes to finite
-///		volumes.
+///		volumes.  If pReconstruction is not NULL the reconstruction operator
+///		of meshInput is taken from pReconstruction.  If pOverlapQuadrature
+///		is not NULL the quadrature points of meshOverlap are taken from
+///		pOverlapQuadrature.
 ///	</summary>
 void LinearRemapFVtoFV(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
 	int nOrder,
-	OfflineMap & mapRemap
+	OfflineMap & mapRemap,
+	const FVReconstructionOperator * pReconstruction = NULL,
+	const FaceQuadratureTable * pOverlapQuadrature = NULL
 );
 
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
 ///		Generate the OfflineMap for remapping from finite volumes to finite
-///		elements.
+///		elements.  If pReconstruction is not NULL the reconstruction
+///		operator of meshInput is taken from pReconstruction.  If
+///		pOverlapQuadrature is not NULL the quadrature points of meshOverlap
+///		are taken from pOverlapQuadrature.
 ///	</summary>
 void LinearRemapFVtoGLL(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
-	const DataMatrix3D<int> & dataGLLNodes,
-	const DataMatrix3D<double> & dataGLLJacobian,
+	const GLLElementData<int> & dataGLLNodes,
+	const GLLElementData<double> & dataGLLJacobian,
 	int nOrder,
 	OfflineMap & mapRemap,
-	bool fMonotone = false
+	bool fMonotone = false,
+	const FVReconstructionOperator * pReconstruction = NULL,
+	const FaceQuadratureTable * pOverlapQuadrature = NULL
 );
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -18,156 +18,66 @@
 #include "OfflineMap.h"
 #include "FiniteElementTools.h"
 #include "GaussLobattoQuadrature.h"
-#include "TriangularQuadrature.h"
+#include "FaceQuadratureTable.h"
 
 #include "Announce.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
-
-extern "C" {
-/*
-	/// Routine from DQED.h to solve constrained bounded least squares problems
-	void dbocls_(
-		double * w,
-		int * mdw,
-		int * mcon,
-		int * mrows,
-		int * ncols,
-		double * bl,
-		double * bu,
-		int * ind,
-		int * iopt,
-		double * x,
-		double * rnormc,
-		double * rnorm,
-		int * mode,
-		double * rw,
-		int * iw);
-*/
-	/// Matrix vector multiply
-	int dgemv_(
-		char * trans,
-		int * m,
-		int * n,
-		double * alpha,
-		double * a,
-		int * lda,
-		double * x,
-		int * incx,
-		double * beta,
-		double * y,
-		int * incy);
-
-	///	General matrix solver from CLAPACK
-	int dgesv_(
-		int * n,
-		int * nrhs,
-		double * a,
-		int * lda,
-		int * ipiv,
-		double * b,
-		int * ldb,
-		int * info);
-
-	/// Symmetric positive definite matrix solver from CLAPACK
-	int dposv_(
-		char * uplo,
-		int * n,
-		int * nrhs,
-		double * a,
-		int * lda,
-		double * b,
-		int * ldb,
-		int * info);
-
-	/// Symmetric matrix solver from CLAPACK
-	int dsysv_(
-		char * uplo,
-		int * n,
-		int * nrhs,
-		double * a,
-		int * lda,
-		int * ipiv,
-		double * b,
-		int * ldb,
-		double * work,
-		int * lwork,
-		int * info);
-
-	/// Constrained least squares solver
-	int dgglse_(
-		int * m,
-		int * n,
-		int * p,
-		double * a,
-		int * lda,
-		double * b,
-		int * ldb,
-		double * c,
-		double * d,
-		double * x,
-		double * work,
-		int * lwork,
-		int * info);
-}
-
-///////////////////////////////////////////////////////////////////////////////
-
 void LinearRemapSE0(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
-	const DataMatrix3D<int> & dataGLLNodes,
-	const DataMatrix3D<double> & dataGLLJacobian,
+	const GLLElementData<int> & dataGLLNodes,
+	const GLLElementData<double> & dataGLLJacobian,
 	OfflineMap & mapRemap
 ) {
 	// Order of the polynomial interpolant
-	int nP = dataGLLNodes.GetRows();
-
-	// Total cell Jacobian
-	double dTotalJacobian;
+	int nP = dataGLLNodes.GetNp();
 
 	// Get SparseMatrix represntation of the OfflineMap
 	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
 
+	// Total element Jacobian of each first Mesh element
+	int nFirstFaces = static_cast<int>(meshInput.faces.size());
+
+	DataVector<double> vecTotalJacobian;
+	vecTotalJacobian.Initialize(nFirstFaces);
+
+#pragma omp parallel for schedule(static)
+	for (int ixFirst = 0; ixFirst < nFirstFaces; ixFirst++) {
+		const double * pJacobian = dataGLLJacobian[ixFirst];
+
+		for (int s = 0; s < nP * nP; s++) {
+			vecTotalJacobian[ixFirst] += pJacobian[s];
+		}
+	}
+
 	// Loop through all elements in the overlap mesh
-	int ixLastFirstMeshFace = (-1);
-	int ixCurrentFirstMeshFace;
-	int ixCurrentSecondMeshFace;
+	int nOverlapFaces = static_cast<int>(meshOverlap.faces.size());
 
-	for (int i = 0; i < meshOverlap.faces.size(); i++) {
-		ixCurrentFirstMeshFace = meshOverlap.vecFirstFaceIx[i];
-		ixCurrentSecondMeshFace = meshOverlap.vecSecondFaceIx[i];
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nOverlapFaces; i++) {
+		int ixCurrentFirstMeshFace = meshOverlap.vecFirstFaceIx[i];
+		int ixCurrentSecondMeshFace = meshOverlap.vecSecondFaceIx[i];
 
 		double dSecondFaceArea =
 			meshOutput.vecFaceArea[ixCurrentSecondMeshFace];
 
-		// Recalculate total element Jacobian for this first Mesh element
-		if (ixLastFirstMeshFace != ixCurrentFirstMeshFace) {
+		double dTotalJacobian = vecTotalJacobian[ixCurrentFirstMeshFace];
 
-			// Calculate total element Jacobian
-			dTotalJacobian = 0.0;
-			for (int p = 0; p < nP; p++) {
-			for (int q = 0; q < nP; q++) {
-				dTotalJacobian += dataGLLJacobian[p][q][ixCurrentFirstMeshFace];
-			}
-			}
-
-			ixLastFirstMeshFace = ixCurrentFirstMeshFace;
-		}
+		const int * pFirstNodes = dataGLLNodes[ixCurrentFirstMeshFace];
+		const double * pFirstJacobian = dataGLLJacobian[ixCurrentFirstMeshFace];
 
 		// Determine remap coefficients
-		for (int p = 0; p < nP; p++) {
-		for (int q = 0; q < nP; q++) {
-			int ixFirstGlobal = dataGLLNodes[p][q][ixCurrentFirstMeshFace] - 1;
+		for (int s = 0; s < nP * nP; s++) {
+			int ixFirstGlobal = pFirstNodes[s] - 1;
 
-			smatMap(ixCurrentSecondMeshFace, ixFirstGlobal) +=
-				dataGLLJacobian[p][q][ixCurrentFirstMeshFace]
+			smatMap.Add(ixCurrentSecondMeshFace, ixFirstGlobal,
+				pFirstJacobian[s]
 				/ dTotalJacobian
 				* meshOverlap.vecFaceArea[i]
-				/ dSecondFaceArea;
-		}
+				/ dSecondFaceArea);
 		}
 	}
 }
@@ -180,514 +90,70 @@ void ForceConsistencyConservation(
 	DataMatrix<double> & dCoeff,
 	bool fMonotone
 ) {
-	int ncols = dCoeff.GetRows() * dCoeff.GetColumns();
-	int mrows = dCoeff.GetRows() * dCoeff.GetColumns();
-	//int mcon = dCoeff.GetRows() + dCoeff.GetColumns();
-	int mcon = dCoeff.GetColumns();
-
-	int mdw = mcon + mrows;
-
-	// Allocate arrays
-	DataMatrix<double> dW;
-	dW.Initialize(ncols+mcon+1, mdw);
-
-	DataVector<double> dBL;
-	dBL.Initialize(ncols + mcon);
-
-	DataVector<double> dBU;
-	dBU.Initialize(ncols + mcon);
-
-	DataVector<double> dX;
-	dX.Initialize(2*(ncols+mcon)+2);
-
-	DataVector<double> dRW;
-	dRW.Initialize(6 * ncols + 5 * mcon);
-
-	DataVector<int> iInd;
-	iInd.Initialize(ncols + mcon);
-
-	DataVector<int> iOpt;
-	iOpt.Initialize(32);
-	iOpt[0] = 99;
-
-	DataVector<int> iIW;
-	iIW.Initialize(2*(ncols+mcon));
-
-	double dRNormC = -1.0;
-	double dRNorm = -1.0;
-	int iMode = -1;
-
-	// Matrix elements
-	int ix = 0;
-/*
-	// Consistency
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dW[i * dCoeff.GetColumns() + j][ix] = 1.0;
-		}
-		ix++;
-	}
-*/
-	// Conservation
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			dW[i * dCoeff.GetColumns() + j][ix] = vecTargetArea[i];
-		}
-		ix++;
-	}
-
-	// Least squares problem:
-	// Minimize L2 error between high-order coefficients and new coefficients
-	ix = 0;
-
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dW[ix][ix + mcon] = 1.0;
-		dW[ncols][ix + mcon] = dCoeff[i][j];
-		ix++;
-	}
-	}
-
-	FILE * fp = fopen("w.txt", "w");
-	for (int i = 0; i < dW.GetRows(); i++) {
-		for (int j = 0; j < dW.GetColumns(); j++) {
-			fprintf(fp, "%1.10e ", dW[i][j]);
-		}
-		fprintf(fp, "\n");
-	}
-	fclose(fp);
-
-	// Apply constraints
-	ix = 0;
-
-	// Monotonicity
-	if (fMonotone) {
-		for (int i = 0; i < ncols; i++) {
-			dBL[ix] = 0.0;
-			dBU[ix] = 1.0;
-			iInd[ix] = 3;
-			ix++;
-		}
-
-	} else {
-		for (int i = 0; i < ncols; i++) {
-			iInd[ix] = 4;
-			ix++;
-		}
-	}
-/*
-	// Consistency
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dBL[ix] = 1.0;
-		dBU[ix] = 1.0;
-		iInd[ix] = 3;
-		ix++;
-	}
-*/
-	// Conservation
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dBL[ix] = vecSourceArea[j];
-		dBU[ix] = vecSourceArea[j];
-		iInd[ix] = 3;
-		ix++;
-	}
-/*
-	for (int i = 0; i < dBL.GetRows(); i++) {
-		printf("B%i: %1.15e %1.15e %i\n", i, dBL[i], dBU[i], iInd[i]);
-	}
-*/
-	// Solve least squares problem
-	DataMatrix<double> dWin = dW;
-/*
-	dbocls_(
-		&(dW[0][0]),
-		&mdw,
-		&mcon,
-		&mrows,
-		&ncols,
-		dBL,
-		dBU,
-		iInd,
-		iOpt,
-		dX,
-		&dRNormC,
-		&dRNorm,
-		&iMode,
-		dRW,
-		iIW);
-*/
-	if (iMode >= 0) {
-		printf("\nSUCCESS (%i)\n", iMode);
-	} else {
-		_EXCEPTION1("\nFAIL (%i)\n", iMode);
-	}
-
-	printf("\nNorm: %1.15e %1.15e\n", dRNorm, dRNormC);
-/*
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetColumns(); i++) {
-		double dProduct = 0.0;
-		for (int j = 0; j < dCoeff.GetColumns() * dCoeff.GetRows(); j++) {
-			dProduct += dWin[j][i] * dX[j];
-		}
-		printf("%1.15e %1.15e\n", dProduct, vecSourceArea[i]);
-	}
-
-	for (int i = 0; i < dX.GetRows(); i++) {
-		printf("X%i: %1.15e\n", i, dX[i]);
-	}
-
-	for (int i = 0; i < dBL.GetRows(); i++) {
-		printf("B%i: %1.15e %1.15e %i\n", i, dBL[i], dBU[i], iInd[i]);
-	}
-
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		//printf("%1.15e %1.15e\n", dCoeff[i][j], dX[ix]);
-		printf("%1.15e, ", dX[ix]);
-		ix++;
-	}
-	}
-*/
-}
-
-///////////////////////////////////////////////////////////////////////////////
-
-void ForceConsistencyConservation2(
-	const DataVector<double> & vecSourceArea,
-	const DataVector<double> & vecTargetArea,
-	DataMatrix<double> & dCoeff,
-	bool fMonotone
-) {
-	// Number of free coefficients
-	int nCoeff = dCoeff.GetRows() * dCoeff.GetColumns();
-
-	// Number of conditions
-	int nCondConservation = dCoeff.GetColumns();
-	int nCondConsistency  = dCoeff.GetRows();
-
-	// One condition is dropped due to linear dependence
-	int nCond = nCondConservation + nCondConsistency - 1;
-
-	// The Lagrangian matrix and RHS vector
-	DataMatrix<double> dLagrangian;
-	dLagrangian.Initialize(nCoeff + nCond, nCoeff + nCond);
-
-	DataVector<double> dRHS;
-	dRHS.Initialize(nCoeff + nCond);
-
-	// Build the Lagrangian matrix
-	int ix = 0;
-
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-
-		// Least squares conditions
-		dLagrangian[ix][ix] = 1.0;
-		dLagrangian[nCoeff + i][ix] = - 1.0;
-
-		if (j != dCoeff.GetColumns()-1) {
-			dLagrangian[nCoeff + nCondConsistency + j][ix] = - vecTargetArea[i];
-		}
-
-		// Consistency
-		dLagrangian[ix][nCoeff + i] = -1.0;
-
-		// Conservation
-		if (j != dCoeff.GetColumns()-1) {
-			dLagrangian[ix][nCoeff + nCondConsistency + j] = - vecTargetArea[i];
-		}
+	// The coefficients are the L2 projection of dCoeff onto the affine
+	// space given by the consistency conditions (unit row sums) and the
+	// conservation conditions (sum_i A_i c_ij = a_j, the last of which is
+	// dropped due to linear dependence).  The constraint matrix C has
+	// C C^T = [[ nCols I, A 1^T ], [ 1 A^T, (A.A) I ]], so the Schur system
+	// for the Lagrange multipliers is solved in closed form.
+	int nRows = dCoeff.GetRows();
+	int nCols = dCoeff.GetColumns();
+
+	// Constraint residuals of the unprojected coefficients
+	DataVector<double> dRowResidual;
+	dRowResidual.Initialize(nRows);
+
+	DataVector<double> dColResidual;
+	dColResidual.Initialize(nCols);
 
-		// RHS vector
-		dRHS[ix] = dCoeff[i][j];
-
-		ix++;
-	}
-	}
+	double dP = 0.0;
+	for (int i = 0; i < nRows; i++) {
+		dP += vecTargetArea[i] * vecTargetArea[i];
 
-	FILE * fp = fopen("lagrangian.dat", "w");
-	for (int i = 0; i < dLagrangian.GetRows(); i++) {
-		for (int j = 0; j < dLagrangian.GetColumns(); j++) {
-			fprintf(fp, "%1.15e\t", dLagrangian[i][j]);
+		dRowResidual[i] = -1.0;
+		for (int j = 0; j < nCols; j++) {
+			dRowResidual[i] += dCoeff[i][j];
+			dColResidual[j] += vecTargetArea[i] * dCoeff[i][j];
 		}
-		fprintf(fp, "\n");
-	}
-	fclose(fp);
-
-	// Consistency and conservation of RHS vector
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dRHS[nCoeff + i] = -1.0;
-	}
-	for (int i = 0; i < dCoeff.GetColumns()-1; i++) {
-		dRHS[nCoeff + nCondConsistency + i] = - vecSourceArea[i];
-	}
-
-	// Solve the system
-	DataVector<int> iPIV;
-	iPIV.Initialize(dLagrangian.GetRows());
-
-	int n = dLagrangian.GetRows();
-	int nRHS = 1;
-	int nLDA = n;
-	int nLDB = n;
-	int nInfo;
-/*
-	dgesv_(
-		&n,
-		&nRHS,
-		&(dLagrangian[0][0]),
-		&nLDA,
-		&(iPIV[0]),
-		&(dRHS[0]),
-		&nLDB,
-		&nInfo);
-*/
-	char uplo = 'U';
-
-	DataVector<double> dWork;
-	int lWork = n;
-	dWork.Initialize(lWork);
-
-	dsysv_(
-		&uplo,
-		&n,
-		&nRHS,
-		&(dLagrangian[0][0]),
-		&nLDA,
-		&(iPIV[0]),
-		&(dRHS[0]),
-		&nLDB,
-		&(dWork[0]),
-		&lWork,
-		&nInfo);
-
-	if (nInfo != 0) {
-		_EXCEPTION1("Cannot solve target system: %i", nInfo);
 	}
 
-	/*
-	printf("Info: %i\n", nInfo);
-
-	// Output the result
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		printf("%1.15e %1.15e\n", dCoeff[i][j], dRHS[ix]);
-		ix++;
-	}
+	if (dP <= 0.0) {
+		_EXCEPTIONT("Unable to solve Schur system: Zero target area");
 	}
 
-	// Verify consistency
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		double dRowSum = 0.0;
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dRowSum += dRHS[ix];
-			ix++;
-		}
-		printf("Row %i: %1.15e\n", i, dRowSum);
+	double dAdotF = 0.0;
+	for (int i = 0; i < nRows; i++) {
+		dAdotF += vecTargetArea[i] * dRowResidual[i];
 	}
 
-	// Verify conservation
-	ix = 0;
-	DataVector<double> dColumnSums;
-	dColumnSums.Initialize(dCoeff.GetColumns());
-
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		double dRowSum = 0.0;
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dColumnSums[j] += dRHS[ix] * vecTargetArea[i];
-			ix++;
-		}
-	}
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		printf("Column %i: %1.15e %1.15e\n", j, dColumnSums[j], vecSourceArea[j]);
+	double dSumG = 0.0;
+	for (int j = 0; j < nCols-1; j++) {
+		dColResidual[j] -= vecSourceArea[j];
+		dSumG += dColResidual[j];
 	}
-	*/
-
-	// Store coefficients in array
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dCoeff[i][j] = dRHS[ix];
-		ix++;
-	}
-	}
-}
 
-///////////////////////////////////////////////////////////////////////////////
-
-void ForceConsistencyConservation3(
-	const DataVector<double> & vecSourceArea,
-	const DataVector<double> & vecTargetArea,
-	DataMatrix<double> & dCoeff,
-	bool fMonotone
-) {
+	// Sum of the conservation multipliers
+	double dSumZ =
+		(static_cast<double>(nCols) * dSumG
+			- static_cast<double>(nCols-1) * dAdotF) / dP;
 
-	// Number of free coefficients
-	int nCoeff = dCoeff.GetRows() * dCoeff.GetColumns();
+	// Conservation multipliers
+	double dShift = (dAdotF - dP * dSumZ) / static_cast<double>(nCols);
 
-	// Number of conditions
-	int nCondConservation = dCoeff.GetColumns();
-	int nCondConsistency  = dCoeff.GetRows();
-
-	// One condition is dropped due to linear dependence
-	int nCond = nCondConservation + nCondConsistency - 1;
-
-	// Product matrix
-	DataMatrix<double> dCCt;
-	dCCt.Initialize(nCond, nCond);
-
-	DataMatrix<double> dC;
-	dC.Initialize(nCoeff, nCond);
-
-	DataVector<double> dRHS;
-	dRHS.Initialize(nCoeff + nCond);
-
-	// RHS
-	int ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dRHS[ix] = dCoeff[i][j];
-		ix++;
-	}
+	for (int j = 0; j < nCols-1; j++) {
+		dColResidual[j] = (dColResidual[j] - dShift) / dP;
 	}
 
-	// Consistency
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dC[i * dCoeff.GetColumns() + j][ix] = 1.0;
-		}
-		dRHS[nCoeff + ix] = 1.0;
-		ix++;
-	}
+	// Consistency multipliers and projected coefficients
+	for (int i = 0; i < nRows; i++) {
+		double dY =
+			(dRowResidual[i] - vecTargetArea[i] * dSumZ)
+			/ static_cast<double>(nCols);
 
-	// Conservation
-	for (int j = 0; j < dCoeff.GetColumns()-1; j++) {
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			dC[i * dCoeff.GetColumns() + j][ix] = vecTargetArea[i];
-		}
-		dRHS[nCoeff + ix] = vecSourceArea[j];
-		ix++;
-	}
-
-	// Calculate CCt
-	double dP = 0.0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dP += vecTargetArea[i] * vecTargetArea[i];
-	}
-
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dCCt[i][i] = static_cast<double>(dCoeff.GetColumns());
-		for (int j = 0; j < dCoeff.GetColumns()-1; j++) {
-			dCCt[i][dCoeff.GetRows() + j] = vecTargetArea[i];
-			dCCt[dCoeff.GetRows() + j][i] = vecTargetArea[i];
-		}
-	}
-
-	for (int i = 0; i < dCoeff.GetColumns()-1; i++) {
-		int ix = dCoeff.GetRows() + i;
-		dCCt[ix][ix] = dP;
-	}
-/*
-	for (int i = 0; i < nCond; i++) {
-	for (int j = 0; j < nCond; j++) {
-		for (int k = 0; k < nCoeff; k++) {
-			dCCt[i][j] += dC[k][i] * dC[k][j];
+		for (int j = 0; j < nCols-1; j++) {
+			dCoeff[i][j] -= dY + vecTargetArea[i] * dColResidual[j];
 		}
-	}
-	}
-*/
-/*
-	FILE * fp = fopen("cct.dat", "w");
-	for (int i = 0; i < nCond; i++) {
-		for (int j = 0; j < nCond; j++) {
-			fprintf(fp, "%1.15e\t", dCCt[i][j]);
-		}
-		fprintf(fp, "\n");
-	}
-	fclose(fp);
-	_EXCEPTION();
-*/
-	// Calculate C*r1 - r2
-	char trans = 'n';
-	int m = nCond;
-	int n = nCoeff;
-	int lda = m;
-	int incx = 1;
-	int incy = 1;
-	double posone = 1.0;
-	double negone = -1.0;
-	dgemv_(
-		&trans,
-		&m,
-		&n,
-		&posone,
-		&(dC[0][0]),
-		&lda,
-		&(dRHS[0]),
-		&incx,
-		&negone,
-		&(dRHS[nCoeff]),
-		&incy);
-
-	// Solve the general system
-	int nrhs = 1;
-	int ldb = nCond;
-
-	int nInfo;
-/*
-	DataVector<int> iPIV;
-	iPIV.Initialize(nCond);
-
-	dgesv_(
-		&m,
-		&nrhs,
-		&(dCCt[0][0]),
-		&lda,
-		&(iPIV[0]),
-		&(dRHS[nCoeff]),
-		&ldb,
-		&nInfo);
-*/
-	char uplo = 'U';
-	dposv_(
-		&uplo,
-		&m,
-		&nrhs,
-		&(dCCt[0][0]),
-		&lda,
-		&(dRHS[nCoeff]),
-		&ldb,
-		&nInfo);
-
-	if (nInfo != 0) {
-		_EXCEPTION1("Unable to solve SPD Schur system: %i\n", nInfo);
-	}
-
-	// Obtain coefficients
-	trans = 't';
-	dgemv_(
-		&trans,
-		&m,
-		&n,
-		&negone,
-		&(dC[0][0]),
-		&lda,
-		&(dRHS[nCoeff]),
-		&incx,
-		&posone,
-		&(dRHS[0]),
-		&incy);
-
-	// Store coefficients in array
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dCoeff[i][j] = dRHS[ix];
-		ix++;
-	}
+		dCoeff[i][nCols-1] -= dY;
 	}
 
 	// Force monotonicity
@@ -699,25 +165,16 @@ void ForceConsistencyConservation3(
 			dTotalJacobian += vecSourceArea[i];
 		}
 
-		// Determine low-order remap coefficients
-		DataMatrix<double> dMonoCoeff;
-		dMonoCoeff.Initialize(dCoeff.GetRows(), dCoeff.GetColumns());
-
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dMonoCoeff[i][j] =
-				vecSourceArea[j]
-				/ dTotalJacobian;
-		}
-		}
-
-		// Compute scaling factor
+		// Compute scaling factor toward the low-order remap coefficients
+		// a_j / sum a_j, which satisfy the same constraints
 		double dA = 0.0;
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
+		for (int i = 0; i < nRows; i++) {
+		for (int j = 0; j < nCols; j++) {
 			if (dCoeff[i][j] < 0.0) {
+				double dMonoCoeff = vecSourceArea[j] / dTotalJacobian;
+
 				double dNewA =
-					- dCoeff[i][j] / fabs(dMonoCoeff[i][j] - dCoeff[i][j]);
+					- dCoeff[i][j] / fabs(dMonoCoeff - dCoeff[i][j]);
 
 				if (dNewA > dA) {
 					dA = dNewA;
@@ -726,9 +183,15 @@ void ForceConsistencyConservation3(
 		}
 		}
 
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dCoeff[i][j] = (1.0 - dA) * dCoeff[i][j] + dA * dMonoCoeff[i][j];
+		if (dA == 0.0) {
+			return;
+		}
+
+		for (int i = 0; i < nRows; i++) {
+		for (int j = 0; j < nCols; j++) {
+			dCoeff[i][j] =
+				(1.0 - dA) * dCoeff[i][j]
+				+ dA * vecSourceArea[j] / dTotalJacobian;
 		}
 		}
 	}
@@ -740,26 +203,38 @@ void LinearRemapSE4(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
-	const DataMatrix3D<int> & dataGLLNodes,
-	const DataMatrix3D<double> & dataGLLJacobian,
+	const GLLElementData<int> & dataGLLNodes,
+	const GLLElementData<double> & dataGLLJacobian,
 	bool fMonotone,
-	OfflineMap & mapRemap
+	OfflineMap & mapRemap,
+	const FaceQuadratureTable * pOverlapQuadrature
 ) {
 	// Order of the polynomial interpolant
-	int nP = dataGLLNodes.GetRows();
+	int nP = dataGLLNodes.GetNp();
+
+	// Verify the overlap mesh has been indexed for meshInput
+	if (meshOverlap.firstfaceindex.GetSourceFaceCount() != meshInput.faces.size()) {
+		_EXCEPTIONT("Overlap mesh index has not been calculated for meshInput");
+	}
 
-	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(4);
+	// Quadrature points of the overlap mesh
+	FaceQuadratureTable quadOverlapLocal;
 
-	int TriQuadraturePoints = triquadrule.GetPoints();
+	const FaceQuadratureTable * pquadOverlap = pOverlapQuadrature;
 
-	const DataMatrix<double> & TriQuadratureG = triquadrule.GetG();
+	if (pquadOverlap != NULL) {
+		pquadOverlap->Validate(meshOverlap, RemapQuadratureOrder);
+
+	} else {
+		quadOverlapLocal.Initialize(meshOverlap, RemapQuadratureOrder);
+		pquadOverlap = &quadOverlapLocal;
+	}
 
-	const DataVector<double> & TriQuadratureW = triquadrule.GetW();
+	const FaceQuadratureTable & quadOverlap = *pquadOverlap;
 
-	// Sample coefficients
-	DataMatrix<double> dSampleCoeff;
-	dSampleCoeff.Initialize(nP, nP);
+	int TriQuadraturePoints = quadOverlap.GetPoints();
+
+	const DataVector<double> & TriQuadratureW = quadOverlap.GetW();
 
 	// GLL Quadrature nodes on quadrilateral elements
 	DataVector<double> dG;
@@ -769,217 +244,169 @@ void LinearRemapSE4(
 	// Get SparseMatrix represntation of the OfflineMap
 	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
 
-	// NodeVector from meshOverlap
-	const NodeVector & nodesOverlap = meshOverlap.nodes;
-	const NodeVector & nodesFirst   = meshInput.nodes;
-
-	// Vector of source areas
-	DataVector<double> vecSourceArea;
-	vecSourceArea.Initialize(nP * nP);
-
-	DataVector<double> vecTargetArea;
-
-	DataMatrix<double> dCoeff;
+	// NodeVector from meshInput
+	const NodeVector & nodesFirst = meshInput.nodes;
 
-	// Current Overlap Face
-	int ixOverlap = 0;
+	// Overlap Faces of each input Face
+	int nFirstFaces = static_cast<int>(meshInput.faces.size());
 
-	// Loop over all input Faces
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
+	const OverlapFaceIndex & indexOverlap = meshOverlap.firstfaceindex;
 
-		const Face & faceFirst = meshInput.faces[ixFirst];
+	// Exception raised while processing Faces
+	FaceLoopException exFaces;
 
-		if (faceFirst.edges.size() != 4) {
-			_EXCEPTIONT("Only quadrilateral elements allowed for SE remapping");
-		}
-
-		// Output every 100 elements
-		if (ixFirst % 100 == 0) {
-			Announce("Element %i", ixFirst);
-		}
+	// Loop over all input Faces.  Each Face contributes the map entries of
+	// its own overlap Faces.
+#pragma omp parallel for schedule(static)
+	for (int ixFirst = 0; ixFirst < nFirstFaces; ixFirst++) {
+		try {
+			const Face & faceFirst = meshInput.faces[ixFirst];
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = 0;
-		int nTotalOverlapTriangles = 0;
+			if (faceFirst.edges.size() != 4) {
+				_EXCEPTIONT("Only quadrilateral elements allowed for SE remapping");
+			}
 
-		// Determine how many overlap Faces and triangles are present
-		int ixOverlapTemp = ixOverlap;
-		for (; ixOverlapTemp < meshOverlap.faces.size(); ixOverlapTemp++) {
+			// Output every 100 elements
+			if (ixFirst % 100 == 0) {
+#pragma omp critical(Announce)
+				Announce("Element %i", ixFirst);
+			}
 
-			const Face & faceOverlap = meshOverlap.faces[ixOverlapTemp];
+			// Overlap Faces of this input Face
+			int nOverlapFaces = indexOverlap.GetFaceCount(ixFirst);
 
-			if (meshOverlap.vecFirstFaceIx[ixOverlapTemp] != ixFirst) {
-				break;
+			// No overlaps
+			if (nOverlapFaces == 0) {
+				continue;
 			}
 
-			nOverlapFaces++;
-			nTotalOverlapTriangles += faceOverlap.edges.size() - 2;
-		}
-
-		// No overlaps
-		if (nOverlapFaces == 0) {
-			continue;
-		}
+			// Sample coefficients
+			DataMatrix<double> dSampleCoeff;
+			dSampleCoeff.Initialize(nP, nP);
 
-		// Allocate remap coefficients array for meshFirst Face
-		DataMatrix3D<double> dRemapCoeff;
-		dRemapCoeff.Initialize(nP, nP, nOverlapFaces);
-
-		// Find the local remap coefficients
-		for (int j = 0; j < nOverlapFaces; j++) {
-			const Face & faceOverlap = meshOverlap.faces[ixOverlap + j];
-
-			int nOverlapTriangles = faceOverlap.edges.size() - 2;
-
-			// Loop over all sub-triangles of this Overlap Face
-			for (int k = 0; k < nOverlapTriangles; k++) {
-
-				// Cornerpoints of triangle
-				const Node & node0 = nodesOverlap[faceOverlap[0]];
-				const Node & node1 = nodesOverlap[faceOverlap[k+1]];
-				const Node & node2 = nodesOverlap[faceOverlap[k+2]];
-
-				// Calculate the area of the modified Face
-				Face faceTri(3);
-				faceTri.SetNode(0, faceOverlap[0]);
-				faceTri.SetNode(1, faceOverlap[k+1]);
-				faceTri.SetNode(2, faceOverlap[k+2]);
-
-				double dTriangleArea =
-					CalculateFaceArea(faceTri, nodesOverlap);
-
-				// Coordinates of quadrature Node
-				for (int l = 0; l < TriQuadraturePoints; l++) {
-					Node nodeQuadrature;
-					nodeQuadrature.x =
-						  TriQuadratureG[l][0] * node0.x
-						+ TriQuadratureG[l][1] * node1.x
-						+ TriQuadratureG[l][2] * node2.x;
-
-					nodeQuadrature.y =
-						  TriQuadratureG[l][0] * node0.y
-						+ TriQuadratureG[l][1] * node1.y
-						+ TriQuadratureG[l][2] * node2.y;
-
-					nodeQuadrature.z =
-						  TriQuadratureG[l][0] * node0.z
-						+ TriQuadratureG[l][1] * node1.z
-						+ TriQuadratureG[l][2] * node2.z;
-
-					double dMag = sqrt(
-						  nodeQuadrature.x * nodeQuadrature.x
-						+ nodeQuadrature.y * nodeQuadrature.y
-						+ nodeQuadrature.z * nodeQuadrature.z);
-
-					nodeQuadrature.x /= dMag;
-					nodeQuadrature.y /= dMag;
-					nodeQuadrature.z /= dMag;
-
-					// Find components of quadrature point in basis
-					// of the first Face
-					double dAlpha;
-					double dBeta;
-
-					ApplyInverseMap(
-						faceFirst,
-						nodesFirst,
-						nodeQuadrature,
-						dAlpha,
-						dBeta);
-
-					// Check inverse map value
-					if ((dAlpha < 0.0) || (dAlpha > 1.0) ||
-						(dBeta  < 0.0) || (dBeta  > 1.0)
-					) {
-						_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
-							dAlpha, dBeta);
-					}
+			// Allocate remap coefficients array for meshFirst Face, with
+			// the coefficients of each overlap Face stored contiguously
+			DataMatrix<double> dRemapCoeff;
+			dRemapCoeff.Initialize(nOverlapFaces, nP * nP);
 
-					// Sample the finite element at this point
-					SampleGLLFiniteElement(
-						fMonotone, nP,
-						dAlpha,
-						dBeta,
-						dSampleCoeff);
-
-					// Add sample coefficients to the map
-					for (int p = 0; p < nP; p++) {
-					for (int q = 0; q < nP; q++) {
-
-						dRemapCoeff[p][q][j] +=
-							TriQuadratureW[l]
-							* dTriangleArea
-							* dSampleCoeff[p][q]
-							/ meshOverlap.vecFaceArea[ixOverlap + j];
-					}
+			// Find the local remap coefficients
+			for (int j = 0; j < nOverlapFaces; j++) {
+				int ixOverlap = indexOverlap.GetFace(ixFirst, j);
+
+				int ixTriBegin = quadOverlap.GetTriangleBegin(ixOverlap);
+				int ixTriEnd =
+					ixTriBegin + quadOverlap.GetTriangleCount(ixOverlap);
+
+				// Loop over all sub-triangles of this Overlap Face
+				for (int ixTri = ixTriBegin; ixTri < ixTriEnd; ixTri++) {
+
+					double dTriangleArea = quadOverlap.GetTriangleArea(ixTri);
+
+					const double * dX = quadOverlap.GetX(ixTri);
+					const double * dY = quadOverlap.GetY(ixTri);
+					const double * dZ = quadOverlap.GetZ(ixTri);
+
+					// Coordinates of quadrature Node
+					for (int l = 0; l < TriQuadraturePoints; l++) {
+						Node nodeQuadrature(dX[l], dY[l], dZ[l]);
+
+						// Find components of quadrature point in basis
+						// of the first Face
+						double dAlpha;
+						double dBeta;
+
+						ApplyInverseMap(
+							faceFirst,
+							nodesFirst,
+							nodeQuadrature,
+							dAlpha,
+							dBeta);
+
+						// Check inverse map value
+						if ((dAlpha < 0.0) || (dAlpha > 1.0) ||
+							(dBeta  < 0.0) || (dBeta  > 1.0)
+						) {
+							_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
+								dAlpha, dBeta);
+						}
+
+						// Sample the finite element at this point
+						SampleGLLFiniteElement(
+							fMonotone, nP,
+							dAlpha,
+							dBeta,
+							dSampleCoeff);
+
+						// Add sample coefficients to the map
+						for (int p = 0; p < nP; p++) {
+						for (int q = 0; q < nP; q++) {
+
+							dRemapCoeff[j][p * nP + q] +=
+								TriQuadratureW[l]
+								* dTriangleArea
+								* dSampleCoeff[p][q]
+								/ meshOverlap.vecFaceArea[ixOverlap];
+						}
+						}
 					}
 				}
 			}
-		}
 
-		// Force consistency and conservation
-		double dSourceArea = 0.0;
-		for (int p = 0; p < nP; p++) {
-		for (int q = 0; q < nP; q++) {
-			vecSourceArea[p * nP + q] = dataGLLJacobian[p][q][ixFirst];
-			dSourceArea += dataGLLJacobian[p][q][ixFirst];
-		}
-		}
-
-		double dTargetArea = 0.0;
-		vecTargetArea.Initialize(nOverlapFaces);
-		for (int j = 0; j < nOverlapFaces; j++) {
-			vecTargetArea[j] = meshOverlap.vecFaceArea[ixOverlap + j];
-			dTargetArea += meshOverlap.vecFaceArea[ixOverlap + j];
-		}
+			// Force consistency and conservation
+			DataVector<double> vecSourceArea;
+			vecSourceArea.Initialize(nP * nP);
 
-		if (fabs(dTargetArea - meshInput.vecFaceArea[ixFirst]) > 1.0e-10) {
-			Announce("Partial element: %i", ixFirst);
-
-		} else {
-			dCoeff.Initialize(nOverlapFaces, nP * nP);
-
-			for (int j = 0; j < nOverlapFaces; j++) {
+			double dSourceArea = 0.0;
 			for (int p = 0; p < nP; p++) {
 			for (int q = 0; q < nP; q++) {
-				dCoeff[j][p * nP + q] = dRemapCoeff[p][q][j];
+				vecSourceArea[p * nP + q] = dataGLLJacobian[ixFirst][p * nP + q];
+				dSourceArea += dataGLLJacobian[ixFirst][p * nP + q];
 			}
 			}
-			}
-
-			ForceConsistencyConservation3(
-				vecSourceArea,
-				vecTargetArea,
-				dCoeff,
-				fMonotone);
 
+			double dTargetArea = 0.0;
+			DataVector<double> vecTargetArea;
+			vecTargetArea.Initialize(nOverlapFaces);
 			for (int j = 0; j < nOverlapFaces; j++) {
-			for (int p = 0; p < nP; p++) {
-			for (int q = 0; q < nP; q++) {
-				dRemapCoeff[p][q][j] = dCoeff[j][p * nP + q];
-			}
-			}
+				int ixOverlap = indexOverlap.GetFace(ixFirst, j);
+
+				vecTargetArea[j] = meshOverlap.vecFaceArea[ixOverlap];
+				dTargetArea += meshOverlap.vecFaceArea[ixOverlap];
 			}
-		}
 
-		// Put these remap coefficients into the SparseMatrix map
-		for (int j = 0; j < nOverlapFaces; j++) {
-			int ixSecondFace = meshOverlap.vecSecondFaceIx[ixOverlap + j];
+			if (fabs(dTargetArea - meshInput.vecFaceArea[ixFirst]) > 1.0e-10) {
+#pragma omp critical(Announce)
+				Announce("Partial element: %i", ixFirst);
 
-			for (int p = 0; p < nP; p++) {
-			for (int q = 0; q < nP; q++) {
-				int ixFirstNode = dataGLLNodes[p][q][ixFirst] - 1;
-				smatMap(ixSecondFace, ixFirstNode) +=
-					dRemapCoeff[p][q][j]
-					* meshOverlap.vecFaceArea[ixOverlap + j]
-					/ meshOutput.vecFaceArea[ixSecondFace];
+			} else {
+				ForceConsistencyConservation(
+					vecSourceArea,
+					vecTargetArea,
+					dRemapCoeff,
+					fMonotone);
 			}
+
+			// Put these remap coefficients into the SparseMatrix map
+			for (int j = 0; j < nOverlapFaces; j++) {
+				int ixOverlap = indexOverlap.GetFace(ixFirst, j);
+				int ixSecondFace = meshOverlap.vecSecondFaceIx[ixOverlap];
+
+				for (int p = 0; p < nP; p++) {
+				for (int q = 0; q < nP; q++) {
+					int ixFirstNode = dataGLLNodes[ixFirst][p * nP + q] - 1;
+					smatMap.Add(ixSecondFace, ixFirstNode,
+						dRemapCoeff[j][p * nP + q]
+						* meshOverlap.vecFaceArea[ixOverlap]
+						/ meshOutput.vecFaceArea[ixSecondFace]);
+				}
+				}
 			}
+		} catch(Exception & e) {
+			exFaces.Record(ixFirst, e);
 		}
-
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
 	}
+
+	exFaces.Rethrow();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
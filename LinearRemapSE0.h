@@ -20,9 +20,28 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "GridElements.h"
-#include "DataMatrix3D.h"
+#include "DataVector.h"
+#include "DataMatrix.h"
+#include "GLLElementData.h"
 
 class OfflineMap;
+class FaceQuadratureTable;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Project the local remap coefficients dCoeff, with rows associated
+///		with target areas and columns with source areas, onto the nearest
+///		(in the L2 sense) coefficients satisfying consistency and
+///		conservation.  If fMonotone is set the result is then blended with
+///		the low-order remap coefficients until it is non-negative.
+///	</summary>
+void ForceConsistencyConservation(
+	const DataVector<double> & vecSourceArea,
+	const DataVector<double> & vecTargetArea,
+	DataMatrix<double> & dCoeff,
+	bool fMonotone
+);
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -34,8 +53,8 @@ void LinearRemapSE0(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
-	const DataMatrix3D<int> & dataGLLNodes,
-	const DataMatrix3D<double> & dataGLLJacobian,
+	const GLLElementData<int> & dataGLLNodes,
+	const GLLElementData<double> & dataGLLJacobian,
 	OfflineMap & mapRemap
 );
 
@@ -43,16 +62,19 @@ void LinearRemapSE0(
 
 ///	<summary>
 ///		Generate the OfflineMap for cubic conserative element-average
-///		spectral element to element average remapping.
+///		spectral element to element average remapping.  If
+///		pOverlapQuadrature is not NULL the quadrature points of meshOverlap
+///		are taken from pOverlapQuadrature.
 ///	</summary>
 void LinearRemapSE4(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
-	const DataMatrix3D<int> & dataGLLNodes,
-	const DataMatrix3D<double> & dataGLLJacobian,
+	const GLLElementData<int> & dataGLLNodes,
+	const GLLElementData<double> & dataGLLJacobian,
 	bool fMonotone,
-	OfflineMap & mapRemap
+	OfflineMap & mapRemap,
+	const FaceQuadratureTable * pOverlapQuadrature = NULL
 );
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,588 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    MeshStream.cpp
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "MeshStream.h"
+
+#include "Announce.h"
+#include "Exception.h"
+#include "DataVector.h"
+#include "DataMatrix.h"
+
+#include "netcdfcpp.h"
+
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////
+/// MeshStreamWriter
+///////////////////////////////////////////////////////////////////////////////
+
+MeshStreamWriter::MeshStreamWriter(
+	const std::string & strFile,
+	const NetCDFOutputOptions & options
+) :
+	m_strFile(strFile),
+	m_options(options),
+	m_fpNodes(NULL),
+	m_fpFaces(NULL),
+	m_nNodes(0),
+	m_nFaces(0),
+	m_nNodesPerElement(0),
+	m_fHasFirstFaceIx(false),
+	m_fHasSecondFaceIx(false)
+{
+	m_fpNodes = tmpfile();
+	m_fpFaces = tmpfile();
+
+	if ((m_fpNodes == NULL) || (m_fpFaces == NULL)) {
+		_EXCEPTION1("Unable to open temporary files for \"%s\"",
+			strFile.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MeshStreamWriter::~MeshStreamWriter() {
+	if (m_fpNodes != NULL) {
+		fclose(m_fpNodes);
+	}
+	if (m_fpFaces != NULL) {
+		fclose(m_fpFaces);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MeshStreamWriter::WriteNodes(
+	const NodeVector & nodes
+) {
+	if (m_fpNodes == NULL) {
+		_EXCEPTIONT("MeshStreamWriter has already been closed");
+	}
+
+	double dCoord[3];
+	for (int i = 0; i < nodes.size(); i++) {
+		dCoord[0] = static_cast<double>(nodes[i].x);
+		dCoord[1] = static_cast<double>(nodes[i].y);
+		dCoord[2] = static_cast<double>(nodes[i].z);
+
+		if (fwrite(dCoord, sizeof(double), 3, m_fpNodes) != 3) {
+			_EXCEPTIONT("Error writing Nodes to temporary file");
+		}
+	}
+
+	m_nNodes += static_cast<int>(nodes.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MeshStreamWriter::WriteFaces(
+	const Mesh & mesh
+) {
+	if (m_fpFaces == NULL) {
+		_EXCEPTIONT("MeshStreamWriter has already been closed");
+	}
+
+	int nFaces = static_cast<int>(mesh.faces.size());
+	if (nFaces == 0) {
+		return;
+	}
+
+	// All blocks must carry the same source Face indices
+	bool fHasFirstFaceIx = (mesh.vecFirstFaceIx.size() != 0);
+	bool fHasSecondFaceIx = (mesh.vecSecondFaceIx.size() != 0);
+
+	if (m_nFaces == 0) {
+		m_fHasFirstFaceIx = fHasFirstFaceIx;
+		m_fHasSecondFaceIx = fHasSecondFaceIx;
+
+	} else if (
+		(fHasFirstFaceIx != m_fHasFirstFaceIx) ||
+		(fHasSecondFaceIx != m_fHasSecondFaceIx)
+	) {
+		_EXCEPTIONT("Inconsistent source Face indices in Mesh block");
+	}
+
+	if (fHasFirstFaceIx && (mesh.vecFirstFaceIx.size() != nFaces)) {
+		_EXCEPTIONT("Incorrect size of vecFirstFaceIx");
+	}
+	if (fHasSecondFaceIx && (mesh.vecSecondFaceIx.size() != nFaces)) {
+		_EXCEPTIONT("Incorrect size of vecSecondFaceIx");
+	}
+
+	// Each record contains the number of edges, followed by the
+	// (1-indexed) Node and type of each edge, followed by the source
+	// Face indices
+	std::vector<int> vecRecord;
+	for (int i = 0; i < nFaces; i++) {
+		const Face & face = mesh.faces[i];
+
+		int nEdges = static_cast<int>(face.edges.size());
+		if (nEdges > m_nNodesPerElement) {
+			m_nNodesPerElement = nEdges;
+		}
+
+		vecRecord.resize(3 + 2 * nEdges);
+		vecRecord[0] = nEdges;
+		for (int k = 0; k < nEdges; k++) {
+			vecRecord[1 + k] = face[k] + 1;
+			vecRecord[1 + nEdges + k] = static_cast<int>(face.edges[k].type);
+		}
+		vecRecord[1 + 2 * nEdges] =
+			(fHasFirstFaceIx)?(mesh.vecFirstFaceIx[i]):(0);
+		vecRecord[2 + 2 * nEdges] =
+			(fHasSecondFaceIx)?(mesh.vecSecondFaceIx[i]):(0);
+
+		if (fwrite(&(vecRecord[0]), sizeof(int), vecRecord.size(), m_fpFaces)
+			!= vecRecord.size()
+		) {
+			_EXCEPTIONT("Error writing Faces to temporary file");
+		}
+	}
+
+	m_nFaces += nFaces;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MeshStreamWriter::Close() {
+	const int ParamFour = 4;
+	const int ParamLenString = 33;
+
+	if ((m_fpNodes == NULL) || (m_fpFaces == NULL)) {
+		_EXCEPTIONT("MeshStreamWriter has already been closed");
+	}
+
+	Announce("Max nodes per element: %i", m_nNodesPerElement);
+
+	// Output to a NetCDF Exodus file with the layout of Mesh::Write
+	NcFile ncOut(
+		m_strFile.c_str(),
+		NcFile::Replace,
+		NULL,
+		0,
+		(m_options.fNetCDF4)?(NcFile::Netcdf4):(NcFile::Classic));
+
+	// Random Exodus dimensions
+	NcDim * dimLenString = ncOut.add_dim("len_string", ParamLenString);
+	NcDim * dimLenLine = ncOut.add_dim("len_line", 81);
+	NcDim * dimFour = ncOut.add_dim("four", ParamFour);
+	NcDim * dimTime = ncOut.add_dim("time_step");
+	NcDim * dimDimension = ncOut.add_dim("num_dim", 3);
+
+	// Number of nodes
+	NcDim * dimNodes = ncOut.add_dim("num_nodes", m_nNodes);
+
+	// Number of elements
+	NcDim * dimElements = ncOut.add_dim("num_elem", m_nFaces);
+
+	// Other dimensions
+	NcDim * dimNumElementBlocks = ncOut.add_dim("num_el_blk", 1);
+	NcDim * dimNumQARec = ncOut.add_dim("num_qa_rec", 1);
+	NcDim * dimElementBlock1 = ncOut.add_dim("num_el_in_blk1", m_nFaces);
+	NcDim * dimNodesPerElement =
+		ncOut.add_dim("num_nod_per_el1", m_nNodesPerElement);
+	NcDim * dimAttBlock1 = ncOut.add_dim("num_att_in_blk1", 1);
+
+	// Chunk shapes of Face and Node variables, which match the blocks
+	// copied from the temporary files
+	long nChunkFaces[2];
+	nChunkFaces[0] = GetNcChunkLength(m_nFaces, ChunkSize);
+	nChunkFaces[1] = GetNcChunkLength(m_nNodesPerElement);
+
+	long nChunkAttrib1[2];
+	nChunkAttrib1[0] = nChunkFaces[0];
+	nChunkAttrib1[1] = 1;
+
+	long nChunkNodes[2];
+	nChunkNodes[0] = 1;
+	nChunkNodes[1] = GetNcChunkLength(m_nNodes, ChunkSize);
+
+	// Global attributes
+	ncOut.add_att("api_version", 4.98f);
+	ncOut.add_att("version", 4.98f);
+	ncOut.add_att("floating_point_word_size", 8);
+	ncOut.add_att("file_size", 0);
+
+	char szTitle[128];
+	sprintf(szTitle, "tempest(%s) 01/01/2013: 00:00:00", m_strFile.c_str());
+	ncOut.add_att("title", szTitle);
+
+	// Time_whole (unused)
+	ncOut.add_var("time_whole", ncDouble, dimTime);
+
+	// QA records and coordinate names
+	NcVar * varQARecords =
+		ncOut.add_var("qa_records", ncChar, dimNumQARec, dimFour, dimLenString);
+
+	NcVar * varCoordNames =
+		ncOut.add_var("coor_names", ncChar, dimDimension, dimLenString);
+
+	// Element block names
+	NcVar * varElementBlockNames =
+		ncOut.add_var("eb_names", ncChar, dimNumElementBlocks, dimLenString);
+
+	// Define all remaining variables before any data is written, which
+	// avoids rewriting the file when the header grows
+	NcVar * varElementMap =
+		ncOut.add_var("elem_map", ncInt, dimElements);
+	DefineNcVarStorage(&ncOut, varElementMap, nChunkFaces, m_options);
+
+	NcVar * varElementBlockStatus =
+		ncOut.add_var("eb_status", ncInt, dimNumElementBlocks);
+
+	NcVar * varElementProperty =
+		ncOut.add_var("eb_prop1", ncInt, dimNumElementBlocks);
+	varElementProperty->add_att("name", "ID");
+
+	NcVar * varAttrib1 =
+		ncOut.add_var("attrib1", ncDouble, dimElementBlock1, dimAttBlock1);
+	DefineNcVarStorage(&ncOut, varAttrib1, nChunkAttrib1, m_options);
+
+	NcVar * varFaces =
+		ncOut.add_var("connect1", ncInt, dimElementBlock1, dimNodesPerElement);
+
+	varFaces->add_att("elem_type", "SHELL4");
+	DefineNcVarStorage(&ncOut, varFaces, nChunkFaces, m_options);
+
+	NcVar * varNodes =
+		ncOut.add_var("coord", ncDouble, dimDimension, dimNodes);
+	DefineNcVarStorage(&ncOut, varNodes, nChunkNodes, m_options);
+
+	NcVar * varEdgeTypes =
+		ncOut.add_var("edge_type", ncInt,
+			dimElementBlock1, dimNodesPerElement);
+	DefineNcVarStorage(&ncOut, varEdgeTypes, nChunkFaces, m_options);
+
+	NcVar * varFirstMeshSourceFace = NULL;
+	if (m_fHasFirstFaceIx) {
+		varFirstMeshSourceFace =
+			ncOut.add_var("face_source_1", ncInt, dimElementBlock1);
+		DefineNcVarStorage(
+			&ncOut, varFirstMeshSourceFace, nChunkFaces, m_options);
+	}
+
+	NcVar * varSecondMeshSourceFace = NULL;
+	if (m_fHasSecondFaceIx) {
+		varSecondMeshSourceFace =
+			ncOut.add_var("face_source_2", ncInt, dimElementBlock1);
+		DefineNcVarStorage(
+			&ncOut, varSecondMeshSourceFace, nChunkFaces, m_options);
+	}
+
+	// QA records
+	char szQARecord[ParamFour][ParamLenString] = {
+		"Tempest", "13.0", "01/01/2013", "00:00:00"};
+
+	varQARecords->set_cur(0, 0, 0);
+	varQARecords->put(&(szQARecord[0][0]), 1, 4, ParamLenString);
+
+	// Coordinate names
+	char szCoordNames[3][ParamLenString] = {"x", "y", "z"};
+
+	varCoordNames->set_cur(0, 0, 0);
+	varCoordNames->put(&(szCoordNames[0][0]), 3, ParamLenString);
+
+	// Element map and attributes
+	DataVector<int> nElementMap;
+	nElementMap.Initialize(ChunkSize);
+
+	DataVector<double> dAttrib1;
+	dAttrib1.Initialize(ChunkSize);
+
+	for (int i = 0; i < m_nFaces; i += ChunkSize) {
+		int nChunk = (i + ChunkSize > m_nFaces)?(m_nFaces - i):(ChunkSize);
+		for (int j = 0; j < nChunk; j++) {
+			nElementMap[j] = i + j + 1;
+			dAttrib1[j] = 1.0;
+		}
+		varElementMap->set_cur((long)i);
+		varElementMap->put(&(nElementMap[0]), nChunk);
+
+		varAttrib1->set_cur(i, 0);
+		varAttrib1->put(&(dAttrib1[0]), nChunk, 1);
+	}
+
+	// Element block status
+	int nOne = 1;
+
+	varElementBlockStatus->put(&nOne, 1);
+	varElementProperty->put(&nOne, 1);
+
+	// Face nodes (1-indexed), edge types and source Faces
+	if (m_nFaces != 0) {
+		DataMatrix<int> nConnect;
+		nConnect.Initialize(ChunkSize, m_nNodesPerElement);
+
+		DataMatrix<int> nEdgeType;
+		nEdgeType.Initialize(ChunkSize, m_nNodesPerElement);
+
+		DataVector<int> nFirstFaceIx;
+		nFirstFaceIx.Initialize(ChunkSize);
+
+		DataVector<int> nSecondFaceIx;
+		nSecondFaceIx.Initialize(ChunkSize);
+
+		std::vector<int> vecRecord;
+		vecRecord.resize(3 + 2 * m_nNodesPerElement);
+
+		rewind(m_fpFaces);
+
+		for (int i = 0; i < m_nFaces; i += ChunkSize) {
+			int nChunk = (i + ChunkSize > m_nFaces)?(m_nFaces - i):(ChunkSize);
+
+			for (int j = 0; j < nChunk; j++) {
+				int nEdges;
+				if (fread(&nEdges, sizeof(int), 1, m_fpFaces) != 1) {
+					_EXCEPTIONT("Error reading Faces from temporary file");
+				}
+
+				int nRecord = 2 + 2 * nEdges;
+				if (fread(&(vecRecord[0]), sizeof(int), nRecord, m_fpFaces)
+					!= nRecord
+				) {
+					_EXCEPTIONT("Error reading Faces from temporary file");
+				}
+
+				int k = 0;
+				for (; k < nEdges; k++) {
+					nConnect[j][k] = vecRecord[k];
+					nEdgeType[j][k] = vecRecord[nEdges + k];
+				}
+				for (; k < m_nNodesPerElement; k++) {
+					nConnect[j][k] = nConnect[j][nEdges-1];
+					nEdgeType[j][k] = nEdgeType[j][nEdges-1];
+				}
+
+				nFirstFaceIx[j] = vecRecord[2 * nEdges];
+				nSecondFaceIx[j] = vecRecord[2 * nEdges + 1];
+			}
+
+			varFaces->set_cur(i, 0);
+			varFaces->put(&(nConnect[0][0]), nChunk, m_nNodesPerElement);
+
+			varEdgeTypes->set_cur(i, 0);
+			varEdgeTypes->put(&(nEdgeType[0][0]), nChunk, m_nNodesPerElement);
+
+			if (varFirstMeshSourceFace != NULL) {
+				varFirstMeshSourceFace->set_cur((long)i);
+				varFirstMeshSourceFace->put(&(nFirstFaceIx[0]), nChunk);
+			}
+			if (varSecondMeshSourceFace != NULL) {
+				varSecondMeshSourceFace->set_cur((long)i);
+				varSecondMeshSourceFace->put(&(nSecondFaceIx[0]), nChunk);
+			}
+		}
+	}
+
+	// Node list, copied one coordinate at a time
+	DataMatrix<double> dNodeChunk;
+	dNodeChunk.Initialize(ChunkSize, 3);
+
+	DataVector<double> dCoord;
+	dCoord.Initialize(ChunkSize);
+
+	for (int d = 0; d < 3; d++) {
+		rewind(m_fpNodes);
+
+		for (int i = 0; i < m_nNodes; i += ChunkSize) {
+			int nChunk = (i + ChunkSize > m_nNodes)?(m_nNodes - i):(ChunkSize);
+
+			if (fread(&(dNodeChunk[0][0]), sizeof(double), 3 * nChunk, m_fpNodes)
+				!= 3 * nChunk
+			) {
+				_EXCEPTIONT("Error reading Nodes from temporary file");
+			}
+
+			for (int j = 0; j < nChunk; j++) {
+				dCoord[j] = dNodeChunk[j][d];
+			}
+
+			varNodes->set_cur(d, i);
+			varNodes->put(&(dCoord[0]), 1, nChunk);
+		}
+	}
+
+	// Remove temporary files
+	fclose(m_fpNodes);
+	fclose(m_fpFaces);
+
+	m_fpNodes = NULL;
+	m_fpFaces = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// MeshBlockReader
+///////////////////////////////////////////////////////////////////////////////
+
+MeshBlockReader::MeshBlockReader(
+	const std::string & strFile
+) :
+	m_pncFile(NULL),
+	m_nNodes(0),
+	m_nFaces(0),
+	m_nNodesPerElement(0)
+{
+	// Try to open the NetCDF file
+	FILE * fp = fopen(strFile.c_str(), "r");
+	if (fp == NULL) {
+		_EXCEPTION1("Mesh file not found \"%s\"", strFile.c_str());
+	}
+	fclose(fp);
+
+	m_pncFile = new NcFile(strFile.c_str(), NcFile::ReadOnly);
+	if (!m_pncFile->is_valid()) {
+		delete m_pncFile;
+		m_pncFile = NULL;
+		_EXCEPTION1("Unable to open mesh file \"%s\"", strFile.c_str());
+	}
+
+	// Mesh dimensions
+	m_nNodesPerElement = m_pncFile->get_dim("num_nod_per_el1")->size();
+	m_nNodes = m_pncFile->get_dim("num_nodes")->size();
+	m_nFaces = m_pncFile->get_dim("num_elem")->size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MeshBlockReader::~MeshBlockReader() {
+	if (m_pncFile != NULL) {
+		delete m_pncFile;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MeshBlockReader::ReadNodes(
+	NodeVector & nodes
+) {
+	NcVar * varNodes = m_pncFile->get_var("coord");
+
+	nodes.resize(m_nNodes);
+
+	DataVector<double> dCoord;
+	dCoord.Initialize(MeshStreamWriter::ChunkSize);
+
+	for (int d = 0; d < 3; d++) {
+	for (int i = 0; i < m_nNodes; i += MeshStreamWriter::ChunkSize) {
+		int nChunk = (i + MeshStreamWriter::ChunkSize > m_nNodes)?
+			(m_nNodes - i):(MeshStreamWriter::ChunkSize);
+
+		varNodes->set_cur(d, i);
+		varNodes->get(&(dCoord[0]), 1, nChunk);
+
+		for (int j = 0; j < nChunk; j++) {
+			Real dValue = static_cast<Real>(dCoord[j]);
+			if (d == 0) {
+				nodes[i+j].x = dValue;
+			} else if (d == 1) {
+				nodes[i+j].y = dValue;
+			} else {
+				nodes[i+j].z = dValue;
+			}
+		}
+	}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MeshBlockReader::ReadFaces(
+	int ixBegin,
+	int nFaces,
+	Mesh & mesh
+) {
+	if ((ixBegin < 0) || (nFaces < 0) || (ixBegin + nFaces > m_nFaces)) {
+		_EXCEPTION2("Face block [%i, %i) out of range",
+			ixBegin, ixBegin + nFaces);
+	}
+
+	mesh.faces.clear();
+	mesh.faces.resize(nFaces, Face(m_nNodesPerElement));
+	mesh.vecFirstFaceIx.clear();
+	mesh.vecSecondFaceIx.clear();
+	mesh.firstfaceindex.Clear();
+	mesh.secondfaceindex.Clear();
+
+	if (nFaces == 0) {
+		return;
+	}
+
+	// Load in face array
+	NcVar * varFaces = m_pncFile->get_var("connect1");
+
+	DataMatrix<int> iFaceIndices;
+	iFaceIndices.Initialize(nFaces, m_nNodesPerElement);
+
+	varFaces->set_cur(ixBegin, 0);
+	varFaces->get(&(iFaceIndices[0][0]), nFaces, m_nNodesPerElement);
+
+	for (int i = 0; i < nFaces; i++) {
+	for (int j = 0; j < m_nNodesPerElement; j++) {
+		mesh.faces[i].SetNode(j, iFaceIndices[i][j]-1);
+	}
+	}
+
+	// Check for variables
+	bool fHasEdgeType = false;
+	bool fHasFirstMeshSourceFace = false;
+	bool fHasSecondMeshSourceFace = false;
+
+	for (int v = 0; v < m_pncFile->num_vars(); v++) {
+		if (strcmp(m_pncFile->get_var(v)->name(), "edge_type") == 0) {
+			fHasEdgeType = true;
+		}
+		if (strcmp(m_pncFile->get_var(v)->name(), "face_source_1") == 0) {
+			fHasFirstMeshSourceFace = true;
+		}
+		if (strcmp(m_pncFile->get_var(v)->name(), "face_source_2") == 0) {
+			fHasSecondMeshSourceFace = true;
+		}
+	}
+
+	// Load in edge type array
+	if (fHasEdgeType) {
+		NcVar * varEdgeTypes = m_pncFile->get_var("edge_type");
+
+		varEdgeTypes->set_cur(ixBegin, 0);
+		varEdgeTypes->get(&(iFaceIndices[0][0]), nFaces, m_nNodesPerElement);
+
+		for (int i = 0; i < nFaces; i++) {
+		for (int j = 0; j < m_nNodesPerElement; j++) {
+			mesh.faces[i].edges[j].type =
+				static_cast<Edge::Type>(iFaceIndices[i][j]);
+		}
+		}
+	}
+
+	// Load in first mesh source face ix
+	if (fHasFirstMeshSourceFace) {
+		NcVar * varFaceSource1 = m_pncFile->get_var("face_source_1");
+		mesh.vecFirstFaceIx.resize(nFaces);
+		varFaceSource1->set_cur((long)ixBegin);
+		varFaceSource1->get(&(mesh.vecFirstFaceIx[0]), nFaces);
+	}
+
+	// Load in second mesh source face ix
+	if (fHasSecondMeshSourceFace) {
+		NcVar * varFaceSource2 = m_pncFile->get_var("face_source_2");
+		mesh.vecSecondFaceIx.resize(nFaces);
+		varFaceSource2->set_cur((long)ixBegin);
+		varFaceSource2->get(&(mesh.vecSecondFaceIx[0]), nFaces);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
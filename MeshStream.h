@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    MeshStream.h
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _MESHSTREAM_H_
+#define _MESHSTREAM_H_
+
+#include "GridElements.h"
+
+#include <string>
+#include <cstdio>
+
+class NcFile;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A writer which accepts a Mesh in blocks of Nodes and Faces and
+///		produces the same Exodus file as Mesh::Write, without ever holding
+///		the complete Mesh in memory.  Blocks are spooled to temporary files
+///		and copied to the NetCDF output in chunks on Close.
+///	</summary>
+class MeshStreamWriter {
+
+public:
+	///	<summary>
+	///		Number of Nodes or Faces copied to the output file at once.
+	///	</summary>
+	static const int ChunkSize = 65536;
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	MeshStreamWriter(
+		const std::string & strFile,
+		const NetCDFOutputOptions & options = NetCDFOutputOptions()
+	);
+
+	///	<summary>
+	///		Destructor.
+	///	</summary>
+	~MeshStreamWriter();
+
+public:
+	///	<summary>
+	///		Append Nodes to the output.  Nodes are indexed in the order in
+	///		which they are appended.
+	///	</summary>
+	void WriteNodes(
+		const NodeVector & nodes
+	);
+
+	///	<summary>
+	///		Append all Faces of mesh to the output, along with their
+	///		source Face indices.  Node indices refer to all Nodes appended
+	///		to the output.
+	///	</summary>
+	void WriteFaces(
+		const Mesh & mesh
+	);
+
+	///	<summary>
+	///		Write the output file and remove the temporary files.
+	///	</summary>
+	void Close();
+
+	///	<summary>
+	///		Number of Nodes appended so far.
+	///	</summary>
+	int GetNodeCount() const {
+		return m_nNodes;
+	}
+
+	///	<summary>
+	///		Number of Faces appended so far.
+	///	</summary>
+	int GetFaceCount() const {
+		return m_nFaces;
+	}
+
+protected:
+	///	<summary>
+	///		Output filename.
+	///	</summary>
+	std::string m_strFile;
+
+	///	<summary>
+	///		Format and storage options of the output file.
+	///	</summary>
+	NetCDFOutputOptions m_options;
+
+	///	<summary>
+	///		Temporary file containing the coordinates of all Nodes.
+	///	</summary>
+	FILE * m_fpNodes;
+
+	///	<summary>
+	///		Temporary file containing the connectivity, edge types and
+	///		source Face indices of all Faces.
+	///	</summary>
+	FILE * m_fpFaces;
+
+	///	<summary>
+	///		Number of Nodes appended so far.
+	///	</summary>
+	int m_nNodes;
+
+	///	<summary>
+	///		Number of Faces appended so far.
+	///	</summary>
+	int m_nFaces;
+
+	///	<summary>
+	///		Maximum number of Nodes per Face.
+	///	</summary>
+	int m_nNodesPerElement;
+
+	///	<summary>
+	///		Flags indicating the Faces have source Face indices.
+	///	</summary>
+	bool m_fHasFirstFaceIx;
+	bool m_fHasSecondFaceIx;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A reader which loads the Faces of an Exodus mesh file in blocks,
+///		so that the Faces of large overlap meshes can be processed without
+///		holding the complete Mesh in memory.
+///	</summary>
+class MeshBlockReader {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	MeshBlockReader(
+		const std::string & strFile
+	);
+
+	///	<summary>
+	///		Destructor.
+	///	</summary>
+	~MeshBlockReader();
+
+public:
+	///	<summary>
+	///		Load all Nodes of the mesh.
+	///	</summary>
+	void ReadNodes(
+		NodeVector & nodes
+	);
+
+	///	<summary>
+	///		Load nFaces Faces of the mesh beginning at ixBegin, along with
+	///		their edge types and source Face indices, replacing the Faces
+	///		of mesh.  The Nodes of mesh are not modified.
+	///	</summary>
+	void ReadFaces(
+		int ixBegin,
+		int nFaces,
+		Mesh & mesh
+	);
+
+	///	<summary>
+	///		Number of Nodes in the mesh.
+	///	</summary>
+	int GetNodeCount() const {
+		return m_nNodes;
+	}
+
+	///	<summary>
+	///		Number of Faces in the mesh.
+	///	</summary>
+	int GetFaceCount() const {
+		return m_nFaces;
+	}
+
+protected:
+	///	<summary>
+	///		Input file.
+	///	</summary>
+	NcFile * m_pncFile;
+
+	///	<summary>
+	///		Number of Nodes in the mesh.
+	///	</summary>
+	int m_nNodes;
+
+	///	<summary>
+	///		Number of Faces in the mesh.
+	///	</summary>
+	int m_nFaces;
+
+	///	<summary>
+	///		Number of Nodes per Face in the file.
+	///	</summary>
+	int m_nNodesPerElement;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
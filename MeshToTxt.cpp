@@ -17,7 +17,7 @@
 #include "Announce.h"
 #include "CommandLine.h"
 #include "Exception.h"
-#include "GridElements.h"
+#include "CompactMesh.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -51,17 +51,17 @@ try {
 
 	// Load input mesh
 	AnnounceStartBlock("Loading input mesh");
-	Mesh meshInput(strInputMesh);
+	CompactMesh meshInput(strInputMesh);
 	AnnounceEndBlock(NULL);
 
 	// Output nodes
 	AnnounceStartBlock("Writing nodes");
 	FILE * fpNodes = fopen(strOutputNodes.c_str(), "w");
-	for (int i = 0; i < meshInput.nodes.size(); i++) {
+	for (int i = 0; i < meshInput.GetNodeCount(); i++) {
 		fprintf(fpNodes, "%1.10e %1.10e %1.10e\n",
-			static_cast<double>(meshInput.nodes[i].x),
-			static_cast<double>(meshInput.nodes[i].y),
-			static_cast<double>(meshInput.nodes[i].z));
+			static_cast<double>(meshInput.GetX(i)),
+			static_cast<double>(meshInput.GetY(i)),
+			static_cast<double>(meshInput.GetZ(i)));
 	}
 	fclose(fpNodes);
 	AnnounceEndBlock("Done!");
@@ -69,10 +69,11 @@ try {
 	// Output faces
 	AnnounceStartBlock("Writing faces");
 	FILE * fpFaces = fopen(strOutputFaces.c_str(), "w");
-	for (int i = 0; i < meshInput.faces.size(); i++) {
-		for (int j = 0; j < meshInput.faces[i].edges.size(); j++) {
-			fprintf(fpFaces, "%i", meshInput.faces[i][j] + 1);
-			if (j != meshInput.faces[i].edges.size()-1) {
+	for (int i = 0; i < meshInput.GetFaceCount(); i++) {
+		int nFaceNodes = meshInput.GetFaceNodeCount(i);
+		for (int j = 0; j < nFaceNodes; j++) {
+			fprintf(fpFaces, "%i", meshInput.GetFaceNode(i, j) + 1);
+			if (j != nFaceNodes-1) {
 				fprintf(fpFaces, " ");
 			}
 		}
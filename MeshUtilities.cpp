@@ -30,9 +30,25 @@ void MeshUtilities::FindFaceFromNode(
 	aFindFaceStruct.vecFaceLocations.clear();
 	aFindFaceStruct.loc = Face::NodeLocation_Undefined;
 
-	// Loop through all faces to find overlaps
-	// Note: This algorithm can likely be dramatically improved
-	for (int l = 0; l < mesh.faces.size(); l++) {
+	// Restrict the search to candidate faces from the FaceCapTree,
+	// otherwise loop through all faces to find overlaps
+	std::vector<int> vecCandidateFaces;
+
+	bool fUseFaceTree = !mesh.facetree.IsEmpty();
+	if (fUseFaceTree) {
+		mesh.facetree.FindCandidateFaces(node, vecCandidateFaces);
+	}
+
+	int nCandidateFaces;
+	if (fUseFaceTree) {
+		nCandidateFaces = vecCandidateFaces.size();
+	} else {
+		nCandidateFaces = mesh.faces.size();
+	}
+
+	for (int c = 0; c < nCandidateFaces; c++) {
+		int l = (fUseFaceTree)?(vecCandidateFaces[c]):(c);
+
 		Face::NodeLocation loc;
 		int ixLocation;
 
@@ -125,3 +141,147 @@ void MeshUtilities::FindFaceFromNode(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void MeshUtilities::FindFaceFromNode(
+	const Mesh & mesh,
+	const Node & node,
+	int ixFaceHint,
+	FindFaceStruct & aFindFaceStruct
+) {
+	// Maximum number of Faces visited during the walk
+	static const int MaximumWalkLength = 256;
+
+	// Tolerance for deciding that the Node is outside of an Edge
+	static const Real Tolerance = 1.0e-12;
+
+	if ((ixFaceHint == InvalidFace) || (mesh.edgemap.size() == 0)) {
+		FindFaceFromNode(mesh, node, aFindFaceStruct);
+		return;
+	}
+
+	// Walk towards the Node, crossing any Edge which has the Node on
+	// its exterior side
+	int ixFace = ixFaceHint;
+
+	for (int n = 0; n < MaximumWalkLength; n++) {
+		const Face & face = mesh.faces[ixFace];
+
+		int ixNextFace = InvalidFace;
+
+		for (int k = 0; k < face.edges.size(); k++) {
+			const Edge & edge = face.edges[k];
+
+			if (edge[0] == edge[1]) {
+				continue;
+			}
+
+			const Node & node0 = mesh.nodes[edge[0]];
+			const Node & node1 = mesh.nodes[edge[1]];
+
+			bool fExterior;
+
+			// Faces are counter-clockwise oriented, so the interior lies
+			// to the left of each Edge
+			if (edge.type == Edge::Type_ConstantLatitude) {
+				Real dOrient = node0.x * node1.y - node0.y * node1.x;
+				if (dOrient > 0.0) {
+					fExterior = (node.z < node0.z - Tolerance);
+				} else {
+					fExterior = (node.z > node0.z + Tolerance);
+				}
+
+			} else {
+				fExterior =
+					(DotProduct(CrossProduct(node0, node1), node) < -Tolerance);
+			}
+
+			if (!fExterior) {
+				continue;
+			}
+
+			EdgeMapConstIterator iter = mesh.edgemap.find(edge);
+			if (iter == mesh.edgemap.end()) {
+				continue;
+			}
+
+			if (iter->second[0] == ixFace) {
+				ixNextFace = iter->second[1];
+			} else {
+				ixNextFace = iter->second[0];
+			}
+			break;
+		}
+
+		if (ixNextFace == InvalidFace) {
+			break;
+		}
+
+		ixFace = ixNextFace;
+	}
+
+	// Verify the Node is in the interior of the Face found by the walk
+	Face::NodeLocation loc;
+	int ixLocation;
+
+	ContainsNode(
+		mesh.faces[ixFace],
+		mesh.nodes,
+		node,
+		loc,
+		ixLocation);
+
+	if (loc == Face::NodeLocation_Interior) {
+		aFindFaceStruct.vecFaceIndices.clear();
+		aFindFaceStruct.vecFaceLocations.clear();
+
+		aFindFaceStruct.vecFaceIndices.push_back(ixFace);
+		aFindFaceStruct.vecFaceLocations.push_back(ixLocation);
+		aFindFaceStruct.loc = loc;
+		return;
+	}
+
+	// Nodes on Edges or corners require all adjacent Faces
+	FindFaceFromNode(mesh, node, aFindFaceStruct);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MeshUtilities::SetContainedLocation(
+	int nContainedEdges,
+	const int * ixContainedEdges,
+	Face::NodeLocation & loc,
+	int & ixLocation
+) {
+	// Check if the node is contained on an edge
+	if (nContainedEdges == 1) {
+		loc = Face::NodeLocation_Edge;
+		ixLocation = ixContainedEdges[0];
+		return;
+	}
+
+	// Node is coincident with a corner of this face
+	if (nContainedEdges == 2) {
+		int ix0 = ixContainedEdges[0];
+		int ix1 = ixContainedEdges[1];
+
+		if ((ix0 == 0) && (ix1 != 1)) {
+			ixLocation = 0;
+		} else {
+			ixLocation = ix1;
+		}
+
+		loc = Face::NodeLocation_Corner;
+		return;
+	}
+
+	// Node occurs in more than two edges; error.
+	if (nContainedEdges > 2) {
+		_EXCEPTIONT("Logic error: Node occurs in more than two edges");
+	}
+
+	// Default; node occurs in the interior of the face
+	loc = Face::NodeLocation_Interior;
+	ixLocation = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -45,6 +45,31 @@ public:
 		FindFaceStruct & aFindFaceStruct
 	);
 
+	///	<summary>
+	///		Find all Face indices that contain this Node, starting with a
+	///		walk across the Mesh from the Face ixFaceHint.  The walk
+	///		requires the EdgeMap; if no Face containing the Node in its
+	///		interior is found the search falls back to FindFaceFromNode.
+	///	</summary>
+	void FindFaceFromNode(
+		const Mesh & mesh,
+		const Node & node,
+		int ixFaceHint,
+		FindFaceStruct & aFindFaceStruct
+	);
+
+protected:
+	///	<summary>
+	///		Set the location of a Node within a Face from the indices of the
+	///		(at most two, in increasing order) edges that contain it, given
+	///		the total number of containing edges nContainedEdges.
+	///	</summary>
+	static void SetContainedLocation(
+		int nContainedEdges,
+		const int * ixContainedEdges,
+		Face::NodeLocation & loc,
+		int & ixLocation
+	);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
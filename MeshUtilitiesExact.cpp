@@ -16,12 +16,48 @@
 
 #include "MeshUtilitiesExact.h"
 
+#include "Announce.h"
 #include "Exception.h"
 
 #ifdef USE_EXACT_ARITHMETIC
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Number of calls of CalculateEdgeIntersections.
+///	</summary>
+static AnnounceCounter s_counterIntersections("exact edge intersections");
+
+///////////////////////////////////////////////////////////////////////////////
+
+int MeshUtilitiesExact::FilteredOrientation(
+	const Node & node0,
+	const Node & node1,
+	const Node & node2
+) {
+	// Bound on the difference between the floating point triple product
+	// and the exact triple product of the FixedPoint coordinates, which
+	// accounts for truncation of each coordinate to FixedPoint and
+	// round-off in the floating point evaluation of unit vectors.
+	static const Real ErrorBound = 1.0e-14;
+
+	Real dCrossX = node0.y * node1.z - node0.z * node1.y;
+	Real dCrossY = node0.z * node1.x - node0.x * node1.z;
+	Real dCrossZ = node0.x * node1.y - node0.y * node1.x;
+
+	Real dDot = dCrossX * node2.x + dCrossY * node2.y + dCrossZ * node2.z;
+
+	if (dDot > ErrorBound) {
+		return (+1);
+	}
+	if (dDot < -ErrorBound) {
+		return (-1);
+	}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 bool MeshUtilitiesExact::AreNodesEqual(
 	const NodeExact & node0,
 	const NodeExact & node1
@@ -40,6 +76,16 @@ bool MeshUtilitiesExact::AreNodesEqual(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool MeshUtilitiesExact::IsExcludedBeginNode(
+	const NodeExact & nodeIntersection,
+	const NodeExact & nodeFirstBegin
+) {
+	// Begin nodes are never removed from exact intersections
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void MeshUtilitiesExact::ContainsNode(
 	const Face & face,
 	const NodeVector & nodevec,
@@ -48,8 +94,9 @@ void MeshUtilitiesExact::ContainsNode(
 	int & ixLocation
 ) const {
 
-	// Set of edges which "contain" this node
-	std::set<int> setContainedEdgeIx;
+	// Edges which "contain" this node, of which the first two are recorded
+	int nContainedEdges = 0;
+	int ixContainedEdges[2];
 
 	// Loop through all Edges of this face
 	for (int i = 0; i < face.edges.size(); i++) {
@@ -60,11 +107,27 @@ void MeshUtilitiesExact::ContainsNode(
 		}
 
 		// Check which side of the Face this Edge is on
-		NodeExact na(nodevec[face.edges[i][0]]);
-		NodeExact nb(nodevec[face.edges[i][1]]);
-
 		if (face.edges[i].type == Edge::Type_GreatCircleArc) {
 
+			// Use the floating point orientation if unambiguous
+			int iOrientation =
+				FilteredOrientation(
+					nodevec[face.edges[i][0]],
+					nodevec[face.edges[i][1]],
+					node);
+
+			if (iOrientation < 0) {
+				loc = Face::NodeLocation_Exterior;
+				ixLocation = 0;
+				return;
+			}
+			if (iOrientation > 0) {
+				continue;
+			}
+
+			NodeExact na(nodevec[face.edges[i][0]]);
+			NodeExact nb(nodevec[face.edges[i][1]]);
+
 			FixedPoint fpDotNorm = DotProductX(CrossProductX(na, nb), node);
 /*
 			Node nx = CrossProductX(na, nb);
@@ -111,7 +174,10 @@ void MeshUtilitiesExact::ContainsNode(
 				return;
 			}
 			if (fpDotNorm.IsZero()) {
-				setContainedEdgeIx.insert(i);
+				if (nContainedEdges < 2) {
+					ixContainedEdges[nContainedEdges] = i;
+				}
+				nContainedEdges++;
 			}
 
 		} else if (face.edges[i].type == Edge::Type_ConstantLatitude) {
@@ -122,43 +188,7 @@ void MeshUtilitiesExact::ContainsNode(
 		}
 	}
 
-	// Check if the node is contained on an edge
-	if (setContainedEdgeIx.size() == 1) {
-		loc = Face::NodeLocation_Edge;
-		ixLocation = *(setContainedEdgeIx.begin());
-		return;
-	}
-
-	// Node is coincident with a corner of this face
-	if (setContainedEdgeIx.size() == 2) {
-
-		std::set<int>::iterator iter;
-
-		iter = setContainedEdgeIx.begin();
-		int ix0 = *(iter);
-
-		iter++;
-		int ix1 = *(iter);
-
-		if ((ix0 == 0) && (ix1 != 1)) {
-			ixLocation = 0;
-		} else {
-			ixLocation = ix1;
-		}
-
-		loc = Face::NodeLocation_Corner;
-		return;
-	}
-
-	// Node occurs in more than two edges; error.
-	if (setContainedEdgeIx.size() > 2) {
-		_EXCEPTIONT("Logic error: Node occurs in more than two edges");
-	}
-
-	// Default; node occurs in the interior of the face
-	loc = Face::NodeLocation_Interior;
-	ixLocation = 0;
-	return;
+	SetContainedLocation(nContainedEdges, ixContainedEdges, loc, ixLocation);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -173,7 +203,33 @@ bool MeshUtilitiesExact::CalculateEdgeIntersections(
 	std::vector<NodeExact> & nodeIntersections,
 	bool fIncludeFirstBeginNode
 ) {
-	
+	s_counterIntersections.Add(1);
+
+	// Both edges are great circle arcs; if the endpoints of either edge lie
+	// strictly on the same side of the plane of the other edge then there
+	// are no intersections, and the exact calculation can be skipped
+	if ((typeFirst  == Edge::Type_GreatCircleArc) &&
+		(typeSecond == Edge::Type_GreatCircleArc)
+	) {
+		int iOrient11 =
+			FilteredOrientation(nodeSecondBegin, nodeSecondEnd, nodeFirstBegin);
+		int iOrient12 =
+			FilteredOrientation(nodeSecondBegin, nodeSecondEnd, nodeFirstEnd);
+		int iOrient21 =
+			FilteredOrientation(nodeFirstBegin, nodeFirstEnd, nodeSecondBegin);
+		int iOrient22 =
+			FilteredOrientation(nodeFirstBegin, nodeFirstEnd, nodeSecondEnd);
+
+		if ((iOrient11 != 0) && (iOrient12 != 0) &&
+			(iOrient21 != 0) && (iOrient22 != 0)
+		) {
+			if ((iOrient11 == iOrient12) || (iOrient21 == iOrient22)) {
+				nodeIntersections.clear();
+				return false;
+			}
+		}
+	}
+
 	// Make a locally modifyable version of the Nodes
 	NodeExact node11;
 	NodeExact node12;
@@ -461,10 +517,10 @@ int MeshUtilitiesExact::FindFaceNearNode(
 	// Get the reference point
 	NodeExact nodeBegin = mesh.nodes[ixNode];
 
-	// Get the set of faces adjacent this node
-	const std::set<int> & setNearbyFaces = mesh.revnodearray[ixNode];
+	// Get the number of faces adjacent this node
+	int nNearbyFaces = mesh.revnodearray.GetFaceCount(ixNode);
 
-	if (setNearbyFaces.size() < 3) {
+	if (nNearbyFaces < 3) {
 		_EXCEPTIONT("Insufficient Faces at Corner; at least three Faces expected");
 	}
 
@@ -485,10 +541,11 @@ int MeshUtilitiesExact::FindFaceNearNode(
 	printf("BENorm: "); fpDotNeNb.Print(); printf("\n");
 */
 	// Loop through all faces
-	std::set<int>::const_iterator iter = setNearbyFaces.begin();
-	for (; iter != setNearbyFaces.end(); iter++) {
+	for (int ixNearby = 0; ixNearby < nNearbyFaces; ixNearby++) {
+
+		int ixFace = mesh.revnodearray.GetFace(ixNode, ixNearby);
 
-		const Face & face = mesh.faces[*iter];
+		const Face & face = mesh.faces[ixFace];
 
 		int nEdges = face.edges.size();
 
@@ -601,12 +658,12 @@ int MeshUtilitiesExact::FindFaceNearNode(
 
 		if (fpDenom.IsPositive()) {
 			if (fp2.IsNonNegative() && fp0.IsPositive()) {
-				return (*iter);
+				return ixFace;
 			}
 
 		} else {
 			if (fp2.IsNonPositive() && fp0.IsNegative()) {
-				return (*iter);
+				return ixFace;
 			}
 		}
 	}
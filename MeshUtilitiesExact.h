@@ -60,6 +60,21 @@ public:
 		return nodeReal;
 	}
 
+	///	<summary>
+	///		Determine the sign of the triple product (node0 x node1) . node2
+	///		using floating point arithmetic.  The sign is only reported if
+	///		the error bound guarantees that it agrees with the exact
+	///		FixedPoint evaluation of the same triple product.
+	///	</summary>
+	///	<returns>
+	///		+1 or -1 if the sign is certain, 0 if exact evaluation is needed.
+	///	</returns>
+	static int FilteredOrientation(
+		const Node & node0,
+		const Node & node1,
+		const Node & node2
+	);
+
 	///	<summary>
 	///		Determine if two Nodes are equal.
 	///	</summary>
@@ -68,6 +83,15 @@ public:
 		const NodeExact & node1
 	);
 
+	///	<summary>
+	///		Determine if an intersection Node would be removed from the output
+	///		of CalculateEdgeIntersections when fIncludeFirstBeginNode is false.
+	///	</summary>
+	bool IsExcludedBeginNode(
+		const NodeExact & nodeIntersection,
+		const NodeExact & nodeFirstBegin
+	);
+
 	///	<summary>
 	///		Determine if face contains node, and whether
 	///		the Node is along an edge or at a corner.
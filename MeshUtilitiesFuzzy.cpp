@@ -16,10 +16,18 @@
 
 #include "MeshUtilitiesFuzzy.h"
 
+#include "Announce.h"
 #include "Exception.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Number of calls of CalculateEdgeIntersections.
+///	</summary>
+static AnnounceCounter s_counterIntersections("fuzzy edge intersections");
+
+///////////////////////////////////////////////////////////////////////////////
+
 bool MeshUtilitiesFuzzy::AreNodesEqual(
 	const Node & node0,
 	const Node & node1
@@ -47,6 +55,15 @@ bool MeshUtilitiesFuzzy::AreNodesEqual(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool MeshUtilitiesFuzzy::IsExcludedBeginNode(
+	const Node & nodeIntersection,
+	const Node & nodeFirstBegin
+) {
+	return AreNodesEqual(nodeIntersection, nodeFirstBegin);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void MeshUtilitiesFuzzy::ContainsNode(
 	const Face & face,
 	const NodeVector & nodevec,
@@ -56,8 +73,9 @@ void MeshUtilitiesFuzzy::ContainsNode(
 ) const {
 	static const Real Tolerance = ReferenceTolerance;
 
-	// Set of edges which "contain" this node
-	std::set<int> setContainedEdgeIx;
+	// Edges which "contain" this node, of which the first two are recorded
+	int nContainedEdges = 0;
+	int ixContainedEdges[2];
 
 	// Loop through all edges of this face
 	for (int i = 0; i < face.edges.size(); i++) {
@@ -80,7 +98,10 @@ void MeshUtilitiesFuzzy::ContainsNode(
 				return;
 			}
 			if (dDotNorm < Tolerance) {
-				setContainedEdgeIx.insert(i);
+				if (nContainedEdges < 2) {
+					ixContainedEdges[nContainedEdges] = i;
+				}
+				nContainedEdges++;
 			}
 
 		} else if (face.edges[i].type == Edge::Type_ConstantLatitude) {
@@ -93,7 +114,10 @@ void MeshUtilitiesFuzzy::ContainsNode(
 				return;
 			}
 			if (dDotNorm < Tolerance) {
-				setContainedEdgeIx.insert(i);
+				if (nContainedEdges < 2) {
+					ixContainedEdges[nContainedEdges] = i;
+				}
+				nContainedEdges++;
 			}
 
 		} else {
@@ -101,775 +125,695 @@ void MeshUtilitiesFuzzy::ContainsNode(
 		}
 	}
 
-	// Check if the node is contained on an edge
-	if (setContainedEdgeIx.size() == 1) {
-		loc = Face::NodeLocation_Edge;
-		ixLocation = *(setContainedEdgeIx.begin());
-		return;
-	}
-
-	// Node is coincident with a corner of this face
-	if (setContainedEdgeIx.size() == 2) {
-
-		std::set<int>::iterator iter;
-
-		iter = setContainedEdgeIx.begin();
-		int ix0 = *(iter);
-
-		iter++;
-		int ix1 = *(iter);
-
-		if ((ix0 == 0) && (ix1 != 1)) {
-			ixLocation = 0;
-		} else {
-			ixLocation = ix1;
-		}
-
-		loc = Face::NodeLocation_Corner;
-		return;
-	}
-
-	// Node occurs in more than two edges; error.
-	if (setContainedEdgeIx.size() > 2) {
-		_EXCEPTIONT("Logic error: Node occurs in more than two edges");
-	}
-
-	// Default; node occurs in the interior of the face
-	loc = Face::NodeLocation_Interior;
-	ixLocation = 0;
-	return;
+	SetContainedLocation(nContainedEdges, ixContainedEdges, loc, ixLocation);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool MeshUtilitiesFuzzy::CalculateEdgeIntersections(
+template <>
+bool MeshUtilitiesFuzzy::CalculateEdgeIntersectionsKernel<
+	Edge::Type_GreatCircleArc, Edge::Type_GreatCircleArc>(
+	const Node & node11,
+	const Node & node12,
+	const Node & node21,
+	const Node & node22,
 	const Node & nodeFirstBegin,
-	const Node & nodeFirstEnd,
-	Edge::Type typeFirst,
-	const Node & nodeSecondBegin,
-	const Node & nodeSecondEnd,
-	Edge::Type typeSecond,
 	std::vector<Node> & nodeIntersections,
 	bool fIncludeFirstBeginNode
 ) {
 	static const Real Tolerance = ReferenceTolerance;
 
-	// Make a locally modifyable version of the Nodes
-	Node node11;
-	Node node12;
-	Node node21;
-	Node node22;
-
-	// Second edge is a line of constant latitude; first is a great circle arc
-	if ((typeFirst  == Edge::Type_ConstantLatitude) &&
-		(typeSecond == Edge::Type_GreatCircleArc)
-	) {
-		node11 = nodeSecondBegin;
-		node12 = nodeSecondEnd;
-		node21 = nodeFirstBegin;
-		node22 = nodeFirstEnd;
-
-		typeFirst = Edge::Type_GreatCircleArc;
-		typeSecond = Edge::Type_ConstantLatitude;
-
-	} else {
-		node11 = nodeFirstBegin;
-		node12 = nodeFirstEnd;
-		node21 = nodeSecondBegin;
-		node22 = nodeSecondEnd;
-	}
-
-	// Check for coincident nodes
-	if (AreNodesEqual(node11, node12)) {
-		_EXCEPTIONT("Coincident nodes used to define edge");
-	}
-	if (AreNodesEqual(node21, node22)) {
-		_EXCEPTIONT("Coincident nodes used to define edge");
-	}
+	// Cross products
+	Node nodeN11xN12(CrossProduct(node11, node12));
+	Node nodeN21xN22(CrossProduct(node21, node22));
 
-	// Clear the intersection vector
-	nodeIntersections.clear();
-
-	// Both edges are great circle arcs
-	if ((typeFirst  == Edge::Type_GreatCircleArc) &&
-		(typeSecond == Edge::Type_GreatCircleArc)
-	) {
-		// Cross products
-		Node nodeN11xN12(CrossProduct(node11, node12));
-		Node nodeN21xN22(CrossProduct(node21, node22));
-
-		// Check for coincident lines
-		Real dDot11 = DotProduct(nodeN21xN22, node11);
-		Real dDot12 = DotProduct(nodeN21xN22, node12);
-		Real dDot21 = DotProduct(nodeN11xN12, node21);
-		Real dDot22 = DotProduct(nodeN11xN12, node22);
+	// Check for coincident lines
+	Real dDot11 = DotProduct(nodeN21xN22, node11);
+	Real dDot12 = DotProduct(nodeN21xN22, node12);
+	Real dDot21 = DotProduct(nodeN11xN12, node21);
+	Real dDot22 = DotProduct(nodeN11xN12, node22);
 /*
-		printf("%1.15e %1.15e %1.15e %1.15e\n",
-			dDot11, dDot12, dDot21, dDot22);
-
-		printf("\n");
-		node11.Print("n11");
-		node12.Print("n12");
-		node21.Print("n21");
-		node22.Print("n22");
+	printf("%1.15e %1.15e %1.15e %1.15e\n",
+		dDot11, dDot12, dDot21, dDot22);
+
+	printf("\n");
+	node11.Print("n11");
+	node12.Print("n12");
+	node21.Print("n21");
+	node22.Print("n22");
 */
-		// A line which is coincident with both planes
-		Node nodeLine;
+	// A line which is coincident with both planes
+	Node nodeLine;
 
-		// Coincident planes
-		if ((fabs(dDot11) < Tolerance) &&
-			(fabs(dDot21) < Tolerance)
-		) {
-			return true;
+	// Coincident planes
+	if ((fabs(dDot11) < Tolerance) &&
+		(fabs(dDot21) < Tolerance)
+	) {
+		return true;
 
-		// node11 is coplanar with the second arc
-		} else if (fabs(dDot11) < Tolerance) {
-			nodeLine = node11;
+	// node11 is coplanar with the second arc
+	} else if (fabs(dDot11) < Tolerance) {
+		nodeLine = node11;
 
-		// node12 is coplanar with the second arc
-		} else if (fabs(dDot12) < Tolerance) {
-			nodeLine = node12;
+	// node12 is coplanar with the second arc
+	} else if (fabs(dDot12) < Tolerance) {
+		nodeLine = node12;
 
-		// node21 is coplanar with the first arc
-		} else if (fabs(dDot21) < Tolerance) {
-			nodeLine = node21;
+	// node21 is coplanar with the first arc
+	} else if (fabs(dDot21) < Tolerance) {
+		nodeLine = node21;
 
-		// node22 is coplanar with the first arc
-		} else if (fabs(dDot22) < Tolerance) {
-			nodeLine = node22;
+	// node22 is coplanar with the first arc
+	} else if (fabs(dDot22) < Tolerance) {
+		nodeLine = node22;
 
-		// Line of intersection is the cross product of cross products
-		} else {
-			nodeLine = CrossProduct(nodeN11xN12, nodeN21xN22);
+	// Line of intersection is the cross product of cross products
+	} else {
+		nodeLine = CrossProduct(nodeN11xN12, nodeN21xN22);
 
-			// Verify coplanarity
-			Real dDotDebug1 = DotProduct(nodeLine, nodeN11xN12);
-			Real dDotDebug2 = DotProduct(nodeLine, nodeN21xN22);
+		// Verify coplanarity
+		Real dDotDebug1 = DotProduct(nodeLine, nodeN11xN12);
+		Real dDotDebug2 = DotProduct(nodeLine, nodeN21xN22);
 
-			if ((fabs(dDotDebug1) > Tolerance) ||
-				(fabs(dDotDebug2) > Tolerance)
-			) {
-				printf("%1.5e %1.5e\n", dDotDebug1, dDotDebug2);
-				_EXCEPTIONT("Logic error");
-			}
+		if ((fabs(dDotDebug1) > Tolerance) ||
+			(fabs(dDotDebug2) > Tolerance)
+		) {
+			printf("%1.5e %1.5e\n", dDotDebug1, dDotDebug2);
+			_EXCEPTIONT("Logic error");
 		}
+	}
 /*
-		// True if nodeLine is in the fan of node11 and node12.  False if
-		// -nodeLine is in the fan of node11 and node12.
-		bool fFirstPosModeInRange = true;
-		bool fSecondPosModeInRange = true;
+	// True if nodeLine is in the fan of node11 and node12.  False if
+	// -nodeLine is in the fan of node11 and node12.
+	bool fFirstPosModeInRange = true;
+	bool fSecondPosModeInRange = true;
 
-		Real dDenom;
-		Real dC;
-		Real dD;
+	Real dDenom;
+	Real dC;
+	Real dD;
 
-		// Determine if nodeLine is in the fan of [node11, node12]
-		if (fabs(nodeN11xN12.x) > Tolerance) {
-			dDenom = nodeN11xN12.x;
+	// Determine if nodeLine is in the fan of [node11, node12]
+	if (fabs(nodeN11xN12.x) > Tolerance) {
+		dDenom = nodeN11xN12.x;
 
-			dC = nodeLine.y * node12.z - nodeLine.z * node12.y;
-			dD = nodeLine.z * node11.y - nodeLine.y * node11.z;
+		dC = nodeLine.y * node12.z - nodeLine.z * node12.y;
+		dD = nodeLine.z * node11.y - nodeLine.y * node11.z;
 
-		} else if (fabs(nodeN11xN12.y) > Tolerance) {
-			dDenom = nodeN11xN12.y;
+	} else if (fabs(nodeN11xN12.y) > Tolerance) {
+		dDenom = nodeN11xN12.y;
 
-			dC = nodeLine.z * node12.x - nodeLine.x * node12.z;
-			dD = nodeLine.x * node11.z - nodeLine.z * node11.x;
+		dC = nodeLine.z * node12.x - nodeLine.x * node12.z;
+		dD = nodeLine.x * node11.z - nodeLine.z * node11.x;
 
-		} else if (fabs(nodeN11xN12.z) > Tolerance) {
-			dDenom = nodeN11xN12.z;
+	} else if (fabs(nodeN11xN12.z) > Tolerance) {
+		dDenom = nodeN11xN12.z;
 
-			dC = nodeLine.x * node12.y - nodeLine.y * node12.x;
-			dD = nodeLine.y * node11.x - nodeLine.x * node11.y;
+		dC = nodeLine.x * node12.y - nodeLine.y * node12.x;
+		dD = nodeLine.y * node11.x - nodeLine.x * node11.y;
 
-		} else {
-			_EXCEPTIONT("Zero Cross product detected");
-		}
+	} else {
+		_EXCEPTIONT("Zero Cross product detected");
+	}
 
-		if ((dC <= -Tolerance) && (dD >= Tolerance)) {
-			return false;
-		} else if ((dC >= Tolerance) && (dD <= -Tolerance)) {
-			return false;
-		} else if ((dC >= -Tolerance) && (dD >= -Tolerance)) {
-			fFirstPosModeInRange = (dDenom > 0.0);
-		} else {
-			fFirstPosModeInRange = (dDenom < 0.0);
-		}
+	if ((dC <= -Tolerance) && (dD >= Tolerance)) {
+		return false;
+	} else if ((dC >= Tolerance) && (dD <= -Tolerance)) {
+		return false;
+	} else if ((dC >= -Tolerance) && (dD >= -Tolerance)) {
+		fFirstPosModeInRange = (dDenom > 0.0);
+	} else {
+		fFirstPosModeInRange = (dDenom < 0.0);
+	}
 
-		// If we have reached this point then nodeLine is in the fan
-		// of [node11, node12].  Now determine if nodeLine is in the
-		// fan of [node21, node22].
-		if (fabs(nodeN21xN22.x) > Tolerance) {
-			dDenom = nodeN21xN22.x;
+	// If we have reached this point then nodeLine is in the fan
+	// of [node11, node12].  Now determine if nodeLine is in the
+	// fan of [node21, node22].
+	if (fabs(nodeN21xN22.x) > Tolerance) {
+		dDenom = nodeN21xN22.x;
 
-			dC = nodeLine.y * node22.z - nodeLine.z * node22.y;
-			dD = nodeLine.z * node21.y - nodeLine.y * node21.z;
+		dC = nodeLine.y * node22.z - nodeLine.z * node22.y;
+		dD = nodeLine.z * node21.y - nodeLine.y * node21.z;
 
-		} else if (fabs(nodeN21xN22.y) > Tolerance) {
-			dDenom = nodeN21xN22.y;
+	} else if (fabs(nodeN21xN22.y) > Tolerance) {
+		dDenom = nodeN21xN22.y;
 
-			dC = nodeLine.z * node22.x - nodeLine.x * node22.z;
-			dD = nodeLine.x * node21.z - nodeLine.z * node21.x;
+		dC = nodeLine.z * node22.x - nodeLine.x * node22.z;
+		dD = nodeLine.x * node21.z - nodeLine.z * node21.x;
 
-		} else if (fabs(nodeN21xN22.z) > Tolerance) {
-			dDenom = nodeN21xN22.z;
+	} else if (fabs(nodeN21xN22.z) > Tolerance) {
+		dDenom = nodeN21xN22.z;
 
-			dC = nodeLine.x * node22.y - nodeLine.y * node22.x;
-			dD = nodeLine.y * node21.x - nodeLine.x * node21.y;
+		dC = nodeLine.x * node22.y - nodeLine.y * node22.x;
+		dD = nodeLine.y * node21.x - nodeLine.x * node21.y;
 
-		} else {
-			_EXCEPTIONT("Zero Cross product detected");
-		}
+	} else {
+		_EXCEPTIONT("Zero Cross product detected");
+	}
 
-		if ((dC <= -Tolerance) && (dD >= Tolerance)) {
-			return false;
-		} else if ((dC >= Tolerance) && (dD <= -Tolerance)) {
-			return false;
-		} else if ((dC >= -Tolerance) && (dD >= -Tolerance)) {
-			fSecondPosModeInRange = (dDenom > 0.0);
-		} else {
-			fSecondPosModeInRange = (dDenom < 0.0);
-		}
+	if ((dC <= -Tolerance) && (dD >= Tolerance)) {
+		return false;
+	} else if ((dC >= Tolerance) && (dD <= -Tolerance)) {
+		return false;
+	} else if ((dC >= -Tolerance) && (dD >= -Tolerance)) {
+		fSecondPosModeInRange = (dDenom > 0.0);
+	} else {
+		fSecondPosModeInRange = (dDenom < 0.0);
+	}
 
-		// Verify fans are not antipodal
-		if (fFirstPosModeInRange != fSecondPosModeInRange) {
-			return false;
-		}
+	// Verify fans are not antipodal
+	if (fFirstPosModeInRange != fSecondPosModeInRange) {
+		return false;
+	}
 
-		// Solution exists
-		if (!fFirstPosModeInRange) {
-			nodeLine.x = - nodeLine.x;
-			nodeLine.y = - nodeLine.y;
-			nodeLine.z = - nodeLine.z;
-		} 
+	// Solution exists
+	if (!fFirstPosModeInRange) {
+		nodeLine.x = - nodeLine.x;
+		nodeLine.y = - nodeLine.y;
+		nodeLine.z = - nodeLine.z;
+	} 
 
-		nodeIntersections.push_back(nodeLine);
-		return false;
+	nodeIntersections.push_back(nodeLine);
+	return false;
 */
 
-		// Find the intersection point
-		Real dMagLine = nodeLine.Magnitude();
+	// Find the intersection point
+	Real dMagLine = nodeLine.Magnitude();
 
-		nodeLine.x /= dMagLine;
-		nodeLine.y /= dMagLine;
-		nodeLine.z /= dMagLine;
+	nodeLine.x /= dMagLine;
+	nodeLine.y /= dMagLine;
+	nodeLine.z /= dMagLine;
 
-		// Check whether each podal point falls within the range
-		Real dAngle11;
-		Real dAngle12;
-		Real dAngle21;
-		Real dAngle22;
+	// Check whether each podal point falls within the range
+	Real dAngle11;
+	Real dAngle12;
+	Real dAngle21;
+	Real dAngle22;
 
-		Real dAngle1 = 1.0 - DotProduct(node11, node12);
-		Real dAngle2 = 1.0 - DotProduct(node21, node22);
+	Real dAngle1 = 1.0 - DotProduct(node11, node12);
+	Real dAngle2 = 1.0 - DotProduct(node21, node22);
 
-		// Check positive node
-		dAngle11 = 1.0 - DotProduct(nodeLine, node11);
-		dAngle12 = 1.0 - DotProduct(nodeLine, node12);
-		dAngle21 = 1.0 - DotProduct(nodeLine, node21);
-		dAngle22 = 1.0 - DotProduct(nodeLine, node22);
+	// Check positive node
+	dAngle11 = 1.0 - DotProduct(nodeLine, node11);
+	dAngle12 = 1.0 - DotProduct(nodeLine, node12);
+	dAngle21 = 1.0 - DotProduct(nodeLine, node21);
+	dAngle22 = 1.0 - DotProduct(nodeLine, node22);
 
-		if ((dAngle11 < dAngle1 + Tolerance) &&
-			(dAngle12 < dAngle1 + Tolerance) &&
-			(dAngle21 < dAngle2 + Tolerance) &&
-			(dAngle22 < dAngle2 + Tolerance)
+	if ((dAngle11 < dAngle1 + Tolerance) &&
+		(dAngle12 < dAngle1 + Tolerance) &&
+		(dAngle21 < dAngle2 + Tolerance) &&
+		(dAngle22 < dAngle2 + Tolerance)
+	) {
+		if ((AreNodesEqual(nodeLine, nodeFirstBegin)) &&
+			!fIncludeFirstBeginNode
 		) {
-			if ((AreNodesEqual(nodeLine, nodeFirstBegin)) &&
-				!fIncludeFirstBeginNode
-			) {
-				return false;
-			}
-
-			nodeIntersections.push_back(nodeLine);
 			return false;
 		}
 
-		// Check negative node
-		nodeLine.x *= (-1.0);
-		nodeLine.y *= (-1.0);
-		nodeLine.z *= (-1.0);
+		nodeIntersections.push_back(nodeLine);
+		return false;
+	}
 
-		dAngle11 = 1.0 - DotProduct(nodeLine, node11);
-		dAngle12 = 1.0 - DotProduct(nodeLine, node12);
-		dAngle21 = 1.0 - DotProduct(nodeLine, node21);
-		dAngle22 = 1.0 - DotProduct(nodeLine, node22);
+	// Check negative node
+	nodeLine.x *= (-1.0);
+	nodeLine.y *= (-1.0);
+	nodeLine.z *= (-1.0);
 
-		if ((dAngle11 < dAngle1 + Tolerance) &&
-			(dAngle12 < dAngle1 + Tolerance) &&
-			(dAngle21 < dAngle2 + Tolerance) &&
-			(dAngle22 < dAngle2 + Tolerance)
-		) {
-			if ((AreNodesEqual(nodeLine, nodeFirstBegin)) &&
-				!fIncludeFirstBeginNode
-			) {
-				return false;
-			}
+	dAngle11 = 1.0 - DotProduct(nodeLine, node11);
+	dAngle12 = 1.0 - DotProduct(nodeLine, node12);
+	dAngle21 = 1.0 - DotProduct(nodeLine, node21);
+	dAngle22 = 1.0 - DotProduct(nodeLine, node22);
 
-			nodeIntersections.push_back(nodeLine);
+	if ((dAngle11 < dAngle1 + Tolerance) &&
+		(dAngle12 < dAngle1 + Tolerance) &&
+		(dAngle21 < dAngle2 + Tolerance) &&
+		(dAngle22 < dAngle2 + Tolerance)
+	) {
+		if ((AreNodesEqual(nodeLine, nodeFirstBegin)) &&
+			!fIncludeFirstBeginNode
+		) {
 			return false;
 		}
 
-		// No intersections
+		nodeIntersections.push_back(nodeLine);
 		return false;
+	}
+
+	// No intersections
+	return false;
 
 /*
-		// n11 dot n12
-		Real dN11oN12 =
-			+ node11.x * node12.x
-			+ node11.y * node12.y
-			+ node11.z * node12.z;
-
-		// Cross product of second vectors
-		Node nodeN21xN22(
-			+ node21.y * node22.z - node21.z * node22.y,
-			- node21.x * node22.z + node21.z * node22.x,
-			+ node21.x * node22.y - node21.y * node22.x);
-
-		// Other Cross products
-		Node nodeN12xN21(
-			+ node12.y * node21.z - node12.z * node21.y,
-			- node12.x * node21.z + node12.z * node21.x,
-			+ node12.x * node21.y - node12.y * node21.x);
-
-		Node nodeN12xN22(
-			+ node12.y * node22.z - node12.z * node22.y,
-			- node12.x * node22.z + node12.z * node22.x,
-			+ node12.x * node22.y - node12.y * node22.x);
-
-		// n12 dot (n21 cross n22)
-		Real dN12oN21xN22 =
-			+ node12.x * nodeN21xN22.x
-			+ node12.y * nodeN21xN22.y
-			+ node12.z * nodeN21xN22.z;
+	// n11 dot n12
+	Real dN11oN12 =
+		+ node11.x * node12.x
+		+ node11.y * node12.y
+		+ node11.z * node12.z;
+
+	// Cross product of second vectors
+	Node nodeN21xN22(
+		+ node21.y * node22.z - node21.z * node22.y,
+		- node21.x * node22.z + node21.z * node22.x,
+		+ node21.x * node22.y - node21.y * node22.x);
+
+	// Other Cross products
+	Node nodeN12xN21(
+		+ node12.y * node21.z - node12.z * node21.y,
+		- node12.x * node21.z + node12.z * node21.x,
+		+ node12.x * node21.y - node12.y * node21.x);
+
+	Node nodeN12xN22(
+		+ node12.y * node22.z - node12.z * node22.y,
+		- node12.x * node22.z + node12.z * node22.x,
+		+ node12.x * node22.y - node12.y * node22.x);
+
+	// n12 dot (n21 cross n22)
+	Real dN12oN21xN22 =
+		+ node12.x * nodeN21xN22.x
+		+ node12.y * nodeN21xN22.y
+		+ node12.z * nodeN21xN22.z;
+
+	// n11 dot (n21 cross n22)
+	Real dN11oN21xN22 =
+		+ node11.x * nodeN21xN22.x
+		+ node11.y * nodeN21xN22.y
+		+ node11.z * nodeN21xN22.z;
+
+	// Check if all four vectors lay in the same plane (coincident lines)
+	if ((fabs(dN11oN21xN22) < Tolerance) &&
+	    (fabs(dN12oN21xN22) < Tolerance)
+	) {
+		// If coincident, check for intersections
+		Node nodeN11xN12(
+			+ node11.y * node12.z - node11.z * node12.y,
+			- node11.x * node12.z + node11.z * node12.x,
+			+ node11.x * node12.y - node11.y * node12.x);
 
-		// n11 dot (n21 cross n22)
-		Real dN11oN21xN22 =
-			+ node11.x * nodeN21xN22.x
-			+ node11.y * nodeN21xN22.y
-			+ node11.z * nodeN21xN22.z;
+		// Use the largest element of the cross product
+		Real dA0;
+		Real dA1;
+		Real dB0;
+		Real dB1;
 
-		// Check if all four vectors lay in the same plane (coincident lines)
-		if ((fabs(dN11oN21xN22) < Tolerance) &&
-		    (fabs(dN12oN21xN22) < Tolerance)
+		if ((fabs(nodeN11xN12.x) > fabs(nodeN11xN12.y)) &&
+			(fabs(nodeN11xN12.x) > fabs(nodeN11xN12.z))
 		) {
-			// If coincident, check for intersections
-			Node nodeN11xN12(
-				+ node11.y * node12.z - node11.z * node12.y,
-				- node11.x * node12.z + node11.z * node12.x,
-				+ node11.x * node12.y - node11.y * node12.x);
-
-			// Use the largest element of the cross product
-			Real dA0;
-			Real dA1;
-			Real dB0;
-			Real dB1;
-
-			if ((fabs(nodeN11xN12.x) > fabs(nodeN11xN12.y)) &&
-				(fabs(nodeN11xN12.x) > fabs(nodeN11xN12.z))
-			) {
-				dA0 = - node12.y * node21.z + node12.z * node21.y;
-				dA1 = - node12.y * node22.z + node12.z * node22.y;
+			dA0 = - node12.y * node21.z + node12.z * node21.y;
+			dA1 = - node12.y * node22.z + node12.z * node22.y;
 
-				dB0 = + node11.y * node21.z - node11.z * node21.y;
-				dB1 = + node11.y * node22.z - node11.z * node22.y;
+			dB0 = + node11.y * node21.z - node11.z * node21.y;
+			dB1 = + node11.y * node22.z - node11.z * node22.y;
 
-				dA0 /= - nodeN11xN12.x;
-				dA1 /= - nodeN11xN12.x;
-				dB0 /= - nodeN11xN12.x;
-				dB1 /= - nodeN11xN12.x;
+			dA0 /= - nodeN11xN12.x;
+			dA1 /= - nodeN11xN12.x;
+			dB0 /= - nodeN11xN12.x;
+			dB1 /= - nodeN11xN12.x;
 
-			} else if (
-				(fabs(nodeN11xN12.y) > fabs(nodeN11xN12.x)) &&
-				(fabs(nodeN11xN12.y) > fabs(nodeN11xN12.z))
-			) {
-				dA0 = - node12.x * node21.z + node12.z * node21.x;
-				dA1 = - node12.x * node22.z + node12.z * node22.x;
+		} else if (
+			(fabs(nodeN11xN12.y) > fabs(nodeN11xN12.x)) &&
+			(fabs(nodeN11xN12.y) > fabs(nodeN11xN12.z))
+		) {
+			dA0 = - node12.x * node21.z + node12.z * node21.x;
+			dA1 = - node12.x * node22.z + node12.z * node22.x;
 
-				dB0 = + node11.x * node21.z - node11.z * node21.x;
-				dB1 = + node11.x * node22.z - node11.z * node22.x;
+			dB0 = + node11.x * node21.z - node11.z * node21.x;
+			dB1 = + node11.x * node22.z - node11.z * node22.x;
 
-				dA0 /= - nodeN11xN12.y;
-				dA1 /= - nodeN11xN12.y;
-				dB0 /= - nodeN11xN12.y;
-				dB1 /= - nodeN11xN12.y;
+			dA0 /= - nodeN11xN12.y;
+			dA1 /= - nodeN11xN12.y;
+			dB0 /= - nodeN11xN12.y;
+			dB1 /= - nodeN11xN12.y;
 
-			} else {
-				dA0 = - node12.x * node21.y + node12.y * node21.x;
-				dA1 = - node12.x * node22.y + node12.y * node22.x;
+		} else {
+			dA0 = - node12.x * node21.y + node12.y * node21.x;
+			dA1 = - node12.x * node22.y + node12.y * node22.x;
 
-				dB0 = + node11.x * node21.y - node11.y * node21.x;
-				dB1 = + node11.x * node22.y - node11.y * node22.x;
+			dB0 = + node11.x * node21.y - node11.y * node21.x;
+			dB1 = + node11.x * node22.y - node11.y * node22.x;
 
-				dA0 /= nodeN11xN12.z;
-				dA1 /= nodeN11xN12.z;
-				dB0 /= nodeN11xN12.z;
-				dB1 /= nodeN11xN12.z;
-			}
+			dA0 /= nodeN11xN12.z;
+			dA1 /= nodeN11xN12.z;
+			dB0 /= nodeN11xN12.z;
+			dB1 /= nodeN11xN12.z;
+		}
 
-			// Insert in order from FirstBegin to FirstEnd
-			if (dA0 < dA1) {
-				if ((dA0 > -Tolerance) && (dB0 > -Tolerance)) {
-					nodeIntersections.push_back(node21);
-				}
-				if ((dA1 > -Tolerance) && (dB1 > -Tolerance)) {
-					nodeIntersections.push_back(node22);
-				}
-			} else {
-				if ((dA1 > -Tolerance) && (dB1 > -Tolerance)) {
-					nodeIntersections.push_back(node22);
-				}
-				if ((dA0 > -Tolerance) && (dB0 > -Tolerance)) {
-					nodeIntersections.push_back(node21);
-				}
+		// Insert in order from FirstBegin to FirstEnd
+		if (dA0 < dA1) {
+			if ((dA0 > -Tolerance) && (dB0 > -Tolerance)) {
+				nodeIntersections.push_back(node21);
+			}
+			if ((dA1 > -Tolerance) && (dB1 > -Tolerance)) {
+				nodeIntersections.push_back(node22);
+			}
+		} else {
+			if ((dA1 > -Tolerance) && (dB1 > -Tolerance)) {
+				nodeIntersections.push_back(node22);
+			}
+			if ((dA0 > -Tolerance) && (dB0 > -Tolerance)) {
+				nodeIntersections.push_back(node21);
 			}
+		}
 
-			// Remove intersections that coincide with the first begin node
-			if (!fIncludeFirstBeginNode) {
-				for (int i = 0; i < nodeIntersections.size(); i++) {
-					if (nodeIntersections[i] == nodeFirstBegin) {
-						nodeIntersections.erase(nodeIntersections.begin()+i);
-					}
+		// Remove intersections that coincide with the first begin node
+		if (!fIncludeFirstBeginNode) {
+			for (int i = 0; i < nodeIntersections.size(); i++) {
+				if (nodeIntersections[i] == nodeFirstBegin) {
+					nodeIntersections.erase(nodeIntersections.begin()+i);
 				}
 			}
-
-			return true;
 		}
 
-		// Solution coefficients
-		Real dA0;
-		Real dB0;
-		Real dC0;
-		Real dD0;
+		return true;
+	}
 
-		Real dNumerC =
-			+ node11.x * nodeN12xN22.x
-			+ node11.y * nodeN12xN22.y
-			+ node11.z * nodeN12xN22.z;
+	// Solution coefficients
+	Real dA0;
+	Real dB0;
+	Real dC0;
+	Real dD0;
 
-		Real dNumerD =
-			+ node11.x * nodeN12xN21.x
-			+ node11.y * nodeN12xN21.y
-			+ node11.z * nodeN12xN21.z;
+	Real dNumerC =
+		+ node11.x * nodeN12xN22.x
+		+ node11.y * nodeN12xN22.y
+		+ node11.z * nodeN12xN22.z;
 
-		// node12 is farthest from the plane defining node21 and node22
-		if (fabs(dN11oN21xN22) < fabs(dN12oN21xN22)) {
+	Real dNumerD =
+		+ node11.x * nodeN12xN21.x
+		+ node11.y * nodeN12xN21.y
+		+ node11.z * nodeN12xN21.z;
 
-			Real dNumerB =
-				+ node11.x * nodeN21xN22.x
-				+ node11.y * nodeN21xN22.y
-				+ node11.z * nodeN21xN22.z;
+	// node12 is farthest from the plane defining node21 and node22
+	if (fabs(dN11oN21xN22) < fabs(dN12oN21xN22)) {
 
-			Real dMB = - dNumerB / dN12oN21xN22;
-			Real dMC = - dNumerC / dN12oN21xN22;
-			Real dMD = + dNumerD / dN12oN21xN22;
+		Real dNumerB =
+			+ node11.x * nodeN21xN22.x
+			+ node11.y * nodeN21xN22.y
+			+ node11.z * nodeN21xN22.z;
 
-			Real dDenom = dMB * dMB + 2.0 * dMB * dN11oN12 + 1.0;
+		Real dMB = - dNumerB / dN12oN21xN22;
+		Real dMC = - dNumerC / dN12oN21xN22;
+		Real dMD = + dNumerD / dN12oN21xN22;
 
-			dA0 = 1.0 / sqrt(dDenom);
-			dB0 = dA0 * dMB;
-			dC0 = dA0 * dMC;
-			dD0 = dA0 * dMD;
+		Real dDenom = dMB * dMB + 2.0 * dMB * dN11oN12 + 1.0;
 
-		// node11 is farthest from the plane defining node21 and node22
-		} else {
+		dA0 = 1.0 / sqrt(dDenom);
+		dB0 = dA0 * dMB;
+		dC0 = dA0 * dMC;
+		dD0 = dA0 * dMD;
 
-			Real dNumerA =
-				+ node12.x * nodeN21xN22.x
-				+ node12.y * nodeN21xN22.y
-				+ node12.z * nodeN21xN22.z;
+	// node11 is farthest from the plane defining node21 and node22
+	} else {
 
-			Real dMA = - dNumerA / dN11oN21xN22;
-			Real dMC = + dNumerC / dN11oN21xN22;
-			Real dMD = - dNumerD / dN11oN21xN22;
+		Real dNumerA =
+			+ node12.x * nodeN21xN22.x
+			+ node12.y * nodeN21xN22.y
+			+ node12.z * nodeN21xN22.z;
 
-			Real dDenom = dMA * dMA + 2.0 * dMA * dN11oN12 + 1.0;
+		Real dMA = - dNumerA / dN11oN21xN22;
+		Real dMC = + dNumerC / dN11oN21xN22;
+		Real dMD = - dNumerD / dN11oN21xN22;
 
-			dB0 = 1.0 / sqrt(dDenom);
-			dA0 = dB0 * dMA;
-			dC0 = dB0 * dMC;
-			dD0 = dB0 * dMD;
-		}
+		Real dDenom = dMA * dMA + 2.0 * dMA * dN11oN12 + 1.0;
 
-		// Check if first solution lies within interval
-		if ((dA0 > -Tolerance) &&
-			(dB0 > -Tolerance) &&
-			(dC0 > -Tolerance) &&
-			(dD0 > -Tolerance)
-		) {
-			nodeIntersections.push_back(Node(
-				(node11.x * dA0 + node12.x * dB0),
-				(node11.y * dA0 + node12.y * dB0),
-				(node11.z * dA0 + node12.z * dB0)));
+		dB0 = 1.0 / sqrt(dDenom);
+		dA0 = dB0 * dMA;
+		dC0 = dB0 * dMC;
+		dD0 = dB0 * dMD;
+	}
 
-		// Check if second solution lies within interval
-		} else if (
-			(dA0 < Tolerance) &&
-			(dB0 < Tolerance) &&
-			(dC0 < Tolerance) &&
-			(dD0 < Tolerance)
-		) {
-			nodeIntersections.push_back(Node(
-				- (node11.x * dA0 + node12.x * dB0),
-				- (node11.y * dA0 + node12.y * dB0),
-				- (node11.z * dA0 + node12.z * dB0)));
-		}
-*/
-	// First edge is a line of constant latitude; second is a great circle arc
+	// Check if first solution lies within interval
+	if ((dA0 > -Tolerance) &&
+		(dB0 > -Tolerance) &&
+		(dC0 > -Tolerance) &&
+		(dD0 > -Tolerance)
+	) {
+		nodeIntersections.push_back(Node(
+			(node11.x * dA0 + node12.x * dB0),
+			(node11.y * dA0 + node12.y * dB0),
+			(node11.z * dA0 + node12.z * dB0)));
+
+	// Check if second solution lies within interval
 	} else if (
-		(typeFirst  == Edge::Type_GreatCircleArc) &&
-		(typeSecond == Edge::Type_ConstantLatitude)
+		(dA0 < Tolerance) &&
+		(dB0 < Tolerance) &&
+		(dC0 < Tolerance) &&
+		(dD0 < Tolerance)
 	) {
-		// Check for coincident edges (edges along the equator)
-		if ((fabs(node11.z) < Tolerance) &&
-			(fabs(node12.z) < Tolerance) &&
-			(fabs(node21.z) < Tolerance)
-		) {
-			return true;
-		}
+		nodeIntersections.push_back(Node(
+			- (node11.x * dA0 + node12.x * dB0),
+			- (node11.y * dA0 + node12.y * dB0),
+			- (node11.z * dA0 + node12.z * dB0)));
+	}
+*/
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <>
+bool MeshUtilitiesFuzzy::CalculateEdgeIntersectionsKernel<
+	Edge::Type_GreatCircleArc, Edge::Type_ConstantLatitude>(
+	const Node & node11,
+	const Node & node12,
+	const Node & node21,
+	const Node & node22,
+	const Node & nodeFirstBegin,
+	std::vector<Node> & nodeIntersections,
+	bool fIncludeFirstBeginNode
+) {
+	static const Real Tolerance = ReferenceTolerance;
 
-		// Cross product of basis vectors for great circle plane
-		Real dCrossX = node11.y * node12.z - node11.z * node12.y;
-		Real dCrossY = node11.z * node12.x - node11.x * node12.z;
-		Real dCrossZ = node11.x * node12.y - node11.y * node12.x;
+	// Check for coincident edges (edges along the equator)
+	if ((fabs(node11.z) < Tolerance) &&
+		(fabs(node12.z) < Tolerance) &&
+		(fabs(node21.z) < Tolerance)
+	) {
+		return true;
+	}
+
+	// Cross product of basis vectors for great circle plane
+	Real dCrossX = node11.y * node12.z - node11.z * node12.y;
+	Real dCrossY = node11.z * node12.x - node11.x * node12.z;
+	Real dCrossZ = node11.x * node12.y - node11.y * node12.x;
 
-		// Maximum Z value reached by great circle arc along sphere
-		Real dAbsCross2 =
-			dCrossX * dCrossX + dCrossY * dCrossY + dCrossZ * dCrossZ;
+	// Maximum Z value reached by great circle arc along sphere
+	Real dAbsCross2 =
+		dCrossX * dCrossX + dCrossY * dCrossY + dCrossZ * dCrossZ;
 
-		Real dAbsEqCross2 =
-			dCrossX * dCrossX + dCrossY * dCrossY;
+	Real dAbsEqCross2 =
+		dCrossX * dCrossX + dCrossY * dCrossY;
 
-		Real dApexZ = sqrt(dAbsEqCross2 / dAbsCross2);
+	Real dApexZ = sqrt(dAbsEqCross2 / dAbsCross2);
 /*
-		// Check if apex is under this latitude (zero intersections)
-		if (fabs(node21.z) - dApexZ > Tolerance) {
-			return false;
-		}
+	// Check if apex is under this latitude (zero intersections)
+	if (fabs(node21.z) - dApexZ > Tolerance) {
+		return false;
+	}
 
-		// Find apex of great circle arc
-		//Real dApexX = - dCrossX / dCrossZ;
-		//Real dApexY = - dCrossY / dCrossZ;
+	// Find apex of great circle arc
+	//Real dApexX = - dCrossX / dCrossZ;
+	//Real dApexY = - dCrossY / dCrossZ;
 
-		Real dApexExpectedLength = sqrt(1.0 - dApexZ * dApexZ);
-		Real dApexX = - dCrossX * dApexExpectedLength / sqrt(dAbsEqCross2);
-		Real dApexY = - dCrossY * dApexExpectedLength / sqrt(dAbsEqCross2);
+	Real dApexExpectedLength = sqrt(1.0 - dApexZ * dApexZ);
+	Real dApexX = - dCrossX * dApexExpectedLength / sqrt(dAbsEqCross2);
+	Real dApexY = - dCrossY * dApexExpectedLength / sqrt(dAbsEqCross2);
 
-		Real dApexMag = dApexX * dApexX + dApexY * dApexY + dApexZ * dApexZ;
-		if (fabs(dApexMag - 1.0) > Tolerance) {
-			printf("Magnitude: %1.15e\n", dApexMag);
-			_EXCEPTIONT("Logic error");
-		}
+	Real dApexMag = dApexX * dApexX + dApexY * dApexY + dApexZ * dApexZ;
+	if (fabs(dApexMag - 1.0) > Tolerance) {
+		printf("Magnitude: %1.15e\n", dApexMag);
+		_EXCEPTIONT("Logic error");
+	}
 */
 /*
-		// Check if apex is exactly at this latitude (one intersection)
-		if ((node21.z > 0.0) && (fabs(node21.z - dApexZ) <= Tolerance)) {
-			nodeIntersections.resize(1);
-			nodeIntersections[0].x = dApexX;
-			nodeIntersections[0].y = dApexY;
-			nodeIntersections[0].z = dApexZ;
-
-		} else if ((node21.z < 0.0) && (fabs(node21.z - dApexZ) <= Tolerance) {
-			nodeIntersections.resize(1);
-			nodeIntersections[0].x = - dApexX;
-			nodeIntersections[0].y = - dApexY;
-			nodeIntersections[0].z = - dApexZ;
-		}
+	// Check if apex is exactly at this latitude (one intersection)
+	if ((node21.z > 0.0) && (fabs(node21.z - dApexZ) <= Tolerance)) {
+		nodeIntersections.resize(1);
+		nodeIntersections[0].x = dApexX;
+		nodeIntersections[0].y = dApexY;
+		nodeIntersections[0].z = dApexZ;
+
+	} else if ((node21.z < 0.0) && (fabs(node21.z - dApexZ) <= Tolerance) {
+		nodeIntersections.resize(1);
+		nodeIntersections[0].x = - dApexX;
+		nodeIntersections[0].y = - dApexY;
+		nodeIntersections[0].z = - dApexZ;
+	}
 */
-		// node12.z is larger than node11.z
-		if (fabs(node11.z) < fabs(node12.z)) {
+	// node12.z is larger than node11.z
+	if (fabs(node11.z) < fabs(node12.z)) {
 
-			// Quadratic coefficients, used to solve for A
-			Real dDTermA = (dCrossY * dCrossY + dCrossX * dCrossX)
-				/ (node12.z * node12.z);
+		// Quadratic coefficients, used to solve for A
+		Real dDTermA = (dCrossY * dCrossY + dCrossX * dCrossX)
+			/ (node12.z * node12.z);
 
-			Real dDTermB = + 2.0 * node21.z / (node12.z * node12.z) * (
-				- node12.x * dCrossY + node12.y * dCrossX);
+		Real dDTermB = + 2.0 * node21.z / (node12.z * node12.z) * (
+			- node12.x * dCrossY + node12.y * dCrossX);
 
-			Real dDTermC = node21.z * node21.z / (node12.z * node12.z) - 1.0;
+		Real dDTermC = node21.z * node21.z / (node12.z * node12.z) - 1.0;
 
-			Real dDisc = dDTermB * dDTermB - 4.0 * dDTermA * dDTermC;
+		Real dDisc = dDTermB * dDTermB - 4.0 * dDTermA * dDTermC;
 
-			Real dCross2 = node21.x * node22.y - node21.y * node22.x;
+		Real dCross2 = node21.x * node22.y - node21.y * node22.x;
 
-			// Only one solution
-			//if (fabs(dDisc) < Tolerance) {
-			if (fabs(dApexZ - fabs(node21.z)) < Tolerance) {
+		// Only one solution
+		//if (fabs(dDisc) < Tolerance) {
+		if (fabs(dApexZ - fabs(node21.z)) < Tolerance) {
 
-				// Components of intersection in node1 basis
-				Real dA = - dDTermB / (2.0 * dDTermA);
+			// Components of intersection in node1 basis
+			Real dA = - dDTermB / (2.0 * dDTermA);
 
-				Real dB = (-dA * node11.z + node21.z) / node12.z;
+			Real dB = (-dA * node11.z + node21.z) / node12.z;
 
-				// Components of intersection in (1,0)-(0,1) basis
-				Real dC = (-dA * dCrossY + node12.x * node21.z) / node12.z;
+			// Components of intersection in (1,0)-(0,1) basis
+			Real dC = (-dA * dCrossY + node12.x * node21.z) / node12.z;
 
-				Real dD = ( dA * dCrossX + node12.y * node21.z) / node12.z;
+			Real dD = ( dA * dCrossX + node12.y * node21.z) / node12.z;
 
-				// Components of intersection in node2 basis
-				Real dE = ( dC * node22.y - dD * node22.x) / dCross2;
+			// Components of intersection in node2 basis
+			Real dE = ( dC * node22.y - dD * node22.x) / dCross2;
 
-				Real dF = (-dC * node21.y + dD * node21.x) / dCross2;
+			Real dF = (-dC * node21.y + dD * node21.x) / dCross2;
 
-				if ((dA > -Tolerance) &&
-					(dB > -Tolerance) &&
-					(dE > -Tolerance) &&
-					(dF > -Tolerance)
-				) {
-					nodeIntersections.resize(1);
-					nodeIntersections[0].x = dC;
-					nodeIntersections[0].y = dD;
-					nodeIntersections[0].z = node21.z;
-				}
+			if ((dA > -Tolerance) &&
+				(dB > -Tolerance) &&
+				(dE > -Tolerance) &&
+				(dF > -Tolerance)
+			) {
+				nodeIntersections.resize(1);
+				nodeIntersections[0].x = dC;
+				nodeIntersections[0].y = dD;
+				nodeIntersections[0].z = node21.z;
+			}
 
-			// Possibly multiple solutiosn
-			} else {
-				Real dSqrtDisc =
-					sqrt(dDTermB * dDTermB - 4.0 * dDTermA * dDTermC);
+		// Possibly multiple solutiosn
+		} else {
+			Real dSqrtDisc =
+				sqrt(dDTermB * dDTermB - 4.0 * dDTermA * dDTermC);
 
-				// Components of intersection in node1 basis
-				Real dA0 = (- dDTermB + dSqrtDisc) / (2.0 * dDTermA);
-				Real dA1 = (- dDTermB - dSqrtDisc) / (2.0 * dDTermA);
+			// Components of intersection in node1 basis
+			Real dA0 = (- dDTermB + dSqrtDisc) / (2.0 * dDTermA);
+			Real dA1 = (- dDTermB - dSqrtDisc) / (2.0 * dDTermA);
 
-				Real dB0 = (-dA0 * node11.z + node21.z) / node12.z;
-				Real dB1 = (-dA1 * node11.z + node21.z) / node12.z;
+			Real dB0 = (-dA0 * node11.z + node21.z) / node12.z;
+			Real dB1 = (-dA1 * node11.z + node21.z) / node12.z;
 
-				// Components of intersection in (1,0,0)-(0,1,0) basis
-				Real dC0 = (-dA0 * dCrossY + node12.x * node21.z) / node12.z;
-				Real dC1 = (-dA1 * dCrossY + node12.x * node21.z) / node12.z;
+			// Components of intersection in (1,0,0)-(0,1,0) basis
+			Real dC0 = (-dA0 * dCrossY + node12.x * node21.z) / node12.z;
+			Real dC1 = (-dA1 * dCrossY + node12.x * node21.z) / node12.z;
 
-				Real dD0 = ( dA0 * dCrossX + node12.y * node21.z) / node12.z;
-				Real dD1 = ( dA1 * dCrossX + node12.y * node21.z) / node12.z;
+			Real dD0 = ( dA0 * dCrossX + node12.y * node21.z) / node12.z;
+			Real dD1 = ( dA1 * dCrossX + node12.y * node21.z) / node12.z;
 
-				// Components of intersection in node2 basis
-				Real dE0 = ( dC0 * node22.y - dD0 * node22.x) / dCross2;
-				Real dE1 = ( dC1 * node22.y - dD1 * node22.x) / dCross2;
+			// Components of intersection in node2 basis
+			Real dE0 = ( dC0 * node22.y - dD0 * node22.x) / dCross2;
+			Real dE1 = ( dC1 * node22.y - dD1 * node22.x) / dCross2;
 
-				Real dF0 = (-dC0 * node21.y + dD0 * node21.x) / dCross2;
-				Real dF1 = (-dC1 * node21.y + dD1 * node21.x) / dCross2;
+			Real dF0 = (-dC0 * node21.y + dD0 * node21.x) / dCross2;
+			Real dF1 = (-dC1 * node21.y + dD1 * node21.x) / dCross2;
 
-				if ((dA0 > -Tolerance) &&
-					(dB0 > -Tolerance) &&
-					(dE0 > -Tolerance) &&
-					(dF0 > -Tolerance)
-				) {
-					nodeIntersections.push_back(
-						Node(dC0, dD0, node21.z));
-				}
-				if ((dA1 > -Tolerance) &&
-					(dB1 > -Tolerance) &&
-					(dE1 > -Tolerance) &&
-					(dF1 > -Tolerance)
-				) {
-					nodeIntersections.push_back(
-						Node(dC1, dD1, node21.z));
-				}
+			if ((dA0 > -Tolerance) &&
+				(dB0 > -Tolerance) &&
+				(dE0 > -Tolerance) &&
+				(dF0 > -Tolerance)
+			) {
+				nodeIntersections.push_back(
+					Node(dC0, dD0, node21.z));
+			}
+			if ((dA1 > -Tolerance) &&
+				(dB1 > -Tolerance) &&
+				(dE1 > -Tolerance) &&
+				(dF1 > -Tolerance)
+			) {
+				nodeIntersections.push_back(
+					Node(dC1, dD1, node21.z));
 			}
+		}
 
-		// node11.z is larger than node12.z
-		} else {
+	// node11.z is larger than node12.z
+	} else {
 
-			// Quadratic coefficients, used to solve for B
-			Real dDTermA = (dCrossY * dCrossY + dCrossX * dCrossX)
-				/ (node11.z * node11.z);
+		// Quadratic coefficients, used to solve for B
+		Real dDTermA = (dCrossY * dCrossY + dCrossX * dCrossX)
+			/ (node11.z * node11.z);
 
-			Real dDTermB = - 2.0 * node21.z / (node11.z * node11.z) * (
-				- node11.x * dCrossY + node11.y * dCrossX);
+		Real dDTermB = - 2.0 * node21.z / (node11.z * node11.z) * (
+			- node11.x * dCrossY + node11.y * dCrossX);
 
-			Real dDTermC = node21.z * node21.z / (node11.z * node11.z) - 1.0;
+		Real dDTermC = node21.z * node21.z / (node11.z * node11.z) - 1.0;
 
-			Real dDisc = dDTermB * dDTermB - 4.0 * dDTermA * dDTermC;
+		Real dDisc = dDTermB * dDTermB - 4.0 * dDTermA * dDTermC;
 
-			Real dCross2 = node21.x * node22.y - node21.y * node22.x;
+		Real dCross2 = node21.x * node22.y - node21.y * node22.x;
 
-			// Only one solution
-			//if (fabs(dDisc) < Tolerance) {
-			if (fabs(dApexZ - fabs(node21.z)) < Tolerance) {
+		// Only one solution
+		//if (fabs(dDisc) < Tolerance) {
+		if (fabs(dApexZ - fabs(node21.z)) < Tolerance) {
 
-				// Components of intersection in node1 basis
-				Real dB = - dDTermB / (2.0 * dDTermA);
+			// Components of intersection in node1 basis
+			Real dB = - dDTermB / (2.0 * dDTermA);
 
-				Real dA = (-dB * node12.z + node21.z) / node11.z;
+			Real dA = (-dB * node12.z + node21.z) / node11.z;
 
-				// Components of intersection in (1,0,0)-(0,1,0) basis
-				Real dC = (dB * dCrossY + node11.x * node21.z) / node11.z;
+			// Components of intersection in (1,0,0)-(0,1,0) basis
+			Real dC = (dB * dCrossY + node11.x * node21.z) / node11.z;
 
-				Real dD = (-dB * dCrossX + node11.y * node21.z) / node11.z;
+			Real dD = (-dB * dCrossX + node11.y * node21.z) / node11.z;
 
-				// Components of intersection in node2 basis
-				Real dE = ( dC * node22.y - dD * node22.x) / dCross2;
+			// Components of intersection in node2 basis
+			Real dE = ( dC * node22.y - dD * node22.x) / dCross2;
 
-				Real dF = (-dC * node21.y + dD * node21.x) / dCross2;
+			Real dF = (-dC * node21.y + dD * node21.x) / dCross2;
 
-				if ((dA > -Tolerance) &&
-					(dB > -Tolerance) &&
-					(dE > -Tolerance) &&
-					(dF > -Tolerance)
-				) {
-					nodeIntersections.resize(1);
-					nodeIntersections[0].x = dC;
-					nodeIntersections[0].y = dD;
-					nodeIntersections[0].z = node21.z;
-				}
+			if ((dA > -Tolerance) &&
+				(dB > -Tolerance) &&
+				(dE > -Tolerance) &&
+				(dF > -Tolerance)
+			) {
+				nodeIntersections.resize(1);
+				nodeIntersections[0].x = dC;
+				nodeIntersections[0].y = dD;
+				nodeIntersections[0].z = node21.z;
+			}
 
-			// Two solutions
-			} else {
-				Real dSqrtDisc = sqrt(dDisc);
+		// Two solutions
+		} else {
+			Real dSqrtDisc = sqrt(dDisc);
 
-				// Components of intersection in node1 basis
-				Real dB0 = (- dDTermB + dSqrtDisc) / (2.0 * dDTermA);
-				Real dB1 = (- dDTermB - dSqrtDisc) / (2.0 * dDTermA);
+			// Components of intersection in node1 basis
+			Real dB0 = (- dDTermB + dSqrtDisc) / (2.0 * dDTermA);
+			Real dB1 = (- dDTermB - dSqrtDisc) / (2.0 * dDTermA);
 
-				Real dA0 = (-dB0 * node12.z + node21.z) / node11.z;
-				Real dA1 = (-dB1 * node12.z + node21.z) / node11.z;
+			Real dA0 = (-dB0 * node12.z + node21.z) / node11.z;
+			Real dA1 = (-dB1 * node12.z + node21.z) / node11.z;
 
-				// Components of intersection in (1,0,0)-(0,1,0) basis
-				Real dC0 = (dB0 * dCrossY + node11.x * node21.z) / node11.z;
-				Real dC1 = (dB1 * dCrossY + node11.x * node21.z) / node11.z;
+			// Components of intersection in (1,0,0)-(0,1,0) basis
+			Real dC0 = (dB0 * dCrossY + node11.x * node21.z) / node11.z;
+			Real dC1 = (dB1 * dCrossY + node11.x * node21.z) / node11.z;
 
-				Real dD0 = (-dB0 * dCrossX + node11.y * node21.z) / node11.z;
-				Real dD1 = (-dB1 * dCrossX + node11.y * node21.z) / node11.z;
+			Real dD0 = (-dB0 * dCrossX + node11.y * node21.z) / node11.z;
+			Real dD1 = (-dB1 * dCrossX + node11.y * node21.z) / node11.z;
 
-				// Components of intersection in node2 basis
-				Real dE0 = ( dC0 * node22.y - dD0 * node22.x) / dCross2;
-				Real dE1 = ( dC1 * node22.y - dD1 * node22.x) / dCross2;
+			// Components of intersection in node2 basis
+			Real dE0 = ( dC0 * node22.y - dD0 * node22.x) / dCross2;
+			Real dE1 = ( dC1 * node22.y - dD1 * node22.x) / dCross2;
 
-				Real dF0 = (-dC0 * node21.y + dD0 * node21.x) / dCross2;
-				Real dF1 = (-dC1 * node21.y + dD1 * node21.x) / dCross2;
+			Real dF0 = (-dC0 * node21.y + dD0 * node21.x) / dCross2;
+			Real dF1 = (-dC1 * node21.y + dD1 * node21.x) / dCross2;
 
-				if ((dA0 > -Tolerance) &&
-					(dB0 > -Tolerance) &&
-					(dE0 > -Tolerance) &&
-					(dF0 > -Tolerance)
-				) {
-					nodeIntersections.push_back(
-						Node(dC0, dD0, node21.z));
-				}
-				if ((dA1 > -Tolerance) &&
-					(dB1 > -Tolerance) &&
-					(dE1 > -Tolerance) &&
-					(dF1 > -Tolerance)
-				) {
-					nodeIntersections.push_back(
-						Node(dC1, dD1, node21.z));
-				}
+			if ((dA0 > -Tolerance) &&
+				(dB0 > -Tolerance) &&
+				(dE0 > -Tolerance) &&
+				(dF0 > -Tolerance)
+			) {
+				nodeIntersections.push_back(
+					Node(dC0, dD0, node21.z));
+			}
+			if ((dA1 > -Tolerance) &&
+				(dB1 > -Tolerance) &&
+				(dE1 > -Tolerance) &&
+				(dF1 > -Tolerance)
+			) {
+				nodeIntersections.push_back(
+					Node(dC1, dD1, node21.z));
 			}
 		}
-
-	// Both edges are lines of constant latitude
-	} else if (
-		(typeFirst  == Edge::Type_ConstantLatitude) &&
-		(typeSecond == Edge::Type_ConstantLatitude)
-	) {
-		if (fabs(node11.z - node21.z) < Tolerance) {
-			return true;
-		} else {
-			return false;
-		}
-
-	// Unknown
-	} else {
-		_EXCEPTION2("Invalid Edge::Type (%i, %i)",
-			typeFirst, typeSecond);
 	}
 
 	// If the begin node is not to be included, erase from intersections
@@ -886,6 +830,106 @@ bool MeshUtilitiesFuzzy::CalculateEdgeIntersections(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+template <>
+bool MeshUtilitiesFuzzy::CalculateEdgeIntersectionsKernel<
+	Edge::Type_ConstantLatitude, Edge::Type_ConstantLatitude>(
+	const Node & node11,
+	const Node & node12,
+	const Node & node21,
+	const Node & node22,
+	const Node & nodeFirstBegin,
+	std::vector<Node> & nodeIntersections,
+	bool fIncludeFirstBeginNode
+) {
+	static const Real Tolerance = ReferenceTolerance;
+
+	// Lines of constant latitude only intersect if they are coincident
+	if (fabs(node11.z - node21.z) < Tolerance) {
+		return true;
+	} else {
+		return false;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool MeshUtilitiesFuzzy::CalculateEdgeIntersections(
+	const Node & nodeFirstBegin,
+	const Node & nodeFirstEnd,
+	Edge::Type typeFirst,
+	const Node & nodeSecondBegin,
+	const Node & nodeSecondEnd,
+	Edge::Type typeSecond,
+	std::vector<Node> & nodeIntersections,
+	bool fIncludeFirstBeginNode
+) {
+	s_counterIntersections.Add(1);
+
+	// Make a locally modifyable version of the Nodes
+	Node node11(nodeFirstBegin);
+	Node node12(nodeFirstEnd);
+	Node node21(nodeSecondBegin);
+	Node node22(nodeSecondEnd);
+
+	// Check for coincident nodes
+	if (AreNodesEqual(node11, node12)) {
+		_EXCEPTIONT("Coincident nodes used to define edge");
+	}
+	if (AreNodesEqual(node21, node22)) {
+		_EXCEPTIONT("Coincident nodes used to define edge");
+	}
+
+	// Clear the intersection vector
+	nodeIntersections.clear();
+
+	// Both edges are great circle arcs
+	if ((typeFirst  == Edge::Type_GreatCircleArc) &&
+		(typeSecond == Edge::Type_GreatCircleArc)
+	) {
+		return CalculateEdgeIntersectionsKernel<
+			Edge::Type_GreatCircleArc, Edge::Type_GreatCircleArc>(
+				node11, node12, node21, node22, nodeFirstBegin,
+				nodeIntersections, fIncludeFirstBeginNode);
+
+	// First edge is a great circle arc; second is a line of constant latitude
+	} else if (
+		(typeFirst  == Edge::Type_GreatCircleArc) &&
+		(typeSecond == Edge::Type_ConstantLatitude)
+	) {
+		return CalculateEdgeIntersectionsKernel<
+			Edge::Type_GreatCircleArc, Edge::Type_ConstantLatitude>(
+				node11, node12, node21, node22, nodeFirstBegin,
+				nodeIntersections, fIncludeFirstBeginNode);
+
+	// First edge is a line of constant latitude; second is a great circle
+	// arc, which is calculated with the edges exchanged
+	} else if (
+		(typeFirst  == Edge::Type_ConstantLatitude) &&
+		(typeSecond == Edge::Type_GreatCircleArc)
+	) {
+		return CalculateEdgeIntersectionsKernel<
+			Edge::Type_GreatCircleArc, Edge::Type_ConstantLatitude>(
+				node21, node22, node11, node12, nodeFirstBegin,
+				nodeIntersections, fIncludeFirstBeginNode);
+
+	// Both edges are lines of constant latitude
+	} else if (
+		(typeFirst  == Edge::Type_ConstantLatitude) &&
+		(typeSecond == Edge::Type_ConstantLatitude)
+	) {
+		return CalculateEdgeIntersectionsKernel<
+			Edge::Type_ConstantLatitude, Edge::Type_ConstantLatitude>(
+				node11, node12, node21, node22, nodeFirstBegin,
+				nodeIntersections, fIncludeFirstBeginNode);
+	}
+
+	// Unknown
+	_EXCEPTION2("Invalid Edge::Type (%i, %i)",
+		typeFirst, typeSecond);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 int MeshUtilitiesFuzzy::FindFaceNearNode(
 	const Mesh & mesh,
 	int ixNode,
@@ -897,10 +941,10 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 	// Get the reference point
 	const Node & nodeBegin = mesh.nodes[ixNode];
 
-	// Get the set of faces adjacent this node
-	const std::set<int> & setNearbyFaces = mesh.revnodearray[ixNode];
+	// Get the number of faces adjacent this node
+	int nNearbyFaces = mesh.revnodearray.GetFaceCount(ixNode);
 
-	if (setNearbyFaces.size() < 3) {
+	if (nNearbyFaces < 3) {
 		_EXCEPTIONT("Insufficient Faces at Corner; at least three Faces expected");
 	}
 
@@ -919,10 +963,11 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 		- ScalarProduct(dDotNeNb, nodeBegin);
 */
 	// Loop through all faces
-	std::set<int>::const_iterator iter = setNearbyFaces.begin();
-	for (; iter != setNearbyFaces.end(); iter++) {
+	for (int ixNearby = 0; ixNearby < nNearbyFaces; ixNearby++) {
 
-		const Face & face = mesh.faces[*iter];
+		int ixFace = mesh.revnodearray.GetFace(ixNode, ixNearby);
+
+		const Face & face = mesh.faces[ixFace];
 
 		int nEdges = face.edges.size();
 
@@ -968,8 +1013,6 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 		const Node & node1 = mesh.nodes[edgePrev[1]];
 		const Node & node2 = mesh.nodes[edgeThis[1]];
 
-		printf("%i %i %i\n", edgePrev[0], edgePrev[1], edgeThis[1]);
-
 		if (!AreNodesEqual(node1, nodeBegin)) {
 			_EXCEPTIONT("Logic error");
 		}
@@ -1016,12 +1059,12 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 
 		if (dDenom > 0.0) {
 			if ((d2 > -Tolerance) && (d0 > Tolerance)) {
-				return (*iter);
+				return ixFace;
 			}
 
 		} else {
 			if ((d2 < Tolerance) && (d0 < -Tolerance)) {
-				return (*iter);
+				return ixFace;
 			}
 		}
 */
@@ -1069,7 +1112,7 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 		}
 
 #ifdef VERBOSE
-		printf("Face: %i\n", (*iter));
+		printf("Face: %i\n", ixFace);
 		printf("Type: %i %i %i\n", edgePrev.type, edgeThis.type, edgetype);
 		nodeDirA.Print("DirA");
 		nodeDirL.Print("DirL");
@@ -1115,9 +1158,9 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 				(edgePrev.type == Edge::Type_ConstantLatitude)
 			) {
 				if ((node2.z > node1.z) && (nodeBegin.z < - Tolerance)) {
-					return (*iter);
+					return ixFace;
 				} else if ((node2.z < node1.z) && (nodeBegin.z > Tolerance)) {
-					return (*iter);
+					return ixFace;
 				} else {
 					continue;
 				}
@@ -1128,9 +1171,9 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 				(edgePrev.type == Edge::Type_GreatCircleArc)
 			) {
 				if ((node2.z < node1.z) && (nodeBegin.z < - Tolerance)) {
-					return (*iter);
+					return ixFace;
 				} else if ((node2.z > node1.z) && (nodeBegin.z > Tolerance)) {
-					return (*iter);
+					return ixFace;
 				} else {
 					continue;
 				}
@@ -1142,7 +1185,7 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 
 			// Coincident edges
 			if (edgetype == edgeThis.type) {
-				return (*iter);
+				return ixFace;
 			}
 
 			// Great circle arc emerging along a line of constant latitude
@@ -1150,11 +1193,11 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 				(edgeThis.type == Edge::Type_ConstantLatitude)
 			) {
 				if ((node0.z > node1.z) && (nodeBegin.z < Tolerance)) {
-					return (*iter);
+					return ixFace;
 				} else if ((node0.z < node1.z) && (nodeBegin.z > Tolerance)) {
-					return (*iter);
+					return ixFace;
 				} else if (fabs(nodeBegin.z) <= Tolerance) {
-					return (*iter);
+					return ixFace;
 				} else {
 					continue;
 				}
@@ -1165,11 +1208,11 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 				(edgeThis.type == Edge::Type_GreatCircleArc)
 			) {
 				if ((node0.z < node1.z) && (nodeBegin.z < - Tolerance)) {
-					return (*iter);
+					return ixFace;
 				} else if ((node0.z > node1.z) && (nodeBegin.z > Tolerance)) {
-					return (*iter);
+					return ixFace;
 				} else if (fabs(nodeBegin.z) <= Tolerance) {
-					return (*iter);
+					return ixFace;
 				} else {
 					continue;
 				}
@@ -1180,7 +1223,7 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 		if ((dAngleLA < dAngleLR) &&
 			(dAngleRA < dAngleLR)
 		) {
-			return (*iter);
+			return ixFace;
 		}
 	}
 
@@ -47,6 +47,15 @@ public:
 		const Node & node1
 	);
 
+	///	<summary>
+	///		Determine if an intersection Node would be removed from the output
+	///		of CalculateEdgeIntersections when fIncludeFirstBeginNode is false.
+	///	</summary>
+	bool IsExcludedBeginNode(
+		const Node & nodeIntersection,
+		const Node & nodeFirstBegin
+	);
+
 	///	<summary>
 	///		Determine if face contains node, and whether
 	///		the Node is along an edge or at a corner.
@@ -102,6 +111,25 @@ public:
 		const Edge::Type edgetype,
 		const FindFaceStruct & aFindFaceStruct
 	);
+
+protected:
+	///	<summary>
+	///		Calculate the intersections of two edges with the given types.
+	///		Specialized for each pair of edge types, with a great circle arc
+	///		always first for mixed pairs, and dispatched by
+	///		CalculateEdgeIntersections after the edges have been validated.
+	///		nodeFirstBegin is the begin node of the original first edge.
+	///	</summary>
+	template <Edge::Type TypeFirst, Edge::Type TypeSecond>
+	bool CalculateEdgeIntersectionsKernel(
+		const Node & node11,
+		const Node & node12,
+		const Node & node21,
+		const Node & node22,
+		const Node & nodeFirstBegin,
+		std::vector<Node> & nodeIntersections,
+		bool fIncludeFirstBeginNode
+	);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -17,6 +17,9 @@
 #include "NetCDFUtilities.h"
 #include "Exception.h"
 #include "netcdfcpp.h"
+#include "netcdf.h"
+
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -108,3 +111,140 @@ void CopyNcVarAttributes(
 
 ////////////////////////////////////////////////////////////////////////////////
 
+NetCDFOutputOptions::NetCDFOutputOptions(
+	bool a_fNetCDF4,
+	int a_nDeflateLevel,
+	bool a_fShuffle
+) :
+	fNetCDF4(a_fNetCDF4),
+	nDeflateLevel(a_nDeflateLevel),
+	fShuffle(a_fShuffle)
+{
+	if ((nDeflateLevel < 0) || (nDeflateLevel > 9)) {
+		_EXCEPTION1("Deflate level must be between 0 and 9 (%i)",
+			nDeflateLevel);
+	}
+	if (!fNetCDF4 && ((nDeflateLevel != 0) || fShuffle)) {
+		_EXCEPTIONT("Compression requires NetCDF-4 output");
+	}
+#ifndef NC_NETCDF4
+	if (fNetCDF4) {
+		_EXCEPTIONT("NetCDF-4 output requires a NetCDF-4 library");
+	}
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+long GetNcChunkLength(
+	long nSize,
+	long nTarget
+) {
+	if (nSize > nTarget) {
+		return nTarget;
+	}
+	if (nSize < 1) {
+		return 1;
+	}
+	return nSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void DefineNcVarStorage(
+	NcFile * file,
+	NcVar * var,
+	const long * nChunkSizes,
+	const NetCDFOutputOptions & options
+) {
+	if (!options.fNetCDF4) {
+		return;
+	}
+
+#ifdef NC_NETCDF4
+	int nDims = var->num_dims();
+	if (nDims == 0) {
+		return;
+	}
+
+	std::vector<size_t> vecChunkSizes(nDims);
+	for (int d = 0; d < nDims; d++) {
+		vecChunkSizes[d] = static_cast<size_t>(nChunkSizes[d]);
+	}
+
+	int err = nc_def_var_chunking(
+		file->id(), var->id(), NC_CHUNKED, &(vecChunkSizes[0]));
+
+	if (err != NC_NOERR) {
+		_EXCEPTION2("Unable to chunk variable \"%s\": %s",
+			var->name(), nc_strerror(err));
+	}
+
+	if ((options.nDeflateLevel != 0) || options.fShuffle) {
+		err = nc_def_var_deflate(
+			file->id(),
+			var->id(),
+			(options.fShuffle)?(1):(0),
+			(options.nDeflateLevel != 0)?(1):(0),
+			options.nDeflateLevel);
+
+		if (err != NC_NOERR) {
+			_EXCEPTION2("Unable to compress variable \"%s\": %s",
+				var->name(), nc_strerror(err));
+		}
+	}
+#else
+	_EXCEPTIONT("NetCDF-4 output requires a NetCDF-4 library");
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool GetNcVarChunkSizes(
+	NcFile * file,
+	NcVar * var,
+	long * nChunkSizes
+) {
+#ifdef NC_NETCDF4
+	int nDims = var->num_dims();
+	if (nDims == 0) {
+		return false;
+	}
+
+	// Classic format files are never chunked
+	int nFormat;
+	int err = nc_inq_format(file->id(), &nFormat);
+	if (err != NC_NOERR) {
+		_EXCEPTION1("Unable to determine file format: %s", nc_strerror(err));
+	}
+	if ((nFormat != NC_FORMAT_NETCDF4) &&
+		(nFormat != NC_FORMAT_NETCDF4_CLASSIC)
+	) {
+		return false;
+	}
+
+	int nStorage;
+	std::vector<size_t> vecChunkSizes(nDims);
+
+	err = nc_inq_var_chunking(
+		file->id(), var->id(), &nStorage, &(vecChunkSizes[0]));
+
+	if (err != NC_NOERR) {
+		_EXCEPTION2("Unable to get chunking of variable \"%s\": %s",
+			var->name(), nc_strerror(err));
+	}
+	if (nStorage != NC_CHUNKED) {
+		return false;
+	}
+
+	for (int d = 0; d < nDims; d++) {
+		nChunkSizes[d] = static_cast<long>(vecChunkSizes[d]);
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
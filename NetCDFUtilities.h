@@ -22,6 +22,89 @@ class NcVar;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Format and storage options for NetCDF output files.  Chunking and
+///		compression are only available in NetCDF-4 (HDF5) files.
+///	</summary>
+struct NetCDFOutputOptions {
+
+	///	<summary>
+	///		Target number of values along the longest dimension of a chunk.
+	///	</summary>
+	static const long DefaultChunkLength = 65536;
+
+	///	<summary>
+	///		Constructor for classic format output.
+	///	</summary>
+	NetCDFOutputOptions() :
+		fNetCDF4(false),
+		nDeflateLevel(0),
+		fShuffle(false)
+	{ }
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	NetCDFOutputOptions(
+		bool a_fNetCDF4,
+		int a_nDeflateLevel,
+		bool a_fShuffle
+	);
+
+	///	<summary>
+	///		Write NetCDF-4 files with chunked variables.
+	///	</summary>
+	bool fNetCDF4;
+
+	///	<summary>
+	///		Deflate level of chunked variables (0 for no compression).
+	///	</summary>
+	int nDeflateLevel;
+
+	///	<summary>
+	///		Apply the shuffle filter to chunked variables.
+	///	</summary>
+	bool fShuffle;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number of values along a dimension of size nSize in a chunk which
+///		holds at most nTarget values along that dimension.
+///	</summary>
+long GetNcChunkLength(
+	long nSize,
+	long nTarget = NetCDFOutputOptions::DefaultChunkLength
+);
+
+////////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Define the chunk shape and compression of a newly added variable.
+///		This has no effect unless NetCDF-4 output is requested.
+///	</summary>
+void DefineNcVarStorage(
+	NcFile * file,
+	NcVar * var,
+	const long * nChunkSizes,
+	const NetCDFOutputOptions & options
+);
+
+////////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the chunk shape of a variable.  Returns false, and leaves
+///		nChunkSizes unchanged, if the variable is not chunked.
+///	</summary>
+bool GetNcVarChunkSizes(
+	NcFile * file,
+	NcVar * var,
+	long * nChunkSizes
+);
+
+////////////////////////////////////////////////////////////////////////////////
+
 void CopyNcFileAttributes(
 	NcFile * fileIn,
 	NcFile * fileOut
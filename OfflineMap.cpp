@@ -15,6 +15,7 @@
 ///	</remarks>
 
 #include "OfflineMap.h"
+#include "SparseMatrixDevice.h"
 
 #include "netcdfcpp.h"
 #include "NetCDFUtilities.h"
@@ -25,6 +26,254 @@
 #include "DataMatrix.h"
 
 #include <cmath>
+#include <climits>
+#include <cstring>
+#include <cstdio>
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#endif
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Bytes of map entries and data read and written, and nonzeros of
+///		maps read, written and applied to each slice of data.
+///	</summary>
+static AnnounceCounter s_counterBytesRead("bytes read");
+static AnnounceCounter s_counterBytesWritten("bytes written");
+static AnnounceCounter s_counterNonZerosRead("map nonzeros read");
+static AnnounceCounter s_counterNonZerosWritten("map nonzeros written");
+static AnnounceCounter s_counterNonZerosApplied("map nonzeros applied");
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Identifier at the start of a binary map file.
+///	</summary>
+static const char BinaryMapMagic[8] = {'T','R','M','A','P','B','I','N'};
+
+///	<summary>
+///		Version of the binary map format.
+///	</summary>
+static const int32_t BinaryMapVersion = 2;
+
+///	<summary>
+///		Value used to detect a binary map file of different byte order.
+///	</summary>
+static const int32_t BinaryMapByteOrder = 0x01020304;
+
+///	<summary>
+///		Alignment of the arrays of a binary map file, in bytes.
+///	</summary>
+static const int64_t BinaryMapAlignment = 4096;
+
+///	<summary>
+///		Maximum length of a dimension name in a binary map file.
+///	</summary>
+static const int BinaryMapDimNameLength = 60;
+
+///	<summary>
+///		Header of a binary map file.  All offsets are in bytes from the
+///		start of the file.  Weights are stored as float if nValueSize is 4
+///		and as double if nValueSize is 8.  Version 1 files, which precede
+///		nValueSize, always store weights as double.
+///	</summary>
+struct BinaryMapHeader {
+	char szMagic[8];
+	int32_t nVersion;
+	int32_t nByteOrder;
+
+	int32_t nRows;
+	int32_t nCols;
+	int32_t nNonZeros;
+
+	int32_t nSrcGridDims;
+	int32_t nDstGridDims;
+
+	int32_t nAreaA;
+	int32_t nAreaB;
+	int32_t nValueSize;
+
+	int64_t ixDims;
+	int64_t ixAreaA;
+	int64_t ixAreaB;
+	int64_t ixRowPtr;
+	int64_t ixColIx;
+	int64_t ixValues;
+	int64_t sFileSize;
+};
+
+///	<summary>
+///		Dimension record of a binary map file.
+///	</summary>
+struct BinaryMapDim {
+	int32_t nSize;
+	char szName[BinaryMapDimNameLength];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+OfflineMap::OfflineMap() :
+	m_fSinglePrecision(false),
+	m_fWidenedGridDims(false),
+	m_pMappedFile(NULL),
+	m_sMappedFileSize(0)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+
+OfflineMap::~OfflineMap() {
+	UnmapBinaryFile();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::UnmapBinaryFile() {
+	if (m_pMappedFile == NULL) {
+		return;
+	}
+
+	if (m_mapRemap.IsExternal()) {
+		m_mapRemap.Clear();
+	}
+	if (m_mapRemapSingle.IsExternal()) {
+		m_mapRemapSingle.Clear();
+	}
+
+	munmap(m_pMappedFile, m_sMappedFileSize);
+
+	m_pMappedFile = NULL;
+	m_sMappedFileSize = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::EnsureDoublePrecision() {
+	if (!m_fSinglePrecision) {
+		return;
+	}
+	if (m_mapRemap.GetNonZeros() != m_mapRemapSingle.GetNonZeros()) {
+		m_mapRemap.ConvertFrom(m_mapRemapSingle);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ConvertToSinglePrecision(
+	const DataVector<double> & vecInputAreas,
+	const DataVector<double> & vecOutputAreas,
+	double dTolerance
+) {
+	if (m_fSinglePrecision) {
+		return;
+	}
+
+	m_mapRemap.Finalize();
+
+	const int nRows = m_mapRemap.GetRows();
+	const int nCols = m_mapRemap.GetColumns();
+
+	bool fCheckConservation =
+		((vecInputAreas.GetRows() != 0) && (vecOutputAreas.GetRows() != 0));
+
+	if (fCheckConservation) {
+		if ((vecInputAreas.GetRows() < nCols) ||
+			(vecOutputAreas.GetRows() < nRows)
+		) {
+			_EXCEPTIONT("Area / map dimension mismatch");
+		}
+	}
+
+	SparseMatrix<float> smatSingle;
+	smatSingle.ConvertFrom(m_mapRemap);
+
+	// Change in row sums and area-weighted column sums due to rounding
+	const int * piRowPtr = m_mapRemap.GetRowPtr();
+	const int * piColIx = m_mapRemap.GetColIx();
+	const double * pValues = m_mapRemap.GetValues();
+	const float * pValuesSingle = smatSingle.GetValues();
+
+	DataVector<double> dColumnChange;
+	dColumnChange.Initialize(nCols);
+
+	double dMaxRowChange = 0.0;
+	int ixMaxRow = 0;
+
+	for (int i = 0; i < nRows; i++) {
+		double dRowChange = 0.0;
+		for (int j = piRowPtr[i]; j < piRowPtr[i+1]; j++) {
+			double dChange = static_cast<double>(pValuesSingle[j]) - pValues[j];
+			dRowChange += dChange;
+			if (fCheckConservation) {
+				dColumnChange[piColIx[j]] += dChange * vecOutputAreas[i];
+			}
+		}
+		if (fabs(dRowChange) > dMaxRowChange) {
+			dMaxRowChange = fabs(dRowChange);
+			ixMaxRow = i;
+		}
+	}
+
+	double dMaxColumnChange = 0.0;
+	int ixMaxColumn = 0;
+
+	if (fCheckConservation) {
+		for (int i = 0; i < nCols; i++) {
+			if (vecInputAreas[i] == 0.0) {
+				continue;
+			}
+			double dChange = fabs(dColumnChange[i] / vecInputAreas[i]);
+			if (dChange > dMaxColumnChange) {
+				dMaxColumnChange = dChange;
+				ixMaxColumn = i;
+			}
+		}
+	}
+
+	Announce("Single precision consistency error: %1.5e (row %i)",
+		dMaxRowChange, ixMaxRow);
+	if (fCheckConservation) {
+		Announce("Single precision conservation error: %1.5e (column %i)",
+			dMaxColumnChange, ixMaxColumn);
+	} else {
+		Announce("Areas not available; conservation error not checked");
+	}
+
+	if (dMaxRowChange > dTolerance) {
+		_EXCEPTION2("Single precision map changes consistency of row %i "
+			"by %1.5e", ixMaxRow, dMaxRowChange);
+	}
+	if (dMaxColumnChange > dTolerance) {
+		_EXCEPTION2("Single precision map changes conservation of column %i "
+			"by %1.5e", ixMaxColumn, dMaxColumnChange);
+	}
+
+	// Replace the double precision weights
+	UnmapBinaryFile();
+
+	m_mapRemapSingle.ConvertFrom(smatSingle);
+	m_mapRemap.Clear();
+	m_fSinglePrecision = true;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -112,6 +361,30 @@ void OfflineMap::InitializeOutputDimensionsFromFile(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void OfflineMap::InitializeInputDimensions(
+	int nCol
+) {
+	m_vecInputDimSizes.resize(1);
+	m_vecInputDimSizes[0] = nCol;
+
+	m_vecInputDimNames.resize(1);
+	m_vecInputDimNames[0] = "ncol";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::InitializeOutputDimensions(
+	int nCol
+) {
+	m_vecOutputDimSizes.resize(1);
+	m_vecOutputDimSizes[0] = nCol;
+
+	m_vecOutputDimNames.resize(1);
+	m_vecOutputDimNames[0] = "ncol";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 NcDim * NcFile_GetDimIfExists(
 	NcFile & ncInput,
 	const std::string & strDimName,
@@ -132,376 +405,2762 @@ NcDim * NcFile_GetDimIfExists(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void OfflineMap::Apply(
-	const DataVector<double> & vecAreaInput,
-	const DataVector<double> & vecAreaOutput,
-	const std::string & strInputDataFile,
-	const std::string & strOutputDataFile,
-	const std::vector<std::string> & vecVariables,
-	const std::string & strNColName,
-	bool fOutputDouble,
-	bool fAppend
-) {
-	NcFile ncInput(strInputDataFile.c_str(), NcFile::ReadOnly);
+///	<summary>
+///		Number of blocks of slices in flight in the pipelined apply.
+///	</summary>
+static const int ApplyPipelineBlocks = 3;
 
-	NcFile::FileMode eOpenMode = NcFile::Replace;
-	if (fAppend) {
-		eOpenMode = NcFile::Write;
+///	<summary>
+///		NetCDF type corresponding to float and double data.
+///	</summary>
+inline NcType ApplyNcType(const float *) {
+	return ncFloat;
+}
+
+inline NcType ApplyNcType(const double *) {
+	return ncDouble;
+}
+
+#ifdef USE_MPI
+///	<summary>
+///		MPI type corresponding to float and double data.
+///	</summary>
+inline MPI_Datatype ApplyMPIType(const float *) {
+	return MPI_FLOAT;
+}
+
+inline MPI_Datatype ApplyMPIType(const double *) {
+	return MPI_DOUBLE;
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		The rows of an offline map of precision T applied by one of several
+///		MPI ranks.  Rows are split into contiguous ranges with similar
+///		numbers of entries, and each rank reads the contiguous range of
+///		input columns referenced by its rows.  If input diagnostics are
+///		computed the input columns are also split evenly over the ranks,
+///		so that each column is owned by exactly one rank, and the range
+///		read by a rank is widened to include the columns it owns.  A rank
+///		which neither has entries nor owns columns reads a single column.
+///	</summary>
+template <typename T>
+struct ApplyPartition {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	ApplyPartition(
+		const SparseMatrix<T> & smatRemap,
+		int nCol,
+		int nRank,
+		int nSize,
+		bool fInputDiagnostics
+	) :
+		nRank(nRank),
+		nSize(nSize),
+		ixOwnBegin(0),
+		ixOwnEnd(0)
+	{
+		const int nRows = smatRemap.GetRows();
+		const int * piRowPtr = smatRemap.GetRowPtr();
+		const int * piColIx = smatRemap.GetColIx();
+		const int nNonZeros = piRowPtr[nRows];
+
+		// Balance the number of entries of each rank
+		vecRowBegin.resize(nSize + 1);
+		vecRowBegin[0] = 0;
+		for (int r = 1; r < nSize; r++) {
+			int nTarget = static_cast<int>(
+				(static_cast<long>(nNonZeros) * r) / nSize);
+			vecRowBegin[r] = static_cast<int>(
+				std::lower_bound(piRowPtr, piRowPtr + nRows, nTarget)
+					- piRowPtr);
+			if (vecRowBegin[r] < vecRowBegin[r-1]) {
+				vecRowBegin[r] = vecRowBegin[r-1];
+			}
+		}
+		vecRowBegin[nSize] = nRows;
+
+		const int iRowBegin = vecRowBegin[nRank];
+		const int iRowEnd = vecRowBegin[nRank+1];
+		const int jBegin = piRowPtr[iRowBegin];
+		const int jEnd = piRowPtr[iRowEnd];
+
+		// Range of input columns owned by this rank
+		if (fInputDiagnostics) {
+			ixOwnBegin = static_cast<int>(
+				(static_cast<long>(nCol) * nRank) / nSize);
+			ixOwnEnd = static_cast<int>(
+				(static_cast<long>(nCol) * (nRank + 1)) / nSize);
+		}
+
+		// Range of input columns referenced by the local rows and owned
+		// by this rank
+		if (jBegin != jEnd) {
+			ixColBegin = piColIx[jBegin];
+			ixColEnd = piColIx[jBegin] + 1;
+			for (int j = jBegin; j < jEnd; j++) {
+				if (piColIx[j] < ixColBegin) {
+					ixColBegin = piColIx[j];
+				}
+				if (piColIx[j] >= ixColEnd) {
+					ixColEnd = piColIx[j] + 1;
+				}
+			}
+			if (ixOwnBegin != ixOwnEnd) {
+				ixColBegin = std::min(ixColBegin, ixOwnBegin);
+				ixColEnd = std::max(ixColEnd, ixOwnEnd);
+			}
+
+		} else if (ixOwnBegin != ixOwnEnd) {
+			ixColBegin = ixOwnBegin;
+			ixColEnd = ixOwnEnd;
+
+		} else {
+			ixColBegin = 0;
+			ixColEnd = 1;
+		}
+
+		// Local rows, with columns relative to the local column range; the
+		// values are used in place
+		vecLocalRowPtr.resize(iRowEnd - iRowBegin + 1);
+		for (int i = iRowBegin; i <= iRowEnd; i++) {
+			vecLocalRowPtr[i - iRowBegin] = piRowPtr[i] - jBegin;
+		}
+
+		vecLocalColIx.resize(jEnd - jBegin);
+		for (int j = jBegin; j < jEnd; j++) {
+			vecLocalColIx[j - jBegin] = piColIx[j] - ixColBegin;
+		}
+
+		smatLocal.AttachExternal(
+			iRowEnd - iRowBegin,
+			ixColEnd - ixColBegin,
+			jEnd - jBegin,
+			&(vecLocalRowPtr[0]),
+			(jEnd == jBegin)?(NULL):(&(vecLocalColIx[0])),
+			smatRemap.GetValues() + jBegin);
+	}
+
+	///	<summary>
+	///		Rank of this processor and number of ranks.
+	///	</summary>
+	int nRank;
+	int nSize;
+
+	///	<summary>
+	///		First row of each rank, followed by the number of rows.
+	///	</summary>
+	std::vector<int> vecRowBegin;
+
+	///	<summary>
+	///		Range of input columns read by this rank.
+	///	</summary>
+	int ixColBegin;
+	int ixColEnd;
+
+	///	<summary>
+	///		Range of input columns whose diagnostics are computed by this
+	///		rank, which is empty if there are no input diagnostics.
+	///	</summary>
+	int ixOwnBegin;
+	int ixOwnEnd;
+
+	///	<summary>
+	///		CSR arrays of the local rows.
+	///	</summary>
+	std::vector<int> vecLocalRowPtr;
+	std::vector<int> vecLocalColIx;
+
+	///	<summary>
+	///		Local rows of the offline map.
+	///	</summary>
+	SparseMatrix<T> smatLocal;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		The partition and device copy of an offline map of precision T,
+///		which are constructed for the first variable to which the map is
+///		applied and reused for all other variables of a data file.
+///	</summary>
+template <typename T>
+struct ApplyContext {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	ApplyContext(
+		bool fDistributed,
+		bool fDevice
+	) :
+		fInitialized(false),
+		fDistributed(fDistributed),
+		fDevice(fDevice)
+	{ }
+
+	///	<summary>
+	///		Partition the rows of the map and upload them to the device, as
+	///		requested, if this has not been done already.  If no device is
+	///		available the map is applied on the CPU.
+	///	</summary>
+	void Initialize(
+		const SparseMatrix<T> & smatRemap,
+		int nCol,
+		bool fInputDiagnostics
+	) {
+		if (fInitialized) {
+			return;
+		}
+		fInitialized = true;
+
+#ifdef USE_MPI
+		if (fDistributed) {
+			int nRank;
+			int nSize;
+			MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+			MPI_Comm_size(MPI_COMM_WORLD, &nSize);
+
+			if (nSize > 1) {
+				pPartition.reset(
+					new ApplyPartition<T>(
+						smatRemap, nCol, nRank, nSize, fInputDiagnostics));
+			}
+		}
+#endif
+
+		if (fDevice) {
+			if (SparseMatrixDevice<T>::IsAvailable()) {
+				Announce("Uploading offline map to device");
+				pDevice.reset(new SparseMatrixDevice<T>(
+					(pPartition.get() != NULL)?
+						(pPartition->smatLocal):(smatRemap)));
+			} else {
+				Announce("WARNING: No offload device available; "
+					"applying offline map on the CPU");
+			}
+		}
 	}
-		
-	NcFile ncOutput(strOutputDataFile.c_str(), eOpenMode);
 
-	// Check for ncol dimension
-	NcDim * dimNCol = ncInput.get_dim(strNColName.c_str());
-	int nCol = dimNCol->size();
+	///	<summary>
+	///		Flag indicating Initialize has been called.
+	///	</summary>
+	bool fInitialized;
+
+	///	<summary>
+	///		Flags indicating the map should be partitioned over MPI ranks
+	///		and applied on an offload device.
+	///	</summary>
+	bool fDistributed;
+	bool fDevice;
+
+	///	<summary>
+	///		Rows of the map applied by this rank, or NULL if all rows are
+	///		applied by this rank.
+	///	</summary>
+	std::unique_ptr< ApplyPartition<T> > pPartition;
+
+	///	<summary>
+	///		Device copy of the rows of the map applied by this rank, or NULL
+	///		if the map is applied on the CPU.
+	///	</summary>
+	std::unique_ptr< SparseMatrixDevice<T> > pDevice;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Buffers for a block of horizontal slices of a variable, stored with
+///		the precision T of the offline map.
+///	</summary>
+template <typename T>
+struct ApplyBlock {
+
+	///	<summary>
+	///		Number of slices in this block.
+	///	</summary>
+	int nSlices;
+
+	///	<summary>
+	///		Length of this block along the batch dimension.
+	///	</summary>
+	int nLength;
+
+	///	<summary>
+	///		Offset of this block in the input and output variables.
+	///	</summary>
+	DataVector<long> nCounts;
+
+	///	<summary>
+	///		Slice-major input and output data.
+	///	</summary>
+	DataVector<T> dataIn;
+	DataVector<T> dataOut;
+
+	///	<summary>
+	///		Interleaved input and output data for SparseMatrix::ApplyMultiple.
+	///	</summary>
+	DataVector<T> dataInInterleaved;
+	DataVector<T> dataOutInterleaved;
+
+	///	<summary>
+	///		Conversion buffers used by Read and Write for data which is not
+	///		stored with precision T.
+	///	</summary>
+	DataVector<float> dataInFloat;
+	DataVector<double> dataInDouble;
+	DataVector<float> dataOutFloat;
+	DataVector<double> dataOutDouble;
+
+	///	<summary>
+	///		Input and output mass of each slice, and range of the input and
+	///		output data of all slices, if diagnostics are computed.
+	///	</summary>
+	DataVector<double> dInputMass;
+	DataVector<double> dOutputMass;
 
-/*
-	if (nCol != m_mapRemap.GetColumns()) {
-		_EXCEPTION2("\nMismatch between offline map size (%i) and "
-			"data.ncol (%i)", m_mapRemap.GetColumns(), nCol);
+	double dInputMin;
+	double dInputMax;
+	double dOutputMin;
+	double dOutputMax;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Diagnostics of the application of an offline map to all slices of
+///		a variable, accumulated from the masses and ranges of its blocks.
+///	</summary>
+struct ApplyStatistics {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	ApplyStatistics() :
+		nSlices(0),
+		dMaxRelativeMassError(0.0),
+		dInputMin(HUGE_VAL),
+		dInputMax(-HUGE_VAL),
+		dOutputMin(HUGE_VAL),
+		dOutputMax(-HUGE_VAL)
+	{ }
+
+	///	<summary>
+	///		Add the diagnostics of the nSlices slices of a block.
+	///	</summary>
+	template <typename T>
+	void Accumulate(
+		const ApplyBlock<T> & block,
+		bool fInput,
+		bool fOutput
+	) {
+		if (fInput) {
+			dInputMin = std::min(dInputMin, block.dInputMin);
+			dInputMax = std::max(dInputMax, block.dInputMax);
+		}
+		if (fOutput) {
+			dOutputMin = std::min(dOutputMin, block.dOutputMin);
+			dOutputMax = std::max(dOutputMax, block.dOutputMax);
+		}
+		if (fInput && fOutput) {
+			for (int k = 0; k < block.nSlices; k++) {
+				double dError =
+					fabs(block.dOutputMass[k] - block.dInputMass[k]);
+				if (block.dInputMass[k] != 0.0) {
+					dError /= fabs(block.dInputMass[k]);
+				}
+				if (dError > dMaxRelativeMassError) {
+					dMaxRelativeMassError = dError;
+				}
+			}
+		}
+		nSlices += block.nSlices;
 	}
-*/
-	// Output columns
-	int nColOut = m_mapRemap.GetRows();
 
-	// Data
-	bool fRectilinear;
-	if (m_vecOutputDimSizes.size() == 1) {
-		fRectilinear = false;
-	} else if (m_vecOutputDimSizes.size() == 2) {
-		fRectilinear = true;
-	} else {
-		_EXCEPTIONT("m_vecOutputDimSizes undefined");
+	///	<summary>
+	///		Announce the diagnostics.
+	///	</summary>
+	void Announce(
+		bool fInput,
+		bool fOutput
+	) const {
+		if (nSlices == 0) {
+			return;
+		}
+		if (fInput) {
+			::Announce(" Input Min %1.10e Max %1.10e",
+				dInputMin, dInputMax);
+		}
+		if (fOutput) {
+			::Announce("Output Min %1.10e Max %1.10e",
+				dOutputMin, dOutputMax);
+		}
+		if (fInput && fOutput) {
+			::Announce("Maximum relative change in mass %1.5e (%li slices)",
+				dMaxRelativeMassError, nSlices);
+		}
 	}
 
-	if (fRectilinear) {
-		if (nColOut != m_vecOutputDimSizes[0] * m_vecOutputDimSizes[1]) {
-			_EXCEPTIONT("Mismatch between map size and output size");
+	///	<summary>
+	///		Number of slices.
+	///	</summary>
+	long nSlices;
+
+	///	<summary>
+	///		Largest relative difference between the output and input mass
+	///		of a slice.
+	///	</summary>
+	double dMaxRelativeMassError;
+
+	///	<summary>
+	///		Range of the input and output data.
+	///	</summary>
+	double dInputMin;
+	double dInputMax;
+	double dOutputMin;
+	double dOutputMax;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Reads, remaps and writes the horizontal slices of one variable in
+///		blocks, each of which is a single hyperslab of the variable.  The
+///		dimensions before ncol are spanned completely from the innermost
+///		outwards for as long as the block fits in the batch size, and the
+///		next dimension outwards (the batch dimension) is split into ranges,
+///		so that each block is read and written with one NetCDF call.
+///		Read and Write are the only stages which call the NetCDF library,
+///		which is not thread-safe.  Data is converted to the precision T of
+///		the offline map as it is read, and from T as it is written, so that
+///		float data is remapped by a float map without passing through
+///		double buffers.  If a partition is given, only its rows are remapped
+///		from the input columns it reads, and the rows of each rank are sent
+///		in turn to the root rank, which is the only rank with an output
+///		variable and writes them without assembling the complete output.
+///		If a device copy of the map is given, blocks are remapped on the
+///		device.
+///	</summary>
+template <typename T>
+class ApplyBlockProcessor {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	ApplyBlockProcessor(
+		const SparseMatrix<T> & smatRemap,
+		const DataVector<double> & vecAreaInput,
+		const DataVector<double> & vecAreaOutput,
+		NcVar * var,
+		NcVar * varOut,
+		const DataVector<long> & vecDimSizes,
+		const DataVector<long> & nCounts,
+		const DataVector<long> & nGet,
+		const DataVector<long> & nPut,
+		const DataVector<long> & nChunkSizes,
+		int nBatch,
+		const ApplyPartition<T> * pPartition = NULL,
+		const SparseMatrixDevice<T> * pDevice = NULL
+	) :
+		m_smatRemap(
+			(pPartition != NULL)?(pPartition->smatLocal):(smatRemap)),
+		m_vecAreaInput(vecAreaInput),
+		m_vecAreaOutput(vecAreaOutput),
+		m_var(var),
+		m_varOut(varOut),
+		m_vecDimSizes(vecDimSizes),
+		m_pPartition(pPartition),
+		m_pDevice(pDevice),
+		m_nBatch(nBatch)
+	{
+		m_nCounts = nCounts;
+		m_nGet = nGet;
+		m_nPut = nPut;
+
+		m_nCol = static_cast<int>(nGet[nGet.GetRows()-1]);
+		m_nColOut = smatRemap.GetRows();
+		m_nRemapRows = m_nColOut;
+		m_nWriteCounts = nCounts;
+
+		m_ixInputStatBegin = 0;
+		m_ixInputStatEnd = m_nCol;
+
+		int ixAreaInput = 0;
+		int ixAreaOutput = 0;
+
+		// Read only the input columns referenced by the local rows and
+		// compute diagnostics of the owned columns and the local rows
+		if (pPartition != NULL) {
+			m_nCol = pPartition->ixColEnd - pPartition->ixColBegin;
+			m_nGet[m_nGet.GetRows()-1] = m_nCol;
+			m_nRemapRows = m_smatRemap.GetRows();
+			m_nReadCounts = nCounts;
+
+			m_ixInputStatBegin =
+				pPartition->ixOwnBegin - pPartition->ixColBegin;
+			m_ixInputStatEnd =
+				pPartition->ixOwnEnd - pPartition->ixColBegin;
+			if (pPartition->ixOwnBegin == pPartition->ixOwnEnd) {
+				m_ixInputStatBegin = 0;
+				m_ixInputStatEnd = 0;
+			}
+
+			ixAreaInput = pPartition->ixColBegin;
+			ixAreaOutput = pPartition->vecRowBegin[pPartition->nRank];
 		}
-	} else {
-		m_vecOutputDimSizes[0] = nColOut;
-		if (nColOut != m_vecOutputDimSizes[0]) {
-			_EXCEPTION2("Mismatch between map size and output size (%i, %i)",
-				nColOut, m_vecOutputDimSizes[0]);
+
+		// Areas of the first input column read and the first local row
+		m_pAreaInput = NULL;
+		m_pAreaOutput = NULL;
+		if (vecAreaInput.GetRows() != 0) {
+			m_pAreaInput =
+				static_cast<const double *>(vecAreaInput) + ixAreaInput;
+		}
+		if (vecAreaOutput.GetRows() != 0) {
+			m_pAreaOutput =
+				static_cast<const double *>(vecAreaOutput) + ixAreaOutput;
+		}
+
+		// Span complete inner dimensions while the block fits
+		m_nBatchDim = static_cast<int>(vecDimSizes.GetRows()) - 1;
+		m_nInnerSlices = 1;
+
+		for (; m_nBatchDim >= 0; m_nBatchDim--) {
+			long nDimSize = vecDimSizes[m_nBatchDim];
+			if (static_cast<long>(m_nInnerSlices) * nDimSize > nBatch) {
+				break;
+			}
+			m_nInnerSlices *= static_cast<int>(nDimSize);
+
+			m_nGet[m_nBatchDim] = nDimSize;
+			m_nPut[m_nBatchDim] = nDimSize;
+		}
+
+		// Split the batch dimension into ranges
+		int nBatchDimSize = 1;
+		int nOuterEntries = 1;
+		if (m_nBatchDim >= 0) {
+			nBatchDimSize = static_cast<int>(vecDimSizes[m_nBatchDim]);
+		}
+		for (int d = 0; d < m_nBatchDim; d++) {
+			nOuterEntries *= static_cast<int>(vecDimSizes[d]);
+		}
+
+		m_nBatchLength = nBatch / m_nInnerSlices;
+		if (m_nBatchLength < 1) {
+			m_nBatchLength = 1;
+		}
+		if (m_nBatchLength > nBatchDimSize) {
+			m_nBatchLength = nBatchDimSize;
+		}
+
+		// Align the ranges with the chunks of the input variable
+		if ((m_nBatchDim >= 0) && (nChunkSizes.GetRows() != 0)) {
+			int nChunkLength = static_cast<int>(nChunkSizes[m_nBatchDim]);
+			if ((nChunkLength > 1) &&
+				(m_nBatchLength > nChunkLength) &&
+				(m_nBatchLength < nBatchDimSize)
+			) {
+				m_nBatchLength -= m_nBatchLength % nChunkLength;
+			}
+		}
+
+		m_nBlocksPerEntry =
+			(nBatchDimSize + m_nBatchLength - 1) / m_nBatchLength;
+		m_nTotalBlocks = nOuterEntries * m_nBlocksPerEntry;
+
+		// Number of longitudes of rectilinear output, or zero
+		m_nLon = 0;
+		if (nPut.GetRows() == vecDimSizes.GetRows() + 2) {
+			m_nLon = static_cast<int>(nPut[nPut.GetRows()-1]);
+		}
+
+		// Buffers on the root rank for receiving the output rows of each
+		// other rank, and for the rectangles of the rows of any rank
+		if ((pPartition != NULL) && (pPartition->nRank == 0)) {
+			int nMaxRows = 0;
+			int nMaxOtherRows = 0;
+			for (int r = 0; r < pPartition->nSize; r++) {
+				int nRows =
+					pPartition->vecRowBegin[r+1] - pPartition->vecRowBegin[r];
+				nMaxRows = std::max(nMaxRows, nRows);
+				if (r != 0) {
+					nMaxOtherRows = std::max(nMaxOtherRows, nRows);
+				}
+			}
+			if (nMaxOtherRows != 0) {
+				m_dataReceived.Initialize(nMaxOtherRows * nBatch);
+			}
+			if ((m_nLon != 0) && (nMaxRows != 0)) {
+				m_dataPiece.Initialize(nMaxRows * nBatch);
+			}
 		}
 	}
 
-	DataVector<float> dataIn;
-	dataIn.Initialize(nCol);
+public:
+	///	<summary>
+	///		Allocate the buffers of a block.
+	///	</summary>
+	void InitializeBlock(
+		ApplyBlock<T> & block
+	) const {
+		block.nSlices = 0;
+		block.nLength = 0;
+		block.nCounts = m_nCounts;
+		block.dataIn.Initialize(m_nCol * m_nBatch);
+		block.dataOut.Initialize(std::max(m_nRemapRows, 1) * m_nBatch);
+		block.dataInInterleaved.Initialize(m_nCol * m_nBatch);
+		block.dataOutInterleaved.Initialize(
+			std::max(m_nRemapRows, 1) * m_nBatch);
+
+		// Conversion buffers for data not stored with precision T
+		const T * pTypeTag = NULL;
+		const bool fConvertIn = (m_var->type() != ApplyNcType(pTypeTag));
+		const bool fConvertOut =
+			(m_varOut != NULL) && (m_varOut->type() != ApplyNcType(pTypeTag));
+
+		if (fConvertIn && (m_var->type() == ncFloat)) {
+			block.dataInFloat.Initialize(m_nCol * m_nBatch);
+		} else {
+			block.dataInFloat.Deinitialize();
+		}
+		if (fConvertIn && (m_var->type() != ncFloat)) {
+			block.dataInDouble.Initialize(m_nCol * m_nBatch);
+		} else {
+			block.dataInDouble.Deinitialize();
+		}
+		if (fConvertOut && (m_varOut->type() == ncFloat)) {
+			block.dataOutFloat.Initialize(m_nColOut * m_nBatch);
+		} else {
+			block.dataOutFloat.Deinitialize();
+		}
+		if (fConvertOut && (m_varOut->type() != ncFloat)) {
+			block.dataOutDouble.Initialize(m_nColOut * m_nBatch);
+		} else {
+			block.dataOutDouble.Deinitialize();
+		}
 
-	DataMatrix<float> dataOut;
-	if (m_vecOutputDimSizes.size() == 1) {
-		dataOut.Initialize(m_vecOutputDimSizes[0], 1);
-	} else {
-		dataOut.Initialize(m_vecOutputDimSizes[0], m_vecOutputDimSizes[1]);
+		if (m_vecAreaInput.GetRows() != 0) {
+			block.dInputMass.Initialize(m_nBatch);
+		}
+		if (m_vecAreaOutput.GetRows() != 0) {
+			block.dOutputMass.Initialize(m_nBatch);
+		}
 	}
 
-	DataVector<double> dataInDouble;
-	dataInDouble.Initialize(nCol);
+	///	<summary>
+	///		Set the offset and number of slices of block iBlock.
+	///	</summary>
+	void SetBlock(
+		int iBlock,
+		ApplyBlock<T> & block
+	) const {
+		long tt = static_cast<long>(iBlock / m_nBlocksPerEntry);
+		for (int d = m_nBatchDim - 1; d >= 0; d--) {
+			block.nCounts[d] = tt % m_vecDimSizes[d];
+			tt /= m_vecDimSizes[d];
+		}
 
-	DataVector<double> dataOutDouble;
-	dataOutDouble.Initialize(nColOut);
+		block.nLength = 1;
+		if (m_nBatchDim >= 0) {
+			long k0 =
+				static_cast<long>(iBlock % m_nBlocksPerEntry) * m_nBatchLength;
+
+			block.nCounts[m_nBatchDim] = k0;
+			block.nLength =
+				static_cast<int>(m_vecDimSizes[m_nBatchDim] - k0);
+			if (block.nLength > m_nBatchLength) {
+				block.nLength = m_nBatchLength;
+			}
+		}
+
+		block.nSlices = block.nLength * m_nInnerSlices;
+	}
 
-	// Output
-	if (!fAppend) {
-		CopyNcFileAttributes(&ncInput, &ncOutput);
+	///	<summary>
+	///		Read the input data of a block.
+	///	</summary>
+	void Read(
+		ApplyBlock<T> & block
+	) {
+		if (m_nBatchDim >= 0) {
+			m_nGet[m_nBatchDim] = block.nLength;
+		}
+
+		if (m_pPartition != NULL) {
+			for (int d = 0; d < m_vecDimSizes.GetRows(); d++) {
+				m_nReadCounts[d] = block.nCounts[d];
+			}
+			m_nReadCounts[m_vecDimSizes.GetRows()] = m_pPartition->ixColBegin;
+
+			m_var->set_cur(&(m_nReadCounts[0]));
+
+		} else {
+			m_var->set_cur(&(block.nCounts[0]));
+		}
+
+		const int nValues = m_nCol * block.nSlices;
+
+		// Load data with the precision of the map
+		const T * pTypeTag = NULL;
+		if (m_var->type() == ApplyNcType(pTypeTag)) {
+			m_var->get(&(block.dataIn[0]), &(m_nGet[0]));
+			s_counterBytesRead.Add(sizeof(T) * static_cast<long long>(nValues));
+
+		// Load data as Float, cast to the precision of the map
+		} else if (m_var->type() == ncFloat) {
+			m_var->get(&(block.dataInFloat[0]), &(m_nGet[0]));
+			s_counterBytesRead.Add(
+				sizeof(float) * static_cast<long long>(nValues));
+
+			for (int i = 0; i < nValues; i++) {
+				block.dataIn[i] = static_cast<T>(block.dataInFloat[i]);
+			}
+
+		// Load data as Double, cast to the precision of the map
+		} else if (m_var->type() == ncDouble) {
+			m_var->get(&(block.dataInDouble[0]), &(m_nGet[0]));
+			s_counterBytesRead.Add(
+				sizeof(double) * static_cast<long long>(nValues));
+
+			for (int i = 0; i < nValues; i++) {
+				block.dataIn[i] = static_cast<T>(block.dataInDouble[i]);
+			}
+
+		} else {
+			_EXCEPTIONT("Invalid variable type");
+		}
 	}
 
-	NcDim * dim0;
-	NcDim * dim1;
+	///	<summary>
+	///		Apply the offline map to the input data of a block.
+	///	</summary>
+	void Remap(
+		ApplyBlock<T> & block
+	) const {
+		const int nK = block.nSlices;
+
+		const bool fInputDiagnostics = (m_pAreaInput != NULL);
+		const bool fOutputDiagnostics = (m_pAreaOutput != NULL);
+
+		const int ixStatBegin = m_ixInputStatBegin;
+		const int ixStatEnd = m_ixInputStatEnd;
+
+		block.dInputMin = HUGE_VAL;
+		block.dInputMax = -HUGE_VAL;
+		block.dOutputMin = HUGE_VAL;
+		block.dOutputMax = -HUGE_VAL;
+
+		// Apply the offline map to the data; a single slice is already in
+		// interleaved order
+		if (nK == 1) {
+			if (fInputDiagnostics) {
+				block.dInputMass[0] = SliceStatistics(
+					&(block.dataIn[ixStatBegin]),
+					ixStatEnd - ixStatBegin,
+					m_pAreaInput + ixStatBegin,
+					block.dInputMin, block.dInputMax);
+			}
 
-	dim0 = NcFile_GetDimIfExists(
-		ncOutput,
-		m_vecOutputDimNames[0].c_str(),
-		m_vecOutputDimSizes[0]);
+			ApplyMultiple(
+				&(block.dataIn[0]),
+				&(block.dataOut[0]),
+				1);
 
-	if (fRectilinear) {
-		dim1 = NcFile_GetDimIfExists(
-			ncOutput,
-			m_vecOutputDimNames[1].c_str(),
-			m_vecOutputDimSizes[1]);
-	}
-
-/*
-	// A map of other dimension variables
-	std::map<std::string, NcDim *> mapDim;
-*/
-	// Loop through all variables
-	for (int v = 0; v < vecVariables.size(); v++) {
-		NcVar * var = ncInput.get_var(vecVariables[v].c_str());
-
-		AnnounceStartBlock(vecVariables[v].c_str());
-/*
-		// Verify last dimension of variable is ncol
-		NcDim * dimLast = var->get_dim(var->num_dims()-1);
-		if (dimLast->size() < m_mapRemap.GetColumns()) {
-			if (var->num_dims() == 1) {
-				_EXCEPTIONT("Variable dimension / map size mismatch");
-			}
-
-			NcDim * dimSecondLast = var->get_dim(var->num_dims()-2);
-		}
-*/
-		/*
-		if (var->get_dim(var->num_dims()-1)->name() != strNColName) {
-			_EXCEPTION2("Last dimension of variable \"%s\" must be \"%s\"",
-				vecVariables[v].c_str(), strNColName.c_str());
-		}
-		*/
-
-		// Loop through all dimensions and add missing dimensions to output
-		int nVarTotalEntries = 1;
-
-		DataVector<NcDim *> vecDims;
-		vecDims.Initialize(var->num_dims());
-
-		DataVector<NcDim *> vecDimsOut;
-		if (fRectilinear) {
-			vecDimsOut.Initialize(var->num_dims()+1);
-			vecDimsOut[vecDimsOut.GetRows()-2] = dim0;
-			vecDimsOut[vecDimsOut.GetRows()-1] = dim1;
+			if (fOutputDiagnostics) {
+				block.dOutputMass[0] = SliceStatistics(
+					&(block.dataOut[0]), m_nRemapRows, m_pAreaOutput,
+					block.dOutputMin, block.dOutputMax);
+			}
+
+		// Diagnostics of several slices are computed as they are interleaved
+		} else {
+			for (int k = 0; k < nK; k++) {
+				const T * pIn = &(block.dataIn[k * m_nCol]);
+
+				if (fInputDiagnostics) {
+					for (int i = 0; i < ixStatBegin; i++) {
+						block.dataInInterleaved[i * nK + k] = pIn[i];
+					}
+
+					double dMass = 0.0;
+					for (int i = ixStatBegin; i < ixStatEnd; i++) {
+						const T dValue = pIn[i];
+						block.dataInInterleaved[i * nK + k] = dValue;
+
+						dMass += dValue * m_pAreaInput[i];
+						if (dValue < block.dInputMin) {
+							block.dInputMin = dValue;
+						}
+						if (dValue > block.dInputMax) {
+							block.dInputMax = dValue;
+						}
+					}
+					block.dInputMass[k] = dMass;
+
+					for (int i = ixStatEnd; i < m_nCol; i++) {
+						block.dataInInterleaved[i * nK + k] = pIn[i];
+					}
+
+				} else {
+					for (int i = 0; i < m_nCol; i++) {
+						block.dataInInterleaved[i * nK + k] = pIn[i];
+					}
+				}
+			}
+
+			ApplyMultiple(
+				&(block.dataInInterleaved[0]),
+				&(block.dataOutInterleaved[0]),
+				nK);
+
+			for (int k = 0; k < nK; k++) {
+				T * pOut = &(block.dataOut[k * m_nRemapRows]);
+
+				if (fOutputDiagnostics) {
+					double dMass = 0.0;
+					for (int i = 0; i < m_nRemapRows; i++) {
+						const T dValue = block.dataOutInterleaved[i * nK + k];
+						pOut[i] = dValue;
+
+						dMass += dValue * m_pAreaOutput[i];
+						if (dValue < block.dOutputMin) {
+							block.dOutputMin = dValue;
+						}
+						if (dValue > block.dOutputMax) {
+							block.dOutputMax = dValue;
+						}
+					}
+					block.dOutputMass[k] = dMass;
+
+				} else {
+					for (int i = 0; i < m_nRemapRows; i++) {
+						pOut[i] = block.dataOutInterleaved[i * nK + k];
+					}
+				}
+			}
+		}
+	}
+
+	///	<summary>
+	///		Mass of a slice of nValues entries with the given areas, and
+	///		update of the range of the data.
+	///	</summary>
+	static double SliceStatistics(
+		const T * pData,
+		int nValues,
+		const double * pArea,
+		double & dMin,
+		double & dMax
+	) {
+		double dMass = 0.0;
+		for (int i = 0; i < nValues; i++) {
+			dMass += pData[i] * pArea[i];
+			if (pData[i] < dMin) {
+				dMin = pData[i];
+			}
+			if (pData[i] > dMax) {
+				dMax = pData[i];
+			}
+		}
+		return dMass;
+	}
+
+	///	<summary>
+	///		Apply the offline map to nK interleaved slices, on the device if
+	///		a device copy of the map is given.
+	///	</summary>
+	void ApplyMultiple(
+		const T * pIn,
+		T * pOut,
+		int nK
+	) const {
+		if (m_pDevice != NULL) {
+			m_pDevice->ApplyMultiple(pIn, pOut, nK);
+		} else {
+			m_smatRemap.ApplyMultiple(pIn, pOut, nK);
+		}
+
+		s_counterNonZerosApplied.Add(
+			static_cast<long long>(m_smatRemap.GetNonZeros()) * nK);
+	}
+
+	///	<summary>
+	///		Get the number of blocks.
+	///	</summary>
+	int GetTotalBlocks() const {
+		return m_nTotalBlocks;
+	}
+
+	///	<summary>
+	///		Announce the number of slices per block.
+	///	</summary>
+	void AnnounceBatch() const {
+		if (m_nBatchLength * m_nInnerSlices > 1) {
+			Announce("Applying map to %i slices at a time",
+				m_nBatchLength * m_nInnerSlices);
+		}
+	}
+
+	///	<summary>
+	///		Announce the diagnostics accumulated over all blocks.
+	///	</summary>
+	void AnnounceStatistics() const {
+		m_stats.Announce(
+			(m_vecAreaInput.GetRows() != 0),
+			(m_vecAreaOutput.GetRows() != 0));
+	}
+
+	///	<summary>
+	///		Write nRows output rows of a block, starting at row iRowBegin,
+	///		from data ordered by slice and then by row.  Rows of rectilinear
+	///		output are written as rectangles of partial and complete rows of
+	///		the grid.
+	///	</summary>
+	void PutRows(
+		ApplyBlock<T> & block,
+		const T * pDataOut,
+		int iRowBegin,
+		int nRows
+	) {
+		const int nDims = m_vecDimSizes.GetRows();
+
+		if (m_nBatchDim >= 0) {
+			m_nPut[m_nBatchDim] = block.nLength;
+		}
+		for (int d = 0; d < nDims; d++) {
+			m_nWriteCounts[d] = block.nCounts[d];
+		}
+
+		if (m_nLon == 0) {
+			m_nWriteCounts[nDims] = iRowBegin;
+			m_nPut[nDims] = nRows;
+
+			PutData(block, pDataOut, nRows);
+			return;
+		}
+
+		const int iRowEnd = iRowBegin + nRows;
+		for (int i = iRowBegin; i < iRowEnd;) {
+			const int ixLon = i % m_nLon;
+
+			int nLat = 1;
+			int nLon = std::min(m_nLon - ixLon, iRowEnd - i);
+			if ((ixLon == 0) && (iRowEnd - i >= m_nLon)) {
+				nLat = (iRowEnd - i) / m_nLon;
+				nLon = m_nLon;
+			}
+			const int nPieceRows = nLat * nLon;
+
+			m_nWriteCounts[nDims] = i / m_nLon;
+			m_nWriteCounts[nDims+1] = ixLon;
+			m_nPut[nDims] = nLat;
+			m_nPut[nDims+1] = nLon;
+
+			// Copy the rows of the rectangle of each slice, unless the
+			// rectangle holds all rows
+			const T * pPiece = pDataOut;
+			if (nPieceRows != nRows) {
+				for (int k = 0; k < block.nSlices; k++) {
+					const T * pIn = pDataOut + k * nRows + (i - iRowBegin);
+					T * pOut = &(m_dataPiece[k * nPieceRows]);
+					for (int j = 0; j < nPieceRows; j++) {
+						pOut[j] = pIn[j];
+					}
+				}
+				pPiece = &(m_dataPiece[0]);
+			}
+
+			PutData(block, pPiece, nPieceRows);
+
+			i += nPieceRows;
+		}
+	}
+
+	///	<summary>
+	///		Write nRows rows of each slice of a block at the offset and with
+	///		the put sizes set by PutRows.
+	///	</summary>
+	void PutData(
+		ApplyBlock<T> & block,
+		const T * pDataOut,
+		int nRows
+	) {
+		m_varOut->set_cur(&(m_nWriteCounts[0]));
+
+		const int nValues = nRows * block.nSlices;
+
+		// Write the data with the precision of the map
+		const T * pTypeTag = NULL;
+		if (m_varOut->type() == ApplyNcType(pTypeTag)) {
+			m_varOut->put(pDataOut, &(m_nPut[0]));
+			s_counterBytesWritten.Add(
+				sizeof(T) * static_cast<long long>(nValues));
+
+		// Cast the data to float
+		} else if (m_varOut->type() == ncFloat) {
+			for (int i = 0; i < nValues; i++) {
+				block.dataOutFloat[i] = static_cast<float>(pDataOut[i]);
+			}
+			m_varOut->put(&(block.dataOutFloat[0]), &(m_nPut[0]));
+			s_counterBytesWritten.Add(
+				sizeof(float) * static_cast<long long>(nValues));
+
+		// Cast the data to double
+		} else {
+			for (int i = 0; i < nValues; i++) {
+				block.dataOutDouble[i] = static_cast<double>(pDataOut[i]);
+			}
+			m_varOut->put(&(block.dataOutDouble[0]), &(m_nPut[0]));
+			s_counterBytesWritten.Add(
+				sizeof(double) * static_cast<long long>(nValues));
+		}
+	}
+
+#ifdef USE_MPI
+	///	<summary>
+	///		Combine the diagnostics of a block computed by each rank of a
+	///		partition on the root rank.  Each input column and each output
+	///		row is owned by exactly one rank, so masses are summed.
+	///	</summary>
+	void ReduceStatistics(
+		ApplyBlock<T> & block
+	) const {
+		const bool fInputDiagnostics = (m_vecAreaInput.GetRows() != 0);
+		const bool fOutputDiagnostics = (m_vecAreaOutput.GetRows() != 0);
+
+		if (!fInputDiagnostics && !fOutputDiagnostics) {
+			return;
+		}
+
+		const int nK = block.nSlices;
+
+		std::vector<double> vecLocal(2 * nK + 4, 0.0);
+		std::vector<double> vecGlobal(2 * nK + 4, 0.0);
+
+		for (int k = 0; k < nK; k++) {
+			if (fInputDiagnostics) {
+				vecLocal[k] = block.dInputMass[k];
+			}
+			if (fOutputDiagnostics) {
+				vecLocal[nK + k] = block.dOutputMass[k];
+			}
+		}
+		MPI_Reduce(
+			&(vecLocal[0]), &(vecGlobal[0]), 2 * nK,
+			MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+		// Minima are reduced together with the negated maxima
+		vecLocal[2 * nK] = block.dInputMin;
+		vecLocal[2 * nK + 1] = block.dOutputMin;
+		vecLocal[2 * nK + 2] = -block.dInputMax;
+		vecLocal[2 * nK + 3] = -block.dOutputMax;
+
+		MPI_Reduce(
+			&(vecLocal[2 * nK]), &(vecGlobal[2 * nK]), 4,
+			MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+
+		if (m_pPartition->nRank != 0) {
+			return;
+		}
+
+		for (int k = 0; k < nK; k++) {
+			if (fInputDiagnostics) {
+				block.dInputMass[k] = vecGlobal[k];
+			}
+			if (fOutputDiagnostics) {
+				block.dOutputMass[k] = vecGlobal[nK + k];
+			}
+		}
+		block.dInputMin = vecGlobal[2 * nK];
+		block.dOutputMin = vecGlobal[2 * nK + 1];
+		block.dInputMax = -vecGlobal[2 * nK + 2];
+		block.dOutputMax = -vecGlobal[2 * nK + 3];
+	}
+#endif
+
+	///	<summary>
+	///		Write the output data of a block.  The root rank of a partition
+	///		writes its own rows and then receives and writes the rows of
+	///		each other rank in turn.
+	///	</summary>
+	void Write(
+		ApplyBlock<T> & block
+	) {
+		if (m_pPartition == NULL) {
+			PutRows(block, &(block.dataOut[0]), 0, m_nColOut);
+
+		} else {
+#ifdef USE_MPI
+			const int nSize = m_pPartition->nSize;
+			const std::vector<int> & vecRowBegin = m_pPartition->vecRowBegin;
+			const T * pTypeTag = NULL;
+
+			ReduceStatistics(block);
+
+			if (m_pPartition->nRank != 0) {
+				if (m_nRemapRows != 0) {
+					MPI_Send(
+						&(block.dataOut[0]),
+						m_nRemapRows * block.nSlices,
+						ApplyMPIType(pTypeTag),
+						0,
+						0,
+						MPI_COMM_WORLD);
+				}
+				return;
+			}
+
+			if (m_nRemapRows != 0) {
+				PutRows(block, &(block.dataOut[0]), 0, m_nRemapRows);
+			}
+
+			for (int r = 1; r < nSize; r++) {
+				const int nRows = vecRowBegin[r+1] - vecRowBegin[r];
+				if (nRows == 0) {
+					continue;
+				}
+
+				MPI_Recv(
+					&(m_dataReceived[0]),
+					nRows * block.nSlices,
+					ApplyMPIType(pTypeTag),
+					r,
+					0,
+					MPI_COMM_WORLD,
+					MPI_STATUS_IGNORE);
+
+				PutRows(block, &(m_dataReceived[0]), vecRowBegin[r], nRows);
+			}
+#else
+			_EXCEPTIONT("Distributed apply requires compilation with "
+				"MPI=True");
+#endif
+		}
+
+		// Blocks are written in order, so diagnostics are accumulated here
+		m_stats.Accumulate(
+			block,
+			(m_vecAreaInput.GetRows() != 0),
+			(m_vecAreaOutput.GetRows() != 0));
+	}
+
+	///	<summary>
+	///		Read, remap and write all blocks in sequence.
+	///	</summary>
+	void Process() {
+		ApplyBlock<T> block;
+		InitializeBlock(block);
+
+		for (int b = 0; b < m_nTotalBlocks; b++) {
+			SetBlock(b, block);
+			Read(block);
+			Remap(block);
+			Write(block);
+		}
+	}
+
+	///	<summary>
+	///		Read, remap and write block iBlock with buffers allocated by
+	///		InitializeBlock, while other threads process other blocks of
+	///		this or other processors.  Reads and writes of all processors
+	///		are serialized, since the NetCDF library is not thread-safe, so
+	///		that only remapping is performed concurrently.
+	///	</summary>
+	void ProcessBlockConcurrent(
+		int iBlock,
+		ApplyBlock<T> & block
+	) {
+		std::unique_ptr<Exception> pex;
+
+		SetBlock(iBlock, block);
+
+#pragma omp critical(NetCDF)
+		{
+			try {
+				Read(block);
+			} catch(Exception & e) {
+				pex.reset(new Exception(e));
+			}
+		}
+		if (pex.get() != NULL) {
+			throw Exception(*pex);
+		}
+
+		Remap(block);
+
+#pragma omp critical(NetCDF)
+		{
+			try {
+				Write(block);
+			} catch(Exception & e) {
+				pex.reset(new Exception(e));
+			}
+		}
+		if (pex.get() != NULL) {
+			throw Exception(*pex);
+		}
+	}
+
+#ifdef USE_PTHREADS
+	///	<summary>
+	///		Read, remap and write all blocks with a pipeline of
+	///		ApplyPipelineBlocks buffers.  The calling thread performs all
+	///		NetCDF reads and writes, so that calls to the NetCDF library are
+	///		serialized, while a second thread remaps blocks in order.
+	///	</summary>
+	void ProcessPipelined() {
+		ApplyBlock<T> blocks[ApplyPipelineBlocks];
+		for (int i = 0; i < ApplyPipelineBlocks; i++) {
+			InitializeBlock(blocks[i]);
+			m_eState[i] = ApplyBlockFree;
+		}
+
+		m_pBlocks = blocks;
+		m_fAbort = false;
+		m_pexRemap = NULL;
+
+		pthread_mutex_init(&m_mutex, NULL);
+		pthread_cond_init(&m_cond, NULL);
+
+		pthread_t threadRemap;
+		if (pthread_create(&threadRemap, NULL, RemapThread, this) != 0) {
+			pthread_cond_destroy(&m_cond);
+			pthread_mutex_destroy(&m_mutex);
+			_EXCEPTIONT("Unable to create remap thread");
+		}
+
+		try {
+			int iRead = 0;
+			int iWrite = 0;
+
+			while (iWrite < m_nTotalBlocks) {
+				const int ixWrite = iWrite % ApplyPipelineBlocks;
+
+				// Wait until the oldest block is remapped or a buffer is free
+				pthread_mutex_lock(&m_mutex);
+				while ((!m_fAbort) &&
+					(m_eState[ixWrite] != ApplyBlockRemapped) &&
+					((iRead == m_nTotalBlocks) ||
+					 (iRead - iWrite == ApplyPipelineBlocks))
+				) {
+					pthread_cond_wait(&m_cond, &m_mutex);
+				}
+				bool fAbort = m_fAbort;
+				bool fWrite = (m_eState[ixWrite] == ApplyBlockRemapped);
+				pthread_mutex_unlock(&m_mutex);
+
+				if (fAbort) {
+					break;
+				}
+
+				// Write the oldest block, freeing its buffer
+				if (fWrite) {
+					Write(blocks[ixWrite]);
+					SetState(ixWrite, ApplyBlockFree);
+					iWrite++;
+
+				// Read the next block into a free buffer
+				} else {
+					const int ixRead = iRead % ApplyPipelineBlocks;
+					SetBlock(iRead, blocks[ixRead]);
+					Read(blocks[ixRead]);
+					SetState(ixRead, ApplyBlockRead);
+					iRead++;
+				}
+			}
+
+		} catch(...) {
+			pthread_mutex_lock(&m_mutex);
+			m_fAbort = true;
+			pthread_cond_broadcast(&m_cond);
+			pthread_mutex_unlock(&m_mutex);
+
+			pthread_join(threadRemap, NULL);
+			pthread_cond_destroy(&m_cond);
+			pthread_mutex_destroy(&m_mutex);
+			delete m_pexRemap;
+			throw;
+		}
+
+		pthread_join(threadRemap, NULL);
+		pthread_cond_destroy(&m_cond);
+		pthread_mutex_destroy(&m_mutex);
+
+		// Rethrow any exception from the remap thread
+		if (m_pexRemap != NULL) {
+			Exception ex(*m_pexRemap);
+			delete m_pexRemap;
+			throw ex;
+		}
+	}
+
+protected:
+	///	<summary>
+	///		States of the buffers of the pipeline.
+	///	</summary>
+	enum ApplyBlockState {
+		ApplyBlockFree,
+		ApplyBlockRead,
+		ApplyBlockRemapped
+	};
+
+	///	<summary>
+	///		Set the state of a buffer and wake the other thread.
+	///	</summary>
+	void SetState(
+		int ix,
+		ApplyBlockState eState
+	) {
+		pthread_mutex_lock(&m_mutex);
+		m_eState[ix] = eState;
+		pthread_cond_broadcast(&m_cond);
+		pthread_mutex_unlock(&m_mutex);
+	}
+
+	///	<summary>
+	///		Entry point of the remap thread.
+	///	</summary>
+	static void * RemapThread(
+		void * pProcessor
+	) {
+		ApplyBlockProcessor * pThis =
+			reinterpret_cast<ApplyBlockProcessor *>(pProcessor);
+
+		for (int b = 0; b < pThis->m_nTotalBlocks; b++) {
+			const int ix = b % ApplyPipelineBlocks;
+
+			pthread_mutex_lock(&(pThis->m_mutex));
+			while ((!pThis->m_fAbort) &&
+				(pThis->m_eState[ix] != ApplyBlockRead)
+			) {
+				pthread_cond_wait(&(pThis->m_cond), &(pThis->m_mutex));
+			}
+			bool fAbort = pThis->m_fAbort;
+			pthread_mutex_unlock(&(pThis->m_mutex));
+
+			if (fAbort) {
+				break;
+			}
+
+			try {
+				pThis->Remap(pThis->m_pBlocks[ix]);
+
+			} catch(Exception & e) {
+				pthread_mutex_lock(&(pThis->m_mutex));
+				pThis->m_pexRemap = new Exception(e);
+				pThis->m_fAbort = true;
+				pthread_cond_broadcast(&(pThis->m_cond));
+				pthread_mutex_unlock(&(pThis->m_mutex));
+				break;
+			}
+
+			pThis->SetState(ix, ApplyBlockRemapped);
+		}
+
+		return NULL;
+	}
+#endif
+
+protected:
+	///	<summary>
+	///		Offline map.
+	///	</summary>
+	const SparseMatrix<T> & m_smatRemap;
+
+	///	<summary>
+	///		Input and output areas, used to announce mass.
+	///	</summary>
+	const DataVector<double> & m_vecAreaInput;
+	const DataVector<double> & m_vecAreaOutput;
+
+	///	<summary>
+	///		Input and output variables.
+	///	</summary>
+	NcVar * m_var;
+	NcVar * m_varOut;
+
+	///	<summary>
+	///		Sizes of the dimensions of the input variable before ncol.
+	///	</summary>
+	const DataVector<long> & m_vecDimSizes;
+
+	///	<summary>
+	///		Rows of the offline map remapped by this rank, or NULL if all
+	///		rows are remapped.
+	///	</summary>
+	const ApplyPartition<T> * m_pPartition;
+
+	///	<summary>
+	///		Device copy of the offline map, or NULL if the map is applied on
+	///		the CPU.
+	///	</summary>
+	const SparseMatrixDevice<T> * m_pDevice;
+
+	///	<summary>
+	///		Template offset and get and put sizes of a block.
+	///	</summary>
+	DataVector<long> m_nCounts;
+	DataVector<long> m_nGet;
+	DataVector<long> m_nPut;
+
+	///	<summary>
+	///		Offset of the input columns of a partition, and of the output
+	///		rows written by a put.
+	///	</summary>
+	DataVector<long> m_nReadCounts;
+	DataVector<long> m_nWriteCounts;
+
+	///	<summary>
+	///		Range of the input columns of a block whose diagnostics are
+	///		computed.
+	///	</summary>
+	int m_ixInputStatBegin;
+	int m_ixInputStatEnd;
+
+	///	<summary>
+	///		Areas of the first input column of a block and of the first
+	///		row remapped by this rank, or NULL if there are no diagnostics.
+	///	</summary>
+	const double * m_pAreaInput;
+	const double * m_pAreaOutput;
+
+	///	<summary>
+	///		Number of input and output columns, and number of rows of the
+	///		offline map remapped by this rank.
+	///	</summary>
+	int m_nCol;
+	int m_nColOut;
+	int m_nRemapRows;
+
+	///	<summary>
+	///		Number of longitudes of rectilinear output, or zero if the
+	///		output has a single horizontal dimension.
+	///	</summary>
+	int m_nLon;
+
+	///	<summary>
+	///		Dimension which is split into ranges, or -1 if each block holds
+	///		the complete variable.
+	///	</summary>
+	int m_nBatchDim;
+
+	///	<summary>
+	///		Maximum number of slices per block.
+	///	</summary>
+	int m_nBatch;
+
+	///	<summary>
+	///		Number of slices for each entry of the batch dimension.
+	///	</summary>
+	int m_nInnerSlices;
+
+	///	<summary>
+	///		Maximum length of a block along the batch dimension.
+	///	</summary>
+	int m_nBatchLength;
+
+	///	<summary>
+	///		Number of blocks for each entry of the outer dimensions, and in
+	///		total.
+	///	</summary>
+	int m_nBlocksPerEntry;
+	int m_nTotalBlocks;
+
+	///	<summary>
+	///		Output rows of another rank of a partition, received by the root
+	///		rank, ordered by slice and then by row.
+	///	</summary>
+	DataVector<T> m_dataReceived;
+
+	///	<summary>
+	///		Rows of a rectangle of rectilinear output written by the root
+	///		rank of a partition, ordered by slice and then by row.
+	///	</summary>
+	DataVector<T> m_dataPiece;
+
+	///	<summary>
+	///		Diagnostics accumulated over all blocks.
+	///	</summary>
+	ApplyStatistics m_stats;
+
+#ifdef USE_PTHREADS
+	///	<summary>
+	///		Buffers of the pipeline and their states.
+	///	</summary>
+	ApplyBlock<T> * m_pBlocks;
+	ApplyBlockState m_eState[ApplyPipelineBlocks];
+
+	///	<summary>
+	///		Flag indicating the pipeline should stop.
+	///	</summary>
+	bool m_fAbort;
+
+	///	<summary>
+	///		Exception thrown by the remap thread.
+	///	</summary>
+	Exception * m_pexRemap;
+
+	///	<summary>
+	///		Mutex and condition variable protecting the pipeline state.
+	///	</summary>
+	pthread_mutex_t m_mutex;
+	pthread_cond_t m_cond;
+#endif
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Maximum number of data files which are open at once when an offline
+///		map is applied to a list of data files.
+///	</summary>
+static const int ApplyMaxOpenFiles = 32;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A variable of a data file to which an offline map is applied, with
+///		its output variable and the offsets and sizes of its hyperslabs.
+///		The output variables of all data files which are open at once are
+///		defined before any data is written.
+///	</summary>
+struct ApplyVariable {
+
+	///	<summary>
+	///		Name of the variable.
+	///	</summary>
+	std::string strName;
+
+	///	<summary>
+	///		Index of the data file of the variable.
+	///	</summary>
+	int iFile;
+
+	///	<summary>
+	///		Input and output variables.  The output variable is only defined
+	///		on the root rank of a distributed apply.
+	///	</summary>
+	NcVar * var;
+	NcVar * varOut;
+
+	///	<summary>
+	///		Sizes of the dimensions of the input variable before ncol.
+	///	</summary>
+	DataVector<long> vecDimSizes;
+
+	///	<summary>
+	///		Template offset and get and put sizes of a slice.
+	///	</summary>
+	DataVector<long> nCounts;
+	DataVector<long> nGet;
+	DataVector<long> nPut;
+
+	///	<summary>
+	///		Chunks of the input variable, or empty if it is not chunked.
+	///	</summary>
+	DataVector<long> nChunkSizes;
+
+	///	<summary>
+	///		Number of horizontal slices.
+	///	</summary>
+	long nTotalSlices;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Maximum number of slices of a variable per block for which the
+///		buffers of nBlocks blocks fit in sMemoryBudget bytes.
+///	</summary>
+static int ApplyBatchSize(
+	const ApplyVariable & applyvar,
+	int nColOut,
+	size_t sValueBytes,
+	size_t sMemoryBudget,
+	int nBlocks
+) {
+	const int nCol =
+		static_cast<int>(applyvar.nGet[applyvar.nGet.GetRows()-1]);
+
+	size_t sSliceBytes =
+		static_cast<size_t>(nCol + nColOut)
+		* (sizeof(double) + 2 * sValueBytes);
+
+	size_t sBatchSize = sMemoryBudget / (sSliceBytes * nBlocks);
+
+	if (sBatchSize > static_cast<size_t>(applyvar.nTotalSlices)) {
+		sBatchSize = static_cast<size_t>(applyvar.nTotalSlices);
+	}
+	if (sBatchSize > static_cast<size_t>(INT_MAX / (nCol + nColOut))) {
+		sBatchSize = static_cast<size_t>(INT_MAX / (nCol + nColOut));
+	}
+
+	int nBatch = static_cast<int>(sBatchSize);
+	if (nBatch < 1) {
+		nBatch = 1;
+	}
+	return nBatch;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Announce the data files of variable v if it is the first variable
+///		of one of several data files.
+///	</summary>
+static void AnnounceApplyDataFile(
+	const std::vector<ApplyVariable> & vecApplyVariables,
+	int v,
+	const std::vector<std::string> & vecInputDataFiles,
+	const std::vector<std::string> & vecOutputDataFiles
+) {
+	const int iFile = vecApplyVariables[v].iFile;
+
+	if ((vecInputDataFiles.size() > 1) &&
+		((v == 0) || (vecApplyVariables[v-1].iFile != iFile))
+	) {
+		Announce("Data file %i of %i: %s -> %s",
+			iFile+1, static_cast<int>(vecInputDataFiles.size()),
+			vecInputDataFiles[iFile].c_str(),
+			vecOutputDataFiles[iFile].c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Read, remap and write the blocks of all variables of a group of
+///		data files with an offline map of precision T.  If several OpenMP
+///		threads are available and there are at least as many slices as
+///		threads, the blocks of all variables are handed to the threads as
+///		they become free, with the memory budget divided among the threads
+///		and blocks limited in size so that all threads are occupied.  Each
+///		thread remaps its blocks on its own, while NetCDF calls are
+///		serialized.  Otherwise the variables are processed in turn with
+///		the map applied by all threads, optionally with the pipelined
+///		processor.  The rows of the map may be partitioned over all MPI
+///		ranks, or applied on a device, as requested by the context, in
+///		which case variables are also processed in turn.  Diagnostics are
+///		announced for each variable in order.
+///	</summary>
+template <typename T>
+static void ProcessApplyVariables(
+	const SparseMatrix<T> & smatRemap,
+	const DataVector<double> & vecAreaInput,
+	const DataVector<double> & vecAreaOutput,
+	const std::vector<ApplyVariable> & vecApplyVariables,
+	const std::vector<std::string> & vecInputDataFiles,
+	const std::vector<std::string> & vecOutputDataFiles,
+	size_t sMemoryBudget,
+	bool fPipeline,
+	ApplyContext<T> & context
+) {
+	const int nVariables = static_cast<int>(vecApplyVariables.size());
+	if (nVariables == 0) {
+		return;
+	}
+
+	const DataVector<long> & nGetFirst = vecApplyVariables[0].nGet;
+	context.Initialize(
+		smatRemap,
+		static_cast<int>(nGetFirst[nGetFirst.GetRows()-1]),
+		(vecAreaInput.GetRows() != 0));
+
+	const ApplyPartition<T> * pPartition = context.pPartition.get();
+	const SparseMatrixDevice<T> * pDevice = context.pDevice.get();
+
+	const int nColOut = smatRemap.GetRows();
+
+	// Blocks are processed concurrently if all threads can be occupied
+	int nThreads = 1;
+#ifdef _OPENMP
+	nThreads = omp_get_max_threads();
+#endif
+
+	long nAllSlices = 0;
+	for (int v = 0; v < nVariables; v++) {
+		nAllSlices += vecApplyVariables[v].nTotalSlices;
+	}
+
+	const bool fConcurrent =
+		(nThreads > 1) &&
+		(!fPipeline) &&
+		(pPartition == NULL) &&
+		(pDevice == NULL) &&
+		(nAllSlices >= nThreads);
+
+	// Process each variable in turn
+	if (!fConcurrent) {
+		const int nBlocks = (fPipeline)?(ApplyPipelineBlocks):(1);
+
+		for (int v = 0; v < nVariables; v++) {
+			const ApplyVariable & applyvar = vecApplyVariables[v];
+
+			AnnounceApplyDataFile(
+				vecApplyVariables, v, vecInputDataFiles, vecOutputDataFiles);
+
+			AnnounceStartBlock(applyvar.strName.c_str());
+
+			ApplyBlockProcessor<T> processor(
+				smatRemap,
+				vecAreaInput,
+				vecAreaOutput,
+				applyvar.var,
+				applyvar.varOut,
+				applyvar.vecDimSizes,
+				applyvar.nCounts,
+				applyvar.nGet,
+				applyvar.nPut,
+				applyvar.nChunkSizes,
+				ApplyBatchSize(
+					applyvar, nColOut, sizeof(T), sMemoryBudget, nBlocks),
+				pPartition,
+				pDevice);
+
+			processor.AnnounceBatch();
+
+			if (fPipeline) {
+#ifdef USE_PTHREADS
+				processor.ProcessPipelined();
+#else
+				_EXCEPTIONT("Pipelined apply requires compilation with "
+					"PTHREADS=True");
+#endif
+			} else {
+				processor.Process();
+			}
+
+			processor.AnnounceStatistics();
+
+			AnnounceEndBlock(NULL);
+		}
+		return;
+	}
+
+	// Blocks of all variables, limited in size so that there are at least
+	// as many blocks as threads
+	const long nMaxBatch = (nAllSlices + nThreads - 1) / nThreads;
+
+	std::vector< std::unique_ptr< ApplyBlockProcessor<T> > >
+		vecProcessors(nVariables);
+
+	std::vector<int> vecFirstBlock(nVariables + 1);
+	vecFirstBlock[0] = 0;
+
+	for (int v = 0; v < nVariables; v++) {
+		const ApplyVariable & applyvar = vecApplyVariables[v];
+
+		int nBatch = ApplyBatchSize(
+			applyvar, nColOut, sizeof(T), sMemoryBudget, nThreads);
+		if (nBatch > nMaxBatch) {
+			nBatch = static_cast<int>(nMaxBatch);
+		}
+
+		vecProcessors[v].reset(new ApplyBlockProcessor<T>(
+			smatRemap,
+			vecAreaInput,
+			vecAreaOutput,
+			applyvar.var,
+			applyvar.varOut,
+			applyvar.vecDimSizes,
+			applyvar.nCounts,
+			applyvar.nGet,
+			applyvar.nPut,
+			applyvar.nChunkSizes,
+			nBatch));
+
+		vecFirstBlock[v+1] =
+			vecFirstBlock[v] + vecProcessors[v]->GetTotalBlocks();
+	}
+
+	const int nAllBlocks = vecFirstBlock[nVariables];
+
+	Announce("Applying map to %i blocks of %i variables on %i threads",
+		nAllBlocks, nVariables, nThreads);
+
+	// Blocks are handed to the threads as they become free; each thread
+	// reuses its buffers for consecutive blocks of the same variable
+	Exception * pexApply = NULL;
+	bool fAbort = false;
+
+#pragma omp parallel
+	{
+		ApplyBlock<T> block;
+		int vBlock = -1;
+
+#pragma omp for schedule(dynamic)
+		for (int b = 0; b < nAllBlocks; b++) {
+			bool fAborted;
+#pragma omp atomic read
+			fAborted = fAbort;
+
+			if (fAborted) {
+				continue;
+			}
+
+			const int v = static_cast<int>(
+				std::upper_bound(
+					vecFirstBlock.begin(), vecFirstBlock.end(), b)
+				- vecFirstBlock.begin()) - 1;
+
+			try {
+				if (v != vBlock) {
+					vecProcessors[v]->InitializeBlock(block);
+					vBlock = v;
+				}
+
+				vecProcessors[v]->ProcessBlockConcurrent(
+					b - vecFirstBlock[v], block);
+
+			} catch(Exception & e) {
+#pragma omp critical(ApplyException)
+				{
+					if (pexApply == NULL) {
+						pexApply = new Exception(e);
+					}
+				}
+#pragma omp atomic write
+				fAbort = true;
+			}
+		}
+	}
+
+	// Rethrow the first exception of any thread
+	if (pexApply != NULL) {
+		Exception ex(*pexApply);
+		delete pexApply;
+		throw ex;
+	}
+
+	for (int v = 0; v < nVariables; v++) {
+		AnnounceApplyDataFile(
+			vecApplyVariables, v, vecInputDataFiles, vecOutputDataFiles);
+
+		AnnounceStartBlock(vecApplyVariables[v].strName.c_str());
+		vecProcessors[v]->AnnounceBatch();
+		vecProcessors[v]->AnnounceStatistics();
+		AnnounceEndBlock(NULL);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::Apply(
+	const DataVector<double> & vecAreaInput,
+	const DataVector<double> & vecAreaOutput,
+	const std::string & strInputDataFile,
+	const std::string & strOutputDataFile,
+	const std::vector<std::string> & vecVariables,
+	const std::string & strNColName,
+	bool fOutputDouble,
+	bool fAppend,
+	size_t sMemoryBudget,
+	bool fPipeline,
+	const NetCDFOutputOptions & options,
+	bool fDistributed,
+	bool fDevice
+) {
+	Apply(
+		vecAreaInput,
+		vecAreaOutput,
+		std::vector<std::string>(1, strInputDataFile),
+		std::vector<std::string>(1, strOutputDataFile),
+		vecVariables,
+		strNColName,
+		fOutputDouble,
+		fAppend,
+		sMemoryBudget,
+		fPipeline,
+		options,
+		fDistributed,
+		fDevice);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::Apply(
+	const DataVector<double> & vecAreaInput,
+	const DataVector<double> & vecAreaOutput,
+	const std::vector<std::string> & vecInputDataFiles,
+	const std::vector<std::string> & vecOutputDataFiles,
+	const std::vector<std::string> & vecVariables,
+	const std::string & strNColName,
+	bool fOutputDouble,
+	bool fAppend,
+	size_t sMemoryBudget,
+	bool fPipeline,
+	const NetCDFOutputOptions & options,
+	bool fDistributed,
+	bool fDevice
+) {
+	if (vecInputDataFiles.size() != vecOutputDataFiles.size()) {
+		_EXCEPTION2("Mismatch between number of input data files (%i) "
+			"and output data files (%i)",
+			static_cast<int>(vecInputDataFiles.size()),
+			static_cast<int>(vecOutputDataFiles.size()));
+	}
+	for (int i = 0; i < vecOutputDataFiles.size(); i++) {
+		for (int j = 0; j < i; j++) {
+			if (vecOutputDataFiles[i] == vecOutputDataFiles[j]) {
+				_EXCEPTION1("Output data file \"%s\" is listed more than once",
+					vecOutputDataFiles[i].c_str());
+			}
+		}
+	}
+
+	// Rejected before any output data file is created
+#ifndef USE_PTHREADS
+	if (fPipeline) {
+		_EXCEPTIONT("Pipelined apply requires compilation with PTHREADS=True");
+	}
+#endif
+
+	// Only the root rank writes the output of a distributed apply
+	bool fWriter = true;
+#ifdef USE_MPI
+	if (fDistributed) {
+		int nRank;
+		MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+		fWriter = (nRank == 0);
+	}
+#endif
+
+	NcFile::FileMode eOpenMode = NcFile::Replace;
+	if (fAppend) {
+		eOpenMode = NcFile::Write;
+	}
+
+	// Output columns
+	int nColOut = GetRows();
+
+	// Data
+	bool fRectilinear;
+	if (m_vecOutputDimSizes.size() == 1) {
+		fRectilinear = false;
+	} else if (m_vecOutputDimSizes.size() == 2) {
+		fRectilinear = true;
+	} else {
+		_EXCEPTIONT("m_vecOutputDimSizes undefined");
+	}
+
+	if (fRectilinear) {
+		if (nColOut != m_vecOutputDimSizes[0] * m_vecOutputDimSizes[1]) {
+			_EXCEPTIONT("Mismatch between map size and output size");
+		}
+	} else {
+		m_vecOutputDimSizes[0] = nColOut;
+		if (nColOut != m_vecOutputDimSizes[0]) {
+			_EXCEPTION2("Mismatch between map size and output size (%i, %i)",
+				nColOut, m_vecOutputDimSizes[0]);
+		}
+	}
+
+	if (!m_fSinglePrecision) {
+		m_mapRemap.Finalize();
+	}
+
+	// Partition and device copy of the map, shared by all variables
+	ApplyContext<float> contextSingle(fDistributed, fDevice);
+	ApplyContext<double> contextDouble(fDistributed, fDevice);
+
+	// Data files are processed in groups of files which are open at once
+	const int nFiles = static_cast<int>(vecInputDataFiles.size());
+
+	for (int iGroup = 0; iGroup < nFiles; iGroup += ApplyMaxOpenFiles) {
+		const int iGroupEnd = std::min(nFiles, iGroup + ApplyMaxOpenFiles);
+
+		std::vector< std::unique_ptr<NcFile> > vecInputFiles;
+		std::vector< std::unique_ptr<NcFile> > vecOutputFiles;
+
+		std::vector<ApplyVariable> vecApplyVariables;
+
+		// Define all output variables of the group before any data is
+		// written, so that each output file leaves define mode only once
+		for (int f = iGroup; f < iGroupEnd; f++) {
+			vecInputFiles.emplace_back(new NcFile(
+				vecInputDataFiles[f].c_str(), NcFile::ReadOnly));
+
+			NcFile & ncInput = *(vecInputFiles.back());
+			if (!ncInput.is_valid()) {
+				_EXCEPTION1("Unable to open input data file \"%s\"",
+					vecInputDataFiles[f].c_str());
+			}
+
+			NcFile * pncOutput = NULL;
+			if (fWriter) {
+				vecOutputFiles.emplace_back(new NcFile(
+					vecOutputDataFiles[f].c_str(),
+					eOpenMode,
+					NULL,
+					0,
+					(options.fNetCDF4)?(NcFile::Netcdf4):(NcFile::Classic)));
+
+				pncOutput = vecOutputFiles.back().get();
+				if (!pncOutput->is_valid()) {
+					_EXCEPTION1("Unable to open output data file \"%s\"",
+						vecOutputDataFiles[f].c_str());
+				}
+			}
+
+			// Check for ncol dimension
+			NcDim * dimNCol = ncInput.get_dim(strNColName.c_str());
+			if (dimNCol == NULL) {
+				_EXCEPTION2("Data file \"%s\" has no dimension \"%s\"",
+					vecInputDataFiles[f].c_str(), strNColName.c_str());
+			}
+			int nCol = dimNCol->size();
+
+			// Output
+			NcDim * dim0 = NULL;
+			NcDim * dim1 = NULL;
+
+			if (fWriter) {
+				if (!fAppend) {
+					CopyNcFileAttributes(&ncInput, pncOutput);
+				}
+
+				dim0 = NcFile_GetDimIfExists(
+					*pncOutput,
+					m_vecOutputDimNames[0].c_str(),
+					m_vecOutputDimSizes[0]);
+
+				if (fRectilinear) {
+					dim1 = NcFile_GetDimIfExists(
+						*pncOutput,
+						m_vecOutputDimNames[1].c_str(),
+						m_vecOutputDimSizes[1]);
+				}
+			}
+
+			// Define all variables
+			for (int v = 0; v < vecVariables.size(); v++) {
+				NcVar * var = ncInput.get_var(vecVariables[v].c_str());
+				if (var == NULL) {
+					_EXCEPTION2("Data file \"%s\" has no variable \"%s\"",
+						vecInputDataFiles[f].c_str(),
+						vecVariables[v].c_str());
+				}
+
+				vecApplyVariables.push_back(ApplyVariable());
+
+				ApplyVariable & applyvar = vecApplyVariables.back();
+				applyvar.strName = vecVariables[v];
+				applyvar.iFile = f;
+				applyvar.var = var;
+				applyvar.varOut = NULL;
+
+				// Loop through all dimensions and add missing dimensions
+				// to output
+				DataVector<NcDim *> vecDimsOut;
+				if (fRectilinear) {
+					vecDimsOut.Initialize(var->num_dims()+1);
+					vecDimsOut[vecDimsOut.GetRows()-2] = dim0;
+					vecDimsOut[vecDimsOut.GetRows()-1] = dim1;
+				} else {
+					vecDimsOut.Initialize(var->num_dims());
+					vecDimsOut[vecDimsOut.GetRows()-1] = dim0;
+				}
+
+				DataVector<long> & vecDimSizes = applyvar.vecDimSizes;
+				vecDimSizes.Initialize(var->num_dims()-1);
+
+				applyvar.nTotalSlices = 1;
+
+				for (int d = 0; d < var->num_dims()-1; d++) {
+					NcDim * dim = var->get_dim(d);
+
+					long nDimSize = dim->size();
+					std::string strDimName = dim->name();
+
+					vecDimSizes[d] = nDimSize;
+					applyvar.nTotalSlices *= nDimSize;
+
+					if (fWriter) {
+						vecDimsOut[d] =
+							NcFile_GetDimIfExists(
+								*pncOutput,
+								strDimName.c_str(),
+								nDimSize);
+					}
+				}
+
+				// Create new output variable
+				applyvar.nCounts.Initialize(vecDimsOut.GetRows());
+
+				if (fWriter) {
+					applyvar.varOut =
+						pncOutput->add_var(
+							vecVariables[v].c_str(),
+							(fOutputDouble)?(ncDouble):(ncFloat),
+							vecDimsOut.GetRows(),
+							(const NcDim**)&(vecDimsOut[0]));
+
+					CopyNcVarAttributes(var, applyvar.varOut);
+				}
+
+				// Get size
+				DataVector<long> & nGet = applyvar.nGet;
+				nGet.Initialize(var->num_dims());
+				for (int d = 0; d < nGet.GetRows()-1; d++) {
+					nGet[d] = 1;
+				}
+				nGet[nGet.GetRows()-1] = nCol;
+
+				// Put size
+				DataVector<long> & nPut = applyvar.nPut;
+				nPut.Initialize(vecDimsOut.GetRows());
+				for (int d = 0; d < nPut.GetRows()-1; d++) {
+					nPut[d] = 1;
+				}
+				if (fRectilinear) {
+					nPut[nPut.GetRows()-2] = m_vecOutputDimSizes[0];
+					nPut[nPut.GetRows()-1] = m_vecOutputDimSizes[1];
+				} else {
+					nPut[nPut.GetRows()-1] = m_vecOutputDimSizes[0];
+				}
+
+				// One horizontal slice per chunk
+				if (fWriter) {
+					DefineNcVarStorage(
+						pncOutput, applyvar.varOut, &(nPut[0]), options);
+				}
+
+				// Chunks of the input variable, with which blocks are
+				// aligned
+				applyvar.nChunkSizes.Initialize(var->num_dims());
+
+				if (!GetNcVarChunkSizes(
+						&ncInput, var, &(applyvar.nChunkSizes[0]))
+				) {
+					applyvar.nChunkSizes.Deinitialize();
+				}
+			}
+		}
+
+		// Read, remap and write the blocks of all variables
+		if (m_fSinglePrecision) {
+			ProcessApplyVariables<float>(
+				m_mapRemapSingle,
+				vecAreaInput,
+				vecAreaOutput,
+				vecApplyVariables,
+				vecInputDataFiles,
+				vecOutputDataFiles,
+				sMemoryBudget,
+				fPipeline,
+				contextSingle);
+
+		} else {
+			ProcessApplyVariables<double>(
+				m_mapRemap,
+				vecAreaInput,
+				vecAreaOutput,
+				vecApplyVariables,
+				vecInputDataFiles,
+				vecOutputDataFiles,
+				sMemoryBudget,
+				fPipeline,
+				contextDouble);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int OfflineMap::GetSourceSize() const {
+	if (m_vecInputDimSizes.size() == 0) {
+		return GetColumns();
+	}
+
+	int nSize = 1;
+	for (int i = 0; i < m_vecInputDimSizes.size(); i++) {
+		nSize *= m_vecInputDimSizes[i];
+	}
+	return nSize;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int OfflineMap::GetTargetSize() const {
+	if (m_vecOutputDimSizes.size() == 0) {
+		return GetRows();
+	}
+
+	int nSize = 1;
+	for (int i = 0; i < m_vecOutputDimSizes.size(); i++) {
+		nSize *= m_vecOutputDimSizes[i];
+	}
+	return nSize;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Apply the weights of an offline map, stored with precision MapType,
+///		to horizontal slices of data with precision T.
+///	</summary>
+template <typename MapType, typename T>
+static void ApplyToSlices(
+	const SparseMatrix<MapType> & smatRemap,
+	int nColIn,
+	int nColOut,
+	const T * pDataIn,
+	T * pDataOut,
+	int nLevels,
+	bool fParallel
+) {
+	if ((smatRemap.GetColumns() > nColIn) || (smatRemap.GetRows() > nColOut)) {
+		_EXCEPTION4("OfflineMap dimensions (%i, %i) exceed grid sizes (%i, %i)",
+			smatRemap.GetRows(), smatRemap.GetColumns(), nColOut, nColIn);
+	}
+
+	smatRemap.ApplyStrided(
+		pDataIn, nColIn, pDataOut, nColOut, nLevels, fParallel);
+
+	s_counterNonZerosApplied.Add(
+		static_cast<long long>(smatRemap.GetNonZeros()) * nLevels);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::Apply(
+	const double * pDataIn,
+	double * pDataOut,
+	int nLevels,
+	bool fParallel
+) const {
+	if (m_fSinglePrecision) {
+		ApplyToSlices(m_mapRemapSingle, GetSourceSize(), GetTargetSize(),
+			pDataIn, pDataOut, nLevels, fParallel);
+	} else {
+		ApplyToSlices(m_mapRemap, GetSourceSize(), GetTargetSize(),
+			pDataIn, pDataOut, nLevels, fParallel);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::Apply(
+	const float * pDataIn,
+	float * pDataOut,
+	int nLevels,
+	bool fParallel
+) const {
+	if (m_fSinglePrecision) {
+		ApplyToSlices(m_mapRemapSingle, GetSourceSize(), GetTargetSize(),
+			pDataIn, pDataOut, nLevels, fParallel);
+	} else {
+		ApplyToSlices(m_mapRemap, GetSourceSize(), GetTargetSize(),
+			pDataIn, pDataOut, nLevels, fParallel);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::Read(
+	const std::string & strInput
+) {
+	if (IsBinaryFile(strInput)) {
+		ReadBinary(strInput);
+		return;
+	}
+
+	NcFile ncMap(strInput.c_str(), NcFile::ReadOnly);
+
+	// Read input dimensions entries
+	NcDim * dimSrcGridRank = ncMap.get_dim("src_grid_rank");
+	NcDim * dimDstGridRank = ncMap.get_dim("dst_grid_rank");
+
+	int nSrcGridDims = (int)(dimSrcGridRank->size());
+	int nDstGridDims = (int)(dimDstGridRank->size());
+
+	NcVar * varSrcGridDims = ncMap.get_var("src_grid_dims");
+	NcVar * varDstGridDims = ncMap.get_var("dst_grid_dims");
+
+	m_vecInputDimSizes.resize(nSrcGridDims);
+	m_vecInputDimNames.resize(nSrcGridDims);
+
+	m_vecOutputDimSizes.resize(nDstGridDims);
+	m_vecOutputDimNames.resize(nDstGridDims);
+
+	varSrcGridDims->get(&(m_vecInputDimSizes[0]), nSrcGridDims);
+	varDstGridDims->get(&(m_vecOutputDimSizes[0]), nDstGridDims);
+
+	for (int i = 0; i < nSrcGridDims; i++) {
+		char szDim[64];
+		sprintf(szDim, "name%i", i);
+		m_vecInputDimNames[i] = varSrcGridDims->get_att(szDim)->as_string(0);
+	}
+
+	for (int i = 0; i < nDstGridDims; i++) {
+		char szDim[64];
+		sprintf(szDim, "name%i", i);
+		m_vecOutputDimNames[i] = varDstGridDims->get_att(szDim)->as_string(0);
+	}
+
+	// Read SparseMatrix entries
+	NcDim * dimNS = ncMap.get_dim("n_s");
+
+	NcVar * varRow = ncMap.get_var("row");
+	NcVar * varCol = ncMap.get_var("col");
+	NcVar * varS   = ncMap.get_var("S");
+
+	int nS = dimNS->size();
+
+	DataVector<int> vecRow;
+	vecRow.Initialize(nS);
+
+	DataVector<int> vecCol;
+	vecCol.Initialize(nS);
+
+	varRow->set_cur((long)0);
+	varRow->get(&(vecRow[0]), nS);
+
+	varCol->set_cur((long)0);
+	varCol->get(&(vecCol[0]), nS);
+
+	s_counterBytesRead.Add(2 * sizeof(int) * static_cast<long long>(nS));
+	s_counterNonZerosRead.Add(nS);
+
+	// Weights stored as float are kept in single precision
+	if (varS->type() == ncFloat) {
+		DataVector<float> vecS;
+		vecS.Initialize(nS);
+
+		varS->set_cur((long)0);
+		varS->get(&(vecS[0]), nS);
+
+		s_counterBytesRead.Add(sizeof(float) * static_cast<long long>(nS));
+
+		m_mapRemapSingle.SetEntries(vecRow, vecCol, vecS);
+		m_mapRemap.Clear();
+		m_fSinglePrecision = true;
+
+	} else {
+		DataVector<double> vecS;
+		vecS.Initialize(nS);
+
+		varS->set_cur((long)0);
+		varS->get(&(vecS[0]), nS);
+
+		s_counterBytesRead.Add(sizeof(double) * static_cast<long long>(nS));
+
+		m_mapRemap.SetEntries(vecRow, vecCol, vecS);
+		m_mapRemapSingle.Clear();
+		m_fSinglePrecision = false;
+	}
+
+	// Read areas, if present
+	m_dSourceAreas.Deinitialize();
+	m_dTargetAreas.Deinitialize();
+
+	for (int v = 0; v < ncMap.num_vars(); v++) {
+		NcVar * var = ncMap.get_var(v);
+
+		DataVector<double> * pAreas = NULL;
+		if (strcmp(var->name(), "area_a") == 0) {
+			pAreas = &m_dSourceAreas;
+		} else if (strcmp(var->name(), "area_b") == 0) {
+			pAreas = &m_dTargetAreas;
+		} else {
+			continue;
+		}
+
+		int nAreas = var->get_dim(0)->size();
+		pAreas->Initialize(nAreas);
+		var->set_cur((long)0);
+		var->get(&((*pAreas)[0]), nAreas);
+	}
+
+	UnmapBinaryFile();
+
+	WidenGridDimensions(strInput);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::WidenGridDimensions(
+	const std::string & strInput
+) {
+	m_fWidenedGridDims = false;
+
+	if (GetSourceSize() < GetColumns()) {
+		if (m_vecInputDimSizes.size() > 1) {
+			_EXCEPTION3("Map \"%s\" has src_grid_dims of size %i but refers "
+				"to %i columns",
+				strInput.c_str(), GetSourceSize(), GetColumns());
+		}
+		Announce("WARNING: Map \"%s\" has src_grid_dims of size %i; "
+			"using the %i columns of the map",
+			strInput.c_str(), GetSourceSize(), GetColumns());
+		if (m_vecInputDimSizes.size() == 1) {
+			m_vecInputDimSizes[0] = GetColumns();
 		} else {
-			vecDimsOut.Initialize(var->num_dims());
-			vecDimsOut[vecDimsOut.GetRows()-1] = dim0;
+			InitializeInputDimensions(GetColumns());
 		}
+		m_fWidenedGridDims = true;
+	}
+	if (GetTargetSize() < GetRows()) {
+		if (m_vecOutputDimSizes.size() > 1) {
+			_EXCEPTION3("Map \"%s\" has dst_grid_dims of size %i but refers "
+				"to %i rows",
+				strInput.c_str(), GetTargetSize(), GetRows());
+		}
+		Announce("WARNING: Map \"%s\" has dst_grid_dims of size %i; "
+			"using the %i rows of the map",
+			strInput.c_str(), GetTargetSize(), GetRows());
+		if (m_vecOutputDimSizes.size() == 1) {
+			m_vecOutputDimSizes[0] = GetRows();
+		} else {
+			InitializeOutputDimensions(GetRows());
+		}
+		m_fWidenedGridDims = true;
+	}
+}
 
-		DataVector<long> vecDimSizes;
-		vecDimSizes.Initialize(var->num_dims()-1);
+///////////////////////////////////////////////////////////////////////////////
 
-		for (int d = 0; d < var->num_dims()-1; d++) {
-			vecDims[d] = var->get_dim(d);
+bool OfflineMap::IsBinaryFile(
+	const std::string & strInput
+) {
+	FILE * fp = fopen(strInput.c_str(), "rb");
+	if (fp == NULL) {
+		return false;
+	}
 
-			long nDimSize = vecDims[d]->size();
-			std::string strDimName = vecDims[d]->name();
+	char szMagic[8];
+	size_t sRead = fread(szMagic, 1, sizeof(szMagic), fp);
+	fclose(fp);
 
-			vecDimSizes[d] = nDimSize;
-			nVarTotalEntries *= nDimSize;
+	return ((sRead == sizeof(szMagic)) &&
+		(memcmp(szMagic, BinaryMapMagic, sizeof(szMagic)) == 0));
+}
 
-			vecDimsOut[d] =
-				NcFile_GetDimIfExists(
-					ncOutput,
-					strDimName.c_str(),
-					nDimSize);
-/*
-			std::map<std::string, NcDim *>::const_iterator iter =
-				mapDim.find(strDimName);
+///////////////////////////////////////////////////////////////////////////////
 
-			if (iter == mapDim.end()) {
-				NcDim * dimNew = ncOutput.add_dim(strDimName.c_str(), nDimSize);
+void OfflineMap::ReadBinary(
+	const std::string & strInput
+) {
+	UnmapBinaryFile();
 
-				vecDimsOut[d] = dimNew;
+	int fd = open(strInput.c_str(), O_RDONLY);
+	if (fd < 0) {
+		_EXCEPTION1("Unable to open binary map file \"%s\"",
+			strInput.c_str());
+	}
 
-				mapDim.insert(
-					std::pair<std::string, NcDim *>(strDimName, dimNew));
+	struct stat statFile;
+	if (fstat(fd, &statFile) != 0) {
+		close(fd);
+		_EXCEPTION1("Unable to stat binary map file \"%s\"",
+			strInput.c_str());
+	}
 
-			} else {
-				vecDimsOut[d] = iter->second;
-			}
-*/
-		}
+	size_t sFileSize = static_cast<size_t>(statFile.st_size);
+	if (sFileSize < sizeof(BinaryMapHeader)) {
+		close(fd);
+		_EXCEPTION1("Binary map file \"%s\" is truncated", strInput.c_str());
+	}
 
-		// Create new output variable
-		DataVector<long> nCounts;
-		nCounts.Initialize(vecDimsOut.GetRows());
+	// The mapping is shared, so concurrent jobs use the same pages
+	void * pMapped = mmap(NULL, sFileSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
 
-		NcVar * varOut;
-		if (fOutputDouble) {
-			varOut =
-				ncOutput.add_var(
-					vecVariables[v].c_str(),
-					ncDouble,
-					vecDimsOut.GetRows(),
-					(const NcDim**)&(vecDimsOut[0]));
+	if (pMapped == MAP_FAILED) {
+		_EXCEPTION1("Unable to memory map binary map file \"%s\"",
+			strInput.c_str());
+	}
 
-		} else {
-			varOut =
-				ncOutput.add_var(
-					vecVariables[v].c_str(),
-					ncFloat,
-					vecDimsOut.GetRows(),
-					(const NcDim**)&(vecDimsOut[0]));
-		}
+	m_pMappedFile = pMapped;
+	m_sMappedFileSize = sFileSize;
 
-		CopyNcVarAttributes(var, varOut);
+	s_counterBytesRead.Add(static_cast<long long>(sFileSize));
 
-		// Get size
-		DataVector<long> nGet;
-		nGet.Initialize(vecDims.GetRows());
-		for (int d = 0; d < nGet.GetRows()-1; d++) {
-			nGet[d] = 1;
-		}
-		nGet[nGet.GetRows()-1] = nCol;
+	const char * pData = reinterpret_cast<const char *>(pMapped);
 
-		// Put size
-		DataVector<long> nPut;
-		nPut.Initialize(nCounts.GetRows());
-		for (int d = 0; d < nPut.GetRows()-1; d++) {
-			nPut[d] = 1;
-		}
-		if (fRectilinear) {
-			nPut[nPut.GetRows()-2] = m_vecOutputDimSizes[0];
-			nPut[nPut.GetRows()-1] = m_vecOutputDimSizes[1];
-		} else {
-			nPut[nPut.GetRows()-1] = m_vecOutputDimSizes[0];
-		}
+	const BinaryMapHeader & header =
+		*reinterpret_cast<const BinaryMapHeader *>(pData);
 
-		// Loop through all entries
-		for (int t = 0; t < nVarTotalEntries; t++) {
+	// Verify the header
+	if (memcmp(header.szMagic, BinaryMapMagic, sizeof(BinaryMapMagic)) != 0) {
+		UnmapBinaryFile();
+		_EXCEPTION1("\"%s\" is not a binary map file", strInput.c_str());
+	}
+	if (header.nByteOrder != BinaryMapByteOrder) {
+		UnmapBinaryFile();
+		_EXCEPTION1("Binary map file \"%s\" has incompatible byte order",
+			strInput.c_str());
+	}
+	if ((header.nVersion != 1) && (header.nVersion != BinaryMapVersion)) {
+		UnmapBinaryFile();
+		_EXCEPTION2("Binary map file \"%s\" has unsupported version %i",
+			strInput.c_str(), header.nVersion);
+	}
 
-			long tt = static_cast<long>(t);
-			for (int d = 0; d < vecDimSizes.GetRows(); d++) {
-				nCounts[d] = tt % vecDimSizes[d];
-				tt -= nCounts[d] * vecDimSizes[d];
-			}
+	const int64_t nValueSize =
+		(header.nVersion == 1)?(sizeof(double)):(header.nValueSize);
 
-			// Get the data
-			var->set_cur(&(nCounts[0]));
+	if ((nValueSize != sizeof(float)) && (nValueSize != sizeof(double))) {
+		UnmapBinaryFile();
+		_EXCEPTION2("Binary map file \"%s\" has invalid value size %i",
+			strInput.c_str(), static_cast<int>(nValueSize));
+	}
+	if ((header.sFileSize != static_cast<int64_t>(sFileSize)) ||
+		(header.ixDims + static_cast<int64_t>(sizeof(BinaryMapDim))
+			* (header.nSrcGridDims + header.nDstGridDims) > header.sFileSize) ||
+		(header.ixAreaA + static_cast<int64_t>(sizeof(double))
+			* header.nAreaA > header.sFileSize) ||
+		(header.ixAreaB + static_cast<int64_t>(sizeof(double))
+			* header.nAreaB > header.sFileSize) ||
+		(header.ixRowPtr + static_cast<int64_t>(sizeof(int32_t))
+			* (header.nRows + 1) > header.sFileSize) ||
+		(header.ixColIx + static_cast<int64_t>(sizeof(int32_t))
+			* header.nNonZeros > header.sFileSize) ||
+		(header.ixValues + nValueSize * header.nNonZeros > header.sFileSize)
+	) {
+		UnmapBinaryFile();
+		_EXCEPTION1("Binary map file \"%s\" is truncated", strInput.c_str());
+	}
 
-			// Load data as Float, cast to Double
-			if (var->type() == ncFloat) {
-				var->get(&(dataIn[0]), &(nGet[0]));
+	// Read dimensions
+	const BinaryMapDim * pDims =
+		reinterpret_cast<const BinaryMapDim *>(pData + header.ixDims);
 
-				for (int i = 0; i < nCol; i++) {
-					dataInDouble[i] = static_cast<double>(dataIn[i]);
-				}
+	m_vecInputDimSizes.resize(header.nSrcGridDims);
+	m_vecInputDimNames.resize(header.nSrcGridDims);
 
-			// Load data as Double
-			} else if (var->type() == ncDouble) {
-				var->get(&(dataInDouble[0]), &(nGet[0]));
+	for (int i = 0; i < header.nSrcGridDims; i++) {
+		const BinaryMapDim & dim = pDims[i];
+		m_vecInputDimSizes[i] = dim.nSize;
+		m_vecInputDimNames[i] =
+			std::string(dim.szName, strnlen(dim.szName, BinaryMapDimNameLength));
+	}
 
-			} else {
-				_EXCEPTIONT("Invalid variable type");
-			}
-
-			// Announce input mass
-			if (vecAreaInput.GetRows() != 0) {
-				double dInputMass = 0.0;
-				double dInputMin  = dataInDouble[0];
-				double dInputMax  = dataInDouble[0];
-				for (int i = 0; i < nCol; i++) {
-					dInputMass += dataInDouble[i] * vecAreaInput[i];
-					if (dataInDouble[i] < dInputMin) {
-						dInputMin = dataInDouble[i];
-					}
-					if (dataInDouble[i] > dInputMax) {
-						dInputMax = dataInDouble[i];
-					}
-				}
-				Announce(" Input Mass: %1.15e Min %1.10e Max %1.10e",
-					dInputMass, dInputMin, dInputMax);
-			}
+	m_vecOutputDimSizes.resize(header.nDstGridDims);
+	m_vecOutputDimNames.resize(header.nDstGridDims);
 
-			// Apply the offline map to the data
-			m_mapRemap.Apply(dataInDouble, dataOutDouble);
+	for (int i = 0; i < header.nDstGridDims; i++) {
+		const BinaryMapDim & dim = pDims[header.nSrcGridDims + i];
+		m_vecOutputDimSizes[i] = dim.nSize;
+		m_vecOutputDimNames[i] =
+			std::string(dim.szName, strnlen(dim.szName, BinaryMapDimNameLength));
+	}
 
-			// Announce output mass
-			if (vecAreaOutput.GetRows() != 0) {
-				double dOutputMass = 0.0;
-				double dOutputMin  = dataOutDouble[0];
-				double dOutputMax  = dataOutDouble[0];
-				for (int i = 0; i < nColOut; i++) {
-					dOutputMass += dataOutDouble[i] * vecAreaOutput[i];
-					if (dataOutDouble[i] < dOutputMin) {
-						dOutputMin = dataOutDouble[i];
-					}
-					if (dataOutDouble[i] > dOutputMax) {
-						dOutputMax = dataOutDouble[i];
-					}
-				}
-				Announce("Output Mass: %1.15e Min %1.10e Max %1.10e",
-					dOutputMass, dOutputMin, dOutputMax);
-			}
+	// Copy areas
+	m_dSourceAreas.Deinitialize();
+	m_dTargetAreas.Deinitialize();
 
-			// Write the data
-			if (fOutputDouble) {
-				varOut->set_cur(&(nCounts[0]));
-				varOut->put(&(dataOutDouble[0]), &(nPut[0]));
+	if (header.nAreaA != 0) {
+		m_dSourceAreas.Initialize(header.nAreaA);
+		memcpy(&(m_dSourceAreas[0]), pData + header.ixAreaA,
+			header.nAreaA * sizeof(double));
+	}
+	if (header.nAreaB != 0) {
+		m_dTargetAreas.Initialize(header.nAreaB);
+		memcpy(&(m_dTargetAreas[0]), pData + header.ixAreaB,
+			header.nAreaB * sizeof(double));
+	}
 
-			} else {
-				// Cast the data to float
-				int ix = 0;
-				for (int i = 0; i < dataOut.GetRows(); i++) {
-				for (int j = 0; j < dataOut.GetColumns(); j++) {
-					dataOut[i][j] = static_cast<float>(dataOutDouble[ix]);
-					ix++;
-				}
-				}
+	// Use the CSR arrays in place
+	if (nValueSize == sizeof(float)) {
+		m_mapRemap.Clear();
+		m_mapRemapSingle.AttachExternal(
+			header.nRows,
+			header.nCols,
+			header.nNonZeros,
+			reinterpret_cast<const int *>(pData + header.ixRowPtr),
+			reinterpret_cast<const int *>(pData + header.ixColIx),
+			reinterpret_cast<const float *>(pData + header.ixValues));
+		m_fSinglePrecision = true;
 
-				// Write the data as float
-				varOut->set_cur(&(nCounts[0]));
-				varOut->put(&(dataOut[0][0]), &(nPut[0]));
-			}
-		}
-		AnnounceEndBlock(NULL);
+	} else {
+		m_mapRemapSingle.Clear();
+		m_mapRemap.AttachExternal(
+			header.nRows,
+			header.nCols,
+			header.nNonZeros,
+			reinterpret_cast<const int *>(pData + header.ixRowPtr),
+			reinterpret_cast<const int *>(pData + header.ixColIx),
+			reinterpret_cast<const double *>(pData + header.ixValues));
+		m_fSinglePrecision = false;
 	}
+
+	s_counterNonZerosRead.Add(header.nNonZeros);
+
+	WidenGridDimensions(strInput);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void OfflineMap::Read(
-	const std::string & strInput
+///	<summary>
+///		Write nBytes of data to a binary map file, followed by padding to
+///		the next multiple of BinaryMapAlignment.
+///	</summary>
+static void WriteBinaryMapArray(
+	FILE * fp,
+	const void * pData,
+	int64_t nBytes
 ) {
-	NcFile ncMap(strInput.c_str(), NcFile::ReadOnly);
+	if (nBytes != 0) {
+		if (fwrite(pData, 1, nBytes, fp) != static_cast<size_t>(nBytes)) {
+			_EXCEPTIONT("Unable to write binary map file");
+		}
+	}
 
-	// Read input dimensions entries
-	NcDim * dimSrcGridRank = ncMap.get_dim("src_grid_rank");
-	NcDim * dimDstGridRank = ncMap.get_dim("dst_grid_rank");
+	s_counterBytesWritten.Add(nBytes);
 
-	int nSrcGridDims = (int)(dimSrcGridRank->size());
-	int nDstGridDims = (int)(dimDstGridRank->size());
+	int64_t nPad =
+		(BinaryMapAlignment - nBytes % BinaryMapAlignment) % BinaryMapAlignment;
 
-	NcVar * varSrcGridDims = ncMap.get_var("src_grid_dims");
-	NcVar * varDstGridDims = ncMap.get_var("dst_grid_dims");
+	char szZero[BinaryMapAlignment];
+	memset(szZero, 0, nPad);
 
-	m_vecInputDimSizes.resize(nSrcGridDims);
-	m_vecInputDimNames.resize(nSrcGridDims);
+	if (fwrite(szZero, 1, nPad, fp) != static_cast<size_t>(nPad)) {
+		_EXCEPTIONT("Unable to write binary map file");
+	}
+}
 
-	m_vecOutputDimSizes.resize(nDstGridDims);
-	m_vecOutputDimNames.resize(nDstGridDims);
+///	<summary>
+///		Size of a binary map array including padding.
+///	</summary>
+static int64_t BinaryMapPaddedSize(
+	int64_t nBytes
+) {
+	return ((nBytes + BinaryMapAlignment - 1) / BinaryMapAlignment)
+		* BinaryMapAlignment;
+}
 
-	varSrcGridDims->get(&(m_vecInputDimSizes[0]), nSrcGridDims);
-	varDstGridDims->get(&(m_vecOutputDimSizes[0]), nDstGridDims);
+///////////////////////////////////////////////////////////////////////////////
 
-	for (int i = 0; i < nSrcGridDims; i++) {
-		char szDim[64];
-		sprintf(szDim, "name%i", i);
-		m_vecInputDimNames[i] = varSrcGridDims->get_att(szDim)->as_string(0);
+void OfflineMap::WriteBinary(
+	const std::string & strOutput,
+	const DataVector<double> & vecInputArea,
+	const DataVector<double> & vecOutputArea
+) {
+	if (!m_fSinglePrecision) {
+		m_mapRemap.Finalize();
 	}
 
-	for (int i = 0; i < nDstGridDims; i++) {
-		char szDim[64];
-		sprintf(szDim, "name%i", i);
-		m_vecOutputDimNames[i] = varDstGridDims->get_att(szDim)->as_string(0);
+	int nA = 1;
+	int nB = 1;
+
+	for (int i = 0; i < m_vecInputDimSizes.size(); i++) {
+		nA *= m_vecInputDimSizes[i];
+	}
+	for (int i = 0; i < m_vecOutputDimSizes.size(); i++) {
+		nB *= m_vecOutputDimSizes[i];
 	}
 
-	// Read SparseMatrix entries
-	NcDim * dimNS = ncMap.get_dim("n_s");
+	if ((vecInputArea.GetRows() != 0) && (vecInputArea.GetRows() != nA)) {
+		_EXCEPTION2("OfflineMap dimension mismatch with input Mesh (%i, %i)",
+			vecInputArea.GetRows(), nA);
+	}
+	if ((vecOutputArea.GetRows() != 0) && (vecOutputArea.GetRows() != nB)) {
+		_EXCEPTION2("OfflineMap dimension mismatch with output Mesh (%i, %i)",
+			vecOutputArea.GetRows(), nB);
+	}
 
-	NcVar * varRow = ncMap.get_var("row");
-	NcVar * varCol = ncMap.get_var("col");
-	NcVar * varS   = ncMap.get_var("S");
+	// Dimension records
+	std::vector<BinaryMapDim> vecDims(
+		m_vecInputDimSizes.size() + m_vecOutputDimSizes.size());
 
-	int nS = dimNS->size();
+	for (int i = 0; i < vecDims.size(); i++) {
+		bool fInput = (i < m_vecInputDimSizes.size());
+		int ix = (fInput)?(i):(i - static_cast<int>(m_vecInputDimSizes.size()));
 
-	DataVector<int> vecRow;
-	vecRow.Initialize(nS);
+		const std::string & strName =
+			(fInput)?(m_vecInputDimNames[ix]):(m_vecOutputDimNames[ix]);
 
-	DataVector<int> vecCol;
-	vecCol.Initialize(nS);
+		if (strName.length() > BinaryMapDimNameLength) {
+			_EXCEPTION1("Dimension name \"%s\" too long for binary map file",
+				strName.c_str());
+		}
 
-	DataVector<double> vecS;
-	vecS.Initialize(nS);
+		memset(&(vecDims[i]), 0, sizeof(BinaryMapDim));
+		vecDims[i].nSize =
+			(fInput)?(m_vecInputDimSizes[ix]):(m_vecOutputDimSizes[ix]);
+		memcpy(vecDims[i].szName, strName.c_str(), strName.length());
+	}
 
-	varRow->set_cur((long)0);
-	varRow->get(&(vecRow[0]), nS);
+	// Header
+	const int nRows = GetRows();
+	const int nNonZeros =
+		(m_fSinglePrecision)?
+			(m_mapRemapSingle.GetNonZeros()):(m_mapRemap.GetNonZeros());
+
+	const int64_t nValueSize =
+		(m_fSinglePrecision)?(sizeof(float)):(sizeof(double));
+
+	BinaryMapHeader header;
+	memset(&header, 0, sizeof(BinaryMapHeader));
+	memcpy(header.szMagic, BinaryMapMagic, sizeof(BinaryMapMagic));
+
+	header.nVersion = BinaryMapVersion;
+	header.nByteOrder = BinaryMapByteOrder;
+	header.nRows = nRows;
+	header.nCols = GetColumns();
+	header.nNonZeros = nNonZeros;
+
+	s_counterNonZerosWritten.Add(nNonZeros);
+	header.nSrcGridDims = static_cast<int32_t>(m_vecInputDimSizes.size());
+	header.nDstGridDims = static_cast<int32_t>(m_vecOutputDimSizes.size());
+	header.nAreaA = vecInputArea.GetRows();
+	header.nAreaB = vecOutputArea.GetRows();
+	header.nValueSize = static_cast<int32_t>(nValueSize);
+
+	const int64_t sDims =
+		static_cast<int64_t>(sizeof(BinaryMapDim)) * vecDims.size();
+	const int64_t sAreaA = static_cast<int64_t>(sizeof(double)) * header.nAreaA;
+	const int64_t sAreaB = static_cast<int64_t>(sizeof(double)) * header.nAreaB;
+	const int64_t sRowPtr = static_cast<int64_t>(sizeof(int32_t)) * (nRows + 1);
+	const int64_t sColIx = static_cast<int64_t>(sizeof(int32_t)) * nNonZeros;
+	const int64_t sValues = nValueSize * nNonZeros;
+
+	header.ixDims = BinaryMapPaddedSize(sizeof(BinaryMapHeader));
+	header.ixAreaA = header.ixDims + BinaryMapPaddedSize(sDims);
+	header.ixAreaB = header.ixAreaA + BinaryMapPaddedSize(sAreaA);
+	header.ixRowPtr = header.ixAreaB + BinaryMapPaddedSize(sAreaB);
+	header.ixColIx = header.ixRowPtr + BinaryMapPaddedSize(sRowPtr);
+	header.ixValues = header.ixColIx + BinaryMapPaddedSize(sColIx);
+	header.sFileSize = header.ixValues + BinaryMapPaddedSize(sValues);
+
+	// Write the file
+	FILE * fp = fopen(strOutput.c_str(), "wb");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open binary map file \"%s\"",
+			strOutput.c_str());
+	}
 
-	varCol->set_cur((long)0);
-	varCol->get(&(vecCol[0]), nS);
+	try {
+		WriteBinaryMapArray(fp, &header, sizeof(BinaryMapHeader));
+		WriteBinaryMapArray(fp, (sDims == 0)?(NULL):(&(vecDims[0])), sDims);
+		WriteBinaryMapArray(fp, (const double *)(vecInputArea), sAreaA);
+		WriteBinaryMapArray(fp, (const double *)(vecOutputArea), sAreaB);
+		if (m_fSinglePrecision) {
+			WriteBinaryMapArray(fp, m_mapRemapSingle.GetRowPtr(), sRowPtr);
+			WriteBinaryMapArray(fp, m_mapRemapSingle.GetColIx(), sColIx);
+			WriteBinaryMapArray(fp, m_mapRemapSingle.GetValues(), sValues);
+		} else {
+			WriteBinaryMapArray(fp, m_mapRemap.GetRowPtr(), sRowPtr);
+			WriteBinaryMapArray(fp, m_mapRemap.GetColIx(), sColIx);
+			WriteBinaryMapArray(fp, m_mapRemap.GetValues(), sValues);
+		}
 
-	varS->set_cur((long)0);
-	varS->get(&(vecS[0]), nS);
+	} catch(...) {
+		fclose(fp);
+		throw;
+	}
 
-	m_mapRemap.SetEntries(vecRow, vecCol, vecS);
+	if (fclose(fp) != 0) {
+		_EXCEPTION1("Unable to write binary map file \"%s\"",
+			strOutput.c_str());
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -509,9 +3168,15 @@ void OfflineMap::Read(
 void OfflineMap::Write(
 	const std::string & strOutput,
 	const DataVector<double> & vecInputArea,
-	const DataVector<double> & vecOutputArea
+	const DataVector<double> & vecOutputArea,
+	const NetCDFOutputOptions & options
 ) {
-	NcFile ncMap(strOutput.c_str(), NcFile::Replace);
+	NcFile ncMap(
+		strOutput.c_str(),
+		NcFile::Replace,
+		NULL,
+		0,
+		(options.fNetCDF4)?(NcFile::Netcdf4):(NcFile::Classic));
 
 	// Attributes
 	ncMap.add_att("Title", "TempestRemap Offline Regridding Weight Generator");
@@ -554,6 +3219,9 @@ void OfflineMap::Write(
 	NcDim * dimNA = ncMap.add_dim("n_a", nA);
 	NcDim * dimNB = ncMap.add_dim("n_b", nB);
 
+	long nChunkA = GetNcChunkLength(nA);
+	long nChunkB = GetNcChunkLength(nB);
+
 	// Write areas
 	if (vecInputArea.GetRows() != 0) {
 		if (vecInputArea.GetRows() != nA) {
@@ -562,6 +3230,7 @@ void OfflineMap::Write(
 		}
 
 		NcVar * varAreaA = ncMap.add_var("area_a", ncDouble, dimNA);
+		DefineNcVarStorage(&ncMap, varAreaA, &nChunkA, options);
 		varAreaA->put(&(vecInputArea[0]), nA);
 	}
 
@@ -572,6 +3241,7 @@ void OfflineMap::Write(
 		}
 
 		NcVar * varAreaB = ncMap.add_var("area_b", ncDouble, dimNB);
+		DefineNcVarStorage(&ncMap, varAreaB, &nChunkB, options);
 		varAreaB->put(&(vecOutputArea[0]), nB);
 	}
 
@@ -583,6 +3253,7 @@ void OfflineMap::Write(
 		dFrac[i] = 1.0;
 	}
 	NcVar * varFracA = ncMap.add_var("frac_a", ncDouble, dimNA);
+	DefineNcVarStorage(&ncMap, varFracA, &nChunkA, options);
 	varFracA->put(&(dFrac[0]), nA);
 
 	dFrac.Initialize(nB);
@@ -590,21 +3261,42 @@ void OfflineMap::Write(
 		dFrac[i] = 1.0;
 	}
 	NcVar * varFracB = ncMap.add_var("frac_b", ncDouble, dimNB);
+	DefineNcVarStorage(&ncMap, varFracB, &nChunkB, options);
 	varFracB->put(&(dFrac[0]), nB);
 
 	// Write SparseMatrix entries
 	DataVector<int> vecRow;
 	DataVector<int> vecCol;
 	DataVector<double> vecS;
+	DataVector<float> vecSSingle;
 
-	m_mapRemap.GetEntries(vecRow, vecCol, vecS);
+	if (m_fSinglePrecision) {
+		m_mapRemapSingle.GetEntries(vecRow, vecCol, vecSSingle);
+	} else {
+		m_mapRemap.GetEntries(vecRow, vecCol, vecS);
+	}
 
 	int nS = vecRow.GetRows();
 	NcDim * dimNS = ncMap.add_dim("n_s", nS);
 
 	NcVar * varRow = ncMap.add_var("row", ncInt, dimNS);
 	NcVar * varCol = ncMap.add_var("col", ncInt, dimNS);
-	NcVar * varS = ncMap.add_var("S", ncDouble, dimNS);
+	NcVar * varS =
+		ncMap.add_var("S", (m_fSinglePrecision)?(ncFloat):(ncDouble), dimNS);
+
+	// Chunks of entries hold a whole number of rows of average length
+	int nRows = GetRows();
+	long nRowLength = (nRows > 0)?((nS + nRows - 1) / nRows):(1);
+	if (nRowLength < 1) {
+		nRowLength = 1;
+	}
+	long nChunkS = nRowLength * GetNcChunkLength(
+		NetCDFOutputOptions::DefaultChunkLength / nRowLength);
+	nChunkS = GetNcChunkLength(nS, nChunkS);
+
+	DefineNcVarStorage(&ncMap, varRow, &nChunkS, options);
+	DefineNcVarStorage(&ncMap, varCol, &nChunkS, options);
+	DefineNcVarStorage(&ncMap, varS, &nChunkS, options);
 
 	varRow->set_cur((long)0);
 	varRow->put(&(vecRow[0]), nS);
@@ -613,115 +3305,479 @@ void OfflineMap::Write(
 	varCol->put(&(vecCol[0]), nS);
 
 	varS->set_cur((long)0);
-	varS->put(&(vecS[0]), nS);
+	if (m_fSinglePrecision) {
+		varS->put(&(vecSSingle[0]), nS);
+	} else {
+		varS->put(&(vecS[0]), nS);
+	}
+
+	s_counterBytesWritten.Add(
+		(2 * sizeof(int) + ((m_fSinglePrecision)?(sizeof(float)):(sizeof(double))))
+		* static_cast<long long>(nS));
+	s_counterNonZerosWritten.Add(nS);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool OfflineMap::IsConsistent(
-	double dTolerance
+void OfflineMap::Compose(
+	const OfflineMap & mapFirst,
+	const OfflineMap & mapSecond,
+	double dDropTolerance
 ) {
+	// Verify the output grid of mapFirst is the input grid of mapSecond
+	int nFirstOut = 1;
+	for (int i = 0; i < mapFirst.m_vecOutputDimSizes.size(); i++) {
+		nFirstOut *= mapFirst.m_vecOutputDimSizes[i];
+	}
+
+	int nSecondIn = 1;
+	for (int i = 0; i < mapSecond.m_vecInputDimSizes.size(); i++) {
+		nSecondIn *= mapSecond.m_vecInputDimSizes[i];
+	}
+
+	if (nFirstOut != nSecondIn) {
+		_EXCEPTION2("Output grid size of first map (%i) does not match "
+			"input grid size of second map (%i)", nFirstOut, nSecondIn);
+	}
+	if (mapFirst.GetRows() > nFirstOut) {
+		_EXCEPTIONT("First map has more rows than its output grid");
+	}
+	if (mapSecond.GetColumns() > nSecondIn) {
+		_EXCEPTIONT("Second map has more columns than its input grid");
+	}
+
+	if ((&mapFirst == this) || (&mapSecond == this)) {
+		_EXCEPTIONT("OfflineMap composition cannot be computed in place");
+	}
 
-	// Get map entries
-	DataVector<int> dataRows;
-	DataVector<int> dataCols;
-	DataVector<double> dataEntries;
+	UnmapBinaryFile();
 
-	m_mapRemap.GetEntries(dataRows, dataCols, dataEntries);
+	m_vecInputDimSizes = mapFirst.m_vecInputDimSizes;
+	m_vecInputDimNames = mapFirst.m_vecInputDimNames;
+	m_vecOutputDimSizes = mapSecond.m_vecOutputDimSizes;
+	m_vecOutputDimNames = mapSecond.m_vecOutputDimNames;
 
-	// Calculate row sums
-	DataVector<double> dRowSums;
-	dRowSums.Initialize(m_mapRemap.GetRows());
+	m_dSourceAreas = mapFirst.m_dSourceAreas;
+	m_dTargetAreas = mapSecond.m_dTargetAreas;
 
-	for (int i = 0; i < dataRows.GetRows(); i++) {
-		dRowSums[dataRows[i]] += dataEntries[i];
+	// Single precision maps are composed in double precision
+	SparseMatrix<double> smatFirst;
+	SparseMatrix<double> smatSecond;
+
+	const SparseMatrix<double> * pmatFirst = &(mapFirst.m_mapRemap);
+	const SparseMatrix<double> * pmatSecond = &(mapSecond.m_mapRemap);
+
+	if (mapFirst.m_fSinglePrecision) {
+		smatFirst.ConvertFrom(mapFirst.m_mapRemapSingle);
+		pmatFirst = &smatFirst;
+	}
+	if (mapSecond.m_fSinglePrecision) {
+		smatSecond.ConvertFrom(mapSecond.m_mapRemapSingle);
+		pmatSecond = &smatSecond;
 	}
 
-	// Verify all row sums are equal to 1
-	bool fConsistent = true;
-	for (int i = 0; i < dRowSums.GetRows(); i++) {
-		if (fabs(dRowSums[i] - 1.0) > dTolerance) {
-			fConsistent = false;
-			Announce("OfflineMap is not consistent in row %i (%1.15e)",
-				i, dRowSums[i]);
-		}
+	m_mapRemapSingle.Clear();
+	m_fSinglePrecision = false;
+
+	m_mapRemap.Multiply(*pmatSecond, *pmatFirst, dDropTolerance);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Record an error in an OfflineMapCheck.  Ties are resolved in favour
+///		of the lowest index so that the result does not depend on the
+///		number of threads.
+///	</summary>
+static inline void UpdateOfflineMapCheck(
+	OfflineMapCheck & check,
+	int ix,
+	double dError,
+	double dValue
+) {
+	if ((dError > check.dWorstError) ||
+		((dError == check.dWorstError) && (ix < check.ixWorst))
+	) {
+		check.ixWorst = ix;
+		check.dWorstError = dError;
+		check.dWorstValue = dValue;
 	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
-	return fConsistent;
+///	<summary>
+///		Merge the worst error recorded by one thread into an OfflineMapCheck.
+///	</summary>
+static inline void MergeOfflineMapCheck(
+	OfflineMapCheck & check,
+	const OfflineMapCheck & checkThread
+) {
+	check.nViolations += checkThread.nViolations;
+	if (checkThread.ixWorst != (-1)) {
+		UpdateOfflineMapCheck(
+			check,
+			checkThread.ixWorst,
+			checkThread.dWorstError,
+			checkThread.dWorstValue);
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool OfflineMap::IsConservative(
+///	<summary>
+///		Verify the selected properties of a finalized SparseMatrix.  Row
+///		sums and the range of entries are computed in one pass over the
+///		rows, which also accumulates the area-weighted column sums into
+///		one buffer per thread.  The buffers are then reduced in thread
+///		order in a parallel pass over the columns, so column sums may
+///		differ in the last bits with the number of threads.
+///	</summary>
+template <typename T>
+static void VerifySparseMatrix(
+	const SparseMatrix<T> & smat,
 	const DataVector<double> & vecInputAreas,
 	const DataVector<double> & vecOutputAreas,
+	bool fCheckConsistency,
+	bool fCheckConservation,
+	bool fCheckMonotone,
+	double dConsistencyTolerance,
+	double dConservationTolerance,
+	double dMonotoneTolerance,
+	OfflineMapReport & report
+) {
+	const int nRows = smat.GetRows();
+	const int nCols = smat.GetColumns();
+	const int nNonZeros = smat.GetNonZeros();
+
+	const int * piRowPtr = smat.GetRowPtr();
+	const int * piColIx = smat.GetColIx();
+	const T * pValues = smat.GetValues();
+
+	if (fCheckConservation) {
+		if (vecInputAreas.GetRows() < nCols) {
+			_EXCEPTIONT("vecInputAreas / mapRemap dimension mismatch");
+		}
+		if (vecOutputAreas.GetRows() < nRows) {
+			_EXCEPTIONT("vecOutputAreas / mapRemap dimension mismatch");
+		}
+	}
+
+	OfflineMapCheck & checkConsistency = report.checkConsistency;
+	OfflineMapCheck & checkConservation = report.checkConservation;
+	OfflineMapCheck & checkMonotone = report.checkMonotonicity;
+
+	checkConsistency = OfflineMapCheck();
+	checkConservation = OfflineMapCheck();
+	checkMonotone = OfflineMapCheck();
+
+	if (fCheckConsistency) {
+		checkConsistency.fChecked = true;
+		checkConsistency.nChecked = nRows;
+	}
+	if (fCheckConservation) {
+		checkConservation.fChecked = true;
+		checkConservation.nChecked = nCols;
+	}
+	if (fCheckMonotone) {
+		checkMonotone.fChecked = true;
+		checkMonotone.nChecked = nNonZeros;
+	}
+
+	int nThreads = 1;
+#ifdef _OPENMP
+	nThreads = omp_get_max_threads();
+#endif
+
+	// Area-weighted column sums of each thread
+	DataMatrix<double> dColumnSums;
+	if (fCheckConservation && (nCols > 0)) {
+		dColumnSums.Initialize(nThreads, nCols);
+	}
+
+	// Pass over rows
+#pragma omp parallel num_threads(nThreads)
+	{
+		int iThread = 0;
+#ifdef _OPENMP
+		iThread = omp_get_thread_num();
+#endif
+
+		OfflineMapCheck checkRowThread;
+		OfflineMapCheck checkEntryThread;
+
+		double * pColumnSums =
+			(fCheckConservation && (nCols > 0))?(dColumnSums[iThread]):(NULL);
+
+#pragma omp for schedule(static)
+		for (int i = 0; i < nRows; i++) {
+			double dRowSum = 0.0;
+
+			for (int j = piRowPtr[i]; j < piRowPtr[i+1]; j++) {
+				const double dValue = static_cast<double>(pValues[j]);
+
+				dRowSum += dValue;
+
+				if (fCheckConservation) {
+					pColumnSums[piColIx[j]] += dValue * vecOutputAreas[i];
+				}
+
+				if (fCheckMonotone) {
+					double dError = 0.0;
+					if (dValue < 0.0) {
+						dError = - dValue;
+					} else if (dValue > 1.0) {
+						dError = dValue - 1.0;
+					}
+					if (dError > dMonotoneTolerance) {
+						checkEntryThread.nViolations++;
+					}
+					if (dError > 0.0) {
+						UpdateOfflineMapCheck(
+							checkEntryThread, j, dError, dValue);
+					}
+				}
+			}
+
+			if (fCheckConsistency) {
+				double dError = fabs(dRowSum - 1.0);
+				if (dError > dConsistencyTolerance) {
+					checkRowThread.nViolations++;
+				}
+				if (dError > 0.0) {
+					UpdateOfflineMapCheck(checkRowThread, i, dError, dRowSum);
+				}
+			}
+		}
+
+#pragma omp critical
+		{
+			MergeOfflineMapCheck(checkConsistency, checkRowThread);
+			MergeOfflineMapCheck(checkMonotone, checkEntryThread);
+		}
+
+		// Pass over columns
+		if (fCheckConservation) {
+			OfflineMapCheck checkColumnThread;
+
+#pragma omp for schedule(static)
+			for (int i = 0; i < nCols; i++) {
+				double dColumnSum = 0.0;
+				for (int t = 0; t < nThreads; t++) {
+					dColumnSum += dColumnSums[t][i];
+				}
+
+				double dError = fabs(dColumnSum - vecInputAreas[i]);
+				if (dError > dConservationTolerance) {
+					checkColumnThread.nViolations++;
+				}
+				if (dError > 0.0) {
+					UpdateOfflineMapCheck(
+						checkColumnThread, i, dError, dColumnSum);
+				}
+			}
+
+#pragma omp critical
+			{
+				MergeOfflineMapCheck(checkConservation, checkColumnThread);
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Announce the result of verifying one property of an OfflineMap.
+///	</summary>
+static void AnnounceOfflineMapCheck(
+	const OfflineMapCheck & check,
+	const char * szProperty,
+	const char * szElement,
+	const char * szElements,
 	double dTolerance
 ) {
-/*
-	if (vecInputAreas.GetRows() != m_mapRemap.GetColumns()) {
-		_EXCEPTIONT("vecInputAreas / mapRemap dimension mismatch");
+	if (!check.fChecked) {
+		return;
 	}
-	if (vecOutputAreas.GetRows() != m_mapRemap.GetRows()) {
-		_EXCEPTIONT("vecOutputAreas / mapRemap dimension mismatch");
+	if (check.IsPassed()) {
+		Announce("OfflineMap is %s (%i %s, max error %1.5e)",
+			szProperty, check.nChecked, szElements, check.dWorstError);
+	} else {
+		Announce("OfflineMap is not %s in %i of %i %s "
+			"(tolerance %1.5e)",
+			szProperty, check.nViolations, check.nChecked,
+			szElements, dTolerance);
+		Announce("Largest error in %s %i (%1.15e, error %1.5e)",
+			szElement, check.ixWorst, check.dWorstValue, check.dWorstError);
 	}
-*/
-	// Get map entries
-	DataVector<int> dataRows;
-	DataVector<int> dataCols;
-	DataVector<double> dataEntries;
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
-	m_mapRemap.GetEntries(dataRows, dataCols, dataEntries);
+OfflineMapReport OfflineMap::Verify(
+	const DataVector<double> & vecInputAreas,
+	const DataVector<double> & vecOutputAreas,
+	bool fCheckMonotone,
+	double dConsistencyTolerance,
+	double dConservationTolerance,
+	double dMonotoneTolerance
+) {
+	bool fHasAreas =
+		((vecInputAreas.GetRows() != 0) && (vecOutputAreas.GetRows() != 0));
+
+	bool fCheckConservation =
+		fHasAreas
+		&& (vecInputAreas.GetRows() >= GetColumns())
+		&& (vecOutputAreas.GetRows() >= GetRows());
+
+	OfflineMapReport report;
+
+	if (m_fSinglePrecision) {
+		VerifySparseMatrix<float>(
+			m_mapRemapSingle,
+			vecInputAreas,
+			vecOutputAreas,
+			true,
+			fCheckConservation,
+			fCheckMonotone,
+			dConsistencyTolerance,
+			dConservationTolerance,
+			dMonotoneTolerance,
+			report);
 
-	// Calculate column sums
-	DataVector<double> dColumnSums;
-	dColumnSums.Initialize(m_mapRemap.GetColumns());
+	} else {
+		m_mapRemap.Finalize();
+
+		VerifySparseMatrix<double>(
+			m_mapRemap,
+			vecInputAreas,
+			vecOutputAreas,
+			true,
+			fCheckConservation,
+			fCheckMonotone,
+			dConsistencyTolerance,
+			dConservationTolerance,
+			dMonotoneTolerance,
+			report);
+	}
 
-	for (int i = 0; i < dataRows.GetRows(); i++) {
-		dColumnSums[dataCols[i]] +=
-			dataEntries[i] * vecOutputAreas[dataRows[i]];
+	AnnounceOfflineMapCheck(
+		report.checkConsistency, "consistent", "row", "rows",
+		dConsistencyTolerance);
+
+	if (fCheckConservation) {
+		AnnounceOfflineMapCheck(
+			report.checkConservation, "conservative", "column", "columns",
+			dConservationTolerance);
+	} else if (fHasAreas) {
+		Announce("Areas do not match map dimensions; "
+			"conservation not verified");
+	} else {
+		Announce("Areas not available; conservation not verified");
 	}
 
-	// Verify all column sums equal the input Jacobian
-	bool fConservative = true;
-	for (int i = 0; i < dColumnSums.GetRows(); i++) {
-		if (fabs(dColumnSums[i] - vecInputAreas[i]) > dTolerance) {
-			fConservative = false;
-			Announce("OfflineMap is not conservative in column "
-				"%i (%1.15e / %1.15e)",
-				i, dColumnSums[i], vecInputAreas[i]);
-		}
+	AnnounceOfflineMapCheck(
+		report.checkMonotonicity, "monotone", "entry", "entries",
+		dMonotoneTolerance);
+
+	return report;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool OfflineMap::IsConsistent(
+	double dTolerance,
+	OfflineMapCheck * pCheck
+) {
+	DataVector<double> vecDummyAreas;
+
+	OfflineMapReport report;
+
+	if (m_fSinglePrecision) {
+		VerifySparseMatrix<float>(
+			m_mapRemapSingle, vecDummyAreas, vecDummyAreas,
+			true, false, false, dTolerance, 0.0, 0.0, report);
+	} else {
+		m_mapRemap.Finalize();
+		VerifySparseMatrix<double>(
+			m_mapRemap, vecDummyAreas, vecDummyAreas,
+			true, false, false, dTolerance, 0.0, 0.0, report);
+	}
+
+	AnnounceOfflineMapCheck(
+		report.checkConsistency, "consistent", "row", "rows",
+		dTolerance);
+
+	if (pCheck != NULL) {
+		*pCheck = report.checkConsistency;
+	}
+
+	return report.checkConsistency.IsPassed();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool OfflineMap::IsConservative(
+	const DataVector<double> & vecInputAreas,
+	const DataVector<double> & vecOutputAreas,
+	double dTolerance,
+	OfflineMapCheck * pCheck
+) {
+	OfflineMapReport report;
+
+	if (m_fSinglePrecision) {
+		VerifySparseMatrix<float>(
+			m_mapRemapSingle, vecInputAreas, vecOutputAreas,
+			false, true, false, 0.0, dTolerance, 0.0, report);
+	} else {
+		m_mapRemap.Finalize();
+		VerifySparseMatrix<double>(
+			m_mapRemap, vecInputAreas, vecOutputAreas,
+			false, true, false, 0.0, dTolerance, 0.0, report);
 	}
 
-	return fConservative;
+	AnnounceOfflineMapCheck(
+		report.checkConservation, "conservative", "column", "columns",
+		dTolerance);
+
+	if (pCheck != NULL) {
+		*pCheck = report.checkConservation;
+	}
+
+	return report.checkConservation.IsPassed();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 bool OfflineMap::IsMonotone(
-	double dTolerance
+	double dTolerance,
+	OfflineMapCheck * pCheck
 ) {
+	DataVector<double> vecDummyAreas;
 
-	// Get map entries
-	DataVector<int> dataRows;
-	DataVector<int> dataCols;
-	DataVector<double> dataEntries;
+	OfflineMapReport report;
 
-	m_mapRemap.GetEntries(dataRows, dataCols, dataEntries);
+	if (m_fSinglePrecision) {
+		VerifySparseMatrix<float>(
+			m_mapRemapSingle, vecDummyAreas, vecDummyAreas,
+			false, false, true, 0.0, 0.0, dTolerance, report);
+	} else {
+		m_mapRemap.Finalize();
+		VerifySparseMatrix<double>(
+			m_mapRemap, vecDummyAreas, vecDummyAreas,
+			false, false, true, 0.0, 0.0, dTolerance, report);
+	}
 
-	// Verify all entries are in the range [0,1]
-	bool fMonotone = true;
-	for (int i = 0; i < dataRows.GetRows(); i++) {
-		if ((dataEntries[i] < -dTolerance) ||
-			(dataEntries[i] > 1.0 + dTolerance)
-		) {
-			fMonotone = false;
+	AnnounceOfflineMapCheck(
+		report.checkMonotonicity, "monotone", "entry", "entries",
+		dTolerance);
 
-			Announce("OfflineMap is not monotone in entry (%i): %1.15e",
-				i, dataEntries[i]);
-		}
+	if (pCheck != NULL) {
+		*pCheck = report.checkMonotonicity;
 	}
 
-	return fMonotone;
+	return report.checkMonotonicity.IsPassed();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -19,6 +19,7 @@
 
 #include "SparseMatrix.h"
 #include "DataVector.h"
+#include "NetCDFUtilities.h"
 #include <string>
 #include <vector>
 
@@ -26,11 +27,123 @@ class Mesh;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		The result of verifying one property of an OfflineMap.
+///	</summary>
+struct OfflineMapCheck {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OfflineMapCheck() :
+		fChecked(false),
+		nChecked(0),
+		nViolations(0),
+		ixWorst(-1),
+		dWorstError(0.0),
+		dWorstValue(0.0)
+	{ }
+
+	///	<summary>
+	///		Determine if no violations were found.
+	///	</summary>
+	bool IsPassed() const {
+		return (nViolations == 0);
+	}
+
+	///	<summary>
+	///		Flag indicating this property was verified.
+	///	</summary>
+	bool fChecked;
+
+	///	<summary>
+	///		Number of rows, columns or entries examined.
+	///	</summary>
+	int nChecked;
+
+	///	<summary>
+	///		Number of rows, columns or entries outside the tolerance.
+	///	</summary>
+	int nViolations;
+
+	///	<summary>
+	///		Row, column or entry with the largest error, or -1 if the
+	///		error is zero everywhere.
+	///	</summary>
+	int ixWorst;
+
+	///	<summary>
+	///		Largest error.
+	///	</summary>
+	double dWorstError;
+
+	///	<summary>
+	///		Row sum, column sum or entry at ixWorst.
+	///	</summary>
+	double dWorstValue;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		The result of verifying an OfflineMap.
+///	</summary>
+struct OfflineMapReport {
+
+	///	<summary>
+	///		Determine if all verified properties hold.
+	///	</summary>
+	bool IsPassed() const {
+		return (checkConsistency.IsPassed()
+			&& checkConservation.IsPassed()
+			&& checkMonotonicity.IsPassed());
+	}
+
+	///	<summary>
+	///		Row sums compared to 1.
+	///	</summary>
+	OfflineMapCheck checkConsistency;
+
+	///	<summary>
+	///		Area-weighted column sums compared to the input areas.
+	///	</summary>
+	OfflineMapCheck checkConservation;
+
+	///	<summary>
+	///		Entries compared to the range [0,1].
+	///	</summary>
+	OfflineMapCheck checkMonotonicity;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		An offline map between two Meshes.
 ///	</summary>
 class OfflineMap {
 
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OfflineMap();
+
+	///	<summary>
+	///		Destructor.
+	///	</summary>
+	~OfflineMap();
+
+private:
+	///	<summary>
+	///		Copy constructor (not implemented).
+	///	</summary>
+	OfflineMap(const OfflineMap &);
+
+	///	<summary>
+	///		Assignment operator (not implemented).
+	///	</summary>
+	OfflineMap & operator= (const OfflineMap &);
+
 public:
 	///	<summary>
 	///		Initialize the array of input dimensions from a file.
@@ -46,9 +159,48 @@ public:
 		const std::string & strOutputMesh
 	);
 
+	///	<summary>
+	///		Initialize the input dimensions as a single dimension of nCol
+	///		degrees of freedom, such as the GLL nodes of a spectral element
+	///		mesh.
+	///	</summary>
+	void InitializeInputDimensions(
+		int nCol
+	);
+
+	///	<summary>
+	///		Initialize the output dimensions as a single dimension of nCol
+	///		degrees of freedom.
+	///	</summary>
+	void InitializeOutputDimensions(
+		int nCol
+	);
+
 public:
 	///	<summary>
-	///		Apply the offline map to a data file.
+	///		Default memory budget for the data buffers of Apply, in bytes.
+	///	</summary>
+	static const size_t DefaultApplyMemoryBudget = 256 * 1024 * 1024;
+
+	///	<summary>
+	///		Apply the offline map to a data file.  If areas are given, the
+	///		range of the input and output data of each variable and the
+	///		largest relative change in the mass of a slice are announced.
+	///		Horizontal slices are read, remapped and written in blocks, each
+	///		of which is the largest hyperslab of the dimensions before ncol
+	///		for which the data buffers fit in sMemoryBudget bytes.  If
+	///		fPipeline is set, reading and writing are overlapped with
+	///		remapping on a second thread.  In NetCDF-4 output each
+	///		horizontal slice is stored in one chunk, and batches are aligned
+	///		with the chunks of chunked input.  If fDistributed is set and the
+	///		executable is compiled with MPI, the rows of the map are
+	///		partitioned over all ranks, each of which reads the range of
+	///		input columns referenced by its rows, and the root rank writes
+	///		the output rows of each rank in turn.  Input diagnostics are
+	///		computed by splitting the input columns evenly over the ranks.
+	///		If fDevice is set and the executable is compiled with
+	///		OFFLOAD=True, the map is uploaded once and applied on an offload
+	///		device such as a GPU, or on the CPU if no device is available.
 	///	</summary>
 	void Apply(
 		const DataVector<double> & vecAreaInput,
@@ -58,31 +210,206 @@ public:
 		const std::vector<std::string> & vecVariables,
 		const std::string & strNColName,
 		bool fOutputDouble = false,
-		bool fAppend = false
+		bool fAppend = false,
+		size_t sMemoryBudget = DefaultApplyMemoryBudget,
+		bool fPipeline = false,
+		const NetCDFOutputOptions & options = NetCDFOutputOptions(),
+		bool fDistributed = false,
+		bool fDevice = false
 	);
 
 	///	<summary>
-	///		Read the OfflineMap from a NetCDF file.
+	///		Apply the offline map to the variables of each of a list of
+	///		data files, writing the corresponding output data files.  The
+	///		output variables of up to 32 data files are defined before any
+	///		data is written.  If compiled with OpenMP, and neither fPipeline,
+	///		a partition over several MPI ranks nor a device is used, the
+	///		blocks of all variables of these files are then remapped
+	///		concurrently by all threads, with sMemoryBudget shared among the
+	///		threads.  Output data is identical to that of applying the map
+	///		to each file in turn.
+	///	</summary>
+	void Apply(
+		const DataVector<double> & vecAreaInput,
+		const DataVector<double> & vecAreaOutput,
+		const std::vector<std::string> & vecInputDataFiles,
+		const std::vector<std::string> & vecOutputDataFiles,
+		const std::vector<std::string> & vecVariables,
+		const std::string & strNColName,
+		bool fOutputDouble = false,
+		bool fAppend = false,
+		size_t sMemoryBudget = DefaultApplyMemoryBudget,
+		bool fPipeline = false,
+		const NetCDFOutputOptions & options = NetCDFOutputOptions(),
+		bool fDistributed = false,
+		bool fDevice = false
+	);
+
+	///	<summary>
+	///		Apply the offline map to nLevels horizontal slices in caller-owned
+	///		arrays with layout [nLevels][ncol], where ncol is GetSourceSize()
+	///		for pDataIn and GetTargetSize() for pDataOut.  The data is not
+	///		copied and the map is not modified, so several threads may apply
+	///		the same map concurrently, in which case fParallel should be
+	///		false to avoid nested OpenMP parallelism.
+	///	</summary>
+	void Apply(
+		const double * pDataIn,
+		double * pDataOut,
+		int nLevels,
+		bool fParallel = true
+	) const;
+
+	void Apply(
+		const float * pDataIn,
+		float * pDataOut,
+		int nLevels,
+		bool fParallel = true
+	) const;
+
+	///	<summary>
+	///		Read the OfflineMap from a NetCDF file, or from a binary map file
+	///		if strInput is in the binary format.
 	///	</summary>
 	void Read(
 		const std::string & strInput
 	);
 
 	///	<summary>
-	///		Write the OfflineMap to a NetCDF file.
+	///		Determine if a file is in the binary map format.
 	///	</summary>
-	void Write(
+	static bool IsBinaryFile(
+		const std::string & strInput
+	);
+
+	///	<summary>
+	///		Memory map a binary map file.  The SparseMatrix refers directly
+	///		to the CSR arrays of the mapped file, which remains mapped until
+	///		the OfflineMap is destroyed or read again.
+	///	</summary>
+	void ReadBinary(
+		const std::string & strInput
+	);
+
+	///	<summary>
+	///		Write the OfflineMap to a binary map file.  The file contains a
+	///		header with the grid dimensions, followed by the areas and CSR
+	///		arrays of the map, each aligned to a page boundary.
+	///	</summary>
+	void WriteBinary(
 		const std::string & strOutput,
 		const DataVector<double> & vecInputArea,
 		const DataVector<double> & vecOutputArea
 	);
 
+	///	<summary>
+	///		Write the OfflineMap to a NetCDF file.  In NetCDF-4 output the
+	///		entries are chunked in blocks of whole rows.
+	///	</summary>
+	void Write(
+		const std::string & strOutput,
+		const DataVector<double> & vecInputArea,
+		const DataVector<double> & vecOutputArea,
+		const NetCDFOutputOptions & options = NetCDFOutputOptions()
+	);
+
 public:
+	///	<summary>
+	///		Store the weights of the map in single precision, which halves
+	///		the memory and bandwidth needed to apply it.  Data is then
+	///		remapped in single precision with sums accumulated in double
+	///		precision.  The conversion is rejected with an exception if it
+	///		changes any row sum (consistency) by more than dTolerance, or, if
+	///		areas are given, changes the area-weighted column sum of any
+	///		column (conservation) by more than dTolerance relative to the
+	///		input area of that column.
+	///	</summary>
+	void ConvertToSinglePrecision(
+		const DataVector<double> & vecInputAreas,
+		const DataVector<double> & vecOutputAreas,
+		double dTolerance
+	);
+
+	///	<summary>
+	///		Determine if the weights of the map are stored in single
+	///		precision.
+	///	</summary>
+	bool IsSinglePrecision() const {
+		return m_fSinglePrecision;
+	}
+
+	///	<summary>
+	///		Determine if the grid dimensions of the map were widened to
+	///		the number of columns or rows when it was read, in which case
+	///		they need not match the size of the grid.
+	///	</summary>
+	bool HasWidenedGridDimensions() const {
+		return m_fWidenedGridDims;
+	}
+
+	///	<summary>
+	///		Get the number of rows (output degrees of freedom) of the map.
+	///	</summary>
+	int GetRows() const {
+		return (m_fSinglePrecision)?
+			(m_mapRemapSingle.GetRows()):(m_mapRemap.GetRows());
+	}
+
+	///	<summary>
+	///		Get the number of columns (input degrees of freedom) of the map.
+	///	</summary>
+	int GetColumns() const {
+		return (m_fSinglePrecision)?
+			(m_mapRemapSingle.GetColumns()):(m_mapRemap.GetColumns());
+	}
+
+	///	<summary>
+	///		Get the number of degrees of freedom of the source grid, from
+	///		the input dimensions if they are known.
+	///	</summary>
+	int GetSourceSize() const;
+
+	///	<summary>
+	///		Get the number of degrees of freedom of the target grid, from
+	///		the output dimensions if they are known.
+	///	</summary>
+	int GetTargetSize() const;
+
+public:
+	///	<summary>
+	///		Set this OfflineMap to the composition of mapFirst followed by
+	///		mapSecond, so that applying it is equivalent to applying mapFirst
+	///		and then mapSecond.  Entries of the composed map with magnitude
+	///		no greater than dDropTolerance are dropped.
+	///	</summary>
+	void Compose(
+		const OfflineMap & mapFirst,
+		const OfflineMap & mapSecond,
+		double dDropTolerance = 0.0
+	);
+
+public:
+	///	<summary>
+	///		Verify consistency, conservation and (optionally) monotonicity
+	///		of the map in a single parallel pass over its entries, and
+	///		announce a summary of each property.  Conservation is only
+	///		verified if both area vectors are non-empty.
+	///	</summary>
+	OfflineMapReport Verify(
+		const DataVector<double> & vecInputAreas,
+		const DataVector<double> & vecOutputAreas,
+		bool fCheckMonotone,
+		double dConsistencyTolerance = 1.0e-8,
+		double dConservationTolerance = 1.0e-8,
+		double dMonotoneTolerance = 1.0e-12
+	);
+
 	///	<summary>
 	///		Determine if the map is first-order accurate.
 	///	</summary>
 	bool IsConsistent(
-		double dTolerance
+		double dTolerance,
+		OfflineMapCheck * pCheck = NULL
 	);
 
 	///	<summary>
@@ -91,14 +418,16 @@ public:
 	bool IsConservative(
 		const DataVector<double> & vecInputAreas,
 		const DataVector<double> & vecOutputAreas,
-		double dTolerance
+		double dTolerance,
+		OfflineMapCheck * pCheck = NULL
 	);
 
 	///	<summary>
 	///		Determine if the map is monotone.
 	///	</summary>
 	bool IsMonotone(
-		double dTolerance
+		double dTolerance,
+		OfflineMapCheck * pCheck = NULL
 	);
 
 public:
@@ -110,18 +439,96 @@ public:
 	}
 
 	///	<summary>
-	///		Get the SparseMatrix representation of the OfflineMap.
+	///		Get the SparseMatrix representation of the OfflineMap.  If the
+	///		map is stored in single precision, this is a double precision
+	///		copy of the map.
 	///	</summary>
 	SparseMatrix<double> & GetSparseMatrix() {
+		EnsureDoublePrecision();
 		return m_mapRemap;
 	}
 
+	///	<summary>
+	///		Get the areas of the source grid read with the map, which are
+	///		uninitialized if the map file did not contain them.
+	///	</summary>
+	const DataVector<double> & GetSourceAreas() const {
+		return m_dSourceAreas;
+	}
+
+	///	<summary>
+	///		Get the areas of the target grid read with the map, which are
+	///		uninitialized if the map file did not contain them.
+	///	</summary>
+	const DataVector<double> & GetTargetAreas() const {
+		return m_dTargetAreas;
+	}
+
+	///	<summary>
+	///		Get the sizes and names of the input dimensions.
+	///	</summary>
+	const std::vector<int> & GetInputDimSizes() const {
+		return m_vecInputDimSizes;
+	}
+
+	const std::vector<std::string> & GetInputDimNames() const {
+		return m_vecInputDimNames;
+	}
+
+	///	<summary>
+	///		Get the sizes and names of the output dimensions.
+	///	</summary>
+	const std::vector<int> & GetOutputDimSizes() const {
+		return m_vecOutputDimSizes;
+	}
+
+	const std::vector<std::string> & GetOutputDimNames() const {
+		return m_vecOutputDimNames;
+	}
+
+protected:
+	///	<summary>
+	///		Release the memory mapped binary map file, if any.
+	///	</summary>
+	void UnmapBinaryFile();
+
+	///	<summary>
+	///		Widen single grid dimensions read from strInput which do not
+	///		cover all columns and rows of the map, as in spectral element
+	///		maps which recorded the number of elements rather than the
+	///		number of GLL nodes.
+	///	</summary>
+	void WidenGridDimensions(
+		const std::string & strInput
+	);
+
+	///	<summary>
+	///		Fill the double precision SparseMatrix from the single precision
+	///		weights, if the map is stored in single precision.
+	///	</summary>
+	void EnsureDoublePrecision();
+
 protected:
 	///	<summary>
 	///		The SparseMatrix representing this operator.
 	///	</summary>
 	SparseMatrix<double> m_mapRemap;
 
+	///	<summary>
+	///		Flag indicating the map is stored in single precision.
+	///	</summary>
+	bool m_fSinglePrecision;
+
+	///	<summary>
+	///		Flag indicating the grid dimensions were widened when read.
+	///	</summary>
+	bool m_fWidenedGridDims;
+
+	///	<summary>
+	///		The single precision SparseMatrix representing this operator.
+	///	</summary>
+	SparseMatrix<float> m_mapRemapSingle;
+
 	///	<summary>
 	///		Vector of dimension sizes for Input.
 	///	</summary>
@@ -141,6 +548,22 @@ protected:
 	///		Vector of dimension names for Output.
 	///	</summary>
 	std::vector<std::string> m_vecOutputDimNames;
+
+	///	<summary>
+	///		Areas of the source and target grids read with the map.
+	///	</summary>
+	DataVector<double> m_dSourceAreas;
+	DataVector<double> m_dTargetAreas;
+
+	///	<summary>
+	///		Memory mapped binary map file, or NULL if none.
+	///	</summary>
+	void * m_pMappedFile;
+
+	///	<summary>
+	///		Size of the memory mapped binary map file.
+	///	</summary>
+	size_t m_sMappedFileSize;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
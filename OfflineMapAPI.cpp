@@ -0,0 +1,224 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    OfflineMapAPI.cpp
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "OfflineMapAPI.h"
+#include "OfflineMap.h"
+#include "Exception.h"
+
+#include <cstdio>
+#include <exception>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct OfflineMapHandle {
+
+	///	<summary>
+	///		The offline map.
+	///	</summary>
+	OfflineMap map;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Message of the last error on each thread.
+///	</summary>
+static thread_local std::string s_strLastError;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Record the message of an exception caught at the C interface.
+///	</summary>
+static int SetLastError(
+	const std::string & strError
+) {
+	s_strLastError = strError;
+	return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+OfflineMapHandle * OfflineMapLoad(
+	const char * szMapFile
+) {
+	OfflineMapHandle * pMap = NULL;
+
+	try {
+		if (szMapFile == NULL) {
+			_EXCEPTIONT("No map file specified");
+		}
+
+		FILE * fp = fopen(szMapFile, "rb");
+		if (fp == NULL) {
+			_EXCEPTION1("Unable to open map file \"%s\"", szMapFile);
+		}
+		fclose(fp);
+
+		pMap = new OfflineMapHandle;
+		pMap->map.Read(szMapFile);
+
+		// The sizes of the data arrays are checked against the grid
+		// dimensions, which are only guessed for a widened map
+		if (pMap->map.HasWidenedGridDimensions()) {
+			_EXCEPTION1("Map \"%s\" does not record the size of its grids; "
+				"regenerate the map", szMapFile);
+		}
+
+		s_strLastError.clear();
+		return pMap;
+
+	} catch(Exception & e) {
+		SetLastError(e.ToString());
+
+	} catch(std::exception & e) {
+		SetLastError(e.what());
+	}
+
+	delete pMap;
+	return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapFree(
+	OfflineMapHandle * pMap
+) {
+	delete pMap;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int OfflineMapGetSourceSize(
+	const OfflineMapHandle * pMap
+) {
+	if (pMap == NULL) {
+		return 0;
+	}
+	return pMap->map.GetSourceSize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int OfflineMapGetTargetSize(
+	const OfflineMapHandle * pMap
+) {
+	if (pMap == NULL) {
+		return 0;
+	}
+	return pMap->map.GetTargetSize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Apply the map of a handle to data of precision T.
+///	</summary>
+template <typename T>
+static int ApplyOfflineMapHandle(
+	const OfflineMapHandle * pMap,
+	const T * dDataIn,
+	size_t sDataInLength,
+	T * dDataOut,
+	size_t sDataOutLength,
+	int nLevels,
+	int fParallel
+) {
+	try {
+		if (pMap == NULL) {
+			_EXCEPTIONT("Invalid offline map handle");
+		}
+		if ((nLevels > 0) && ((dDataIn == NULL) || (dDataOut == NULL))) {
+			_EXCEPTIONT("Invalid data array");
+		}
+
+		// The arrays must hold exactly nLevels slices of the source and
+		// target grids, so that a stride mismatch is not silently accepted
+		size_t sLevels = (nLevels > 0)?(static_cast<size_t>(nLevels)):(0);
+		size_t sSourceSize = static_cast<size_t>(pMap->map.GetSourceSize());
+		size_t sTargetSize = static_cast<size_t>(pMap->map.GetTargetSize());
+
+		if (sDataInLength != sLevels * sSourceSize) {
+			_EXCEPTION3("Input data array length (%lu) must be %i levels "
+				"of the source size %lu",
+				static_cast<unsigned long>(sDataInLength),
+				nLevels,
+				static_cast<unsigned long>(sSourceSize));
+		}
+		if (sDataOutLength != sLevels * sTargetSize) {
+			_EXCEPTION3("Output data array length (%lu) must be %i levels "
+				"of the target size %lu",
+				static_cast<unsigned long>(sDataOutLength),
+				nLevels,
+				static_cast<unsigned long>(sTargetSize));
+		}
+
+		pMap->map.Apply(dDataIn, dDataOut, nLevels, (fParallel != 0));
+		return 0;
+
+	} catch(Exception & e) {
+		return SetLastError(e.ToString());
+
+	} catch(std::exception & e) {
+		return SetLastError(e.what());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int OfflineMapApplyDouble(
+	const OfflineMapHandle * pMap,
+	const double * dDataIn,
+	size_t sDataInLength,
+	double * dDataOut,
+	size_t sDataOutLength,
+	int nLevels,
+	int fParallel
+) {
+	return ApplyOfflineMapHandle(
+		pMap,
+		dDataIn, sDataInLength,
+		dDataOut, sDataOutLength,
+		nLevels, fParallel);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int OfflineMapApplyFloat(
+	const OfflineMapHandle * pMap,
+	const float * dDataIn,
+	size_t sDataInLength,
+	float * dDataOut,
+	size_t sDataOutLength,
+	int nLevels,
+	int fParallel
+) {
+	return ApplyOfflineMapHandle(
+		pMap,
+		dDataIn, sDataInLength,
+		dDataOut, sDataOutLength,
+		nLevels, fParallel);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const char * OfflineMapGetLastError() {
+	return s_strLastError.c_str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
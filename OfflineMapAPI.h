@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    OfflineMapAPI.h
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _OFFLINEMAPAPI_H_
+#define _OFFLINEMAPAPI_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		C interface for applying an offline map to data in memory, for
+///		models which remap fields online.  A map is loaded once with
+///		OfflineMapLoad and then applied to caller-owned arrays with layout
+///		[nLevels][ncol], without copying them, where ncol is the source or
+///		target size of the map.  Applying a map does not
+///		modify it, so the same map may be applied from several threads
+///		concurrently, each with fParallel set to 0.  Functions which return
+///		int return 0 on success; the message of the last error on the
+///		calling thread is returned by OfflineMapGetLastError.
+///	</summary>
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///	<summary>
+///		Opaque handle of a loaded offline map.
+///	</summary>
+typedef struct OfflineMapHandle OfflineMapHandle;
+
+///	<summary>
+///		Load an offline map from a NetCDF or binary map file.  Returns NULL
+///		on failure, including for maps whose grid dimensions do not cover
+///		all of their columns and rows.
+///	</summary>
+OfflineMapHandle * OfflineMapLoad(
+	const char * szMapFile
+);
+
+///	<summary>
+///		Release an offline map.
+///	</summary>
+void OfflineMapFree(
+	OfflineMapHandle * pMap
+);
+
+///	<summary>
+///		Number of degrees of freedom of the source grid (input ncol).
+///	</summary>
+int OfflineMapGetSourceSize(
+	const OfflineMapHandle * pMap
+);
+
+///	<summary>
+///		Number of degrees of freedom of the target grid (output ncol).
+///	</summary>
+int OfflineMapGetTargetSize(
+	const OfflineMapHandle * pMap
+);
+
+///	<summary>
+///		Remap nLevels slices of double precision data.  The lengths of
+///		dDataIn and dDataOut must be nLevels times the source and target
+///		size of the map.  If fParallel is nonzero the rows of the map are
+///		distributed over OpenMP threads.
+///	</summary>
+int OfflineMapApplyDouble(
+	const OfflineMapHandle * pMap,
+	const double * dDataIn,
+	size_t sDataInLength,
+	double * dDataOut,
+	size_t sDataOutLength,
+	int nLevels,
+	int fParallel
+);
+
+///	<summary>
+///		Remap nLevels slices of single precision data, with the array
+///		lengths of OfflineMapApplyDouble.  Sums are accumulated in double
+///		precision.
+///	</summary>
+int OfflineMapApplyFloat(
+	const OfflineMapHandle * pMap,
+	const float * dDataIn,
+	size_t sDataInLength,
+	float * dDataOut,
+	size_t sDataOutLength,
+	int nLevels,
+	int fParallel
+);
+
+///	<summary>
+///		Message of the last error on the calling thread, or an empty
+///		string if no error has occurred.
+///	</summary>
+const char * OfflineMapGetLastError();
+
+#ifdef __cplusplus
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
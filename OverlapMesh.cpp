@@ -23,12 +23,33 @@
 
 #include <unistd.h>
 #include <iostream>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef USE_MPI
+#include <mpi.h>
+#include <cstring>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
 #define VERBOSE
 
-//#define CHECK_AREAS
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number of Faces of the first mesh processed, overlap Faces
+///		generated, and Faces of the first mesh for which the mixed method
+///		fell back to exact arithmetic.
+///	</summary>
+static AnnounceCounter s_counterFirstFaces("overlap first mesh faces");
+static AnnounceCounter s_counterOverlapFaces("overlap faces");
+static AnnounceCounter s_counterExactFallbacks("exact arithmetic fallbacks");
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -125,9 +146,127 @@ typedef std::vector<PathSegment> PathSegmentVector;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		A key identifying a pair of Edges, the first from the first mesh
+///		and the second from the second mesh.
+///	</summary>
+typedef std::pair<Edge, Edge> EdgeIntersectionKey;
+
+///	<summary>
+///		The intersections between an Edge on the first mesh and an Edge
+///		on the second mesh, calculated along the direction in which the
+///		first Edge was first traversed and with the second Edge in
+///		ascending order of node indices.
+///	</summary>
+template <class NodeIntersectType>
+struct EdgeIntersection {
+
+	///	<summary>
+	///		True if the two Edges are coincident.
+	///	</summary>
+	bool fCoincident;
+
+	///	<summary>
+	///		Intersection Nodes, including any intersection at the first
+	///		node of the first Edge.
+	///	</summary>
+	std::vector<NodeIntersectType> nodeIntersections;
+
+	///	<summary>
+	///		Index of each intersection Node on the overlap mesh, or
+	///		InvalidNode if the Node has not yet been added.
+	///	</summary>
+	std::vector<int> vecOverlapNodeIx;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Temporary storage used by GeneratePath.  The buffers are cleared
+///		but not released between calls, so the path of each Face on the
+///		first mesh reuses the storage of the previous Face.
+///	</summary>
+template <class NodeIntersectType>
+struct GeneratePathBuffer {
+
+	///	<summary>
+	///		Location of the starting Node of the path.
+	///	</summary>
+	FindFaceStruct aFindFaceStruct;
+
+	///	<summary>
+	///		Location of the Edge crossed at a bifurcation of the path.
+	///	</summary>
+	FindFaceStruct aNextFindFaceStruct;
+
+	///	<summary>
+	///		Intersections of an Edge on the first mesh with an Edge on the
+	///		second mesh which has not been memoized.
+	///	</summary>
+	std::vector<NodeIntersectType> nodeEdgeIntersections;
+
+	///	<summary>
+	///		Remaining intersections of the current Edge on the first mesh
+	///		with the current Face on the second mesh, and the index of each
+	///		intersection in the memoized intersections.
+	///	</summary>
+	std::vector<NodeIntersectType> nodeIntersections;
+	std::vector<int> vecIntersectionIx;
+};
+
+///	<summary>
+///		Temporary storage used by GenerateOverlapFaces.  The buffers are
+///		cleared but not released between calls.
+///	</summary>
+struct GenerateOverlapFacesBuffer {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	GenerateOverlapFacesBuffer() :
+		nStamp(0)
+	{ }
+
+	///	<summary>
+	///		Flag indicating each PathSegment has been used.
+	///	</summary>
+	std::vector<bool> vecTracedPathUsed;
+
+	///	<summary>
+	///		Overlap Face under construction.
+	///	</summary>
+	Face faceOverlap;
+
+	///	<summary>
+	///		Stamp of the last call which added each Face on the second mesh
+	///		to the overlap mesh.
+	///	</summary>
+	std::vector<int> vecSecondFaceStamp;
+
+	///	<summary>
+	///		Stamp of the current call.
+	///	</summary>
+	int nStamp;
+
+	///	<summary>
+	///		Heap of Faces on the second mesh which are still to be added,
+	///		with the smallest index on top.  Faces may be repeated.
+	///	</summary>
+	std::vector<int> vecSecondFacesToAdd;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		Generate a PathSegmentVector describing the path around the face
-///		ixCurrentFirstFace.
+///		ixCurrentFirstFace.  New intersection Nodes are appended to
+///		meshOverlap and are indexed starting from nBaseOverlapNodes.
+///		The search for the starting face on meshSecond begins from
+///		ixSecondFaceHint, which is updated to the starting face.  Edge
+///		intersections are memoized in mapIntersections, so that the
+///		traversal of an Edge shared with a previous face reuses both the
+///		intersections and the intersection Nodes on meshOverlap.  All
+///		temporaries are stored in buffer.
 ///	</summary>
 template <
 	class MeshUtilities,
@@ -138,9 +277,20 @@ void GeneratePath(
 	const Mesh & meshSecond,
 	const std::vector<int> & vecSecondNodeMap,
 	int ixCurrentFirstFace,
+	int nBaseOverlapNodes,
+	int & ixSecondFaceHint,
+	std::map<
+		EdgeIntersectionKey,
+		EdgeIntersection<NodeIntersectType> > & mapIntersections,
+	GeneratePathBuffer<NodeIntersectType> & buffer,
 	PathSegmentVector & vecTracedPath,
 	Mesh & meshOverlap
 ) {
+	typedef
+		typename std::map<
+			EdgeIntersectionKey,
+			EdgeIntersection<NodeIntersectType> >::iterator
+		EdgeIntersectionIterator;
 
 	// MeshUtilities object
 	MeshUtilities utils;
@@ -159,10 +309,11 @@ void GeneratePath(
 		nodevecFirst[faceFirstCurrent[0]];
 
 	// Find the starting face on the second mesh
-	FindFaceStruct aFindFaceStruct;
+	FindFaceStruct & aFindFaceStruct = buffer.aFindFaceStruct;
 	utils.FindFaceFromNode(
 		meshSecond,
 		nodeCurrent,
+		ixSecondFaceHint,
 		aFindFaceStruct);
 
 	// No faces found
@@ -205,6 +356,8 @@ void GeneratePath(
 
 	}
 
+	ixSecondFaceHint = ixCurrentSecondFace;
+
 	// Starting information
 	printf("\nFaces: %i %i\n", ixCurrentFirstFace, ixCurrentSecondFace);
 #ifdef VERBOSE
@@ -229,6 +382,8 @@ void GeneratePath(
 		int ixOverlapNodeCurrent = edgeFirstCurrent[0];
 		Node nodeCurrent = nodevecFirst[ixOverlapNodeCurrent];
 
+		NodeIntersectType nodeFirstBeginX = nodeFirstBegin;
+
 		NodeIntersectType nodeLastIntersection = nodeFirstBegin;
 
 		// Repeat until we hit the end of this edge
@@ -253,7 +408,17 @@ void GeneratePath(
 			// Node or Edge.
 			int ixIntersectionSecondEdge;
 
-			std::vector<NodeIntersectType> nodeIntersections;
+			std::vector<NodeIntersectType> & nodeIntersections =
+				buffer.nodeIntersections;
+
+			nodeIntersections.clear();
+
+			// Index of each intersection in the memoized intersections
+			std::vector<int> & vecIntersectionIx = buffer.vecIntersectionIx;
+
+			vecIntersectionIx.clear();
+
+			EdgeIntersectionIterator iterIntersection;
 
 			for (int j = 0; j < faceSecondCurrent.edges.size(); j++) {
 				const Edge & edgeSecondCurrent =
@@ -277,58 +442,88 @@ void GeneratePath(
 
 				printf(" - - - \n");
 */
-				if (edgeSecondCurrent[0] < edgeSecondCurrent[1]) {
-					fCoincidentEdge =
-						utils.CalculateEdgeIntersections(
-							nodevecOverlap[edgeFirstCurrent[0]],
-							nodevecOverlap[edgeFirstCurrent[1]],
-							edgeFirstCurrent.type,
-							nodevecSecond[edgeSecondCurrent[0]],
-							nodevecSecond[edgeSecondCurrent[1]],
-							edgeSecondCurrent.type,
-							nodeIntersections);
-				} else {
-					fCoincidentEdge =
+				// Look up the intersections of the ordered Edges
+				int ixFirstNodeSmall;
+				int ixFirstNodeBig;
+				edgeFirstCurrent.GetOrderedNodes(
+					ixFirstNodeSmall, ixFirstNodeBig);
+
+				int ixSecondNodeSmall;
+				int ixSecondNodeBig;
+				edgeSecondCurrent.GetOrderedNodes(
+					ixSecondNodeSmall, ixSecondNodeBig);
+
+				EdgeIntersectionKey keyIntersection(
+					Edge(ixFirstNodeSmall, ixFirstNodeBig),
+					Edge(ixSecondNodeSmall, ixSecondNodeBig));
+
+				iterIntersection =
+					mapIntersections.lower_bound(keyIntersection);
+
+				// Intersections are calculated along the direction of the
+				// first traversal of edgeFirstCurrent and the ordered
+				// edgeSecondCurrent
+				if ((iterIntersection == mapIntersections.end()) ||
+					(mapIntersections.key_comp()(
+						keyIntersection, iterIntersection->first))
+				) {
+					bool fCoincident =
 						utils.CalculateEdgeIntersections(
-							nodevecOverlap[edgeFirstCurrent[0]],
-							nodevecOverlap[edgeFirstCurrent[1]],
+							nodevecFirst[edgeFirstCurrent[0]],
+							nodevecFirst[edgeFirstCurrent[1]],
 							edgeFirstCurrent.type,
-							nodevecSecond[edgeSecondCurrent[1]],
-							nodevecSecond[edgeSecondCurrent[0]],
+							nodevecSecond[ixSecondNodeSmall],
+							nodevecSecond[ixSecondNodeBig],
 							edgeSecondCurrent.type,
-							nodeIntersections);
+							buffer.nodeEdgeIntersections,
+							true);
+
+					iterIntersection =
+						mapIntersections.insert(
+							iterIntersection,
+							std::pair<
+								EdgeIntersectionKey,
+								EdgeIntersection<NodeIntersectType> >(
+									keyIntersection,
+									EdgeIntersection<NodeIntersectType>()));
+
+					EdgeIntersection<NodeIntersectType> & intersection =
+						iterIntersection->second;
+
+					intersection.fCoincident = fCoincident;
+					intersection.nodeIntersections =
+						buffer.nodeEdgeIntersections;
+					intersection.vecOverlapNodeIx.resize(
+						intersection.nodeIntersections.size(), InvalidNode);
 				}
 
-				for (int i = 0; i < nodeIntersections.size(); i++) {
-					bool fEqualNodes =
-						utils.AreNodesEqual(
-							nodeIntersections[i],
-							nodeLastIntersection);
-/*
-					nodeIntersections[i].Print("n0");
-					nodeLastIntersection.Print("l0");
-*/
-/*
-					meshOverlap.nodes[edgeFirstCurrent[1]].Print("f1");
-					nodeIntersections[i].Print("n0");
-					nodeLastIntersection.Print("l0");
-*/
-					if (fEqualNodes) {
-							nodeIntersections.erase(nodeIntersections.begin()+i);
-							i--;
+				fCoincidentEdge = iterIntersection->second.fCoincident;
+
+				// Remove the begin node of edgeFirstCurrent and the last
+				// intersection, keeping track of the cached index of each
+				// remaining intersection
+				nodeIntersections.clear();
+				vecIntersectionIx.clear();
+
+				for (int i = 0;
+					i < iterIntersection->second.nodeIntersections.size(); i++
+				) {
+					const NodeIntersectType & nodeIntersection =
+						iterIntersection->second.nodeIntersections[i];
+
+					if (utils.IsExcludedBeginNode(
+							nodeIntersection, nodeFirstBeginX)
+					) {
+						continue;
 					}
-/*
-						bool fBeginPoint =
-							utils.AreNodesEqual(
-								nodeIntersections[i],
-								meshOverlap.nodes[edgeFirstCurrent[0]]);
-
-						if (!fBeginPoint) {
-							nodeIntersections.erase(nodeIntersections.begin()+i);
-							i--;
-						}
+					if (utils.AreNodesEqual(
+							nodeIntersection, nodeLastIntersection)
+					) {
+						continue;
 					}
-*/
+
+					nodeIntersections.push_back(nodeIntersection);
+					vecIntersectionIx.push_back(i);
 				}
 
 				if (fCoincidentEdge) {
@@ -356,7 +551,7 @@ void GeneratePath(
 				utils.ContainsNode(
 					meshSecond.faces[ixCurrentSecondFace],
 					meshSecond.nodes,
-					nodevecOverlap[edgeFirstCurrent[1]],
+					nodevecFirst[edgeFirstCurrent[1]],
 					loc,
 					ixLocation);
 
@@ -435,7 +630,7 @@ void GeneratePath(
 			utils.ContainsNode(
 				meshSecond.faces[ixCurrentSecondFace],
 				meshSecond.nodes,
-				nodevecOverlap[edgeFirstCurrent[1]],
+				nodevecFirst[edgeFirstCurrent[1]],
 				loc0,
 				ixLocation0);
 
@@ -534,13 +729,12 @@ void GeneratePath(
 				} else {
 					const FacePair & facepair = iter->second;
 
-					// Find the set of possible Faces
-					std::vector<int> vecPossibleFaces;
-					vecPossibleFaces.push_back(facepair[0]);
-					vecPossibleFaces.push_back(facepair[1]);
-
 					// Build the FindFaceStruct
-					FindFaceStruct aNextFindFaceStruct;
+					FindFaceStruct & aNextFindFaceStruct =
+						buffer.aNextFindFaceStruct;
+
+					aNextFindFaceStruct.vecFaceIndices.clear();
+					aNextFindFaceStruct.vecFaceLocations.clear();
 
 					aNextFindFaceStruct.vecFaceIndices.push_back(facepair[0]);
 					aNextFindFaceStruct.vecFaceIndices.push_back(facepair[1]);
@@ -681,11 +875,25 @@ void GeneratePath(
 			// General intersection between edgeFirstCurrent and
 			// edgeSecondCurrent.
 			} else {
-				// Push a new intersection into the array of nodes
-				ixOverlapNodeNext =
-					static_cast<int>(meshOverlap.nodes.size());
+				// Reuse the intersection Node if this intersection has
+				// already been traversed, otherwise push a new
+				// intersection into the array of nodes
+				int & ixIntersectionNode =
+					iterIntersection->second.vecOverlapNodeIx[
+						vecIntersectionIx[0]];
+
+				if (ixIntersectionNode != InvalidNode) {
+					ixOverlapNodeNext = ixIntersectionNode;
 
-				nodevecOverlap.push_back((Node)(nodeIntersections[0]));
+				} else {
+					ixOverlapNodeNext =
+						nBaseOverlapNodes
+						+ static_cast<int>(meshOverlap.nodes.size());
+
+					nodevecOverlap.push_back((Node)(nodeIntersections[0]));
+
+					ixIntersectionNode = ixOverlapNodeNext;
+				}
 /*
 				NodeMap::const_iterator iterNodeMap =
 					mapOverlapNodes.find((Node)(nodeIntersections[0]));
@@ -724,10 +932,6 @@ void GeneratePath(
 
 				int ixPrevSecondFace = ixCurrentSecondFace;
 
-				std::vector<int> vecPossibleFaces;
-				vecPossibleFaces.push_back(facepair[0]);
-				vecPossibleFaces.push_back(facepair[1]);
-
 				// Face always changes across GreatCircleArcs
 				if ((edgeFirstCurrent.type == Edge::Type_GreatCircleArc) &&
 					(edgeSecondCurrent.type == Edge::Type_GreatCircleArc)
@@ -801,25 +1005,37 @@ bool GenerateOverlapFaces(
 	const std::vector<int> & vecSecondNodeMap,
 	const PathSegmentVector & vecTracedPath,
 	int ixCurrentFirstFace,
+	GenerateOverlapFacesBuffer & buffer,
 	Mesh & meshOverlap
 ) {
 
 	// Array indicating which elements of vecTracedPath have been used
-	std::vector<bool> vecTracedPathUsed;
-	vecTracedPathUsed.resize(vecTracedPath.size(), false);
+	std::vector<bool> & vecTracedPathUsed = buffer.vecTracedPathUsed;
+	vecTracedPathUsed.assign(vecTracedPath.size(), false);
+
+	// Faces from the Second mesh that have been added are marked with
+	// the stamp of this call
+	std::vector<int> & vecSecondFaceStamp = buffer.vecSecondFaceStamp;
+	if (vecSecondFaceStamp.size() != meshSecond.faces.size()) {
+		vecSecondFaceStamp.assign(meshSecond.faces.size(), 0);
+		buffer.nStamp = 0;
+	}
+
+	buffer.nStamp++;
+
+	const int nStamp = buffer.nStamp;
 
-	// The set of interior faces (from the Second mesh)
-	std::set<int> setSecondFacesAdded;
 	for (int j = 0; j < vecTracedPath.size(); j++) {
-		setSecondFacesAdded.insert(vecTracedPath[j].ixSecondFace);
+		vecSecondFaceStamp[vecTracedPath[j].ixSecondFace] = nStamp;
 
 #ifdef VERBOSE
 		printf("%i %i : %i\n", vecTracedPath[j][0], vecTracedPath[j][1], vecTracedPath[j].ixSecondFace);
 #endif
 	}
 
-	// Set of faces from meshSecond that should be added
-	std::set<int> setSecondFacesToAdd;
+	// Heap of faces from meshSecond that should be added
+	std::vector<int> & vecSecondFacesToAdd = buffer.vecSecondFacesToAdd;
+	vecSecondFacesToAdd.clear();
 
 	// Loop through all possible starting PathSegments
 	for (int j = 0; j < vecTracedPath.size(); j++) {
@@ -830,7 +1046,8 @@ bool GenerateOverlapFaces(
 		}
 
 		// Build the new face
-		Face faceOverlap(0);
+		Face & faceOverlap = buffer.faceOverlap;
+		faceOverlap.edges.clear();
 
 		// Origin node of this fac
 		int ixOverlapOriginNode = vecTracedPath[j][0];
@@ -963,12 +1180,16 @@ bool GenerateOverlapFaces(
 				const FacePair & facepair = iter->second;
 
 				if (facepair[0] == ixCurrentSecondFace) {
-					setSecondFacesToAdd.insert(facepair[1]);
+					vecSecondFacesToAdd.push_back(facepair[1]);
 				} else if (facepair[1] == ixCurrentSecondFace) {
-					setSecondFacesToAdd.insert(facepair[0]);
+					vecSecondFacesToAdd.push_back(facepair[0]);
 				} else {
 					_EXCEPTIONT("Logic error");
 				}
+				std::push_heap(
+					vecSecondFacesToAdd.begin(),
+					vecSecondFacesToAdd.end(),
+					std::greater<int>());
 
 				// An exit node is found
 				if (ixExitNode != InvalidNode) {
@@ -1066,35 +1287,36 @@ ContinueToNextFace:
 	///////////////////////////////////////////////////////////////////////
 	// Find interior faces from meshSecond to add to meshOverlap
 
-	// Remove added faces from set of faces to add
-	std::set<int>::iterator iterToAdd;
-	std::set<int>::iterator iterAdded = setSecondFacesAdded.begin();
-	for (; iterAdded != setSecondFacesAdded.end(); iterAdded++) {
-		iterToAdd = setSecondFacesToAdd.find(*iterAdded);
-
-		if (iterToAdd != setSecondFacesToAdd.end()) {
-			setSecondFacesToAdd.erase(iterToAdd);
-		}
-	}
-
+	// Faces are taken from the heap in ascending order; faces which have
+	// already been added are skipped
 	for (;;) {
 
-		// Take the next Face from the ToAdd set
-		if (setSecondFacesToAdd.size() == 0) {
+		// Take the next Face from the heap
+		if (vecSecondFacesToAdd.size() == 0) {
 			break;
 		}
 
-		iterToAdd = setSecondFacesToAdd.begin();
+		std::pop_heap(
+			vecSecondFacesToAdd.begin(),
+			vecSecondFacesToAdd.end(),
+			std::greater<int>());
+
+		int ixFaceToAdd = vecSecondFacesToAdd.back();
 
-		int ixFaceToAdd = *iterToAdd;
+		vecSecondFacesToAdd.pop_back();
+
+		if (vecSecondFaceStamp[ixFaceToAdd] == nStamp) {
+			continue;
+		}
 
-		setSecondFacesToAdd.erase(iterToAdd);
-		setSecondFacesAdded.insert(ixFaceToAdd);
+		vecSecondFaceStamp[ixFaceToAdd] = nStamp;
 
 		const Face & faceSecondCurrent = meshSecond.faces[ixFaceToAdd];
 
 		// Add this face to meshOverlap
-		Face faceOverlapCurrent(faceSecondCurrent.edges.size());
+		meshOverlap.faces.push_back(faceSecondCurrent);
+
+		Face & faceOverlapCurrent = meshOverlap.faces.back();
 
 		for (int i = 0; i < faceOverlapCurrent.edges.size(); i++) {
 			faceOverlapCurrent.edges[i][0] =
@@ -1103,11 +1325,7 @@ ContinueToNextFace:
 			faceOverlapCurrent.edges[i][1] =
 				//faceSecondCurrent.edges[i][1];
 				vecSecondNodeMap[faceSecondCurrent.edges[i][1]];
-			faceOverlapCurrent.edges[i].type =
-				faceSecondCurrent.edges[i].type;
 		}
-
-		meshOverlap.faces.push_back(faceOverlapCurrent);
 		meshOverlap.vecFirstFaceIx.push_back(ixCurrentFirstFace);
 		meshOverlap.vecSecondFaceIx.push_back(ixFaceToAdd);
 
@@ -1138,10 +1356,12 @@ ContinueToNextFace:
 				_EXCEPTIONT("EdgeMap consistency error");
 			}
 
-			if (setSecondFacesAdded.find(ixOtherFace) ==
-				setSecondFacesAdded.end()
-			) {
-				setSecondFacesToAdd.insert(ixOtherFace);
+			if (vecSecondFaceStamp[ixOtherFace] != nStamp) {
+				vecSecondFacesToAdd.push_back(ixOtherFace);
+				std::push_heap(
+					vecSecondFacesToAdd.begin(),
+					vecSecondFacesToAdd.end(),
+					std::greater<int>());
 				fMoreFacesToAdd = true;
 			}
 		}
@@ -1152,66 +1372,240 @@ ContinueToNextFace:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void GenerateOverlapMesh(
-	const Mesh & meshFirst,
-	const Mesh & meshSecond,
-	Mesh & meshOverlap,
-	OverlapMeshMethod method
-) {
-	meshOverlap.Clear();
+///	<summary>
+///		The overlap Faces generated for a set of Faces on the first mesh.
+///		Only new intersection Nodes are stored in the fragment mesh, and
+///		these are indexed starting from the number of Nodes shared by all
+///		fragments.
+///	</summary>
+struct OverlapFragment {
 
-	// Get the two NodeVectors
-	const NodeVector & nodevecFirst = meshFirst.nodes;
-	const NodeVector & nodevecSecond = meshSecond.nodes;
-	const NodeVector & nodevecOverlap = meshOverlap.nodes;
+	///	<summary>
+	///		Intersection Nodes and overlap Faces of this fragment.
+	///	</summary>
+	Mesh mesh;
 
-	// Check for coincident Nodes between meshFirst and meshSecond
-	std::vector<int> vecSecondNodeMap;
+	///	<summary>
+	///		Index of the first overlap Face and first intersection Node
+	///		associated with each first mesh Face in this fragment.
+	///	</summary>
+	std::vector<int> vecFaceBegin;
+	std::vector<int> vecNodeBegin;
 
-	int nCoincidentNodes =
-		BuildCoincidentNodeVector(
-			meshFirst, meshSecond, vecSecondNodeMap);
+	///	<summary>
+	///		The pair of Edges whose intersection generated each Node of
+	///		the fragment mesh.
+	///	</summary>
+	std::vector<EdgeIntersectionKey> vecNodeKeys;
 
-	Announce("Number of coincident nodes between mesh A and B [%i]",
-		nCoincidentNodes);
+	///	<summary>
+	///		Number of first mesh Faces not yet merged into the overlap mesh.
+	///	</summary>
+	int nUnmergedFaces;
 
-	// Insert all nodes from the two NodeVectors
-	for (int i = 0; i < nodevecFirst.size(); i++) {
-		meshOverlap.nodes.push_back(nodevecFirst[i]);
-		//mapOverlapNodes.insert(NodeMap::value_type(nodevecFirst[i], i));
+	///	<summary>
+	///		Error message if generation of this fragment failed.
+	///	</summary>
+	std::string strError;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute the index of the cell (ix, iy) along a Hilbert curve
+///		covering a grid of 2^Order by 2^Order cells.
+///	</summary>
+unsigned int HilbertCurveIndex(
+	unsigned int ix,
+	unsigned int iy
+) {
+	static const int Order = 16;
+
+	unsigned int d = 0;
+	for (unsigned int s = (1u << (Order - 1)); s > 0; s /= 2) {
+		unsigned int rx = ((ix & s) > 0)?(1):(0);
+		unsigned int ry = ((iy & s) > 0)?(1):(0);
+
+		d += s * s * ((3 * rx) ^ ry);
+
+		// Rotate the quadrant
+		if (ry == 0) {
+			if (rx == 1) {
+				ix = s - 1 - ix;
+				iy = s - 1 - iy;
+			}
+			unsigned int t = ix;
+			ix = iy;
+			iy = t;
+		}
 	}
+	return d;
+}
 
-	for (int i = 0; i < nodevecSecond.size(); i++) {
-		if (vecSecondNodeMap[i] == InvalidNode) {
-			int ix = static_cast<int>(meshOverlap.nodes.size());
-			meshOverlap.nodes.push_back(nodevecSecond[i]);
-			//mapOverlapNodes.insert(NodeMap::value_type(nodevecSecond[i], ix));
-			vecSecondNodeMap[i] = ix;
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Order the Faces of a mesh along a Hilbert curve on each panel of
+///		the cube which circumscribes the sphere.
+///	</summary>
+void GetSpaceFillingCurveOrder(
+	const Mesh & mesh,
+	std::vector<int> & vecFaceOrder
+) {
+	static const Real GridCells = 65536.0;
+
+	std::vector< std::pair<unsigned long long, int> > vecKeys;
+	vecKeys.resize(mesh.faces.size());
+
+	for (int i = 0; i < mesh.faces.size(); i++) {
+		const Face & face = mesh.faces[i];
+
+		// Centroid of the Face
+		Node nodeCentroid;
+		for (int k = 0; k < face.edges.size(); k++) {
+			const Node & node = mesh.nodes[face[k]];
+			nodeCentroid.x += node.x;
+			nodeCentroid.y += node.y;
+			nodeCentroid.z += node.z;
 		}
+
+		// Project onto the panel of the cube
+		Real dAbsX = fabs(nodeCentroid.x);
+		Real dAbsY = fabs(nodeCentroid.y);
+		Real dAbsZ = fabs(nodeCentroid.z);
+
+		int iPanel;
+		Real dA;
+		Real dB;
+
+		if ((dAbsX >= dAbsY) && (dAbsX >= dAbsZ)) {
+			iPanel = (nodeCentroid.x > 0.0)?(0):(1);
+			dA = nodeCentroid.y / dAbsX;
+			dB = nodeCentroid.z / dAbsX;
+		} else if (dAbsY >= dAbsZ) {
+			iPanel = (nodeCentroid.y > 0.0)?(2):(3);
+			dA = nodeCentroid.x / dAbsY;
+			dB = nodeCentroid.z / dAbsY;
+		} else if (dAbsZ > 0.0) {
+			iPanel = (nodeCentroid.z > 0.0)?(4):(5);
+			dA = nodeCentroid.x / dAbsZ;
+			dB = nodeCentroid.y / dAbsZ;
+		} else {
+			iPanel = 0;
+			dA = 0.0;
+			dB = 0.0;
+		}
+
+		Real dCellA = floor(0.5 * (dA + 1.0) * GridCells);
+		Real dCellB = floor(0.5 * (dB + 1.0) * GridCells);
+
+		unsigned int ixA = static_cast<unsigned int>(
+			std::max(0.0, std::min(GridCells - 1.0, dCellA)));
+		unsigned int ixB = static_cast<unsigned int>(
+			std::max(0.0, std::min(GridCells - 1.0, dCellB)));
+
+		unsigned long long iKey =
+			(static_cast<unsigned long long>(iPanel) << 32)
+			+ static_cast<unsigned long long>(HilbertCurveIndex(ixA, ixB));
+
+		vecKeys[i] = std::pair<unsigned long long, int>(iKey, i);
 	}
-/*
-	// Estimate meshOverlap size
-	int nMaximumFaceCount;
-	if (meshFirst.faces.size() > meshSecond.faces.size()) {
-		nMaximumFaceCount = static_cast<int>(meshFirst.faces.size());
-	} else {
-		nMaximumFaceCount = static_cast<int>(meshSecond.faces.size());
+
+	std::sort(vecKeys.begin(), vecKeys.end());
+
+	vecFaceOrder.resize(mesh.faces.size());
+	for (int i = 0; i < vecKeys.size(); i++) {
+		vecFaceOrder[i] = vecKeys[i].second;
 	}
-	meshOverlap.faces.reserve(2 * nMaximumFaceCount);
-*/
-	// Loop through all Faces on the first Mesh
-	int ixCurrentFirstFace = 0;
+}
 
-#pragma message "OpenMP here"
-	for (; ixCurrentFirstFace < meshFirst.faces.size(); ixCurrentFirstFace++) {
-	//for (int ixCurrentFirstFace = 320; ixCurrentFirstFace < 321; ixCurrentFirstFace++) {
+///////////////////////////////////////////////////////////////////////////////
 
-#ifdef CHECK_AREAS
-		Real dFirstFaceArea = meshFirst.CalculateFaceArea(ixCurrentFirstFace);
-#endif
+///	<summary>
+///		Record the EdgeIntersectionKey of all intersection Nodes in
+///		mapIntersections with index less than nBaseOverlapNodes + nNodes.
+///	</summary>
+template <class NodeIntersectType>
+void GetIntersectionNodeKeys(
+	const std::map<
+		EdgeIntersectionKey,
+		EdgeIntersection<NodeIntersectType> > & mapIntersections,
+	int nBaseOverlapNodes,
+	int nNodes,
+	std::vector<EdgeIntersectionKey> & vecNodeKeys
+) {
+	typename std::map<
+		EdgeIntersectionKey,
+		EdgeIntersection<NodeIntersectType> >::const_iterator
+			iter = mapIntersections.begin();
+
+	for (; iter != mapIntersections.end(); iter++) {
+		const std::vector<int> & vecOverlapNodeIx =
+			iter->second.vecOverlapNodeIx;
+
+		for (int i = 0; i < vecOverlapNodeIx.size(); i++) {
+			int ixNode = vecOverlapNodeIx[i] - nBaseOverlapNodes;
+			if ((ixNode >= 0) && (ixNode < nNodes)) {
+				vecNodeKeys[ixNode] = iter->first;
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap Faces associated with the Faces of meshFirst
+///		listed in vecFirstFaces, in the given order.
+///	</summary>
+void GenerateOverlapFragment(
+	const Mesh & meshFirst,
+	const Mesh & meshSecond,
+	const std::vector<int> & vecSecondNodeMap,
+	OverlapMeshMethod method,
+	const std::vector<int> & vecFirstFaces,
+	int nBaseOverlapNodes,
+	OverlapFragment & fragment
+) {
+	Mesh & meshFragment = fragment.mesh;
+
+	meshFragment.Clear();
+	meshFragment.vecFirstFaceIx.clear();
+	meshFragment.vecSecondFaceIx.clear();
+
+	fragment.vecFaceBegin.resize(vecFirstFaces.size() + 1);
+	fragment.vecNodeBegin.resize(vecFirstFaces.size() + 1);
+	fragment.nUnmergedFaces = static_cast<int>(vecFirstFaces.size());
+	fragment.strError = "";
+
+	// Starting face on meshSecond, carried over from the previous Face
+	int ixSecondFaceHint = InvalidFace;
+
+	// Memoized Edge intersections
+	std::map<EdgeIntersectionKey, EdgeIntersection<Node> >
+		mapIntersectionsFuzzy;
+
+	std::map<EdgeIntersectionKey, EdgeIntersection<NodeExact> >
+		mapIntersectionsExact;
+
+	// Temporaries reused by all Faces of this fragment
+	GeneratePathBuffer<Node> bufferPathFuzzy;
+	GeneratePathBuffer<NodeExact> bufferPathExact;
+	GenerateOverlapFacesBuffer bufferFaces;
+
+	PathSegmentVector vecTracedPath;
+
+	fragment.vecNodeKeys.clear();
+
+	for (int f = 0; f < vecFirstFaces.size(); f++) {
+
+		int ixCurrentFirstFace = vecFirstFaces[f];
+
+		fragment.vecFaceBegin[f] = meshFragment.faces.size();
+		fragment.vecNodeBegin[f] = meshFragment.nodes.size();
 
 		// Generate the path
-		PathSegmentVector vecTracedPath;
+		vecTracedPath.clear();
 
 		// Fuzzy arithmetic (standard floating point operations)
 		if (method == OverlapMeshMethod_Fuzzy) {
@@ -1220,8 +1614,12 @@ void GenerateOverlapMesh(
 				meshSecond,
 				vecSecondNodeMap,
 				ixCurrentFirstFace,
+				nBaseOverlapNodes,
+				ixSecondFaceHint,
+				mapIntersectionsFuzzy,
+				bufferPathFuzzy,
 				vecTracedPath,
-				meshOverlap
+				meshFragment
 			);
 
 			GenerateOverlapFaces(
@@ -1229,7 +1627,8 @@ void GenerateOverlapMesh(
 				vecSecondNodeMap,
 				vecTracedPath,
 				ixCurrentFirstFace,
-				meshOverlap
+				bufferFaces,
+				meshFragment
 			);
 		}
 
@@ -1240,8 +1639,12 @@ void GenerateOverlapMesh(
 				meshSecond,
 				vecSecondNodeMap,
 				ixCurrentFirstFace,
+				nBaseOverlapNodes,
+				ixSecondFaceHint,
+				mapIntersectionsExact,
+				bufferPathExact,
 				vecTracedPath,
-				meshOverlap
+				meshFragment
 			);
 
 			GenerateOverlapFaces(
@@ -1249,15 +1652,16 @@ void GenerateOverlapMesh(
 				vecSecondNodeMap,
 				vecTracedPath,
 				ixCurrentFirstFace,
-				meshOverlap
+				bufferFaces,
+				meshFragment
 			);
 
 		}
 
 		// Mixed method; try Fuzzy arithmetic first
 		if (method == OverlapMeshMethod_Mixed) {
-			int nInitialOverlapNodes = meshOverlap.nodes.size();
-			int nInitialOverlapFaces = meshOverlap.faces.size();
+			int nInitialOverlapNodes = meshFragment.nodes.size();
+			int nInitialOverlapFaces = meshFragment.faces.size();
 
 			try {
 				GeneratePath<MeshUtilitiesFuzzy, Node>(
@@ -1265,8 +1669,12 @@ void GenerateOverlapMesh(
 					meshSecond,
 					vecSecondNodeMap,
 					ixCurrentFirstFace,
+					nBaseOverlapNodes,
+					ixSecondFaceHint,
+					mapIntersectionsFuzzy,
+					bufferPathFuzzy,
 					vecTracedPath,
-					meshOverlap
+					meshFragment
 				);
 
 				GenerateOverlapFaces(
@@ -1274,28 +1682,46 @@ void GenerateOverlapMesh(
 					vecSecondNodeMap,
 					vecTracedPath,
 					ixCurrentFirstFace,
-					meshOverlap
+					bufferFaces,
+					meshFragment
 				);
 
 			} catch(Exception & e) {
+				s_counterExactFallbacks.Add(1);
+
 				printf("WARNING: Fuzzy arithmetic operations failed "
 					"with message:\n  \"%s\"\n  Trying exact arithmetic",
 					e.ToString().c_str());
 
 				vecTracedPath.clear();
 
-				meshOverlap.nodes.resize(nInitialOverlapNodes);
-				meshOverlap.faces.resize(nInitialOverlapFaces);
-				meshOverlap.vecFirstFaceIx.resize(nInitialOverlapFaces);
-				meshOverlap.vecSecondFaceIx.resize(nInitialOverlapFaces);
+				meshFragment.nodes.resize(nInitialOverlapNodes);
+				meshFragment.faces.resize(nInitialOverlapFaces);
+				meshFragment.vecFirstFaceIx.resize(nInitialOverlapFaces);
+				meshFragment.vecSecondFaceIx.resize(nInitialOverlapFaces);
+
+				// Memoized intersections may refer to removed Nodes
+				fragment.vecNodeKeys.resize(nInitialOverlapNodes);
+
+				GetIntersectionNodeKeys(
+					mapIntersectionsFuzzy,
+					nBaseOverlapNodes,
+					nInitialOverlapNodes,
+					fragment.vecNodeKeys);
+
+				mapIntersectionsFuzzy.clear();
 
 				GeneratePath<MeshUtilitiesExact, NodeExact>(
 					meshFirst,
 					meshSecond,
 					vecSecondNodeMap,
 					ixCurrentFirstFace,
+					nBaseOverlapNodes,
+					ixSecondFaceHint,
+					mapIntersectionsExact,
+					bufferPathExact,
 					vecTracedPath,
-					meshOverlap
+					meshFragment
 				);
 
 				GenerateOverlapFaces(
@@ -1303,38 +1729,1107 @@ void GenerateOverlapMesh(
 					vecSecondNodeMap,
 					vecTracedPath,
 					ixCurrentFirstFace,
-					meshOverlap
+					bufferFaces,
+					meshFragment
 				);
 			}
 		}
 
-#ifdef CHECK_AREAS
-		int nMeshOverlapPrevFaces = meshOverlap.faces.size();
-#endif
-
-#ifdef CHECK_AREAS
-		int nMeshOverlapCurrentFaces = meshOverlap.faces.size();
-
-		Real dOverlapAreas = 0.0;
-		for (int i = nMeshOverlapPrevFaces; i < nMeshOverlapCurrentFaces; i++) {
-			dOverlapAreas += meshOverlap.CalculateFaceArea(i);
-		}
-
-		if (fabs(dOverlapAreas - dFirstFaceArea) > ReferenceTolerance) {
-			printf("Area inconsistency (%i : %1.15e %1.15e)\n",
-				ixCurrentFirstFace,
-				dFirstFaceArea,
-				dOverlapAreas);
-			_EXCEPTION();
-		}
-#endif
-
 /*
 		if (!fSuccess) {
 			_EXCEPTIONT("OverlapMesh generation failed");
 		}
 */
 	}
+
+	fragment.vecFaceBegin[vecFirstFaces.size()] = meshFragment.faces.size();
+	fragment.vecNodeBegin[vecFirstFaces.size()] = meshFragment.nodes.size();
+
+	s_counterFirstFaces.Add(vecFirstFaces.size());
+	s_counterOverlapFaces.Add(meshFragment.faces.size());
+
+	// Keys of all intersection Nodes in this fragment
+	int nFragmentNodes = static_cast<int>(meshFragment.nodes.size());
+
+	fragment.vecNodeKeys.resize(nFragmentNodes);
+
+	GetIntersectionNodeKeys(
+		mapIntersectionsFuzzy,
+		nBaseOverlapNodes,
+		nFragmentNodes,
+		fragment.vecNodeKeys);
+
+	GetIntersectionNodeKeys(
+		mapIntersectionsExact,
+		nBaseOverlapNodes,
+		nFragmentNodes,
+		fragment.vecNodeKeys);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append the overlap Faces and intersection Nodes associated with
+///		the f-th first mesh Face of a fragment to meshOverlap, remapping
+///		the indices of intersection Nodes.  Nodes generated by an
+///		intersection already present in mapOverlapNodes are not
+///		duplicated.  The first nFlushedNodes Nodes of the overlap mesh
+///		have already been removed from meshOverlap.
+///	</summary>
+void AppendOverlapFragment(
+	const OverlapFragment & fragment,
+	int f,
+	int nBaseOverlapNodes,
+	int nFlushedNodes,
+	std::map<EdgeIntersectionKey, int> & mapOverlapNodes,
+	Mesh & meshOverlap
+) {
+	const Mesh & meshFragment = fragment.mesh;
+
+	int ixFaceBegin = fragment.vecFaceBegin[f];
+	int ixFaceEnd = fragment.vecFaceBegin[f+1];
+
+	int ixNodeBegin = fragment.vecNodeBegin[f];
+	int ixNodeEnd = fragment.vecNodeBegin[f+1];
+
+	// Invalid key, used for Nodes which are not associated with an
+	// intersection
+	const EdgeIntersectionKey keyInvalid;
+
+	// Add intersection Nodes
+	std::vector<int> vecNodeMap;
+	vecNodeMap.resize(ixNodeEnd - ixNodeBegin);
+
+	for (int i = ixNodeBegin; i < ixNodeEnd; i++) {
+		const EdgeIntersectionKey & key = fragment.vecNodeKeys[i];
+
+		bool fValidKey =
+			(key.first[0] != keyInvalid.first[0]) ||
+			(key.first[1] != keyInvalid.first[1]);
+
+		if (fValidKey) {
+			std::map<EdgeIntersectionKey, int>::const_iterator iter =
+				mapOverlapNodes.find(key);
+
+			if (iter != mapOverlapNodes.end()) {
+				vecNodeMap[i - ixNodeBegin] = iter->second;
+				continue;
+			}
+		}
+
+		int ixNode =
+			nFlushedNodes + static_cast<int>(meshOverlap.nodes.size());
+
+		meshOverlap.nodes.push_back(meshFragment.nodes[i]);
+
+		if (fValidKey) {
+			mapOverlapNodes.insert(
+				std::pair<EdgeIntersectionKey, int>(key, ixNode));
+		}
+
+		vecNodeMap[i - ixNodeBegin] = ixNode;
+	}
+
+	// Add Faces
+	int ixOverlapFaceBegin = static_cast<int>(meshOverlap.faces.size());
+
+	meshOverlap.faces.insert(
+		meshOverlap.faces.end(),
+		meshFragment.faces.begin() + ixFaceBegin,
+		meshFragment.faces.begin() + ixFaceEnd);
+
+	for (int i = ixOverlapFaceBegin; i < meshOverlap.faces.size(); i++) {
+		Face & face = meshOverlap.faces[i];
+		for (int k = 0; k < face.edges.size(); k++) {
+			for (int m = 0; m < 2; m++) {
+				int ixNode = face.edges[k][m] - nBaseOverlapNodes;
+				if (ixNode < 0) {
+					continue;
+				}
+				if ((ixNode >= ixNodeBegin) && (ixNode < ixNodeEnd)) {
+					face.edges[k][m] = vecNodeMap[ixNode - ixNodeBegin];
+					continue;
+				}
+
+				// Intersection Node shared with another Face of this
+				// fragment, which may not yet have been merged
+				const EdgeIntersectionKey & key = fragment.vecNodeKeys[ixNode];
+
+				if ((key.first[0] == keyInvalid.first[0]) &&
+					(key.first[1] == keyInvalid.first[1])
+				) {
+					_EXCEPTIONT("Overlap Face refers to Node of another Face");
+				}
+
+				std::map<EdgeIntersectionKey, int>::const_iterator iter =
+					mapOverlapNodes.find(key);
+
+				if (iter != mapOverlapNodes.end()) {
+					face.edges[k][m] = iter->second;
+
+				} else {
+					face.edges[k][m] = nFlushedNodes
+						+ static_cast<int>(meshOverlap.nodes.size());
+
+					meshOverlap.nodes.push_back(meshFragment.nodes[ixNode]);
+
+					mapOverlapNodes.insert(
+						std::pair<EdgeIntersectionKey, int>(
+							key, face.edges[k][m]));
+				}
+			}
+		}
+	}
+
+	meshOverlap.vecFirstFaceIx.insert(
+		meshOverlap.vecFirstFaceIx.end(),
+		meshFragment.vecFirstFaceIx.begin() + ixFaceBegin,
+		meshFragment.vecFirstFaceIx.begin() + ixFaceEnd);
+
+	meshOverlap.vecSecondFaceIx.insert(
+		meshOverlap.vecSecondFaceIx.end(),
+		meshFragment.vecSecondFaceIx.begin() + ixFaceBegin,
+		meshFragment.vecSecondFaceIx.begin() + ixFaceEnd);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Write all Nodes and Faces of meshOverlap to writer and remove them
+///		from meshOverlap.  Intersection Nodes on edges of meshFirst whose
+///		adjacent Faces have all been merged can no longer be shared and
+///		are removed from mapOverlapNodes.
+///	</summary>
+void FlushOverlapBlock(
+	const Mesh & meshFirst,
+	int ixNextMergeFace,
+	int & nFlushedNodes,
+	std::map<EdgeIntersectionKey, int> & mapOverlapNodes,
+	Mesh & meshOverlap,
+	MeshStreamWriter & writer
+) {
+	writer.WriteNodes(meshOverlap.nodes);
+	writer.WriteFaces(meshOverlap);
+
+	nFlushedNodes += static_cast<int>(meshOverlap.nodes.size());
+
+	meshOverlap.nodes.clear();
+	meshOverlap.faces.clear();
+	meshOverlap.vecFirstFaceIx.clear();
+	meshOverlap.vecSecondFaceIx.clear();
+
+	// Without an EdgeMap all intersection Nodes are retained
+	if (meshFirst.edgemap.size() == 0) {
+		return;
+	}
+
+	std::map<EdgeIntersectionKey, int>::iterator iter =
+		mapOverlapNodes.begin();
+
+	while (iter != mapOverlapNodes.end()) {
+		EdgeMapConstIterator iterEdge =
+			meshFirst.edgemap.find(iter->first.first);
+
+		if ((iterEdge != meshFirst.edgemap.end()) &&
+			(iterEdge->second[0] < ixNextMergeFace) &&
+			(iterEdge->second[1] < ixNextMergeFace)
+		) {
+			mapOverlapNodes.erase(iter++);
+		} else {
+			iter++;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Merge the fragments of all completed Faces of meshFirst into
+///		meshOverlap in order, beginning from ixNextMergeFace, and write out
+///		each completed block of nBlockFaces Faces if pWriter is not NULL.
+///	</summary>
+void MergeOverlapFragments(
+	const Mesh & meshFirst,
+	const std::vector<bool> & vecFirstFaceDone,
+	const std::vector<int> & vecFirstFaceFragment,
+	const std::vector<int> & vecFirstFaceFragmentIx,
+	int nBaseOverlapNodes,
+	std::vector<OverlapFragment> & vecFragments,
+	int & ixNextMergeFace,
+	int & nFlushedNodes,
+	std::map<EdgeIntersectionKey, int> & mapOverlapNodes,
+	Mesh & meshOverlap,
+	MeshStreamWriter * pWriter,
+	int nBlockFaces
+) {
+	int nFirstFaces = static_cast<int>(meshFirst.faces.size());
+
+	for (; ixNextMergeFace < nFirstFaces; ixNextMergeFace++) {
+		if (!vecFirstFaceDone[ixNextMergeFace]) {
+			break;
+		}
+
+		// Faces which are not traversed have no overlap Faces
+		if (vecFirstFaceFragment[ixNextMergeFace] != (-1)) {
+			OverlapFragment & fragment =
+				vecFragments[vecFirstFaceFragment[ixNextMergeFace]];
+
+			AppendOverlapFragment(
+				fragment,
+				vecFirstFaceFragmentIx[ixNextMergeFace],
+				nBaseOverlapNodes,
+				nFlushedNodes,
+				mapOverlapNodes,
+				meshOverlap);
+
+			// Release fragments once all of their Faces have been merged
+			fragment.nUnmergedFaces--;
+			if (fragment.nUnmergedFaces == 0) {
+				fragment.mesh = Mesh();
+				fragment.vecFaceBegin.clear();
+				fragment.vecNodeBegin.clear();
+				fragment.vecNodeKeys.clear();
+			}
+		}
+
+		// Write out each completed block
+		if ((pWriter != NULL) &&
+			((ixNextMergeFace + 1) % nBlockFaces == 0)
+		) {
+			FlushOverlapBlock(
+				meshFirst,
+				ixNextMergeFace + 1,
+				nFlushedNodes,
+				mapOverlapNodes,
+				meshOverlap,
+				*pWriter);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef USE_MPI
+
+///	<summary>
+///		Append the binary representation of a vector of plain values to
+///		a buffer, preceded by its length.
+///	</summary>
+template <typename T>
+void PackVector(
+	const std::vector<T> & vec,
+	std::vector<char> & vecBuffer
+) {
+	int nSize = static_cast<int>(vec.size());
+
+	size_t ixBegin = vecBuffer.size();
+	vecBuffer.resize(ixBegin + sizeof(int) + nSize * sizeof(T));
+
+	memcpy(&(vecBuffer[ixBegin]), &nSize, sizeof(int));
+	if (nSize != 0) {
+		memcpy(&(vecBuffer[ixBegin + sizeof(int)]), &(vec[0]),
+			nSize * sizeof(T));
+	}
+}
+
+///	<summary>
+///		Extract a vector of plain values written by PackVector from a
+///		buffer, advancing the read position.
+///	</summary>
+template <typename T>
+void UnpackVector(
+	const std::vector<char> & vecBuffer,
+	size_t & ixPos,
+	std::vector<T> & vec
+) {
+	int nSize;
+	memcpy(&nSize, &(vecBuffer[ixPos]), sizeof(int));
+	ixPos += sizeof(int);
+
+	vec.resize(nSize);
+	if (nSize != 0) {
+		memcpy(&(vec[0]), &(vecBuffer[ixPos]), nSize * sizeof(T));
+	}
+	ixPos += nSize * sizeof(T);
+}
+
+///	<summary>
+///		Append an OverlapFragment to a buffer for transfer between ranks.
+///	</summary>
+void PackOverlapFragment(
+	const OverlapFragment & fragment,
+	std::vector<char> & vecBuffer
+) {
+	const Mesh & mesh = fragment.mesh;
+
+	// Intersection Nodes
+	std::vector<double> vecCoords;
+	vecCoords.resize(3 * mesh.nodes.size());
+	for (int i = 0; i < mesh.nodes.size(); i++) {
+		vecCoords[3*i  ] = static_cast<double>(mesh.nodes[i].x);
+		vecCoords[3*i+1] = static_cast<double>(mesh.nodes[i].y);
+		vecCoords[3*i+2] = static_cast<double>(mesh.nodes[i].z);
+	}
+	PackVector(vecCoords, vecBuffer);
+
+	// Faces, stored as the number of Edges followed by the Nodes and
+	// type of each Edge
+	std::vector<int> vecFaces;
+	for (int i = 0; i < mesh.faces.size(); i++) {
+		const Face & face = mesh.faces[i];
+		vecFaces.push_back(static_cast<int>(face.edges.size()));
+		for (int k = 0; k < face.edges.size(); k++) {
+			vecFaces.push_back(face.edges[k][0]);
+			vecFaces.push_back(face.edges[k][1]);
+			vecFaces.push_back(static_cast<int>(face.edges[k].type));
+		}
+	}
+	PackVector(vecFaces, vecBuffer);
+
+	PackVector(mesh.vecFirstFaceIx, vecBuffer);
+	PackVector(mesh.vecSecondFaceIx, vecBuffer);
+	PackVector(fragment.vecFaceBegin, vecBuffer);
+	PackVector(fragment.vecNodeBegin, vecBuffer);
+
+	// Intersection keys
+	std::vector<int> vecKeys;
+	vecKeys.resize(4 * fragment.vecNodeKeys.size());
+	for (int i = 0; i < fragment.vecNodeKeys.size(); i++) {
+		vecKeys[4*i  ] = fragment.vecNodeKeys[i].first[0];
+		vecKeys[4*i+1] = fragment.vecNodeKeys[i].first[1];
+		vecKeys[4*i+2] = fragment.vecNodeKeys[i].second[0];
+		vecKeys[4*i+3] = fragment.vecNodeKeys[i].second[1];
+	}
+	PackVector(vecKeys, vecBuffer);
+
+	// Number of unmerged Faces and error message
+	std::vector<int> vecUnmerged(1, fragment.nUnmergedFaces);
+	PackVector(vecUnmerged, vecBuffer);
+
+	std::vector<char> vecError(
+		fragment.strError.begin(), fragment.strError.end());
+	PackVector(vecError, vecBuffer);
+}
+
+///	<summary>
+///		Extract an OverlapFragment written by PackOverlapFragment from a
+///		buffer, advancing the read position.
+///	</summary>
+void UnpackOverlapFragment(
+	const std::vector<char> & vecBuffer,
+	size_t & ixPos,
+	OverlapFragment & fragment
+) {
+	Mesh & mesh = fragment.mesh;
+
+	// Intersection Nodes
+	std::vector<double> vecCoords;
+	UnpackVector(vecBuffer, ixPos, vecCoords);
+
+	mesh.nodes.resize(vecCoords.size() / 3);
+	for (int i = 0; i < mesh.nodes.size(); i++) {
+		mesh.nodes[i] = Node(
+			static_cast<Real>(vecCoords[3*i  ]),
+			static_cast<Real>(vecCoords[3*i+1]),
+			static_cast<Real>(vecCoords[3*i+2]));
+	}
+
+	// Faces
+	std::vector<int> vecFaces;
+	UnpackVector(vecBuffer, ixPos, vecFaces);
+
+	mesh.faces.clear();
+	for (int ix = 0; ix < vecFaces.size();) {
+		int nEdges = vecFaces[ix++];
+
+		mesh.faces.push_back(Face(nEdges));
+		Face & face = mesh.faces.back();
+
+		for (int k = 0; k < nEdges; k++) {
+			face.edges[k][0] = vecFaces[ix++];
+			face.edges[k][1] = vecFaces[ix++];
+			face.edges[k].type = static_cast<Edge::Type>(vecFaces[ix++]);
+		}
+	}
+
+	UnpackVector(vecBuffer, ixPos, mesh.vecFirstFaceIx);
+	UnpackVector(vecBuffer, ixPos, mesh.vecSecondFaceIx);
+	UnpackVector(vecBuffer, ixPos, fragment.vecFaceBegin);
+	UnpackVector(vecBuffer, ixPos, fragment.vecNodeBegin);
+
+	// Intersection keys
+	std::vector<int> vecKeys;
+	UnpackVector(vecBuffer, ixPos, vecKeys);
+
+	fragment.vecNodeKeys.resize(vecKeys.size() / 4);
+	for (int i = 0; i < fragment.vecNodeKeys.size(); i++) {
+		fragment.vecNodeKeys[i] = EdgeIntersectionKey(
+			Edge(vecKeys[4*i  ], vecKeys[4*i+1]),
+			Edge(vecKeys[4*i+2], vecKeys[4*i+3]));
+	}
+
+	// Number of unmerged Faces and error message
+	std::vector<int> vecUnmerged;
+	UnpackVector(vecBuffer, ixPos, vecUnmerged);
+	fragment.nUnmergedFaces = vecUnmerged[0];
+
+	std::vector<char> vecError;
+	UnpackVector(vecBuffer, ixPos, vecError);
+	fragment.strError = std::string(vecError.begin(), vecError.end());
+}
+
+///	<summary>
+///		Send the fragments generated on this rank to the root rank, which
+///		receives the fragments of all ranks in order.  Messages are split
+///		so that each is below the MPI count limit.
+///	</summary>
+void GatherOverlapFragments(
+	const std::vector<int> & vecRankFragmentBegin,
+	std::vector<OverlapFragment> & vecFragments
+) {
+	static const long long MaximumMessageSize = (1 << 30);
+
+	int nRank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+
+	int nSize;
+	MPI_Comm_size(MPI_COMM_WORLD, &nSize);
+
+	// Pack and release the fragments of this rank
+	if (nRank != 0) {
+		std::vector<char> vecBuffer;
+		for (int f = vecRankFragmentBegin[nRank];
+			f < vecRankFragmentBegin[nRank+1]; f++
+		) {
+			PackOverlapFragment(vecFragments[f], vecBuffer);
+			vecFragments[f] = OverlapFragment();
+		}
+
+		long long nBufferSize = static_cast<long long>(vecBuffer.size());
+		MPI_Send(&nBufferSize, 1, MPI_LONG_LONG, 0, 0, MPI_COMM_WORLD);
+
+		for (long long ix = 0; ix < nBufferSize; ix += MaximumMessageSize) {
+			long long nMessageSize = nBufferSize - ix;
+			if (nMessageSize > MaximumMessageSize) {
+				nMessageSize = MaximumMessageSize;
+			}
+			MPI_Send(&(vecBuffer[ix]), static_cast<int>(nMessageSize),
+				MPI_CHAR, 0, 1, MPI_COMM_WORLD);
+		}
+		return;
+	}
+
+	// Receive the fragments of all other ranks
+	for (int r = 1; r < nSize; r++) {
+		long long nBufferSize;
+		MPI_Recv(&nBufferSize, 1, MPI_LONG_LONG, r, 0, MPI_COMM_WORLD,
+			MPI_STATUS_IGNORE);
+
+		std::vector<char> vecBuffer;
+		vecBuffer.resize(nBufferSize);
+
+		for (long long ix = 0; ix < nBufferSize; ix += MaximumMessageSize) {
+			long long nMessageSize = nBufferSize - ix;
+			if (nMessageSize > MaximumMessageSize) {
+				nMessageSize = MaximumMessageSize;
+			}
+			MPI_Recv(&(vecBuffer[ix]), static_cast<int>(nMessageSize),
+				MPI_CHAR, r, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		}
+
+		size_t ixPos = 0;
+		for (int f = vecRankFragmentBegin[r];
+			f < vecRankFragmentBegin[r+1]; f++
+		) {
+			UnpackOverlapFragment(vecBuffer, ixPos, vecFragments[f]);
+		}
+	}
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap mesh.  If pWriter is not NULL the overlap mesh
+///		is written to pWriter after every nBlockFaces Faces of meshFirst
+///		have been merged, leaving meshOverlap empty.  With MPI, contiguous
+///		ranges of fragments along the traversal are generated on each rank
+///		and merged on the root rank, where the result is identical to the
+///		serial overlap mesh.  Other ranks return an empty meshOverlap.
+///	</summary>
+void GenerateOverlapMeshBlocks(
+	const Mesh & meshFirst,
+	const Mesh & meshSecond,
+	Mesh & meshOverlap,
+	OverlapMeshMethod method,
+	OverlapMeshTraversal traversal,
+	MeshStreamWriter * pWriter,
+	int nBlockFaces,
+	const std::vector<int> * pvecFirstFaces
+) {
+	meshOverlap.Clear();
+	meshOverlap.vecFirstFaceIx.clear();
+	meshOverlap.vecSecondFaceIx.clear();
+
+	if ((pWriter != NULL) && (nBlockFaces < 1)) {
+		_EXCEPTIONT("Block size must be positive");
+	}
+
+	// Number of ranks and rank of this processor
+	int nRank = 0;
+	int nSize = 1;
+
+#ifdef USE_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+	MPI_Comm_size(MPI_COMM_WORLD, &nSize);
+#endif
+
+	// Only the root rank writes the overlap mesh
+	if (nRank != 0) {
+		pWriter = NULL;
+	}
+
+	// Get the two NodeVectors
+	const NodeVector & nodevecFirst = meshFirst.nodes;
+	const NodeVector & nodevecSecond = meshSecond.nodes;
+	const NodeVector & nodevecOverlap = meshOverlap.nodes;
+
+	// Check for coincident Nodes between meshFirst and meshSecond
+	std::vector<int> vecSecondNodeMap;
+
+	int nCoincidentNodes =
+		BuildCoincidentNodeVector(
+			meshFirst, meshSecond, vecSecondNodeMap);
+
+	Announce("Number of coincident nodes between mesh A and B [%i]",
+		nCoincidentNodes);
+
+	// Insert all nodes from the two NodeVectors
+	for (int i = 0; i < nodevecFirst.size(); i++) {
+		meshOverlap.nodes.push_back(nodevecFirst[i]);
+		//mapOverlapNodes.insert(NodeMap::value_type(nodevecFirst[i], i));
+	}
+
+	for (int i = 0; i < nodevecSecond.size(); i++) {
+		if (vecSecondNodeMap[i] == InvalidNode) {
+			int ix = static_cast<int>(meshOverlap.nodes.size());
+			meshOverlap.nodes.push_back(nodevecSecond[i]);
+			//mapOverlapNodes.insert(NodeMap::value_type(nodevecSecond[i], ix));
+			vecSecondNodeMap[i] = ix;
+		}
+	}
+/*
+	// Estimate meshOverlap size
+	int nMaximumFaceCount;
+	if (meshFirst.faces.size() > meshSecond.faces.size()) {
+		nMaximumFaceCount = static_cast<int>(meshFirst.faces.size());
+	} else {
+		nMaximumFaceCount = static_cast<int>(meshSecond.faces.size());
+	}
+	meshOverlap.faces.reserve(2 * nMaximumFaceCount);
+*/
+	// Nodes from both meshes, which are shared by all fragments
+	int nBaseOverlapNodes = static_cast<int>(meshOverlap.nodes.size());
+
+	// Number of Nodes already written to pWriter
+	int nFlushedNodes = 0;
+
+	if (pWriter != NULL) {
+		pWriter->WriteNodes(meshOverlap.nodes);
+		meshOverlap.nodes.clear();
+		nFlushedNodes = nBaseOverlapNodes;
+	}
+
+	// Number of Faces on meshFirst
+	int nFirstFaces = static_cast<int>(meshFirst.faces.size());
+
+	// Order in which Faces on meshFirst are traversed
+	std::vector<int> vecFirstFaceOrder;
+	if (traversal == OverlapMeshTraversal_SpaceFillingCurve) {
+		GetSpaceFillingCurveOrder(meshFirst, vecFirstFaceOrder);
+
+	} else {
+		vecFirstFaceOrder.resize(nFirstFaces);
+		for (int i = 0; i < nFirstFaces; i++) {
+			vecFirstFaceOrder[i] = i;
+		}
+	}
+
+	// Restrict the traversal to the selected Faces on meshFirst
+	std::vector<bool> vecFirstFaceSelected;
+	vecFirstFaceSelected.resize(nFirstFaces, (pvecFirstFaces == NULL));
+
+	if (pvecFirstFaces != NULL) {
+		for (int i = 0; i < pvecFirstFaces->size(); i++) {
+			int ixFace = (*pvecFirstFaces)[i];
+			if ((ixFace < 0) || (ixFace >= nFirstFaces)) {
+				_EXCEPTION1("Selected Face %i out of range", ixFace);
+			}
+			vecFirstFaceSelected[ixFace] = true;
+		}
+
+		int nSelected = 0;
+		for (int i = 0; i < nFirstFaces; i++) {
+			if (vecFirstFaceSelected[vecFirstFaceOrder[i]]) {
+				vecFirstFaceOrder[nSelected] = vecFirstFaceOrder[i];
+				nSelected++;
+			}
+		}
+		vecFirstFaceOrder.resize(nSelected);
+	}
+
+	// Number of Faces on meshFirst which are traversed
+	int nTraversedFaces = static_cast<int>(vecFirstFaceOrder.size());
+
+	// Number of Faces on meshFirst processed by each fragment
+	static const int FragmentFaceCount = 64;
+
+	int nFragments =
+		(nTraversedFaces + FragmentFaceCount - 1) / FragmentFaceCount;
+
+	// Number of fragments generated before merging
+	int nThreads = 1;
+#ifdef _OPENMP
+	nThreads = omp_get_max_threads();
+#endif
+	int nFragmentsPerPass = 4 * nThreads;
+
+	// Fragment and position within the fragment of each Face on meshFirst,
+	// or (-1) if the Face is not traversed
+	std::vector<int> vecFirstFaceFragment;
+	vecFirstFaceFragment.resize(nFirstFaces, (-1));
+
+	std::vector<int> vecFirstFaceFragmentIx;
+	vecFirstFaceFragmentIx.resize(nFirstFaces, (-1));
+
+	for (int i = 0; i < nTraversedFaces; i++) {
+		vecFirstFaceFragment[vecFirstFaceOrder[i]] = i / FragmentFaceCount;
+		vecFirstFaceFragmentIx[vecFirstFaceOrder[i]] = i % FragmentFaceCount;
+	}
+
+	// Loop through all Faces on the first Mesh in traversal order.  Each
+	// block of Faces is processed independently into a fragment.  The
+	// overlap Faces are merged in order of the first Mesh Faces, so the
+	// Faces and their geometry depend neither on the traversal nor the
+	// number of threads.  Intersection Nodes are numbered as they are
+	// generated, which depends on the traversal but not on the threads.
+	std::vector<OverlapFragment> vecFragments;
+	vecFragments.resize(nFragments);
+
+	std::vector<bool> vecFirstFaceDone;
+	vecFirstFaceDone.resize(nFirstFaces, false);
+	for (int i = 0; i < nFirstFaces; i++) {
+		if (!vecFirstFaceSelected[i]) {
+			vecFirstFaceDone[i] = true;
+		}
+	}
+
+	int ixNextMergeFace = 0;
+
+	// Overlap mesh Nodes generated by intersections
+	std::map<EdgeIntersectionKey, int> mapOverlapNodes;
+
+	// Range of fragments generated by each rank
+	std::vector<int> vecRankFragmentBegin;
+	vecRankFragmentBegin.resize(nSize + 1);
+	for (int r = 0; r <= nSize; r++) {
+		vecRankFragmentBegin[r] = static_cast<int>(
+			(static_cast<long long>(nFragments) * r) / nSize);
+	}
+
+	int ixFragmentBegin = vecRankFragmentBegin[nRank];
+	int ixFragmentEnd = vecRankFragmentBegin[nRank+1];
+
+	for (int ixPass = ixFragmentBegin;
+		ixPass < ixFragmentEnd; ixPass += nFragmentsPerPass
+	) {
+		int nPassFragments = nFragmentsPerPass;
+		if (ixPass + nPassFragments > ixFragmentEnd) {
+			nPassFragments = ixFragmentEnd - ixPass;
+		}
+
+#pragma omp parallel for schedule(dynamic)
+		for (int f = ixPass; f < ixPass + nPassFragments; f++) {
+			int ixBegin = f * FragmentFaceCount;
+			int ixEnd = ixBegin + FragmentFaceCount;
+			if (ixEnd > nTraversedFaces) {
+				ixEnd = nTraversedFaces;
+			}
+
+			std::vector<int> vecFirstFaces(
+				vecFirstFaceOrder.begin() + ixBegin,
+				vecFirstFaceOrder.begin() + ixEnd);
+
+			// Exceptions cannot propagate out of a parallel region
+			try {
+				GenerateOverlapFragment(
+					meshFirst,
+					meshSecond,
+					vecSecondNodeMap,
+					method,
+					vecFirstFaces,
+					nBaseOverlapNodes,
+					vecFragments[f]);
+
+			} catch(Exception & e) {
+				vecFragments[f].strError = e.ToString();
+			}
+		}
+
+		// Fragments from other ranks are merged after they are gathered
+		if (nSize != 1) {
+			continue;
+		}
+
+		for (int f = ixPass; f < ixPass + nPassFragments; f++) {
+			if (vecFragments[f].strError != "") {
+				_EXCEPTION1("%s", vecFragments[f].strError.c_str());
+			}
+
+			int ixBegin = f * FragmentFaceCount;
+			int ixEnd = ixBegin + FragmentFaceCount;
+			if (ixEnd > nTraversedFaces) {
+				ixEnd = nTraversedFaces;
+			}
+			for (int i = ixBegin; i < ixEnd; i++) {
+				vecFirstFaceDone[vecFirstFaceOrder[i]] = true;
+			}
+		}
+
+		// Merge all completed Faces in order
+		MergeOverlapFragments(
+			meshFirst,
+			vecFirstFaceDone,
+			vecFirstFaceFragment,
+			vecFirstFaceFragmentIx,
+			nBaseOverlapNodes,
+			vecFragments,
+			ixNextMergeFace,
+			nFlushedNodes,
+			mapOverlapNodes,
+			meshOverlap,
+			pWriter,
+			nBlockFaces);
+	}
+
+#ifdef USE_MPI
+	// Gather all fragments on the root rank and merge them in order
+	if (nSize != 1) {
+		GatherOverlapFragments(vecRankFragmentBegin, vecFragments);
+
+		if (nRank != 0) {
+			meshOverlap.Clear();
+			return;
+		}
+
+		for (int f = 0; f < nFragments; f++) {
+			if (vecFragments[f].strError != "") {
+				_EXCEPTION1("%s", vecFragments[f].strError.c_str());
+			}
+		}
+
+		vecFirstFaceDone.assign(nFirstFaces, true);
+
+		MergeOverlapFragments(
+			meshFirst,
+			vecFirstFaceDone,
+			vecFirstFaceFragment,
+			vecFirstFaceFragmentIx,
+			nBaseOverlapNodes,
+			vecFragments,
+			ixNextMergeFace,
+			nFlushedNodes,
+			mapOverlapNodes,
+			meshOverlap,
+			pWriter,
+			nBlockFaces);
+	}
+#endif
+
+	if (pWriter != NULL) {
+		FlushOverlapBlock(
+			meshFirst,
+			ixNextMergeFace,
+			nFlushedNodes,
+			mapOverlapNodes,
+			meshOverlap,
+			*pWriter);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GenerateOverlapMesh(
+	const Mesh & meshFirst,
+	const Mesh & meshSecond,
+	Mesh & meshOverlap,
+	OverlapMeshMethod method,
+	OverlapMeshTraversal traversal
+) {
+	GenerateOverlapMeshBlocks(
+		meshFirst,
+		meshSecond,
+		meshOverlap,
+		method,
+		traversal,
+		NULL,
+		0,
+		NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GenerateOverlapMesh(
+	const Mesh & meshFirst,
+	const Mesh & meshSecond,
+	MeshStreamWriter & writer,
+	int nBlockFaces,
+	OverlapMeshMethod method,
+	OverlapMeshTraversal traversal
+) {
+	Mesh meshOverlap;
+
+	GenerateOverlapMeshBlocks(
+		meshFirst,
+		meshSecond,
+		meshOverlap,
+		method,
+		traversal,
+		&writer,
+		nBlockFaces,
+		NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Build a key identifying the geometry of a Face, given the index of
+///		each of its Nodes in a reference NodeVector.  The key consists of
+///		the Node indices and Edge types, rotated to begin at the smallest
+///		Node index.
+///	</summary>
+void GetFaceGeometryKey(
+	const Face & face,
+	const std::vector<int> & vecNodeIx,
+	std::vector<int> & vecKey
+) {
+	int nEdges = static_cast<int>(face.edges.size());
+
+	int kBegin = 0;
+	for (int k = 1; k < nEdges; k++) {
+		if (vecNodeIx[face[k]] < vecNodeIx[face[kBegin]]) {
+			kBegin = k;
+		}
+	}
+
+	vecKey.resize(2 * nEdges);
+	for (int k = 0; k < nEdges; k++) {
+		int kRotated = (kBegin + k) % nEdges;
+		vecKey[k] = vecNodeIx[face[kRotated]];
+		vecKey[nEdges + k] = static_cast<int>(face.edges[kRotated].type);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Determine the index of the first overlap Face associated with each
+///		Face of the first mesh, verifying that the overlap mesh is stored
+///		in order of the first mesh Faces.
+///	</summary>
+void GetOverlapFaceBegin(
+	const Mesh & meshOverlap,
+	int nFirstFaces,
+	std::vector<int> & vecFaceBegin
+) {
+	if (meshOverlap.vecFirstFaceIx.size() != meshOverlap.faces.size()) {
+		_EXCEPTIONT("Overlap mesh has no first mesh source Faces");
+	}
+	if (meshOverlap.vecSecondFaceIx.size() != meshOverlap.faces.size()) {
+		_EXCEPTIONT("Overlap mesh has no second mesh source Faces");
+	}
+
+	vecFaceBegin.resize(nFirstFaces + 1);
+
+	int ixOverlap = 0;
+	for (int i = 0; i < nFirstFaces; i++) {
+		vecFaceBegin[i] = ixOverlap;
+		while ((ixOverlap < meshOverlap.faces.size()) &&
+			(meshOverlap.vecFirstFaceIx[ixOverlap] == i)
+		) {
+			ixOverlap++;
+		}
+	}
+	vecFaceBegin[nFirstFaces] = ixOverlap;
+
+	if (ixOverlap != meshOverlap.faces.size()) {
+		_EXCEPTIONT("Overlap mesh is not stored in order of first mesh Faces");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int RegenerateOverlapMesh(
+	const Mesh & meshFirstPrevious,
+	const Mesh & meshOverlapPrevious,
+	const Mesh & meshFirst,
+	const Mesh & meshSecond,
+	Mesh & meshOverlap,
+	OverlapMeshMethod method,
+	OverlapMeshTraversal traversal
+) {
+	int nFirstFaces = static_cast<int>(meshFirst.faces.size());
+	int nPreviousFaces = static_cast<int>(meshFirstPrevious.faces.size());
+
+	// Overlap Faces of each Face of the previous first mesh
+	std::vector<int> vecPreviousFaceBegin;
+	GetOverlapFaceBegin(
+		meshOverlapPrevious, nPreviousFaces, vecPreviousFaceBegin);
+
+	// Index each Node of meshFirst by a coincident Node of the previous
+	// first mesh, or give it a unique index if there is no such Node
+	NodeSpatialHash hashPreviousNodes;
+	hashPreviousNodes.Initialize(meshFirstPrevious.nodes);
+
+	std::vector<int> vecPreviousNodeIx;
+	vecPreviousNodeIx.resize(meshFirstPrevious.nodes.size());
+	for (int i = 0; i < vecPreviousNodeIx.size(); i++) {
+		vecPreviousNodeIx[i] = i;
+	}
+
+	std::vector<int> vecNodeIx;
+	vecNodeIx.resize(meshFirst.nodes.size());
+
+#pragma omp parallel for
+	for (int i = 0; i < meshFirst.nodes.size(); i++) {
+		int ix = hashPreviousNodes.Find(meshFirst.nodes[i]);
+		if (ix == InvalidNode) {
+			ix = static_cast<int>(meshFirstPrevious.nodes.size()) + i;
+		}
+		vecNodeIx[i] = ix;
+	}
+
+	// Faces of the previous first mesh, indexed by their geometry
+	std::map<std::vector<int>, int> mapPreviousFaces;
+
+	std::vector<int> vecKey;
+	for (int i = 0; i < nPreviousFaces; i++) {
+		GetFaceGeometryKey(
+			meshFirstPrevious.faces[i], vecPreviousNodeIx, vecKey);
+
+		mapPreviousFaces.insert(
+			std::pair<std::vector<int>, int>(vecKey, i));
+	}
+
+	// Match Faces of meshFirst with unchanged Faces of the previous mesh
+	std::vector<int> vecPreviousFace;
+	vecPreviousFace.resize(nFirstFaces, InvalidFace);
+
+	std::vector<int> vecChangedFaces;
+
+	for (int i = 0; i < nFirstFaces; i++) {
+		GetFaceGeometryKey(meshFirst.faces[i], vecNodeIx, vecKey);
+
+		std::map<std::vector<int>, int>::const_iterator iter =
+			mapPreviousFaces.find(vecKey);
+
+		if (iter != mapPreviousFaces.end()) {
+			vecPreviousFace[i] = iter->second;
+		} else {
+			vecChangedFaces.push_back(i);
+		}
+	}
+
+	Announce("Regenerating overlap of %i of %i Faces",
+		static_cast<int>(vecChangedFaces.size()), nFirstFaces);
+
+	// Generate the overlap of all changed Faces
+	Mesh meshOverlapChanged;
+
+	if (vecChangedFaces.size() != 0) {
+		GenerateOverlapMeshBlocks(
+			meshFirst,
+			meshSecond,
+			meshOverlapChanged,
+			method,
+			traversal,
+			NULL,
+			0,
+			&vecChangedFaces);
+	}
+
+	std::vector<int> vecChangedFaceBegin;
+	GetOverlapFaceBegin(
+		meshOverlapChanged, nFirstFaces, vecChangedFaceBegin);
+
+	// Assemble the overlap mesh in order of the Faces of meshFirst.  Nodes
+	// which are coincident between the reused and regenerated overlap
+	// Faces are merged.
+	meshOverlap.Clear();
+	meshOverlap.vecFirstFaceIx.clear();
+	meshOverlap.vecSecondFaceIx.clear();
+
+	NodeSpatialHash hashOverlapNodes;
+	hashOverlapNodes.Clear(static_cast<int>(
+		meshOverlapPrevious.nodes.size() + meshOverlapChanged.nodes.size()));
+
+	std::vector<int> vecPreviousNodeMap;
+	vecPreviousNodeMap.resize(meshOverlapPrevious.nodes.size(), InvalidNode);
+
+	std::vector<int> vecChangedNodeMap;
+	vecChangedNodeMap.resize(meshOverlapChanged.nodes.size(), InvalidNode);
+
+	for (int i = 0; i < nFirstFaces; i++) {
+		bool fReused = (vecPreviousFace[i] != InvalidFace);
+
+		const Mesh & meshSource =
+			(fReused)?(meshOverlapPrevious):(meshOverlapChanged);
+
+		std::vector<int> & vecNodeMap =
+			(fReused)?(vecPreviousNodeMap):(vecChangedNodeMap);
+
+		int ixBegin;
+		int ixEnd;
+		if (fReused) {
+			ixBegin = vecPreviousFaceBegin[vecPreviousFace[i]];
+			ixEnd = vecPreviousFaceBegin[vecPreviousFace[i]+1];
+		} else {
+			ixBegin = vecChangedFaceBegin[i];
+			ixEnd = vecChangedFaceBegin[i+1];
+		}
+
+		for (int j = ixBegin; j < ixEnd; j++) {
+			Face face = meshSource.faces[j];
+
+			for (int k = 0; k < face.edges.size(); k++) {
+			for (int m = 0; m < 2; m++) {
+				int ixSourceNode = face.edges[k][m];
+
+				if (vecNodeMap[ixSourceNode] == InvalidNode) {
+					const Node & node = meshSource.nodes[ixSourceNode];
+
+					int ixNode = hashOverlapNodes.Find(node);
+					if (ixNode == InvalidNode) {
+						ixNode = static_cast<int>(meshOverlap.nodes.size());
+						meshOverlap.nodes.push_back(node);
+						hashOverlapNodes.Insert(node, ixNode);
+					}
+					vecNodeMap[ixSourceNode] = ixNode;
+				}
+
+				face.edges[k][m] = vecNodeMap[ixSourceNode];
+			}
+			}
+
+			meshOverlap.faces.push_back(face);
+			meshOverlap.vecFirstFaceIx.push_back(i);
+			meshOverlap.vecSecondFaceIx.push_back(
+				meshSource.vecSecondFaceIx[j]);
+		}
+	}
+
+	return static_cast<int>(vecChangedFaces.size());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -20,6 +20,7 @@
 #include "Defines.h"
 
 #include "GridElements.h"
+#include "MeshStream.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -32,6 +33,17 @@ enum OverlapMeshMethod {
 	OverlapMeshMethod_Mixed,
 };
 
+///	<summary>
+///		Order in which Faces of the first mesh are traversed.  The overlap
+///		Faces are always stored in order of the first mesh Faces with the
+///		same geometry, but intersection Nodes are numbered in the order
+///		they are generated, so Node numbering depends on the traversal.
+///	</summary>
+enum OverlapMeshTraversal {
+	OverlapMeshTraversal_Index,
+	OverlapMeshTraversal_SpaceFillingCurve
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
@@ -42,7 +54,45 @@ void GenerateOverlapMesh(
 	const Mesh & meshFirst,
 	const Mesh & meshSecond,
 	Mesh & meshOverlap,
-	OverlapMeshMethod method
+	OverlapMeshMethod method,
+	OverlapMeshTraversal traversal = OverlapMeshTraversal_Index
+);
+
+///	<summary>
+///		Generate the mesh obtained by overlapping meshes meshFirst and
+///		meshSecond, writing the overlap mesh to writer in blocks of the
+///		overlap Faces of nBlockFaces Faces of meshFirst.  Only the current
+///		block and the intersection Nodes which may still be shared with
+///		later blocks are held in memory.  The EdgeMap of meshFirst is used
+///		to determine which intersection Nodes may still be shared.
+///	</summary>
+void GenerateOverlapMesh(
+	const Mesh & meshFirst,
+	const Mesh & meshSecond,
+	MeshStreamWriter & writer,
+	int nBlockFaces,
+	OverlapMeshMethod method,
+	OverlapMeshTraversal traversal = OverlapMeshTraversal_Index
+);
+
+///	<summary>
+///		Regenerate the overlap mesh of meshFirst and meshSecond, given the
+///		overlap mesh meshOverlapPrevious of meshFirstPrevious and the same
+///		meshSecond.  Overlap Faces of Faces of meshFirst which coincide with
+///		a Face of meshFirstPrevious are reused, and only the overlap of the
+///		remaining Faces is generated.
+///	</summary>
+///	<returns>
+///		The number of Faces of meshFirst whose overlap was regenerated.
+///	</returns>
+int RegenerateOverlapMesh(
+	const Mesh & meshFirstPrevious,
+	const Mesh & meshOverlapPrevious,
+	const Mesh & meshFirst,
+	const Mesh & meshSecond,
+	Mesh & meshOverlap,
+	OverlapMeshMethod method,
+	OverlapMeshTraversal traversal = OverlapMeshTraversal_Index
 );
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -45,6 +45,29 @@ public:
 		double dXsample
 	);
 
+	///	<summary>
+	///		Determine the coefficients of a Lagrangian polynomial through a
+	///		fixed number of points dX which is sampled at point dXsample.
+	///	</summary>
+	template <int nPoints>
+	static void LagrangianPolynomialCoeffs(
+		const double * dX,
+		double * dCoeffs,
+		double dXsample
+	) {
+		for (int i = 0; i < nPoints; i++) {
+			dCoeffs[i] = 1.0;
+
+			for (int j = 0; j < nPoints; j++) {
+				if (i == j) {
+					continue;
+				}
+
+				dCoeffs[i] *= (dXsample - dX[j]) / (dX[i] - dX[j]);
+			}
+		}
+	}
+
 	///	<summary>
 	///		Determine the coefficients of the first derivative of a Lagrangian
 	///		polynomial through the specified points dX which is sampled at
@@ -19,24 +19,305 @@
 
 #include "Defines.h"
 #include "DataVector.h"
+#include "Exception.h"
 
-#include <map>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <string>
+#include <cstdio>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		A sparse matrix stored in compressed sparse row (CSR) format.  The
+///		matrix is assembled by adding (row, col, value) triplets with Add,
+///		which are buffered separately for each thread.  Finalize sorts the
+///		buffered triplets and sums duplicates into the CSR arrays.  Values
+///		added to the same entry are summed in the order they were added,
+///		with entries added from different threads summed in thread order.
+///		If a spill budget is set with SetSpill, the triplets of each thread
+///		are written to sorted runs in a scratch directory whenever they
+///		reach the budget, and Finalize merges the runs, so that the memory
+///		used by assembly is bounded by the budget and the finalized
+///		matrix.  Spilling does not change the order in which entries are
+///		summed.
+///	</summary>
 template <typename DataType>
 class SparseMatrix {
 
-public:
+protected:
 	///	<summary>
-	///		Sparse matrix map.
+	///		A buffered entry of the sparse matrix.
 	///	</summary>
-	typedef typename std::pair<int, int> IndexType;
-	typedef typename std::map<IndexType, DataType> SparseMap;
-	typedef typename SparseMap::value_type SparseMapPair;
-	typedef typename SparseMap::iterator SparseMapIterator;
-	typedef typename SparseMap::const_iterator SparseMapConstIterator;
-	typedef typename std::pair<SparseMapIterator, bool> SparseMapInsertResult;
+	struct Triplet {
+		int iRow;
+		int iCol;
+		DataType value;
+	};
+
+	///	<summary>
+	///		A run of triplets in row-major order spilled to a file.  Runs
+	///		spilled from memory have level 0, and a run merged from runs of
+	///		level n has level n+1.
+	///	</summary>
+	struct TripletRun {
+		std::string strFile;
+		size_t sTriplets;
+		int nLevel;
+	};
+
+	///	<summary>
+	///		A buffer of triplets added by one thread, and the runs it has
+	///		spilled, in order of addition.
+	///	</summary>
+	struct TripletBuffer {
+		std::vector<Triplet> vecTriplets;
+		std::vector<TripletRun> vecRuns;
+		int nRunsWritten;
+		int nRows;
+		int nCols;
+
+		TripletBuffer() :
+			nRunsWritten(0),
+			nRows(0),
+			nCols(0)
+		{ }
+	};
+
+	///	<summary>
+	///		Comparator ordering triplets of the same row by column.
+	///	</summary>
+	static bool CompareColumn(const Triplet & a, const Triplet & b) {
+		return (a.iCol < b.iCol);
+	}
+
+	///	<summary>
+	///		Comparator ordering triplets by row, then by column.
+	///	</summary>
+	static bool CompareRowColumn(const Triplet & a, const Triplet & b) {
+		if (a.iRow != b.iRow) {
+			return (a.iRow < b.iRow);
+		}
+		return (a.iCol < b.iCol);
+	}
+
+	///	<summary>
+	///		A sequence of triplets in row-major order which is merged by
+	///		Finalize, read either from memory or through a buffer from a
+	///		spilled run.
+	///	</summary>
+	class TripletSource {
+
+	public:
+		///	<summary>
+		///		Constructor for triplets in memory.
+		///	</summary>
+		TripletSource(
+			const Triplet * pTriplets,
+			size_t sTriplets
+		) :
+			m_fp(NULL),
+			m_pTriplets(pTriplets),
+			m_sTriplets(sTriplets),
+			m_ix(0),
+			m_sFileTriplets(0)
+		{ }
+
+		///	<summary>
+		///		Constructor for a spilled run.
+		///	</summary>
+		TripletSource(
+			const TripletRun & run,
+			size_t sBufferTriplets
+		) :
+			m_fp(NULL),
+			m_pTriplets(NULL),
+			m_sTriplets(0),
+			m_ix(0),
+			m_sFileTriplets(run.sTriplets),
+			m_strFile(run.strFile)
+		{
+			m_fp = fopen(run.strFile.c_str(), "rb");
+			if (m_fp == NULL) {
+				_EXCEPTION1("Unable to open SparseMatrix run \"%s\"",
+					run.strFile.c_str());
+			}
+			m_vecBuffer.resize(std::max<size_t>(sBufferTriplets, 1));
+			Refill();
+		}
+
+		///	<summary>
+		///		Destructor.
+		///	</summary>
+		~TripletSource() {
+			if (m_fp != NULL) {
+				fclose(m_fp);
+			}
+		}
+
+	public:
+		///	<summary>
+		///		Determine if all triplets have been read.
+		///	</summary>
+		bool IsDone() const {
+			return ((m_ix == m_sTriplets) && (m_sFileTriplets == 0));
+		}
+
+		///	<summary>
+		///		Get the next triplet.
+		///	</summary>
+		const Triplet & Front() const {
+			return m_pTriplets[m_ix];
+		}
+
+		///	<summary>
+		///		Advance to the next triplet.
+		///	</summary>
+		void Pop() {
+			m_ix++;
+			if ((m_ix == m_sTriplets) && (m_sFileTriplets != 0)) {
+				Refill();
+			}
+		}
+
+	protected:
+		///	<summary>
+		///		Read the next triplets of the run into the buffer.
+		///	</summary>
+		void Refill() {
+			size_t sRead = std::min(m_vecBuffer.size(), m_sFileTriplets);
+			if (fread(&(m_vecBuffer[0]), sizeof(Triplet), sRead, m_fp)
+				!= sRead
+			) {
+				_EXCEPTION1("Unable to read SparseMatrix run \"%s\"",
+					m_strFile.c_str());
+			}
+			m_pTriplets = &(m_vecBuffer[0]);
+			m_sTriplets = sRead;
+			m_ix = 0;
+			m_sFileTriplets -= sRead;
+		}
+
+	private:
+		///	<summary>
+		///		File of a spilled run.
+		///	</summary>
+		FILE * m_fp;
+
+		///	<summary>
+		///		Triplets available in memory and the index of the next one.
+		///	</summary>
+		const Triplet * m_pTriplets;
+		size_t m_sTriplets;
+		size_t m_ix;
+
+		///	<summary>
+		///		Number of triplets of the run remaining in the file.
+		///	</summary>
+		size_t m_sFileTriplets;
+
+		///	<summary>
+		///		Name of the file of a spilled run.
+		///	</summary>
+		std::string m_strFile;
+
+		///	<summary>
+		///		Buffer of triplets read from the file.
+		///	</summary>
+		std::vector<Triplet> m_vecBuffer;
+	};
+
+	///	<summary>
+	///		Merge of several TripletSources into one sequence in row-major
+	///		order, in which triplets with the same row and column are
+	///		ordered by source and then by their order in each source.
+	///	</summary>
+	class TripletMerge {
+
+	protected:
+		///	<summary>
+		///		Comparator ordering sources by their next triplet, and by
+		///		their index, for a min-heap.
+		///	</summary>
+		struct CompareSource {
+			const TripletMerge * pMerge;
+
+			bool operator()(int a, int b) const {
+				const Triplet & ta = pMerge->m_vecSources[a]->Front();
+				const Triplet & tb = pMerge->m_vecSources[b]->Front();
+				if (ta.iRow != tb.iRow) {
+					return (ta.iRow > tb.iRow);
+				}
+				if (ta.iCol != tb.iCol) {
+					return (ta.iCol > tb.iCol);
+				}
+				return (a > b);
+			}
+		};
+
+	public:
+		///	<summary>
+		///		Constructor.
+		///	</summary>
+		TripletMerge(
+			std::vector< std::unique_ptr<TripletSource> > & vecSources
+		) :
+			m_vecSources(vecSources),
+			m_heap(CompareSource{this})
+		{
+			for (int s = 0; s < m_vecSources.size(); s++) {
+				if (!m_vecSources[s]->IsDone()) {
+					m_heap.push(s);
+				}
+			}
+		}
+
+	public:
+		///	<summary>
+		///		Determine if all triplets have been merged.
+		///	</summary>
+		bool IsDone() const {
+			return m_heap.empty();
+		}
+
+		///	<summary>
+		///		Get the next triplet, which is valid until Pop is called.
+		///	</summary>
+		const Triplet & Front() const {
+			return m_vecSources[m_heap.top()]->Front();
+		}
+
+		///	<summary>
+		///		Advance to the next triplet.
+		///	</summary>
+		void Pop() {
+			int s = m_heap.top();
+			m_heap.pop();
+
+			m_vecSources[s]->Pop();
+			if (!m_vecSources[s]->IsDone()) {
+				m_heap.push(s);
+			}
+		}
+
+	private:
+		///	<summary>
+		///		Sources in order of precedence.
+		///	</summary>
+		std::vector< std::unique_ptr<TripletSource> > & m_vecSources;
+
+		///	<summary>
+		///		Heap of the indices of sources which are not done.
+		///	</summary>
+		std::priority_queue<int, std::vector<int>, CompareSource> m_heap;
+	};
 
 public:
 	///	<summary>
@@ -44,31 +325,637 @@ public:
 	///	</summary>
 	SparseMatrix() :
 		m_nRows(0),
-		m_nCols(0)
-	{ }
+		m_nCols(0),
+		m_nExtNonZeros(0),
+		m_piExtRowPtr(NULL),
+		m_piExtColIx(NULL),
+		m_pExtValues(NULL),
+		m_sSpillTriplets(0)
+	{
+		int nThreads = 1;
+#ifdef _OPENMP
+		nThreads = omp_get_max_threads();
+#endif
+		m_vecBuffers.resize(nThreads);
+
+		m_vecRowPtr.resize(1, 0);
+	}
+
+	///	<summary>
+	///		Destructor.  Removes any spilled runs.
+	///	</summary>
+	~SparseMatrix() {
+		RemoveRuns();
+	}
 
 public:
 	///	<summary>
-	///		Accessor.
+	///		Spill the triplets of each thread to sorted runs in strDirectory
+	///		whenever the triplets buffered by all threads, and the memory
+	///		used to sort them, would exceed sMemoryBudget bytes.  A budget
+	///		of zero disables spilling.  The runs are owned by this matrix,
+	///		which must not be copied before it is finalized.
+	///	</summary>
+	void SetSpill(
+		size_t sMemoryBudget,
+		const std::string & strDirectory
+	) {
+		m_strSpillDirectory = strDirectory;
+		m_sSpillTriplets = 0;
+
+		if (sMemoryBudget != 0) {
+			m_sSpillTriplets =
+				sMemoryBudget / (2 * sizeof(Triplet) * m_vecBuffers.size());
+			if (m_sSpillTriplets < 1) {
+				m_sSpillTriplets = 1;
+			}
+		}
+	}
+
+public:
+	///	<summary>
+	///		Add value to the entry (iRow, iCol).  This function may be
+	///		called concurrently from different threads of a parallel region.
+	///	</summary>
+	void Add(int iRow, int iCol, DataType value) {
+		int iThread = 0;
+#ifdef _OPENMP
+		iThread = omp_get_thread_num();
+#endif
+		if (iThread >= m_vecBuffers.size()) {
+			_EXCEPTION1("SparseMatrix does not support thread %i", iThread);
+		}
+
+		TripletBuffer & buffer = m_vecBuffers[iThread];
+
+		Triplet triplet;
+		triplet.iRow = iRow;
+		triplet.iCol = iCol;
+		triplet.value = value;
+
+		buffer.vecTriplets.push_back(triplet);
+
+		if (iRow >= buffer.nRows) {
+			buffer.nRows = iRow + 1;
+		}
+		if (iCol >= buffer.nCols) {
+			buffer.nCols = iCol + 1;
+		}
+
+		if ((m_sSpillTriplets != 0) &&
+			(buffer.vecTriplets.size() >= m_sSpillTriplets)
+		) {
+			Spill(iThread);
+		}
+	}
+
+	///	<summary>
+	///		Determine if there are triplets which have not been finalized.
+	///	</summary>
+	bool IsFinalized() const {
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			if ((m_vecBuffers[t].vecTriplets.size() != 0) ||
+				(m_vecBuffers[t].vecRuns.size() != 0)
+			) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+protected:
+	///	<summary>
+	///		Number of runs of the same level which are merged into one run
+	///		of the next level.
+	///	</summary>
+	static const int SpillMergeRuns = 8;
+
+	///	<summary>
+	///		Maximum number of runs merged directly by Finalize; if there are
+	///		more, the runs of each thread are first merged into one.
+	///	</summary>
+	static const int SpillMaxFinalRuns = 256;
+
+	///	<summary>
+	///		Open a new, empty run of one thread.
 	///	</summary>
-	DataType & operator()(int iRow, int iCol) {
-		SparseMapIterator iter = m_mapEntries.find(IndexType(iRow, iCol));
-		if (iter == m_mapEntries.end()) {
-			if (iRow >= m_nRows) {
-				m_nRows = iRow + 1;
+	FILE * OpenRun(
+		int iThread,
+		int nLevel,
+		TripletRun & run
+	) {
+		TripletBuffer & buffer = m_vecBuffers[iThread];
+
+		char szRun[96];
+		sprintf(szRun, "/sparsematrix_%i_%p_%i_%i.run",
+			static_cast<int>(getpid()),
+			static_cast<void *>(this),
+			iThread,
+			buffer.nRunsWritten);
+
+		buffer.nRunsWritten++;
+
+		run.strFile = m_strSpillDirectory + szRun;
+		run.sTriplets = 0;
+		run.nLevel = nLevel;
+
+		FILE * fp = fopen(run.strFile.c_str(), "wb");
+		if (fp == NULL) {
+			_EXCEPTION1("Unable to open SparseMatrix run \"%s\"",
+				run.strFile.c_str());
+		}
+		return fp;
+	}
+
+	///	<summary>
+	///		Append triplets to a run and clear them.
+	///	</summary>
+	static void WriteRun(
+		FILE * fp,
+		TripletRun & run,
+		std::vector<Triplet> & vecTriplets
+	) {
+		if (vecTriplets.size() == 0) {
+			return;
+		}
+		if (fwrite(&(vecTriplets[0]), sizeof(Triplet), vecTriplets.size(), fp)
+			!= vecTriplets.size()
+		) {
+			_EXCEPTION1("Unable to write SparseMatrix run \"%s\"",
+				run.strFile.c_str());
+		}
+		run.sTriplets += vecTriplets.size();
+		vecTriplets.clear();
+	}
+
+	///	<summary>
+	///		Close a run, removing it if it could not be written.
+	///	</summary>
+	static void CloseRun(
+		FILE * fp,
+		const TripletRun & run,
+		bool fValid
+	) {
+		if ((fclose(fp) != 0) || !fValid) {
+			remove(run.strFile.c_str());
+			if (fValid) {
+				_EXCEPTION1("Unable to write SparseMatrix run \"%s\"",
+					run.strFile.c_str());
+			}
+		}
+	}
+
+	///	<summary>
+	///		Write the triplets buffered by one thread to a new run, sorted
+	///		by row and column with the order of addition preserved.  Runs
+	///		are then merged so that each thread has fewer than
+	///		SpillMergeRuns runs of each level.
+	///	</summary>
+	void Spill(
+		int iThread
+	) {
+		TripletBuffer & buffer = m_vecBuffers[iThread];
+
+		std::stable_sort(
+			buffer.vecTriplets.begin(),
+			buffer.vecTriplets.end(),
+			CompareRowColumn);
+
+		TripletRun run;
+		FILE * fp = OpenRun(iThread, 0, run);
+		try {
+			WriteRun(fp, run, buffer.vecTriplets);
+		} catch(...) {
+			CloseRun(fp, run, false);
+			throw;
+		}
+		CloseRun(fp, run, true);
+
+		buffer.vecRuns.push_back(run);
+
+		for (;;) {
+			const int nRuns = static_cast<int>(buffer.vecRuns.size());
+			if (nRuns < SpillMergeRuns) {
+				break;
+			}
+
+			const int nLevel = buffer.vecRuns[nRuns-1].nLevel;
+			if (buffer.vecRuns[nRuns-SpillMergeRuns].nLevel != nLevel) {
+				break;
+			}
+
+			MergeRuns(iThread, nRuns - SpillMergeRuns);
+		}
+	}
+
+	///	<summary>
+	///		Merge the runs of one thread from ixFirstRun onwards into one
+	///		run, without summing duplicates, so that the order in which
+	///		entries are summed is unchanged.  The buffered triplets of the
+	///		thread must be empty, as their memory is used for output.
+	///	</summary>
+	void MergeRuns(
+		int iThread,
+		int ixFirstRun
+	) {
+		TripletBuffer & buffer = m_vecBuffers[iThread];
+
+		const int nRuns = static_cast<int>(buffer.vecRuns.size());
+		if (nRuns - ixFirstRun < 2) {
+			return;
+		}
+
+		int nLevel = 0;
+		for (int r = ixFirstRun; r < nRuns; r++) {
+			if (buffer.vecRuns[r].nLevel > nLevel) {
+				nLevel = buffer.vecRuns[r].nLevel;
+			}
+		}
+
+		TripletRun run;
+		FILE * fp = OpenRun(iThread, nLevel + 1, run);
+		try {
+			std::vector< std::unique_ptr<TripletSource> > vecSources;
+			for (int r = ixFirstRun; r < nRuns; r++) {
+				vecSources.push_back(std::unique_ptr<TripletSource>(
+					new TripletSource(
+						buffer.vecRuns[r],
+						m_sSpillTriplets / (nRuns - ixFirstRun))));
+			}
+
+			std::vector<Triplet> & vecOut = buffer.vecTriplets;
+
+			TripletMerge merge(vecSources);
+			for (; !merge.IsDone(); merge.Pop()) {
+				vecOut.push_back(merge.Front());
+				if (vecOut.size() >= m_sSpillTriplets) {
+					WriteRun(fp, run, vecOut);
+				}
+			}
+			WriteRun(fp, run, vecOut);
+
+		} catch(...) {
+			buffer.vecTriplets.clear();
+			CloseRun(fp, run, false);
+			throw;
+		}
+		CloseRun(fp, run, true);
+
+		for (int r = ixFirstRun; r < nRuns; r++) {
+			remove(buffer.vecRuns[r].strFile.c_str());
+		}
+		buffer.vecRuns.resize(ixFirstRun);
+		buffer.vecRuns.push_back(run);
+	}
+
+	///	<summary>
+	///		Remove the files of all spilled runs.
+	///	</summary>
+	void RemoveRuns() {
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			std::vector<TripletRun> & vecRuns = m_vecBuffers[t].vecRuns;
+			for (int r = 0; r < vecRuns.size(); r++) {
+				remove(vecRuns[r].strFile.c_str());
+			}
+			vecRuns.clear();
+		}
+	}
+
+	///	<summary>
+	///		Merge the existing entries, the spilled runs and the buffered
+	///		triplets of all threads into the CSR arrays, summing entries of
+	///		each run in order and the runs in the order they were added.
+	///	</summary>
+	void FinalizeRuns() {
+
+		// Limit the number of runs which are open at once
+		size_t nRuns = 0;
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			nRuns += m_vecBuffers[t].vecRuns.size();
+		}
+
+		if (nRuns > SpillMaxFinalRuns) {
+			nRuns = 0;
+			for (int t = 0; t < m_vecBuffers.size(); t++) {
+				if (m_vecBuffers[t].vecRuns.size() == 0) {
+					continue;
+				}
+				if (m_vecBuffers[t].vecTriplets.size() != 0) {
+					Spill(t);
+				}
+				MergeRuns(t, 0);
+				nRuns++;
+			}
+		}
+
+		// Existing entries are summed first
+		std::vector<Triplet> vecExisting;
+		int nExistingRows = static_cast<int>(m_vecRowPtr.size()) - 1;
+		for (int i = 0; i < nExistingRows; i++) {
+			for (int j = m_vecRowPtr[i]; j < m_vecRowPtr[i+1]; j++) {
+				Triplet triplet;
+				triplet.iRow = i;
+				triplet.iCol = m_vecColIx[j];
+				triplet.value = m_vecValues[j];
+				vecExisting.push_back(triplet);
+			}
+		}
+
+		std::vector<int>().swap(m_vecColIx);
+		std::vector<DataType>().swap(m_vecValues);
+
+		// Sources in order of summation
+		size_t sBufferTriplets = m_sSpillTriplets;
+		if (nRuns != 0) {
+			sBufferTriplets = m_sSpillTriplets * m_vecBuffers.size() / nRuns;
+		}
+
+		std::vector< std::unique_ptr<TripletSource> > vecSources;
+
+		vecSources.push_back(std::unique_ptr<TripletSource>(
+			new TripletSource(
+				(vecExisting.size() == 0)?(NULL):(&(vecExisting[0])),
+				vecExisting.size())));
+
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			TripletBuffer & buffer = m_vecBuffers[t];
+
+			for (int r = 0; r < buffer.vecRuns.size(); r++) {
+				vecSources.push_back(std::unique_ptr<TripletSource>(
+					new TripletSource(buffer.vecRuns[r], sBufferTriplets)));
+			}
+
+			std::stable_sort(
+				buffer.vecTriplets.begin(),
+				buffer.vecTriplets.end(),
+				CompareRowColumn);
+
+			vecSources.push_back(std::unique_ptr<TripletSource>(
+				new TripletSource(
+					(buffer.vecTriplets.size() == 0)?
+						(NULL):(&(buffer.vecTriplets[0])),
+					buffer.vecTriplets.size())));
+		}
+
+		// Sum duplicates into the CSR arrays
+		m_vecRowPtr.assign(m_nRows + 1, 0);
+
+		int iLastRow = -1;
+		int iLastCol = -1;
+
+		TripletMerge merge(vecSources);
+		for (; !merge.IsDone(); merge.Pop()) {
+			const Triplet & triplet = merge.Front();
+
+			if ((triplet.iRow < 0) || (triplet.iCol < 0)) {
+				_EXCEPTION2("Invalid SparseMatrix entry (%i, %i)",
+					triplet.iRow, triplet.iCol);
+			}
+
+			if ((triplet.iRow == iLastRow) && (triplet.iCol == iLastCol)) {
+				m_vecValues.back() += triplet.value;
+			} else {
+				m_vecColIx.push_back(triplet.iCol);
+				m_vecValues.push_back(triplet.value);
+				m_vecRowPtr[triplet.iRow + 1]++;
+
+				iLastRow = triplet.iRow;
+				iLastCol = triplet.iCol;
+			}
+		}
+
+		for (int i = 0; i < m_nRows; i++) {
+			m_vecRowPtr[i+1] += m_vecRowPtr[i];
+		}
+
+		vecSources.clear();
+
+		// Release the triplets and runs
+		RemoveRuns();
+
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			std::vector<Triplet>().swap(m_vecBuffers[t].vecTriplets);
+			m_vecBuffers[t].nRows = 0;
+			m_vecBuffers[t].nCols = 0;
+		}
+	}
+
+public:
+	///	<summary>
+	///		Merge all buffered triplets into the CSR arrays.  Existing
+	///		entries are summed ahead of the buffered triplets.
+	///	</summary>
+	void Finalize() {
+		if (IsFinalized()) {
+			return;
+		}
+
+		Detach();
+
+		// Update dimensions
+		bool fSpilled = false;
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			if (m_vecBuffers[t].nRows > m_nRows) {
+				m_nRows = m_vecBuffers[t].nRows;
+			}
+			if (m_vecBuffers[t].nCols > m_nCols) {
+				m_nCols = m_vecBuffers[t].nCols;
+			}
+			if (m_vecBuffers[t].vecRuns.size() != 0) {
+				fSpilled = true;
+			}
+		}
+
+		if (fSpilled) {
+			FinalizeRuns();
+			return;
+		}
+
+		int nExistingRows = static_cast<int>(m_vecRowPtr.size()) - 1;
+
+		// Count the entries in each row
+		std::vector<size_t> vecRowBegin;
+		vecRowBegin.resize(m_nRows + 1, 0);
+
+		for (int i = 0; i < nExistingRows; i++) {
+			vecRowBegin[i+1] += m_vecRowPtr[i+1] - m_vecRowPtr[i];
+		}
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			const std::vector<Triplet> & vecTriplets =
+				m_vecBuffers[t].vecTriplets;
+
+			for (size_t i = 0; i < vecTriplets.size(); i++) {
+				if ((vecTriplets[i].iRow < 0) || (vecTriplets[i].iCol < 0)) {
+					_EXCEPTION2("Invalid SparseMatrix entry (%i, %i)",
+						vecTriplets[i].iRow, vecTriplets[i].iCol);
+				}
+				vecRowBegin[vecTriplets[i].iRow + 1]++;
+			}
+		}
+		for (int i = 0; i < m_nRows; i++) {
+			vecRowBegin[i+1] += vecRowBegin[i];
+		}
+
+		// Distribute all entries by row, preserving the order of addition
+		std::vector<Triplet> vecSorted;
+		vecSorted.resize(vecRowBegin[m_nRows]);
+
+		std::vector<size_t> vecRowNext(vecRowBegin.begin(), vecRowBegin.end());
+
+		for (int i = 0; i < nExistingRows; i++) {
+			for (int j = m_vecRowPtr[i]; j < m_vecRowPtr[i+1]; j++) {
+				Triplet & triplet = vecSorted[vecRowNext[i]++];
+				triplet.iRow = i;
+				triplet.iCol = m_vecColIx[j];
+				triplet.value = m_vecValues[j];
 			}
-			if (iCol >= m_nCols) {
-				m_nCols = iCol + 1;
+		}
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			std::vector<Triplet> & vecTriplets =
+				m_vecBuffers[t].vecTriplets;
+
+			for (size_t i = 0; i < vecTriplets.size(); i++) {
+				vecSorted[vecRowNext[vecTriplets[i].iRow]++] = vecTriplets[i];
 			}
 
-			SparseMapInsertResult result =
-				m_mapEntries.insert(
-					SparseMapPair(
-						IndexType(iRow, iCol), (DataType)(0)));
+			std::vector<Triplet>().swap(vecTriplets);
+			m_vecBuffers[t].nRows = 0;
+			m_vecBuffers[t].nCols = 0;
+		}
 
-			return result.first->second;
-		} else {
-			return iter->second;
+		// Sort each row by column and sum duplicates
+		m_vecRowPtr.resize(m_nRows + 1);
+		m_vecColIx.clear();
+		m_vecValues.clear();
+
+		m_vecRowPtr[0] = 0;
+		for (int i = 0; i < m_nRows; i++) {
+			typename std::vector<Triplet>::iterator iterBegin =
+				vecSorted.begin() + vecRowBegin[i];
+			typename std::vector<Triplet>::iterator iterEnd =
+				vecSorted.begin() + vecRowBegin[i+1];
+
+			std::stable_sort(iterBegin, iterEnd, CompareColumn);
+
+			for (; iterBegin != iterEnd; iterBegin++) {
+				if ((m_vecColIx.size() != m_vecRowPtr[i]) &&
+					(m_vecColIx.back() == iterBegin->iCol)
+				) {
+					m_vecValues.back() += iterBegin->value;
+				} else {
+					m_vecColIx.push_back(iterBegin->iCol);
+					m_vecValues.push_back(iterBegin->value);
+				}
+			}
+
+			m_vecRowPtr[i+1] = static_cast<int>(m_vecColIx.size());
+		}
+	}
+
+	///	<summary>
+	///		Set this matrix to a finalized matrix of another DataType,
+	///		converting each entry.
+	///	</summary>
+	template <typename OtherType>
+	void ConvertFrom(
+		const SparseMatrix<OtherType> & mat
+	) {
+		if (!mat.IsFinalized()) {
+			_EXCEPTIONT("SparseMatrix must be finalized before conversion");
+		}
+
+		Clear();
+
+		const int nRows = mat.GetRows();
+		const int nNonZeros = mat.GetNonZeros();
+
+		const int * piRowPtr = mat.GetRowPtr();
+		const int * piColIx = mat.GetColIx();
+		const OtherType * pValues = mat.GetValues();
+
+		m_nRows = nRows;
+		m_nCols = mat.GetColumns();
+
+		m_vecRowPtr.assign(piRowPtr, piRowPtr + nRows + 1);
+		m_vecColIx.assign(piColIx, piColIx + nNonZeros);
+
+		m_vecValues.resize(nNonZeros);
+		for (int j = 0; j < nNonZeros; j++) {
+			m_vecValues[j] = static_cast<DataType>(pValues[j]);
+		}
+	}
+
+	///	<summary>
+	///		Use CSR arrays stored outside of this object, such as in a memory
+	///		mapped file, in place of the CSR arrays of this object.  The
+	///		arrays are not copied and must remain valid until the matrix is
+	///		cleared or modified.
+	///	</summary>
+	void AttachExternal(
+		int nRows,
+		int nCols,
+		int nNonZeros,
+		const int * piRowPtr,
+		const int * piColIx,
+		const DataType * pValues
+	) {
+		Clear();
+
+		m_nRows = nRows;
+		m_nCols = nCols;
+
+		m_nExtNonZeros = nNonZeros;
+		m_piExtRowPtr = piRowPtr;
+		m_piExtColIx = piColIx;
+		m_pExtValues = pValues;
+	}
+
+	///	<summary>
+	///		Determine if the matrix uses external CSR arrays.
+	///	</summary>
+	bool IsExternal() const {
+		return (m_piExtRowPtr != NULL);
+	}
+
+	///	<summary>
+	///		Copy external CSR arrays into this object, so that the matrix no
+	///		longer refers to them.
+	///	</summary>
+	void Detach() {
+		if (!IsExternal()) {
+			return;
+		}
+
+		m_vecRowPtr.assign(m_piExtRowPtr, m_piExtRowPtr + m_nRows + 1);
+		m_vecColIx.assign(m_piExtColIx, m_piExtColIx + m_nExtNonZeros);
+		m_vecValues.assign(m_pExtValues, m_pExtValues + m_nExtNonZeros);
+
+		m_nExtNonZeros = 0;
+		m_piExtRowPtr = NULL;
+		m_piExtColIx = NULL;
+		m_pExtValues = NULL;
+	}
+
+	///	<summary>
+	///		Remove all entries.
+	///	</summary>
+	void Clear() {
+		m_nRows = 0;
+		m_nCols = 0;
+
+		m_nExtNonZeros = 0;
+		m_piExtRowPtr = NULL;
+		m_piExtColIx = NULL;
+		m_pExtValues = NULL;
+
+		m_vecRowPtr.assign(1, 0);
+		m_vecColIx.clear();
+		m_vecValues.clear();
+
+		RemoveRuns();
+
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			m_vecBuffers[t] = TripletBuffer();
 		}
 	}
 
@@ -76,42 +963,168 @@ public:
 	///		Get the number of rows in the SparseMatrix.
 	///	</summary>
 	int GetRows() const {
-		return m_nRows;
+		int nRows = m_nRows;
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			if (m_vecBuffers[t].nRows > nRows) {
+				nRows = m_vecBuffers[t].nRows;
+			}
+		}
+		return nRows;
 	}
 
 	///	<summary>
 	///		Get the number of columns in the SparseMatrix.
 	///	</summary>
 	int GetColumns() const {
-		return m_nCols;
+		int nCols = m_nCols;
+		for (int t = 0; t < m_vecBuffers.size(); t++) {
+			if (m_vecBuffers[t].nCols > nCols) {
+				nCols = m_vecBuffers[t].nCols;
+			}
+		}
+		return nCols;
+	}
+
+	///	<summary>
+	///		Get the number of finalized non-zero entries.
+	///	</summary>
+	int GetNonZeros() const {
+		if (IsExternal()) {
+			return m_nExtNonZeros;
+		}
+		return static_cast<int>(m_vecValues.size());
+	}
+
+	///	<summary>
+	///		Get the CSR row pointer array, of size GetRows()+1.
+	///	</summary>
+	const int * GetRowPtr() const {
+		if (IsExternal()) {
+			return m_piExtRowPtr;
+		}
+		return &(m_vecRowPtr[0]);
+	}
+
+	///	<summary>
+	///		Get the CSR column index array.
+	///	</summary>
+	const int * GetColIx() const {
+		if (IsExternal()) {
+			return m_piExtColIx;
+		}
+		return (m_vecColIx.size() == 0)?(NULL):(&(m_vecColIx[0]));
+	}
+
+	///	<summary>
+	///		Get the CSR value array.
+	///	</summary>
+	const DataType * GetValues() const {
+		if (IsExternal()) {
+			return m_pExtValues;
+		}
+		return (m_vecValues.size() == 0)?(NULL):(&(m_vecValues[0]));
 	}
 
 	///	<summary>
-	///		Get the entries of the SparseMatrix.
+	///		Get the entries of the SparseMatrix in row-major order.
 	///	</summary>
 	void GetEntries(
 		DataVector<int> & dataRows,
 		DataVector<int> & dataCols,
 		DataVector<DataType> & dataEntries
 	) {
-		dataRows.Initialize(m_mapEntries.size());
-		dataCols.Initialize(m_mapEntries.size());
-		dataEntries.Initialize(m_mapEntries.size());
+		Finalize();
+
+		const int * piRowPtr = GetRowPtr();
+		const int * piColIx = GetColIx();
+		const DataType * pValues = GetValues();
+
+		dataRows.Initialize(GetNonZeros());
+		dataCols.Initialize(GetNonZeros());
+		dataEntries.Initialize(GetNonZeros());
+
+		for (int i = 0; i < m_nRows; i++) {
+			for (int j = piRowPtr[i]; j < piRowPtr[i+1]; j++) {
+				dataRows[j] = i;
+				dataCols[j] = piColIx[j];
+				dataEntries[j] = pValues[j];
+			}
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Distribute entries which are not in row-major order into the
+	///		CSR arrays.  Where an entry (row, col) is repeated only the
+	///		first value is kept.  m_nRows and m_nCols must already be set.
+	///	</summary>
+	void SetUnorderedEntries(
+		const DataVector<int> & dataRows,
+		const DataVector<int> & dataCols,
+		const DataVector<DataType> & dataEntries
+	) {
+		int nEntries = static_cast<int>(dataRows.GetRows());
+
+		// Count the entries in each row
+		std::vector<size_t> vecRowBegin;
+		vecRowBegin.resize(m_nRows + 1, 0);
+
+		for (int i = 0; i < nEntries; i++) {
+			vecRowBegin[dataRows[i] + 1]++;
+		}
+		for (int i = 0; i < m_nRows; i++) {
+			vecRowBegin[i+1] += vecRowBegin[i];
+		}
+
+		// Distribute all entries by row, preserving their order
+		std::vector<Triplet> vecSorted;
+		vecSorted.resize(nEntries);
+
+		std::vector<size_t> vecRowNext(vecRowBegin.begin(), vecRowBegin.end());
 
-		int ix = 0;
+		for (int i = 0; i < nEntries; i++) {
+			Triplet & triplet = vecSorted[vecRowNext[dataRows[i]]++];
+			triplet.iRow = dataRows[i];
+			triplet.iCol = dataCols[i];
+			triplet.value = dataEntries[i];
+		}
+
+		// Sort each row by column and keep the first of any duplicates
+		m_vecRowPtr.resize(m_nRows + 1);
+		m_vecColIx.clear();
+		m_vecValues.clear();
+		m_vecColIx.reserve(nEntries);
+		m_vecValues.reserve(nEntries);
 
-		SparseMapConstIterator iter = m_mapEntries.begin();
-		for (; iter != m_mapEntries.end(); iter++) {
-			dataRows[ix] = iter->first.first;
-			dataCols[ix] = iter->first.second;
-			dataEntries[ix] = iter->second;
+		m_vecRowPtr[0] = 0;
+		for (int i = 0; i < m_nRows; i++) {
+			typename std::vector<Triplet>::iterator iterBegin =
+				vecSorted.begin() + vecRowBegin[i];
+			typename std::vector<Triplet>::iterator iterEnd =
+				vecSorted.begin() + vecRowBegin[i+1];
 
-			ix++;
+			std::stable_sort(iterBegin, iterEnd, CompareColumn);
+
+			for (; iterBegin != iterEnd; iterBegin++) {
+				if ((m_vecColIx.size() != m_vecRowPtr[i]) &&
+					(m_vecColIx.back() == iterBegin->iCol)
+				) {
+					continue;
+				}
+				m_vecColIx.push_back(iterBegin->iCol);
+				m_vecValues.push_back(iterBegin->value);
+			}
+
+			m_vecRowPtr[i+1] = static_cast<int>(m_vecColIx.size());
 		}
 	}
 
+public:
 	///	<summary>
-	///		Set the entries of the SparseMatrix in bulk.
+	///		Set the entries of the SparseMatrix in bulk.  Entries which are
+	///		already in row-major order are copied directly into the CSR
+	///		arrays; otherwise they are sorted and, as before, only the first
+	///		value of any repeated entry (row, col) is kept.
 	///	</summary>
 	void SetEntries(
 		const DataVector<int> & dataRows,
@@ -125,23 +1138,186 @@ public:
 			_EXCEPTIONT("Mismatch between size of dataRows and dataEntries");
 		}
 
-		m_nRows = 0;
-		m_nCols = 0;
+		Clear();
 
-		m_mapEntries.clear();
+		int nEntries = static_cast<int>(dataRows.GetRows());
 
-		for (int i = 0; i < dataRows.GetRows(); i++) {
+		// Check for row-major order without duplicates
+		bool fOrdered = true;
+		for (int i = 0; i < nEntries; i++) {
+			if ((dataRows[i] < 0) || (dataCols[i] < 0)) {
+				_EXCEPTION2("Invalid SparseMatrix entry (%i, %i)",
+					dataRows[i], dataCols[i]);
+			}
 			if (dataRows[i] >= m_nRows) {
 				m_nRows = dataRows[i] + 1;
 			}
 			if (dataCols[i] >= m_nCols) {
 				m_nCols = dataCols[i] + 1;
 			}
+			if ((i != 0) &&
+				((dataRows[i] < dataRows[i-1]) ||
+				((dataRows[i] == dataRows[i-1]) &&
+				 (dataCols[i] <= dataCols[i-1])))
+			) {
+				fOrdered = false;
+			}
+		}
+
+		if (!fOrdered) {
+			SetUnorderedEntries(dataRows, dataCols, dataEntries);
+			return;
+		}
+
+		m_vecRowPtr.assign(m_nRows + 1, 0);
+		m_vecColIx.resize(nEntries);
+		m_vecValues.resize(nEntries);
 
-			m_mapEntries.insert(
-				SparseMapPair(
-					IndexType(dataRows[i], dataCols[i]),
-						dataEntries[i]));
+		for (int i = 0; i < nEntries; i++) {
+			m_vecRowPtr[dataRows[i] + 1]++;
+			m_vecColIx[i] = dataCols[i];
+			m_vecValues[i] = dataEntries[i];
+		}
+		for (int i = 0; i < m_nRows; i++) {
+			m_vecRowPtr[i+1] += m_vecRowPtr[i];
+		}
+	}
+
+public:
+	///	<summary>
+	///		Set this matrix to the product matA * matB (SpGEMM).  Entries of
+	///		the product with magnitude no greater than dDropTolerance are
+	///		dropped.  Both matrices must be finalized.  Rows of the product
+	///		are computed in parallel, each with a dense accumulator over the
+	///		columns of matB, and each row is summed in order of the entries
+	///		of matA and matB so that the result does not depend on the
+	///		number of threads.
+	///	</summary>
+	void Multiply(
+		const SparseMatrix<DataType> & matA,
+		const SparseMatrix<DataType> & matB,
+		DataType dDropTolerance = 0
+	) {
+		if ((!matA.IsFinalized()) || (!matB.IsFinalized())) {
+			_EXCEPTIONT("SparseMatrix must be finalized before Multiply");
+		}
+		if ((&matA == this) || (&matB == this)) {
+			_EXCEPTIONT("SparseMatrix product cannot be computed in place");
+		}
+
+		const int nRows = matA.GetRows();
+		const int nCols = matB.GetColumns();
+		const int nInner = matB.GetRows();
+
+		const int * piRowPtrA = matA.GetRowPtr();
+		const int * piColIxA = matA.GetColIx();
+		const DataType * pValuesA = matA.GetValues();
+
+		const int * piRowPtrB = matB.GetRowPtr();
+		const int * piColIxB = matB.GetColIx();
+		const DataType * pValuesB = matB.GetValues();
+
+		// Number of entries of each row of the product
+		std::vector<int> vecRowCount(nRows, 0);
+
+		// Entries of each thread, for a contiguous range of rows
+		int nThreads = 1;
+#ifdef _OPENMP
+		nThreads = omp_get_max_threads();
+#endif
+		std::vector< std::vector<int> > vecThreadColIx(nThreads);
+		std::vector< std::vector<DataType> > vecThreadValues(nThreads);
+
+		int nThreadsUsed = 1;
+
+#pragma omp parallel
+		{
+			int iThread = 0;
+			int nTeam = 1;
+#ifdef _OPENMP
+			iThread = omp_get_thread_num();
+			nTeam = omp_get_num_threads();
+#endif
+#pragma omp single
+			nThreadsUsed = nTeam;
+
+			const int iRowBegin =
+				static_cast<int>((static_cast<long>(nRows) * iThread) / nTeam);
+			const int iRowEnd =
+				static_cast<int>((static_cast<long>(nRows) * (iThread+1)) / nTeam);
+
+			std::vector<int> & vecColIx = vecThreadColIx[iThread];
+			std::vector<DataType> & vecValues = vecThreadValues[iThread];
+
+			// Dense accumulator and list of occupied columns
+			std::vector<DataType> vecAccum(nCols, 0);
+			std::vector<int> vecMarker(nCols, -1);
+			std::vector<int> vecOccupied;
+
+			for (int i = iRowBegin; i < iRowEnd; i++) {
+				vecOccupied.clear();
+
+				for (int ja = piRowPtrA[i]; ja < piRowPtrA[i+1]; ja++) {
+					const int k = piColIxA[ja];
+					if (k >= nInner) {
+						continue;
+					}
+
+					const DataType dA = pValuesA[ja];
+
+					for (int jb = piRowPtrB[k]; jb < piRowPtrB[k+1]; jb++) {
+						const int j = piColIxB[jb];
+						if (vecMarker[j] != i) {
+							vecMarker[j] = i;
+							vecAccum[j] = 0;
+							vecOccupied.push_back(j);
+						}
+						vecAccum[j] += dA * pValuesB[jb];
+					}
+				}
+
+				std::sort(vecOccupied.begin(), vecOccupied.end());
+
+				int nCount = 0;
+				for (int n = 0; n < vecOccupied.size(); n++) {
+					const int j = vecOccupied[n];
+					const DataType dValue = vecAccum[j];
+					if ((dValue > dDropTolerance) || (-dValue > dDropTolerance)) {
+						vecColIx.push_back(j);
+						vecValues.push_back(dValue);
+						nCount++;
+					}
+				}
+				vecRowCount[i] = nCount;
+			}
+		}
+
+		// Assemble the CSR arrays
+		Clear();
+
+		m_nRows = nRows;
+
+		m_vecRowPtr.resize(nRows + 1);
+		m_vecRowPtr[0] = 0;
+		for (int i = 0; i < nRows; i++) {
+			m_vecRowPtr[i+1] = m_vecRowPtr[i] + vecRowCount[i];
+		}
+
+		m_vecColIx.reserve(m_vecRowPtr[nRows]);
+		m_vecValues.reserve(m_vecRowPtr[nRows]);
+
+		for (int t = 0; t < nThreadsUsed; t++) {
+			m_vecColIx.insert(m_vecColIx.end(),
+				vecThreadColIx[t].begin(), vecThreadColIx[t].end());
+			m_vecValues.insert(m_vecValues.end(),
+				vecThreadValues[t].begin(), vecThreadValues[t].end());
+		}
+
+		m_nCols = 0;
+		for (int j = 0; j < m_vecColIx.size(); j++) {
+			if (m_vecColIx[j] >= m_nCols) {
+				m_nCols = m_vecColIx[j] + 1;
+			}
 		}
 	}
 
@@ -161,12 +1337,201 @@ public:
 			_EXCEPTION1("dataVectorOut has incorrect row count (%i)", m_nRows);
 		}
 */
+		if (!IsFinalized()) {
+			_EXCEPTIONT("SparseMatrix must be finalized before Apply");
+		}
+
 		dataVectorOut.Zero();
 
-		SparseMapConstIterator iter = m_mapEntries.begin();
-		for (; iter != m_mapEntries.end(); iter++) {
-			dataVectorOut[iter->first.first] +=
-				iter->second * dataVectorIn[iter->first.second];
+		const int * piRowPtr = GetRowPtr();
+		const int * piColIx = GetColIx();
+		const DataType * pValues = GetValues();
+		const DataType * pIn = dataVectorIn;
+		DataType * pOut = dataVectorOut;
+
+		// Each row is owned by a single thread and summed in a fixed order,
+		// so the result does not depend on the number of threads
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < m_nRows; i++) {
+			pOut[i] = static_cast<DataType>(RowProduct(
+				piColIx, pValues, piRowPtr[i], piRowPtr[i+1], pIn));
+		}
+	}
+
+	///	<summary>
+	///		Apply the sparse matrix to nVectors vectors stored one after
+	///		another in caller-owned arrays, so that entry i of vector k is
+	///		stored at pIn[k * nInStride + i] and pOut[k * nOutStride + i].
+	///		Entries of each output vector beyond the last row of the matrix
+	///		are set to zero.  Each vector is summed in the same order as
+	///		Apply, in double precision, for matrix and vectors of any
+	///		precision.  If fParallel is false the rows are not distributed
+	///		over OpenMP threads, so that several threads may apply the
+	///		matrix concurrently.
+	///	</summary>
+	template <typename VectorType>
+	void ApplyStrided(
+		const VectorType * pIn,
+		int nInStride,
+		VectorType * pOut,
+		int nOutStride,
+		int nVectors,
+		bool fParallel = true
+	) const {
+		if (!IsFinalized()) {
+			_EXCEPTIONT("SparseMatrix must be finalized before Apply");
+		}
+		if ((nInStride < m_nCols) || (nOutStride < m_nRows)) {
+			_EXCEPTION4("Vector stride (%i, %i) smaller than SparseMatrix "
+				"dimensions (%i, %i)", nOutStride, nInStride, m_nRows, m_nCols);
+		}
+		if (nVectors < 0) {
+			_EXCEPTION1("Invalid number of vectors (%i)", nVectors);
+		}
+
+		const int * piRowPtr = GetRowPtr();
+		const int * piColIx = GetColIx();
+		const DataType * pValues = GetValues();
+
+		// Each row is loaded once for all vectors
+#pragma omp parallel for schedule(static) if(fParallel)
+		for (int i = 0; i < m_nRows; i++) {
+			for (int k = 0; k < nVectors; k++) {
+				pOut[static_cast<size_t>(k) * nOutStride + i] =
+					static_cast<VectorType>(RowProduct(
+						piColIx, pValues, piRowPtr[i], piRowPtr[i+1],
+						pIn + static_cast<size_t>(k) * nInStride));
+			}
+		}
+
+		for (int k = 0; k < nVectors; k++) {
+			VectorType * pOutVector = pOut + static_cast<size_t>(k) * nOutStride;
+			for (int i = m_nRows; i < nOutStride; i++) {
+				pOutVector[i] = 0;
+			}
+		}
+	}
+
+	///	<summary>
+	///		Apply the sparse matrix to nVectors vectors at once (SpMM).  The
+	///		vectors are interleaved, so that entry i of vector k is stored
+	///		at pIn[i * nVectors + k] and pOut[i * nVectors + k].  Each matrix
+	///		entry is loaded once for all vectors, and each vector is summed
+	///		in the same order as Apply.  Sums are accumulated in double
+	///		precision for any DataType.
+	///	</summary>
+	void ApplyMultiple(
+		const DataType * pIn,
+		DataType * pOut,
+		int nVectors
+	) const {
+		if (!IsFinalized()) {
+			_EXCEPTIONT("SparseMatrix must be finalized before Apply");
+		}
+		if (nVectors < 1) {
+			_EXCEPTION1("Invalid number of vectors (%i)", nVectors);
+		}
+
+		const int * piRowPtr = GetRowPtr();
+		const int * piColIx = GetColIx();
+		const DataType * pValues = GetValues();
+
+#pragma omp parallel
+		{
+			// Four partial sums for each vector
+			std::vector<double> vecSum(4 * nVectors);
+
+			double * pSum0 = &(vecSum[0]);
+			double * pSum1 = pSum0 + nVectors;
+			double * pSum2 = pSum1 + nVectors;
+			double * pSum3 = pSum2 + nVectors;
+
+#pragma omp for schedule(static)
+			for (int i = 0; i < m_nRows; i++) {
+				const int jBegin = piRowPtr[i];
+				const int jEnd = piRowPtr[i+1];
+
+				for (int k = 0; k < 4 * nVectors; k++) {
+					pSum0[k] = 0;
+				}
+
+				int j = jBegin;
+				for (; j + 3 < jEnd; j += 4) {
+					AccumulateMultiple(
+						piColIx, pValues, pSum0, j, pIn, nVectors);
+					AccumulateMultiple(
+						piColIx, pValues, pSum1, j+1, pIn, nVectors);
+					AccumulateMultiple(
+						piColIx, pValues, pSum2, j+2, pIn, nVectors);
+					AccumulateMultiple(
+						piColIx, pValues, pSum3, j+3, pIn, nVectors);
+				}
+				for (; j < jEnd; j++) {
+					AccumulateMultiple(
+						piColIx, pValues, pSum0, j, pIn, nVectors);
+				}
+
+				DataType * pRowOut = pOut + static_cast<size_t>(i) * nVectors;
+				for (int k = 0; k < nVectors; k++) {
+					pRowOut[k] = static_cast<DataType>(
+						(pSum0[k] + pSum1[k]) + (pSum2[k] + pSum3[k]));
+				}
+			}
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Inner product of the entries [jBegin, jEnd) of the CSR arrays with
+	///		pIn.  Four independent partial sums are carried so that the
+	///		gathers from pIn may be vectorized, and are combined pairwise.
+	///		Sums are accumulated in double precision.
+	///	</summary>
+	template <typename VectorType>
+	static inline double RowProduct(
+		const int * piColIx,
+		const DataType * pValues,
+		int jBegin,
+		int jEnd,
+		const VectorType * pIn
+	) {
+		double dSum0 = 0;
+		double dSum1 = 0;
+		double dSum2 = 0;
+		double dSum3 = 0;
+
+		int j = jBegin;
+		for (; j + 3 < jEnd; j += 4) {
+			dSum0 += static_cast<double>(pValues[j  ]) * pIn[piColIx[j  ]];
+			dSum1 += static_cast<double>(pValues[j+1]) * pIn[piColIx[j+1]];
+			dSum2 += static_cast<double>(pValues[j+2]) * pIn[piColIx[j+2]];
+			dSum3 += static_cast<double>(pValues[j+3]) * pIn[piColIx[j+3]];
+		}
+		for (; j < jEnd; j++) {
+			dSum0 += static_cast<double>(pValues[j]) * pIn[piColIx[j]];
+		}
+
+		return ((dSum0 + dSum1) + (dSum2 + dSum3));
+	}
+
+	///	<summary>
+	///		Add the contribution of CSR entry j to the partial sums of
+	///		nVectors interleaved vectors.
+	///	</summary>
+	static inline void AccumulateMultiple(
+		const int * piColIx,
+		const DataType * pValues,
+		double * pSum,
+		int j,
+		const DataType * pIn,
+		int nVectors
+	) {
+		const double dValue = pValues[j];
+		const DataType * pInCol =
+			pIn + static_cast<size_t>(piColIx[j]) * nVectors;
+
+		for (int k = 0; k < nVectors; k++) {
+			pSum[k] += dValue * static_cast<double>(pInCol[k]);
 		}
 	}
 
@@ -182,9 +1547,49 @@ protected:
 	int m_nCols;
 
 	///	<summary>
-	///		Entries of the sparse matrix.
+	///		Index of the first entry of each row, followed by the number of
+	///		entries.
+	///	</summary>
+	std::vector<int> m_vecRowPtr;
+
+	///	<summary>
+	///		Column index of each entry.
+	///	</summary>
+	std::vector<int> m_vecColIx;
+
+	///	<summary>
+	///		Value of each entry.
+	///	</summary>
+	std::vector<DataType> m_vecValues;
+
+	///	<summary>
+	///		Number of non-zero entries in the external CSR arrays.
+	///	</summary>
+	int m_nExtNonZeros;
+
+	///	<summary>
+	///		External CSR arrays, or NULL if the CSR arrays of this object
+	///		are used.
+	///	</summary>
+	const int * m_piExtRowPtr;
+	const int * m_piExtColIx;
+	const DataType * m_pExtValues;
+
+	///	<summary>
+	///		Triplets which have not yet been finalized, for each thread.
+	///	</summary>
+	std::vector<TripletBuffer> m_vecBuffers;
+
+	///	<summary>
+	///		Number of triplets of each thread at which they are spilled, or
+	///		zero if triplets are not spilled.
+	///	</summary>
+	size_t m_sSpillTriplets;
+
+	///	<summary>
+	///		Directory of spilled runs.
 	///	</summary>
-	SparseMap m_mapEntries;
+	std::string m_strSpillDirectory;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,221 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    SparseMatrixDevice.h
+///	\author  Paul Ullrich
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _SPARSEMATRIXDEVICE_H_
+#define _SPARSEMATRIXDEVICE_H_
+
+#include "SparseMatrix.h"
+#include "Exception.h"
+
+#ifdef USE_OPENMP_OFFLOAD
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A copy of the CSR arrays of a finalized SparseMatrix in the memory
+///		of an accelerator device, such as a GPU, to which the matrix is
+///		applied with OpenMP target offload.  The arrays are uploaded once
+///		by the constructor and released by the destructor; only the input
+///		and output vectors are transferred by each ApplyMultiple.  The
+///		SparseMatrix must not be modified while this object exists.
+///	</summary>
+template <typename DataType>
+class SparseMatrixDevice {
+
+public:
+	///	<summary>
+	///		Determine if an offload device is available.  Always false if
+	///		compiled without OFFLOAD=True.
+	///	</summary>
+	static bool IsAvailable() {
+#ifdef USE_OPENMP_OFFLOAD
+		return (omp_get_num_devices() > 0);
+#else
+		return false;
+#endif
+	}
+
+public:
+	///	<summary>
+	///		Constructor.  Uploads the CSR arrays of mat to the default
+	///		device.
+	///	</summary>
+	SparseMatrixDevice(
+		const SparseMatrix<DataType> & mat
+	) {
+		if (!mat.IsFinalized()) {
+			_EXCEPTIONT("SparseMatrix must be finalized before upload");
+		}
+		if (!IsAvailable()) {
+			_EXCEPTIONT("No offload device available");
+		}
+
+		m_nRows = mat.GetRows();
+		m_nCols = mat.GetColumns();
+		m_nNonZeros = mat.GetNonZeros();
+
+		m_piRowPtr = mat.GetRowPtr();
+		m_piColIx = mat.GetColIx();
+		m_pValues = mat.GetValues();
+
+#ifdef USE_OPENMP_OFFLOAD
+		m_iDevice = omp_get_default_device();
+
+		const int * piRowPtr = m_piRowPtr;
+		const int * piColIx = m_piColIx;
+		const DataType * pValues = m_pValues;
+		const int nRows = m_nRows;
+		const int nNonZeros = m_nNonZeros;
+
+#pragma omp target enter data device(m_iDevice) \
+	map(to: piRowPtr[0:nRows+1], \
+		piColIx[0:nNonZeros], \
+		pValues[0:nNonZeros])
+#endif
+	}
+
+	///	<summary>
+	///		Destructor.  Releases the CSR arrays on the device.
+	///	</summary>
+	~SparseMatrixDevice() {
+#ifdef USE_OPENMP_OFFLOAD
+		const int * piRowPtr = m_piRowPtr;
+		const int * piColIx = m_piColIx;
+		const DataType * pValues = m_pValues;
+		const int nRows = m_nRows;
+		const int nNonZeros = m_nNonZeros;
+
+#pragma omp target exit data device(m_iDevice) \
+	map(delete: piRowPtr[0:nRows+1], \
+		piColIx[0:nNonZeros], \
+		pValues[0:nNonZeros])
+#endif
+	}
+
+private:
+	///	<summary>
+	///		Copy constructor (not implemented).
+	///	</summary>
+	SparseMatrixDevice(const SparseMatrixDevice &);
+
+	///	<summary>
+	///		Assignment operator (not implemented).
+	///	</summary>
+	SparseMatrixDevice & operator=(const SparseMatrixDevice &);
+
+public:
+	///	<summary>
+	///		Get the number of rows.
+	///	</summary>
+	int GetRows() const {
+		return m_nRows;
+	}
+
+	///	<summary>
+	///		Get the number of columns.
+	///	</summary>
+	int GetColumns() const {
+		return m_nCols;
+	}
+
+	///	<summary>
+	///		Apply the matrix on the device to nVectors interleaved vectors,
+	///		with the same layout as SparseMatrix::ApplyMultiple.  Each vector
+	///		is summed with four partial sums in the same order as
+	///		SparseMatrix::ApplyMultiple, in double precision for any
+	///		DataType, although the device may contract products and sums.
+	///	</summary>
+	void ApplyMultiple(
+		const DataType * pIn,
+		DataType * pOut,
+		int nVectors
+	) const {
+		if (nVectors < 1) {
+			_EXCEPTION1("Invalid number of vectors (%i)", nVectors);
+		}
+
+#ifdef USE_OPENMP_OFFLOAD
+		const int * piRowPtr = m_piRowPtr;
+		const int * piColIx = m_piColIx;
+		const DataType * pValues = m_pValues;
+		const int nRows = m_nRows;
+		const size_t sIn = static_cast<size_t>(m_nCols) * nVectors;
+		const size_t sOut = static_cast<size_t>(m_nRows) * nVectors;
+
+#pragma omp target teams distribute parallel for collapse(2) \
+	device(m_iDevice) map(to: pIn[0:sIn]) map(from: pOut[0:sOut])
+		for (int i = 0; i < nRows; i++) {
+		for (int k = 0; k < nVectors; k++) {
+			const int jBegin = piRowPtr[i];
+			const int jEnd = piRowPtr[i+1];
+
+			double dSum0 = 0;
+			double dSum1 = 0;
+			double dSum2 = 0;
+			double dSum3 = 0;
+
+			int j = jBegin;
+			for (; j + 3 < jEnd; j += 4) {
+				dSum0 += static_cast<double>(pValues[j  ])
+					* pIn[static_cast<size_t>(piColIx[j  ]) * nVectors + k];
+				dSum1 += static_cast<double>(pValues[j+1])
+					* pIn[static_cast<size_t>(piColIx[j+1]) * nVectors + k];
+				dSum2 += static_cast<double>(pValues[j+2])
+					* pIn[static_cast<size_t>(piColIx[j+2]) * nVectors + k];
+				dSum3 += static_cast<double>(pValues[j+3])
+					* pIn[static_cast<size_t>(piColIx[j+3]) * nVectors + k];
+			}
+			for (; j < jEnd; j++) {
+				dSum0 += static_cast<double>(pValues[j])
+					* pIn[static_cast<size_t>(piColIx[j]) * nVectors + k];
+			}
+
+			pOut[static_cast<size_t>(i) * nVectors + k] =
+				static_cast<DataType>((dSum0 + dSum1) + (dSum2 + dSum3));
+		}
+		}
+#else
+		_EXCEPTIONT("Offload requires compilation with OFFLOAD=True");
+#endif
+	}
+
+private:
+	///	<summary>
+	///		Dimensions of the matrix.
+	///	</summary>
+	int m_nRows;
+	int m_nCols;
+	int m_nNonZeros;
+
+	///	<summary>
+	///		Host CSR arrays, which identify the device copies.
+	///	</summary>
+	const int * m_piRowPtr;
+	const int * m_piColIx;
+	const DataType * m_pValues;
+
+	///	<summary>
+	///		Device holding the CSR arrays.
+	///	</summary>
+	int m_iDevice;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -19,16 +19,23 @@
 #include "Exception.h"
 #include "GridElements.h"
 #include "OverlapMesh.h"
-#include "DataMatrix3D.h"
+#include "GLLElementData.h"
 #include "FiniteElementTools.h"
 #include "SparseMatrix.h"
 
 #include "OfflineMap.h"
 #include "LinearRemapSE0.h"
 #include "LinearRemapFV.h"
+#include "FaceQuadratureTable.h"
+#include "ContentCache.h"
 
 #include "netcdfcpp.h"
 #include <cmath>
+#include <cstdio>
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -65,10 +72,57 @@ void ParseVariableList(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Read a list of input and output data file pairs.  Each line of the
+///		file contains an input data file followed by an output data file;
+///		empty lines and lines beginning with '#' are ignored.
+///	</summary>
+void ReadDataFileList(
+	const std::string & strDataList,
+	std::vector< std::string > & vecInputData,
+	std::vector< std::string > & vecOutputData
+) {
+	FILE * fp = fopen(strDataList.c_str(), "r");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open data list \"%s\"", strDataList.c_str());
+	}
+
+	char szLine[4096];
+	char szInput[4096];
+	char szOutput[4096];
+	char szExtra[4096];
+
+	int iLine = 0;
+
+	while (fgets(szLine, sizeof(szLine), fp) != NULL) {
+		iLine++;
+
+		int nFiles = sscanf(szLine, "%4095s %4095s %4095s",
+			szInput, szOutput, szExtra);
+
+		if ((nFiles <= 0) || (szInput[0] == '#')) {
+			continue;
+		}
+
+		if (nFiles != 2) {
+			fclose(fp);
+			_EXCEPTION2("Line %i of data list \"%s\" must contain an "
+				"input and an output data file", iLine, strDataList.c_str());
+		}
+
+		vecInputData.push_back(szInput);
+		vecOutputData.push_back(szOutput);
+	}
+
+	fclose(fp);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void LoadMetaDataFile(
 	const std::string & strMetaFile,
-	DataMatrix3D<int> & dataGLLNodes,
-	DataMatrix3D<double> & dataGLLJacobian
+	GLLElementData<int> & dataGLLNodes,
+	GLLElementData<double> & dataGLLJacobian
 ) {
 	NcFile ncMeta(strMetaFile.c_str(), NcFile::ReadOnly);
 
@@ -81,17 +135,31 @@ void LoadMetaDataFile(
 	int nP = dimNp->size();
 	int nElem = dimNelem->size();
 
-	dataGLLNodes.Initialize(nP, nP, nElem);
-	dataGLLJacobian.Initialize(nP, nP, nElem);
+	dataGLLNodes.Initialize(nP, nElem, false);
+	dataGLLJacobian.Initialize(nP, nElem, false);
+
+	// Metadata is stored as [p][q][element]
+	DataVector<int> vecGLLNodes;
+	vecGLLNodes.Initialize(nP * nP * nElem);
+
+	DataVector<double> vecGLLJacobian;
+	vecGLLJacobian.Initialize(nP * nP * nElem);
+
+	varGLLNodes->get(&(vecGLLNodes[0]), nP, nP, nElem);
+	varGLLJacobian->get(&(vecGLLJacobian[0]), nP, nP, nElem);
 
-	varGLLNodes->get(&(dataGLLNodes[0][0][0]), nP, nP, nElem);
-	varGLLJacobian->get(&(dataGLLJacobian[0][0][0]), nP, nP, nElem);
+	dataGLLNodes.FromPointMajor(vecGLLNodes);
+	dataGLLJacobian.FromPointMajor(vecGLLJacobian);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char** argv) {
 
+#ifdef USE_MPI
+	MPI_Init(&argc, &argv);
+#endif
+
 try {
 
 	// Method
@@ -136,15 +204,63 @@ try {
 	// Output map file
 	std::string strOutputMap;
 
-	// Input data file
+	// Output binary map file
+	std::string strOutputMapBinary;
+
+	// Store the map in single precision
+	bool fOutputSingle;
+
+	// Tolerance on changes in the map due to single precision
+	double dSingleTolerance;
+
+	// Write NetCDF-4 output with chunked variables
+	bool fNetCDF4;
+
+	// Deflate level of NetCDF-4 output
+	int nDeflateLevel;
+
+	// Apply the shuffle filter to NetCDF-4 output
+	bool fShuffle;
+
+	// Input data files
 	std::string strInputData;
 
-	// Output data file
+	// Output data files
 	std::string strOutputData;
 
+	// File containing a list of input and output data files
+	std::string strDataList;
+
 	// Name of the ncol variable
 	std::string strNColName;
 
+	// Input reconstruction operator file
+	std::string strInputReconstruction;
+
+	// Output reconstruction operator file
+	std::string strOutputReconstruction;
+
+	// Overlap mesh quadrature cache file
+	std::string strOverlapQuadrature;
+
+	// Read meshes through a binary cache next to each mesh file
+	bool fMeshCache;
+
+	// Directory of cached offline maps
+	std::string strCacheDir;
+
+	// Apply the map to data on an offload device
+	bool fGPU;
+
+	// Turn off mass diagnostics when applying the map to data
+	bool fNoDiagnostics;
+
+	// Memory budget for assembling the offline map, in MB (0 for no limit)
+	int nAssemblyMemoryMB;
+
+	// Directory of scratch files for assembling the offline map
+	std::string strScratchDir;
+
 	// Parse the command line
 	BeginCommandLine()
 		//CommandLineStringD(strMethod, "method", "", "[se]");
@@ -161,15 +277,42 @@ try {
 		CommandLineString(strOverlapMesh, "ov_mesh", "");
 		CommandLineString(strVariables, "var", "");
 		CommandLineString(strOutputMap, "out_map", "");
+		CommandLineString(strOutputMapBinary, "out_map_bin", "");
+		CommandLineBool(fOutputSingle, "out_single");
+		CommandLineDouble(dSingleTolerance, "single_tol", 1.0e-6);
+		CommandLineBool(fNetCDF4, "netcdf4");
+		CommandLineInt(nDeflateLevel, "deflate", 0);
+		CommandLineBool(fShuffle, "shuffle");
 		CommandLineString(strInputData, "in_data", "");
 		CommandLineString(strOutputData, "out_data", "");
+		CommandLineString(strDataList, "data_list", "");
 		CommandLineString(strNColName, "ncol_name", "ncol");
+		CommandLineString(strInputReconstruction, "in_recon", "");
+		CommandLineString(strOutputReconstruction, "out_recon", "");
+		CommandLineString(strOverlapQuadrature, "ov_quad", "");
+		CommandLineBool(fMeshCache, "mesh_cache");
+		CommandLineString(strCacheDir, "cache_dir", "");
+		CommandLineBool(fGPU, "gpu");
+		CommandLineBool(fNoDiagnostics, "nodiag");
+		CommandLineInt(nAssemblyMemoryMB, "assembly_mem", 0);
+		CommandLineString(strScratchDir, "scratch_dir", ".");
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
 
 	AnnounceBanner();
 
+	// Format of NetCDF output files
+	NetCDFOutputOptions optNetCDF(fNetCDF4, nDeflateLevel, fShuffle);
+
+	// Rank of this processor; the map is assembled and written by the
+	// root rank
+	int nRank = 0;
+
+#ifdef USE_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+#endif
+
 	// Check command line parameters
 	if ((strInputData != "") && (strOutputData == "")) {
 		_EXCEPTIONT("in_data specified without out_data");
@@ -177,18 +320,58 @@ try {
 	if ((strInputData == "") && (strOutputData != "")) {
 		_EXCEPTIONT("out_data specified without in_data");
 	}
+	if (nAssemblyMemoryMB < 0) {
+		_EXCEPTIONT("--assembly_mem must be nonnegative");
+	}
+
+	// Input and output data files; the map is applied to each pair
+	std::vector< std::string > vecInputData;
+	std::vector< std::string > vecOutputData;
+
+	ParseVariableList(strInputData, vecInputData);
+	ParseVariableList(strOutputData, vecOutputData);
+
+	if (vecInputData.size() != vecOutputData.size()) {
+		_EXCEPTIONT("in_data and out_data must list the same number of files");
+	}
+
+	if (strDataList != "") {
+		ReadDataFileList(strDataList, vecInputData, vecOutputData);
+	}
+
+	// Verify all input data files can be read before the map is generated
+	for (int i = 0; i < vecInputData.size(); i++) {
+		FILE * fp = fopen(vecInputData[i].c_str(), "r");
+		if (fp == NULL) {
+			_EXCEPTION1("Unable to open input data file \"%s\"",
+				vecInputData[i].c_str());
+		}
+		fclose(fp);
+
+		for (int j = 0; j < vecInputData.size(); j++) {
+			if (vecOutputData[i] == vecInputData[j]) {
+				_EXCEPTION1("Output data file \"%s\" is also an input "
+					"data file", vecOutputData[i].c_str());
+			}
+		}
+	}
+	if (fInputSE &&
+		((strInputReconstruction != "") || (strOutputReconstruction != ""))
+	) {
+		_EXCEPTIONT("in_recon and out_recon require finite volume input");
+	}
 
 	// Parse variable list
 	std::vector< std::string > vecVariableStrings;
 	ParseVariableList(strVariables, vecVariableStrings);
 
-	if ((strInputData != "") && (vecVariableStrings.size() == 0)) {
+	if ((vecInputData.size() != 0) && (vecVariableStrings.size() == 0)) {
 		_EXCEPTIONT("No variables specified");
 	}
 
 	// Load input mesh
 	AnnounceStartBlock("Loading input mesh");
-	Mesh meshInput(strInputMesh);
+	Mesh meshInput(strInputMesh, fMeshCache);
 	meshInput.RemoveZeroEdges();
 	AnnounceEndBlock(NULL);
 
@@ -206,7 +389,7 @@ try {
 
 	// Load output mesh
 	AnnounceStartBlock("Loading output mesh");
-	Mesh meshOutput(strOutputMesh);
+	Mesh meshOutput(strOutputMesh, fMeshCache);
 	meshOutput.RemoveZeroEdges();
 	AnnounceEndBlock(NULL);
 
@@ -224,16 +407,11 @@ try {
 
 	// Load overlap mesh
 	AnnounceStartBlock("Loading overlap mesh");
-	Mesh meshOverlap(strOverlapMesh);
+	Mesh meshOverlap(strOverlapMesh, fMeshCache);
 	meshOverlap.RemoveZeroEdges();
 
 	// Verify that overlap mesh is in the correct order
-	int ixFirstFaceMax = (-1);
-	for (int i = 0; i < meshOverlap.vecFirstFaceIx.size(); i++) {
-		if (meshOverlap.vecFirstFaceIx[i] + 1 > ixFirstFaceMax) {
-			ixFirstFaceMax = meshOverlap.vecFirstFaceIx[i] + 1;
-		}
-	}
+	int ixFirstFaceMax = meshOverlap.firstfaceindex.GetSourceFaceCount();
 
 	if (ixFirstFaceMax  == meshInput.faces.size()) {
 		Announce("Overlap mesh primary correspondence found");
@@ -250,6 +428,11 @@ try {
 			ixFirstFaceMax);
 	}
 
+	// Index the overlap mesh by input and output mesh Face
+	meshOverlap.ConstructOverlapIndex(
+		static_cast<int>(meshInput.faces.size()),
+		static_cast<int>(meshOutput.faces.size()));
+
 	AnnounceEndBlock(NULL);
 
 	// Calculate Face areas
@@ -278,25 +461,136 @@ try {
 */
 	// Offline Map
 	OfflineMap mapRemap;
+	mapRemap.InitializeInputDimensionsFromFile(strInputMesh);
+	mapRemap.InitializeOutputDimensionsFromFile(strOutputMesh);
+
+	// Entries beyond the assembly budget are spilled to scratch files
+	if (nAssemblyMemoryMB != 0) {
+		mapRemap.GetSparseMatrix().SetSpill(
+			static_cast<size_t>(nAssemblyMemoryMB) * 1024 * 1024,
+			strScratchDir);
+	}
 
-	// Finite volume input / Finite volume output
-	if ((!fInputSE) && (!fOutputSE)) {
+	// Cache entry of the offline map, keyed by the contents of all meshes
+	// and the options that affect the map
+	ContentCache cache(strCacheDir);
+
+	std::string strCacheEntry;
+	if (cache.IsEnabled()) {
+		ContentHash hash;
+		hash.Add(std::string("map"));
+		hash.Add(meshInput);
+		hash.Add(meshOutput);
+		hash.Add(meshOverlap);
+
+		for (int i = 0; i < mapRemap.GetInputDimSizes().size(); i++) {
+			hash.Add(mapRemap.GetInputDimSizes()[i]);
+			hash.Add(mapRemap.GetInputDimNames()[i]);
+		}
+		for (int i = 0; i < mapRemap.GetOutputDimSizes().size(); i++) {
+			hash.Add(mapRemap.GetOutputDimSizes()[i]);
+			hash.Add(mapRemap.GetOutputDimNames()[i]);
+		}
 
-		// Generate reverse node array
+		hash.Add(static_cast<int>(fInputSE));
+		hash.Add(static_cast<int>(fOutputSE));
+		hash.Add(nP);
+		hash.Add(nPout);
+		hash.Add(static_cast<int>(fBubble));
+		hash.Add(static_cast<int>(fMonotone));
+		hash.Add(static_cast<int>(
+			(strInputReconstruction != "") || (strOutputReconstruction != "")));
+		hash.Add(RemapQuadratureOrder);
+
+		if (strMetaFile != "") {
+			hash.AddFile(strMetaFile);
+		}
+
+		strCacheEntry = cache.GetEntryPath("map", hash, ".bin");
+	}
+
+	bool fMapCached = cache.HasEntry(strCacheEntry);
+
+	// Quadrature points of the overlap mesh, shared by all remap operators,
+	// which are not needed if the map is read from the cache
+	FaceQuadratureTable quadOverlap;
+
+	if (fMapCached) {
+		Announce("Offline map found in cache \"%s\"", strCacheEntry.c_str());
+
+	} else if ((strOverlapQuadrature != "") &&
+		quadOverlap.Read(strOverlapQuadrature) &&
+		quadOverlap.IsCompatible(meshOverlap, RemapQuadratureOrder)
+	) {
+		Announce("Overlap mesh quadrature loaded from \"%s\"",
+			strOverlapQuadrature.c_str());
+
+	} else {
+		AnnounceStartBlock("Calculating overlap mesh quadrature");
+		quadOverlap.Initialize(meshOverlap, RemapQuadratureOrder);
+		AnnounceEndBlock(NULL);
+
+		if ((strOverlapQuadrature != "") && (nRank == 0)) {
+			AnnounceStartBlock("Writing overlap mesh quadrature");
+			quadOverlap.Write(strOverlapQuadrature);
+			AnnounceEndBlock(NULL);
+		}
+	}
+
+	// Reconstruction operator of the finite volume input mesh
+	FVReconstructionOperator opReconstruction;
+
+	const FVReconstructionOperator * pReconstruction = NULL;
+
+	if (strInputReconstruction != "") {
+		AnnounceStartBlock("Loading reconstruction operator");
+		opReconstruction.Read(strInputReconstruction);
+		opReconstruction.Validate(meshInput, nP);
+		AnnounceEndBlock(NULL);
+
+		pReconstruction = &opReconstruction;
+
+	} else if (strOutputReconstruction != "") {
+		AnnounceStartBlock("Calculating reconstruction operator");
 		meshInput.ConstructReverseNodeArray();
+		opReconstruction.Initialize(meshInput, nP);
+		AnnounceEndBlock(NULL);
+
+		pReconstruction = &opReconstruction;
+	}
+
+	if ((strOutputReconstruction != "") && (nRank == 0)) {
+		AnnounceStartBlock("Writing reconstruction operator");
+		opReconstruction.Write(strOutputReconstruction);
+		AnnounceEndBlock(NULL);
+	}
+
+	// Finite volume input / Finite volume output
+	if ((!fInputSE) && (!fOutputSE)) {
 
 		// Construct OfflineMap
-		AnnounceStartBlock("Calculating offline map");
-		mapRemap.InitializeInputDimensionsFromFile(strInputMesh);
-		mapRemap.InitializeOutputDimensionsFromFile(strOutputMesh);
+		if (!fMapCached) {
+
+			// Generate reverse node array
+			if (pReconstruction == NULL) {
+				meshInput.ConstructReverseNodeArray();
+			}
 
-		LinearRemapFVtoFV(
-			meshInput, meshOutput, meshOverlap, nP, mapRemap);
+			AnnounceStartBlock("Calculating offline map");
+			LinearRemapFVtoFV(
+				meshInput,
+				meshOutput,
+				meshOverlap,
+				nP,
+				mapRemap,
+				pReconstruction,
+				&quadOverlap);
+		}
 
 	// Finite volume input / Spectral element output
 	} else if ((!fInputSE) && (fOutputSE)) {
-		DataMatrix3D<int> dataGLLNodes;
-		DataMatrix3D<double> dataGLLJacobian;
+		GLLElementData<int> dataGLLNodes;
+		GLLElementData<double> dataGLLJacobian;
 
 		if (strMetaFile != "") {
 			AnnounceStartBlock("Loading meta data file");
@@ -333,28 +627,35 @@ try {
 			dataGLLJacobian,
 			vecOutputAreas);
 
-		// Generate reverse node array
-		meshInput.ConstructReverseNodeArray();
+		// The output degrees of freedom are the GLL nodes of each element
+		mapRemap.InitializeOutputDimensions(vecOutputAreas.GetRows());
 
 		// Generate remap weights
-		AnnounceStartBlock("Calculating offline map");
-		mapRemap.InitializeInputDimensionsFromFile(strInputMesh);
-		mapRemap.InitializeOutputDimensionsFromFile(strOutputMesh);
-
-		LinearRemapFVtoGLL(
-			meshInput,
-			meshOutput,
-			meshOverlap,
-			dataGLLNodes,
-			dataGLLJacobian,
-			nP,
-			mapRemap,
-			fMonotone);
+		if (!fMapCached) {
+
+			// Generate reverse node array
+			if (pReconstruction == NULL) {
+				meshInput.ConstructReverseNodeArray();
+			}
+
+			AnnounceStartBlock("Calculating offline map");
+			LinearRemapFVtoGLL(
+				meshInput,
+				meshOutput,
+				meshOverlap,
+				dataGLLNodes,
+				dataGLLJacobian,
+				nP,
+				mapRemap,
+				fMonotone,
+				pReconstruction,
+				&quadOverlap);
+		}
 
 	// Spectral element input / Finite volume output
 	} else if ((fInputSE) && (!fOutputSE)) {
-		DataMatrix3D<int> dataGLLNodes;
-		DataMatrix3D<double> dataGLLJacobian;
+		GLLElementData<int> dataGLLNodes;
+		GLLElementData<double> dataGLLJacobian;
 
 		if (strMetaFile != "") {
 			AnnounceStartBlock("Loading meta data file");
@@ -380,7 +681,7 @@ try {
 			}
 		}
 
-		if (dataGLLNodes.GetSubColumns() != meshInput.faces.size()) {
+		if (dataGLLNodes.GetElements() != meshInput.faces.size()) {
 			_EXCEPTIONT("Number of element does not match between metadata and "
 				"input mesh");
 		}
@@ -391,61 +692,117 @@ try {
 			dataGLLJacobian,
 			vecInputAreas);
 
+		// The input degrees of freedom are the unique GLL nodes
+		mapRemap.InitializeInputDimensions(vecInputAreas.GetRows());
+
 		// Generate offline map
-		AnnounceStartBlock("Calculating offline map");
-		mapRemap.InitializeInputDimensionsFromFile(strInputMesh);
-		mapRemap.InitializeOutputDimensionsFromFile(strOutputMesh);
-
-		LinearRemapSE4(
-			meshInput,
-			meshOutput,
-			meshOverlap,
-			dataGLLNodes,
-			dataGLLJacobian,
-			fMonotone,
-			mapRemap
-		);
+		if (!fMapCached) {
+			AnnounceStartBlock("Calculating offline map");
+			LinearRemapSE4(
+				meshInput,
+				meshOutput,
+				meshOverlap,
+				dataGLLNodes,
+				dataGLLJacobian,
+				fMonotone,
+				mapRemap,
+				&quadOverlap
+			);
+		}
 
 	} else {
 		_EXCEPTIONT("Not implemented");
 	}
 
+	// Read the cached offline map; the meta data of spectral element
+	// meshes is still loaded above for the areas of their nodes
+	if (fMapCached) {
+		AnnounceStartBlock("Reading offline map from cache");
+		mapRemap.Read(strCacheEntry);
+
+	// Store the offline map in the cache before it is converted to single
+	// precision, so that the entry is independent of out_single
+	} else if (cache.IsEnabled() && (nRank == 0)) {
+		std::string strTemporary = cache.GetTemporaryPath(strCacheEntry);
+
+		bool fValid = true;
+		try {
+			mapRemap.WriteBinary(
+				strTemporary,
+				DataVector<double>(),
+				DataVector<double>());
+
+		} catch(Exception & e) {
+			Announce(e.ToString().c_str());
+			fValid = false;
+		}
+
+		cache.Commit(strTemporary, strCacheEntry, fValid);
+	}
+
 	// Verify consistency, conservation and monotonicity
-	if (!fNoCheck) {
+	if ((!fNoCheck) && (nRank == 0)) {
 		AnnounceStartBlock("Verifying map");
-		mapRemap.IsConsistent(1.0e-8);
-		mapRemap.IsConservative(vecInputAreas, vecOutputAreas, 1.0e-8);
+		mapRemap.Verify(vecInputAreas, vecOutputAreas, fMonotone);
+		AnnounceEndBlock(NULL);
+	}
 
-		if (fMonotone) {
-			mapRemap.IsMonotone(1.0e-12);
-		}
+	// Convert to single precision
+	if (fOutputSingle && (nRank == 0)) {
+		AnnounceStartBlock("Converting map to single precision");
+		mapRemap.ConvertToSinglePrecision(
+			vecInputAreas, vecOutputAreas, dSingleTolerance);
 		AnnounceEndBlock(NULL);
 	}
 
 	AnnounceEndBlock(NULL);
 
 	// Output the Offline Map
-	if (strOutputMap != "") {
+	if ((strOutputMap != "") && (nRank == 0)) {
 		AnnounceStartBlock("Writing offline map");
 		mapRemap.Write(
 			strOutputMap,
-			meshInput.vecFaceArea,
-			meshOutput.vecFaceArea);
+			vecInputAreas,
+			vecOutputAreas,
+			optNetCDF);
+		AnnounceEndBlock(NULL);
+	}
+
+	if ((strOutputMapBinary != "") && (nRank == 0)) {
+		AnnounceStartBlock("Writing binary offline map");
+		mapRemap.WriteBinary(
+			strOutputMapBinary,
+			vecInputAreas,
+			vecOutputAreas);
 		AnnounceEndBlock(NULL);
 	}
 
-	// Apply Offline Map to data
-	if (strInputData != "") {
+	// Apply Offline Map to data; the map is generated once for all files
+	if ((vecInputData.size() != 0) && (nRank == 0)) {
 		AnnounceStartBlock("Applying offline map to data");
+
+		// Mass diagnostics are computed for the areas which are given
+		DataVector<double> vecApplyInputAreas;
+		DataVector<double> vecApplyOutputAreas;
+		if (!fNoDiagnostics) {
+			vecApplyInputAreas = vecInputAreas;
+			vecApplyOutputAreas = vecOutputAreas;
+		}
+
 		mapRemap.Apply(
-			vecInputAreas,
-			meshOutput.vecFaceArea,
-			strInputData,
-			strOutputData,
+			vecApplyInputAreas,
+			vecApplyOutputAreas,
+			vecInputData,
+			vecOutputData,
 			vecVariableStrings,
 			strNColName,
 			false,
-			false);
+			false,
+			OfflineMap::DefaultApplyMemoryBudget,
+			false,
+			optNetCDF,
+			false,
+			fGPU);
 		AnnounceEndBlock(NULL);
 	}
 
@@ -454,6 +811,10 @@ try {
 } catch(Exception & e) {
 	Announce(e.ToString().c_str());
 }
+
+#ifdef USE_MPI
+	MPI_Finalize();
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,34 @@
+#!/bin/sh
+
+# Run the benchmarks on CSne30, RLL1deg and ICO16, writing the results to
+# benchmark_results.csv and benchmark_results.json.  If a baseline CSV file
+# is given as the first argument, a median time more than 10% slower than
+# the baseline is reported as a regression and the script exits nonzero.
+#
+# Build with "make all benchmarks" first.
+
+DATA=benchmark_data
+mkdir -p $DATA
+
+if [ ! -f $DATA/outCSne30.g ]; then
+	./GenerateCSMesh --res 30 --file $DATA/outCSne30.g
+fi
+if [ ! -f $DATA/outRLL1deg.g ]; then
+	./GenerateRLLMesh --lon 360 --lat 180 --file $DATA/outRLL1deg.g
+fi
+if [ ! -f $DATA/outICO16.g ]; then
+	./GenerateICOMesh --res 16 --dual --file $DATA/outICO16.g
+fi
+if [ ! -f $DATA/overlap_CSne30_RLL1deg.g ]; then
+	./GenerateOverlapMesh --a $DATA/outCSne30.g --b $DATA/outRLL1deg.g --out $DATA/overlap_CSne30_RLL1deg.g
+fi
+if [ ! -f $DATA/map_CSne30_np4_RLL1deg.nc ]; then
+	./gecore2 --in_mesh $DATA/outCSne30.g --out_mesh $DATA/outRLL1deg.g --ov_mesh $DATA/overlap_CSne30_RLL1deg.g --in_se --np 4 --out_map $DATA/map_CSne30_np4_RLL1deg.nc
+fi
+
+BASELINE=""
+if [ "$1" != "" ]; then
+	BASELINE="--baseline $1"
+fi
+
+./Benchmark --cs_mesh $DATA/outCSne30.g --rll_mesh $DATA/outRLL1deg.g --ico_mesh $DATA/outICO16.g --ov_mesh $DATA/overlap_CSne30_RLL1deg.g --map $DATA/map_CSne30_np4_RLL1deg.nc --csv benchmark_results.csv --json benchmark_results.json $BASELINE
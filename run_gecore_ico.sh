@@ -1,38 +1,13 @@
 #!/bin/sh
 
-time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np2_1.nc --out_data testdata_CSne15_ICO72_np2_1.nc --in_se --np 2 --bubble
-time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np3_1.nc --out_data testdata_CSne15_ICO72_np3_1.nc --in_se --np 3 --bubble
-time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np4_1.nc --out_data testdata_CSne15_ICO72_np4_1.nc --in_se --np 4 --bubble
+time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np2_1.nc,testdata_CSne15_np2_2.nc,testdata_CSne15_np2_3.nc --out_data testdata_CSne15_ICO72_np2_1.nc,testdata_CSne15_ICO72_np2_2.nc,testdata_CSne15_ICO72_np2_3.nc --in_se --np 2 --bubble
+time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np3_1.nc,testdata_CSne15_np3_2.nc,testdata_CSne15_np3_3.nc --out_data testdata_CSne15_ICO72_np3_1.nc,testdata_CSne15_ICO72_np3_2.nc,testdata_CSne15_ICO72_np3_3.nc --in_se --np 3 --bubble
+time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np4_1.nc,testdata_CSne15_np4_2.nc,testdata_CSne15_np4_3.nc --out_data testdata_CSne15_ICO72_np4_1.nc,testdata_CSne15_ICO72_np4_2.nc,testdata_CSne15_ICO72_np4_3.nc --in_se --np 4 --bubble
 
-time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np2_2.nc --out_data testdata_CSne15_ICO72_np2_2.nc --in_se --np 2 --bubble
-time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np3_2.nc --out_data testdata_CSne15_ICO72_np3_2.nc --in_se --np 3 --bubble
-time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np4_2.nc --out_data testdata_CSne15_ICO72_np4_2.nc --in_se --np 4 --bubble
-
-time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np2_3.nc --out_data testdata_CSne15_ICO72_np2_3.nc --in_se --np 2 --bubble
-time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np3_3.nc --out_data testdata_CSne15_ICO72_np3_3.nc --in_se --np 3 --bubble
-time ./gecore2 --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --var Psi --in_data testdata_CSne15_np4_3.nc --out_data testdata_CSne15_ICO72_np4_3.nc --in_se --np 4 --bubble
-
-time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np2_1.nc --out_data testdata_CSne30_ICO72_np2_1.nc --in_se --np 2 --bubble
-time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np3_1.nc --out_data testdata_CSne30_ICO72_np3_1.nc --in_se --np 3 --bubble
-time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np4_1.nc --out_data testdata_CSne30_ICO72_np4_1.nc --in_se --np 4 --bubble
-
-time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np2_2.nc --out_data testdata_CSne30_ICO72_np2_2.nc --in_se --np 2 --bubble
-time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np3_2.nc --out_data testdata_CSne30_ICO72_np3_2.nc --in_se --np 3 --bubble
-time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np4_2.nc --out_data testdata_CSne30_ICO72_np4_2.nc --in_se --np 4 --bubble
-
-time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np2_3.nc --out_data testdata_CSne30_ICO72_np2_3.nc --in_se --np 2 --bubble
-time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np3_3.nc --out_data testdata_CSne30_ICO72_np3_3.nc --in_se --np 3 --bubble
-time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np4_3.nc --out_data testdata_CSne30_ICO72_np4_3.nc --in_se --np 4 --bubble
-
-time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np2_1.nc --out_data testdata_CSne60_ICO72_np2_1.nc --in_se --np 2 --bubble
-time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np3_1.nc --out_data testdata_CSne60_ICO72_np3_1.nc --in_se --np 3 --bubble
-time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np4_1.nc --out_data testdata_CSne60_ICO72_np4_1.nc --in_se --np 4 --bubble
-
-time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np2_2.nc --out_data testdata_CSne60_ICO72_np2_2.nc --in_se --np 2 --bubble
-time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np3_2.nc --out_data testdata_CSne60_ICO72_np3_2.nc --in_se --np 3 --bubble
-time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np4_2.nc --out_data testdata_CSne60_ICO72_np4_2.nc --in_se --np 4 --bubble
-
-time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np2_3.nc --out_data testdata_CSne60_ICO72_np2_3.nc --in_se --np 2 --bubble
-time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np3_3.nc --out_data testdata_CSne60_ICO72_np3_3.nc --in_se --np 3 --bubble
-time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np4_3.nc --out_data testdata_CSne60_ICO72_np4_3.nc --in_se --np 4 --bubble
+time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np2_1.nc,testdata_CSne30_np2_2.nc,testdata_CSne30_np2_3.nc --out_data testdata_CSne30_ICO72_np2_1.nc,testdata_CSne30_ICO72_np2_2.nc,testdata_CSne30_ICO72_np2_3.nc --in_se --np 2 --bubble
+time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np3_1.nc,testdata_CSne30_np3_2.nc,testdata_CSne30_np3_3.nc --out_data testdata_CSne30_ICO72_np3_1.nc,testdata_CSne30_ICO72_np3_2.nc,testdata_CSne30_ICO72_np3_3.nc --in_se --np 3 --bubble
+time ./gecore2 --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --var Psi --in_data testdata_CSne30_np4_1.nc,testdata_CSne30_np4_2.nc,testdata_CSne30_np4_3.nc --out_data testdata_CSne30_ICO72_np4_1.nc,testdata_CSne30_ICO72_np4_2.nc,testdata_CSne30_ICO72_np4_3.nc --in_se --np 4 --bubble
 
+time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np2_1.nc,testdata_CSne60_np2_2.nc,testdata_CSne60_np2_3.nc --out_data testdata_CSne60_ICO72_np2_1.nc,testdata_CSne60_ICO72_np2_2.nc,testdata_CSne60_ICO72_np2_3.nc --in_se --np 2 --bubble
+time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np3_1.nc,testdata_CSne60_np3_2.nc,testdata_CSne60_np3_3.nc --out_data testdata_CSne60_ICO72_np3_1.nc,testdata_CSne60_ICO72_np3_2.nc,testdata_CSne60_ICO72_np3_3.nc --in_se --np 3 --bubble
+time ./gecore2 --in_mesh outCSne60.g --out_mesh outICO72.g --ov_mesh overlap_CSne60_ICO72.g --var Psi --in_data testdata_CSne60_np4_1.nc,testdata_CSne60_np4_2.nc,testdata_CSne60_np4_3.nc --out_data testdata_CSne60_ICO72_np4_1.nc,testdata_CSne60_ICO72_np4_2.nc,testdata_CSne60_ICO72_np4_3.nc --in_se --np 4 --bubble